@@ -0,0 +1,207 @@
+/**
+ * @file BoundedQueue.h
+ * @brief 有界阻塞队列 | Bounded blocking queue
+ *
+ * 流水线各阶段之间的缓冲队列：队列满时生产者等待，队列空时消费者等待，
+ * close() 后生产者立即返回、消费者取完剩余元素后返回。
+ * 同时统计队列深度和两端的等待时间，用于定位流水线瓶颈。
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
+#include <deque>
+#include <utility>
+
+/**
+ * @brief 队列统计信息
+ */
+struct BoundedQueueStats {
+  int capacity = 0;           // 容量
+  int depth = 0;              // 当前深度
+  int maxDepth = 0;           // 最大深度
+  double avgDepth = 0.0;      // 入队时的平均深度
+  quint64 pushed = 0;         // 入队数量
+  quint64 popped = 0;         // 出队数量
+  double pushWaitMs = 0.0;    // 生产者因队列满而等待的累计时间(ms)
+  double popWaitMs = 0.0;     // 消费者因队列空而等待的累计时间(ms)
+};
+
+/**
+ * @brief 有界阻塞队列
+ * @tparam T 元素类型（需可移动）
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue(int capacity = 4) :
+    m_capacity(capacity < 1 ? 1 : capacity)
+  {
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /**
+   * @brief 入队，队列满时等待
+   * @return 队列已关闭时返回false，元素被丢弃
+   */
+  bool push(T item)
+  {
+    QMutexLocker locker(&m_mutex);
+    if (!m_closed && static_cast<int>(m_items.size()) >= m_capacity)
+    {
+      QElapsedTimer timer;
+      timer.start();
+      while (!m_closed && static_cast<int>(m_items.size()) >= m_capacity)
+      {
+        m_notFull.wait(&m_mutex);
+      }
+      m_pushWaitNs += timer.nsecsElapsed();
+    }
+    if (m_closed)
+    {
+      return false;
+    }
+
+    m_items.push_back(std::move(item));
+    int depth = static_cast<int>(m_items.size());
+    ++m_pushed;
+    m_depthSum += depth;
+    if (depth > m_maxDepth)
+    {
+      m_maxDepth = depth;
+    }
+    m_notEmpty.wakeOne();
+    return true;
+  }
+
+  /**
+   * @brief 尝试入队，队列满或已关闭时立即返回
+   * @return 入队成功返回true，否则元素被丢弃
+   */
+  bool tryPush(T item)
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_closed || static_cast<int>(m_items.size()) >= m_capacity)
+    {
+      return false;
+    }
+
+    m_items.push_back(std::move(item));
+    int depth = static_cast<int>(m_items.size());
+    ++m_pushed;
+    m_depthSum += depth;
+    if (depth > m_maxDepth)
+    {
+      m_maxDepth = depth;
+    }
+    m_notEmpty.wakeOne();
+    return true;
+  }
+
+  /**
+   * @brief 出队，队列空时等待
+   * @return 队列已关闭且为空时返回false
+   */
+  bool pop(T& item)
+  {
+    QMutexLocker locker(&m_mutex);
+    if (!m_closed && m_items.empty())
+    {
+      QElapsedTimer timer;
+      timer.start();
+      while (!m_closed && m_items.empty())
+      {
+        m_notEmpty.wait(&m_mutex);
+      }
+      m_popWaitNs += timer.nsecsElapsed();
+    }
+    if (m_items.empty())
+    {
+      return false;
+    }
+
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    ++m_popped;
+    m_notFull.wakeOne();
+    return true;
+  }
+
+  /**
+   * @brief 关闭队列，唤醒所有等待者
+   */
+  void close()
+  {
+    QMutexLocker locker(&m_mutex);
+    m_closed = true;
+    m_notEmpty.wakeAll();
+    m_notFull.wakeAll();
+  }
+
+  /**
+   * @brief 清空队列中尚未取出的元素
+   */
+  void clear()
+  {
+    QMutexLocker locker(&m_mutex);
+    m_items.clear();
+    m_notFull.wakeAll();
+  }
+
+  bool isClosed() const
+  {
+    QMutexLocker locker(&m_mutex);
+    return m_closed;
+  }
+
+  int size() const
+  {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_items.size());
+  }
+
+  int capacity() const
+  {
+    return m_capacity;
+  }
+
+  BoundedQueueStats stats() const
+  {
+    QMutexLocker locker(&m_mutex);
+    BoundedQueueStats result;
+    result.capacity = m_capacity;
+    result.depth = static_cast<int>(m_items.size());
+    result.maxDepth = m_maxDepth;
+    result.avgDepth = m_pushed > 0 ? static_cast<double>(m_depthSum) / m_pushed : 0.0;
+    result.pushed = m_pushed;
+    result.popped = m_popped;
+    result.pushWaitMs = m_pushWaitNs / 1e6;
+    result.popWaitMs = m_popWaitNs / 1e6;
+    return result;
+  }
+
+private:
+  const int m_capacity;
+  mutable QMutex m_mutex;
+  QWaitCondition m_notEmpty;
+  QWaitCondition m_notFull;
+  std::deque<T> m_items;
+  bool m_closed = false;
+
+  int m_maxDepth = 0;
+  quint64 m_depthSum = 0;
+  quint64 m_pushed = 0;
+  quint64 m_popped = 0;
+  qint64 m_pushWaitNs = 0;
+  qint64 m_popWaitNs = 0;
+};
+
+#endif //BOUNDEDQUEUE_H
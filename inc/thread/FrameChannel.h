@@ -0,0 +1,132 @@
+/**
+ * @file FrameChannel.h
+ * @brief 工作线程到显示控件的有界帧通道 | Bounded frame channel between worker and display
+ *
+ * 取代逐帧排队的 sendImageWithDisplayObjects 信号：工作线程把帧放入容量有限的通道，
+ * 通道只在由空变为非空时通知界面一次；界面每次只取最新一帧，其余旧帧直接丢弃。
+ * 界面繁忙时事件队列中不会堆积图像副本，内存占用有上限。
+ */
+
+#ifndef FRAMECHANNEL_H
+#define FRAMECHANNEL_H
+
+#include <QObject>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QString>
+
+#include <deque>
+
+#include "InspectionCore.h"
+
+/**
+ * @brief 通道已满时的处理策略
+ */
+enum class FrameDropPolicy {
+  DropOldest,   // 丢弃最旧的帧（默认，界面总能拿到最新帧）
+  DropNewest,   // 丢弃新到的帧
+  Block         // 等待界面取走帧（会限制检测吞吐量，仅用于调试或必须逐帧显示的场合）
+};
+
+/**
+ * @brief 显示帧
+ */
+struct DisplayFrame {
+  qint64 sequence = -1;                     // 帧序号
+  HObject image;                            // 图像
+  QList<DisplayObjectInfo> displayObjects;  // 显示对象
+  QString message;                          // 主窗口附加消息，为空表示无
+  MeasurementRecord record;                 // 测量结果，显示时再生成文本
+};
+
+/**
+ * @brief 帧通道统计信息
+ */
+struct FrameChannelStats {
+  quint64 published = 0;    // 工作线程放入的帧数
+  quint64 displayed = 0;    // 界面实际显示的帧数
+  quint64 overflowed = 0;   // 因通道已满被丢弃的帧数
+  quint64 superseded = 0;   // 因有更新的帧而被界面跳过的帧数
+  double blockedMs = 0.0;   // Block策略下工作线程累计等待时间(ms)
+
+  quint64 dropped() const { return overflowed + superseded; }
+};
+
+/**
+ * @brief 有界帧通道
+ * @details publish() 可在任意线程调用；takeLatest() 在界面线程中调用。
+ */
+class FrameChannel : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit FrameChannel(QObject* parent = nullptr);
+  ~FrameChannel() override;
+
+  /**
+   * @brief 设置通道容量
+   */
+  void setCapacity(int capacity);
+  int capacity() const;
+
+  /**
+   * @brief 设置通道已满时的处理策略
+   */
+  void setDropPolicy(FrameDropPolicy policy);
+  FrameDropPolicy dropPolicy() const;
+
+  /**
+   * @brief 放入一帧
+   * @return 帧是否进入通道（DropNewest 策略下通道已满时返回false）
+   */
+  bool publish(DisplayFrame frame);
+
+  /**
+   * @brief 取出最新一帧，丢弃更旧的帧
+   * @return 通道为空时返回false
+   */
+  bool takeLatest(DisplayFrame& frame);
+
+  /**
+   * @brief 关闭通道，唤醒被阻塞的工作线程，之后放入的帧被丢弃
+   */
+  void close();
+
+  /**
+   * @brief 重新打开通道并清零统计
+   */
+  void reset();
+
+  FrameChannelStats stats() const;
+
+  /**
+   * @brief 生成统计摘要文本
+   */
+  QString statsSummary() const;
+
+  /**
+   * @brief 策略与配置字符串互转（drop_oldest / drop_newest / block）
+   */
+  static FrameDropPolicy policyFromString(const QString& text, FrameDropPolicy fallback = FrameDropPolicy::DropOldest);
+  static QString policyToString(FrameDropPolicy policy);
+
+signals:
+  /**
+   * @brief 通道由空变为非空时发出，界面收到后调用 takeLatest()
+   */
+  void frameAvailable();
+
+private:
+  mutable QMutex m_mutex;
+  QWaitCondition m_notFull;
+  std::deque<DisplayFrame> m_frames;
+  int m_capacity = 2;
+  FrameDropPolicy m_policy = FrameDropPolicy::DropOldest;
+  bool m_closed = false;
+  bool m_notifyPending = false;   // 已发出通知但界面尚未取帧
+  FrameChannelStats m_stats;
+};
+
+#endif //FRAMECHANNEL_H
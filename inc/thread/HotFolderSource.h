@@ -0,0 +1,162 @@
+/**
+ * @file HotFolderSource.h
+ * @brief 监视目录图像来源 | Hot-folder image source
+ *
+ * 持续监视一个图像目录（QFileSystemWatcher，Linux 下即 inotify），新文件在大小与修改时间
+ * 保持稳定一段时间、且能以只读方式打开后视为写入完成，再送入检测流水线。
+ * 已处理文件记录在追加写入的日志文件中（路径 + 大小 + 修改时间），程序重启后不会重复处理；
+ * 同名文件被重新写入后大小或修改时间变化，会作为新文件再次处理。
+ * 读取失败的文件不记入日志，在下一次目录扫描时重试，达到次数上限后放弃（文件被改写或程序重启后再次尝试）。
+ */
+
+#ifndef HOTFOLDERSOURCE_H
+#define HOTFOLDERSOURCE_H
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+
+#include "ImageSource.h"
+
+class QThread;
+
+/**
+ * @brief 监视目录配置
+ */
+struct HotFolderConfig {
+  bool enabled = false;          // 是否以监视目录模式运行
+  QString folder;                // 监视目录
+  QString journalPath;           // 已处理文件日志路径
+  QStringList nameFilters;       // 文件名过滤器
+  int settleMs = 500;            // 文件大小/修改时间保持不变多久视为写入完成(ms)
+  int pollIntervalMs = 100;      // 等待写入完成的文件检查间隔(ms)，也用于合并目录变化通知
+  int rescanIntervalMs = 10000;  // 全目录补扫间隔(ms)，防止监视事件丢失，0表示不补扫
+  bool processExisting = true;   // 启动时是否处理目录中已有但未记录的文件
+  int maxDecodeAttempts = 3;     // 同一文件（未改写）最多读取几次，失败达到该次数后放弃
+};
+
+/**
+ * @brief 监视目录统计信息
+ */
+struct HotFolderStats {
+  quint64 discovered = 0;     // 发现的新文件
+  quint64 skipped = 0;        // 启动时因已在日志中而跳过的文件
+  quint64 ingested = 0;       // 写入完成并送入流水线的文件
+  quint64 processed = 0;      // 已处理并记入日志的文件
+  quint64 vanished = 0;       // 写入完成前被删除或改名的文件
+  quint64 retried = 0;        // 读取失败后等待重试的次数
+  quint64 failed = 0;         // 读取失败达到次数上限而放弃的文件
+  int pending = 0;            // 等待写入完成的文件
+  int queued = 0;             // 已送入流水线、尚未处理完成的文件
+  int journalEntries = 0;     // 日志记录数量
+};
+
+/**
+ * @brief 监视目录图像来源
+ * @details 目录监视和写入完成检测在内部线程的事件循环中运行；next() 在流水线解码线程中阻塞等待，
+ *          markProcessed() 在发布线程中调用，均为线程安全。stop() 唤醒等待中的 next()。
+ */
+class HotFolderSource : public ImageSource
+{
+public:
+  explicit HotFolderSource(const HotFolderConfig& config);
+  ~HotFolderSource() override;
+
+  /**
+   * @brief 加载已处理日志并开始监视
+   * @return 目录不存在或日志无法打开时返回false
+   */
+  bool start();
+
+  /**
+   * @brief 停止监视，唤醒等待中的 next()；尚未取走的文件不记入日志，下次启动时重新处理
+   */
+  void stop();
+
+  bool isStopped() const
+  {
+    return m_stopped.load();
+  }
+
+  bool next(SourceImage& image) override;
+
+  /**
+   * @brief 记录文件已处理（追加写入日志）
+   */
+  void markProcessed(const QString& path) override;
+
+  /**
+   * @brief 文件读取失败：不记入日志，未达到次数上限时在下一次目录扫描时重新发现
+   */
+  void markFailed(const QString& path) override;
+
+  /**
+   * @brief 获取统计信息
+   */
+  HotFolderStats stats() const;
+
+  /**
+   * @brief 生成统计摘要文本
+   */
+  QString statsSummary() const;
+
+private:
+  struct PendingFile {
+    qint64 size = -1;
+    qint64 modifiedMs = 0;
+    qint64 stableSinceMs = 0;   // 大小/修改时间最近一次变化的时间
+  };
+
+  /**
+   * @brief 监视线程主函数：创建监视器和定时器并运行事件循环
+   */
+  void watchLoop();
+
+  /**
+   * @brief 扫描目录，将未记录且未在处理中的文件加入待定列表
+   * @param initial 是否为启动时的首次扫描
+   */
+  void scanDirectory(bool initial);
+
+  /**
+   * @brief 检查待定文件是否写入完成，完成的按修改时间顺序送入就绪队列
+   */
+  void checkPending();
+
+  /**
+   * @brief 加载日志，去掉已不存在或已被改写的文件记录后打开追加写入
+   */
+  bool loadJournal();
+
+  void appendJournal(const QString& key);
+
+  static QString journalKey(const QFileInfo& fileInfo);
+
+private:
+  HotFolderConfig m_config;
+  QThread* m_watchThread = nullptr;
+  std::atomic<bool> m_stopped{true};
+
+  // 以下成员受 m_mutex 保护
+  mutable QMutex m_mutex;
+  QWaitCondition m_readyCondition;
+  std::deque<SourceImage> m_ready;       // 写入完成、等待解码的文件
+  QHash<QString, QString> m_inFlight;    // 已送入流水线的文件：路径 → 日志键
+  QSet<QString> m_journal;               // 已处理文件的日志键
+  QHash<QString, int> m_failures;        // 读取失败的文件：日志键 → 失败次数
+  QFile m_journalFile;
+  HotFolderStats m_stats;
+
+  // 只在监视线程中访问
+  QHash<QString, PendingFile> m_pending;
+};
+
+#endif //HOTFOLDERSOURCE_H
@@ -0,0 +1,284 @@
+/**
+ * @file ImageArchive.h
+ * @brief 追加写入的检测图像归档 | Append-only inspection image archive
+ *
+ * 取代每张图像一个文件的保存方式：原始像素（或 zlib 无损压缩后的像素）连同测量记录
+ * 追加写入大的段文件(seg_XXXXXX.dat)，每条记录在索引文件(seg_XXXXXX.idx)中对应一个定长索引项。
+ * 打开归档时只读取索引文件；按帧号查找为 O(1)，按时间查找为二分查找；读取时通过 mmap
+ * 映射段文件，未压缩帧直接从映射内存生成图像。段文件按大小/日期轮换，按总大小/天数整段删除。
+ *
+ * 文件格式（小端）：
+ *  - 段文件：若干 [ArchiveFrameHeader][像素数据]，每个通道一个平面，按通道顺序排列；
+ *  - 索引文件：若干 ArchiveIndexEntry，写完帧数据并刷新后才追加，崩溃后多余的半条帧数据在打开时截断。
+ */
+
+#ifndef IMAGEARCHIVE_H
+#define IMAGEARCHIVE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+#include <deque>
+#include <memory>
+#include <type_traits>
+
+#include "../thirdparty/hdevelop/include/halconcpp/HalconCpp.h"
+#include "MeasurementRecord.h"
+
+using namespace HalconCpp;
+
+class QFile;
+
+constexpr quint32 kArchiveFrameMagic = 0x46414d49; // "IMAF"
+constexpr quint16 kArchiveFormatVersion = 1;
+
+/**
+ * @brief 帧头（段文件中每帧数据之前）
+ */
+struct ArchiveFrameHeader {
+  quint32 magic = kArchiveFrameMagic;
+  quint16 version = kArchiveFormatVersion;
+  quint16 headerSize = 0;       // sizeof(ArchiveFrameHeader)
+  quint64 frameId = 0;          // 归档内连续递增的帧号
+  qint64 timestampMs = 0;       // 写入时间(ms, 自纪元起)
+  qint32 width = 0;
+  qint32 height = 0;
+  quint16 channels = 0;
+  quint16 pixelType = 0;        // ArchivePixelType
+  quint32 compression = 0;      // 0: 原始像素, 1: zlib
+  quint64 payloadSize = 0;      // 帧头之后的数据字节数
+  quint64 rawSize = 0;          // 解压后的像素字节数
+  MeasurementRecord record;     // 测量记录
+};
+
+static_assert(std::is_trivially_copyable<ArchiveFrameHeader>::value, "ArchiveFrameHeader must stay POD-like");
+
+/**
+ * @brief 索引项（索引文件中定长存储）
+ */
+struct ArchiveIndexEntry {
+  enum Flag : quint32 {
+    Ng = 0x1            // NG帧
+  };
+
+  quint64 frameId = 0;
+  qint64 timestampMs = 0;
+  qint64 sequence = -1;         // 检测流水线中的帧序号
+  quint32 segmentId = 0;
+  quint32 flags = 0;
+  quint64 offset = 0;           // 帧头在段文件中的偏移
+  quint64 size = 0;             // 帧头 + 数据字节数
+  char tag[64] = {};            // 标签（如源文件名、条码），UTF-8，以0结尾
+
+  bool isNg() const { return (flags & Ng) != 0; }
+  QString tagString() const { return QString::fromUtf8(tag); }
+};
+
+static_assert(std::is_trivially_copyable<ArchiveIndexEntry>::value, "ArchiveIndexEntry must stay POD-like");
+
+/**
+ * @brief 像素类型编码
+ */
+enum class ArchivePixelType : quint16 {
+  Unknown = 0,
+  Byte,
+  Int1,
+  UInt2,
+  Int2,
+  Int4,
+  Real,
+  Int8,
+  Direction,
+  Cyclic
+};
+
+/**
+ * @brief 已编码、待追加的帧（可在任意线程中编码，再由 append() 串行写入）
+ */
+struct ArchiveEncodedFrame {
+  ArchiveFrameHeader header;
+  QByteArray payload;
+  qint64 sequence = -1;
+  bool ng = false;
+  QString tag;
+
+  bool isValid() const { return header.channels > 0 && !payload.isEmpty(); }
+};
+
+/**
+ * @brief 归档配置
+ */
+struct ImageArchiveConfig {
+  QString directory;                                  // 归档目录
+  qint64 maxSegmentBytes = 1024LL * 1024 * 1024;      // 单个段文件上限，超过后轮换
+  bool rotateDaily = true;                            // 日期变化时轮换段文件
+  qint64 maxTotalBytes = 0;                           // 归档总大小上限，0表示不限制
+  int retentionDays = 30;                             // 保留天数，0表示不限制
+  int compressionLevel = 1;                           // zlib压缩级别 0~9，0表示不压缩（读取最快）
+};
+
+/**
+ * @brief 归档统计信息
+ */
+struct ImageArchiveStats {
+  int segments = 0;             // 段文件数量
+  quint64 frames = 0;           // 帧数量
+  quint64 ngFrames = 0;         // NG帧数量
+  qint64 totalBytes = 0;        // 段文件总大小
+  qint64 rawBytes = 0;          // 对应的未压缩像素大小
+  quint64 appended = 0;         // 本次打开后追加的帧数
+  quint64 removedSegments = 0;  // 本次打开后按保留策略删除的段文件数
+  qint64 oldestMs = 0;          // 最早帧时间
+  qint64 newestMs = 0;          // 最新帧时间
+};
+
+/**
+ * @brief 追加写入的图像归档
+ * @details 所有函数均为线程安全：追加串行执行，读取可并发。
+ */
+class ImageArchive
+{
+public:
+  ImageArchive();
+  ~ImageArchive();
+
+  ImageArchive(const ImageArchive&) = delete;
+  ImageArchive& operator=(const ImageArchive&) = delete;
+
+  /**
+   * @brief 打开（或创建）归档目录，读取索引并修复未写完的尾部数据
+   */
+  bool open(const ImageArchiveConfig& config);
+  void close();
+  bool isOpen() const;
+  ImageArchiveConfig config() const;
+
+  /**
+   * @brief 编码一帧（复制像素，按配置压缩），不访问归档，可在多个线程中并行调用
+   * @param image 图像（各通道尺寸和类型相同）
+   * @param record 测量记录
+   * @param compressionLevel zlib压缩级别，0表示不压缩
+   * @param frame 输出
+   * @return 不支持的图像类型或读取失败时返回false
+   */
+  static bool encodeFrame(const HObject& image, const MeasurementRecord& record, int compressionLevel,
+                          ArchiveEncodedFrame* frame);
+
+  /**
+   * @brief 追加一帧
+   * @return 分配的帧号，失败时返回0
+   */
+  quint64 append(ArchiveEncodedFrame frame);
+
+  /**
+   * @brief 编码并追加一帧（在调用线程中压缩）
+   */
+  quint64 append(const HObject& image, const MeasurementRecord& record, qint64 sequence, bool ng,
+                 const QString& tag = QString());
+
+  /**
+   * @brief 按帧号查找索引项，O(1)
+   */
+  bool entry(quint64 frameId, ArchiveIndexEntry* result) const;
+
+  /**
+   * @brief 按标签查找最近一帧，O(1)
+   *
+   * 超过63字节的标签按保存时的截断规则比较，只有前63字节相同的标签视为同一标签。
+   */
+  quint64 findByTag(const QString& tag) const;
+
+  /**
+   * @brief 查找时间不早于 timestampMs 的第一帧
+   * @return 帧号，不存在时返回0
+   */
+  quint64 findByTime(qint64 timestampMs) const;
+
+  /**
+   * @brief 查询时间范围内的索引项
+   * @param fromMs 起始时间(含)
+   * @param toMs 结束时间(不含)，<=0 表示不限
+   * @param ngFilter -1: 全部, 0: 只要OK, 1: 只要NG
+   * @param limit 最多返回数量，<=0 表示不限
+   */
+  QVector<ArchiveIndexEntry> query(qint64 fromMs, qint64 toMs, int ngFilter = -1, int limit = 0) const;
+
+  /**
+   * @brief 最近的 count 帧（从旧到新），供结果历史浏览
+   */
+  QVector<ArchiveIndexEntry> latest(int count, int ngFilter = -1) const;
+
+  /**
+   * @brief 读取一帧图像和测量记录（通过 mmap 读取段文件）
+   */
+  bool readFrame(quint64 frameId, HObject* image, MeasurementRecord* record = nullptr) const;
+
+  /**
+   * @brief 立即执行保留策略
+   * @return 删除的段文件数量
+   */
+  int applyRetention();
+
+  ImageArchiveStats stats() const;
+  QString statsSummary() const;
+
+private:
+  // 段文件映射；当前写入段增长后重新映射，旧映射在最后一个读取者释放后才解除
+  struct MappedSegment {
+    std::unique_ptr<QFile> file;
+    uchar* data = nullptr;
+    qint64 size = 0;
+    ~MappedSegment();
+  };
+  typedef std::shared_ptr<MappedSegment> MappedSegmentPtr;
+
+  struct SegmentInfo {
+    quint32 id = 0;
+    qint64 bytes = 0;             // 有效数据大小（最后一条完整帧的结尾）
+    qint64 rawBytes = 0;
+    qint64 firstMs = 0;
+    qint64 lastMs = 0;
+    quint64 frames = 0;
+  };
+
+  QString segmentPath(quint32 id) const;
+  QString indexPath(quint32 id) const;
+  bool loadSegment(quint32 id);
+  bool openWriterLocked(quint32 id);
+  bool rotateIfNeededLocked(qint64 nextBytes, qint64 nowMs);
+  int applyRetentionLocked(qint64 nowMs);
+  void removeSegmentLocked(quint32 id);
+  void closeWriterLocked();
+  MappedSegmentPtr mapRange(quint32 segmentId, quint64 offset, quint64 size) const;
+  static bool decodeFrame(const ArchiveFrameHeader& header, const uchar* payload, HObject* image);
+
+private:
+  mutable QReadWriteLock m_lock;                // 写锁：追加、轮换、删除；读锁：查找、读取
+  ImageArchiveConfig m_config;
+  bool m_open = false;
+
+  std::deque<ArchiveIndexEntry> m_entries;      // 按帧号连续排列
+  QHash<QString, quint64> m_tagIndex;           // 标签 → 最近帧号
+  QMap<quint32, SegmentInfo> m_segments;        // 段号 → 段信息
+  quint64 m_nextFrameId = 1;
+  qint64 m_lastTimestampMs = 0;
+
+  // 当前写入的段
+  quint32 m_writeSegment = 0;
+  std::unique_ptr<QFile> m_dataFile;
+  std::unique_ptr<QFile> m_indexFile;
+  qint64 m_writeDay = 0;                        // 当前段的日期（自纪元起天数）
+
+  mutable QMutex m_mapMutex;                    // 保护映射缓存
+  mutable QHash<quint32, MappedSegmentPtr> m_maps;
+
+  quint64 m_appended = 0;
+  quint64 m_removedSegments = 0;
+};
+
+#endif //IMAGEARCHIVE_H
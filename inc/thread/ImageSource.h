@@ -0,0 +1,94 @@
+/**
+ * @file ImageSource.h
+ * @brief 流水线图像来源 | Image sources for the inspection pipeline
+ *
+ * 流水线解码阶段从 ImageSource 逐个取待处理的图像路径：
+ * FileListSource 为一次性目录快照，HotFolderSource 持续监视目录中新到的文件。
+ */
+
+#ifndef IMAGESOURCE_H
+#define IMAGESOURCE_H
+
+#include <QFileInfoList>
+#include <QString>
+
+/**
+ * @brief 待处理图像
+ */
+struct SourceImage {
+  QString path;         // 图像绝对路径
+  qint64 readyMs = 0;   // 文件写入完成时间(ms, 自纪元起)，0 表示未知，用于统计入队延迟
+};
+
+/**
+ * @brief 图像来源接口
+ */
+class ImageSource
+{
+public:
+  virtual ~ImageSource() = default;
+
+  /**
+   * @brief 取下一张待处理图像，没有时阻塞等待
+   * @return 来源已结束或已停止时返回false
+   */
+  virtual bool next(SourceImage& image) = 0;
+
+  /**
+   * @brief 图像处理（发布）完成通知，默认不处理
+   */
+  virtual void markProcessed(const QString& path)
+  {
+    Q_UNUSED(path);
+  }
+
+  /**
+   * @brief 图像读取失败通知（未处理，不应记为已处理），默认不处理
+   */
+  virtual void markFailed(const QString& path)
+  {
+    Q_UNUSED(path);
+  }
+
+  /**
+   * @brief 图像总数，未知时返回-1
+   */
+  virtual int totalCount() const
+  {
+    return -1;
+  }
+};
+
+/**
+ * @brief 文件列表来源（目录快照）
+ */
+class FileListSource : public ImageSource
+{
+public:
+  explicit FileListSource(const QFileInfoList& files) :
+    m_files(files)
+  {
+  }
+
+  bool next(SourceImage& image) override
+  {
+    if (m_index >= m_files.size())
+    {
+      return false;
+    }
+    image.path = m_files.at(m_index++).absoluteFilePath();
+    image.readyMs = 0;
+    return true;
+  }
+
+  int totalCount() const override
+  {
+    return m_files.size();
+  }
+
+private:
+  QFileInfoList m_files;
+  int m_index = 0;
+};
+
+#endif //IMAGESOURCE_H
@@ -0,0 +1,222 @@
+/**
+ * @file ImageWriterService.h
+ * @brief 后台图像保存服务 | Background image writer service
+ *
+ * 取代在调用线程（界面线程、发布线程）中直接调用 WriteImage：调用方只把图像引用放入有界队列，
+ * 由若干编码线程完成 PNG/TIFF 等格式的编码和写盘。支持按次指定格式与压缩级别、
+ * 只保存NG/抽样保存OK图像、磁盘剩余空间保护，并统计队列深度、写入速率和丢弃数量。
+ * 启用归档模式时检测结果图像连同测量记录追加写入 ImageArchive 段文件，不再每张图像创建一个文件。
+ */
+
+#ifndef IMAGEWRITERSERVICE_H
+#define IMAGEWRITERSERVICE_H
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include <memory>
+
+#include "../thirdparty/hdevelop/include/halconcpp/HalconCpp.h"
+#include "BoundedQueue.h"
+#include "ImageArchive.h"
+#include "InspectionCore.h"
+
+using namespace HalconCpp;
+
+class QThread;
+
+/**
+ * @brief 检测结果图像保存策略
+ */
+enum class ImageSavePolicy {
+  All,            // 保存全部图像
+  NgOnly,         // 只保存NG图像
+  NgAndSampled    // 保存全部NG图像，OK图像按间隔抽样保存
+};
+
+/**
+ * @brief 单次写入的格式选项
+ */
+struct ImageWriteOptions {
+  QString format = "png";   // png / tiff / bmp / jpeg / jp2 / hobj
+  int compression = -1;     // png/tiff: 压缩级别0~9；jpeg/jp2: 质量1~100；-1 使用默认值
+};
+
+/**
+ * @brief 图像保存服务配置
+ */
+struct ImageWriterConfig {
+  bool enabled = false;                               // 是否保存检测结果图像
+  QString rootDir;                                    // 保存根目录，按 日期/NG|OK 分子目录
+  int encoderThreads = 2;                             // 编码线程数
+  int queueCapacity = 32;                             // 队列容量（排队图像数量上限）
+  ImageSavePolicy policy = ImageSavePolicy::NgOnly;   // 保存策略
+  int sampleInterval = 100;                           // NgAndSampled：每N张OK图像保存一张
+  ImageWriteOptions ngOptions;                        // NG图像格式（默认无损PNG）
+  ImageWriteOptions okOptions;                        // OK图像格式
+  qint64 minFreeBytes = 1024LL * 1024 * 1024;         // 磁盘剩余空间低于此值时停止写入
+  bool blockOnFullForNg = true;                       // 队列满时NG图像等待空位，OK图像直接丢弃
+  bool useArchive = false;                            // 检测结果图像写入归档段文件（按策略筛选后）
+  ImageArchiveConfig archive;                         // 归档配置，目录为空时使用 rootDir/archive
+};
+
+/**
+ * @brief 图像保存统计信息
+ */
+struct ImageWriterStats {
+  quint64 submitted = 0;          // 提交的写入请求
+  quint64 written = 0;            // 写入成功
+  quint64 failed = 0;             // 写入失败（编码或IO错误）
+  quint64 skippedByPolicy = 0;    // 按保存策略跳过
+  quint64 droppedQueueFull = 0;   // 队列满被丢弃
+  quint64 droppedDiskFull = 0;    // 磁盘空间不足被丢弃
+  quint64 droppedOnStop = 0;      // 停止时未写入被丢弃
+  int queueDepth = 0;             // 当前队列深度
+  int maxQueueDepth = 0;          // 最大队列深度
+  int queueCapacity = 0;          // 队列容量
+  quint64 bytesWritten = 0;       // 累计写入字节数
+  double bytesPerSecond = 0.0;    // 最近统计窗口的写入速率
+  double avgEncodeMs = 0.0;       // 平均单张编码+写盘耗时(ms)
+  double submitBlockedMs = 0.0;   // 提交方因队列满等待的累计时间(ms)
+  qint64 freeBytes = -1;          // 最近一次检查的磁盘剩余空间，-1表示未检查
+
+  quint64 dropped() const { return droppedQueueFull + droppedDiskFull + droppedOnStop; }
+};
+
+/**
+ * @brief 后台图像保存服务
+ * @details submit()/submitResult() 可在任意线程调用，只复制 HObject 引用，不复制像素。
+ *          提交的图像在写入完成前不得被原地修改（本项目中图像处理均生成新对象）。
+ */
+class ImageWriterService
+{
+public:
+  ImageWriterService();
+  ~ImageWriterService();
+
+  ImageWriterService(const ImageWriterService&) = delete;
+  ImageWriterService& operator=(const ImageWriterService&) = delete;
+
+  /**
+   * @brief 设置配置，正在运行时排空队列后按新配置重启编码线程
+   */
+  void setConfig(const ImageWriterConfig& config);
+  ImageWriterConfig config() const;
+
+  /**
+   * @brief 启动编码线程（已运行时直接返回true）
+   */
+  bool start();
+
+  /**
+   * @brief 停止编码线程
+   * @param drain 为true时写完队列中的图像，否则丢弃
+   */
+  void stop(bool drain = true);
+
+  bool isRunning() const;
+
+  /**
+   * @brief 提交一次写入（不受保存策略限制，例如界面上的手动保存）
+   * @param image 图像
+   * @param filePath 文件路径，没有扩展名时按格式补全
+   * @param options 格式选项
+   * @param ng 是否为NG图像（队列满时NG图像按配置等待空位）
+   * @return 已加入队列返回true；未运行、队列满或磁盘空间不足时返回false
+   */
+  bool submit(const HObject& image, const QString& filePath, const ImageWriteOptions& options, bool ng = false);
+
+  /**
+   * @brief 提交一次写入，格式由文件扩展名决定
+   */
+  bool submit(const HObject& image, const QString& filePath);
+
+  /**
+   * @brief 按保存策略提交检测结果图像，可直接作为流水线发布操作
+   * @return 已加入队列返回true
+   */
+  bool submitResult(const InspectionResult& result);
+
+  /**
+   * @brief 等待队列中的图像全部写完
+   * @param timeoutMs 超时(ms)，-1表示一直等待
+   * @return 全部写完返回true
+   */
+  bool waitForIdle(int timeoutMs = -1);
+
+  ImageWriterStats stats() const;
+
+  /**
+   * @brief 生成统计摘要文本
+   */
+  QString statsSummary() const;
+
+  /**
+   * @brief 生成 WriteImage 的格式参数
+   */
+  static QString halconFormat(const ImageWriteOptions& options);
+
+  /**
+   * @brief 格式对应的文件扩展名（不含点）
+   */
+  static QString fileExtension(const QString& format);
+
+  /**
+   * @brief 根据文件扩展名推断格式，未知扩展名使用 fallback
+   */
+  static ImageWriteOptions optionsForPath(const QString& filePath, const ImageWriteOptions& fallback = ImageWriteOptions());
+
+  /**
+   * @brief 归档（归档模式启动后可用，否则返回nullptr），供结果历史浏览和查询
+   */
+  ImageArchive* archive() const;
+
+  static ImageSavePolicy policyFromString(const QString& text, ImageSavePolicy fallback = ImageSavePolicy::NgOnly);
+  static QString policyToString(ImageSavePolicy policy);
+
+private:
+  struct WriteJob {
+    HObject image;
+    QString filePath;
+    QString format;     // WriteImage 格式参数
+    bool ng = false;
+    bool archive = false;           // 写入归档而不是单独文件
+    MeasurementRecord record;       // 归档：测量记录
+    qint64 sequence = -1;           // 归档：帧序号
+    QString tag;                    // 归档：标签（源文件名）
+  };
+
+  void encoderLoop(std::shared_ptr<BoundedQueue<WriteJob>> queue);
+  bool enqueue(WriteJob job, qint64 estimatedBytes);
+  bool hasDiskSpaceLocked(const QString& directory, qint64 estimatedBytes);
+  void finishJob(bool success, qint64 bytes, qint64 encodeNs);
+
+private:
+  QMutex m_controlMutex;                        // 串行化 start/stop
+  mutable QMutex m_mutex;                       // 保护配置、队列指针和统计（不在持有时等待编码线程）
+  QWaitCondition m_idle;
+  ImageWriterConfig m_config;
+  std::shared_ptr<BoundedQueue<WriteJob>> m_queue;  // 每次启动新建（关闭后的队列不能重新打开）
+  QList<QThread*> m_workers;
+  std::unique_ptr<ImageArchive> m_archive;      // 归档模式下启动时打开，停止时关闭
+  int m_pending = 0;                            // 已入队尚未写完的数量
+
+  quint64 m_okCounter = 0;                      // 抽样计数
+  ImageWriterStats m_stats;
+  qint64 m_encodeNs = 0;
+  qint64 m_blockedNs = 0;
+
+  // 磁盘空间缓存：每隔一段时间查询一次，期间扣除已排队的估计字节数
+  QString m_freeCheckedDir;
+  qint64 m_freeCheckedMs = 0;
+  qint64 m_freeBytes = -1;
+
+  // 写入速率统计窗口
+  qint64 m_rateWindowStartMs = 0;
+  quint64 m_rateWindowBytes = 0;
+  double m_lastRate = 0.0;
+};
+
+#endif //IMAGEWRITERSERVICE_H
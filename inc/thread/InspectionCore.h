@@ -0,0 +1,323 @@
+/**
+ * @file InspectionCore.h
+ * @brief 单帧检测核心 | Single-frame inspection core
+ *
+ * 从 visualWorkThread::onProcessImage 中抽取的检测流程：模板匹配 → 测量区域映射 →
+ * 轮廓提取 → 距离测量。不依赖线程和信号，可被工作线程、检测线程池等复用。
+ */
+
+#ifndef INSPECTIONCORE_H
+#define INSPECTIONCORE_H
+
+#include <QFuture>
+#include <QList>
+#include <QString>
+#include <QMetaType>
+#include <QMutex>
+
+#include <memory>
+
+#include "../thirdparty/hdevelop/include/halconcpp/HalconCpp.h"
+#include "../thirdparty/hdevelop/include/HalconMeasure.h"
+#include "MeasurementRecord.h"
+#include "TemplateCache.h"
+
+using namespace HalconCpp;
+
+/**
+ * @brief 显示对象信息结构体
+ */
+struct DisplayObjectInfo {
+    HObject object;     // Halcon对象
+    QString color;      // 显示颜色
+    double lineWidth;   // 线宽
+
+    DisplayObjectInfo() : lineWidth(1.0) {}
+    DisplayObjectInfo(const HObject& obj, const QString& col, double width)
+        : object(obj), color(col), lineWidth(width) {}
+};
+
+/**
+ * @brief 单帧检测结果
+ */
+struct InspectionResult {
+  qint64 sequence = -1;                     // 帧序号（批处理中的原始顺序）
+  QString imagePath;                        // 图像路径
+  HObject image;                            // 原始图像
+  QList<DisplayObjectInfo> displayObjects;  // 显示对象列表
+  QString message;                          // 主窗口附加消息，测量结果文本由界面根据 record 生成
+
+  MeasurementRecord record;                 // 匹配与测量结果（定长记录）
+
+  bool matched() const { return record.isMatched(); }
+  bool measured() const { return record.isMeasured(); }
+};
+Q_DECLARE_METATYPE(InspectionResult)
+
+/**
+ * @brief 跟踪搜索窗口配置
+ * @details 传送带上相邻帧的工件位姿变化很小：以上一帧匹配位姿为中心，
+ *          在缩小的区域(ReduceDomain)和角度范围内搜索，失败时按倍数逐级放大，
+ *          全部失败或得分低于阈值时回退到全图搜索。
+ *          检测线程池中各线程共享同一跟踪位姿（见 SearchTrack），按帧序号取用和更新。
+ */
+struct SearchWindowConfig {
+  bool enabled = false;       // 是否启用跟踪模式
+  double radius = 80.0;       // 初始搜索半径(像素)，窗口为以上一帧位置为中心的正方形
+  double angleExtent = 0.1;   // 初始角度半宽(弧度)
+  int widenSteps = 2;         // 放大次数
+  double widenFactor = 2.0;   // 每次放大倍数
+  double minScore = 0.5;      // 窗口匹配最低得分，低于此得分的全图结果不用于跟踪
+  int maxFrameGap = 8;        // 并行检测时参考帧与当前帧的最大帧号差，超过时全图搜索
+};
+
+/**
+ * @brief 跟踪搜索统计
+ */
+struct SearchWindowStats {
+  quint64 frames = 0;           // 统计帧数
+  quint64 windowHits = 0;       // 初始窗口命中
+  quint64 widenedHits = 0;      // 放大窗口后命中
+  quint64 globalSearches = 0;   // 全图搜索次数
+  quint64 globalFallbacks = 0;  // 其中由跟踪失败触发的次数
+  quint64 staleSkips = 0;       // 参考帧过旧（并行检测时帧号差超过 maxFrameGap）而直接全图搜索的次数
+  double windowMs = 0.0;        // 窗口搜索累计耗时(ms)
+  double globalMs = 0.0;        // 全图搜索累计耗时(ms)
+  double savedMs = 0.0;         // 窗口命中帧相对全图搜索平均耗时节省的累计时间(ms)，不小于0
+  double fallbackMs = 0.0;      // 窗口未命中、回退全图搜索前浪费的窗口搜索时间(ms)
+
+  double hitRate() const
+  {
+    return frames > 0 ? static_cast<double>(windowHits + widenedHits) / frames : 0.0;
+  }
+
+  /**
+   * @brief 每帧净节省时间(ms) = (命中节省 - 回退损失) / 帧数
+   */
+  double netSavedMsPerFrame() const
+  {
+    return frames > 0 ? (savedMs - fallbackMs) / frames : 0.0;
+  }
+
+  void merge(const SearchWindowStats& other)
+  {
+    frames += other.frames;
+    windowHits += other.windowHits;
+    widenedHits += other.widenedHits;
+    globalSearches += other.globalSearches;
+    globalFallbacks += other.globalFallbacks;
+    staleSkips += other.staleSkips;
+    windowMs += other.windowMs;
+    globalMs += other.globalMs;
+    savedMs += other.savedMs;
+    fallbackMs += other.fallbackMs;
+  }
+};
+
+/**
+ * @brief 跟踪位姿 | Tracked pose shared in frame order
+ * @details 检测线程池按轮询/窃取分发帧，各线程完成顺序与帧序不同，因此跟踪位姿不能按线程保存。
+ *          所有检测核心共享一个实例：只用帧号早于当前帧且相差不超过 maxFrameGap 的位姿预测，
+ *          只有帧号不早于已记录帧的结果才能更新位姿，乱序完成的旧帧不会覆盖新帧的位姿。
+ *          帧号为负（串行检测，帧本身按顺序处理）时总是使用并更新最新位姿。线程安全。
+ */
+class SearchTrack
+{
+public:
+  struct Pose {
+    bool valid = false;
+    qint64 sequence = -1;     // 产生该位姿的帧号
+    double row = 0.0;
+    double column = 0.0;
+    double angle = 0.0;
+  };
+
+  /**
+   * @brief 取当前帧可用的参考位姿
+   * @return 有可用位姿时返回true；参考帧过旧时返回false 且 stale 为true
+   */
+  bool predict(quint64 generation, qint64 sequence, int maxFrameGap, Pose& pose, bool& stale);
+
+  /**
+   * @brief 用当前帧结果更新位姿，valid 为false 表示该帧匹配失败或得分过低
+   */
+  void update(quint64 generation, qint64 sequence, bool valid, double row, double column, double angle);
+
+  /**
+   * @brief 清除位姿（新批次、配置变化时）
+   */
+  void reset();
+
+private:
+  QMutex m_mutex;
+  quint64 m_generation = 0;   // 位姿对应的模板集版本
+  Pose m_pose;
+};
+
+/**
+ * @brief 全图匹配参数
+ * @details 全图搜索先用快速参数（±22.5°，3层金字塔，高贪婪度），失败时用精确参数（±45°~90°，4层金字塔）。
+ *          投机模式下两组参数在不同线程上同时运行，各自使用独立的模板副本，
+ *          先得到得分不低于 acceptScore 结果的一方胜出，另一方通过 InterruptOperator 取消；
+ *          快速匹配胜出时直接返回，不等待被取消的精确匹配退出。精确匹配模板同时设置超时，
+ *          作为取消未能送达时的兜底，也限定了快速匹配未胜出时的等待时间。
+ */
+struct MatchPassConfig {
+  double fastMinScore = 0.3;      // 快速匹配最低得分
+  double preciseMinScore = 0.2;   // 精确匹配最低得分
+  bool speculative = false;       // 是否启用投机并行匹配
+  double acceptScore = 0.5;       // 投机模式下可直接采用的得分
+  int preciseTimeoutMs = 500;     // 投机模式下精确匹配超时(ms)，0 表示不设置
+};
+
+/**
+ * @brief 投机匹配统计
+ */
+struct SpeculativeMatchStats {
+  quint64 frames = 0;         // 投机匹配帧数
+  quint64 fastWins = 0;       // 快速匹配胜出
+  quint64 preciseWins = 0;    // 精确匹配胜出
+  quint64 misses = 0;         // 两者均无可用结果（或仅有低分快速结果）
+  quint64 cancelled = 0;      // 取消另一方的次数
+  quint64 busySkips = 0;      // 上一帧被取消的精确匹配尚未退出，本帧改为顺序匹配的次数
+  double fastMs = 0.0;        // 快速匹配阶段累计耗时(ms)
+  double totalMs = 0.0;       // 投机匹配累计耗时(ms)，包括等待被取消一方结束
+
+  void merge(const SpeculativeMatchStats& other)
+  {
+    frames += other.frames;
+    fastWins += other.fastWins;
+    preciseWins += other.preciseWins;
+    misses += other.misses;
+    cancelled += other.cancelled;
+    busySkips += other.busySkips;
+    fastMs += other.fastMs;
+    totalMs += other.totalMs;
+  }
+};
+
+/**
+ * @brief 单帧检测核心类
+ * @details 不可在多个线程间共享同一实例；每个检测线程持有自己的实例，测量由实例内的
+ *          HalconMeasure（无界面辅助类）完成，不依赖任何 QWidget，可在任意线程创建。
+ */
+class InspectionCore
+{
+public:
+  InspectionCore() = default;
+
+  /**
+   * @brief 检测一帧图像
+   * @param image 输入图像
+   * @param templateSet 模板集（提供参考位姿和测量区域）
+   * @param modelId 本线程使用的模板句柄（可为模板集句柄的副本）
+   * @param sequence 帧序号（检测线程池中用于按帧序使用跟踪位姿），串行检测时为-1
+   * @return 检测结果，image 字段为输入图像
+   */
+  InspectionResult inspect(const HObject& image, const TemplateSet& templateSet, const HTuple& modelId,
+                           qint64 sequence = -1);
+
+  /**
+   * @brief 使用共享的跟踪位姿（检测线程池中所有检测核心共用一个）
+   */
+  void setSearchTrack(const std::shared_ptr<SearchTrack>& track);
+
+  /**
+   * @brief 配方未指定 parallel 时是否并行执行同层工具（检测开始前调用）
+   * @details 检测线程池有多个线程时设为false，避免 N 个检测线程 × M 个工具争用CPU并阻塞等待
+   */
+  void setParallelToolsByDefault(bool enabled);
+
+  /**
+   * @brief 设置跟踪搜索窗口配置，同时清除跟踪状态
+   */
+  void setSearchWindowConfig(const SearchWindowConfig& config);
+  SearchWindowConfig searchWindowConfig() const;
+
+  /**
+   * @brief 获取跟踪搜索统计
+   */
+  SearchWindowStats searchWindowStats() const;
+  void resetSearchWindowStats();
+
+  /**
+   * @brief 设置全图匹配参数（得分阈值、投机模式）
+   */
+  void setMatchPassConfig(const MatchPassConfig& config);
+  MatchPassConfig matchPassConfig() const;
+
+  /**
+   * @brief 获取投机匹配统计
+   */
+  SpeculativeMatchStats speculativeStats() const;
+
+private:
+  /**
+   * @brief 检测流程主体（inspect() 在其外层计时）
+   */
+  InspectionResult inspectFrame(const HObject& image, const TemplateSet& templateSet, const HTuple& modelId,
+                                qint64 sequence);
+
+  /**
+   * @brief 查找模板：跟踪模式下先在窗口内搜索，失败时全图搜索
+   * @param generation 模板集版本，变化时清除跟踪状态
+   * @param sequence 帧序号，-1 表示串行检测
+   */
+  void findModel(const HObject& grayImage, quint64 generation, qint64 sequence, const HTuple& modelId,
+                 HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore);
+
+  /**
+   * @brief 全图搜索：快速匹配，失败时精确匹配；投机模式下两者同时运行
+   */
+  void globalSearch(const HObject& grayImage, quint64 generation, const HTuple& modelId,
+                    HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore);
+
+  /**
+   * @brief 顺序匹配：快速匹配，失败时精确匹配
+   */
+  void sequentialSearch(const HObject& grayImage, const HTuple& modelId, const MatchPassConfig& config,
+                        HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore);
+
+  /**
+   * @brief 投机并行匹配
+   */
+  void speculativeSearch(const HObject& grayImage, quint64 generation, const HTuple& modelId,
+                         const MatchPassConfig& config,
+                         HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore);
+
+  /**
+   * @brief 获取精确匹配专用的模板副本，模板集版本或超时设置变化时释放旧副本并重新复制
+   * @return 复制失败时返回空句柄（不与快速匹配共用句柄）
+   */
+  HTuple ensurePreciseModel(quint64 generation, const HTuple& modelId, int timeoutMs);
+
+  static void findFast(const HObject& grayImage, const HTuple& modelId, double minScore,
+                       HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore);
+  static void findPrecise(const HObject& grayImage, const HTuple& modelId, double minScore,
+                          HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore);
+
+private:
+  HalconMeasure m_measure;  // 轮廓提取、一维边缘测量
+
+  // 配置与统计可从其他线程读写，由 m_configMutex 保护
+  mutable QMutex m_configMutex;
+  SearchWindowConfig m_searchConfig;
+  SearchWindowStats m_searchStats;
+  MatchPassConfig m_matchConfig;
+  SpeculativeMatchStats m_speculativeStats;
+
+  // 跟踪状态
+  std::shared_ptr<SearchTrack> m_track = std::make_shared<SearchTrack>(); // 跟踪位姿，线程池中共享
+  double m_globalMsAverage = 0.0;     // 全图搜索耗时滑动平均(ms)
+
+  // 检测配方执行计划的每线程状态（预分配，计划变化时重新分配）
+  InspectionPlanState m_planState;
+
+  // 投机模式下精确匹配专用的模板副本（只在检测线程中访问）
+  QFuture<void> m_preciseFuture;      // 最近一次精确匹配任务，快速匹配胜出时可能仍在退出
+  HTuple m_preciseModel;
+  quint64 m_preciseModelGeneration = 0;
+  int m_preciseModelTimeoutMs = 0;
+};
+
+#endif //INSPECTIONCORE_H
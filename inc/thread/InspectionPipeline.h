@@ -0,0 +1,146 @@
+/**
+ * @file InspectionPipeline.h
+ * @brief 批量检测流水线 | Batch decode → inspect → publish pipeline
+ *
+ * 三个阶段并发运行，阶段之间由有界队列连接：
+ *  - 解码阶段：独立线程从图像来源（目录快照或监视目录）提前读取后续 K 张图像；
+ *  - 检测阶段：调用线程串行检测，或提交到检测线程池并行检测；
+ *  - 发布阶段：独立线程按顺序执行界面信号、结果保存等发布操作。
+ * 整体吞吐量取决于最慢的阶段而非各阶段耗时之和。
+ */
+
+#ifndef INSPECTIONPIPELINE_H
+#define INSPECTIONPIPELINE_H
+
+#include <QFileInfoList>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+#include "BoundedQueue.h"
+#include "ImageSource.h"
+#include "InspectionCore.h"
+#include "LatencyProfiler.h"
+#include "TemplateCache.h"
+
+class InspectionPool;
+
+/**
+ * @brief 流水线阶段统计信息
+ */
+struct PipelineStageStats {
+  QString name;               // 阶段名称
+  quint64 items = 0;          // 处理数量
+  double busyMs = 0.0;        // 实际工作耗时(ms)
+  double inputStallMs = 0.0;  // 等待上游输入的时间(ms)
+  double outputStallMs = 0.0; // 等待下游空位的时间(ms)
+  int queueCapacity = 0;      // 输入队列容量（解码阶段无输入队列）
+  int maxQueueDepth = 0;      // 输入队列最大深度
+  double avgQueueDepth = 0.0; // 输入队列平均深度
+};
+
+/**
+ * @brief 批量检测流水线
+ * @details 每次 run() 处理一个批次，结束时所有阶段线程均已退出。
+ */
+class InspectionPipeline
+{
+public:
+  using Publisher = std::function<void(const InspectionResult&)>;
+  using ContinueCheck = std::function<bool()>;
+  using ErrorHandler = std::function<void(const QString&)>;
+
+  /**
+   * @brief 构造函数
+   * @param core 串行检测核心（pool 为空时在调用线程中使用）
+   * @param cache 模板缓存
+   * @param pool 检测线程池，可为nullptr
+   */
+  InspectionPipeline(InspectionCore* core, TemplateCache* cache, InspectionPool* pool = nullptr);
+
+  /**
+   * @brief 设置解码预读数量（解码队列容量）
+   */
+  void setPrefetchDepth(int depth);
+
+  /**
+   * @brief 设置发布队列容量
+   */
+  void setPublishDepth(int depth);
+
+  /**
+   * @brief 添加发布操作，按添加顺序在发布线程中执行
+   */
+  void addPublisher(const Publisher& publisher);
+
+  /**
+   * @brief 设置继续运行判断，返回false时停止读取后续图像
+   */
+  void setContinueCheck(const ContinueCheck& check);
+
+  /**
+   * @brief 设置错误回调（在解码线程中调用）
+   */
+  void setErrorHandler(const ErrorHandler& handler);
+
+  /**
+   * @brief 处理一个批次，阻塞直到所有结果发布完成
+   * @param files 图像文件列表
+   * @return 已发布的结果数量
+   */
+  int run(const QFileInfoList& files);
+
+  /**
+   * @brief 处理图像来源中的所有图像，阻塞直到来源结束且所有结果发布完成
+   * @details 每个结果发布后调用 source.markProcessed()，图像读取失败时调用 source.markFailed()。
+   * @param source 图像来源
+   * @return 已发布的结果数量
+   */
+  int run(ImageSource& source);
+
+  /**
+   * @brief 获取最近一次运行的各阶段统计
+   */
+  QList<PipelineStageStats> stageStats() const;
+
+  /**
+   * @brief 最近一次运行的入队延迟（文件写入完成 → 开始检测）统计，来源未提供就绪时间时无样本
+   */
+  LatencySnapshot ingestLatency() const;
+
+  /**
+   * @brief 生成最近一次运行的统计摘要文本
+   */
+  QString statsSummary() const;
+
+private:
+  struct DecodedFrame {
+    qint64 sequence = -1;
+    QString imagePath;
+    qint64 readyMs = 0;   // 文件写入完成时间(ms, 自纪元起)
+    HObject image;
+  };
+
+  void decodeStage(ImageSource& source, BoundedQueue<DecodedFrame>& decodeQueue, PipelineStageStats& stats);
+  void publishStage(ImageSource& source, BoundedQueue<InspectionResult>& publishQueue, PipelineStageStats& stats);
+  void recordIngestLatency(const DecodedFrame& frame);
+  InspectionResult inspectSerial(const DecodedFrame& frame);
+
+private:
+  InspectionCore* m_core = nullptr;
+  TemplateCache* m_cache = nullptr;
+  InspectionPool* m_pool = nullptr;
+
+  int m_prefetchDepth = 4;
+  int m_publishDepth = 8;
+  QList<Publisher> m_publishers;
+  ContinueCheck m_continueCheck;
+  ErrorHandler m_errorHandler;
+
+  QList<PipelineStageStats> m_stats;  // 最近一次运行的统计
+  double m_wallMs = 0.0;              // 最近一次运行的总耗时(ms)
+  LatencyHistogram m_ingestLatency;   // 最近一次运行的入队延迟
+};
+
+#endif //INSPECTIONPIPELINE_H
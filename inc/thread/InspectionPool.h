@@ -0,0 +1,174 @@
+/**
+ * @file InspectionPool.h
+ * @brief 多线程检测池 | Multi-worker inspection pool
+ *
+ * N 个检测线程各自持有模板句柄副本和检测核心（含无界面测量辅助类），
+ * 任务按轮询分发到各线程的本地队列，空闲线程从其他队列尾部窃取任务；
+ * 结果经重排序后按提交顺序发出，界面看到的帧顺序与单线程处理一致。
+ */
+
+#ifndef INSPECTIONPOOL_H
+#define INSPECTIONPOOL_H
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+
+#include "InspectionCore.h"
+#include "TemplateCache.h"
+
+class QThread;
+
+/**
+ * @brief 检测线程统计信息
+ */
+struct InspectionWorkerStats {
+  int index = 0;              // 线程序号
+  quint64 processed = 0;      // 已处理帧数
+  quint64 stolen = 0;         // 从其他线程窃取的帧数
+  double busyMs = 0.0;        // 累计检测耗时(ms)
+  double utilisation = 0.0;   // 利用率 = 检测耗时 / 池运行时间
+};
+
+/**
+ * @brief 多线程检测池
+ * @details 不依赖任何 QWidget，可在任意线程创建；submit() 可在任意线程调用。
+ */
+class InspectionPool : public QObject
+{
+  Q_OBJECT
+
+public:
+  /**
+   * @brief 构造函数
+   * @param cache 模板缓存（线程池不持有）
+   * @param workerCount 检测线程数量，小于1时按1处理
+   * @param parent 父对象
+   */
+  InspectionPool(TemplateCache* cache, int workerCount, QObject* parent = nullptr);
+  ~InspectionPool() override;
+
+  /**
+   * @brief 启动检测线程
+   */
+  void start();
+
+  /**
+   * @brief 停止检测线程，未处理的任务被丢弃
+   */
+  void stop();
+
+  /**
+   * @brief 开始新的批次，帧序号从0重新计数
+   */
+  void beginBatch();
+
+  /**
+   * @brief 提交一帧图像
+   * @param image 图像对象
+   * @param imagePath 图像路径（用于结果记录）
+   * @return 分配的帧序号
+   */
+  qint64 submit(const HObject& image, const QString& imagePath = QString());
+
+  /**
+   * @brief 等待已提交的帧全部发出结果
+   * @param msecs 超时时间（毫秒），-1 表示一直等待
+   * @return 是否全部完成
+   */
+  bool waitForDone(int msecs = -1);
+
+  /**
+   * @brief 获取检测线程数量
+   */
+  int workerCount() const;
+
+  /**
+   * @brief 获取各检测线程统计信息
+   */
+  QList<InspectionWorkerStats> workerStats() const;
+
+  /**
+   * @brief 生成线程利用率摘要文本
+   */
+  QString utilisationSummary() const;
+
+  /**
+   * @brief 设置所有检测线程的跟踪搜索窗口配置
+   */
+  void setSearchWindowConfig(const SearchWindowConfig& config);
+
+  /**
+   * @brief 获取所有检测线程合计的跟踪搜索统计
+   */
+  SearchWindowStats searchWindowStats() const;
+
+  /**
+   * @brief 设置所有检测线程的全图匹配参数
+   */
+  void setMatchPassConfig(const MatchPassConfig& config);
+
+  /**
+   * @brief 获取所有检测线程合计的投机匹配统计
+   */
+  SpeculativeMatchStats speculativeStats() const;
+
+signals:
+  /**
+   * @brief 按提交顺序发出的检测结果
+   */
+  void resultReady(const InspectionResult& result);
+
+private:
+  struct Task {
+    qint64 sequence = -1;
+    HObject image;
+    QString imagePath;
+  };
+
+  struct Worker {
+    int index = 0;
+    QThread* thread = nullptr;
+    InspectionCore core;
+    QMutex queueMutex;             // 保护本地队列
+    std::deque<Task> queue;        // 本地任务队列：本线程从头部取，其他线程从尾部窃取
+    quint64 modelGeneration = 0;   // 模板副本对应的模板集版本
+    HTuple modelId;                // 本线程的模板句柄副本
+    std::atomic<quint64> processed{0};
+    std::atomic<quint64> stolen{0};
+    std::atomic<qint64> busyNs{0};
+  };
+
+  void runWorker(Worker* worker);
+  bool takeTask(Worker* worker, Task& task);
+  void ensureModelCopy(Worker* worker, const TemplateSet& templateSet);
+  void deliver(InspectionResult&& result);
+
+private:
+  TemplateCache* m_cache = nullptr;
+  QList<Worker*> m_workers;
+
+  QMutex m_wakeMutex;                 // 配合 m_wakeCondition 使用
+  QWaitCondition m_wakeCondition;     // 有新任务或停止时唤醒检测线程
+  std::atomic<int> m_pendingTasks{0}; // 所有队列中的任务总数
+  std::atomic<bool> m_stopping{false};
+  std::atomic<quint64> m_nextWorker{0}; // 轮询分发位置（无符号，溢出后仍从0开始循环）
+
+  QMutex m_reorderMutex;              // 保护重排序缓冲区
+  QWaitCondition m_doneCondition;     // 批次完成通知
+  QMap<qint64, InspectionResult> m_reorderBuffer; // 等待按序发出的结果
+  qint64 m_nextSequence = 0;          // 下一个提交序号
+  qint64 m_nextToDeliver = 0;         // 下一个应发出的序号
+
+  QElapsedTimer m_uptime;             // 池运行计时
+  std::shared_ptr<SearchTrack> m_track; // 所有检测线程共享的跟踪位姿，按帧序号使用和更新
+};
+
+#endif //INSPECTIONPOOL_H
@@ -0,0 +1,240 @@
+/**
+ * @file InspectionRecipe.h
+ * @brief 检测配方与执行计划 | Inspection recipe and compiled execution plan
+ *
+ * 配方(JSON)声明测量区域(ROI)、测量工具、记录字段和公差，更换产品时只需修改配方文件。
+ * 加载模板集时配方被编译为执行计划：ROI 预先读取为区域句柄，工具按依赖关系分层并解析为下标，
+ * 每个检测线程持有预分配的 InspectionPlanState，之后每帧复用。同一层中互不依赖的工具并行执行。
+ *
+ * 配方格式：
+ * @code
+ * {
+ *   "name": "default",
+ *   "parallel": false,
+ *   "rois": [
+ *     {"name": "rect1", "source": "measure_rect1", "color": "green", "line_width": 2},
+ *     {"name": "slot", "file": "Check/slot_region.hobj"}
+ *   ],
+ *   "tools": [
+ *     {"name": "edge1", "type": "contour", "roi": "rect1", "threshold": 100, "color": "red"},
+ *     {"name": "edge2", "type": "contour", "roi": "rect2", "threshold": 100, "color": "blue"},
+ *     {"name": "gap", "type": "distance", "inputs": ["edge1", "edge2"],
+ *      "record": {"min": "MinDistance", "max": "MaxDistance"},
+ *      "tolerance": {"value": "min", "min": 10.0, "max": 12.5}}
+ *   ]
+ * }
+ * @endcode
+ * 工具类型与输出值：
+ * - contour：ROI 内阈值 threshold 的最长亚像素轮廓，输出 length
+ * - distance：两个 contour 的距离(mode 默认 point_to_point)，输出 min、max
+ * - area：ROI 面积与重心，输出 area、row、column
+ * - edge：旋转矩形 ROI 内沿长轴的一维测量，取幅值最大的亚像素边缘（sigma 默认1.0，threshold 为最小幅值，
+ *   默认30），输出 amplitude、row、column
+ * - width：同上的一维测量，取第一个边缘对，输出 width 及两边缘中点 row、column
+ *   edge/width 可用 direction（度，与 gen_rectangle2 的 phi 同义）指定剖面方向，随模板位姿旋转；
+ *   未指定时取 ROI 最小外接矩形的角度，方向可能与绘制时相反或转过90°
+ * - point_distance：两个 area 或 edge 工具的点（重心/边缘点）间距离，输出 distance
+ * 两条边缘的间距用两个 edge 加 point_distance，或一个跨两条边缘的 width，代替 contour + distance，
+ * 只计算一维剖面而不提取二维轮廓。
+ * ROI 的 source 取模板集内置区域(measure_rect1/measure_rect2)，file 为相对配方文件目录的 .hobj 路径。
+ * parallel 可省略：省略时只有单个检测线程才并行执行同层工具，检测线程池有多个线程时各帧已占满CPU，
+ * 工具再并行只会让每个检测线程阻塞等待工具线程池。
+ */
+
+#ifndef INSPECTIONRECIPE_H
+#define INSPECTIONRECIPE_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <limits>
+#include <memory>
+#include <optional>
+
+#include "../thirdparty/hdevelop/include/halconcpp/HalconCpp.h"
+#include "MeasurementRecord.h"
+
+using namespace HalconCpp;
+
+class HalconMeasure;
+struct TemplateSet;
+struct InspectionResult;
+
+/**
+ * @brief 单个工具最多输出的数值个数
+ */
+constexpr int kRecipeMaxToolValues = 3;
+
+/**
+ * @brief 测量工具类型
+ */
+enum class RecipeToolType : int {
+  Contour = 0,    // 最长亚像素轮廓
+  Distance,       // 两轮廓距离
+  Area,           // 区域面积与重心
+  PointDistance,  // 两点距离
+  Edge,           // 一维测量最强边缘
+  Width           // 一维测量边缘对宽度
+};
+
+/**
+ * @brief 编译后的测量区域（模板坐标系）
+ */
+struct RecipeRoi {
+  QString name;
+  HObject region;
+  QString color = "green";
+  double lineWidth = 2.0;
+  bool display = true;
+};
+
+/**
+ * @brief 编译后的工具公差
+ */
+struct RecipeTolerance {
+  int valueIndex = -1;   // 判定的输出值下标，-1表示不判定
+  double min = -std::numeric_limits<double>::infinity();
+  double max = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief 编译后的工具（名称已解析为下标）
+ */
+struct RecipeStep {
+  QString name;
+  RecipeToolType type = RecipeToolType::Contour;
+  int roi = -1;                                  // contour/area/edge/width 使用的ROI下标
+  int inputs[2] = {-1, -1};                      // distance/point_distance 的输入工具下标
+  int threshold = 100;                           // contour 灰度阈值，edge/width 最小边缘幅值
+  double sigma = 1.0;                            // edge/width 高斯平滑σ
+  std::optional<double> direction;               // edge/width 剖面方向（模板坐标系，弧度），未指定时取外接矩形角度
+  QString distanceMode = "point_to_point";       // distance 模式
+  QString color;                                 // 显示颜色，为空时不显示
+  double lineWidth = 3.0;
+  int recordFields[kRecipeMaxToolValues] = {-1, -1, -1}; // 输出值写入的记录字段，-1表示不写入
+  RecipeTolerance tolerance;
+};
+
+/**
+ * @brief 工具每帧的输出（预分配，按工具下标存放）
+ */
+struct RecipeStepOutput {
+  HObject object;                               // contour 的轮廓，edge/width 的标记
+  double values[kRecipeMaxToolValues] = {};
+  bool ok = false;
+};
+
+/**
+ * @brief 执行计划的每线程状态，按计划预分配后每帧复用
+ */
+struct InspectionPlanState {
+  quint64 planId = 0;                   // 对应的计划编号，计划变化时重新分配
+  QVector<HObject> mappedRois;          // 映射到当前位姿的ROI
+  QVector<RecipeStepOutput> outputs;    // 工具输出
+  bool parallelByDefault = true;        // 配方未指定 parallel 时是否并行执行同层工具
+  double rotation = 0.0;                // 本帧模板坐标系到图像的旋转角（弧度），用于换算工具方向
+};
+
+class InspectionPlan;
+using InspectionPlanPtr = std::shared_ptr<const InspectionPlan>;
+
+/**
+ * @brief 编译后的执行计划（编译完成后只读，可被多个检测线程共享）
+ */
+class InspectionPlan
+{
+public:
+  /**
+   * @brief 编译配方
+   * @param recipe 配方JSON
+   * @param templateSet 模板集（提供内置区域和已预加载的参数区域）
+   * @param baseDir ROI 相对路径的基准目录
+   * @param error 失败原因
+   * @return 失败时返回空指针
+   */
+  static InspectionPlanPtr compile(const QJsonObject& recipe, const TemplateSet& templateSet,
+                                   const QString& baseDir, QString& error);
+
+  /**
+   * @brief 只检查配方结构（工具类型、引用、依赖环），不读取区域文件
+   */
+  static bool validate(const QJsonObject& recipe, QString& error);
+
+  /**
+   * @brief 与原固定检测流程等价的默认配方
+   */
+  static QJsonObject defaultRecipe();
+
+  /**
+   * @brief 读取配方文件，文件不存在时返回默认配方
+   * @param path 配方文件路径
+   * @param error 文件存在但无法解析时的原因（此时返回空对象）
+   */
+  static QJsonObject loadRecipe(const QString& path, QString& error);
+
+  /**
+   * @brief 保存配方文件
+   */
+  static bool saveRecipe(const QString& path, const QJsonObject& recipe, QString& error);
+
+  /**
+   * @brief 工具类型的输出值名称
+   */
+  static QStringList valueNames(RecipeToolType type);
+
+  /**
+   * @brief 按计划分配每线程状态（计划未变化时不重新分配）
+   */
+  void prepare(InspectionPlanState& state) const;
+
+  /**
+   * @brief 执行计划
+   * @param image 输入图像
+   * @param homMat2D 模板坐标系到图像的仿射变换
+   * @param helper 无界面测量辅助类（const 函数，可并行调用）
+   * @param state 每线程状态
+   * @param result 检测结果，写入显示对象和测量记录
+   * @return 所有写入记录的工具均成功时返回true
+   */
+  bool execute(const HObject& image, const HTuple& homMat2D, const HalconMeasure& helper,
+               InspectionPlanState& state, InspectionResult& result) const;
+
+  QString name() const { return m_name; }
+  quint64 id() const { return m_id; }
+  int stepCount() const { return m_steps.size(); }
+  int stageCount() const { return m_stages.size(); }
+  /**
+   * @brief 使用该状态执行时同层工具是否并行（配方指定时以配方为准）
+   */
+  bool isParallel(const InspectionPlanState& state) const;
+
+  /**
+   * @brief 计划摘要（ROI数、工具数和分层）
+   */
+  QString summary() const;
+
+private:
+  InspectionPlan() = default;
+
+  /**
+   * @brief 编译实现；templateSet 为空时只检查结构，不解析区域
+   */
+  static InspectionPlanPtr build(const QJsonObject& recipe, const TemplateSet* templateSet,
+                                 const QString& baseDir, QString& error);
+
+  void runStep(int index, const HObject& image, const HalconMeasure& helper, InspectionPlanState& state) const;
+
+private:
+  enum class ParallelMode { Auto, Enabled, Disabled };
+
+  quint64 m_id = 0;
+  QString m_name;
+  ParallelMode m_parallel = ParallelMode::Auto;   // 配方 parallel 字段，省略时为 Auto
+  QVector<RecipeRoi> m_rois;
+  QVector<RecipeStep> m_steps;
+  QVector<QVector<int>> m_stages;   // 按依赖分层的工具下标，同层工具互不依赖
+};
+
+#endif //INSPECTIONRECIPE_H
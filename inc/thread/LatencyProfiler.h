@@ -0,0 +1,196 @@
+/**
+ * @file LatencyProfiler.h
+ * @brief 检测流程分阶段耗时统计 | Per-stage latency histograms for the inspection path
+ *
+ * 用法：在需要计时的作用域开头写 PROFILE_STAGE(InspectionStage::xxx)，
+ * 作用域结束时该阶段本帧的纳秒耗时被写入对应的无锁直方图。
+ * 关闭统计时计时器只读取一次原子开关，不读取时钟，开销可忽略。
+ */
+
+#ifndef LATENCYPROFILER_H
+#define LATENCYPROFILER_H
+
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief 检测流程阶段
+ */
+enum class InspectionStage : int {
+  Preprocess = 0,     // 灰度转换等预处理
+  FindShapeWindow,    // 跟踪窗口内模板匹配（含逐级放大）
+  FindShapeFast,      // 快速模板匹配
+  FindShapePrecise,   // 精确模板匹配（快速匹配失败时）
+  RigidTransform,     // VectorAngleToRigid
+  RecipeExecute,      // 检测配方执行计划（ROI映射 + 各层测量工具）
+  ContourExtract,     // 配方 contour 工具：区域内最长轮廓提取（每个工具一个样本）
+  DistanceMeasure,    // 配方 distance 工具：DistanceCc
+  AreaMeasure,        // 配方 area 工具：面积、重心计算
+  PointDistance,      // 配方 point_distance 工具
+  EdgeMeasure,        // 配方 edge 工具：一维测量最强边缘
+  WidthMeasure,       // 配方 width 工具：一维测量边缘对
+  Total,              // 单帧检测总耗时
+  Count
+};
+
+/**
+ * @brief 单个直方图的统计快照
+ */
+struct LatencySnapshot {
+  std::uint64_t count = 0;    // 样本数量
+  double meanUs = 0.0;        // 平均值(us)
+  double p50Us = 0.0;         // 50分位(us)
+  double p95Us = 0.0;         // 95分位(us)
+  double p99Us = 0.0;         // 99分位(us)
+  double maxUs = 0.0;         // 最大值(us)
+};
+
+/**
+ * @brief 无锁对数直方图
+ * @details 每个2的幂区间划分为8个子桶，相对误差不超过12.5%；
+ *          record() 只有几次 relaxed 原子操作，可被多个检测线程并发调用。
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram();
+
+  /**
+   * @brief 记录一个样本
+   * @param nanoseconds 耗时(ns)
+   */
+  void record(std::uint64_t nanoseconds);
+
+  /**
+   * @brief 清空所有样本
+   */
+  void reset();
+
+  /**
+   * @brief 获取统计快照（与 record() 并发时结果为近似值）
+   */
+  LatencySnapshot snapshot() const;
+
+  static int bucketIndex(std::uint64_t value);
+  static std::uint64_t bucketLowerBound(int index);
+  static std::uint64_t bucketUpperBound(int index);
+
+private:
+  std::array<std::atomic<std::uint64_t>, kBucketCount> m_buckets;
+  std::atomic<std::uint64_t> m_count{0};
+  std::atomic<std::uint64_t> m_sum{0};
+  std::atomic<std::uint64_t> m_max{0};
+};
+
+/**
+ * @brief 分阶段耗时统计器（全局单例）
+ */
+class LatencyProfiler
+{
+public:
+  static LatencyProfiler& instance();
+
+  /**
+   * @brief 开启或关闭统计
+   */
+  void setEnabled(bool enabled);
+
+  bool isEnabled() const
+  {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 设置周期摘要的间隔，0 表示不输出周期摘要
+   * @param seconds 间隔(秒)
+   */
+  void setReportInterval(int seconds);
+
+  /**
+   * @brief 记录一个阶段耗时
+   */
+  void record(InspectionStage stage, std::uint64_t nanoseconds);
+
+  /**
+   * @brief 获取某阶段的统计快照
+   */
+  LatencySnapshot snapshot(InspectionStage stage) const;
+
+  /**
+   * @brief 清空所有阶段的统计
+   */
+  void reset();
+
+  /**
+   * @brief 距上次周期摘要是否已超过间隔；多个线程同时调用时只有一个返回true
+   */
+  bool reportDue();
+
+  /**
+   * @brief 生成所有有样本阶段的统计摘要
+   */
+  QString summary() const;
+
+  static const char* stageName(InspectionStage stage);
+
+private:
+  LatencyProfiler() = default;
+  LatencyProfiler(const LatencyProfiler&) = delete;
+  LatencyProfiler& operator=(const LatencyProfiler&) = delete;
+
+  std::atomic<bool> m_enabled{false};
+  std::atomic<std::int64_t> m_reportIntervalNs{30LL * 1000 * 1000 * 1000};
+  std::atomic<std::int64_t> m_lastReportNs{0};
+  std::array<LatencyHistogram, static_cast<int>(InspectionStage::Count)> m_histograms;
+};
+
+/**
+ * @brief 作用域计时器
+ * @details 构造时若统计关闭则不读取时钟，析构时不做任何事。
+ */
+class ScopedStageTimer
+{
+public:
+  explicit ScopedStageTimer(InspectionStage stage) :
+    m_stage(stage)
+    , m_active(LatencyProfiler::instance().isEnabled())
+  {
+    if (m_active)
+    {
+      m_start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedStageTimer()
+  {
+    if (m_active)
+    {
+      auto elapsed = std::chrono::steady_clock::now() - m_start;
+      LatencyProfiler::instance().record(
+          m_stage, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+  }
+
+  ScopedStageTimer(const ScopedStageTimer&) = delete;
+  ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+  InspectionStage m_stage;
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+#define PROFILE_STAGE_CONCAT_INNER(a, b) a##b
+#define PROFILE_STAGE_CONCAT(a, b) PROFILE_STAGE_CONCAT_INNER(a, b)
+// 对当前作用域计时
+#define PROFILE_STAGE(stage) ScopedStageTimer PROFILE_STAGE_CONCAT(profileStageTimer_, __LINE__)(stage)
+
+#endif //LATENCYPROFILER_H
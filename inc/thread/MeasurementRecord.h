@@ -0,0 +1,144 @@
+/**
+ * @file MeasurementRecord.h
+ * @brief 定长测量结果记录与预分配环形缓冲 | Fixed-layout measurement records and preallocated ring buffer
+ *
+ * 检测核心每帧产出一条 MeasurementRecord（POD，可直接按字节复制，不涉及堆分配），
+ * 发布阶段写入预分配的 MeasurementRing。只有在界面显示、导出时才转换为 QVariantMap 或文本。
+ */
+
+#ifndef MEASUREMENTRECORD_H
+#define MEASUREMENTRECORD_H
+
+#include <QMutex>
+#include <QString>
+#include <QVariantMap>
+
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief 测量记录格式版本，字段布局变化时递增
+ */
+constexpr quint32 kMeasurementSchemaId = 1;
+
+/**
+ * @brief 测量字段（MeasurementRecord::values 的下标）
+ */
+enum class MeasurementField : int {
+  MinDistance = 0,    // 最小距离
+  MaxDistance,        // 最大距离
+  CentroidDistance,   // 重心距离
+  Area1,              // 区域1面积
+  Area2,              // 区域2面积
+  Centroid1X,         // 重心1 X
+  Centroid1Y,         // 重心1 Y
+  Centroid2X,         // 重心2 X
+  Centroid2Y,         // 重心2 Y
+  MatchScore,         // 模板匹配得分
+  MatchRow,           // 模板位置Row
+  MatchColumn,        // 模板位置Column
+  MatchAngle,         // 模板角度
+  Count
+};
+
+/**
+ * @brief 单帧测量结果记录
+ */
+struct MeasurementRecord {
+  enum Flag : quint32 {
+    Matched = 0x1,        // 找到模板
+    Measured = 0x2,       // 完成距离测量
+    OutOfTolerance = 0x4  // 配方公差判定不合格
+  };
+
+  quint32 schemaId = kMeasurementSchemaId;
+  quint32 flags = 0;
+  qint64 sequence = -1;       // 帧序号
+  qint64 timestampMs = 0;     // 检测完成时间(ms, 自纪元起)
+  double values[static_cast<int>(MeasurementField::Count)] = {};
+  double inspectMs = 0.0;     // 单帧检测耗时(ms)
+
+  double value(MeasurementField field) const
+  {
+    return values[static_cast<int>(field)];
+  }
+
+  void set(MeasurementField field, double value)
+  {
+    values[static_cast<int>(field)] = value;
+  }
+
+  bool isMatched() const { return (flags & Matched) != 0; }
+  bool isMeasured() const { return (flags & Measured) != 0; }
+  bool isInTolerance() const { return (flags & OutOfTolerance) == 0; }
+};
+
+static_assert(std::is_trivially_copyable<MeasurementRecord>::value, "MeasurementRecord must stay POD-like");
+
+/**
+ * @brief 字段名称（与 HalconLable::measurementCache 的键一致）
+ */
+QString measurementFieldName(MeasurementField field);
+
+/**
+ * @brief 转换为 QVariantMap（仅在界面/导出边界调用）
+ * @param record 测量记录
+ * @param measuredOnly 为true时未完成测量的记录只输出匹配字段
+ */
+QVariantMap measurementToVariantMap(const MeasurementRecord& record, bool measuredOnly = true);
+
+/**
+ * @brief 生成主窗口显示的测量结果文本，未完成测量时返回空字符串
+ */
+QString measurementMessage(const MeasurementRecord& record);
+
+/**
+ * @brief 预分配的测量记录环形缓冲
+ * @details 构造时一次性分配全部容量，写满后覆盖最旧的记录；push() 只做一次定长复制。
+ *          所有函数均为线程安全。
+ */
+class MeasurementRing
+{
+public:
+  explicit MeasurementRing(int capacity = 4096);
+
+  /**
+   * @brief 写入一条记录
+   */
+  void push(const MeasurementRecord& record);
+
+  /**
+   * @brief 获取最新一条记录
+   * @return 缓冲为空时返回false
+   */
+  bool latest(MeasurementRecord& record) const;
+
+  /**
+   * @brief 按从旧到新的顺序复制最近的记录
+   * @param out 输出数组
+   * @param maxCount 最多复制的数量
+   * @return 实际复制的数量
+   */
+  int copyRecent(MeasurementRecord* out, int maxCount) const;
+
+  /**
+   * @brief 清空记录（不释放内存）
+   */
+  void clear();
+
+  int capacity() const;
+  int size() const;
+
+  /**
+   * @brief 累计写入数量（含已被覆盖的）
+   */
+  quint64 totalPushed() const;
+
+private:
+  mutable QMutex m_mutex;
+  std::vector<MeasurementRecord> m_records;
+  quint64 m_pushed = 0;     // 下一条记录的写入序号
+  int m_size = 0;
+};
+
+#endif //MEASUREMENTRECORD_H
@@ -0,0 +1,293 @@
+/**
+ * @file TemplateCache.h
+ * @brief 模板/测量区域常驻缓存 | Resident template and ROI cache
+ *
+ * 视觉工作线程使用的模板缓存：一次性加载形状模板(.shm)、模板位姿(*data.tup)、
+ * 测量区域(.hobj)以及二维码/测量/检测参数目录中的区域、参数与二维码模型，句柄常驻内存；
+ * 各文件在线程池中并行加载。启动时预加载，文件监视器发现更新的文件后重新加载，
+ * 切换配方时按新目录加载；加载完成后以原子方式替换当前模板集，正在使用旧模板集的帧不受影响。
+ */
+
+#ifndef TEMPLATECACHE_H
+#define TEMPLATECACHE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QMap>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "../thirdparty/hdevelop/include/halconcpp/HalconCpp.h"
+#include "InspectionRecipe.h"
+
+using namespace HalconCpp;
+
+class QFileSystemWatcher;
+class QThread;
+class QTimer;
+
+/**
+ * @brief 模板文件目录（一个配方对应一组目录）
+ */
+struct TemplatePaths {
+  QString modelDir;         // 形状模板及位姿文件目录（DetectionModel）
+  QString measureDir;       // 测量区域与测量参数目录（Measure）
+  QString qrCodeDir;        // 二维码区域、参数与模型目录（QRCode）
+  QString checkDir;         // 检测区域与参数目录（Check）
+  QString recipeFile;       // 检测配方(JSON)，为空或不存在时使用默认配方
+};
+
+/**
+ * @brief 单个模板文件的加载耗时
+ */
+struct TemplateAssetTiming {
+  QString path;             // 文件路径
+  QString kind;             // shape_model / pose / measure_region / region / tuple / data_code
+  double loadMs = 0.0;      // 加载耗时(ms)
+  bool ok = false;          // 是否加载成功
+  QString error;            // 失败原因
+};
+
+/**
+ * @brief 一次模板集加载的报告
+ */
+struct TemplateLoadReport {
+  bool ok = false;                      // 模板集是否可用（形状模板加载成功）
+  quint64 generation = 0;               // 加载成功后的模板集版本号
+  int threads = 0;                      // 并行加载线程数
+  double wallMs = 0.0;                  // 总耗时(ms)
+  double sumMs = 0.0;                   // 各文件加载耗时之和(ms)，与 wallMs 之比即并行加速比
+  QVector<TemplateAssetTiming> assets;  // 各文件耗时（按耗时降序）
+  QString error;                        // 失败原因
+
+  /**
+   * @brief 生成报告文本（总耗时与最慢的若干文件）
+   */
+  QString summary(int slowest = 5) const;
+};
+
+/**
+ * @brief 一组已加载的模板数据（加载完成后只读）
+ * @details HTuple 内部的模型句柄带引用计数，最后一个持有者释放时Halcon自动清除模型，
+ *          因此旧模板集会在最后一帧使用完毕后才被释放。
+ */
+struct TemplateSet {
+  quint64 generation = 0;   // 模板集版本号，每次重新加载递增
+  HTuple modelId;           // 形状模板句柄
+  HTuple row;               // 模板参考位置Row
+  HTuple column;            // 模板参考位置Column
+  HTuple angle;             // 模板参考角度
+  HObject measureRect1;     // 测量区域1（模板坐标系）
+  HObject measureRect2;     // 测量区域2（模板坐标系）
+  QString modelFile;        // 模板文件路径
+  QString poseFile;         // 位姿参数文件路径
+  QDateTime loadTime;       // 加载完成时间
+  TemplatePaths paths;      // 加载时使用的目录
+
+  QMap<QString, HObject> regions;         // 参数目录中的区域/对象(.hobj)，键为文件路径
+  QMap<QString, HTuple> params;           // 参数目录中的参数(.tup)，键为文件路径
+  QMap<QString, HTuple> dataCodeModels;   // 二维码模型(.dcm 或 *_qr_params.tup 生成)，键为文件路径
+  InspectionPlanPtr plan;                 // 由检测配方编译的执行计划，编译失败时为空
+
+  bool isValid() const { return modelId.Length() > 0; }
+  bool hasMeasureRegions() const { return measureRect1.IsInitialized() && measureRect2.IsInitialized(); }
+};
+
+using TemplateSetPtr = std::shared_ptr<const TemplateSet>;
+
+/**
+ * @brief 模板缓存统计信息
+ */
+struct TemplateCacheStats {
+  quint64 hits = 0;          // 直接命中常驻模板的次数
+  quint64 misses = 0;        // 需要同步加载的次数
+  quint64 reloads = 0;       // 成功加载次数
+  quint64 failedReloads = 0; // 加载失败次数
+  double lastLoadMs = 0.0;   // 最近一次加载耗时(ms)
+  double totalLoadMs = 0.0;  // 累计加载耗时(ms)
+  quint64 generation = 0;    // 当前模板集版本号
+};
+
+/**
+ * @brief 模板常驻缓存类
+ * @details 作为 visualWorkThread 的子对象随其移动线程；acquire() 是线程安全的，可被多个检测线程同时调用。
+ *          文件监视器与防抖定时器运行在内部的监视线程中，检测线程在批处理中阻塞时热更新照常进行：
+ *          新模板集在监视线程中加载后原子替换，下一帧 acquire() 即取得新版本。
+ */
+class TemplateCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit TemplateCache(QObject* parent = nullptr);
+  ~TemplateCache() override;
+
+  /**
+   * @brief 设置模板目录与测量区域目录
+   * @param modelDir 形状模板及位姿文件所在目录
+   * @param measureDir 测量区域文件所在目录
+   */
+  void setPaths(const QString& modelDir, const QString& measureDir);
+
+  /**
+   * @brief 设置全部模板目录，清空当前模板集（下次 acquire() 或 preload() 时加载）
+   */
+  void setPaths(const TemplatePaths& paths);
+  TemplatePaths paths() const;
+
+  /**
+   * @brief 设置并行加载线程数，0表示按CPU核数
+   */
+  void setLoadThreads(int threads);
+
+  /**
+   * @brief 预加载当前目录下的全部模板文件并原子替换当前模板集，完成后发出 templatesReady
+   * @return 加载报告
+   */
+  TemplateLoadReport preload();
+
+  /**
+   * @brief 切换配方：按新目录加载，成功后一次性替换模板集和目录；失败时保留原配方
+   * @details 加载期间检测继续使用原模板集，可在任意线程调用
+   * @return 加载报告
+   */
+  TemplateLoadReport switchRecipe(const TemplatePaths& paths);
+
+  /**
+   * @brief 是否已有可用模板集（预加载或首次加载完成）
+   */
+  bool isReady() const;
+
+  /**
+   * @brief 最近一次加载的报告
+   */
+  TemplateLoadReport lastLoadReport() const;
+
+  /**
+   * @brief 获取当前模板集，未加载时同步加载一次
+   * @return 当前模板集（可能为空指针或无效模板集）
+   */
+  TemplateSetPtr acquire();
+
+  /**
+   * @brief 获取当前模板集，不触发加载
+   */
+  TemplateSetPtr current() const;
+
+  /**
+   * @brief 立即重新加载并原子替换当前模板集
+   * @return 加载是否成功（失败时保留旧模板集）
+   */
+  bool reload();
+
+  /**
+   * @brief 清空缓存，下次 acquire() 时重新加载
+   */
+  void invalidate();
+
+  /**
+   * @brief 设置是否监视模板文件变化
+   */
+  void setWatchEnabled(bool enabled);
+
+  /**
+   * @brief 设置文件变化后的重新加载延迟（等待文件写完）
+   * @param milliseconds 延迟时间（毫秒）
+   */
+  void setReloadDelay(int milliseconds);
+
+  /**
+   * @brief 获取缓存统计信息
+   */
+  TemplateCacheStats stats() const;
+
+  /**
+   * @brief 在指定目录中查找修改时间最新的文件
+   * @param dirPath 目录路径
+   * @param nameFilters 文件名过滤器
+   * @return 最新文件的绝对路径，未找到返回空字符串
+   */
+  static QString findLatestFile(const QString& dirPath, const QStringList& nameFilters);
+
+signals:
+  /**
+   * @brief 模板集重新加载完成信号
+   * @param generation 新模板集版本号
+   * @param loadMs 加载耗时（毫秒）
+   */
+  void templatesReloaded(quint64 generation, double loadMs);
+
+  /**
+   * @brief 模板加载失败信号
+   * @param error 错误信息
+   */
+  void reloadFailed(const QString& error);
+
+  /**
+   * @brief 预加载或配方切换完成信号
+   * @param ok 是否加载成功（失败时仍使用原模板集）
+   * @param generation 当前模板集版本号
+   * @param summary 加载报告文本
+   */
+  void templatesReady(bool ok, quint64 generation, const QString& summary);
+
+private:
+  // 以下两个函数在监视线程中执行
+  void onWatchedPathChanged(const QString& path);
+  void onReloadTimeout();
+
+  /**
+   * @brief 在监视线程中执行任务（当前即为监视线程时直接执行）
+   */
+  void runOnWatchThread(std::function<void()> task);
+
+  /**
+   * @brief 从磁盘并行加载一组新的模板数据
+   * @param paths 模板目录
+   * @param report 加载报告输出（各文件耗时）
+   * @return 新模板集，形状模板加载失败时返回空指针
+   */
+  std::shared_ptr<TemplateSet> loadTemplateSet(const TemplatePaths& paths, TemplateLoadReport& report) const;
+
+  /**
+   * @brief 加载并原子替换模板集（调用者持有 m_loadMutex）
+   * @param paths 模板目录
+   * @param switchPaths 成功后是否同时替换当前目录（配方切换）
+   */
+  TemplateLoadReport loadAndSwapLocked(const TemplatePaths& paths, bool switchPaths);
+
+  /**
+   * @brief 重新设置文件监视列表（目录 + 当前使用的文件）
+   */
+  void updateWatchList();
+
+private:
+  mutable QMutex m_mutex;               // 保护 m_current 的互斥锁
+  TemplateSetPtr m_current;             // 当前模板集
+  QMutex m_loadMutex;                   // 串行化加载过程
+
+  TemplatePaths m_paths;                // 当前模板目录，受 m_mutex 保护
+  std::atomic<int> m_loadThreads{0};    // 并行加载线程数，0表示按CPU核数
+  TemplateLoadReport m_lastReport;      // 最近一次加载报告，受 m_mutex 保护
+
+  QThread* m_watchThread = nullptr;        // 监视线程（独立事件循环）
+  QFileSystemWatcher* m_watcher = nullptr; // 文件监视器，属于监视线程
+  QTimer* m_reloadTimer = nullptr;         // 重新加载防抖定时器，属于监视线程
+  std::atomic<bool> m_watchEnabled{true};  // 是否启用文件监视
+
+  std::atomic<quint64> m_hits{0};
+  std::atomic<quint64> m_misses{0};
+  std::atomic<quint64> m_reloads{0};
+  std::atomic<quint64> m_failedReloads{0};
+  std::atomic<quint64> m_generation{0};
+  double m_lastLoadMs = 0.0;            // 受 m_mutex 保护
+  double m_totalLoadMs = 0.0;           // 受 m_mutex 保护
+};
+
+#endif //TEMPLATECACHE_H
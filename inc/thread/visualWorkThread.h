@@ -9,26 +9,22 @@
 #include <QMutex>
 #include <QStringList>
 #include <QMap>  // 添加 QMap 头文件
+#include <QFuture>
+
+#include <functional>
 
 // Halcon相关头文件
 #include "../thirdparty/hdevelop/include/halconcpp/HalconCpp.h"
+#include "TemplateCache.h"
+#include "InspectionCore.h"
+#include "HotFolderSource.h"
 
 using namespace HalconCpp;
 
 class HalconLable;
-
-/**
- * @brief 显示对象信息结构体
- */
-struct DisplayObjectInfo {
-    HObject object;     // Halcon对象
-    QString color;      // 显示颜色
-    double lineWidth;   // 线宽
-    
-    DisplayObjectInfo() : lineWidth(1.0) {}
-    DisplayObjectInfo(const HObject& obj, const QString& col, double width)
-        : object(obj), color(col), lineWidth(width) {}
-};
+class InspectionPool;
+class FrameChannel;
+class ImageWriterService;
 
 /**
  * @brief 视觉处理工作线程类
@@ -70,6 +66,103 @@ public:
    */
   void setRunning(bool running);
 
+  /**
+   * @brief 获取模板常驻缓存
+   * @return 模板缓存对象指针
+   */
+  TemplateCache* templateCache() const;
+
+  /**
+   * @brief 在后台并行预加载当前目录下的全部模板文件，完成后发出 templatesReady（线程安全，可在GUI线程直接调用）
+   */
+  void preloadTemplates();
+
+  /**
+   * @brief 在后台切换配方：新配方全部加载成功后才替换当前模板集，失败时继续使用原配方（线程安全）
+   * @param recipeDir 配方目录，结构与 config 目录相同（models/DetectionModel、halconParams/...），为空时恢复默认配置目录
+   */
+  void switchRecipe(const QString& recipeDir);
+
+  /**
+   * @brief 模板是否已加载完成
+   */
+  bool isTemplateReady() const;
+
+  /**
+   * @brief 获取显示帧通道（检测结果经此通道送往界面）
+   * @return 帧通道对象指针
+   */
+  FrameChannel* frameChannel() const;
+
+  /**
+   * @brief 获取后台图像保存服务（检测结果图像经此保存，也可供界面手动保存使用）
+   * @return 图像保存服务指针
+   */
+  ImageWriterService* imageWriter() const;
+
+  /**
+   * @brief 设置并行检测线程数量
+   * @details 须在 moveToThread 之前调用（线程池作为子对象随本对象移动）；数量大于1时启用检测线程池，
+   *          否则在本线程中逐帧串行检测
+   * @param count 检测线程数量
+   */
+  void setInspectionWorkerCount(int count);
+
+  /**
+   * @brief 设置批量处理时的预读图像数量（解码队列容量）
+   * @param depth 预读数量
+   */
+  void setPrefetchDepth(int depth);
+
+  /**
+   * @brief 设置模板匹配跟踪搜索窗口配置（串行检测和检测线程池同时生效）
+   * @param config 跟踪配置
+   */
+  void setSearchWindowConfig(const SearchWindowConfig& config);
+
+  /**
+   * @brief 获取跟踪搜索统计（串行检测与检测线程池合计）
+   */
+  SearchWindowStats searchWindowStats() const;
+
+  /**
+   * @brief 设置全图匹配参数（得分阈值、投机并行匹配），串行检测和检测线程池同时生效
+   * @param config 匹配参数
+   */
+  void setMatchPassConfig(const MatchPassConfig& config);
+
+  /**
+   * @brief 获取投机匹配统计（串行检测与检测线程池合计）
+   */
+  SpeculativeMatchStats speculativeStats() const;
+
+  /**
+   * @brief 获取测量结果环形缓冲（最近的测量记录，线程安全）
+   */
+  const MeasurementRing& measurementRing() const;
+
+  /**
+   * @brief 获取检测线程池
+   * @return 检测线程池指针，未启用时为nullptr
+   */
+  InspectionPool* inspectionPool() const;
+
+  /**
+   * @brief 设置监视目录配置，启用后 process() 持续处理目录中新写入的图像，直到 stopHotFolder()
+   * @param config 监视目录配置（目录为空时使用默认图像目录）
+   */
+  void setHotFolderConfig(const HotFolderConfig& config);
+
+  /**
+   * @brief 是否正在以监视目录模式处理（线程安全）
+   */
+  bool isHotFolderActive() const;
+
+  /**
+   * @brief 停止监视目录，已送入流水线的图像处理完后 process() 返回（线程安全，可在GUI线程直接调用）
+   */
+  void stopHotFolder();
+
 signals:
   /**
    * @brief 工作线程启动信号
@@ -116,6 +209,13 @@ signals:
    * @param displayObjects 显示对象列表
    */
   void sendImageWithDisplayObjects(const HObject& image, const QList<DisplayObjectInfo>& displayObjects);
+
+  /**
+   * @brief 模板预加载或配方切换完成信号
+   * @param ok 是否成功
+   * @param summary 加载报告（总耗时及最慢的文件）
+   */
+  void templatesReady(bool ok, const QString& summary);
 public slots:
   /**
    * @brief 主要工作处理槽函数
@@ -141,9 +241,54 @@ private:
    */
   void initPath();
 
+  /**
+   * @brief 由配方目录生成模板路径，为空时返回默认配置目录
+   * @param recipeDir 配方目录
+   */
+  TemplatePaths recipePaths(const QString& recipeDir) const;
+
+  /**
+   * @brief 在模板加载线程中执行加载任务，前一个任务完成后才开始
+   */
+  void runTemplateTask(std::function<void()> task);
+
   void visualWorkThreadReadImage(const QString& imagePath);
 
-  void processModelParam();
+  /**
+   * @brief 以监视目录模式处理图像，直到停止监视或线程停止
+   * @param imagePath 默认图像目录（配置中未指定目录时使用）
+   */
+  void visualWorkThreadWatchFolder(const QString& imagePath);
+
+  /**
+   * @brief 用流水线处理一个图像来源并输出统计日志
+   * @param source 图像来源
+   * @return 已发布的结果数量
+   */
+  int runInspectionPipeline(ImageSource& source);
+
+  /**
+   * @brief 将模板集同步到公有模板成员（兼容旧接口）
+   * @param templateSet 模板集
+   */
+  void syncTemplateMembers(const TemplateSetPtr& templateSet);
+
+  /**
+   * @brief 发布检测结果：发送界面信号并保存测量结果
+   * @param result 检测结果
+   */
+  void publishResult(const InspectionResult& result);
+
+  /**
+   * @brief 将测量记录写入测量结果环形缓冲
+   * @param result 检测结果
+   */
+  void storeMeasurementResult(const InspectionResult& result);
+
+  /**
+   * @brief 将最新测量记录转换后写入HalconLable的测量缓存
+   */
+  void syncMeasurementCache();
 
 private:
   bool m_running;                    // 线程运行状态
@@ -154,6 +299,29 @@ private:
   
   // 工作线程的Halcon处理对象
   HalconLable* workThreadHalcon = nullptr;
+
+  // 模板常驻缓存（子对象，随工作线程一起移动）
+  TemplateCache* m_templateCache = nullptr;
+  quint64 m_syncedTemplateGeneration = 0; // 已同步到公有成员的模板集版本
+  QFuture<void> m_templateTask;           // 后台预加载/配方切换任务（受 m_mutex 保护）
+
+  // 单帧检测核心（串行路径使用）与并行检测线程池
+  InspectionCore m_inspectionCore;
+  InspectionPool* m_inspectionPool = nullptr;
+  int m_prefetchDepth = 4;          // 批量处理预读图像数量
+
+  // 最近的测量记录（预分配，发布阶段写入）
+  MeasurementRing m_measurementRing;
+
+  // 显示帧通道（子对象），界面繁忙时按策略丢帧，不阻塞检测
+  FrameChannel* m_frameChannel = nullptr;
+
+  // 后台图像保存服务，作为流水线发布操作保存NG/抽样图像，不阻塞检测
+  ImageWriterService* m_imageWriter = nullptr;
+
+  // 监视目录模式配置与当前活动的来源（受 m_mutex 保护）
+  HotFolderConfig m_hotFolderConfig;
+  HotFolderSource* m_activeHotFolder = nullptr;
   
   // 基础路径配置
   QString HalconPramFilePath = "";  // Halcon参数文件路径
@@ -14,6 +14,7 @@
 class HalconLable;
 class VisualProcess;
 class SerialDialog;
+class SettingManager;
 
 QT_BEGIN_NAMESPACE
 
@@ -59,6 +60,11 @@ private slots:
 
   void on_serialPort_config_toolBtn_clicked();
 
+  /**
+   * @brief 产品配置按钮点击事件：选择配方目录并在后台切换配方
+   */
+  void on_offerings_config_toolBtn_clicked();
+
   /**
    * @brief 开始按钮点击事件
    */
@@ -75,6 +81,11 @@ private slots:
    */
   void onVisualProcess_results(int results);
 
+  /**
+   * @brief 显示帧通道有新帧时的槽函数，只显示最新一帧
+   */
+  void onFrameAvailable();
+
   /**
    * @brief 基础的视觉工作线程完成槽函数
    */
@@ -107,6 +118,13 @@ private:
    */
   void initThread();
 
+  /**
+   * @brief 读取视觉线程配置（检测线程数、预读数量、显示帧通道、跟踪搜索、匹配参数、耗时统计、监视目录、
+   *        图像保存与归档、模板预加载）并应用到工作线程
+   * @details 经 SettingManager 读写 config/vision/vision.ini，缺少的键按默认值表写入；必须在工作线程moveToThread之前调用
+   */
+  void applyVisionSettings();
+
   /**
    * @brief 应用程序日志信息输出
    * @param message 日志信息
@@ -174,10 +192,13 @@ private:
   // UI组件
   Ui::Mainwindow* ui; ///< UI界面对象
   SerialDialog* m_serialDialog = nullptr; ///< 串口配置对话框对象
+  SettingManager* m_settingManager = nullptr; ///< 视觉配置管理器（config/vision/vision.ini）
 
   // 线程管理
   QThread* m_visualProcessThread = nullptr; ///< 视觉处理线程对象
   visualWorkThread* m_visualWorkThread = nullptr; ///< 视觉工作线程对象
+  bool m_templatePreload = true; ///< 启动时是否预加载模板
+  QString m_recipeDir; ///< 当前产品配方目录，为空时使用默认配置目录
 
   // 功能组件
   HalconLable* leftHal = nullptr; ///< 左侧图像显示对象
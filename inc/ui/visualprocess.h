@@ -21,6 +21,7 @@
 #include <QTimer>
 #include <QVariantMap>
 #include <QDateTime>
+#include <QJsonObject>
 
 // Halcon机器视觉库头文件 | Halcon Machine Vision Library Header
 #include "halconcpp/HalconCpp.h"
@@ -70,6 +71,8 @@ struct VisualTaskParams {
     QString measureType;        // 测量类型 | Measurement type
     int edgeThreshold;          // 边缘阈值 | Edge threshold
     double measurePrecision;    // 测量精度 | Measurement precision
+    QJsonObject recipe;         // 检测配方（ROI、工具、公差）| Inspection recipe (ROIs, tools, tolerances)
+    QString recipePath;         // 检测配方文件路径 | Inspection recipe file path
     
     // 检测特定参数 | Detection Specific Parameters
     int maxContrast;            // 最大对比度 | Maximum contrast
@@ -175,6 +178,12 @@ public:
    */
   bool validateTaskParams(const VisualTaskParams& params, QString& errorMessage) const;
   
+  /**
+   * @brief 获取图像显示控件 | Get Image Display Widget
+   * @return Halcon显示控件指针 | Halcon display widget pointer
+   */
+  HalconLable* imageView() const;
+
   /**
    * @brief 启动批处理任务 | Start Batch Processing Task
    */
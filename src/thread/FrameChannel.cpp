@@ -0,0 +1,202 @@
+/**
+ * @file FrameChannel.cpp
+ * @brief 有界帧通道实现 | Bounded frame channel implementation
+ */
+
+#include "../inc/thread/FrameChannel.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+FrameChannel::FrameChannel(QObject* parent) :
+  QObject(parent)
+{
+}
+
+FrameChannel::~FrameChannel()
+{
+  close();
+}
+
+void FrameChannel::setCapacity(int capacity)
+{
+  QMutexLocker locker(&m_mutex);
+  m_capacity = qMax(1, capacity);
+  while (static_cast<int>(m_frames.size()) > m_capacity)
+  {
+    m_frames.pop_front();
+    ++m_stats.overflowed;
+  }
+  m_notFull.wakeAll();
+}
+
+int FrameChannel::capacity() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_capacity;
+}
+
+void FrameChannel::setDropPolicy(FrameDropPolicy policy)
+{
+  QMutexLocker locker(&m_mutex);
+  m_policy = policy;
+  m_notFull.wakeAll();
+}
+
+FrameDropPolicy FrameChannel::dropPolicy() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_policy;
+}
+
+bool FrameChannel::publish(DisplayFrame frame)
+{
+  bool notify = false;
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_closed)
+    {
+      ++m_stats.overflowed;
+      return false;
+    }
+    ++m_stats.published;
+
+    if (static_cast<int>(m_frames.size()) >= m_capacity)
+    {
+      switch (m_policy)
+      {
+      case FrameDropPolicy::DropNewest:
+        ++m_stats.overflowed;
+        return false;
+
+      case FrameDropPolicy::Block:
+        {
+          QElapsedTimer timer;
+          timer.start();
+          while (!m_closed && m_policy == FrameDropPolicy::Block
+                 && static_cast<int>(m_frames.size()) >= m_capacity)
+          {
+            m_notFull.wait(&m_mutex);
+          }
+          m_stats.blockedMs += timer.nsecsElapsed() / 1e6;
+          if (m_closed)
+          {
+            ++m_stats.overflowed;
+            return false;
+          }
+          // 等待期间策略可能被修改，仍然满时按丢弃最旧处理
+          while (static_cast<int>(m_frames.size()) >= m_capacity)
+          {
+            m_frames.pop_front();
+            ++m_stats.overflowed;
+          }
+          break;
+        }
+
+      case FrameDropPolicy::DropOldest:
+      default:
+        while (static_cast<int>(m_frames.size()) >= m_capacity)
+        {
+          m_frames.pop_front();
+          ++m_stats.overflowed;
+        }
+        break;
+      }
+    }
+
+    m_frames.push_back(std::move(frame));
+    if (!m_notifyPending)
+    {
+      m_notifyPending = true;
+      notify = true;
+    }
+  }
+
+  // 合并通知：界面取帧前只发一次，事件队列中最多只有一个待处理事件
+  if (notify)
+  {
+    emit frameAvailable();
+  }
+  return true;
+}
+
+bool FrameChannel::takeLatest(DisplayFrame& frame)
+{
+  QMutexLocker locker(&m_mutex);
+  m_notifyPending = false;
+  if (m_frames.empty())
+  {
+    return false;
+  }
+
+  frame = std::move(m_frames.back());
+  m_stats.superseded += m_frames.size() - 1;
+  m_frames.clear();
+  ++m_stats.displayed;
+  m_notFull.wakeAll();
+  return true;
+}
+
+void FrameChannel::close()
+{
+  QMutexLocker locker(&m_mutex);
+  m_closed = true;
+  m_notFull.wakeAll();
+}
+
+void FrameChannel::reset()
+{
+  QMutexLocker locker(&m_mutex);
+  m_frames.clear();
+  m_closed = false;
+  m_notifyPending = false;
+  m_stats = FrameChannelStats();
+  m_notFull.wakeAll();
+}
+
+FrameChannelStats FrameChannel::stats() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_stats;
+}
+
+QString FrameChannel::statsSummary() const
+{
+  FrameChannelStats current = stats();
+  return QString("发布=%1, 显示=%2, 丢弃=%3 (通道已满=%4, 被新帧取代=%5), 阻塞=%6 ms, 策略=%7")
+         .arg(current.published).arg(current.displayed).arg(current.dropped())
+         .arg(current.overflowed).arg(current.superseded)
+         .arg(current.blockedMs, 0, 'f', 1).arg(policyToString(dropPolicy()));
+}
+
+FrameDropPolicy FrameChannel::policyFromString(const QString& text, FrameDropPolicy fallback)
+{
+  QString value = text.trimmed().toLower();
+  if (value == "drop_oldest")
+  {
+    return FrameDropPolicy::DropOldest;
+  }
+  if (value == "drop_newest")
+  {
+    return FrameDropPolicy::DropNewest;
+  }
+  if (value == "block")
+  {
+    return FrameDropPolicy::Block;
+  }
+  return fallback;
+}
+
+QString FrameChannel::policyToString(FrameDropPolicy policy)
+{
+  switch (policy)
+  {
+  case FrameDropPolicy::DropNewest:
+    return "drop_newest";
+  case FrameDropPolicy::Block:
+    return "block";
+  case FrameDropPolicy::DropOldest:
+  default:
+    return "drop_oldest";
+  }
+}
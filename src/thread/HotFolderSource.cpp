@@ -0,0 +1,457 @@
+/**
+ * @file HotFolderSource.cpp
+ * @brief 监视目录图像来源实现 | Hot-folder image source implementation
+ */
+
+#include "../inc/thread/HotFolderSource.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QEventLoop>
+#include <QFileSystemWatcher>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <vector>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+HotFolderSource::HotFolderSource(const HotFolderConfig& config) :
+  m_config(config)
+{
+  if (m_config.nameFilters.isEmpty())
+  {
+    m_config.nameFilters << "*.bmp" << "*.jpg" << "*.jpeg" << "*.png" << "*.tiff" << "*.tif";
+  }
+  m_config.settleMs = qMax(0, m_config.settleMs);
+  m_config.pollIntervalMs = qMax(10, m_config.pollIntervalMs);
+  m_config.maxDecodeAttempts = qMax(1, m_config.maxDecodeAttempts);
+}
+
+HotFolderSource::~HotFolderSource()
+{
+  stop();
+  QMutexLocker locker(&m_mutex);
+  m_journalFile.close();
+}
+
+bool HotFolderSource::start()
+{
+  if (!m_stopped.load())
+  {
+    return true;
+  }
+  if (!QDir(m_config.folder).exists())
+  {
+    LOG_ERROR(QString("监视目录不存在: %1").arg(m_config.folder));
+    return false;
+  }
+  if (!loadJournal())
+  {
+    return false;
+  }
+
+  m_stopped.store(false);
+  m_watchThread = QThread::create([this]() { watchLoop(); });
+  m_watchThread->setObjectName("HotFolderWatch");
+  m_watchThread->start();
+
+  LOG_INFO(QString("📂 开始监视目录: %1 (稳定时间=%2 ms, 已处理记录=%3)")
+      .arg(m_config.folder).arg(m_config.settleMs).arg(m_journal.size()));
+  return true;
+}
+
+void HotFolderSource::stop()
+{
+  if (m_stopped.exchange(true))
+  {
+    return;
+  }
+
+  {
+    QMutexLocker locker(&m_mutex);
+    // 未取走的文件不算处理完成，下次启动时重新发现
+    for (const SourceImage& image : m_ready)
+    {
+      m_inFlight.remove(image.path);
+    }
+    m_ready.clear();
+    m_readyCondition.wakeAll();
+  }
+
+  if (m_watchThread != nullptr)
+  {
+    // 事件循环尚未开始时 quit() 同样有效：QEventLoop::exec() 会立即返回
+    m_watchThread->quit();
+    m_watchThread->wait();
+    delete m_watchThread;
+    m_watchThread = nullptr;
+  }
+  LOG_INFO(QString("📂 停止监视目录: %1").arg(m_config.folder));
+}
+
+bool HotFolderSource::next(SourceImage& image)
+{
+  QMutexLocker locker(&m_mutex);
+  while (m_ready.empty() && !m_stopped.load())
+  {
+    m_readyCondition.wait(&m_mutex);
+  }
+  if (m_stopped.load())
+  {
+    return false;
+  }
+  image = m_ready.front();
+  m_ready.pop_front();
+  return true;
+}
+
+void HotFolderSource::markProcessed(const QString& path)
+{
+  QMutexLocker locker(&m_mutex);
+  QString key = m_inFlight.take(path);
+  if (key.isEmpty())
+  {
+    return;
+  }
+  m_journal.insert(key);
+  m_failures.remove(key);
+  appendJournal(key);
+  ++m_stats.processed;
+}
+
+void HotFolderSource::markFailed(const QString& path)
+{
+  QMutexLocker locker(&m_mutex);
+  QString key = m_inFlight.take(path);
+  if (key.isEmpty())
+  {
+    return;
+  }
+  int attempts = ++m_failures[key];
+  if (attempts < m_config.maxDecodeAttempts)
+  {
+    ++m_stats.retried;
+    LOG_WARNING(QString("图像 %1 读取失败（第 %2 次），下次扫描目录时重试").arg(path).arg(attempts));
+  }
+  else
+  {
+    ++m_stats.failed;
+    LOG_ERROR(QString("图像 %1 连续 %2 次读取失败，不再处理（文件改写后重新处理）").arg(path).arg(attempts));
+  }
+}
+
+HotFolderStats HotFolderSource::stats() const
+{
+  QMutexLocker locker(&m_mutex);
+  HotFolderStats result = m_stats;
+  result.queued = m_inFlight.size();
+  result.journalEntries = m_journal.size();
+  return result;
+}
+
+QString HotFolderSource::statsSummary() const
+{
+  HotFolderStats item = stats();
+  return QString("发现=%1, 启动跳过=%2, 入队=%3, 已处理=%4, 写入中删除=%5, 读取重试=%6, 读取失败=%7, "
+                 "等待写入=%8, 处理中=%9, 日志记录=%10")
+         .arg(item.discovered).arg(item.skipped).arg(item.ingested).arg(item.processed)
+         .arg(item.vanished).arg(item.retried).arg(item.failed).arg(item.pending).arg(item.queued)
+         .arg(item.journalEntries);
+}
+
+void HotFolderSource::watchLoop()
+{
+  QEventLoop loop;
+  QFileSystemWatcher watcher;
+
+  // 目录变化通知在批量拷贝时非常密集，合并到一次扫描
+  QTimer scanTimer;
+  scanTimer.setSingleShot(true);
+  scanTimer.setInterval(m_config.pollIntervalMs);
+
+  QTimer pollTimer;
+  pollTimer.setInterval(m_config.pollIntervalMs);
+
+  QTimer rescanTimer;
+  rescanTimer.setInterval(m_config.rescanIntervalMs);
+
+  auto startPolling = [this, &pollTimer]() {
+    if (!m_pending.isEmpty() && !pollTimer.isActive())
+    {
+      pollTimer.start();
+    }
+  };
+
+  QObject::connect(&watcher, &QFileSystemWatcher::directoryChanged, &scanTimer, [&scanTimer]() {
+    if (!scanTimer.isActive())
+    {
+      scanTimer.start();
+    }
+  });
+  QObject::connect(&scanTimer, &QTimer::timeout, &scanTimer, [this, startPolling]() {
+    scanDirectory(false);
+    startPolling();
+  });
+  QObject::connect(&rescanTimer, &QTimer::timeout, &rescanTimer, [this, startPolling]() {
+    scanDirectory(false);
+    startPolling();
+  });
+  QObject::connect(&pollTimer, &QTimer::timeout, &pollTimer, [this, &pollTimer]() {
+    checkPending();
+    if (m_pending.isEmpty())
+    {
+      pollTimer.stop();
+    }
+  });
+
+  if (!watcher.addPath(m_config.folder))
+  {
+    LOG_WARNING(QString("⚠️ 无法监视目录 %1，仅依靠定时补扫发现新文件").arg(m_config.folder));
+    if (m_config.rescanIntervalMs <= 0)
+    {
+      rescanTimer.setInterval(1000);
+    }
+    rescanTimer.start();
+  }
+  else if (m_config.rescanIntervalMs > 0)
+  {
+    rescanTimer.start();
+  }
+
+  scanDirectory(true);
+  startPolling();
+
+  if (!m_stopped.load())
+  {
+    loop.exec();
+  }
+  m_pending.clear();
+}
+
+QString HotFolderSource::journalKey(const QFileInfo& fileInfo)
+{
+  return QString("%1\t%2\t%3")
+         .arg(fileInfo.absoluteFilePath())
+         .arg(fileInfo.size())
+         .arg(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
+void HotFolderSource::scanDirectory(bool initial)
+{
+  QDir dir(m_config.folder);
+  QFileInfoList files = dir.entryInfoList(m_config.nameFilters, QDir::Files, QDir::Unsorted);
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  QMutexLocker locker(&m_mutex);
+  for (const QFileInfo& fileInfo : files)
+  {
+    QString path = fileInfo.absoluteFilePath();
+    if (m_pending.contains(path) || m_inFlight.contains(path))
+    {
+      continue; // 正在等待写入完成或正在处理
+    }
+    QString key = journalKey(fileInfo);
+    if (m_journal.contains(key))
+    {
+      if (initial)
+      {
+        ++m_stats.skipped;
+      }
+      continue;
+    }
+    if (m_failures.value(key) >= m_config.maxDecodeAttempts)
+    {
+      continue; // 多次读取失败，文件改写（日志键变化）前不再处理
+    }
+    if (initial && !m_config.processExisting)
+    {
+      // 不处理启动前已有的文件：直接记为已处理
+      m_journal.insert(key);
+      appendJournal(key);
+      ++m_stats.skipped;
+      continue;
+    }
+
+    PendingFile pending;
+    pending.size = fileInfo.size();
+    pending.modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+    pending.stableSinceMs = now;
+    m_pending.insert(path, pending);
+    ++m_stats.discovered;
+  }
+  m_stats.pending = m_pending.size();
+
+  if (initial && (m_stats.discovered > 0 || m_stats.skipped > 0))
+  {
+    LOG_INFO(QString("📂 监视目录已有文件: 待处理=%1, 已处理跳过=%2")
+        .arg(m_stats.discovered).arg(m_stats.skipped));
+  }
+}
+
+void HotFolderSource::checkPending()
+{
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  std::vector<SourceImage> completed;
+  std::vector<QString> keys;
+  quint64 vanished = 0;
+
+  for (auto it = m_pending.begin(); it != m_pending.end();)
+  {
+    QFileInfo fileInfo(it.key());
+    if (!fileInfo.exists())
+    {
+      ++vanished;
+      it = m_pending.erase(it);
+      continue;
+    }
+
+    qint64 size = fileInfo.size();
+    qint64 modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+    if (size != it->size || modifiedMs != it->modifiedMs)
+    {
+      it->size = size;
+      it->modifiedMs = modifiedMs;
+      it->stableSinceMs = now; // 仍在写入
+      ++it;
+      continue;
+    }
+    if (size <= 0 || now - it->stableSinceMs < m_config.settleMs)
+    {
+      ++it;
+      continue;
+    }
+
+    // Windows 下写入方未关闭文件时以独占方式打开，只读打开会失败
+    QFile probe(it.key());
+    if (!probe.open(QIODevice::ReadOnly))
+    {
+      ++it;
+      continue;
+    }
+    probe.close();
+
+    SourceImage image;
+    image.path = it.key();
+    image.readyMs = modifiedMs; // 最后一次写入时间即文件关闭时间
+    completed.push_back(image);
+    keys.push_back(journalKey(fileInfo));
+    it = m_pending.erase(it);
+  }
+
+  QMutexLocker locker(&m_mutex);
+  m_stats.vanished += vanished;
+  m_stats.pending = m_pending.size();
+  if (completed.empty() || m_stopped.load())
+  {
+    return;
+  }
+
+  // 同一轮完成的文件按写入完成顺序处理
+  std::vector<int> order(completed.size());
+  for (int i = 0; i < static_cast<int>(order.size()); ++i)
+  {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&completed](int a, int b) {
+    return completed[a].readyMs < completed[b].readyMs;
+  });
+  for (int index : order)
+  {
+    m_inFlight.insert(completed[index].path, keys[index]);
+    m_ready.push_back(completed[index]);
+  }
+  m_stats.ingested += completed.size();
+  m_readyCondition.wakeAll();
+}
+
+bool HotFolderSource::loadJournal()
+{
+  QMutexLocker locker(&m_mutex);
+  m_journal.clear();
+  m_failures.clear();
+  m_inFlight.clear();
+  m_ready.clear();
+  m_stats = HotFolderStats();
+  m_journalFile.close();
+
+  QFileInfo journalInfo(m_config.journalPath);
+  QDir().mkpath(journalInfo.absolutePath());
+
+  // 读取日志；只保留文件仍存在且未被改写的记录，避免日志随上游清理无限增长
+  int lineCount = 0;
+  QFile input(m_config.journalPath);
+  if (input.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    QTextStream stream(&input);
+    stream.setCodec("UTF-8");
+    while (!stream.atEnd())
+    {
+      QString line = stream.readLine();
+      if (line.isEmpty())
+      {
+        continue;
+      }
+      ++lineCount;
+      QString path = line.section('\t', 0, 0);
+      QFileInfo fileInfo(path);
+      if (fileInfo.exists() && journalKey(fileInfo) == line)
+      {
+        m_journal.insert(line);
+      }
+    }
+    input.close();
+  }
+
+  if (lineCount != m_journal.size())
+  {
+    QSaveFile output(m_config.journalPath);
+    if (output.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+      QTextStream stream(&output);
+      stream.setCodec("UTF-8");
+      for (const QString& key : m_journal)
+      {
+        stream << key << '\n';
+      }
+      stream.flush();
+      if (output.commit())
+      {
+        LOG_INFO(QString("📒 已处理日志压缩: %1 → %2 条").arg(lineCount).arg(m_journal.size()));
+      }
+    }
+  }
+
+  m_journalFile.setFileName(m_config.journalPath);
+  if (!m_journalFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+  {
+    LOG_ERROR(QString("无法打开已处理日志: %1").arg(m_config.journalPath));
+    return false;
+  }
+  return true;
+}
+
+void HotFolderSource::appendJournal(const QString& key)
+{
+  // 每条记录立即写出，程序异常退出时最多丢失正在处理的文件
+  QByteArray line = key.toUtf8();
+  line.append('\n');
+  m_journalFile.write(line);
+  m_journalFile.flush();
+}
@@ -0,0 +1,848 @@
+/**
+ * @file ImageArchive.cpp
+ * @brief 追加写入的检测图像归档实现 | Append-only inspection image archive implementation
+ */
+
+#include "../inc/thread/ImageArchive.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QReadLocker>
+#include <QStringList>
+#include <QWriteLocker>
+
+#include <algorithm>
+#include <cstring>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+namespace
+{
+constexpr qint64 kDayMs = 24LL * 60 * 60 * 1000;
+
+struct PixelTypeInfo {
+  ArchivePixelType type;
+  const char* name;
+  int bytes;
+};
+
+const PixelTypeInfo kPixelTypes[] = {
+  {ArchivePixelType::Byte, "byte", 1},
+  {ArchivePixelType::Int1, "int1", 1},
+  {ArchivePixelType::UInt2, "uint2", 2},
+  {ArchivePixelType::Int2, "int2", 2},
+  {ArchivePixelType::Int4, "int4", 4},
+  {ArchivePixelType::Real, "real", 4},
+  {ArchivePixelType::Int8, "int8", 8},
+  {ArchivePixelType::Direction, "direction", 1},
+  {ArchivePixelType::Cyclic, "cyclic", 1},
+};
+
+const PixelTypeInfo* pixelTypeByName(const QString& name)
+{
+  for (const PixelTypeInfo& info : kPixelTypes)
+  {
+    if (name == QLatin1String(info.name))
+    {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+const PixelTypeInfo* pixelTypeByCode(quint16 code)
+{
+  for (const PixelTypeInfo& info : kPixelTypes)
+  {
+    if (static_cast<quint16>(info.type) == code)
+    {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+qint64 localDay(qint64 timestampMs)
+{
+  return QDateTime::fromMSecsSinceEpoch(timestampMs).date().toJulianDay();
+}
+
+// 索引项中保存的标签：UTF-8 不超过63字节，在字符边界处截断
+QByteArray storedTag(const QString& tag)
+{
+  const int capacity = static_cast<int>(sizeof(ArchiveIndexEntry::tag)) - 1;
+  QByteArray bytes = tag.toUtf8();
+  if (bytes.size() > capacity)
+  {
+    int size = capacity;
+    while (size > 0 && (static_cast<uchar>(bytes.at(size)) & 0xC0) == 0x80)
+    {
+      --size; // 截断位置落在多字节字符中间时退到该字符起始
+    }
+    bytes.truncate(size);
+  }
+  return bytes;
+}
+}
+
+ImageArchive::MappedSegment::~MappedSegment()
+{
+  if (file && data != nullptr)
+  {
+    file->unmap(data);
+  }
+}
+
+ImageArchive::ImageArchive()
+{
+}
+
+ImageArchive::~ImageArchive()
+{
+  close();
+}
+
+/* ============================== 打开与恢复 ============================== */
+
+bool ImageArchive::open(const ImageArchiveConfig& config)
+{
+  close();
+
+  QWriteLocker locker(&m_lock);
+  m_config = config;
+  m_config.compressionLevel = qBound(0, m_config.compressionLevel, 9);
+  m_config.maxSegmentBytes = qMax<qint64>(16LL * 1024 * 1024, m_config.maxSegmentBytes);
+  if (m_config.directory.isEmpty() || !QDir().mkpath(m_config.directory))
+  {
+    LOG_ERROR(QString("无法创建图像归档目录: %1").arg(m_config.directory));
+    return false;
+  }
+
+  // 段号取自文件名 seg_XXXXXX.dat，按段号顺序加载
+  QStringList files = QDir(m_config.directory).entryList(QStringList() << "seg_*.dat", QDir::Files, QDir::Name);
+  QVector<quint32> ids;
+  for (const QString& name : files)
+  {
+    bool ok = false;
+    quint32 id = name.mid(4, name.size() - 8).toUInt(&ok);
+    if (ok && id > 0)
+    {
+      ids.append(id);
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  for (quint32 id : ids)
+  {
+    loadSegment(id);
+  }
+
+  if (!m_entries.empty())
+  {
+    m_nextFrameId = m_entries.back().frameId + 1;
+    m_lastTimestampMs = m_entries.back().timestampMs;
+  }
+  m_open = true;
+  applyRetentionLocked(QDateTime::currentMSecsSinceEpoch());
+
+  LOG_INFO(QString("🗄️ 图像归档已打开: %1, 段文件=%2, 帧数=%3")
+      .arg(m_config.directory).arg(m_segments.size()).arg(m_entries.size()));
+  return true;
+}
+
+/**
+ * 读取一个段的索引：丢弃不完整的索引项和指向段文件之外的索引项，并把段文件截断到最后一条完整帧之后
+ */
+bool ImageArchive::loadSegment(quint32 id)
+{
+  QFile data(segmentPath(id));
+  QFile index(indexPath(id));
+  const qint64 dataSize = data.size();
+
+  SegmentInfo info;
+  info.id = id;
+
+  QByteArray indexBytes;
+  if (index.open(QIODevice::ReadOnly))
+  {
+    indexBytes = index.readAll();
+    index.close();
+  }
+
+  // 原始像素字节数只记录在帧头中，逐帧读取帧头
+  const bool dataOpened = data.open(QIODevice::ReadOnly);
+
+  const int entrySize = static_cast<int>(sizeof(ArchiveIndexEntry));
+  const int count = indexBytes.size() / entrySize;
+  int valid = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    ArchiveIndexEntry entry;
+    std::memcpy(&entry, indexBytes.constData() + i * entrySize, sizeof(entry));
+    bool inRange = entry.segmentId == id && entry.size >= sizeof(ArchiveFrameHeader) &&
+                   static_cast<qint64>(entry.offset + entry.size) <= dataSize &&
+                   static_cast<qint64>(entry.offset) == info.bytes;
+    bool ordered = m_entries.empty() || entry.frameId > m_entries.back().frameId;
+    if (!inRange || !ordered)
+    {
+      break;
+    }
+    ArchiveFrameHeader header;
+    if (!dataOpened || !data.seek(static_cast<qint64>(entry.offset)) ||
+        data.read(reinterpret_cast<char*>(&header), sizeof(header)) != static_cast<qint64>(sizeof(header)) ||
+        header.magic != kArchiveFrameMagic || header.frameId != entry.frameId)
+    {
+      break;
+    }
+
+    info.bytes = static_cast<qint64>(entry.offset + entry.size);
+    info.rawBytes += static_cast<qint64>(header.rawSize);
+    if (info.frames == 0)
+    {
+      info.firstMs = entry.timestampMs;
+    }
+    info.lastMs = entry.timestampMs;
+    ++info.frames;
+    m_entries.push_back(entry);
+    if (entry.tag[0] != '\0')
+    {
+      m_tagIndex.insert(entry.tagString(), entry.frameId);
+    }
+    ++valid;
+  }
+  data.close();
+
+  // 修复崩溃留下的尾部：多余的索引字节和未登记的帧数据
+  if (valid * entrySize != indexBytes.size() && index.open(QIODevice::ReadWrite))
+  {
+    index.resize(static_cast<qint64>(valid) * entrySize);
+    index.close();
+    LOG_WARNING(QString("图像归档段 %1 的索引有 %2 条无效记录，已截断").arg(id).arg(count - valid));
+  }
+  if (dataSize > info.bytes && data.open(QIODevice::ReadWrite))
+  {
+    data.resize(info.bytes);
+    data.close();
+    LOG_WARNING(QString("图像归档段 %1 末尾有 %2 字节未写完的数据，已截断").arg(id).arg(dataSize - info.bytes));
+  }
+
+  m_segments.insert(id, info);
+  return true;
+}
+
+void ImageArchive::close()
+{
+  QWriteLocker locker(&m_lock);
+  closeWriterLocked();
+  {
+    QMutexLocker mapLocker(&m_mapMutex);
+    m_maps.clear();
+  }
+  m_entries.clear();
+  m_tagIndex.clear();
+  m_segments.clear();
+  m_nextFrameId = 1;
+  m_lastTimestampMs = 0;
+  m_open = false;
+}
+
+bool ImageArchive::isOpen() const
+{
+  QReadLocker locker(&m_lock);
+  return m_open;
+}
+
+ImageArchiveConfig ImageArchive::config() const
+{
+  QReadLocker locker(&m_lock);
+  return m_config;
+}
+
+QString ImageArchive::segmentPath(quint32 id) const
+{
+  return QString("%1/seg_%2.dat").arg(m_config.directory).arg(id, 6, 10, QChar('0'));
+}
+
+QString ImageArchive::indexPath(quint32 id) const
+{
+  return QString("%1/seg_%2.idx").arg(m_config.directory).arg(id, 6, 10, QChar('0'));
+}
+
+/* ============================== 编码与追加 ============================== */
+
+bool ImageArchive::encodeFrame(const HObject& image, const MeasurementRecord& record, int compressionLevel,
+                               ArchiveEncodedFrame* frame)
+{
+  if (!image.IsInitialized() || frame == nullptr)
+  {
+    return false;
+  }
+
+  try
+  {
+    HTuple channels, type, width, height;
+    CountChannels(image, &channels);
+    GetImageType(image, &type);
+    GetImageSize(image, &width, &height);
+    const PixelTypeInfo* pixelType = pixelTypeByName(QString(type.S().Text()));
+    if (pixelType == nullptr || channels.I() <= 0)
+    {
+      return false; // complex、vector_field 等类型不归档
+    }
+
+    const int channelCount = channels.I();
+    const qint64 planeBytes = static_cast<qint64>(width.I()) * height.I() * pixelType->bytes;
+    QByteArray raw(static_cast<int>(planeBytes * channelCount), Qt::Uninitialized);
+    for (int c = 0; c < channelCount; ++c)
+    {
+      HObject channel;
+      HTuple pointer, channelType, channelWidth, channelHeight;
+      AccessChannel(image, &channel, c + 1);
+      GetImagePointer1(channel, &pointer, &channelType, &channelWidth, &channelHeight);
+      std::memcpy(raw.data() + c * planeBytes, reinterpret_cast<const void*>(pointer.L()), static_cast<size_t>(planeBytes));
+    }
+
+    ArchiveFrameHeader& header = frame->header;
+    header = ArchiveFrameHeader();
+    header.headerSize = sizeof(ArchiveFrameHeader);
+    header.width = width.I();
+    header.height = height.I();
+    header.channels = static_cast<quint16>(channelCount);
+    header.pixelType = static_cast<quint16>(pixelType->type);
+    header.rawSize = static_cast<quint64>(raw.size());
+    header.record = record;
+
+    frame->payload = raw;
+    header.compression = 0;
+    if (compressionLevel > 0)
+    {
+      // 压缩后不小于原始数据时保存原始数据（噪声较大的图像）
+      QByteArray compressed = qCompress(raw, qBound(1, compressionLevel, 9));
+      if (!compressed.isEmpty() && compressed.size() < raw.size())
+      {
+        frame->payload = compressed;
+        header.compression = 1;
+      }
+    }
+    header.payloadSize = static_cast<quint64>(frame->payload.size());
+    return true;
+  }
+  catch (const HalconCpp::HException& e)
+  {
+    LOG_ERROR(QString("归档图像编码失败: %1").arg(QString(e.ErrorMessage())));
+    return false;
+  }
+}
+
+quint64 ImageArchive::append(const HObject& image, const MeasurementRecord& record, qint64 sequence, bool ng,
+                             const QString& tag)
+{
+  ArchiveEncodedFrame frame;
+  if (!encodeFrame(image, record, config().compressionLevel, &frame))
+  {
+    return 0;
+  }
+  frame.sequence = sequence;
+  frame.ng = ng;
+  frame.tag = tag;
+  return append(std::move(frame));
+}
+
+quint64 ImageArchive::append(ArchiveEncodedFrame frame)
+{
+  if (!frame.isValid())
+  {
+    return 0;
+  }
+
+  QWriteLocker locker(&m_lock);
+  if (!m_open)
+  {
+    return 0;
+  }
+
+  // 时间戳单调不减，按时间查找可以直接二分
+  const qint64 now = qMax(QDateTime::currentMSecsSinceEpoch(), m_lastTimestampMs);
+  const qint64 recordBytes = static_cast<qint64>(sizeof(ArchiveFrameHeader)) + frame.payload.size();
+  if (rotateIfNeededLocked(recordBytes, now))
+  {
+    applyRetentionLocked(now);
+  }
+  if (!m_dataFile || !m_indexFile)
+  {
+    return 0;
+  }
+
+  SegmentInfo& segment = m_segments[m_writeSegment];
+  const qint64 offset = segment.bytes;
+
+  frame.header.frameId = m_nextFrameId;
+  frame.header.timestampMs = now;
+  bool written = m_dataFile->write(reinterpret_cast<const char*>(&frame.header), sizeof(frame.header)) ==
+                 static_cast<qint64>(sizeof(frame.header));
+  written = written && m_dataFile->write(frame.payload) == frame.payload.size();
+  written = written && m_dataFile->flush();
+  if (!written)
+  {
+    LOG_ERROR(QString("写入图像归档段 %1 失败: %2").arg(m_writeSegment).arg(m_dataFile->errorString()));
+    m_dataFile->resize(offset); // 撤销半条帧数据
+    return 0;
+  }
+
+  ArchiveIndexEntry entry;
+  entry.frameId = m_nextFrameId;
+  entry.timestampMs = now;
+  entry.sequence = frame.sequence;
+  entry.segmentId = m_writeSegment;
+  entry.flags = frame.ng ? ArchiveIndexEntry::Ng : 0;
+  entry.offset = static_cast<quint64>(offset);
+  entry.size = static_cast<quint64>(recordBytes);
+  const QByteArray tag = storedTag(frame.tag);
+  std::memcpy(entry.tag, tag.constData(), static_cast<size_t>(tag.size()));
+
+  // 索引项在帧数据落盘后追加：崩溃时最多丢失最后一帧，不会出现指向无效数据的索引
+  if (m_indexFile->write(reinterpret_cast<const char*>(&entry), sizeof(entry)) != static_cast<qint64>(sizeof(entry)) ||
+      !m_indexFile->flush())
+  {
+    LOG_ERROR(QString("写入图像归档索引 %1 失败: %2").arg(m_writeSegment).arg(m_indexFile->errorString()));
+    m_dataFile->resize(offset);
+    return 0;
+  }
+
+  segment.bytes = offset + recordBytes;
+  segment.rawBytes += static_cast<qint64>(frame.header.rawSize);
+  if (segment.frames == 0)
+  {
+    segment.firstMs = now;
+  }
+  segment.lastMs = now;
+  ++segment.frames;
+
+  m_entries.push_back(entry);
+  if (!tag.isEmpty())
+  {
+    m_tagIndex.insert(entry.tagString(), entry.frameId); // 与重新打开时从索引文件读出的键一致
+  }
+  m_lastTimestampMs = now;
+  ++m_nextFrameId;
+  ++m_appended;
+  return entry.frameId;
+}
+
+/**
+ * 需要时打开或轮换写入段
+ * @return 发生了轮换（新建段）时返回true
+ */
+bool ImageArchive::rotateIfNeededLocked(qint64 nextBytes, qint64 nowMs)
+{
+  const qint64 day = localDay(nowMs);
+  if (m_dataFile)
+  {
+    const SegmentInfo& current = m_segments[m_writeSegment];
+    bool full = current.bytes > 0 && current.bytes + nextBytes > m_config.maxSegmentBytes;
+    bool newDay = m_config.rotateDaily && current.frames > 0 && day != m_writeDay;
+    if (!full && !newDay)
+    {
+      return false;
+    }
+    closeWriterLocked();
+  }
+  else if (!m_segments.isEmpty())
+  {
+    // 启动后继续写入最后一个段（未满且为同一天时）
+    const SegmentInfo& last = m_segments.last();
+    bool sameDay = !m_config.rotateDaily || last.frames == 0 || localDay(last.lastMs) == day;
+    if (sameDay && last.bytes + nextBytes <= m_config.maxSegmentBytes)
+    {
+      if (openWriterLocked(last.id))
+      {
+        return false;
+      }
+    }
+  }
+
+  quint32 id = m_segments.isEmpty() ? 1 : m_segments.lastKey() + 1;
+  if (openWriterLocked(id))
+  {
+    m_writeDay = day;
+    return true;
+  }
+  return false;
+}
+
+bool ImageArchive::openWriterLocked(quint32 id)
+{
+  std::unique_ptr<QFile> data(new QFile(segmentPath(id)));
+  std::unique_ptr<QFile> index(new QFile(indexPath(id)));
+  if (!data->open(QIODevice::Append) || !index->open(QIODevice::Append))
+  {
+    LOG_ERROR(QString("无法打开图像归档段 %1: %2").arg(id).arg(data->errorString()));
+    return false;
+  }
+
+  if (!m_segments.contains(id))
+  {
+    SegmentInfo info;
+    info.id = id;
+    m_segments.insert(id, info);
+  }
+  const SegmentInfo& info = m_segments[id];
+  m_writeDay = info.frames > 0 ? localDay(info.lastMs) : localDay(QDateTime::currentMSecsSinceEpoch());
+  m_writeSegment = id;
+  m_dataFile = std::move(data);
+  m_indexFile = std::move(index);
+  return true;
+}
+
+void ImageArchive::closeWriterLocked()
+{
+  if (m_dataFile)
+  {
+    m_dataFile->close();
+    m_dataFile.reset();
+  }
+  if (m_indexFile)
+  {
+    m_indexFile->close();
+    m_indexFile.reset();
+  }
+  m_writeSegment = 0;
+}
+
+/* ============================== 保留策略 ============================== */
+
+int ImageArchive::applyRetention()
+{
+  QWriteLocker locker(&m_lock);
+  return applyRetentionLocked(QDateTime::currentMSecsSinceEpoch());
+}
+
+/**
+ * 从最旧的段开始整段删除（两个文件），不删除当前写入的段
+ */
+int ImageArchive::applyRetentionLocked(qint64 nowMs)
+{
+  qint64 totalBytes = 0;
+  for (const SegmentInfo& info : m_segments)
+  {
+    totalBytes += info.bytes;
+  }
+
+  const qint64 cutoffMs = m_config.retentionDays > 0 ? nowMs - m_config.retentionDays * kDayMs : 0;
+  int removed = 0;
+  while (!m_segments.isEmpty())
+  {
+    const SegmentInfo oldest = m_segments.first();
+    if (m_dataFile && oldest.id == m_writeSegment)
+    {
+      break;
+    }
+    bool expired = cutoffMs > 0 && (oldest.frames == 0 || oldest.lastMs < cutoffMs);
+    bool overSize = m_config.maxTotalBytes > 0 && totalBytes > m_config.maxTotalBytes;
+    if (!expired && !overSize)
+    {
+      break;
+    }
+    removeSegmentLocked(oldest.id);
+    totalBytes -= oldest.bytes;
+    ++removed;
+  }
+  if (removed > 0)
+  {
+    LOG_INFO(QString("🗄️ 图像归档按保留策略删除了 %1 个段文件").arg(removed));
+  }
+  return removed;
+}
+
+void ImageArchive::removeSegmentLocked(quint32 id)
+{
+  while (!m_entries.empty() && m_entries.front().segmentId == id)
+  {
+    const ArchiveIndexEntry& entry = m_entries.front();
+    if (entry.tag[0] != '\0')
+    {
+      auto it = m_tagIndex.find(entry.tagString());
+      if (it != m_tagIndex.end() && it.value() == entry.frameId)
+      {
+        m_tagIndex.erase(it);
+      }
+    }
+    m_entries.pop_front();
+  }
+  {
+    // 写锁下没有读取者持有映射，可以直接解除（Windows 下映射中的文件不能删除）
+    QMutexLocker mapLocker(&m_mapMutex);
+    m_maps.remove(id);
+  }
+  QFile::remove(segmentPath(id));
+  QFile::remove(indexPath(id));
+  m_segments.remove(id);
+  ++m_removedSegments;
+}
+
+/* ============================== 查找与读取 ============================== */
+
+bool ImageArchive::entry(quint64 frameId, ArchiveIndexEntry* result) const
+{
+  QReadLocker locker(&m_lock);
+  if (m_entries.empty() || frameId < m_entries.front().frameId || frameId > m_entries.back().frameId)
+  {
+    return false;
+  }
+
+  // 帧号连续时直接按下标访问；中间缺段时退回二分查找
+  size_t index = static_cast<size_t>(frameId - m_entries.front().frameId);
+  if (index >= m_entries.size() || m_entries[index].frameId != frameId)
+  {
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), frameId,
+                               [](const ArchiveIndexEntry& e, quint64 id) { return e.frameId < id; });
+    if (it == m_entries.end() || it->frameId != frameId)
+    {
+      return false;
+    }
+    index = static_cast<size_t>(it - m_entries.begin());
+  }
+  if (result != nullptr)
+  {
+    *result = m_entries[index];
+  }
+  return true;
+}
+
+quint64 ImageArchive::findByTag(const QString& tag) const
+{
+  QReadLocker locker(&m_lock);
+  return m_tagIndex.value(QString::fromUtf8(storedTag(tag)), 0);
+}
+
+quint64 ImageArchive::findByTime(qint64 timestampMs) const
+{
+  QReadLocker locker(&m_lock);
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), timestampMs,
+                             [](const ArchiveIndexEntry& e, qint64 ms) { return e.timestampMs < ms; });
+  return it == m_entries.end() ? 0 : it->frameId;
+}
+
+QVector<ArchiveIndexEntry> ImageArchive::query(qint64 fromMs, qint64 toMs, int ngFilter, int limit) const
+{
+  QVector<ArchiveIndexEntry> result;
+  QReadLocker locker(&m_lock);
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), fromMs,
+                             [](const ArchiveIndexEntry& e, qint64 ms) { return e.timestampMs < ms; });
+  for (; it != m_entries.end(); ++it)
+  {
+    if (toMs > 0 && it->timestampMs >= toMs)
+    {
+      break;
+    }
+    if (ngFilter >= 0 && it->isNg() != (ngFilter == 1))
+    {
+      continue;
+    }
+    result.append(*it);
+    if (limit > 0 && result.size() >= limit)
+    {
+      break;
+    }
+  }
+  return result;
+}
+
+QVector<ArchiveIndexEntry> ImageArchive::latest(int count, int ngFilter) const
+{
+  QVector<ArchiveIndexEntry> result;
+  QReadLocker locker(&m_lock);
+  for (auto it = m_entries.rbegin(); it != m_entries.rend() && result.size() < count; ++it)
+  {
+    if (ngFilter >= 0 && it->isNg() != (ngFilter == 1))
+    {
+      continue;
+    }
+    result.append(*it);
+  }
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+/**
+ * 映射段文件；已有映射不覆盖请求范围时（当前写入段已增长）按当前文件大小重新映射
+ */
+ImageArchive::MappedSegmentPtr ImageArchive::mapRange(quint32 segmentId, quint64 offset, quint64 size) const
+{
+  QMutexLocker locker(&m_mapMutex);
+  MappedSegmentPtr mapped = m_maps.value(segmentId);
+  if (mapped && static_cast<qint64>(offset + size) <= mapped->size)
+  {
+    return mapped;
+  }
+
+  MappedSegmentPtr remapped = std::make_shared<MappedSegment>();
+  remapped->file.reset(new QFile(segmentPath(segmentId)));
+  if (!remapped->file->open(QIODevice::ReadOnly))
+  {
+    return MappedSegmentPtr();
+  }
+  remapped->size = remapped->file->size();
+  if (static_cast<qint64>(offset + size) > remapped->size)
+  {
+    return MappedSegmentPtr();
+  }
+  remapped->data = remapped->file->map(0, remapped->size);
+  if (remapped->data == nullptr)
+  {
+    LOG_ERROR(QString("映射图像归档段 %1 失败: %2").arg(segmentId).arg(remapped->file->errorString()));
+    return MappedSegmentPtr();
+  }
+  m_maps.insert(segmentId, remapped);
+  return remapped;
+}
+
+bool ImageArchive::readFrame(quint64 frameId, HObject* image, MeasurementRecord* record) const
+{
+  ArchiveIndexEntry indexEntry;
+  if (!entry(frameId, &indexEntry))
+  {
+    return false;
+  }
+
+  QReadLocker locker(&m_lock); // 持有读锁期间段文件不会被保留策略删除
+  MappedSegmentPtr mapped = mapRange(indexEntry.segmentId, indexEntry.offset, indexEntry.size);
+  if (!mapped)
+  {
+    return false;
+  }
+
+  const uchar* base = mapped->data + indexEntry.offset;
+  ArchiveFrameHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (header.magic != kArchiveFrameMagic || header.frameId != frameId ||
+      header.headerSize + header.payloadSize != indexEntry.size)
+  {
+    LOG_ERROR(QString("图像归档帧 %1 的帧头无效").arg(frameId));
+    return false;
+  }
+
+  if (record != nullptr)
+  {
+    *record = header.record;
+  }
+  if (image == nullptr)
+  {
+    return true;
+  }
+  try
+  {
+    return decodeFrame(header, base + header.headerSize, image);
+  }
+  catch (const HalconCpp::HException& e)
+  {
+    LOG_ERROR(QString("读取图像归档帧 %1 失败: %2").arg(frameId).arg(QString(e.ErrorMessage())));
+    return false;
+  }
+}
+
+/**
+ * 未压缩的帧直接从映射内存生成图像（GenImage1/GenImage3 复制一次像素）
+ */
+bool ImageArchive::decodeFrame(const ArchiveFrameHeader& header, const uchar* payload, HObject* image)
+{
+  const PixelTypeInfo* pixelType = pixelTypeByCode(header.pixelType);
+  if (pixelType == nullptr || header.channels == 0)
+  {
+    return false;
+  }
+
+  QByteArray inflated;
+  const uchar* planes = payload;
+  if (header.compression == 1)
+  {
+    inflated = qUncompress(payload, static_cast<int>(header.payloadSize));
+    if (static_cast<quint64>(inflated.size()) != header.rawSize)
+    {
+      return false;
+    }
+    planes = reinterpret_cast<const uchar*>(inflated.constData());
+  }
+  else if (header.payloadSize != header.rawSize)
+  {
+    return false;
+  }
+
+  const qint64 planeBytes = static_cast<qint64>(header.width) * header.height * pixelType->bytes;
+  auto plane = [&](int c) { return reinterpret_cast<Hlong>(planes + c * planeBytes); };
+  if (header.channels == 3)
+  {
+    GenImage3(image, pixelType->name, header.width, header.height, plane(0), plane(1), plane(2));
+    return true;
+  }
+  if (header.channels == 1)
+  {
+    GenImage1(image, pixelType->name, header.width, header.height, plane(0));
+    return true;
+  }
+
+  HObject channels;
+  GenEmptyObj(&channels);
+  for (int c = 0; c < header.channels; ++c)
+  {
+    HObject channel;
+    GenImage1(&channel, pixelType->name, header.width, header.height, plane(c));
+    ConcatObj(channels, channel, &channels);
+  }
+  ChannelsToImage(channels, image);
+  return true;
+}
+
+/* ============================== 统计 ============================== */
+
+ImageArchiveStats ImageArchive::stats() const
+{
+  QReadLocker locker(&m_lock);
+  ImageArchiveStats result;
+  result.segments = m_segments.size();
+  result.frames = static_cast<quint64>(m_entries.size());
+  for (const ArchiveIndexEntry& entry : m_entries)
+  {
+    if (entry.isNg())
+    {
+      ++result.ngFrames;
+    }
+  }
+  for (const SegmentInfo& info : m_segments)
+  {
+    result.totalBytes += info.bytes;
+    result.rawBytes += info.rawBytes;
+  }
+  result.appended = m_appended;
+  result.removedSegments = m_removedSegments;
+  if (!m_entries.empty())
+  {
+    result.oldestMs = m_entries.front().timestampMs;
+    result.newestMs = m_entries.back().timestampMs;
+  }
+  return result;
+}
+
+QString ImageArchive::statsSummary() const
+{
+  ImageArchiveStats s = stats();
+  double ratio = s.totalBytes > 0 ? static_cast<double>(s.rawBytes) / s.totalBytes : 0.0;
+  return QString("段文件=%1, 帧数=%2 (NG=%3), 大小=%4 MB, 压缩比=%5, 本次追加=%6, 本次删除段=%7")
+         .arg(s.segments).arg(s.frames).arg(s.ngFrames)
+         .arg(s.totalBytes / (1024.0 * 1024.0), 0, 'f', 1)
+         .arg(ratio, 0, 'f', 2)
+         .arg(s.appended).arg(s.removedSegments);
+}
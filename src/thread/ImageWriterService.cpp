@@ -0,0 +1,630 @@
+/**
+ * @file ImageWriterService.cpp
+ * @brief 后台图像保存服务实现 | Background image writer service implementation
+ */
+
+#include "../inc/thread/ImageWriterService.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStorageInfo>
+#include <QStringList>
+#include <QThread>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+namespace
+{
+constexpr qint64 kFreeSpaceCheckMs = 2000;  // 磁盘剩余空间查询间隔(ms)
+constexpr qint64 kRateWindowMs = 2000;      // 写入速率统计窗口(ms)
+
+// 未压缩像素字节数，作为排队图像占用磁盘空间的上限估计
+qint64 rawImageBytes(const HObject& image)
+{
+  try
+  {
+    HTuple channels, width, height;
+    CountChannels(image, &channels);
+    GetImageSize(image, &width, &height);
+    return static_cast<qint64>(width.I()) * height.I() * qMax(1, channels.I());
+  }
+  catch (const HalconCpp::HException&)
+  {
+    return 0;
+  }
+}
+}
+
+ImageWriterService::ImageWriterService()
+  : m_archive(new ImageArchive())
+{
+}
+
+ImageWriterService::~ImageWriterService()
+{
+  stop(true);
+}
+
+void ImageWriterService::setConfig(const ImageWriterConfig& config)
+{
+  ImageWriterConfig normalized = config;
+  normalized.encoderThreads = qBound(1, normalized.encoderThreads, 16);
+  normalized.queueCapacity = qBound(1, normalized.queueCapacity, 4096);
+  normalized.sampleInterval = qMax(1, normalized.sampleInterval);
+  normalized.minFreeBytes = qMax<qint64>(0, normalized.minFreeBytes);
+
+  // 线程数和队列容量只在启动时生效，运行中修改时写完已排队的图像后重启
+  bool wasRunning = isRunning();
+  if (wasRunning)
+  {
+    stop(true);
+  }
+  {
+    QMutexLocker locker(&m_mutex);
+    m_config = normalized;
+    m_freeCheckedMs = 0; // 目录可能变化，重新查询剩余空间
+  }
+  if (wasRunning)
+  {
+    start();
+  }
+}
+
+ImageWriterConfig ImageWriterService::config() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_config;
+}
+
+bool ImageWriterService::start()
+{
+  QMutexLocker control(&m_controlMutex);
+  QMutexLocker locker(&m_mutex);
+  if (m_queue != nullptr)
+  {
+    return true;
+  }
+
+  if (m_config.useArchive)
+  {
+    ImageArchiveConfig archiveConfig = m_config.archive;
+    if (archiveConfig.directory.isEmpty())
+    {
+      archiveConfig.directory = m_config.rootDir + "/archive";
+    }
+    if (!m_archive->open(archiveConfig))
+    {
+      LOG_WARNING("⚠️ 图像归档打开失败，检测结果图像按单独文件保存");
+    }
+  }
+
+  m_queue = std::make_shared<BoundedQueue<WriteJob>>(m_config.queueCapacity);
+  m_stats.queueCapacity = m_config.queueCapacity;
+  for (int i = 0; i < m_config.encoderThreads; ++i)
+  {
+    std::shared_ptr<BoundedQueue<WriteJob>> queue = m_queue;
+    QThread* worker = QThread::create([this, queue]() { encoderLoop(queue); });
+    worker->setObjectName(QString("ImageWriter-%1").arg(i));
+    worker->start(QThread::LowPriority); // 编码让位于检测线程
+    m_workers.append(worker);
+  }
+  LOG_INFO(QString("💾 图像保存服务已启动: 编码线程=%1, 队列容量=%2")
+      .arg(m_config.encoderThreads).arg(m_config.queueCapacity));
+  return true;
+}
+
+void ImageWriterService::stop(bool drain)
+{
+  QMutexLocker control(&m_controlMutex);
+  std::shared_ptr<BoundedQueue<WriteJob>> queue;
+  QList<QThread*> workers;
+  {
+    QMutexLocker locker(&m_mutex);
+    queue.swap(m_queue);
+    workers.swap(m_workers);
+  }
+  if (queue == nullptr)
+  {
+    return;
+  }
+
+  if (!drain)
+  {
+    int discarded = queue->size();
+    queue->clear();
+    QMutexLocker locker(&m_mutex);
+    m_stats.droppedOnStop += static_cast<quint64>(discarded);
+    m_pending -= discarded;
+    if (m_pending <= 0)
+    {
+      m_pending = 0;
+      m_idle.wakeAll();
+    }
+  }
+  queue->close();
+  for (QThread* worker : workers)
+  {
+    worker->wait();
+    delete worker;
+  }
+  if (m_archive->isOpen())
+  {
+    LOG_INFO(QString("🗄️ 图像归档: %1").arg(m_archive->statsSummary()));
+    m_archive->close();
+  }
+  LOG_INFO(QString("💾 图像保存服务已停止: %1").arg(statsSummary()));
+}
+
+bool ImageWriterService::isRunning() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_queue != nullptr;
+}
+
+bool ImageWriterService::submit(const HObject& image, const QString& filePath, const ImageWriteOptions& options, bool ng)
+{
+  if (!image.IsInitialized() || filePath.isEmpty())
+  {
+    return false;
+  }
+
+  WriteJob job;
+  job.image = image;
+  job.format = halconFormat(options);
+  job.ng = ng;
+  job.filePath = filePath;
+  if (QFileInfo(filePath).suffix().isEmpty())
+  {
+    job.filePath += "." + fileExtension(options.format);
+  }
+  return enqueue(std::move(job), rawImageBytes(image));
+}
+
+bool ImageWriterService::submit(const HObject& image, const QString& filePath)
+{
+  return submit(image, filePath, optionsForPath(filePath));
+}
+
+bool ImageWriterService::submitResult(const InspectionResult& result)
+{
+  if (!result.image.IsInitialized())
+  {
+    return false;
+  }
+
+  // 未完成测量（未找到模板或测量失败）或超出配方公差视为NG
+  const bool ng = !result.measured() || !result.record.isInTolerance();
+  QString rootDir;
+  ImageWriteOptions options;
+  bool toArchive = false;
+  {
+    QMutexLocker locker(&m_mutex);
+    if (!m_config.enabled || m_config.rootDir.isEmpty())
+    {
+      return false;
+    }
+    if (!ng)
+    {
+      bool save = m_config.policy == ImageSavePolicy::All;
+      if (m_config.policy == ImageSavePolicy::NgAndSampled)
+      {
+        save = (m_okCounter % static_cast<quint64>(m_config.sampleInterval)) == 0;
+        ++m_okCounter;
+      }
+      if (!save)
+      {
+        ++m_stats.skippedByPolicy;
+        return false;
+      }
+    }
+    rootDir = m_config.rootDir;
+    options = ng ? m_config.ngOptions : m_config.okOptions;
+    toArchive = m_config.useArchive;
+  }
+
+  QString baseName = result.imagePath.isEmpty() ? QString("frame") : QFileInfo(result.imagePath).completeBaseName();
+  if (toArchive && m_archive->isOpen())
+  {
+    // 归档：像素与测量记录追加到段文件，标签为源文件名
+    WriteJob job;
+    job.image = result.image;
+    job.ng = ng;
+    job.archive = true;
+    job.record = result.record;
+    job.sequence = result.sequence;
+    job.tag = baseName;
+    job.filePath = m_archive->config().directory;
+    return enqueue(std::move(job), rawImageBytes(result.image));
+  }
+
+  // 根目录/日期/NG|OK/原文件名_序号.扩展名
+  QString filePath = QString("%1/%2/%3/%4_%5.%6")
+                     .arg(rootDir)
+                     .arg(QDate::currentDate().toString("yyyyMMdd"))
+                     .arg(ng ? "NG" : "OK")
+                     .arg(baseName)
+                     .arg(result.sequence)
+                     .arg(fileExtension(options.format));
+  return submit(result.image, filePath, options, ng);
+}
+
+bool ImageWriterService::enqueue(WriteJob job, qint64 estimatedBytes)
+{
+  std::shared_ptr<BoundedQueue<WriteJob>> queue;
+  bool block = false;
+  {
+    QMutexLocker locker(&m_mutex);
+    ++m_stats.submitted;
+    if (m_queue == nullptr)
+    {
+      ++m_stats.droppedOnStop;
+      return false;
+    }
+    QString directory = job.archive ? job.filePath : QFileInfo(job.filePath).absolutePath();
+    if (!hasDiskSpaceLocked(directory, estimatedBytes))
+    {
+      ++m_stats.droppedDiskFull;
+      return false;
+    }
+    queue = m_queue;
+    block = job.ng && m_config.blockOnFullForNg;
+    ++m_pending; // 先计入，避免编码线程在入队后立即完成时计数为负
+  }
+
+  bool queued = false;
+  if (block)
+  {
+    QElapsedTimer timer;
+    timer.start();
+    queued = queue->push(std::move(job));
+    QMutexLocker locker(&m_mutex);
+    m_blockedNs += timer.nsecsElapsed();
+  }
+  else
+  {
+    queued = queue->tryPush(std::move(job));
+  }
+
+  QMutexLocker locker(&m_mutex);
+  if (!queued)
+  {
+    if (queue->isClosed())
+    {
+      ++m_stats.droppedOnStop;
+    }
+    else
+    {
+      ++m_stats.droppedQueueFull;
+    }
+    if (--m_pending <= 0)
+    {
+      m_pending = 0;
+      m_idle.wakeAll();
+    }
+    return false;
+  }
+  return true;
+}
+
+/**
+ * 剩余空间每隔 kFreeSpaceCheckMs 查询一次，期间按未压缩大小扣除排队图像，保证估计偏保守
+ */
+bool ImageWriterService::hasDiskSpaceLocked(const QString& directory, qint64 estimatedBytes)
+{
+  if (m_config.minFreeBytes <= 0)
+  {
+    return true;
+  }
+
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if (m_freeBytes < 0 || now - m_freeCheckedMs >= kFreeSpaceCheckMs || directory != m_freeCheckedDir)
+  {
+    // 目录尚未创建时查询最近的已存在上级目录
+    QString probe = directory;
+    while (!probe.isEmpty() && !QDir(probe).exists())
+    {
+      QString parent = QFileInfo(probe).path();
+      if (parent == probe)
+      {
+        break;
+      }
+      probe = parent;
+    }
+    QStorageInfo storage(probe);
+    storage.refresh();
+    m_freeBytes = storage.isValid() ? storage.bytesAvailable() : -1;
+    m_freeCheckedMs = now;
+    m_freeCheckedDir = directory;
+    m_stats.freeBytes = m_freeBytes;
+  }
+
+  if (m_freeBytes < 0)
+  {
+    return true; // 无法查询时不阻止写入
+  }
+  if (m_freeBytes - estimatedBytes < m_config.minFreeBytes)
+  {
+    if (m_stats.droppedDiskFull == 0 || m_stats.droppedDiskFull % 100 == 0)
+    {
+      LOG_WARNING(QString("⚠️ 磁盘剩余空间不足 (%1 MB < %2 MB)，停止保存图像: %3")
+          .arg(m_freeBytes / (1024 * 1024)).arg(m_config.minFreeBytes / (1024 * 1024)).arg(directory));
+    }
+    return false;
+  }
+  m_freeBytes -= estimatedBytes;
+  return true;
+}
+
+void ImageWriterService::encoderLoop(std::shared_ptr<BoundedQueue<WriteJob>> queue)
+{
+  QString lastDir;
+  WriteJob job;
+  while (queue->pop(job))
+  {
+    QElapsedTimer timer;
+    timer.start();
+    bool success = false;
+    qint64 bytes = 0;
+    if (job.archive)
+    {
+      // 编码（复制、压缩）在各编码线程中并行执行，追加写入由归档串行化
+      ArchiveEncodedFrame frame;
+      if (ImageArchive::encodeFrame(job.image, job.record, m_archive->config().compressionLevel, &frame))
+      {
+        frame.sequence = job.sequence;
+        frame.ng = job.ng;
+        frame.tag = job.tag;
+        bytes = static_cast<qint64>(sizeof(ArchiveFrameHeader)) + frame.payload.size();
+        success = m_archive->append(std::move(frame)) != 0;
+      }
+      if (!success)
+      {
+        bytes = 0;
+        LOG_ERROR(QString("图像写入归档失败: %1 #%2").arg(job.tag).arg(job.sequence));
+      }
+      job = WriteJob();
+      finishJob(success, bytes, timer.nsecsElapsed());
+      continue;
+    }
+
+    try
+    {
+      QString dir = QFileInfo(job.filePath).absolutePath();
+      if (dir != lastDir)
+      {
+        QDir().mkpath(dir);
+        lastDir = dir;
+      }
+      WriteImage(job.image, job.format.toStdString().c_str(), HTuple(0), job.filePath.toStdString().c_str());
+      QFileInfo written(job.filePath);
+      success = written.exists();
+      bytes = success ? written.size() : 0;
+      if (!success)
+      {
+        LOG_ERROR(QString("保存图像失败，文件未创建: %1").arg(job.filePath));
+      }
+    }
+    catch (const HalconCpp::HException& e)
+    {
+      LOG_ERROR(QString("保存图像 %1 时发生Halcon异常: %2").arg(job.filePath).arg(QString(e.ErrorMessage())));
+    }
+    job = WriteJob(); // 尽早释放图像引用
+    finishJob(success, bytes, timer.nsecsElapsed());
+  }
+}
+
+void ImageWriterService::finishJob(bool success, qint64 bytes, qint64 encodeNs)
+{
+  QMutexLocker locker(&m_mutex);
+  if (success)
+  {
+    ++m_stats.written;
+    m_stats.bytesWritten += static_cast<quint64>(bytes);
+    m_encodeNs += encodeNs;
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (m_rateWindowStartMs == 0)
+    {
+      m_rateWindowStartMs = now;
+    }
+    m_rateWindowBytes += static_cast<quint64>(bytes);
+    qint64 elapsed = now - m_rateWindowStartMs;
+    if (elapsed >= kRateWindowMs)
+    {
+      m_lastRate = m_rateWindowBytes * 1000.0 / elapsed;
+      m_rateWindowStartMs = now;
+      m_rateWindowBytes = 0;
+    }
+  }
+  else
+  {
+    ++m_stats.failed;
+  }
+
+  if (--m_pending <= 0)
+  {
+    m_pending = 0;
+    m_idle.wakeAll();
+  }
+}
+
+bool ImageWriterService::waitForIdle(int timeoutMs)
+{
+  QDeadlineTimer deadline = timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeoutMs);
+  QMutexLocker locker(&m_mutex);
+  while (m_pending > 0)
+  {
+    if (!m_idle.wait(&m_mutex, deadline))
+    {
+      return m_pending == 0;
+    }
+  }
+  return true;
+}
+
+ImageArchive* ImageWriterService::archive() const
+{
+  return m_archive->isOpen() ? m_archive.get() : nullptr;
+}
+
+ImageWriterStats ImageWriterService::stats() const
+{
+  QMutexLocker locker(&m_mutex);
+  ImageWriterStats result = m_stats;
+  if (m_queue != nullptr)
+  {
+    BoundedQueueStats queueStats = m_queue->stats();
+    result.queueDepth = queueStats.depth;
+    result.maxQueueDepth = queueStats.maxDepth;
+  }
+  result.avgEncodeMs = result.written > 0 ? m_encodeNs / 1e6 / result.written : 0.0;
+  result.submitBlockedMs = m_blockedNs / 1e6;
+
+  // 第一个统计窗口尚未结束时用当前窗口估算
+  double rate = m_lastRate;
+  qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - m_rateWindowStartMs;
+  if (m_rateWindowStartMs > 0 && elapsed >= kRateWindowMs * 2)
+  {
+    rate = m_rateWindowBytes * 1000.0 / elapsed; // 长时间没有写入，速率衰减
+  }
+  else if (rate == 0.0 && m_rateWindowStartMs > 0 && elapsed > 0)
+  {
+    rate = m_rateWindowBytes * 1000.0 / elapsed;
+  }
+  result.bytesPerSecond = rate;
+  return result;
+}
+
+QString ImageWriterService::statsSummary() const
+{
+  ImageWriterStats s = stats();
+  return QString("提交=%1, 写入=%2, 失败=%3, 策略跳过=%4, 丢弃(队列满=%5, 磁盘空间=%6, 停止=%7), "
+                 "队列=%8/%9 (最大%10), 速率=%11 MB/s, 平均编码=%12 ms, 提交等待=%13 ms")
+         .arg(s.submitted).arg(s.written).arg(s.failed).arg(s.skippedByPolicy)
+         .arg(s.droppedQueueFull).arg(s.droppedDiskFull).arg(s.droppedOnStop)
+         .arg(s.queueDepth).arg(s.queueCapacity).arg(s.maxQueueDepth)
+         .arg(s.bytesPerSecond / (1024.0 * 1024.0), 0, 'f', 2)
+         .arg(s.avgEncodeMs, 0, 'f', 2)
+         .arg(s.submitBlockedMs, 0, 'f', 1);
+}
+
+/* ============================== 格式与策略 ============================== */
+
+QString ImageWriterService::halconFormat(const ImageWriteOptions& options)
+{
+  QString format = options.format.trimmed().toLower();
+  const int level = options.compression;
+  if (format == "png")
+  {
+    if (level < 0)
+    {
+      return "png";
+    }
+    if (level == 0)
+    {
+      return "png none";
+    }
+    return level <= 3 ? "png fastest" : (level >= 7 ? "png best" : "png");
+  }
+  if (format == "tif" || format == "tiff")
+  {
+    return level <= 0 ? QString("tiff") : QString("tiff deflate %1").arg(qBound(1, level, 9));
+  }
+  if (format == "jpg" || format == "jpeg")
+  {
+    return QString("jpeg %1").arg(level < 0 ? 90 : qBound(1, level, 100));
+  }
+  if (format == "jp2")
+  {
+    return level < 0 ? QString("jp2") : QString("jp2 %1").arg(qBound(1, level, 100));
+  }
+  if (format == "bmp" || format == "hobj")
+  {
+    return format;
+  }
+  return "png";
+}
+
+QString ImageWriterService::fileExtension(const QString& format)
+{
+  QString value = format.trimmed().toLower();
+  if (value == "tif" || value == "tiff")
+  {
+    return "tif";
+  }
+  if (value == "jpg" || value == "jpeg")
+  {
+    return "jpg";
+  }
+  if (value == "bmp" || value == "jp2" || value == "hobj")
+  {
+    return value;
+  }
+  return "png";
+}
+
+ImageWriteOptions ImageWriterService::optionsForPath(const QString& filePath, const ImageWriteOptions& fallback)
+{
+  QString suffix = QFileInfo(filePath).suffix().toLower();
+  ImageWriteOptions options = fallback;
+  if (suffix == "png" || suffix == "bmp" || suffix == "jp2" || suffix == "hobj")
+  {
+    options.format = suffix;
+  }
+  else if (suffix == "tif" || suffix == "tiff")
+  {
+    options.format = "tiff";
+  }
+  else if (suffix == "jpg" || suffix == "jpeg")
+  {
+    options.format = "jpeg";
+  }
+  return options;
+}
+
+ImageSavePolicy ImageWriterService::policyFromString(const QString& text, ImageSavePolicy fallback)
+{
+  QString value = text.trimmed().toLower();
+  if (value == "all")
+  {
+    return ImageSavePolicy::All;
+  }
+  if (value == "ng_only")
+  {
+    return ImageSavePolicy::NgOnly;
+  }
+  if (value == "ng_and_sampled")
+  {
+    return ImageSavePolicy::NgAndSampled;
+  }
+  return fallback;
+}
+
+QString ImageWriterService::policyToString(ImageSavePolicy policy)
+{
+  switch (policy)
+  {
+  case ImageSavePolicy::All:
+    return "all";
+  case ImageSavePolicy::NgAndSampled:
+    return "ng_and_sampled";
+  default:
+    return "ng_only";
+  }
+}
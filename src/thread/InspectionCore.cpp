@@ -0,0 +1,648 @@
+/**
+ * @file InspectionCore.cpp
+ * @brief 单帧检测核心实现 | Single-frame inspection core implementation
+ */
+
+#include "../inc/thread/InspectionCore.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+#include "../inc/thread/LatencyProfiler.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QThread>
+#include <QThreadPool>
+
+#include <memory>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+namespace
+{
+  // 投机匹配中精确匹配使用的线程池：与全局线程池（图像解码、保存等）分开，被取消的任务不占用其他模块的线程
+  QThreadPool* speculativeMatchPool()
+  {
+    static QThreadPool* pool = []()
+    {
+      QThreadPool* created = new QThreadPool();
+      created->setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+      return created;
+    }();
+    return pool;
+  }
+}
+
+bool SearchTrack::predict(quint64 generation, qint64 sequence, int maxFrameGap, Pose& pose, bool& stale)
+{
+  QMutexLocker locker(&m_mutex);
+  stale = false;
+  if (!m_pose.valid || m_generation != generation)
+  {
+    return false; // 没有位姿，或模板已更换
+  }
+  if (sequence >= 0 && m_pose.sequence >= 0)
+  {
+    if (m_pose.sequence >= sequence)
+    {
+      return false; // 只有更晚的帧已完成，不用“未来”的位姿预测
+    }
+    if (sequence - m_pose.sequence > qMax(1, maxFrameGap))
+    {
+      stale = true;
+      return false;
+    }
+  }
+  pose = m_pose;
+  return true;
+}
+
+void SearchTrack::update(quint64 generation, qint64 sequence, bool valid, double row, double column, double angle)
+{
+  QMutexLocker locker(&m_mutex);
+  if (m_generation == generation && sequence >= 0 && m_pose.sequence > sequence)
+  {
+    return; // 更晚的帧已更新过位姿
+  }
+  m_generation = generation;
+  m_pose.valid = valid;
+  m_pose.sequence = sequence;
+  m_pose.row = row;
+  m_pose.column = column;
+  m_pose.angle = angle;
+}
+
+void SearchTrack::reset()
+{
+  QMutexLocker locker(&m_mutex);
+  m_pose = Pose();
+}
+
+InspectionResult InspectionCore::inspect(const HObject& image, const TemplateSet& templateSet, const HTuple& modelId,
+                                         qint64 sequence)
+{
+  PROFILE_STAGE(InspectionStage::Total);
+  QElapsedTimer timer;
+  timer.start();
+
+  InspectionResult result = inspectFrame(image, templateSet, modelId, sequence);
+  result.record.inspectMs = timer.nsecsElapsed() / 1e6;
+  result.record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+  return result;
+}
+
+InspectionResult InspectionCore::inspectFrame(const HObject& image, const TemplateSet& templateSet, const HTuple& modelId,
+                                             qint64 sequence)
+{
+  InspectionResult result;
+  result.image = image;
+
+  if (!image.IsInitialized())
+  {
+    LOG_WARNING("图像初始化失败，无法处理图像");
+    return result;
+  }
+
+  HTuple Crow, Ccol, Cangle, Cscore, AffHomMat2D;
+
+  // 检查图像的基本信息
+  HTuple ImageWidth, ImageHeight, ImageChannels;
+  GetImageSize(image, &ImageWidth, &ImageHeight);
+  CountChannels(image, &ImageChannels);
+  LOG_INFO(QString("📷 图像信息: 宽度=%1, 高度=%2, 通道数=%3")
+      .arg(ImageWidth[0].I()).arg(ImageHeight[0].I()).arg(ImageChannels[0].I()));
+
+  // 预处理图像以提高匹配成功率
+  HObject grayImage = image;
+  try
+  {
+    PROFILE_STAGE(InspectionStage::Preprocess);
+    // 如果是彩色图像，转换为灰度图像
+    if (ImageChannels[0].I() > 1)
+    {
+      Rgb1ToGray(image, &grayImage);
+    }
+  }
+  catch (const HalconCpp::HException& except)
+  {
+    LOG_WARNING(QString("⚠️ 图像预处理失败，使用原图像: %1").arg(except.ErrorMessage().Text()));
+    grayImage = image;
+  }
+
+  try
+  {
+    findModel(grayImage, templateSet.generation, sequence, modelId, Crow, Ccol, Cangle, Cscore);
+
+    if (Crow.Length() == 0)
+    {
+      LOG_WARNING("❌ 未找到匹配的模板");
+      return result;
+    }
+
+    MeasurementRecord& record = result.record;
+    record.flags |= MeasurementRecord::Matched;
+    record.set(MeasurementField::MatchRow, Crow[0].D());
+    record.set(MeasurementField::MatchColumn, Ccol[0].D());
+    record.set(MeasurementField::MatchAngle, Cangle[0].D());
+    record.set(MeasurementField::MatchScore, Cscore[0].D());
+    LOG_INFO(QString("✅ 找到模板匹配: Row=%1, Col=%2, Angle=%3, Score=%4")
+        .arg(Crow[0].D()).arg(Ccol[0].D()).arg(Cangle[0].D()).arg(Cscore[0].D()));
+
+    if (!templateSet.plan)
+    {
+      LOG_ERROR("检测配方未编译（测量区域未加载或配方无效），跳过测量");
+      return result;
+    }
+
+    {
+      PROFILE_STAGE(InspectionStage::RigidTransform);
+      // 计算仿射变换矩阵，配方中的ROI由执行计划映射到找到的模板位置
+      VectorAngleToRigid(templateSet.row, templateSet.column, templateSet.angle,
+                         Crow[0], Ccol[0], Cangle[0], &AffHomMat2D);
+    }
+
+    // 🎯 按配方执行测量工具（同层工具并行），结果写入显示对象和测量记录
+    {
+      PROFILE_STAGE(InspectionStage::RecipeExecute);
+      if (templateSet.plan->execute(image, AffHomMat2D, m_measure, m_planState, result))
+      {
+        record.flags |= MeasurementRecord::Measured;
+      }
+      else
+      {
+        LOG_INFO("❌ 无法完成测量：部分工具未得到结果");
+      }
+    }
+    // 显示文本由界面在实际显示时根据记录生成，被丢弃的帧不再格式化字符串
+  }
+  catch (const HalconCpp::HException& e)
+  {
+    LOG_ERROR(QString("❌ 模板匹配或变换失败：%1").arg(QString(e.ErrorMessage())));
+    result.displayObjects.clear();
+  }
+
+  return result;
+}
+
+void InspectionCore::setSearchWindowConfig(const SearchWindowConfig& config)
+{
+  {
+    QMutexLocker locker(&m_configMutex);
+    m_searchConfig = config;
+  }
+  m_track->reset();
+}
+
+void InspectionCore::setSearchTrack(const std::shared_ptr<SearchTrack>& track)
+{
+  m_track = track ? track : std::make_shared<SearchTrack>();
+}
+
+void InspectionCore::setParallelToolsByDefault(bool enabled)
+{
+  m_planState.parallelByDefault = enabled;
+}
+
+SearchWindowConfig InspectionCore::searchWindowConfig() const
+{
+  QMutexLocker locker(&m_configMutex);
+  return m_searchConfig;
+}
+
+SearchWindowStats InspectionCore::searchWindowStats() const
+{
+  QMutexLocker locker(&m_configMutex);
+  return m_searchStats;
+}
+
+void InspectionCore::resetSearchWindowStats()
+{
+  QMutexLocker locker(&m_configMutex);
+  m_searchStats = SearchWindowStats();
+}
+
+void InspectionCore::setMatchPassConfig(const MatchPassConfig& config)
+{
+  QMutexLocker locker(&m_configMutex);
+  m_matchConfig = config;
+}
+
+MatchPassConfig InspectionCore::matchPassConfig() const
+{
+  QMutexLocker locker(&m_configMutex);
+  return m_matchConfig;
+}
+
+SpeculativeMatchStats InspectionCore::speculativeStats() const
+{
+  QMutexLocker locker(&m_configMutex);
+  return m_speculativeStats;
+}
+
+void InspectionCore::findModel(const HObject& grayImage, quint64 generation, qint64 sequence, const HTuple& modelId,
+                               HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore)
+{
+  SearchWindowConfig config = searchWindowConfig();
+
+  // 参考位姿来自帧号更早的帧（并行检测时可能是若干帧之前），模板更换后不再可用
+  SearchTrack::Pose pose;
+  bool stale = false;
+  bool tracking = config.enabled && m_track->predict(generation, sequence, config.maxFrameGap, pose, stale);
+  const double trackRow = pose.row;
+  const double trackColumn = pose.column;
+  const double trackAngle = pose.angle;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // 跟踪模式：以上一帧位姿为中心，在缩小的区域和角度范围内搜索，未找到时逐级放大
+  int hitStep = -1;
+  if (tracking)
+  {
+    PROFILE_STAGE(InspectionStage::FindShapeWindow);
+    double radius = config.radius;
+    double angleExtent = config.angleExtent;
+    for (int step = 0; step <= config.widenSteps; ++step)
+    {
+      try
+      {
+        HObject window, reducedImage;
+        GenRectangle1(&window, trackRow - radius, trackColumn - radius, trackRow + radius, trackColumn + radius);
+        ReduceDomain(grayImage, window, &reducedImage);
+        FindShapeModel(reducedImage, modelId,
+                       trackAngle - angleExtent, 2.0 * angleExtent,
+                       config.minScore, 1, 0.5, "least_squares", 3, 0.9,
+                       &Crow, &Ccol, &Cangle, &Cscore);
+      }
+      catch (const HalconCpp::HException& except)
+      {
+        LOG_WARNING(QString("⚠️ 窗口匹配失败(第%1级): %2").arg(step).arg(except.ErrorMessage().Text()));
+        Crow = HTuple();
+      }
+
+      if (Crow.Length() > 0)
+      {
+        hitStep = step;
+        break;
+      }
+      radius *= config.widenFactor;
+      angleExtent *= config.widenFactor;
+    }
+  }
+  double windowMs = timer.nsecsElapsed() / 1e6;
+
+  double globalMs = 0.0;
+  if (hitStep < 0)
+  {
+    if (tracking)
+    {
+      LOG_WARNING("⚠️ 跟踪窗口内未找到模板，回退到全图搜索");
+    }
+    timer.restart();
+    globalSearch(grayImage, generation, modelId, Crow, Ccol, Cangle, Cscore);
+    globalMs = timer.nsecsElapsed() / 1e6;
+  }
+
+  if (!config.enabled)
+  {
+    return;
+  }
+
+  // 得分过低时位姿置为无效，下一帧重新全图搜索
+  bool valid = Crow.Length() > 0 && Cscore[0].D() >= config.minScore;
+  m_track->update(generation, sequence, valid, valid ? Crow[0].D() : 0.0, valid ? Ccol[0].D() : 0.0,
+                  valid ? Cangle[0].D() : 0.0);
+
+  // 统计：命中帧节省 = 全图搜索平均耗时 - 窗口搜索耗时；回退帧的窗口搜索耗时单独计为损失
+  QMutexLocker locker(&m_configMutex);
+  ++m_searchStats.frames;
+  m_searchStats.windowMs += windowMs;
+  m_searchStats.globalMs += globalMs;
+  if (stale)
+  {
+    ++m_searchStats.staleSkips;
+  }
+  if (hitStep < 0)
+  {
+    ++m_searchStats.globalSearches;
+    if (tracking)
+    {
+      ++m_searchStats.globalFallbacks;
+      m_searchStats.fallbackMs += windowMs;
+    }
+    m_globalMsAverage = m_globalMsAverage > 0.0 ? 0.9 * m_globalMsAverage + 0.1 * globalMs : globalMs;
+    return;
+  }
+
+  if (hitStep == 0)
+  {
+    ++m_searchStats.windowHits;
+  }
+  else
+  {
+    ++m_searchStats.widenedHits;
+  }
+  if (m_globalMsAverage > 0.0)
+  {
+    m_searchStats.savedMs += qMax(0.0, m_globalMsAverage - windowMs);
+  }
+}
+
+void InspectionCore::globalSearch(const HObject& grayImage, quint64 generation, const HTuple& modelId,
+                                  HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore)
+{
+  MatchPassConfig config = matchPassConfig();
+  if (config.speculative)
+  {
+    speculativeSearch(grayImage, generation, modelId, config, Crow, Ccol, Cangle, Cscore);
+    return;
+  }
+  sequentialSearch(grayImage, modelId, config, Crow, Ccol, Cangle, Cscore);
+}
+
+void InspectionCore::sequentialSearch(const HObject& grayImage, const HTuple& modelId, const MatchPassConfig& config,
+                                      HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore)
+{
+  // 首先尝试快速匹配（高greediness，低精度）
+  {
+    PROFILE_STAGE(InspectionStage::FindShapeFast);
+    findFast(grayImage, modelId, config.fastMinScore, Crow, Ccol, Cangle, Cscore);
+  }
+
+  if (Crow.Length() == 0)
+  {
+    LOG_WARNING("⚠️ 快速匹配未找到结果，尝试精确匹配模式...");
+
+    // 如果快速匹配失败，尝试更精确的匹配
+    try
+    {
+      PROFILE_STAGE(InspectionStage::FindShapePrecise);
+      findPrecise(grayImage, modelId, config.preciseMinScore, Crow, Ccol, Cangle, Cscore);
+    }
+    catch (const HalconCpp::HException& except)
+    {
+      LOG_ERROR(QString("❌ 精确匹配也失败: %1").arg(except.ErrorMessage().Text()));
+    }
+  }
+}
+
+void InspectionCore::findFast(const HObject& grayImage, const HTuple& modelId, double minScore,
+                              HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore)
+{
+  FindShapeModel(grayImage, modelId,
+                 -0.39, 0.78, // 角度范围: ±22.5度
+                 minScore, // 最小分数 (默认0.3，降低要求)
+                 1, // 最大匹配数
+                 0.5, // 最大重叠
+                 "least_squares", // 子像素精度
+                 3, // 金字塔层数 (减少层数加快速度)
+                 0.9, // 贪婪度 (提高速度)
+                 &Crow, &Ccol, &Cangle, &Cscore);
+}
+
+void InspectionCore::findPrecise(const HObject& grayImage, const HTuple& modelId, double minScore,
+                                 HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore)
+{
+  FindShapeModel(grayImage, modelId,
+                 -0.79, 1.57, // 更大角度范围: ±45度 到 90度
+                 minScore, // 更低分数阈值 (默认0.2)
+                 3, // 更多匹配候选
+                 0.7, // 允许更多重叠
+                 "least_squares",
+                 4, // 增加金字塔层数
+                 0.7, // 降低贪婪度获得更好精度
+                 &Crow, &Ccol, &Cangle, &Cscore);
+}
+
+void InspectionCore::speculativeSearch(const HObject& grayImage, quint64 generation, const HTuple& modelId,
+                                       const MatchPassConfig& config,
+                                       HTuple& Crow, HTuple& Ccol, HTuple& Cangle, HTuple& Cscore)
+{
+  // 上一帧被取消的精确匹配尚未退出时仍在使用模板副本，本帧按顺序匹配，不与之争用同一句柄
+  if (m_preciseFuture.isRunning())
+  {
+    {
+      QMutexLocker locker(&m_configMutex);
+      ++m_speculativeStats.busySkips;
+    }
+    sequentialSearch(grayImage, modelId, config, Crow, Ccol, Cangle, Cscore);
+    return;
+  }
+
+  // 精确匹配使用独立的模板副本，两次匹配互不争用同一句柄；复制失败时不投机
+  HTuple preciseModel = ensurePreciseModel(generation, modelId, config.preciseTimeoutMs);
+  if (preciseModel.Length() == 0)
+  {
+    sequentialSearch(grayImage, modelId, config, Crow, Ccol, Cangle, Cscore);
+    return;
+  }
+
+  // 两次匹配同时运行，各自记录Halcon线程ID，先得到可接受结果的一方取消另一方
+  struct SpeculativeState {
+    QMutex mutex;
+    HTuple fastThreadId;
+    HTuple preciseThreadId;
+    bool fastRunning = false;
+    bool preciseRunning = false;
+    bool cancelled = false;       // 精确匹配已被取消
+    bool fastInterrupted = false; // 快速匹配被精确匹配取消
+    HTuple row, column, angle, score;
+  };
+  auto state = std::make_shared<SpeculativeState>();
+  {
+    QMutexLocker locker(&state->mutex);
+    GetCurrentHthreadId(&state->fastThreadId);
+    state->fastRunning = true;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  // 精确匹配任务只持有共享状态和模板副本（引用计数），快速匹配胜出时不必等它退出
+  m_preciseFuture = QtConcurrent::run(speculativeMatchPool(), [state, grayImage, preciseModel, config]() {
+    {
+      QMutexLocker locker(&state->mutex);
+      if (state->cancelled)
+      {
+        return;
+      }
+      GetCurrentHthreadId(&state->preciseThreadId);
+      state->preciseRunning = true;
+    }
+    HTuple row, column, angle, score;
+    try
+    {
+      PROFILE_STAGE(InspectionStage::FindShapePrecise);
+      findPrecise(grayImage, preciseModel, config.preciseMinScore, row, column, angle, score);
+    }
+    catch (const HalconCpp::HException&)
+    {
+      row = HTuple(); // 被取消或超时，结果为空
+    }
+
+    QMutexLocker locker(&state->mutex);
+    state->preciseRunning = false;
+    state->row = row;
+    state->column = column;
+    state->angle = angle;
+    state->score = score;
+
+    // 精确匹配先得到可接受结果时取消仍在运行的快速匹配
+    if (row.Length() > 0 && score[0].D() >= config.acceptScore && state->fastRunning)
+    {
+      try
+      {
+        InterruptOperator(state->fastThreadId, "cancel");
+        state->fastInterrupted = true;
+      }
+      catch (const HalconCpp::HException&)
+      {
+      }
+    }
+  });
+
+  bool fastAccepted = false;
+  try
+  {
+    PROFILE_STAGE(InspectionStage::FindShapeFast);
+    findFast(grayImage, modelId, config.fastMinScore, Crow, Ccol, Cangle, Cscore);
+    fastAccepted = Crow.Length() > 0 && Cscore[0].D() >= config.acceptScore;
+  }
+  catch (const HalconCpp::HException& except)
+  {
+    QMutexLocker locker(&state->mutex);
+    if (!state->fastInterrupted)
+    {
+      LOG_WARNING(QString("⚠️ 快速匹配失败，等待精确匹配结果: %1").arg(except.ErrorMessage().Text()));
+    }
+    Crow = HTuple();
+  }
+
+  bool cancelled = false;
+  {
+    QMutexLocker locker(&state->mutex);
+    state->fastRunning = false;
+    cancelled = state->fastInterrupted;
+  }
+  if (fastAccepted)
+  {
+    // 快速匹配结果可接受：取消并丢弃精确匹配，不等待其退出
+    QMutexLocker locker(&state->mutex);
+    state->cancelled = true;
+    if (state->preciseRunning)
+    {
+      try
+      {
+        InterruptOperator(state->preciseThreadId, "cancel");
+        cancelled = true;
+      }
+      catch (const HalconCpp::HException& except)
+      {
+        LOG_WARNING(QString("⚠️ 取消精确匹配失败，由其超时结束: %1").arg(except.ErrorMessage().Text()));
+      }
+    }
+  }
+  double fastMs = timer.nsecsElapsed() / 1e6;
+
+  bool preciseWon = false;
+  if (!fastAccepted)
+  {
+    // 只有快速匹配不可用时才等待精确匹配；精确匹配模板的超时限定了等待时间
+    m_preciseFuture.waitForFinished();
+    QMutexLocker locker(&state->mutex);
+    if (state->row.Length() > 0)
+    {
+      Crow = state->row;
+      Ccol = state->column;
+      Cangle = state->angle;
+      Cscore = state->score;
+      preciseWon = true;
+    }
+    else if (Crow.Length() > 0)
+    {
+      LOG_INFO("快速匹配得分低于接受阈值且精确匹配无结果，使用快速匹配结果");
+    }
+  }
+  double totalMs = timer.nsecsElapsed() / 1e6;
+
+  QMutexLocker locker(&m_configMutex);
+  ++m_speculativeStats.frames;
+  if (fastAccepted)
+  {
+    ++m_speculativeStats.fastWins;
+  }
+  else if (preciseWon)
+  {
+    ++m_speculativeStats.preciseWins;
+  }
+  else
+  {
+    ++m_speculativeStats.misses;
+  }
+  if (cancelled)
+  {
+    ++m_speculativeStats.cancelled;
+  }
+  m_speculativeStats.fastMs += fastMs;
+  m_speculativeStats.totalMs += totalMs;
+}
+
+HTuple InspectionCore::ensurePreciseModel(quint64 generation, const HTuple& modelId, int timeoutMs)
+{
+  if (m_preciseModelGeneration == generation && m_preciseModel.Length() > 0
+      && m_preciseModelTimeoutMs == timeoutMs)
+  {
+    return m_preciseModel;
+  }
+
+  // 模板集版本或超时变化：先释放旧副本（调用者已确认没有精确匹配仍在使用它）
+  if (m_preciseModel.Length() > 0)
+  {
+    try
+    {
+      ClearShapeModel(m_preciseModel);
+    }
+    catch (const HalconCpp::HException& except)
+    {
+      LOG_WARNING(QString("⚠️ 释放旧的精确匹配模板失败: %1").arg(except.ErrorMessage().Text()));
+    }
+    m_preciseModel = HTuple();
+  }
+  m_preciseModelGeneration = 0;
+
+  try
+  {
+    HTuple serializedItem;
+    SerializeShapeModel(modelId, &serializedItem);
+    DeserializeShapeModel(serializedItem, &m_preciseModel);
+    ClearSerializedItem(serializedItem);
+
+    // 超时作为取消的兜底：取消信号早于匹配开始时，精确匹配最多运行 timeoutMs
+    if (timeoutMs > 0)
+    {
+      SetShapeModelParam(m_preciseModel, "timeout", timeoutMs);
+    }
+  }
+  catch (const HalconCpp::HException& except)
+  {
+    // 不与快速匹配共用句柄（两者会同时运行），本帧及之后改为顺序匹配，直到复制成功
+    LOG_WARNING(QString("⚠️ 复制精确匹配模板失败，不使用投机匹配: %1").arg(except.ErrorMessage().Text()));
+    m_preciseModel = HTuple();
+    return HTuple();
+  }
+  m_preciseModelGeneration = generation;
+  m_preciseModelTimeoutMs = timeoutMs;
+  return m_preciseModel;
+}
@@ -0,0 +1,369 @@
+/**
+ * @file InspectionPipeline.cpp
+ * @brief 批量检测流水线实现 | Batch decode → inspect → publish pipeline implementation
+ */
+
+#include "../inc/thread/InspectionPipeline.h"
+#include "../inc/thread/InspectionPool.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QStringList>
+#include <QThread>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+InspectionPipeline::InspectionPipeline(InspectionCore* core, TemplateCache* cache, InspectionPool* pool) :
+  m_core(core)
+  , m_cache(cache)
+  , m_pool(pool)
+{
+}
+
+void InspectionPipeline::setPrefetchDepth(int depth)
+{
+  m_prefetchDepth = qMax(1, depth);
+}
+
+void InspectionPipeline::setPublishDepth(int depth)
+{
+  m_publishDepth = qMax(1, depth);
+}
+
+void InspectionPipeline::addPublisher(const Publisher& publisher)
+{
+  m_publishers.append(publisher);
+}
+
+void InspectionPipeline::setContinueCheck(const ContinueCheck& check)
+{
+  m_continueCheck = check;
+}
+
+void InspectionPipeline::setErrorHandler(const ErrorHandler& handler)
+{
+  m_errorHandler = handler;
+}
+
+int InspectionPipeline::run(const QFileInfoList& files)
+{
+  FileListSource source(files);
+  return run(source);
+}
+
+int InspectionPipeline::run(ImageSource& source)
+{
+  QElapsedTimer wallTimer;
+  wallTimer.start();
+  m_ingestLatency.reset();
+
+  PipelineStageStats decodeStats;
+  PipelineStageStats inspectStats;
+  PipelineStageStats publishStats;
+  decodeStats.name = "解码";
+  inspectStats.name = "检测";
+  publishStats.name = "发布";
+
+  BoundedQueue<DecodedFrame> decodeQueue(m_prefetchDepth);
+  BoundedQueue<InspectionResult> publishQueue(m_publishDepth);
+
+  QThread* decodeThread = QThread::create([&]() { decodeStage(source, decodeQueue, decodeStats); });
+  QThread* publishThread = QThread::create([&]() { publishStage(source, publishQueue, publishStats); });
+  decodeThread->setObjectName("PipelineDecode");
+  publishThread->setObjectName("PipelinePublish");
+  decodeThread->start();
+  publishThread->start();
+
+  // 检测阶段在调用线程中运行
+  qint64 inspectBusyNs = 0;
+  qint64 inspectOutputStallNs = 0;
+  if (m_pool != nullptr)
+  {
+    // 线程池结果按提交顺序到达，直接转入发布队列；
+    // 在途帧数受信号量限制，避免解码远超检测时线程池队列无限增长
+    QSemaphore inFlight(m_pool->workerCount() * 2);
+    QMetaObject::Connection connection = QObject::connect(
+        m_pool, &InspectionPool::resultReady,
+        [&publishQueue, &inFlight](const InspectionResult& result) {
+          publishQueue.push(result);
+          inFlight.release();
+        });
+
+    m_pool->beginBatch();
+    DecodedFrame frame;
+    while (decodeQueue.pop(frame))
+    {
+      QElapsedTimer stallTimer;
+      stallTimer.start();
+      inFlight.acquire();
+      inspectOutputStallNs += stallTimer.nsecsElapsed();
+      recordIngestLatency(frame);
+
+      QElapsedTimer busyTimer;
+      busyTimer.start();
+      m_pool->submit(frame.image, frame.imagePath);
+      inspectBusyNs += busyTimer.nsecsElapsed();
+      ++inspectStats.items;
+    }
+    m_pool->waitForDone();
+    QObject::disconnect(connection);
+  }
+  else
+  {
+    DecodedFrame frame;
+    while (decodeQueue.pop(frame))
+    {
+      recordIngestLatency(frame);
+
+      QElapsedTimer busyTimer;
+      busyTimer.start();
+      InspectionResult result = inspectSerial(frame);
+      inspectBusyNs += busyTimer.nsecsElapsed();
+      ++inspectStats.items;
+
+      QElapsedTimer stallTimer;
+      stallTimer.start();
+      publishQueue.push(std::move(result));
+      inspectOutputStallNs += stallTimer.nsecsElapsed();
+    }
+  }
+
+  publishQueue.close();
+  decodeThread->wait();
+  publishThread->wait();
+  delete decodeThread;
+  delete publishThread;
+
+  // 汇总队列统计：每个阶段的输入等待来自其输入队列的出队等待，输出等待来自输出队列的入队等待
+  BoundedQueueStats decodeQueueStats = decodeQueue.stats();
+  BoundedQueueStats publishQueueStats = publishQueue.stats();
+
+  decodeStats.outputStallMs = decodeQueueStats.pushWaitMs;
+
+  inspectStats.busyMs = inspectBusyNs / 1e6;
+  inspectStats.inputStallMs = decodeQueueStats.popWaitMs;
+  inspectStats.outputStallMs = inspectOutputStallNs / 1e6;
+  inspectStats.queueCapacity = decodeQueueStats.capacity;
+  inspectStats.maxQueueDepth = decodeQueueStats.maxDepth;
+  inspectStats.avgQueueDepth = decodeQueueStats.avgDepth;
+
+  publishStats.inputStallMs = publishQueueStats.popWaitMs;
+  publishStats.queueCapacity = publishQueueStats.capacity;
+  publishStats.maxQueueDepth = publishQueueStats.maxDepth;
+  publishStats.avgQueueDepth = publishQueueStats.avgDepth;
+
+  m_stats = {decodeStats, inspectStats, publishStats};
+  m_wallMs = wallTimer.nsecsElapsed() / 1e6;
+  return static_cast<int>(publishStats.items);
+}
+
+void InspectionPipeline::decodeStage(ImageSource& source, BoundedQueue<DecodedFrame>& decodeQueue,
+                                     PipelineStageStats& stats)
+{
+  qint64 sequence = 0;
+  qint64 busyNs = 0;
+  const int total = source.totalCount();
+  int index = 0;
+  SourceImage item;
+  while (true)
+  {
+    if (m_continueCheck && !m_continueCheck())
+    {
+      LOG_WARNING("线程已停止，不再读取后续图像");
+      break;
+    }
+    if (!source.next(item))
+    {
+      break; // 来源已结束或已停止
+    }
+    ++index;
+
+    QString filePath = item.path;
+    QString fileName = QFileInfo(filePath).fileName();
+
+    DecodedFrame frame;
+    frame.imagePath = filePath;
+    frame.readyMs = item.readyMs;
+    try
+    {
+      if (total >= 0)
+      {
+        LOG_INFO(QString("🖼️ 正在读取图像 [%1/%2]: %3").arg(index).arg(total).arg(fileName));
+      }
+      else
+      {
+        LOG_INFO(QString("🖼️ 正在读取图像 #%1: %2").arg(index).arg(fileName));
+      }
+
+      QElapsedTimer timer;
+      timer.start();
+      ReadImage(&frame.image, filePath.toStdString().c_str());
+      busyNs += timer.nsecsElapsed();
+    }
+    catch (const HalconCpp::HException& e)
+    {
+      QString errorMsg = QString("处理图像 %1 时发生Halcon异常: %2")
+                         .arg(fileName).arg(QString(e.ErrorMessage()));
+      LOG_ERROR(errorMsg);
+      source.markFailed(filePath); // 未发布，不记为已处理
+      continue; // 继续读取下一张图像
+    }
+    catch (const std::exception& e)
+    {
+      QString errorMsg = QString("处理图像 %1 时发生异常: %2")
+                         .arg(fileName).arg(QString::fromStdString(e.what()));
+      LOG_ERROR(errorMsg);
+      source.markFailed(filePath);
+      continue;
+    }
+
+    if (frame.image.IsInitialized() == false)
+    {
+      QString errorMsg = QString("图像 %1 读取失败").arg(fileName);
+      LOG_ERROR(errorMsg);
+      if (m_errorHandler)
+      {
+        m_errorHandler(errorMsg);
+      }
+      source.markFailed(filePath);
+      continue;
+    }
+
+    frame.sequence = sequence++;
+    ++stats.items;
+    if (!decodeQueue.push(std::move(frame)))
+    {
+      break; // 队列已关闭
+    }
+  }
+
+  stats.busyMs = busyNs / 1e6;
+  decodeQueue.close();
+}
+
+InspectionResult InspectionPipeline::inspectSerial(const DecodedFrame& frame)
+{
+  InspectionResult result;
+  try
+  {
+    TemplateSetPtr templateSet = m_cache->acquire();
+    if (templateSet && templateSet->isValid())
+    {
+      result = m_core->inspect(frame.image, *templateSet, templateSet->modelId);
+    }
+    else
+    {
+      LOG_ERROR("❌ 模板未正确加载，无法进行匹配");
+      result.image = frame.image;
+    }
+  }
+  catch (const HalconCpp::HException& e)
+  {
+    LOG_ERROR(QString("检测 %1 时发生Halcon异常: %2").arg(frame.imagePath).arg(QString(e.ErrorMessage())));
+    result = InspectionResult();
+    result.image = frame.image;
+  }
+
+  result.sequence = frame.sequence;
+  result.record.sequence = frame.sequence;
+  result.imagePath = frame.imagePath;
+  return result;
+}
+
+void InspectionPipeline::recordIngestLatency(const DecodedFrame& frame)
+{
+  if (frame.readyMs <= 0)
+  {
+    return;
+  }
+  qint64 latencyMs = qMax<qint64>(0, QDateTime::currentMSecsSinceEpoch() - frame.readyMs);
+  m_ingestLatency.record(static_cast<std::uint64_t>(latencyMs) * 1000 * 1000);
+}
+
+void InspectionPipeline::publishStage(ImageSource& source, BoundedQueue<InspectionResult>& publishQueue,
+                                      PipelineStageStats& stats)
+{
+  qint64 busyNs = 0;
+  InspectionResult result;
+  while (publishQueue.pop(result))
+  {
+    QElapsedTimer timer;
+    timer.start();
+    for (const Publisher& publisher : m_publishers)
+    {
+      try
+      {
+        publisher(result);
+      }
+      catch (const std::exception& e)
+      {
+        LOG_ERROR(QString("发布 %1 的结果时发生异常: %2")
+            .arg(result.imagePath).arg(QString::fromStdString(e.what())));
+      }
+    }
+    source.markProcessed(result.imagePath);
+    busyNs += timer.nsecsElapsed();
+    ++stats.items;
+  }
+  stats.busyMs = busyNs / 1e6;
+}
+
+QList<PipelineStageStats> InspectionPipeline::stageStats() const
+{
+  return m_stats;
+}
+
+LatencySnapshot InspectionPipeline::ingestLatency() const
+{
+  return m_ingestLatency.snapshot();
+}
+
+QString InspectionPipeline::statsSummary() const
+{
+  QStringList lines;
+  quint64 published = m_stats.isEmpty() ? 0 : m_stats.last().items;
+  double throughput = m_wallMs > 0.0 ? published * 1000.0 / m_wallMs : 0.0;
+  lines << QString("总耗时=%1 ms, 吞吐量=%2 帧/秒")
+           .arg(m_wallMs, 0, 'f', 1).arg(throughput, 0, 'f', 2);
+
+  for (const PipelineStageStats& stage : m_stats)
+  {
+    QString line = QString("%1: 数量=%2, 工作=%3 ms, 等待输入=%4 ms, 等待输出=%5 ms")
+                   .arg(stage.name).arg(stage.items)
+                   .arg(stage.busyMs, 0, 'f', 1)
+                   .arg(stage.inputStallMs, 0, 'f', 1)
+                   .arg(stage.outputStallMs, 0, 'f', 1);
+    if (stage.queueCapacity > 0)
+    {
+      line += QString(", 输入队列 最大=%1/%2 平均=%3")
+              .arg(stage.maxQueueDepth).arg(stage.queueCapacity)
+              .arg(stage.avgQueueDepth, 0, 'f', 2);
+    }
+    lines << line;
+  }
+
+  LatencySnapshot ingest = m_ingestLatency.snapshot();
+  if (ingest.count > 0)
+  {
+    lines << QString("入队延迟(写入完成→开始检测): 数量=%1, 平均=%2 ms, p50=%3 ms, p95=%4 ms, 最大=%5 ms")
+             .arg(ingest.count)
+             .arg(ingest.meanUs / 1e3, 0, 'f', 1)
+             .arg(ingest.p50Us / 1e3, 0, 'f', 1)
+             .arg(ingest.p95Us / 1e3, 0, 'f', 1)
+             .arg(ingest.maxUs / 1e3, 0, 'f', 1);
+  }
+  return lines.join("\n");
+}
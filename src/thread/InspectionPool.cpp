@@ -0,0 +1,355 @@
+/**
+ * @file InspectionPool.cpp
+ * @brief 多线程检测池实现 | Multi-worker inspection pool implementation
+ */
+
+#include "../inc/thread/InspectionPool.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <QThread>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+InspectionPool::InspectionPool(TemplateCache* cache, int workerCount, QObject* parent) :
+  QObject(parent)
+  , m_cache(cache)
+  , m_track(std::make_shared<SearchTrack>())
+{
+  qRegisterMetaType<InspectionResult>("InspectionResult");
+
+  int count = qMax(1, workerCount);
+  for (int i = 0; i < count; ++i)
+  {
+    Worker* worker = new Worker();
+    worker->index = i;
+    worker->core.setSearchTrack(m_track);
+    worker->core.setParallelToolsByDefault(count == 1); // 多个检测线程时帧间并行已占满CPU，同层工具顺序执行
+    m_workers.append(worker);
+  }
+  LOG_INFO(QString("🧵 检测线程池已创建，线程数: %1").arg(count));
+}
+
+InspectionPool::~InspectionPool()
+{
+  stop();
+  for (Worker* worker : m_workers)
+  {
+    delete worker;
+  }
+  m_workers.clear();
+}
+
+void InspectionPool::start()
+{
+  if (!m_workers.isEmpty() && m_workers.first()->thread != nullptr)
+  {
+    return; // 已启动
+  }
+
+  m_stopping = false;
+  m_uptime.start();
+  for (Worker* worker : m_workers)
+  {
+    worker->thread = QThread::create([this, worker]() { runWorker(worker); });
+    worker->thread->setObjectName(QString("InspectionWorker-%1").arg(worker->index));
+    worker->thread->start();
+  }
+  LOG_INFO(QString("🚀 检测线程池已启动，线程数: %1").arg(m_workers.size()));
+}
+
+void InspectionPool::stop()
+{
+  m_stopping = true;
+  {
+    QMutexLocker locker(&m_wakeMutex);
+    m_wakeCondition.wakeAll();
+  }
+
+  for (Worker* worker : m_workers)
+  {
+    if (worker->thread != nullptr)
+    {
+      worker->thread->wait();
+      delete worker->thread;
+      worker->thread = nullptr;
+    }
+    QMutexLocker locker(&worker->queueMutex);
+    worker->queue.clear();
+  }
+  m_pendingTasks = 0;
+
+  // 丢弃未完成的帧，避免等待者永久阻塞
+  QMutexLocker locker(&m_reorderMutex);
+  m_reorderBuffer.clear();
+  m_nextToDeliver = m_nextSequence;
+  m_doneCondition.wakeAll();
+}
+
+void InspectionPool::beginBatch()
+{
+  QMutexLocker locker(&m_reorderMutex);
+  if (m_nextToDeliver != m_nextSequence)
+  {
+    LOG_WARNING(QString("上一批次仍有 %1 帧未完成，新批次将在其后排序").arg(m_nextSequence - m_nextToDeliver));
+    return;
+  }
+  m_reorderBuffer.clear();
+  m_nextSequence = 0;
+  m_nextToDeliver = 0;
+  m_track->reset(); // 帧号重新计数，上一批次的跟踪位姿不再可比
+}
+
+qint64 InspectionPool::submit(const HObject& image, const QString& imagePath)
+{
+  Task task;
+  task.image = image;
+  task.imagePath = imagePath;
+  {
+    QMutexLocker locker(&m_reorderMutex);
+    task.sequence = m_nextSequence++;
+  }
+
+  // 轮询分发到各线程本地队列，负载不均时由空闲线程窃取
+  Worker* worker = m_workers.at(static_cast<int>(m_nextWorker.fetch_add(1) % static_cast<quint64>(m_workers.size())));
+  ++m_pendingTasks;
+  {
+    QMutexLocker locker(&worker->queueMutex);
+    worker->queue.push_back(task);
+  }
+
+  QMutexLocker locker(&m_wakeMutex);
+  m_wakeCondition.wakeOne();
+  return task.sequence;
+}
+
+bool InspectionPool::waitForDone(int msecs)
+{
+  QDeadlineTimer deadline(msecs < 0 ? QDeadlineTimer::Forever : msecs);
+  QMutexLocker locker(&m_reorderMutex);
+  while (m_nextToDeliver < m_nextSequence)
+  {
+    if (!m_doneCondition.wait(&m_reorderMutex, deadline))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+int InspectionPool::workerCount() const
+{
+  return m_workers.size();
+}
+
+QList<InspectionWorkerStats> InspectionPool::workerStats() const
+{
+  QList<InspectionWorkerStats> stats;
+  double uptimeMs = m_uptime.isValid() ? m_uptime.nsecsElapsed() / 1e6 : 0.0;
+  for (const Worker* worker : m_workers)
+  {
+    InspectionWorkerStats item;
+    item.index = worker->index;
+    item.processed = worker->processed.load();
+    item.stolen = worker->stolen.load();
+    item.busyMs = worker->busyNs.load() / 1e6;
+    item.utilisation = uptimeMs > 0.0 ? item.busyMs / uptimeMs : 0.0;
+    stats.append(item);
+  }
+  return stats;
+}
+
+QString InspectionPool::utilisationSummary() const
+{
+  QStringList lines;
+  for (const InspectionWorkerStats& item : workerStats())
+  {
+    lines << QString("线程%1: 处理=%2, 窃取=%3, 耗时=%4 ms, 利用率=%5%")
+             .arg(item.index).arg(item.processed).arg(item.stolen)
+             .arg(item.busyMs, 0, 'f', 1).arg(item.utilisation * 100.0, 0, 'f', 1);
+  }
+  return lines.join("\n");
+}
+
+void InspectionPool::setSearchWindowConfig(const SearchWindowConfig& config)
+{
+  for (Worker* worker : m_workers)
+  {
+    worker->core.setSearchWindowConfig(config);
+  }
+}
+
+SearchWindowStats InspectionPool::searchWindowStats() const
+{
+  SearchWindowStats total;
+  for (const Worker* worker : m_workers)
+  {
+    total.merge(worker->core.searchWindowStats());
+  }
+  return total;
+}
+
+void InspectionPool::setMatchPassConfig(const MatchPassConfig& config)
+{
+  for (Worker* worker : m_workers)
+  {
+    worker->core.setMatchPassConfig(config);
+  }
+}
+
+SpeculativeMatchStats InspectionPool::speculativeStats() const
+{
+  SpeculativeMatchStats total;
+  for (const Worker* worker : m_workers)
+  {
+    total.merge(worker->core.speculativeStats());
+  }
+  return total;
+}
+
+void InspectionPool::runWorker(Worker* worker)
+{
+  while (!m_stopping)
+  {
+    Task task;
+    if (!takeTask(worker, task))
+    {
+      QMutexLocker locker(&m_wakeMutex);
+      if (m_pendingTasks.load() == 0 && !m_stopping)
+      {
+        m_wakeCondition.wait(&m_wakeMutex, 100);
+      }
+      continue;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    InspectionResult result;
+    try
+    {
+      TemplateSetPtr templateSet = m_cache->acquire();
+      if (templateSet && templateSet->isValid())
+      {
+        ensureModelCopy(worker, *templateSet);
+        result = worker->core.inspect(task.image, *templateSet, worker->modelId, task.sequence);
+      }
+      else
+      {
+        LOG_ERROR("❌ 模板未正确加载，无法进行匹配");
+        result.image = task.image;
+      }
+    }
+    catch (const HalconCpp::HException& e)
+    {
+      LOG_ERROR(QString("检测线程%1处理 %2 时发生Halcon异常: %3")
+          .arg(worker->index).arg(task.imagePath).arg(QString(e.ErrorMessage())));
+      result = InspectionResult();
+      result.image = task.image;
+    }
+    catch (const std::exception& e)
+    {
+      LOG_ERROR(QString("检测线程%1处理 %2 时发生异常: %3")
+          .arg(worker->index).arg(task.imagePath).arg(QString::fromStdString(e.what())));
+      result = InspectionResult();
+      result.image = task.image;
+    }
+
+    result.sequence = task.sequence;
+    result.record.sequence = task.sequence;
+    result.imagePath = task.imagePath;
+    worker->busyNs += timer.nsecsElapsed();
+    ++worker->processed;
+
+    deliver(std::move(result));
+  }
+}
+
+bool InspectionPool::takeTask(Worker* worker, Task& task)
+{
+  // 优先处理本地队列（头部，保持提交顺序）
+  {
+    QMutexLocker locker(&worker->queueMutex);
+    if (!worker->queue.empty())
+    {
+      task = worker->queue.front();
+      worker->queue.pop_front();
+      --m_pendingTasks;
+      return true;
+    }
+  }
+
+  // 本地队列为空，从其他线程队列尾部窃取
+  int count = m_workers.size();
+  for (int offset = 1; offset < count; ++offset)
+  {
+    Worker* victim = m_workers.at((worker->index + offset) % count);
+    QMutexLocker locker(&victim->queueMutex);
+    if (!victim->queue.empty())
+    {
+      task = victim->queue.back();
+      victim->queue.pop_back();
+      --m_pendingTasks;
+      ++worker->stolen;
+      return true;
+    }
+  }
+  return false;
+}
+
+void InspectionPool::ensureModelCopy(Worker* worker, const TemplateSet& templateSet)
+{
+  if (worker->modelGeneration == templateSet.generation && worker->modelId.Length() > 0)
+  {
+    return;
+  }
+
+  // 通过序列化复制模板，各线程使用独立句柄，互不争用
+  try
+  {
+    HTuple serializedItem;
+    SerializeShapeModel(templateSet.modelId, &serializedItem);
+    DeserializeShapeModel(serializedItem, &worker->modelId);
+    ClearSerializedItem(serializedItem);
+    LOG_INFO(QString("检测线程%1已复制模板，版本=%2").arg(worker->index).arg(templateSet.generation));
+  }
+  catch (const HalconCpp::HException& e)
+  {
+    LOG_WARNING(QString("检测线程%1复制模板失败，改用共享句柄: %2")
+        .arg(worker->index).arg(QString(e.ErrorMessage())));
+    worker->modelId = templateSet.modelId;
+  }
+  worker->modelGeneration = templateSet.generation;
+}
+
+void InspectionPool::deliver(InspectionResult&& result)
+{
+  QMutexLocker locker(&m_reorderMutex);
+  m_reorderBuffer.insert(result.sequence, std::move(result));
+
+  // 在锁内按序发出，排队连接保证接收方看到的顺序与发出顺序一致
+  while (!m_reorderBuffer.isEmpty() && m_reorderBuffer.firstKey() == m_nextToDeliver)
+  {
+    InspectionResult ready = m_reorderBuffer.take(m_nextToDeliver);
+    ++m_nextToDeliver;
+
+    emit resultReady(ready);
+  }
+
+  if (m_nextToDeliver >= m_nextSequence)
+  {
+    m_doneCondition.wakeAll();
+  }
+}
@@ -0,0 +1,768 @@
+/**
+ * @file InspectionRecipe.cpp
+ * @brief 检测配方编译与执行计划实现 | Inspection recipe compiler and execution plan implementation
+ */
+
+#include "../inc/thread/InspectionRecipe.h"
+#include "../inc/thread/InspectionCore.h"
+#include "../inc/thread/LatencyProfiler.h"
+#include "../inc/thread/TemplateCache.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+#include "../thirdparty/hdevelop/include/HalconMeasure.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtMath>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+namespace
+{
+  // 配方中记录字段的名称，顺序与 MeasurementField 一致
+  const char* const kRecordFieldKeys[] = {
+    "MinDistance", "MaxDistance", "CentroidDistance", "Area1", "Area2",
+    "Centroid1X", "Centroid1Y", "Centroid2X", "Centroid2Y",
+    "MatchScore", "MatchRow", "MatchColumn", "MatchAngle"
+  };
+  static_assert(sizeof(kRecordFieldKeys) / sizeof(kRecordFieldKeys[0]) == static_cast<size_t>(MeasurementField::Count),
+                "kRecordFieldKeys must match MeasurementField");
+
+  int recordFieldFromKey(const QString& key)
+  {
+    for (int i = 0; i < static_cast<int>(MeasurementField::Count); ++i)
+    {
+      if (key == QLatin1String(kRecordFieldKeys[i]))
+      {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  bool toolTypeFromString(const QString& text, RecipeToolType& type)
+  {
+    if (text == "contour") { type = RecipeToolType::Contour; return true; }
+    if (text == "distance") { type = RecipeToolType::Distance; return true; }
+    if (text == "area") { type = RecipeToolType::Area; return true; }
+    if (text == "point_distance") { type = RecipeToolType::PointDistance; return true; }
+    if (text == "edge") { type = RecipeToolType::Edge; return true; }
+    if (text == "width") { type = RecipeToolType::Width; return true; }
+    return false;
+  }
+
+  int inputCount(RecipeToolType type)
+  {
+    return (type == RecipeToolType::Distance || type == RecipeToolType::PointDistance) ? 2 : 0;
+  }
+
+  // distance 的输入须为 contour；point_distance 的输入须为 area 或 edge（二者的 row、column 位于相同下标）
+  bool acceptsInput(RecipeToolType type, RecipeToolType inputType)
+  {
+    if (type == RecipeToolType::Distance)
+    {
+      return inputType == RecipeToolType::Contour;
+    }
+    return inputType == RecipeToolType::Area || inputType == RecipeToolType::Edge;
+  }
+
+  // 各类工具分别统计耗时，同类工具的每次执行记为一个样本
+  InspectionStage toolStage(RecipeToolType type)
+  {
+    switch (type)
+    {
+    case RecipeToolType::Contour: return InspectionStage::ContourExtract;
+    case RecipeToolType::Distance: return InspectionStage::DistanceMeasure;
+    case RecipeToolType::Area: return InspectionStage::AreaMeasure;
+    case RecipeToolType::PointDistance: return InspectionStage::PointDistance;
+    case RecipeToolType::Edge: return InspectionStage::EdgeMeasure;
+    case RecipeToolType::Width: return InspectionStage::WidthMeasure;
+    }
+    return InspectionStage::RecipeExecute;
+  }
+
+  // 配方中的方向位于模板坐标系，随本帧位姿旋转
+  std::optional<double> stepDirection(const RecipeStep& step, const InspectionPlanState& state)
+  {
+    if (!step.direction)
+    {
+      return std::nullopt;
+    }
+    return *step.direction + state.rotation;
+  }
+
+  bool usesRoi(RecipeToolType type)
+  {
+    return type == RecipeToolType::Contour || type == RecipeToolType::Area
+        || type == RecipeToolType::Edge || type == RecipeToolType::Width;
+  }
+
+  // 工具并行线程池：与检测线程池分开，同层工具由调用线程和池中线程共同完成
+  QThreadPool* recipeToolPool()
+  {
+    static QThreadPool* pool = []()
+    {
+      QThreadPool* created = new QThreadPool();
+      created->setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+      return created;
+    }();
+    return pool;
+  }
+
+  std::atomic<quint64> g_nextPlanId{1};
+}
+
+QStringList InspectionPlan::valueNames(RecipeToolType type)
+{
+  switch (type)
+  {
+  case RecipeToolType::Contour: return QStringList() << "length";
+  case RecipeToolType::Distance: return QStringList() << "min" << "max";
+  case RecipeToolType::Area: return QStringList() << "area" << "row" << "column";
+  case RecipeToolType::PointDistance: return QStringList() << "distance";
+  case RecipeToolType::Edge: return QStringList() << "amplitude" << "row" << "column";
+  case RecipeToolType::Width: return QStringList() << "width" << "row" << "column";
+  }
+  return QStringList();
+}
+
+QJsonObject InspectionPlan::defaultRecipe()
+{
+  auto roi = [](const QString& name, const QString& source)
+  {
+    QJsonObject object;
+    object["name"] = name;
+    object["source"] = source;
+    object["color"] = "green";
+    object["line_width"] = 2.0;
+    return object;
+  };
+  auto contour = [](const QString& name, const QString& roiName, const QString& color)
+  {
+    QJsonObject object;
+    object["name"] = name;
+    object["type"] = "contour";
+    object["roi"] = roiName;
+    object["threshold"] = 100;
+    object["color"] = color;
+    object["line_width"] = 3.0;
+    return object;
+  };
+  auto area = [](const QString& name, const QString& roiName, const QString& areaField,
+                 const QString& xField, const QString& yField)
+  {
+    QJsonObject record;
+    record["area"] = areaField;
+    record["column"] = xField;
+    record["row"] = yField;
+    QJsonObject object;
+    object["name"] = name;
+    object["type"] = "area";
+    object["roi"] = roiName;
+    object["record"] = record;
+    return object;
+  };
+
+  QJsonObject distanceRecord;
+  distanceRecord["min"] = "MinDistance";
+  distanceRecord["max"] = "MaxDistance";
+  QJsonObject distance;
+  distance["name"] = "gap";
+  distance["type"] = "distance";
+  distance["inputs"] = QJsonArray{"edge1", "edge2"};
+  distance["mode"] = "point_to_point";
+  distance["record"] = distanceRecord;
+
+  QJsonObject centroidRecord;
+  centroidRecord["distance"] = "CentroidDistance";
+  QJsonObject centroidDistance;
+  centroidDistance["name"] = "centroid_gap";
+  centroidDistance["type"] = "point_distance";
+  centroidDistance["inputs"] = QJsonArray{"area1", "area2"};
+  centroidDistance["record"] = centroidRecord;
+
+  QJsonObject recipe;
+  recipe["name"] = "default";
+  recipe["rois"] = QJsonArray{roi("rect1", "measure_rect1"), roi("rect2", "measure_rect2")};
+  recipe["tools"] = QJsonArray{
+    contour("edge1", "rect1", "red"),
+    contour("edge2", "rect2", "blue"),
+    distance,
+    area("area1", "rect1", "Area1", "Centroid1X", "Centroid1Y"),
+    area("area2", "rect2", "Area2", "Centroid2X", "Centroid2Y"),
+    centroidDistance
+  };
+  return recipe;
+}
+
+QJsonObject InspectionPlan::loadRecipe(const QString& path, QString& error)
+{
+  if (path.isEmpty() || !QFileInfo::exists(path))
+  {
+    return defaultRecipe();
+  }
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+  {
+    error = QString("无法打开配方文件 %1: %2").arg(path, file.errorString());
+    return QJsonObject();
+  }
+  QJsonParseError parseError;
+  QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+  if (parseError.error != QJsonParseError::NoError || !document.isObject())
+  {
+    error = QString("配方文件 %1 解析失败: %2 (偏移 %3)")
+            .arg(path, parseError.errorString()).arg(parseError.offset);
+    return QJsonObject();
+  }
+  return document.object();
+}
+
+bool InspectionPlan::saveRecipe(const QString& path, const QJsonObject& recipe, QString& error)
+{
+  if (!validate(recipe, error))
+  {
+    return false;
+  }
+  QDir().mkpath(QFileInfo(path).absolutePath());
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    error = QString("无法写入配方文件 %1: %2").arg(path, file.errorString());
+    return false;
+  }
+  file.write(QJsonDocument(recipe).toJson(QJsonDocument::Indented));
+  if (!file.commit())
+  {
+    error = QString("保存配方文件 %1 失败: %2").arg(path, file.errorString());
+    return false;
+  }
+  return true;
+}
+
+bool InspectionPlan::validate(const QJsonObject& recipe, QString& error)
+{
+  return build(recipe, nullptr, QString(), error) != nullptr;
+}
+
+InspectionPlanPtr InspectionPlan::compile(const QJsonObject& recipe, const TemplateSet& templateSet,
+                                          const QString& baseDir, QString& error)
+{
+  return build(recipe, &templateSet, baseDir, error);
+}
+
+InspectionPlanPtr InspectionPlan::build(const QJsonObject& recipe, const TemplateSet* templateSet,
+                                        const QString& baseDir, QString& error)
+{
+  std::shared_ptr<InspectionPlan> plan(new InspectionPlan());
+  plan->m_name = recipe.value("name").toString("unnamed");
+  const QJsonValue parallel = recipe.value("parallel");
+  if (parallel.isBool())
+  {
+    plan->m_parallel = parallel.toBool() ? ParallelMode::Enabled : ParallelMode::Disabled;
+  }
+
+  // 1. ROI：名称 → 下标，区域在编译时读取，每帧只做仿射映射
+  QHash<QString, int> roiIndex;
+  const QJsonArray rois = recipe.value("rois").toArray();
+  for (const QJsonValue& value : rois)
+  {
+    QJsonObject object = value.toObject();
+    RecipeRoi roi;
+    roi.name = object.value("name").toString();
+    if (roi.name.isEmpty() || roiIndex.contains(roi.name))
+    {
+      error = QString("ROI 名称为空或重复: '%1'").arg(roi.name);
+      return nullptr;
+    }
+    roi.color = object.value("color").toString("green");
+    roi.lineWidth = object.value("line_width").toDouble(2.0);
+    roi.display = object.value("display").toBool(true);
+
+    QString source = object.value("source").toString();
+    QString file = object.value("file").toString();
+    if (source.isEmpty() == file.isEmpty())
+    {
+      error = QString("ROI '%1' 须且只能指定 source 或 file 之一").arg(roi.name);
+      return nullptr;
+    }
+    if (!source.isEmpty() && source != "measure_rect1" && source != "measure_rect2")
+    {
+      error = QString("ROI '%1' 的 source 未知: %2").arg(roi.name, source);
+      return nullptr;
+    }
+
+    if (templateSet != nullptr)
+    {
+      if (source == "measure_rect1" || source == "measure_rect2")
+      {
+        if (!templateSet->hasMeasureRegions())
+        {
+          error = QString("ROI '%1' 引用的测量区域未加载").arg(roi.name);
+          return nullptr;
+        }
+        roi.region = source == "measure_rect1" ? templateSet->measureRect1 : templateSet->measureRect2;
+      }
+      else
+      {
+        // 优先使用模板集中已预加载的区域，否则在编译时读取
+        QString path = QDir::cleanPath(QDir(baseDir).absoluteFilePath(file));
+        auto it = templateSet->regions.constFind(path);
+        if (it != templateSet->regions.constEnd())
+        {
+          roi.region = it.value();
+        }
+        else
+        {
+          try
+          {
+            ReadRegion(&roi.region, path.toStdString().c_str());
+          }
+          catch (const HalconCpp::HException& e)
+          {
+            error = QString("读取 ROI '%1' 文件 %2 失败: %3").arg(roi.name, path).arg(QString(e.ErrorMessage()));
+            return nullptr;
+          }
+        }
+      }
+    }
+    roiIndex.insert(roi.name, plan->m_rois.size());
+    plan->m_rois.append(roi);
+  }
+
+  // 2. 工具：先登记名称，再解析引用（输入可以写在引用它的工具之后）
+  const QJsonArray tools = recipe.value("tools").toArray();
+  if (tools.isEmpty())
+  {
+    error = "配方中没有工具";
+    return nullptr;
+  }
+  QHash<QString, int> stepIndex;
+  for (const QJsonValue& value : tools)
+  {
+    QString name = value.toObject().value("name").toString();
+    if (name.isEmpty() || stepIndex.contains(name))
+    {
+      error = QString("工具名称为空或重复: '%1'").arg(name);
+      return nullptr;
+    }
+    stepIndex.insert(name, stepIndex.size());
+  }
+
+  plan->m_steps.resize(tools.size());
+  for (int i = 0; i < tools.size(); ++i)
+  {
+    QJsonObject object = tools[i].toObject();
+    RecipeStep& step = plan->m_steps[i];
+    step.name = object.value("name").toString();
+    QString typeName = object.value("type").toString();
+    if (!toolTypeFromString(typeName, step.type))
+    {
+      error = QString("工具 '%1' 的类型未知: %2").arg(step.name, typeName);
+      return nullptr;
+    }
+    step.color = object.value("color").toString();
+    step.lineWidth = object.value("line_width").toDouble(3.0);
+
+    if (usesRoi(step.type))
+    {
+      QString roiName = object.value("roi").toString();
+      step.roi = roiIndex.value(roiName, -1);
+      if (step.roi < 0)
+      {
+        error = QString("工具 '%1' 引用的 ROI 不存在: '%2'").arg(step.name, roiName);
+        return nullptr;
+      }
+      bool measures = step.type == RecipeToolType::Edge || step.type == RecipeToolType::Width;
+      step.threshold = object.value("threshold").toInt(measures ? 30 : 100);
+      step.sigma = object.value("sigma").toDouble(1.0);
+      if (measures && object.contains("direction"))
+      {
+        if (!object.value("direction").isDouble())
+        {
+          error = QString("工具 '%1' 的 direction 须为角度数值(度)").arg(step.name);
+          return nullptr;
+        }
+        step.direction = qDegreesToRadians(object.value("direction").toDouble());
+      }
+    }
+    else
+    {
+      QJsonArray inputs = object.value("inputs").toArray();
+      if (inputs.size() != inputCount(step.type))
+      {
+        error = QString("工具 '%1' 需要 %2 个输入").arg(step.name).arg(inputCount(step.type));
+        return nullptr;
+      }
+      for (int k = 0; k < inputs.size(); ++k)
+      {
+        int input = stepIndex.value(inputs[k].toString(), -1);
+        if (input < 0 || input == i)
+        {
+          error = QString("工具 '%1' 的输入无效: '%2'").arg(step.name, inputs[k].toString());
+          return nullptr;
+        }
+        QJsonObject inputObject = tools[input].toObject();
+        RecipeToolType inputType;
+        if (!toolTypeFromString(inputObject.value("type").toString(), inputType)
+            || !acceptsInput(step.type, inputType))
+        {
+          error = QString("工具 '%1' 的输入 '%2' 类型不符").arg(step.name, inputs[k].toString());
+          return nullptr;
+        }
+        step.inputs[k] = input;
+      }
+      step.distanceMode = object.value("mode").toString("point_to_point");
+    }
+
+    // 记录字段与公差按输出值名称解析为下标
+    const QStringList names = valueNames(step.type);
+    const QJsonObject record = object.value("record").toObject();
+    for (auto it = record.constBegin(); it != record.constEnd(); ++it)
+    {
+      int valueIndex = names.indexOf(it.key());
+      int field = recordFieldFromKey(it.value().toString());
+      if (valueIndex < 0 || field < 0)
+      {
+        error = QString("工具 '%1' 的记录映射无效: %2 → %3").arg(step.name, it.key(), it.value().toString());
+        return nullptr;
+      }
+      step.recordFields[valueIndex] = field;
+    }
+    if (object.contains("tolerance"))
+    {
+      QJsonObject tolerance = object.value("tolerance").toObject();
+      QString valueName = tolerance.value("value").toString(names.first());
+      step.tolerance.valueIndex = names.indexOf(valueName);
+      if (step.tolerance.valueIndex < 0)
+      {
+        error = QString("工具 '%1' 的公差引用了未知输出值: %2").arg(step.name, valueName);
+        return nullptr;
+      }
+      if (tolerance.contains("min"))
+      {
+        step.tolerance.min = tolerance.value("min").toDouble();
+      }
+      if (tolerance.contains("max"))
+      {
+        step.tolerance.max = tolerance.value("max").toDouble();
+      }
+    }
+  }
+
+  // 3. 按依赖分层：层号 = 输入层号的最大值 + 1，同时检查依赖环
+  QVector<int> level(plan->m_steps.size(), -1);
+  QVector<bool> visiting(plan->m_steps.size(), false);
+  std::function<int(int)> resolveLevel = [&](int index) -> int
+  {
+    if (level[index] >= 0)
+    {
+      return level[index];
+    }
+    if (visiting[index])
+    {
+      return -1;
+    }
+    visiting[index] = true;
+    int result = 0;
+    const RecipeStep& step = plan->m_steps[index];
+    for (int k = 0; k < inputCount(step.type); ++k)
+    {
+      int inputLevel = resolveLevel(step.inputs[k]);
+      if (inputLevel < 0)
+      {
+        return -1;
+      }
+      result = qMax(result, inputLevel + 1);
+    }
+    visiting[index] = false;
+    level[index] = result;
+    return result;
+  };
+  for (int i = 0; i < plan->m_steps.size(); ++i)
+  {
+    int stepLevel = resolveLevel(i);
+    if (stepLevel < 0)
+    {
+      error = QString("工具 '%1' 存在循环依赖").arg(plan->m_steps[i].name);
+      return nullptr;
+    }
+    if (stepLevel >= plan->m_stages.size())
+    {
+      plan->m_stages.resize(stepLevel + 1);
+    }
+    plan->m_stages[stepLevel].append(i);
+  }
+
+  plan->m_id = g_nextPlanId++;
+  return plan;
+}
+
+QString InspectionPlan::summary() const
+{
+  QStringList stages;
+  for (const QVector<int>& stage : m_stages)
+  {
+    QStringList names;
+    for (int index : stage)
+    {
+      names << m_steps[index].name;
+    }
+    stages << QString("[%1]").arg(names.join(", "));
+  }
+  return QString("配方 '%1': ROI=%2, 工具=%3, 分层=%4 %5, 并行=%6")
+         .arg(m_name).arg(m_rois.size()).arg(m_steps.size()).arg(m_stages.size())
+         .arg(stages.join(" → "))
+         .arg(m_parallel == ParallelMode::Auto ? "自动" : (m_parallel == ParallelMode::Enabled ? "开启" : "关闭"));
+}
+
+bool InspectionPlan::isParallel(const InspectionPlanState& state) const
+{
+  if (m_parallel == ParallelMode::Auto)
+  {
+    return state.parallelByDefault;
+  }
+  return m_parallel == ParallelMode::Enabled;
+}
+
+void InspectionPlan::prepare(InspectionPlanState& state) const
+{
+  if (state.planId == m_id)
+  {
+    return;
+  }
+  state.planId = m_id;
+  state.mappedRois = QVector<HObject>(m_rois.size());
+  state.outputs = QVector<RecipeStepOutput>(m_steps.size());
+}
+
+bool InspectionPlan::execute(const HObject& image, const HTuple& homMat2D, const HalconMeasure& helper,
+                             InspectionPlanState& state, InspectionResult& result) const
+{
+  prepare(state);
+  state.rotation = std::atan2(homMat2D[3].D(), homMat2D[0].D()); // 刚体变换 [cos −sin tr; sin cos tc]
+
+  // ROI 映射到当前位姿（每帧一次，被多个工具共用）
+  for (int i = 0; i < m_rois.size(); ++i)
+  {
+    AffineTransRegion(m_rois[i].region, &state.mappedRois[i], homMat2D, "nearest_neighbor");
+    if (m_rois[i].display)
+    {
+      result.displayObjects.append(DisplayObjectInfo(state.mappedRois[i], m_rois[i].color, m_rois[i].lineWidth));
+    }
+  }
+  for (RecipeStepOutput& output : state.outputs)
+  {
+    output.ok = false;
+  }
+
+  // 逐层执行，同层工具并行：调用线程执行第一个，其余交给工具线程池
+  const bool parallel = isParallel(state);
+  for (const QVector<int>& stage : m_stages)
+  {
+    if (!parallel || stage.size() == 1)
+    {
+      for (int index : stage)
+      {
+        runStep(index, image, helper, state);
+      }
+      continue;
+    }
+
+    QList<QFuture<void>> futures;
+    for (int k = 1; k < stage.size(); ++k)
+    {
+      const int index = stage[k];
+      futures.append(QtConcurrent::run(recipeToolPool(), [this, index, &image, &helper, &state]()
+      {
+        runStep(index, image, helper, state);
+      }));
+    }
+    runStep(stage[0], image, helper, state);
+    for (QFuture<void>& future : futures)
+    {
+      future.waitForFinished();
+    }
+  }
+
+  // 按配方顺序汇总：显示对象、记录字段、公差
+  MeasurementRecord& record = result.record;
+  bool recordedAll = true;
+  bool recordedAny = false;
+  bool inTolerance = true;
+  for (int i = 0; i < m_steps.size(); ++i)
+  {
+    const RecipeStep& step = m_steps[i];
+    const RecipeStepOutput& output = state.outputs[i];
+    bool writesRecord = false;
+    for (int v = 0; v < kRecipeMaxToolValues; ++v)
+    {
+      writesRecord = writesRecord || step.recordFields[v] >= 0;
+    }
+    recordedAny = recordedAny || writesRecord;
+
+    if (!output.ok)
+    {
+      LOG_INFO(QString("❌ 工具 '%1' 未得到结果").arg(step.name));
+      recordedAll = recordedAll && !writesRecord;
+      continue;
+    }
+    if (!step.color.isEmpty() && output.object.IsInitialized())
+    {
+      result.displayObjects.append(DisplayObjectInfo(output.object, step.color, step.lineWidth));
+    }
+    for (int v = 0; v < kRecipeMaxToolValues; ++v)
+    {
+      if (step.recordFields[v] >= 0)
+      {
+        record.set(static_cast<MeasurementField>(step.recordFields[v]), output.values[v]);
+      }
+    }
+    if (step.tolerance.valueIndex >= 0)
+    {
+      double value = output.values[step.tolerance.valueIndex];
+      if (value < step.tolerance.min || value > step.tolerance.max)
+      {
+        inTolerance = false;
+        LOG_INFO(QString("⚠️ 工具 '%1' 超出公差: %2 不在 [%3, %4]")
+            .arg(step.name).arg(value).arg(step.tolerance.min).arg(step.tolerance.max));
+      }
+    }
+  }
+
+  if (!inTolerance)
+  {
+    record.flags |= MeasurementRecord::OutOfTolerance;
+  }
+  return recordedAny && recordedAll;
+}
+
+void InspectionPlan::runStep(int index, const HObject& image, const HalconMeasure& helper, InspectionPlanState& state) const
+{
+  const RecipeStep& step = m_steps[index];
+  RecipeStepOutput& output = state.outputs[index];
+  output.ok = false;
+  PROFILE_STAGE(toolStage(step.type));
+
+  try
+  {
+    switch (step.type)
+    {
+    case RecipeToolType::Contour:
+    {
+      output.object = helper.QtGetLengthMaxXld(image, state.mappedRois[step.roi], step.threshold);
+      HTuple count, length;
+      CountObj(output.object, &count);
+      if (count.I() > 0)
+      {
+        LengthXld(output.object, &length);
+        output.values[0] = length[0].D();
+        output.ok = true;
+      }
+      break;
+    }
+    case RecipeToolType::Distance:
+    {
+      // 输入位于更早的层，此时已完成
+      const RecipeStepOutput& first = state.outputs[step.inputs[0]];
+      const RecipeStepOutput& second = state.outputs[step.inputs[1]];
+      if (first.ok && second.ok)
+      {
+        HTuple distanceMin, distanceMax;
+        DistanceCc(first.object, second.object, step.distanceMode.toStdString().c_str(), &distanceMin, &distanceMax);
+        output.values[0] = distanceMin.D();
+        output.values[1] = distanceMax.D();
+        output.ok = true;
+      }
+      break;
+    }
+    case RecipeToolType::Area:
+    {
+      HTuple area, row, column;
+      AreaCenter(state.mappedRois[step.roi], &area, &row, &column);
+      output.values[0] = area[0].D();
+      output.values[1] = row[0].D();
+      output.values[2] = column[0].D();
+      output.ok = true;
+      break;
+    }
+    case RecipeToolType::Edge:
+    {
+      vk::MeasureOptions options;
+      options.sigma = step.sigma;
+      options.threshold = step.threshold;
+      std::vector<vk::Edge> edges;
+      vk::Edge edge;
+      if (helper.measureEdges(image, state.mappedRois[step.roi], edges, options, stepDirection(step, state))
+          && vk::strongestEdge(edges, edge))
+      {
+        GenCrossContourXld(&output.object, edge.row, edge.column, 12.0, 0.785398);
+        output.values[0] = edge.amplitude;
+        output.values[1] = edge.row;
+        output.values[2] = edge.column;
+        output.ok = true;
+      }
+      break;
+    }
+    case RecipeToolType::Width:
+    {
+      vk::MeasureOptions options;
+      options.sigma = step.sigma;
+      options.threshold = step.threshold;
+      std::vector<vk::EdgePair> pairs;
+      if (helper.measureEdgePairs(image, state.mappedRois[step.roi], pairs, options, stepDirection(step, state))
+          && !pairs.empty())
+      {
+        const vk::EdgePair& pair = pairs.front();
+        GenContourPolygonXld(&output.object, HTuple(pair.first.row).Append(pair.second.row),
+                             HTuple(pair.first.column).Append(pair.second.column));
+        output.values[0] = pair.width;
+        output.values[1] = 0.5 * (pair.first.row + pair.second.row);
+        output.values[2] = 0.5 * (pair.first.column + pair.second.column);
+        output.ok = true;
+      }
+      break;
+    }
+    case RecipeToolType::PointDistance:
+    {
+      const RecipeStepOutput& first = state.outputs[step.inputs[0]];
+      const RecipeStepOutput& second = state.outputs[step.inputs[1]];
+      if (first.ok && second.ok)
+      {
+        output.values[0] = std::hypot(second.values[2] - first.values[2], second.values[1] - first.values[1]);
+        output.ok = true;
+      }
+      break;
+    }
+    }
+  }
+  catch (const HalconCpp::HException& e)
+  {
+    LOG_INFO(QString("❌ 工具 '%1' 执行失败：%2").arg(step.name).arg(QString(e.ErrorMessage())));
+    output.ok = false;
+  }
+}
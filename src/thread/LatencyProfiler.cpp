@@ -0,0 +1,247 @@
+/**
+ * @file LatencyProfiler.cpp
+ * @brief 检测流程分阶段耗时统计实现 | Per-stage latency histograms implementation
+ */
+
+#include "../inc/thread/LatencyProfiler.h"
+
+#include <QStringList>
+
+namespace
+{
+// 最高有效位序号，value 必须大于0
+int highestBit(std::uint64_t value)
+{
+  int bit = 0;
+  if (value >> 32) { value >>= 32; bit += 32; }
+  if (value >> 16) { value >>= 16; bit += 16; }
+  if (value >> 8) { value >>= 8; bit += 8; }
+  if (value >> 4) { value >>= 4; bit += 4; }
+  if (value >> 2) { value >>= 2; bit += 2; }
+  if (value >> 1) { bit += 1; }
+  return bit;
+}
+
+std::int64_t steadyNowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+/* ============================== LatencyHistogram ============================== */
+
+LatencyHistogram::LatencyHistogram()
+{
+  reset();
+}
+
+int LatencyHistogram::bucketIndex(std::uint64_t value)
+{
+  if (value < static_cast<std::uint64_t>(kSubBuckets))
+  {
+    return static_cast<int>(value);
+  }
+  int msb = highestBit(value);
+  int shift = msb - kSubBucketBits;
+  int sub = static_cast<int>((value >> shift) & (kSubBuckets - 1));
+  return (shift + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucketLowerBound(int index)
+{
+  if (index < kSubBuckets)
+  {
+    return static_cast<std::uint64_t>(index);
+  }
+  int shift = index / kSubBuckets - 1;
+  std::uint64_t sub = static_cast<std::uint64_t>(index % kSubBuckets);
+  return (static_cast<std::uint64_t>(kSubBuckets) + sub) << shift;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+  if (index < kSubBuckets)
+  {
+    return static_cast<std::uint64_t>(index);
+  }
+  int shift = index / kSubBuckets - 1;
+  return bucketLowerBound(index) + ((std::uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds)
+{
+  m_buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+  std::uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+  while (nanoseconds > currentMax
+         && !m_max.compare_exchange_weak(currentMax, nanoseconds, std::memory_order_relaxed))
+  {
+  }
+}
+
+void LatencyHistogram::reset()
+{
+  for (auto& bucket : m_buckets)
+  {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_count.store(0, std::memory_order_relaxed);
+  m_sum.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const
+{
+  LatencySnapshot result;
+
+  // 先复制桶计数，以复制结果的总数为准计算分位数
+  std::array<std::uint64_t, kBucketCount> counts;
+  std::uint64_t total = 0;
+  for (int i = 0; i < kBucketCount; ++i)
+  {
+    counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0)
+  {
+    return result;
+  }
+
+  std::uint64_t maxNs = m_max.load(std::memory_order_relaxed);
+  const double percentiles[] = {0.50, 0.95, 0.99};
+  double values[3] = {0.0, 0.0, 0.0};
+  int next = 0;
+  std::uint64_t seen = 0;
+  for (int i = 0; i < kBucketCount && next < 3; ++i)
+  {
+    seen += counts[i];
+    while (next < 3 && seen >= static_cast<std::uint64_t>(percentiles[next] * total + 0.5))
+    {
+      // 取桶中点，且不超过已记录的最大值
+      std::uint64_t mid = bucketLowerBound(i) + (bucketUpperBound(i) - bucketLowerBound(i)) / 2;
+      values[next] = static_cast<double>(mid < maxNs ? mid : maxNs);
+      ++next;
+    }
+  }
+
+  std::uint64_t count = m_count.load(std::memory_order_relaxed);
+  result.count = count;
+  result.meanUs = count > 0 ? m_sum.load(std::memory_order_relaxed) / 1e3 / count : 0.0;
+  result.p50Us = values[0] / 1e3;
+  result.p95Us = values[1] / 1e3;
+  result.p99Us = values[2] / 1e3;
+  result.maxUs = maxNs / 1e3;
+  return result;
+}
+
+/* ============================== LatencyProfiler ============================== */
+
+LatencyProfiler& LatencyProfiler::instance()
+{
+  static LatencyProfiler profiler;
+  return profiler;
+}
+
+void LatencyProfiler::setEnabled(bool enabled)
+{
+  if (enabled && !m_enabled.load())
+  {
+    m_lastReportNs.store(steadyNowNs());
+  }
+  m_enabled.store(enabled);
+}
+
+void LatencyProfiler::setReportInterval(int seconds)
+{
+  m_reportIntervalNs.store(seconds > 0 ? static_cast<std::int64_t>(seconds) * 1000 * 1000 * 1000 : 0);
+}
+
+void LatencyProfiler::record(InspectionStage stage, std::uint64_t nanoseconds)
+{
+  int index = static_cast<int>(stage);
+  if (index >= 0 && index < static_cast<int>(InspectionStage::Count))
+  {
+    m_histograms[index].record(nanoseconds);
+  }
+}
+
+LatencySnapshot LatencyProfiler::snapshot(InspectionStage stage) const
+{
+  int index = static_cast<int>(stage);
+  if (index < 0 || index >= static_cast<int>(InspectionStage::Count))
+  {
+    return LatencySnapshot();
+  }
+  return m_histograms[index].snapshot();
+}
+
+void LatencyProfiler::reset()
+{
+  for (auto& histogram : m_histograms)
+  {
+    histogram.reset();
+  }
+}
+
+bool LatencyProfiler::reportDue()
+{
+  std::int64_t interval = m_reportIntervalNs.load(std::memory_order_relaxed);
+  if (!isEnabled() || interval <= 0)
+  {
+    return false;
+  }
+
+  std::int64_t now = steadyNowNs();
+  std::int64_t last = m_lastReportNs.load(std::memory_order_relaxed);
+  if (now - last < interval)
+  {
+    return false;
+  }
+  return m_lastReportNs.compare_exchange_strong(last, now, std::memory_order_relaxed);
+}
+
+QString LatencyProfiler::summary() const
+{
+  QStringList lines;
+  for (int i = 0; i < static_cast<int>(InspectionStage::Count); ++i)
+  {
+    LatencySnapshot item = m_histograms[i].snapshot();
+    if (item.count == 0)
+    {
+      continue;
+    }
+    lines << QString("%1: 次数=%2, 平均=%3 ms, p50=%4 ms, p95=%5 ms, p99=%6 ms, 最大=%7 ms")
+             .arg(stageName(static_cast<InspectionStage>(i)))
+             .arg(item.count)
+             .arg(item.meanUs / 1e3, 0, 'f', 3)
+             .arg(item.p50Us / 1e3, 0, 'f', 3)
+             .arg(item.p95Us / 1e3, 0, 'f', 3)
+             .arg(item.p99Us / 1e3, 0, 'f', 3)
+             .arg(item.maxUs / 1e3, 0, 'f', 3);
+  }
+  return lines.isEmpty() ? QString("无耗时样本") : lines.join("\n");
+}
+
+const char* LatencyProfiler::stageName(InspectionStage stage)
+{
+  switch (stage)
+  {
+  case InspectionStage::Preprocess: return "预处理";
+  case InspectionStage::FindShapeWindow: return "窗口匹配";
+  case InspectionStage::FindShapeFast: return "快速匹配";
+  case InspectionStage::FindShapePrecise: return "精确匹配";
+  case InspectionStage::RigidTransform: return "位姿变换";
+  case InspectionStage::RecipeExecute: return "配方执行";
+  case InspectionStage::ContourExtract: return "轮廓提取";
+  case InspectionStage::DistanceMeasure: return "距离测量";
+  case InspectionStage::AreaMeasure: return "面积测量";
+  case InspectionStage::PointDistance: return "点距测量";
+  case InspectionStage::EdgeMeasure: return "边缘测量";
+  case InspectionStage::WidthMeasure: return "宽度测量";
+  case InspectionStage::Total: return "单帧总计";
+  default: return "未知";
+  }
+}
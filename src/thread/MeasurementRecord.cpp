@@ -0,0 +1,129 @@
+/**
+ * @file MeasurementRecord.cpp
+ * @brief 测量结果记录实现 | Measurement record implementation
+ */
+
+#include "../inc/thread/MeasurementRecord.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+
+QString measurementFieldName(MeasurementField field)
+{
+  switch (field)
+  {
+  case MeasurementField::MinDistance: return QStringLiteral("最小距离");
+  case MeasurementField::MaxDistance: return QStringLiteral("最大距离");
+  case MeasurementField::CentroidDistance: return QStringLiteral("重心距离");
+  case MeasurementField::Area1: return QStringLiteral("区域1面积");
+  case MeasurementField::Area2: return QStringLiteral("区域2面积");
+  case MeasurementField::Centroid1X: return QStringLiteral("重心1_X");
+  case MeasurementField::Centroid1Y: return QStringLiteral("重心1_Y");
+  case MeasurementField::Centroid2X: return QStringLiteral("重心2_X");
+  case MeasurementField::Centroid2Y: return QStringLiteral("重心2_Y");
+  case MeasurementField::MatchScore: return QStringLiteral("模板匹配得分");
+  case MeasurementField::MatchRow: return QStringLiteral("模板位置_Row");
+  case MeasurementField::MatchColumn: return QStringLiteral("模板位置_Col");
+  case MeasurementField::MatchAngle: return QStringLiteral("模板角度");
+  default: return QStringLiteral("未知");
+  }
+}
+
+QVariantMap measurementToVariantMap(const MeasurementRecord& record, bool measuredOnly)
+{
+  QVariantMap map;
+  const int count = static_cast<int>(MeasurementField::Count);
+  for (int i = 0; i < count; ++i)
+  {
+    MeasurementField field = static_cast<MeasurementField>(i);
+    bool matchField = field >= MeasurementField::MatchScore;
+    if (measuredOnly && !record.isMeasured() && !matchField)
+    {
+      continue;
+    }
+    map.insert(measurementFieldName(field), record.values[i]);
+  }
+  return map;
+}
+
+QString measurementMessage(const MeasurementRecord& record)
+{
+  if (!record.isMeasured())
+  {
+    return QString();
+  }
+  return QString("🎯 映射区域测量结果:\n最小距离: %1px\n最大距离: %2px\n重心距离: %3px\n区域1面积: %4px²\n区域2面积: %5px²\n模板匹配得分: %6")
+         .arg(QString::number(record.value(MeasurementField::MinDistance), 'f', 2))
+         .arg(QString::number(record.value(MeasurementField::MaxDistance), 'f', 2))
+         .arg(QString::number(record.value(MeasurementField::CentroidDistance), 'f', 2))
+         .arg(QString::number(record.value(MeasurementField::Area1), 'f', 1))
+         .arg(QString::number(record.value(MeasurementField::Area2), 'f', 1))
+         .arg(QString::number(record.value(MeasurementField::MatchScore), 'f', 3))
+         + (record.isInTolerance() ? QString() : QString("\n判定: NG（超出配方公差）"));
+}
+
+/* ============================== MeasurementRing ============================== */
+
+MeasurementRing::MeasurementRing(int capacity) :
+  m_records(static_cast<size_t>(qMax(1, capacity)))
+{
+}
+
+void MeasurementRing::push(const MeasurementRecord& record)
+{
+  QMutexLocker locker(&m_mutex);
+  m_records[static_cast<size_t>(m_pushed % m_records.size())] = record;
+  ++m_pushed;
+  m_size = qMin(m_size + 1, static_cast<int>(m_records.size()));
+}
+
+bool MeasurementRing::latest(MeasurementRecord& record) const
+{
+  QMutexLocker locker(&m_mutex);
+  if (m_size == 0)
+  {
+    return false;
+  }
+  record = m_records[static_cast<size_t>((m_pushed - 1) % m_records.size())];
+  return true;
+}
+
+int MeasurementRing::copyRecent(MeasurementRecord* out, int maxCount) const
+{
+  QMutexLocker locker(&m_mutex);
+  int count = std::min(m_size, maxCount);
+  if (count <= 0)
+  {
+    return 0;
+  }
+  quint64 first = m_pushed - static_cast<quint64>(count);
+  for (int i = 0; i < count; ++i)
+  {
+    out[i] = m_records[static_cast<size_t>((first + i) % m_records.size())];
+  }
+  return count;
+}
+
+void MeasurementRing::clear()
+{
+  QMutexLocker locker(&m_mutex);
+  m_size = 0;
+}
+
+int MeasurementRing::capacity() const
+{
+  return static_cast<int>(m_records.size());
+}
+
+int MeasurementRing::size() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_size;
+}
+
+quint64 MeasurementRing::totalPushed() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_pushed;
+}
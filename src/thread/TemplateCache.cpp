@@ -0,0 +1,734 @@
+/**
+ * @file TemplateCache.cpp
+ * @brief 模板/测量区域常驻缓存实现 | Resident template and ROI cache implementation
+ */
+
+#include "../inc/thread/TemplateCache.h"
+#include "../thirdparty/log_manager/inc/simplecategorylogger.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <functional>
+
+#define SYSTEM "VisualWorkThread"
+
+// 日志重定义
+#ifdef _DEBUG // 调试模式
+#define LOG_INFO(message) SIMPLE_DEBUG_LOG_INFO(SYSTEM, message)
+#define LOG_WARNING(message) SIMPLE_DEBUG_LOG_WARNING(SYSTEM, message)
+#define LOG_ERROR(message) SIMPLE_DEBUG_LOG_ERROR(SYSTEM, message)
+#else // 发布模式
+#define LOG_INFO(message) SIMPLE_LOG_INFO_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_WARNING(message) SIMPLE_LOG_WARNING_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#define LOG_ERROR(message) SIMPLE_LOG_ERROR_CONFIG(SYSTEM, message, SHOW_IN_CONSOLE, WRITE_TO_FILE)
+#endif
+
+namespace
+{
+  const char* kMeasureRect1File = "m_Measyre_Rect1.hobj";
+  const char* kMeasureRect2File = "m_Measyre_Rect2.hobj";
+  const int kDefaultReloadDelayMs = 500; // 模板文件通常分多次写入，等待写完再加载
+
+  // 参数目录中预加载的文件类型
+  const QStringList kAuxiliaryFilters = {"*.hobj", "*.tup", "*.dcm"};
+
+  // 模板加载线程池：与检测使用的全局线程池分开，加载期间不占用检测线程
+  QThreadPool* templateLoadPool()
+  {
+    static QThreadPool* pool = []()
+    {
+      QThreadPool* created = new QThreadPool();
+      created->setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+      created->setExpiryTimeout(30000);
+      return created;
+    }();
+    return pool;
+  }
+
+  // 一个待加载的文件
+  struct LoadTask
+  {
+    QString path;
+    QString kind;
+    std::function<void()> run;  // 失败时抛出 HException
+  };
+
+  // 参数目录中单个文件的加载结果（每个任务写入自己的槽位，无需加锁）
+  struct AuxiliaryResult
+  {
+    HObject object;
+    HTuple tuple;
+    HTuple dataCodeModel;
+    bool hasObject = false;
+    bool hasTuple = false;
+    bool hasDataCodeModel = false;
+  };
+
+  // 参数目录去重（测量目录可能与其他目录相同）
+  QStringList auxiliaryDirectories(const TemplatePaths& paths)
+  {
+    QStringList dirs;
+    for (const QString& dir : {paths.measureDir, paths.qrCodeDir, paths.checkDir})
+    {
+      QString cleaned = QDir::cleanPath(dir);
+      if (!dir.isEmpty() && QDir(cleaned).exists() && !dirs.contains(cleaned))
+      {
+        dirs << cleaned;
+      }
+    }
+    return dirs;
+  }
+}
+
+QString TemplateLoadReport::summary(int slowest) const
+{
+  int failed = 0;
+  for (const TemplateAssetTiming& asset : assets)
+  {
+    if (!asset.ok)
+    {
+      ++failed;
+    }
+  }
+
+  QString text = QString("%1: 版本=%2, 文件=%3 (失败%4), 线程=%5, 总耗时=%6 ms, 累计=%7 ms, 加速比=%8x")
+                 .arg(ok ? "模板集加载成功" : "模板集加载失败")
+                 .arg(generation).arg(assets.size()).arg(failed).arg(threads)
+                 .arg(wallMs, 0, 'f', 1).arg(sumMs, 0, 'f', 1)
+                 .arg(wallMs > 0.0 ? sumMs / wallMs : 0.0, 0, 'f', 2);
+  if (!ok && !error.isEmpty())
+  {
+    text += QString(", 原因: %1").arg(error);
+  }
+  for (int i = 0; i < assets.size() && i < slowest; ++i)
+  {
+    const TemplateAssetTiming& asset = assets[i];
+    text += QString("\n  %1 %2 [%3] %4 ms%5")
+            .arg(asset.ok ? "✅" : "❌")
+            .arg(QFileInfo(asset.path).fileName())
+            .arg(asset.kind)
+            .arg(asset.loadMs, 0, 'f', 1)
+            .arg(asset.ok ? QString() : QString(" (%1)").arg(asset.error));
+  }
+  return text;
+}
+
+TemplateCache::TemplateCache(QObject* parent) :
+  QObject(parent)
+{
+  // 监视器和防抖定时器放在独立线程中：检测线程在批处理期间不返回事件循环，
+  // 若与其共用线程，文件变化通知要等到批处理结束才会处理
+  m_watchThread = new QThread();
+  m_watchThread->setObjectName("TemplateCacheWatch");
+
+  m_watcher = new QFileSystemWatcher();
+  m_reloadTimer = new QTimer();
+  m_reloadTimer->setSingleShot(true);
+  m_reloadTimer->setInterval(kDefaultReloadDelayMs);
+  m_watcher->moveToThread(m_watchThread);
+  m_reloadTimer->moveToThread(m_watchThread);
+
+  // 以监视器/定时器为上下文对象，槽函数在监视线程中执行，而不是本对象所在线程
+  connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_watcher, [this](const QString& path) { onWatchedPathChanged(path); });
+  connect(m_watcher, &QFileSystemWatcher::fileChanged, m_watcher, [this](const QString& path) { onWatchedPathChanged(path); });
+  connect(m_reloadTimer, &QTimer::timeout, m_reloadTimer, [this]() { onReloadTimeout(); });
+  m_watchThread->start();
+}
+
+TemplateCache::~TemplateCache()
+{
+  m_watchThread->quit();
+  m_watchThread->wait();
+  // 线程已结束，可在此直接释放其中的对象
+  delete m_reloadTimer;
+  delete m_watcher;
+  delete m_watchThread;
+}
+
+void TemplateCache::setPaths(const QString& modelDir, const QString& measureDir)
+{
+  TemplatePaths newPaths = paths();
+  newPaths.modelDir = modelDir;
+  newPaths.measureDir = measureDir;
+  setPaths(newPaths);
+}
+
+void TemplateCache::setPaths(const TemplatePaths& paths)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    m_paths = paths;
+  }
+  invalidate();
+  updateWatchList();
+}
+
+TemplatePaths TemplateCache::paths() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_paths;
+}
+
+void TemplateCache::setLoadThreads(int threads)
+{
+  m_loadThreads = qMax(0, threads);
+}
+
+TemplateSetPtr TemplateCache::acquire()
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_current && m_current->isValid())
+    {
+      ++m_hits;
+      return m_current;
+    }
+  }
+
+  // 首次使用或上次加载失败时同步加载；预加载正在进行时等待其完成，不重复加载
+  ++m_misses;
+  {
+    QMutexLocker loadLocker(&m_loadMutex);
+    TemplateSetPtr loaded = current();
+    if (!loaded || !loaded->isValid())
+    {
+      loadAndSwapLocked(paths(), false);
+    }
+  }
+  return current();
+}
+
+TemplateSetPtr TemplateCache::current() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_current;
+}
+
+bool TemplateCache::reload()
+{
+  QMutexLocker loadLocker(&m_loadMutex);
+  return loadAndSwapLocked(paths(), false).ok;
+}
+
+TemplateLoadReport TemplateCache::preload()
+{
+  TemplateLoadReport report;
+  {
+    QMutexLocker loadLocker(&m_loadMutex);
+    report = loadAndSwapLocked(paths(), false);
+  }
+  QString summary = report.summary();
+  if (report.ok)
+  {
+    LOG_INFO(QString("🚀 模板预加载完成\n%1").arg(summary));
+  }
+  else
+  {
+    LOG_ERROR(QString("❌ 模板预加载失败\n%1").arg(summary));
+  }
+  emit templatesReady(report.ok, m_generation.load(), summary);
+  return report;
+}
+
+TemplateLoadReport TemplateCache::switchRecipe(const TemplatePaths& paths)
+{
+  LOG_INFO(QString("🔀 切换配方: 模板=%1, 测量=%2, 二维码=%3, 检测=%4")
+      .arg(paths.modelDir, paths.measureDir, paths.qrCodeDir, paths.checkDir));
+
+  TemplateLoadReport report;
+  {
+    QMutexLocker loadLocker(&m_loadMutex);
+    report = loadAndSwapLocked(paths, true);
+  }
+  QString summary = report.summary();
+  if (report.ok)
+  {
+    LOG_INFO(QString("🔀 配方切换完成\n%1").arg(summary));
+  }
+  else
+  {
+    LOG_ERROR(QString("❌ 配方切换失败，继续使用原配方\n%1").arg(summary));
+  }
+  emit templatesReady(report.ok, m_generation.load(), summary);
+  return report;
+}
+
+bool TemplateCache::isReady() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_current && m_current->isValid();
+}
+
+TemplateLoadReport TemplateCache::lastLoadReport() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_lastReport;
+}
+
+TemplateLoadReport TemplateCache::loadAndSwapLocked(const TemplatePaths& paths, bool switchPaths)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  TemplateLoadReport report;
+  std::shared_ptr<TemplateSet> loaded = loadTemplateSet(paths, report);
+  double loadMs = timer.nsecsElapsed() / 1e6;
+  report.wallMs = loadMs;
+
+  if (!loaded)
+  {
+    ++m_failedReloads;
+    LOG_ERROR(QString("❌ 模板加载失败(%1 ms): %2").arg(loadMs, 0, 'f', 2).arg(report.error));
+    {
+      QMutexLocker locker(&m_mutex);
+      m_lastReport = report;
+    }
+    emit reloadFailed(report.error);
+    return report;
+  }
+
+  loaded->generation = ++m_generation;
+  loaded->loadTime = QDateTime::currentDateTime();
+  report.generation = loaded->generation;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    m_current = loaded; // 原子替换，旧模板集由最后一个持有者释放
+    if (switchPaths)
+    {
+      m_paths = paths; // 配方切换：目录与模板集同时替换
+    }
+    m_lastLoadMs = loadMs;
+    m_totalLoadMs += loadMs;
+    m_lastReport = report;
+  }
+  ++m_reloads;
+
+  LOG_INFO(QString("✅ 模板集已加载: 版本=%1, 模板=%2, 区域=%3, 参数=%4, 二维码模型=%5, 耗时=%6 ms")
+      .arg(loaded->generation)
+      .arg(QFileInfo(loaded->modelFile).fileName())
+      .arg(loaded->regions.size()).arg(loaded->params.size()).arg(loaded->dataCodeModels.size())
+      .arg(loadMs, 0, 'f', 2));
+
+  updateWatchList();
+  emit templatesReloaded(loaded->generation, loadMs);
+  return report;
+}
+
+void TemplateCache::invalidate()
+{
+  QMutexLocker locker(&m_mutex);
+  m_current.reset();
+}
+
+void TemplateCache::setWatchEnabled(bool enabled)
+{
+  m_watchEnabled = enabled;
+  updateWatchList();
+}
+
+void TemplateCache::setReloadDelay(int milliseconds)
+{
+  const int delay = qMax(0, milliseconds);
+  runOnWatchThread([this, delay]() { m_reloadTimer->setInterval(delay); });
+}
+
+void TemplateCache::runOnWatchThread(std::function<void()> task)
+{
+  if (QThread::currentThread() == m_watchThread)
+  {
+    task();
+  }
+  else
+  {
+    QMetaObject::invokeMethod(m_watcher, std::move(task), Qt::QueuedConnection);
+  }
+}
+
+TemplateCacheStats TemplateCache::stats() const
+{
+  TemplateCacheStats result;
+  result.hits = m_hits.load();
+  result.misses = m_misses.load();
+  result.reloads = m_reloads.load();
+  result.failedReloads = m_failedReloads.load();
+  result.generation = m_generation.load();
+
+  QMutexLocker locker(&m_mutex);
+  result.lastLoadMs = m_lastLoadMs;
+  result.totalLoadMs = m_totalLoadMs;
+  return result;
+}
+
+QString TemplateCache::findLatestFile(const QString& dirPath, const QStringList& nameFilters)
+{
+  QDir dir(dirPath);
+  if (!dir.exists())
+  {
+    return QString();
+  }
+
+  // QDir::Time 按修改时间降序排列，第一个即为最新文件
+  QFileInfoList files = dir.entryInfoList(nameFilters, QDir::Files, QDir::Time);
+  return files.isEmpty() ? QString() : files.first().absoluteFilePath();
+}
+
+void TemplateCache::onWatchedPathChanged(const QString& path)
+{
+  LOG_INFO(QString("🔄 检测到模板文件变化: %1").arg(path));
+  // 防抖：同一次保存会触发多次通知
+  m_reloadTimer->start();
+}
+
+void TemplateCache::onReloadTimeout()
+{
+  TemplateSetPtr old = current();
+  TemplatePaths currentPaths = paths();
+  QString latestModel = findLatestFile(currentPaths.modelDir, QStringList() << "*.shm");
+
+  // 只有文件确实更新时才重新加载，目录中其他文件的变化直接忽略
+  bool changed = !old || latestModel != old->modelFile;
+  if (old && !changed)
+  {
+    QStringList watched;
+    watched << old->modelFile << old->poseFile << currentPaths.recipeFile
+        << QDir(currentPaths.measureDir).filePath(kMeasureRect1File)
+        << QDir(currentPaths.measureDir).filePath(kMeasureRect2File);
+    for (const QString& file : watched)
+    {
+      if (!file.isEmpty() && QFileInfo(file).lastModified() > old->loadTime)
+      {
+        changed = true;
+        break;
+      }
+    }
+  }
+  if (old && !changed)
+  {
+    // 参数目录：文件数量变化（新增/删除）或有文件比模板集新
+    int auxiliaryCount = 0;
+    for (const QString& dir : auxiliaryDirectories(currentPaths))
+    {
+      for (const QFileInfo& info : QDir(dir).entryInfoList(kAuxiliaryFilters, QDir::Files))
+      {
+        ++auxiliaryCount;
+        if (info.lastModified() > old->loadTime)
+        {
+          changed = true;
+        }
+      }
+    }
+    int loadedCount = old->regions.size() + old->params.size();
+    for (auto it = old->dataCodeModels.constBegin(); it != old->dataCodeModels.constEnd(); ++it)
+    {
+      if (it.key().endsWith(".dcm", Qt::CaseInsensitive))
+      {
+        ++loadedCount; // 由 *_qr_params.tup 生成的模型已计入参数
+      }
+    }
+    loadedCount += (old->hasMeasureRegions() ? 2 : 0);
+    changed = changed || auxiliaryCount != loadedCount;
+  }
+
+  if (changed)
+  {
+    reload();
+  }
+  else
+  {
+    updateWatchList(); // 部分编辑器以替换方式保存，文件会从监视列表中移除
+  }
+}
+
+/**
+ * 先列出全部文件，再在加载线程池中并行读取；形状模板排在最前（通常最慢）。
+ * 形状模板失败时整个模板集无效，其他文件失败只记录在报告中。
+ */
+std::shared_ptr<TemplateSet> TemplateCache::loadTemplateSet(const TemplatePaths& paths, TemplateLoadReport& report) const
+{
+  auto set = std::make_shared<TemplateSet>();
+  set->paths = paths;
+
+  // 1. 形状模板：取最新的 .shm 文件
+  set->modelFile = findLatestFile(paths.modelDir, QStringList() << "*.shm");
+  if (set->modelFile.isEmpty())
+  {
+    report.error = QString("模板目录中未找到 .shm 文件: %1").arg(paths.modelDir);
+    return nullptr;
+  }
+
+  // 2. 模板位姿：文件名以 data 结尾的 .tup 文件
+  set->row = 0;
+  set->column = 0;
+  set->angle = 0;
+  QDir modelDir(paths.modelDir);
+  QFileInfoList tupFiles = modelDir.entryInfoList(QStringList() << "*.tup", QDir::Files, QDir::Time);
+  for (const QFileInfo& info : tupFiles)
+  {
+    if (info.baseName().endsWith("data", Qt::CaseInsensitive))
+    {
+      set->poseFile = info.absoluteFilePath();
+      break;
+    }
+  }
+  if (set->poseFile.isEmpty())
+  {
+    LOG_WARNING("未找到文件名以'data'结尾的.tup文件，使用默认参数");
+  }
+
+  QVector<LoadTask> tasks;
+  tasks.append({set->modelFile, "shape_model", [set]()
+  {
+    ReadShapeModel(set->modelFile.toStdString().c_str(), &set->modelId);
+  }});
+  if (!set->poseFile.isEmpty())
+  {
+    tasks.append({set->poseFile, "pose", [set]()
+    {
+      HTuple dataTuple;
+      ReadTuple(set->poseFile.toStdString().c_str(), &dataTuple);
+      if (dataTuple.Length() < 3)
+      {
+        throw HalconCpp::HException(QString("模板参数文件数据不足: 期望>=3，实际=%1")
+                                    .arg(dataTuple.Length()).toStdString().c_str());
+      }
+      set->row = dataTuple[0];
+      set->column = dataTuple[1];
+      set->angle = dataTuple[2];
+    }});
+  }
+
+  // 3. 测量区域：缺失时模板仍可用于匹配，由使用者决定是否测量
+  QDir measureDir(paths.measureDir);
+  QString rect1Path = QDir::cleanPath(measureDir.filePath(kMeasureRect1File));
+  QString rect2Path = QDir::cleanPath(measureDir.filePath(kMeasureRect2File));
+  tasks.append({rect1Path, "measure_region", [set, rect1Path]()
+  {
+    ReadRegion(&set->measureRect1, rect1Path.toStdString().c_str());
+  }});
+  tasks.append({rect2Path, "measure_region", [set, rect2Path]()
+  {
+    ReadRegion(&set->measureRect2, rect2Path.toStdString().c_str());
+  }});
+
+  // 4. 参数目录（测量/二维码/检测）中的区域、参数和二维码模型
+  const int firstAuxiliary = tasks.size();
+  for (const QString& dir : auxiliaryDirectories(paths))
+  {
+    for (const QFileInfo& info : QDir(dir).entryInfoList(kAuxiliaryFilters, QDir::Files, QDir::Name))
+    {
+      QString path = info.absoluteFilePath();
+      if (QDir::cleanPath(path) == rect1Path || QDir::cleanPath(path) == rect2Path)
+      {
+        continue;
+      }
+      QString suffix = info.suffix().toLower();
+      tasks.append({path, suffix == "hobj" ? "region" : (suffix == "dcm" ? "data_code" : "tuple"), nullptr});
+    }
+  }
+  QVector<AuxiliaryResult> auxiliary(tasks.size() - firstAuxiliary);
+  for (int i = firstAuxiliary; i < tasks.size(); ++i)
+  {
+    AuxiliaryResult* slot = &auxiliary[i - firstAuxiliary];
+    const QString path = tasks[i].path;
+    const QString kind = tasks[i].kind;
+    tasks[i].run = [slot, path, kind]()
+    {
+      if (kind == "region")
+      {
+        ReadObject(&slot->object, path.toStdString().c_str());
+        slot->hasObject = true;
+      }
+      else if (kind == "data_code")
+      {
+        ReadDataCode2dModel(path.toStdString().c_str(), &slot->dataCodeModel);
+        slot->hasDataCodeModel = true;
+      }
+      else
+      {
+        ReadTuple(path.toStdString().c_str(), &slot->tuple);
+        slot->hasTuple = true;
+        // 二维码参数（类型、极性）：预先创建二维码模型，首帧无需再创建
+        if (QFileInfo(path).completeBaseName().endsWith("_qr_params", Qt::CaseInsensitive) && slot->tuple.Length() >= 2)
+        {
+          CreateDataCode2dModel(slot->tuple[0], "polarity", slot->tuple[1], &slot->dataCodeModel);
+          slot->hasDataCodeModel = true;
+        }
+      }
+    };
+  }
+
+  // 并行加载：调用线程也参与，各任务只写入自己的结果
+  QVector<TemplateAssetTiming> timings(tasks.size());
+  TemplateAssetTiming* timingSlots = timings.data();
+  const QVector<LoadTask>& taskList = tasks;
+  std::atomic<int> next{0};
+  auto worker = [&taskList, timingSlots, &next]()
+  {
+    for (int i = next++; i < taskList.size(); i = next++)
+    {
+      TemplateAssetTiming& timing = timingSlots[i];
+      timing.path = taskList[i].path;
+      timing.kind = taskList[i].kind;
+      QElapsedTimer taskTimer;
+      taskTimer.start();
+      try
+      {
+        taskList[i].run();
+        timing.ok = true;
+      }
+      catch (const HalconCpp::HException& e)
+      {
+        timing.error = QString(e.ErrorMessage());
+      }
+      timing.loadMs = taskTimer.nsecsElapsed() / 1e6;
+    }
+  };
+
+  QThreadPool* pool = templateLoadPool();
+  int threads = m_loadThreads > 0 ? m_loadThreads : pool->maxThreadCount();
+  threads = qBound(1, threads, tasks.size());
+  QList<QFuture<void>> workers;
+  for (int i = 1; i < threads; ++i)
+  {
+    workers.append(QtConcurrent::run(pool, worker));
+  }
+  worker();
+  for (QFuture<void>& future : workers)
+  {
+    future.waitForFinished();
+  }
+
+  report.threads = threads;
+  for (const TemplateAssetTiming& timing : timings)
+  {
+    report.sumMs += timing.loadMs;
+  }
+  report.assets = timings;
+  std::sort(report.assets.begin(), report.assets.end(),
+            [](const TemplateAssetTiming& a, const TemplateAssetTiming& b) { return a.loadMs > b.loadMs; });
+
+  if (!timings[0].ok)
+  {
+    report.error = QString("读取模板文件 %1 失败: %2").arg(QFileInfo(set->modelFile).fileName()).arg(timings[0].error);
+    return nullptr;
+  }
+  report.ok = true;
+
+  for (const TemplateAssetTiming& timing : timings)
+  {
+    if (!timing.ok && timing.kind == "pose")
+    {
+      LOG_ERROR(QString("读取data文件 %1 失败: %2").arg(QFileInfo(timing.path).fileName()).arg(timing.error));
+    }
+  }
+  if (!set->measureRect1.IsInitialized() || !set->measureRect2.IsInitialized())
+  {
+    set->measureRect1.Clear();
+    set->measureRect2.Clear();
+    LOG_WARNING(QString("读取测量区域文件失败: %1").arg(paths.measureDir));
+  }
+
+  for (int i = firstAuxiliary; i < tasks.size(); ++i)
+  {
+    const AuxiliaryResult& slot = auxiliary[i - firstAuxiliary];
+    const QString& path = tasks[i].path;
+    if (slot.hasObject)
+    {
+      set->regions.insert(path, slot.object);
+    }
+    if (slot.hasTuple)
+    {
+      set->params.insert(path, slot.tuple);
+    }
+    if (slot.hasDataCodeModel)
+    {
+      set->dataCodeModels.insert(path, slot.dataCodeModel);
+    }
+    if (!timings[i].ok)
+    {
+      LOG_WARNING(QString("预加载 %1 失败: %2").arg(QFileInfo(path).fileName()).arg(timings[i].error));
+    }
+  }
+
+  // 5. 检测配方：区域已全部加载，编译为执行计划供每帧复用
+  QString recipeError;
+  QJsonObject recipe = InspectionPlan::loadRecipe(paths.recipeFile, recipeError);
+  if (!recipe.isEmpty())
+  {
+    QString baseDir = paths.recipeFile.isEmpty() ? paths.measureDir : QFileInfo(paths.recipeFile).absolutePath();
+    set->plan = InspectionPlan::compile(recipe, *set, baseDir, recipeError);
+  }
+  if (set->plan)
+  {
+    LOG_INFO(QString("🧩 %1").arg(set->plan->summary()));
+  }
+  else
+  {
+    LOG_WARNING(QString("检测配方编译失败，只进行模板匹配: %1").arg(recipeError));
+  }
+  return set;
+}
+
+void TemplateCache::updateWatchList()
+{
+  // 文件监视器只能在所属线程中操作，其他线程的调用转交给监视线程
+  if (QThread::currentThread() != m_watchThread)
+  {
+    runOnWatchThread([this]() { updateWatchList(); });
+    return;
+  }
+
+  QStringList oldPaths = m_watcher->files() + m_watcher->directories();
+  if (!oldPaths.isEmpty())
+  {
+    m_watcher->removePaths(oldPaths);
+  }
+
+  if (!m_watchEnabled)
+  {
+    return;
+  }
+
+  TemplatePaths currentPaths = paths();
+  QStringList paths;
+  QString recipeDir = currentPaths.recipeFile.isEmpty() ? QString() : QFileInfo(currentPaths.recipeFile).absolutePath();
+  for (const QString& dir : {currentPaths.modelDir, currentPaths.measureDir, currentPaths.qrCodeDir, currentPaths.checkDir, recipeDir})
+  {
+    if (!dir.isEmpty() && QDir(dir).exists() && !paths.contains(dir))
+    {
+      paths << dir;
+    }
+  }
+
+  TemplateSetPtr set = current();
+  if (set)
+  {
+    QStringList files;
+    files << set->modelFile << set->poseFile << currentPaths.recipeFile
+        << QDir(currentPaths.measureDir).filePath(kMeasureRect1File)
+        << QDir(currentPaths.measureDir).filePath(kMeasureRect2File);
+    for (const QString& file : files)
+    {
+      if (!file.isEmpty() && QFileInfo::exists(file))
+      {
+        paths << file;
+      }
+    }
+  }
+
+  if (!paths.isEmpty())
+  {
+    m_watcher->addPaths(paths);
+  }
+}
@@ -5,6 +5,11 @@
 #include "../inc/thread/visualWorkThread.h"
 #include "../thirdparty/log_manager/inc/simplecategorylogger.h"
 #include "../thirdparty/hdevelop/include/HalconLable.h"
+#include "../inc/thread/InspectionPool.h"
+#include "../inc/thread/InspectionPipeline.h"
+#include "../inc/thread/FrameChannel.h"
+#include "../inc/thread/ImageWriterService.h"
+#include "../inc/thread/LatencyProfiler.h"
 
 #include <QDebug>
 #include <QApplication>
@@ -15,6 +20,7 @@
 #include <QThread>
 #include <QMetaType>  // 添加 QMetaType 头文件
 #include <QMap>       // 添加 QMap 头文件用于文件分组
+#include <QtConcurrent/QtConcurrentRun>
 
 #define SYSTEM "VisualWorkThread"
 
@@ -60,7 +66,13 @@ visualWorkThread::visualWorkThread(QObject* parent) :
 
   initLog();
   initHalcon();
+  m_templateCache = new TemplateCache(this);
+  m_frameChannel = new FrameChannel(this);
+  m_imageWriter = new ImageWriterService();
   initPath();
+
+  // 只连接一次，避免每张图像重复建立连接导致同一帧被处理多次
+  connect(this, &visualWorkThread::imageFinished, this, &visualWorkThread::onProcessImage);
 }
 
 /**
@@ -68,6 +80,18 @@ visualWorkThread::visualWorkThread(QObject* parent) :
  */
 visualWorkThread::~visualWorkThread()
 {
+  QFuture<void> templateTask;
+  {
+    QMutexLocker locker(&m_mutex);
+    templateTask = m_templateTask;
+  }
+  templateTask.waitForFinished(); // 后台模板加载使用模板缓存，须先结束
+  if (m_inspectionPool != nullptr)
+  {
+    m_inspectionPool->stop(); // 先停止检测线程，再释放辅助对象
+  }
+  delete m_imageWriter; // 写完队列中的图像后退出
+  m_imageWriter = nullptr;
   if (workThreadHalcon != nullptr)
   {
     delete workThreadHalcon; // 清理Halcon对象
@@ -109,9 +133,224 @@ bool visualWorkThread::isRunning()
  * @param running 运行状态
  */
 void visualWorkThread::setRunning(bool running)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    m_running = running;
+  }
+  if (!running)
+  {
+    m_frameChannel->close(); // 唤醒因 Block 策略等待界面的发布线程
+    stopHotFolder();         // 唤醒等待新文件的解码线程
+  }
+}
+
+/**
+ * @brief 获取模板常驻缓存
+ * @return 模板缓存对象指针
+ */
+TemplateCache* visualWorkThread::templateCache() const
+{
+  return m_templateCache;
+}
+
+/**
+ * @brief 在后台并行预加载模板
+ */
+void visualWorkThread::preloadTemplates()
+{
+  runTemplateTask([this]()
+  {
+    TemplateLoadReport report = m_templateCache->preload();
+    emit templatesReady(report.ok, report.summary());
+  });
+}
+
+/**
+ * @brief 在后台切换配方
+ * @param recipeDir 配方目录
+ */
+void visualWorkThread::switchRecipe(const QString& recipeDir)
+{
+  TemplatePaths paths = recipePaths(recipeDir);
+  runTemplateTask([this, paths]()
+  {
+    // 模板集（含其目录）原子替换；路径成员由处理线程在取用新模板集时同步，不单独排队更新
+    TemplateLoadReport report = m_templateCache->switchRecipe(paths);
+    emit templatesReady(report.ok, report.summary());
+  });
+}
+
+/**
+ * @brief 模板是否已加载完成
+ */
+bool visualWorkThread::isTemplateReady() const
+{
+  return m_templateCache->isReady();
+}
+
+// 前一个加载任务完成后再执行，保证预加载与配方切换按调用顺序生效
+void visualWorkThread::runTemplateTask(std::function<void()> task)
 {
   QMutexLocker locker(&m_mutex);
-  m_running = running;
+  QFuture<void> previous = m_templateTask;
+  m_templateTask = QtConcurrent::run([previous, task]() mutable
+  {
+    previous.waitForFinished();
+    task();
+  });
+}
+
+/**
+ * @brief 获取显示帧通道
+ * @return 帧通道对象指针
+ */
+FrameChannel* visualWorkThread::frameChannel() const
+{
+  return m_frameChannel;
+}
+
+/**
+ * @brief 获取后台图像保存服务
+ * @return 图像保存服务指针
+ */
+ImageWriterService* visualWorkThread::imageWriter() const
+{
+  return m_imageWriter;
+}
+
+/**
+ * @brief 设置并行检测线程数量
+ * @param count 检测线程数量
+ */
+void visualWorkThread::setInspectionWorkerCount(int count)
+{
+  if (m_inspectionPool != nullptr)
+  {
+    LOG_WARNING("检测线程池已创建，忽略重复设置");
+    return;
+  }
+  if (count <= 1)
+  {
+    LOG_INFO("🧵 检测线程数为1，使用串行检测");
+    return;
+  }
+
+  // 检测结果由批量流水线的发布阶段统一发出
+  m_inspectionPool = new InspectionPool(m_templateCache, count, this);
+  m_inspectionPool->start();
+}
+
+/**
+ * @brief 设置批量处理时的预读图像数量
+ * @param depth 预读数量
+ */
+void visualWorkThread::setPrefetchDepth(int depth)
+{
+  m_prefetchDepth = qMax(1, depth);
+}
+
+/**
+ * @brief 设置模板匹配跟踪搜索窗口配置
+ * @param config 跟踪配置
+ */
+void visualWorkThread::setSearchWindowConfig(const SearchWindowConfig& config)
+{
+  m_inspectionCore.setSearchWindowConfig(config);
+  if (m_inspectionPool != nullptr)
+  {
+    m_inspectionPool->setSearchWindowConfig(config);
+  }
+}
+
+/**
+ * @brief 获取跟踪搜索统计
+ * @return 串行检测与检测线程池合计的统计
+ */
+SearchWindowStats visualWorkThread::searchWindowStats() const
+{
+  SearchWindowStats total = m_inspectionCore.searchWindowStats();
+  if (m_inspectionPool != nullptr)
+  {
+    total.merge(m_inspectionPool->searchWindowStats());
+  }
+  return total;
+}
+
+/**
+ * @brief 设置全图匹配参数
+ * @param config 匹配参数
+ */
+void visualWorkThread::setMatchPassConfig(const MatchPassConfig& config)
+{
+  m_inspectionCore.setMatchPassConfig(config);
+  if (m_inspectionPool != nullptr)
+  {
+    m_inspectionPool->setMatchPassConfig(config);
+  }
+}
+
+/**
+ * @brief 获取投机匹配统计
+ * @return 串行检测与检测线程池合计的统计
+ */
+SpeculativeMatchStats visualWorkThread::speculativeStats() const
+{
+  SpeculativeMatchStats total = m_inspectionCore.speculativeStats();
+  if (m_inspectionPool != nullptr)
+  {
+    total.merge(m_inspectionPool->speculativeStats());
+  }
+  return total;
+}
+
+/**
+ * @brief 获取测量结果环形缓冲
+ * @return 测量结果缓冲
+ */
+const MeasurementRing& visualWorkThread::measurementRing() const
+{
+  return m_measurementRing;
+}
+
+/**
+ * @brief 获取检测线程池
+ * @return 检测线程池指针，未启用时为nullptr
+ */
+InspectionPool* visualWorkThread::inspectionPool() const
+{
+  return m_inspectionPool;
+}
+
+/**
+ * @brief 设置监视目录配置
+ * @param config 监视目录配置
+ */
+void visualWorkThread::setHotFolderConfig(const HotFolderConfig& config)
+{
+  QMutexLocker locker(&m_mutex);
+  m_hotFolderConfig = config;
+}
+
+/**
+ * @brief 是否正在以监视目录模式处理
+ */
+bool visualWorkThread::isHotFolderActive() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_activeHotFolder != nullptr;
+}
+
+/**
+ * @brief 停止监视目录
+ */
+void visualWorkThread::stopHotFolder()
+{
+  QMutexLocker locker(&m_mutex);
+  if (m_activeHotFolder != nullptr)
+  {
+    m_activeHotFolder->stop();
+  }
 }
 
 /**
@@ -141,6 +380,22 @@ bool visualWorkThread::initHalcon()
   }
 }
 
+/**
+ * @brief 由配方目录生成模板路径
+ * @param recipeDir 配方目录，为空时使用默认配置目录
+ */
+TemplatePaths visualWorkThread::recipePaths(const QString& recipeDir) const
+{
+  QString root = recipeDir.isEmpty() ? QApplication::applicationDirPath() + "/config" : QDir::cleanPath(recipeDir);
+  TemplatePaths paths;
+  paths.modelDir = root + "/models/DetectionModel/";
+  paths.measureDir = root + "/halconParams/Measure";
+  paths.qrCodeDir = root + "/halconParams/QRCode";
+  paths.checkDir = root + "/halconParams/Check";
+  paths.recipeFile = root + "/halconParams/recipe.json";
+  return paths;
+}
+
 /**
  * @brief 初始化路径配置
  */
@@ -155,7 +410,11 @@ void visualWorkThread::initPath()
     QRcodeReadPath = HalconPramFilePath + "QRCode";
     MeasureReadPath = HalconPramFilePath + "Measure";
     CheckReadPath = HalconPramFilePath + "Check";
-    m_modelReadPath = QApplication::applicationDirPath() + "/config/models/";
+    m_modelReadPath = QApplication::applicationDirPath() + "/config/models/DetectionModel/";
+
+    // 模板与参数常驻缓存：启动时预加载（或首次使用时加载），之后由文件监视触发更新
+    m_templateCache->setPaths(TemplatePaths{m_modelReadPath, MeasureReadPath, QRcodeReadPath, CheckReadPath,
+                                            HalconPramFilePath + "recipe.json"});
 
     LOG_INFO("路径配置初始化完成");
     LOG_INFO(QString("参数文件路径: %1").arg(HalconPramFilePath));
@@ -203,10 +462,21 @@ void visualWorkThread::process()
 
     QString imagePtah = QApplication::applicationDirPath() + "/img";
 
-    m_modelReadPath += "DetectionModel/";
     LOG_INFO(tr("m_modelReadPath : %1").arg(m_modelReadPath));
 
-    visualWorkThreadReadImage(imagePtah);
+    bool hotFolderEnabled = false;
+    {
+      QMutexLocker locker(&m_mutex);
+      hotFolderEnabled = m_hotFolderConfig.enabled;
+    }
+    if (hotFolderEnabled)
+    {
+      visualWorkThreadWatchFolder(imagePtah);
+    }
+    else
+    {
+      visualWorkThreadReadImage(imagePtah);
+    }
 
   }
   catch (const HalconCpp::HException& e)
@@ -263,462 +533,223 @@ void visualWorkThread::visualWorkThreadReadImage(const QString& imagePath)
 
   LOG_INFO(QString("📁 找到 %1 个图像文件").arg(fileList.size()));
 
-  // 🎯 简单的图像处理循环示例
-  for (int i = 0; i < fileList.size() && isRunning(); ++i)
+  FileListSource source(fileList);
+  int published = runInspectionPipeline(source);
+  LOG_INFO(QString("🎉 图像处理任务完成，共处理 %1 个文件").arg(published));
+}
+
+// 监视目录模式：持续处理新写入的图像
+void visualWorkThread::visualWorkThreadWatchFolder(const QString& imagePath)
+{
+  HotFolderConfig config;
+  {
+    QMutexLocker locker(&m_mutex);
+    config = m_hotFolderConfig;
+  }
+  if (config.folder.isEmpty())
   {
-    const QFileInfo& fileInfo = fileList[i];
-    QString filePath = fileInfo.absoluteFilePath();
-    QString fileName = fileInfo.fileName();
+    config.folder = imagePath;
+  }
+  if (config.journalPath.isEmpty())
+  {
+    config.journalPath = QApplication::applicationDirPath() + "/config/vision/hotfolder.journal";
+  }
 
-    try
-    {
-      LOG_INFO(QString("🖼️ 正在处理图像 [%1/%2]: %3")
-          .arg(i + 1).arg(fileList.size()).arg(fileName));
+  HotFolderSource source(config);
+  if (!source.start())
+  {
+    QString errorMsg = QString("无法监视图像文件夹：%1").arg(config.folder);
+    LOG_ERROR(errorMsg);
+    emit error(errorMsg);
+    return;
+  }
+  {
+    QMutexLocker locker(&m_mutex);
+    m_activeHotFolder = &source;
+  }
 
-      // 读取图像
-      HObject image;
-      ReadImage(&image, filePath.toStdString().c_str());
+  int published = runInspectionPipeline(source);
 
-      // 🎯 在这里添加您的具体图像处理逻辑
-      // 例如：图像增强、特征提取、模式识别等
+  {
+    QMutexLocker locker(&m_mutex);
+    m_activeHotFolder = nullptr;
+  }
+  source.stop();
+  LOG_INFO(QString("🎉 监视目录处理结束，共处理 %1 个文件").arg(published));
+  LOG_INFO(QString("📂 监视目录统计: %1").arg(source.statsSummary()));
+}
 
-      if (image.IsInitialized() == false)
-      {
-        QString errorMsg = QString("图像 %1 读取失败").arg(fileName);
-        LOG_ERROR(errorMsg);
-        emit error(errorMsg);
-        continue; // 跳过当前图像，继续处理下一个
-      }
-      LOG_INFO(QString("✅ 图像处理完成：%1").arg(fileName));
-      connect(this, &visualWorkThread::imageFinished, this, &visualWorkThread::onProcessImage);
-      emit imageFinished(image);
-    }
-    catch (const HalconCpp::HException& e)
-    {
-      QString errorMsg = QString("处理图像 %1 时发生Halcon异常: %2")
-                         .arg(fileName).arg(QString(e.ErrorMessage()));
-      LOG_ERROR(errorMsg);
-      // 继续处理下一张图像，而不是中断整个处理流程
-      continue;
+// 解码 → 检测 → 发布 三阶段流水线：读图、匹配、界面发布互相重叠
+int visualWorkThread::runInspectionPipeline(ImageSource& source)
+{
+  m_frameChannel->reset();
+
+  InspectionPipeline pipeline(&m_inspectionCore, m_templateCache, m_inspectionPool);
+  pipeline.setPrefetchDepth(m_prefetchDepth);
+  pipeline.setContinueCheck([this]() { return isRunning(); });
+  pipeline.setErrorHandler([this](const QString& errorMsg) { emit error(errorMsg); });
+  pipeline.addPublisher([this](const InspectionResult& result) { publishResult(result); });
+  if (m_imageWriter->isRunning())
+  {
+    // 只把图像引用放入保存队列，编码和写盘在保存线程中进行
+    pipeline.addPublisher([this](const InspectionResult& result) { m_imageWriter->submitResult(result); });
+  }
 
-    } catch (const std::exception& e)
-    {
-      QString errorMsg = QString("处理图像 %1 时发生异常: %2")
-                         .arg(fileName).arg(QString::fromStdString(e.what()));
-      LOG_ERROR(errorMsg);
-      continue;
-    }
+  int published = pipeline.run(source);
+  syncTemplateMembers(m_templateCache->current());
+  syncMeasurementCache();
+
+  LOG_INFO(QString("⏱️ 流水线统计:\n%1").arg(pipeline.statsSummary()));
+  if (m_inspectionPool != nullptr)
+  {
+    LOG_INFO(QString("🧵 检测线程利用率:\n%1").arg(m_inspectionPool->utilisationSummary()));
+  }
+  LOG_INFO(QString("🖥️ 显示通道: %1").arg(m_frameChannel->statsSummary()));
+  if (m_imageWriter->isRunning())
+  {
+    LOG_INFO(QString("💾 图像保存: %1").arg(m_imageWriter->statsSummary()));
   }
-  LOG_INFO(QString("🎉 图像处理任务完成，共处理 %1 个文件").arg(fileList.size()));
+
+  SearchWindowStats searchStats = searchWindowStats();
+  if (searchStats.frames > 0)
+  {
+    LOG_INFO(QString("🎯 跟踪搜索: 帧数=%1, 命中率=%2% (初始窗口=%3, 放大后=%4), 全图搜索=%5 (跟踪失败回退=%6, 参考帧过旧=%7), "
+                     "窗口耗时=%8 ms, 全图耗时=%9 ms, 命中节省=%10 ms, 回退损失=%11 ms, 净节省=%12 ms/帧")
+        .arg(searchStats.frames).arg(searchStats.hitRate() * 100.0, 0, 'f', 1)
+        .arg(searchStats.windowHits).arg(searchStats.widenedHits)
+        .arg(searchStats.globalSearches).arg(searchStats.globalFallbacks).arg(searchStats.staleSkips)
+        .arg(searchStats.windowMs, 0, 'f', 1).arg(searchStats.globalMs, 0, 'f', 1)
+        .arg(searchStats.savedMs, 0, 'f', 1).arg(searchStats.fallbackMs, 0, 'f', 1)
+        .arg(searchStats.netSavedMsPerFrame(), 0, 'f', 2));
+  }
+
+  SpeculativeMatchStats specStats = speculativeStats();
+  if (specStats.frames > 0)
+  {
+    LOG_INFO(QString("⚡ 投机匹配: 帧数=%1, 快速胜出=%2, 精确胜出=%3, 无结果=%4, 取消=%5, 改为顺序匹配=%6, "
+                     "平均快速阶段=%7 ms, 平均总耗时=%8 ms")
+        .arg(specStats.frames).arg(specStats.fastWins).arg(specStats.preciseWins)
+        .arg(specStats.misses).arg(specStats.cancelled).arg(specStats.busySkips)
+        .arg(specStats.fastMs / specStats.frames, 0, 'f', 2)
+        .arg(specStats.totalMs / specStats.frames, 0, 'f', 2));
+  }
+  if (LatencyProfiler::instance().isEnabled())
+  {
+    LOG_INFO(QString("⏱️ 检测分阶段耗时:\n%1").arg(LatencyProfiler::instance().summary()));
+  }
+
+  TemplateCacheStats cacheStats = m_templateCache->stats();
+  LOG_INFO(QString("📊 模板缓存: 命中=%1, 未命中=%2, 加载=%3, 失败=%4, 最近加载耗时=%5 ms")
+      .arg(cacheStats.hits).arg(cacheStats.misses).arg(cacheStats.reloads)
+      .arg(cacheStats.failedReloads).arg(cacheStats.lastLoadMs, 0, 'f', 2));
+  return published;
 }
 
 void visualWorkThread::onProcessImage(const HObject& processedImage)
 {
-  if (m_modelReadPath.isEmpty())
-  {
-    LOG_ERROR("模型读取路径未设置，无法处理图像");
-    return;
-  }
-  LOG_INFO(tr("m_modelReadPath : %1").arg(m_modelReadPath));
   if (processedImage.IsInitialized() == false)
   {
     LOG_WARNING("图像初始化失败，无法处理图像");
     return;
   }
   const HObject image = processedImage;
-  processModelParam(); // 处理模型参数
 
-  // 检查模板是否已正确加载
-  if (visual_modelId.Length() == 0)
+  // 从常驻缓存获取模板集，整帧使用同一份快照（模板与路径一致），不受热更新和配方切换影响
+  TemplateSetPtr templateSet = m_templateCache->acquire();
+  if (templateSet && templateSet->paths.modelDir.isEmpty())
+  {
+    LOG_ERROR("模型读取路径未设置，无法处理图像");
+    return;
+  }
+  if (!templateSet || !templateSet->isValid())
   {
     LOG_ERROR("❌ 模板未正确加载，无法进行匹配");
     return;
   }
+  syncTemplateMembers(templateSet);
 
-  if (image.IsInitialized() == true)
+  LOG_INFO("🔍 开始进行模板匹配...");
+  InspectionResult result = m_inspectionCore.inspect(image, *templateSet, templateSet->modelId);
+  publishResult(result);
+  if (m_imageWriter->isRunning())
   {
-    HTuple Crow, Ccol, Cangle, Cscore, AffHomMat2D;
-
-    LOG_INFO("🔍 开始进行模板匹配...");
-    LOG_INFO(QString("📊 模板参数: Row=%1, Column=%2, Angle=%3")
-        .arg(visual_Row.D()).arg(visual_Column.D()).arg(visual_Angle.D()));
-
-    // 检查图像和模板的基本信息
-    HTuple ImageWidth, ImageHeight, ImageChannels;
-    GetImageSize(image, &ImageWidth, &ImageHeight);
-    CountChannels(image, &ImageChannels);
-    LOG_INFO(
-        QString("📷 图像信息: 宽度=%1, 高度=%2, 通道数=%3").arg(ImageWidth[0].I()).arg(ImageHeight[0].I()).arg(ImageChannels[0].I()
-        ));
-
-    // 预处理图像以提高匹配成功率
-    HObject processedImage = image;
-    try
-    {
-      // 如果是彩色图像，转换为灰度图像
-      if (ImageChannels[0].I() > 1)
-      {
-        LOG_INFO("🔄 转换彩色图像为灰度图像...");
-        Rgb1ToGray(image, &processedImage);
-      }
-
-      // 可选：增强对比度
-      // HObject enhancedImage;
-      // Emphasize(processedImage, &enhancedImage, 7, 7, 1.0);
-      // processedImage = enhancedImage;
-    }
-    catch (const HalconCpp::HException& except)
-    {
-      LOG_WARNING(QString("⚠️ 图像预处理失败，使用原图像: %1").arg(except.ErrorMessage().Text()));
-      processedImage = image;
-    }
-
-    try
-    {
-      // 查找模板 - 使用更保守的参数避免挂起
-      LOG_INFO("🎯 正在执行 FindShapeModel...");
-
-      // 首先尝试快速匹配（高greediness，低精度）
-      LOG_INFO("⚡ 尝试快速匹配模式...");
-      FindShapeModel(processedImage, visual_modelId,
-                     -0.39, 0.78, // 角度范围: ±22.5度
-                     0.3, // 最小分数 (降低要求)
-                     1, // 最大匹配数
-                     0.5, // 最大重叠
-                     "least_squares", // 子像素精度
-                     3, // 金字塔层数 (减少层数加快速度)
-                     0.9, // 贪婪度 (提高速度)
-                     &Crow, &Ccol, &Cangle, &Cscore);
-
-      LOG_INFO(QString("✅ FindShapeModel 执行完成，找到 %1 个匹配").arg(Crow.Length()));
-
-      // 检查是否找到模板
-      if (Crow.Length() == 0)
-      {
-        LOG_WARNING("⚠️ 快速匹配未找到结果，尝试精确匹配模式...");
-
-        // 如果快速匹配失败，尝试更精确的匹配
-        try
-        {
-          FindShapeModel(processedImage, visual_modelId,
-                         -0.79, 1.57, // 更大角度范围: ±45度 到 90度
-                         0.2, // 更低分数阈值
-                         3, // 更多匹配候选
-                         0.7, // 允许更多重叠
-                         "least_squares",
-                         4, // 增加金字塔层数
-                         0.7, // 降低贪婪度获得更好精度
-                         &Crow, &Ccol, &Cangle, &Cscore);
-
-          LOG_INFO(QString("🔍 精确匹配完成，找到 %1 个匹配").arg(Crow.Length()));
-        }
-        catch (const HalconCpp::HException& except)
-        {
-          LOG_ERROR(QString("❌ 精确匹配也失败: %1").arg(except.ErrorMessage().Text()));
-        }
-      }
-
-      if (Crow.Length() == 0)
-      {
-        LOG_WARNING("❌ 未找到匹配的模板");
-        // 创建空的显示对象列表
-        QList<DisplayObjectInfo> emptyDisplayObjects;
-        emit sendImageWithDisplayObjects(image, emptyDisplayObjects);
-        return;
-      }
-
-      LOG_INFO(QString("✅ 找到模板匹配: Row=%1, Col=%2, Angle=%3, Score=%4")
-          .arg(Crow[0].D()).arg(Ccol[0].D()).arg(Cangle[0].D()).arg(Cscore[0].D()));
-
-      // 计算仿射变换矩阵
-      LOG_INFO("🔄 正在计算仿射变换矩阵...");
-      VectorAngleToRigid(visual_Row, visual_Column, visual_Angle, Crow[0], Ccol[0], Cangle[0], &AffHomMat2D);
-
-      LOG_INFO("✅ 仿射变换矩阵计算成功");
-
-      // 读取原始测量区域
-      HObject Measyre_Rect1, Measyre_Rect2;
-      QString Measyre_Rect1_Path = MeasureReadPath + "/m_Measyre_Rect1.hobj";
-      QString Measyre_Rect2_Path = MeasureReadPath + "/m_Measyre_Rect2.hobj";
-
-      try
-      {
-        ReadRegion(&Measyre_Rect1, Measyre_Rect1_Path.toLatin1().data());
-        ReadRegion(&Measyre_Rect2, Measyre_Rect2_Path.toLatin1().data());
-        LOG_INFO("✅ 成功读取原始测量区域");
-      }
-      catch (const HalconCpp::HException& e)
-      {
-        LOG_ERROR(QString("读取测量区域文件失败: %1").arg(QString(e.ErrorMessage())));
-        return;
-      }
-
-      // 🎯 将测量区域通过仿射变换映射到找到的模板位置
-      HObject TransformedRect1, TransformedRect2;
-      AffineTransRegion(Measyre_Rect1, &TransformedRect1, AffHomMat2D, "nearest_neighbor");
-      AffineTransRegion(Measyre_Rect2, &TransformedRect2, AffHomMat2D, "nearest_neighbor");
-
-      LOG_INFO("🎯 测量区域已成功映射到模板位置");
-
-      // 🎯 创建显示对象列表
-      QList<DisplayObjectInfo> displayObjects;
-
-      // 添加变换后的区域（绿色显示）
-      displayObjects.append(DisplayObjectInfo(TransformedRect1, "green", 2.0));
-      displayObjects.append(DisplayObjectInfo(TransformedRect2, "green", 2.0));
-
-      // 在变换后的区域中提取轮廓
-      HObject Xld1 = workThreadHalcon->QtGetLengthMaxXld(image, TransformedRect1, 100);
-
-      // 检查第一个轮廓是否提取成功
-      if (!Xld1.IsInitialized())
-      {
-        LOG_INFO(tr("❌ 警告：第一个映射区域没有找到有效轮廓"));
-      }
-      else
-      {
-        LOG_INFO(tr("✅ 第一个映射区域轮廓提取成功"));
-        // 🎨 添加轮廓到显示对象列表（红色显示）
-        displayObjects.append(DisplayObjectInfo(Xld1, "red", 3.0));
-      }
-
-      LOG_INFO(tr("正在提取第二个映射区域的轮廓..."));
-      HObject Xld2 = workThreadHalcon->QtGetLengthMaxXld(image, TransformedRect2, 100);
-
-      // 检查第二个轮廓是否提取成功
-      if (!Xld2.IsInitialized())
-      {
-        LOG_INFO(tr("❌ 警告：第二个映射区域没有找到有效轮廓"));
-      }
-      else
-      {
-        LOG_INFO(tr("✅ 第二个映射区域轮廓提取成功"));
-        // 🎨 添加轮廓到显示对象列表（蓝色显示）
-        displayObjects.append(DisplayObjectInfo(Xld2, "blue", 3.0));
-      }
-
-      // 只有两个轮廓都成功提取才进行距离计算
-      if (Xld1.IsInitialized() && Xld2.IsInitialized())
-      {
-        LOG_INFO(tr("正在计算两个轮廓之间的距离..."));
-
-        try
-        {
-          HTuple DisMin, DisMax;
-          DistanceCc(Xld1, Xld2, "point_to_point", &DisMin, &DisMax); // 计算两点之间的距离
-
-          // 🎯 使用新的测量分析功能获取额外信息
-          double area1 = workThreadHalcon->calculateRegionArea(TransformedRect1);
-          double area2 = workThreadHalcon->calculateRegionArea(TransformedRect2);
-          pointStruct centroid1 = workThreadHalcon->calculateRegionCentroid(TransformedRect1);
-          pointStruct centroid2 = workThreadHalcon->calculateRegionCentroid(TransformedRect2);
-
-          // 计算重心之间的距离
-          double centroidDistance = workThreadHalcon->calculatePointDistance(
-              centroid1.X, centroid1.Y, centroid2.X, centroid2.Y);
-
-          QString msg = QString(
-                            "🎯 映射区域测量结果:\n最小距离: %1px\n最大距离: %2px\n重心距离: %3px\n区域1面积: %4px²\n区域2面积: %5px²\n模板匹配得分: %6")
-                        .arg(QString::number(DisMin.D(), 'f', 2))
-                        .arg(QString::number(DisMax.D(), 'f', 2))
-                        .arg(QString::number(centroidDistance, 'f', 2))
-                        .arg(QString::number(area1, 'f', 1))
-                        .arg(QString::number(area2, 'f', 1))
-                        .arg(QString::number(Cscore[0].D(), 'f', 3));
-
-          // 发送图像和所有显示对象（原子操作）
-          emit sendImageWithDisplayObjects(image, displayObjects);
-          emit sendMainWinddowMsg(msg);
-
-          // 🎯 可选：导出测量结果到缓存
-          QMap<QString, QVariant> measurementResults;
-          measurementResults["最小距离"] = DisMin.D();
-          measurementResults["最大距离"] = DisMax.D();
-          measurementResults["重心距离"] = centroidDistance;
-          measurementResults["区域1面积"] = area1;
-          measurementResults["区域2面积"] = area2;
-          measurementResults["重心1_X"] = centroid1.X;
-          measurementResults["重心1_Y"] = centroid1.Y;
-          measurementResults["重心2_X"] = centroid2.X;
-          measurementResults["重心2_Y"] = centroid2.Y;
-          measurementResults["模板匹配得分"] = Cscore[0].D();
-          measurementResults["模板位置_Row"] = Crow[0].D();
-          measurementResults["模板位置_Col"] = Ccol[0].D();
-          measurementResults["模板角度"] = Cangle[0].D();
-
-          // 保存到HalconLable的缓存中
-          for (auto it = measurementResults.begin(); it != measurementResults.end(); ++it)
-          {
-            workThreadHalcon->measurementCache[it.key()] = it.value();
-          }
-
-          LOG_INFO(tr("📊 测量结果已保存到缓存，共 %1 项数据").arg(measurementResults.size()));
-
-        }
-        catch (HalconCpp::HException& e)
-        {
-          QString errorMsg = tr("❌ 距离计算失败：%1").arg(QString(e.ErrorMessage()));
-          LOG_INFO(errorMsg);
-        } catch (...)
-        {
-          LOG_INFO(tr("❌ 距离计算时发生未知错误"));
-        }
-      }
-      else
-      {
-        LOG_INFO(tr("❌ 无法进行距离测量：轮廓提取失败"));
-        // 即使轮廓提取失败，也显示区域
-        emit sendImageWithDisplayObjects(image, displayObjects);
-      }
-    }
-    catch (const HalconCpp::HException& e)
-    {
-      QString errorMsg = tr("❌ 模板匹配或变换失败：%1").arg(QString(e.ErrorMessage()));
-      LOG_ERROR(errorMsg);
-      // 创建空的显示对象列表
-      QList<DisplayObjectInfo> emptyDisplayObjects;
-      emit sendImageWithDisplayObjects(image, emptyDisplayObjects);
-    }
+    m_imageWriter->submitResult(result);
   }
-  else
+  syncMeasurementCache();
+}
+
+// 发布检测结果：放入显示帧通道并保存测量结果
+void visualWorkThread::publishResult(const InspectionResult& result)
+{
+  // 图像、显示对象和消息作为一帧放入通道（原子操作），界面只取最新帧
+  DisplayFrame frame;
+  frame.sequence = result.sequence;
+  frame.image = result.image;
+  frame.displayObjects = result.displayObjects;
+  frame.message = result.message;
+  frame.record = result.record;
+  m_frameChannel->publish(std::move(frame));
+
+  storeMeasurementResult(result);
+
+  // 分阶段耗时周期摘要（统计关闭时直接返回）
+  LatencyProfiler& profiler = LatencyProfiler::instance();
+  if (profiler.reportDue())
   {
-    LOG_INFO(tr("❌ 图像未初始化，无法进行处理"));
+    LOG_INFO(QString("⏱️ 检测分阶段耗时:\n%1").arg(profiler.summary()));
   }
 }
 
-// 处理模型参数 - 读取模板文件和参数文件
-void visualWorkThread::processModelParam()
+// 测量结果写入预分配环形缓冲（定长复制，无堆分配）
+void visualWorkThread::storeMeasurementResult(const InspectionResult& result)
 {
-  // 获取指定目录 , 文件类型， 模板路径， 模版参数
-  QStringList Type;
-  QString modelPath = "";
-  QString modelHTuplePath = "";
-
-  // 🎯 支持多种文件扩展名 - 您可以根据需要添加或删除
-  Type << "*.shm" << "*.tup";
-
-  LOG_INFO(QString("📋 设置文件类型过滤器: %1").arg(Type.join(", ")));
-
-  // 现在返回的是按文件类型分组的映射
-  QMap<QString, QStringList> fileTypeGroups = getCurrentToDayDate(m_modelReadPath, Type);
-
-  LOG_INFO(QString("🔍 共找到 %1 种文件类型").arg(fileTypeGroups.size()));
-
-  // 分别处理每种文件类型
-  for (auto it = fileTypeGroups.begin(); it != fileTypeGroups.end(); ++it)
+  if (!result.measured())
   {
-    QString extension = it.key();
-    QStringList files = it.value();
-
-    LOG_INFO(QString("📁 处理 %1 文件类型，共 %2 个文件:").arg(extension.toUpper()).arg(files.size()));
-
-    for (int i = 0; i < files.size(); ++i)
-    {
-      LOG_INFO(QString("  [%1] %2").arg(i + 1).arg(QFileInfo(files[i]).fileName()));
-    }
-
-    // 根据文件扩展名执行不同的处理逻辑
-    if (extension == "shm")
-    {
-      LOG_INFO(QString("🎯 专门处理 %1 个 .shm 模型文件").arg(files.size()));
-      if (!files.isEmpty())
-      {
-        modelPath = files[0]; // 只取最新的一个.shm文件
-        LOG_INFO("modelPath : " + modelPath);
-
-        try
-        {
-          // 读取模板文件
-          ReadShapeModel(modelPath.toLatin1().data(), &visual_modelId);
-          LOG_INFO(QString("✅ 成功读取模板文件: %1, ModelId: %2")
-              .arg(QFileInfo(modelPath).fileName())
-              .arg(visual_modelId.ToString().Text()));
-        }
-        catch (const HalconCpp::HException& e)
-        {
-          LOG_ERROR(QString("读取模板文件 %1 时发生Halcon异常: %2")
-              .arg(QFileInfo(modelPath).fileName()).arg(QString(e.ErrorMessage())));
-        }
-      }
-    }
+    return;
   }
+  m_measurementRing.push(result.record);
+}
 
-  if (fileTypeGroups.contains("tup"))
+// 将最新测量结果同步到HalconLable的测量缓存（界面/导出使用，每批次一次）
+void visualWorkThread::syncMeasurementCache()
+{
+  MeasurementRecord record;
+  if (!m_measurementRing.latest(record))
   {
-    QStringList tupFiles = fileTypeGroups["tup"];
-    LOG_INFO(QString("💡 可以直接访问 .tup 文件列表，共 %1 个文件").arg(tupFiles.size()));
-
-    // 过滤出文件名以"data"结尾的.tup文件
-    QStringList dataTupFiles;
-    for (const QString& filePath : tupFiles)
-    {
-      QFileInfo fileInfo(filePath);
-      QString baseName = fileInfo.baseName(); // 获取不带扩展名的文件名
-      if (baseName.endsWith("data", Qt::CaseInsensitive))
-      {
-        dataTupFiles.append(filePath);
-        LOG_INFO(QString("✅ 找到符合条件的文件: %1").arg(fileInfo.fileName()));
-        modelHTuplePath = filePath;
-      }
-    }
-
-    if (!dataTupFiles.isEmpty())
-    {
-      LOG_INFO(QString("🎯 找到 %1 个文件名以'data'结尾的.tup文件").arg(dataTupFiles.size()));
-
-      // 对符合条件的.tup文件进行特定处理
-      for (const QString& dataFilePath : dataTupFiles)
-      {
-        QFileInfo fileInfo(dataFilePath);
-        LOG_INFO(QString("🔧 正在处理data类型的.tup文件: %1").arg(fileInfo.fileName()));
-
-        try
-        {
-          // 读取模板参数文件
-          HTuple DataTuple;
-          ReadTuple(dataFilePath.toLatin1().data(), &DataTuple);
-          LOG_INFO(QString("✅ 成功读取data文件: %1，数据长度: %2")
-              .arg(fileInfo.fileName()).arg(DataTuple.Length()));
-
-          // 验证数据长度并解析参数
-          if (DataTuple.Length() >= 3)
-          {
-            visual_Row = DataTuple[0];
-            visual_Column = DataTuple[1];
-            visual_Angle = DataTuple[2];
+    return;
+  }
+  QVariantMap measurementResults = measurementToVariantMap(record);
+  for (auto it = measurementResults.begin(); it != measurementResults.end(); ++it)
+  {
+    workThreadHalcon->measurementCache[it.key()] = it.value();
+  }
+  LOG_INFO(tr("📊 测量结果: 累计 %1 条记录，最新结果已保存到缓存（%2 项数据）")
+      .arg(m_measurementRing.totalPushed()).arg(measurementResults.size()));
+}
 
-            LOG_INFO(QString("📊 模板参数解析成功: Row=%1, Column=%2, Angle=%3")
-                .arg(visual_Row.D()).arg(visual_Column.D()).arg(visual_Angle.D()));
-          }
-          else
-          {
-            LOG_ERROR(QString("❌ 模板参数文件数据不足: 期望>=3，实际=%1").arg(DataTuple.Length()));
-            // 设置默认值
-            visual_Row = 0;
-            visual_Column = 0;
-            visual_Angle = 0;
-          }
-        }
-        catch (const HalconCpp::HException& e)
-        {
-          LOG_ERROR(QString("读取data文件 %1 时发生Halcon异常: %2")
-              .arg(fileInfo.fileName()).arg(QString(e.ErrorMessage())));
-          // 设置默认值
-          visual_Row = 0;
-          visual_Column = 0;
-          visual_Angle = 0;
-        }
-      }
-    }
-    else
-    {
-      LOG_WARNING("未找到文件名以'data'结尾的.tup文件，使用默认参数");
-      // 设置默认值
-      visual_Row = 0;
-      visual_Column = 0;
-      visual_Angle = 0;
-    }
+// 将模板集及其目录同步到公有模板成员和路径成员，只在版本变化时复制
+void visualWorkThread::syncTemplateMembers(const TemplateSetPtr& templateSet)
+{
+  if (!templateSet || templateSet->generation == m_syncedTemplateGeneration)
+  {
+    return;
   }
+
+  const TemplatePaths& paths = templateSet->paths;
+  m_modelReadPath = paths.modelDir;
+  MeasureReadPath = paths.measureDir;
+  QRcodeReadPath = paths.qrCodeDir;
+  CheckReadPath = paths.checkDir;
+  HalconPramFilePath = QFileInfo(paths.measureDir).absolutePath() + "/";
+  visual_modelId = templateSet->modelId;
+  visual_Row = templateSet->row;
+  visual_Column = templateSet->column;
+  visual_Angle = templateSet->angle;
+  m_syncedTemplateGeneration = templateSet->generation;
+
+  LOG_INFO(QString("📊 模板参数已更新: 版本=%1, Row=%2, Column=%3, Angle=%4")
+      .arg(templateSet->generation)
+      .arg(visual_Row.D()).arg(visual_Column.D()).arg(visual_Angle.D()));
 }
 
 // 获取文件列表 - 按文件类型分组返回（混合策略：shm只返回最新，其他返回全部）
@@ -828,38 +859,7 @@ QMap<QString, QStringList> visualWorkThread::getCurrentToDayDate(const QString P
             .arg(lastModified.toString("yyyy-MM-dd hh:mm:ss")));
       }
 
-      // 根据不同文件扩展名执行不同的处理逻辑
-      if (extension == "shm")
-      {
-        LOG_INFO(QString("🎯 开始处理最新的 .shm 模型文件"));
-        for (const QString& filePath : files)
-        {
-          QFileInfo fileInfo(filePath);
-          HTuple ModelId;
-          LOG_INFO(QString("正在读取最新的 .shm 模型文件: %1").arg(fileInfo.fileName()));
-
-          try
-          {
-            // 读取模型参数
-            ReadShapeModel(filePath.toLatin1().data(), &ModelId);
-            if (ModelId.Length() == 0)
-            {
-              LOG_ERROR(QString("模型 %1 读取失败: ModelId为空").arg(fileInfo.fileName()));
-              continue;
-            }
-            LOG_INFO(QString("✅ 最新模型 %1 读取成功，ModelId: %2").arg(fileInfo.fileName()).arg(ModelId.ToString().Text()));
-          }
-          catch (const HalconCpp::HException& e)
-          {
-            LOG_ERROR(QString("读取最新模型 %1 时发生Halcon异常: %2").arg(fileInfo.fileName()).arg(QString(e.ErrorMessage())));
-            continue;
-          }
-        }
-      }
-      else
-      {
-        LOG_INFO(QString("ℹ️  %1 文件类型暂不执行特定处理逻辑").arg(extension.toUpper()));
-      }
+      // 模板文件只在此列出，实际加载由 TemplateCache 完成，避免重复读取
     }
     return fileTypeGroups; // 返回分组的文件映射（混合策略：shm最新，其他全部）
   }
@@ -9,10 +9,16 @@
 #include "../thirdparty/hdevelop/include/HalconLable.h"
 #include "../inc/ui/VisualProcess.h"
 #include "../inc/ui/serialdialog.h"
+#include "../inc/thread/FrameChannel.h"
+#include "../inc/thread/LatencyProfiler.h"
+#include "../inc/thread/ImageWriterService.h"
+#include "../inc/config/SettingManager.h"
 
 #include <QWidget>
 #include <QMessageBox>
-#include <QSettings>
+#include <QApplication>
+#include <QDir>
+#include <QtMath>
 #include <QThread>
 #include <QTimer>
 #include <QToolButton>
@@ -66,6 +72,84 @@
 #endif
 
 
+namespace
+{
+/**
+ * @brief 视觉线程配置项默认值（config/vision/vision.ini [Vision]）
+ */
+struct VisionSettingDefault
+{
+  QString key;
+  QVariant value;
+};
+
+QString visionSettingsPath()
+{
+  return QApplication::applicationDirPath() + "/config/vision/vision.ini";
+}
+
+const QVector<VisionSettingDefault>& visionSettingDefaults()
+{
+  static const QVector<VisionSettingDefault> defaults = {
+    {"Vision/InspectionWorkers", QThread::idealThreadCount()}, // 检测线程数，默认取CPU核心数
+    {"Vision/PrefetchDepth", 4}, // 批量处理时预读图像数量
+    {"Vision/FrameChannelCapacity", 2}, // 显示帧通道容量
+    {"Vision/FrameDropPolicy", "drop_oldest"}, // drop_oldest / drop_newest / block
+    {"Vision/TrackingEnabled", false}, // 模板匹配跟踪模式
+    {"Vision/TrackingRadius", 80.0}, // 初始搜索半径(像素)
+    {"Vision/TrackingAngle", 5.0}, // 初始角度半宽(度)
+    {"Vision/TrackingWidenSteps", 2}, // 放大次数
+    {"Vision/TrackingMinScore", 0.5}, // 跟踪最低得分
+    {"Vision/FastMinScore", 0.3}, // 快速匹配最低得分
+    {"Vision/PreciseMinScore", 0.2}, // 精确匹配最低得分
+    {"Vision/SpeculativeMatching", false}, // 快速/精确匹配同时运行
+    {"Vision/SpeculativeAcceptScore", 0.5}, // 投机模式下可直接采用的得分
+    {"Vision/PreciseTimeoutMs", 500}, // 投机模式下精确匹配超时(ms)，0表示不设置
+    {"Vision/LatencyProfiling", false}, // 检测分阶段耗时统计
+    {"Vision/LatencyReportInterval", 30}, // 耗时摘要输出间隔(秒)，0表示只在批次结束时输出
+    {"Vision/HotFolderEnabled", false}, // 监视目录模式：持续处理新写入的图像
+    {"Vision/HotFolderPath", ""}, // 监视目录，为空时使用程序目录下的img
+    {"Vision/HotFolderJournal", ""}, // 已处理日志，为空时使用config/vision/hotfolder.journal
+    {"Vision/HotFolderSettleMs", 500}, // 文件大小保持不变多久视为写入完成(ms)
+    {"Vision/HotFolderRescanMs", 10000}, // 全目录补扫间隔(ms)，0表示不补扫
+    {"Vision/HotFolderProcessExisting", true}, // 是否处理启动前已有的未处理文件
+    {"Vision/HotFolderDecodeAttempts", 3}, // 同一文件读取失败几次后放弃（改写后重新处理）
+    {"Vision/ImageSaveEnabled", false}, // 保存检测结果图像（后台线程编码写盘）
+    {"Vision/ImageSavePath", ""}, // 保存根目录，为空时使用程序目录下的result_images
+    {"Vision/ImageSavePolicy", "ng_only"}, // all / ng_only / ng_and_sampled
+    {"Vision/ImageSaveSampleInterval", 100}, // ng_and_sampled：每N张OK图像保存一张
+    {"Vision/ImageSaveNgFormat", "png"}, // NG图像格式：png / tiff / bmp / jpeg / jp2 / hobj
+    {"Vision/ImageSaveOkFormat", "jpeg"}, // OK图像格式
+    {"Vision/ImageSaveCompression", -1}, // png/tiff压缩级别0~9，jpeg/jp2质量1~100，-1为默认
+    {"Vision/ImageSaveThreads", 2}, // 编码线程数
+    {"Vision/ImageSaveQueue", 32}, // 保存队列容量
+    {"Vision/ImageSaveMinFreeMB", 1024}, // 磁盘剩余空间低于此值(MB)时停止保存
+    {"Vision/ImageArchiveEnabled", false}, // 检测结果图像追加写入归档段文件，代替每张图像一个文件
+    {"Vision/ImageArchivePath", ""}, // 归档目录，为空时使用保存根目录下的archive
+    {"Vision/ImageArchiveSegmentMB", 1024}, // 单个段文件上限(MB)
+    {"Vision/ImageArchiveMaxGB", 0}, // 归档总大小上限(GB)，0表示不限制
+    {"Vision/ImageArchiveRetentionDays", 30}, // 保留天数，0表示不限制
+    {"Vision/ImageArchiveCompression", 1}, // zlib压缩级别0~9，0表示不压缩
+    {"Vision/TemplatePreload", true}, // 启动时在后台并行预加载模板和参数文件
+    {"Vision/TemplateLoadThreads", 0}, // 模板加载线程数，0表示按CPU核数
+    {"Vision/RecipeDir", ""}, // 产品配方目录，为空时使用默认配置目录；由“产品配置”按钮写入
+  };
+  return defaults;
+}
+
+QVariant visionSettingDefault(const QString& key)
+{
+  for (const VisionSettingDefault& item : visionSettingDefaults())
+  {
+    if (item.key == key)
+    {
+      return item.value;
+    }
+  }
+  return QVariant();
+}
+}
+
 Mainwindow::Mainwindow(QWidget* parent) :
   QWidget(parent), ui(new Ui::Mainwindow)
 {
@@ -81,6 +165,15 @@ Mainwindow::Mainwindow(QWidget* parent) :
   initThread();
   // 初始化信号和槽连接
   initConnect();
+  // 模板在后台并行预加载，首帧无需等待读取模板文件；上次选择的产品配方在启动时直接切换
+  if (!m_recipeDir.isEmpty() && QDir(m_recipeDir).exists())
+  {
+    m_visualWorkThread->switchRecipe(m_recipeDir);
+  }
+  else if (m_templatePreload)
+  {
+    m_visualWorkThread->preloadTemplates();
+  }
 
   LOG_INFO(SYSTEM, "应用程序初始化完成");
 }
@@ -91,6 +184,7 @@ Mainwindow::~Mainwindow()
   if (m_visualProcessThread != nullptr)
   {
     m_visualWorkThread->setRunning(false); // 停止工作线程
+    m_visualWorkThread->imageWriter()->stop(true); // 写完排队的图像
     m_visualProcessThread->quit(); // 请求线程退出
     m_visualProcessThread->wait(); // 等待线程结束
     delete m_visualProcessThread; // 删除线程对象
@@ -186,34 +280,14 @@ void Mainwindow::initConnect()
       rightHal->dispHalconMessage(20, 20, Msg, "green");
     });
 
-    // 连接图像和显示对象组合信号（原子操作）
-    connect(m_visualWorkThread, &visualWorkThread::sendImageWithDisplayObjects, this,
-            [this](const HObject& image, const QList<DisplayObjectInfo>& displayObjects)
-            {
-              rightHal->clearDisplayObjectsOnly();
-              LOG_INFO(SYSTEM, QString("收到图像和 %1 个显示对象").arg(displayObjects.size()));
-
-              // 首先显示图像
-              if (image.IsInitialized())
-              {
-                rightHal->showImage(image);
-                LOG_INFO(SYSTEM, "图像已显示在右侧Halcon标签");
-              }
-              else
-              {
-                LOG_WARNING(SYSTEM, "收到未初始化的图像，无法显示");
-              } // 然后添加所有显示对象
-              for (const auto& dispObj : displayObjects)
-              {
-                if (dispObj.object.IsInitialized())
-                {
-                  rightHal->addDisplayObject(dispObj.object, dispObj.color, dispObj.lineWidth);
-                  LOG_DEBUG(SYSTEM, QString("添加显示对象: 颜色=%1, 线宽=%2").arg(dispObj.color).arg(dispObj.lineWidth));
-                }
-              }
-
-              LOG_INFO(SYSTEM, QString("成功处理图像和 %1 个显示对象").arg(displayObjects.size()));
-            });
+    // 检测结果经有界帧通道送达，通道只在有新帧时通知一次，界面每次只显示最新帧
+    connect(m_visualWorkThread->frameChannel(), &FrameChannel::frameAvailable,
+            this, &Mainwindow::onFrameAvailable, Qt::QueuedConnection);
+
+    connect(m_visualWorkThread, &visualWorkThread::templatesReady, this, [this](bool ok, const QString& summary)
+    {
+      appLogInfo(QString("%1 %2").arg(ok ? "📦" : "❌").arg(summary), ok ? INFO : ERR);
+    }, Qt::QueuedConnection);
 
     LOG_INFO(SYSTEM, "视觉工作线程基础信号连接完成");
   }
@@ -325,6 +399,8 @@ void Mainwindow::initThread()
     m_visualProcessThread = new QThread();
     // 创建视觉工作线程对象
     m_visualWorkThread = new visualWorkThread();
+    // 检测线程池需在GUI线程中创建，必须在moveToThread之前设置
+    applyVisionSettings();
     // 将视觉工作线程移动到新线程中
     m_visualWorkThread->moveToThread(m_visualProcessThread);
 
@@ -337,6 +413,143 @@ void Mainwindow::initThread()
   }
 }
 
+void Mainwindow::applyVisionSettings()
+{
+  // 视觉线程配置：config/vision/vision.ini [Vision]，缺少的键写入默认值
+  if (m_settingManager == nullptr)
+  {
+    m_settingManager = new SettingManager(this);
+  }
+  if (!m_settingManager->init(visionSettingsPath()))
+  {
+    LOG_ERROR(SYSTEM, "视觉配置文件初始化失败，使用默认配置");
+  }
+  for (const VisionSettingDefault& item : visionSettingDefaults())
+  {
+    if (!m_settingManager->hasValue(item.key))
+    {
+      m_settingManager->setValue(item.key, item.value);
+    }
+  }
+  auto setting = [this](const QString& key)
+  {
+    return m_settingManager->getValue(key, visionSettingDefault(key));
+  };
+
+  int workerCount = qBound(1, setting("Vision/InspectionWorkers").toInt(), 64);
+  int prefetchDepth = qBound(1, setting("Vision/PrefetchDepth").toInt(), 64);
+  int channelCapacity = qBound(1, setting("Vision/FrameChannelCapacity").toInt(), 64);
+  FrameDropPolicy dropPolicy = FrameChannel::policyFromString(setting("Vision/FrameDropPolicy").toString());
+  SearchWindowConfig searchConfig;
+  searchConfig.enabled = setting("Vision/TrackingEnabled").toBool();
+  searchConfig.radius = qMax(8.0, setting("Vision/TrackingRadius").toDouble());
+  searchConfig.angleExtent = qDegreesToRadians(qMax(0.0, setting("Vision/TrackingAngle").toDouble()));
+  searchConfig.widenSteps = qBound(0, setting("Vision/TrackingWidenSteps").toInt(), 8);
+  searchConfig.minScore = qBound(0.0, setting("Vision/TrackingMinScore").toDouble(), 1.0);
+  MatchPassConfig matchConfig;
+  matchConfig.fastMinScore = qBound(0.0, setting("Vision/FastMinScore").toDouble(), 1.0);
+  matchConfig.preciseMinScore = qBound(0.0, setting("Vision/PreciseMinScore").toDouble(), 1.0);
+  matchConfig.speculative = setting("Vision/SpeculativeMatching").toBool();
+  matchConfig.acceptScore = qBound(0.0, setting("Vision/SpeculativeAcceptScore").toDouble(), 1.0);
+  matchConfig.preciseTimeoutMs = qMax(0, setting("Vision/PreciseTimeoutMs").toInt());
+  bool latencyProfiling = setting("Vision/LatencyProfiling").toBool();
+  int latencyReportInterval = setting("Vision/LatencyReportInterval").toInt();
+  HotFolderConfig hotFolderConfig;
+  hotFolderConfig.enabled = setting("Vision/HotFolderEnabled").toBool();
+  hotFolderConfig.folder = setting("Vision/HotFolderPath").toString();
+  hotFolderConfig.journalPath = setting("Vision/HotFolderJournal").toString();
+  hotFolderConfig.settleMs = qBound(0, setting("Vision/HotFolderSettleMs").toInt(), 60000);
+  hotFolderConfig.rescanIntervalMs = qMax(0, setting("Vision/HotFolderRescanMs").toInt());
+  hotFolderConfig.processExisting = setting("Vision/HotFolderProcessExisting").toBool();
+  hotFolderConfig.maxDecodeAttempts = qBound(1, setting("Vision/HotFolderDecodeAttempts").toInt(), 100);
+  ImageWriterConfig writerConfig;
+  writerConfig.enabled = setting("Vision/ImageSaveEnabled").toBool();
+  writerConfig.rootDir = setting("Vision/ImageSavePath").toString();
+  if (writerConfig.rootDir.isEmpty())
+  {
+    writerConfig.rootDir = QApplication::applicationDirPath() + "/result_images";
+  }
+  writerConfig.policy = ImageWriterService::policyFromString(setting("Vision/ImageSavePolicy").toString());
+  writerConfig.sampleInterval = qMax(1, setting("Vision/ImageSaveSampleInterval").toInt());
+  writerConfig.ngOptions.format = setting("Vision/ImageSaveNgFormat").toString();
+  writerConfig.okOptions.format = setting("Vision/ImageSaveOkFormat").toString();
+  writerConfig.ngOptions.compression = setting("Vision/ImageSaveCompression").toInt();
+  writerConfig.okOptions.compression = writerConfig.ngOptions.compression;
+  writerConfig.encoderThreads = qBound(1, setting("Vision/ImageSaveThreads").toInt(), 16);
+  writerConfig.queueCapacity = qBound(1, setting("Vision/ImageSaveQueue").toInt(), 4096);
+  writerConfig.minFreeBytes = qMax<qint64>(0, setting("Vision/ImageSaveMinFreeMB").toLongLong()) * 1024 * 1024;
+  writerConfig.useArchive = setting("Vision/ImageArchiveEnabled").toBool();
+  writerConfig.archive.directory = setting("Vision/ImageArchivePath").toString();
+  writerConfig.archive.maxSegmentBytes = qMax<qint64>(16, setting("Vision/ImageArchiveSegmentMB").toLongLong()) * 1024 * 1024;
+  writerConfig.archive.maxTotalBytes = qMax<qint64>(0, setting("Vision/ImageArchiveMaxGB").toLongLong()) * 1024 * 1024 * 1024;
+  writerConfig.archive.retentionDays = qMax(0, setting("Vision/ImageArchiveRetentionDays").toInt());
+  writerConfig.archive.compressionLevel = qBound(0, setting("Vision/ImageArchiveCompression").toInt(), 9);
+  m_templatePreload = setting("Vision/TemplatePreload").toBool();
+  int templateLoadThreads = qBound(0, setting("Vision/TemplateLoadThreads").toInt(), 64);
+  m_recipeDir = setting("Vision/RecipeDir").toString();
+
+  LOG_INFO(SYSTEM, QString("检测线程数: %1, 预读数量: %2").arg(workerCount).arg(prefetchDepth));
+  m_visualWorkThread->setInspectionWorkerCount(workerCount);
+  m_visualWorkThread->setPrefetchDepth(prefetchDepth);
+
+  LOG_INFO(SYSTEM, QString("显示帧通道: 容量=%1, 策略=%2")
+           .arg(channelCapacity).arg(FrameChannel::policyToString(dropPolicy)));
+  m_visualWorkThread->frameChannel()->setCapacity(channelCapacity);
+  m_visualWorkThread->frameChannel()->setDropPolicy(dropPolicy);
+
+  LOG_INFO(SYSTEM, QString("跟踪搜索: %1, 半径=%2 px, 角度=±%3°, 放大次数=%4, 最低得分=%5")
+           .arg(searchConfig.enabled ? "开启" : "关闭").arg(searchConfig.radius)
+           .arg(qRadiansToDegrees(searchConfig.angleExtent), 0, 'f', 1)
+           .arg(searchConfig.widenSteps).arg(searchConfig.minScore));
+  m_visualWorkThread->setSearchWindowConfig(searchConfig);
+
+  LOG_INFO(SYSTEM, QString("全图匹配: 快速最低得分=%1, 精确最低得分=%2, 投机模式=%3, 接受得分=%4, 精确超时=%5 ms")
+           .arg(matchConfig.fastMinScore).arg(matchConfig.preciseMinScore)
+           .arg(matchConfig.speculative ? "开启" : "关闭")
+           .arg(matchConfig.acceptScore).arg(matchConfig.preciseTimeoutMs));
+  m_visualWorkThread->setMatchPassConfig(matchConfig);
+
+  LOG_INFO(SYSTEM, QString("检测耗时统计: %1, 摘要间隔=%2 s")
+           .arg(latencyProfiling ? "开启" : "关闭").arg(latencyReportInterval));
+  LatencyProfiler::instance().setReportInterval(latencyReportInterval);
+  LatencyProfiler::instance().setEnabled(latencyProfiling);
+
+  LOG_INFO(SYSTEM, QString("监视目录模式: %1, 目录=%2, 稳定时间=%3 ms, 补扫间隔=%4 ms")
+           .arg(hotFolderConfig.enabled ? "开启" : "关闭")
+           .arg(hotFolderConfig.folder.isEmpty() ? QString("img") : hotFolderConfig.folder)
+           .arg(hotFolderConfig.settleMs).arg(hotFolderConfig.rescanIntervalMs));
+  m_visualWorkThread->setHotFolderConfig(hotFolderConfig);
+
+  LOG_INFO(SYSTEM, QString("图像保存: %1, 目录=%2, 策略=%3, 格式=NG:%4/OK:%5, 编码线程=%6, 队列=%7, 最低剩余空间=%8 MB")
+           .arg(writerConfig.enabled ? "开启" : "关闭").arg(writerConfig.rootDir)
+           .arg(ImageWriterService::policyToString(writerConfig.policy))
+           .arg(writerConfig.ngOptions.format).arg(writerConfig.okOptions.format)
+           .arg(writerConfig.encoderThreads).arg(writerConfig.queueCapacity)
+           .arg(writerConfig.minFreeBytes / (1024 * 1024)));
+  LOG_INFO(SYSTEM, QString("图像归档: %1, 目录=%2, 段文件上限=%3 MB, 总大小上限=%4 GB, 保留天数=%5, 压缩级别=%6")
+           .arg(writerConfig.useArchive ? "开启" : "关闭")
+           .arg(writerConfig.archive.directory.isEmpty() ? writerConfig.rootDir + "/archive" : writerConfig.archive.directory)
+           .arg(writerConfig.archive.maxSegmentBytes / (1024 * 1024))
+           .arg(writerConfig.archive.maxTotalBytes / (1024LL * 1024 * 1024))
+           .arg(writerConfig.archive.retentionDays).arg(writerConfig.archive.compressionLevel));
+  LOG_INFO(SYSTEM, QString("模板预加载: %1, 加载线程数=%2, 产品配方=%3")
+           .arg(m_templatePreload ? "开启" : "关闭")
+           .arg(templateLoadThreads > 0 ? QString::number(templateLoadThreads) : QString("自动"))
+           .arg(m_recipeDir.isEmpty() ? QString("默认") : m_recipeDir));
+  m_visualWorkThread->templateCache()->setLoadThreads(templateLoadThreads);
+
+  // 保存服务始终启动：检测结果保存受 enabled 控制，界面上的手动保存/导出也经此在后台写盘
+  ImageWriterService* writer = m_visualWorkThread->imageWriter();
+  writer->setConfig(writerConfig);
+  writer->start();
+  HalconLable::ImageWriteHandler writeHandler = [writer](const HObject& image, const QString& filePath)
+  {
+    return writer->submit(image, filePath);
+  };
+  leftHal->setImageWriteHandler(writeHandler);
+  rightHal->setImageWriteHandler(writeHandler);
+}
+
 void Mainwindow::appLogInfo(const QString& message, Level level)
 {
   // 创建新的列表项
@@ -756,6 +969,12 @@ void Mainwindow::on_vision_process_toolBtn_clicked()
       {
         m_isVisionConfigOpen = true;
         m_visualProcess = new VisualProcess();
+        if (m_visualWorkThread != nullptr)
+        {
+          ImageWriterService* writer = m_visualWorkThread->imageWriter();
+          m_visualProcess->imageView()->setImageWriteHandler(
+              [writer](const HObject& image, const QString& filePath) { return writer->submit(image, filePath); });
+        }
         m_visualProcess->setWindowTitle(tr("视觉处理配置"));
         m_visualProcess->setWindowFlag(Qt::WindowStaysOnTopHint,
                                        true); // 置顶
@@ -793,6 +1012,33 @@ void Mainwindow::on_vision_process_toolBtn_clicked()
   }
 }
 
+void Mainwindow::on_offerings_config_toolBtn_clicked()
+{
+  if (m_visualWorkThread == nullptr)
+  {
+    return;
+  }
+  // 配方目录结构与 config 目录相同（models/DetectionModel、halconParams/...）
+  QString startDir = m_recipeDir.isEmpty() ? QApplication::applicationDirPath() + "/config" : m_recipeDir;
+  QString recipeDir = QFileDialog::getExistingDirectory(this, tr("选择产品配方目录"), startDir);
+  if (recipeDir.isEmpty() || recipeDir == m_recipeDir)
+  {
+    return;
+  }
+
+  // 新配方在后台加载，全部成功后才替换；结果经 templatesReady 写入界面日志
+  m_recipeDir = recipeDir;
+  m_visualWorkThread->switchRecipe(recipeDir);
+  appLogInfo(tr("🔄 正在切换产品配方: %1").arg(recipeDir));
+
+  // 串口配置等也经同一配置管理器读写，写入前重新指向视觉配置文件
+  if (m_settingManager != nullptr && m_settingManager->init(visionSettingsPath()))
+  {
+    m_settingManager->setValue("Vision/RecipeDir", recipeDir);
+  }
+  LOG_INFO(SYSTEM, QString("切换产品配方: %1").arg(recipeDir));
+}
+
 void Mainwindow::on_serialPort_config_toolBtn_clicked()
 {
   try
@@ -856,6 +1102,14 @@ void Mainwindow::on_start_toolBtn_clicked()
 {
   try
   {
+    // 监视目录模式下再次点击停止监视，已送入流水线的图像处理完后任务结束
+    if (m_visualWorkThread->isHotFolderActive())
+    {
+      m_visualWorkThread->stopHotFolder();
+      appLogInfo("⏹️ 已停止监视图像目录");
+      return;
+    }
+
     // 然后启动基础的视觉处理
     QMetaObject::invokeMethod(m_visualWorkThread, "process", Qt::QueuedConnection);
 
@@ -869,11 +1123,46 @@ void Mainwindow::on_start_toolBtn_clicked()
 
 /* ============================== 基础的视觉工作线程槽函数 ============================== */
 
+void Mainwindow::onFrameAvailable()
+{
+  DisplayFrame frame;
+  if (!m_visualWorkThread->frameChannel()->takeLatest(frame))
+  {
+    return; // 已被之前的通知取走
+  }
+
+  // 图像和显示对象作为一个整体显示（原子操作，只渲染一次）
+  if (frame.image.IsInitialized())
+  {
+    QList<DisplayOverlay> overlays;
+    overlays.reserve(frame.displayObjects.size());
+    for (const auto& dispObj : frame.displayObjects)
+    {
+      overlays.append(DisplayOverlay(dispObj.object, DisplayStyle(dispObj.color, dispObj.lineWidth)));
+    }
+    rightHal->showImageWithOverlays(frame.image, overlays);
+  }
+  else
+  {
+    rightHal->clearDisplayObjectsOnly();
+    LOG_WARNING(SYSTEM, "收到未初始化的图像，无法显示");
+  }
+  // 测量结果文本只为实际显示的帧生成
+  QString message = frame.message.isEmpty() ? measurementMessage(frame.record) : frame.message;
+  if (!message.isEmpty())
+  {
+    rightHal->dispHalconMessage(20, 20, message, "green");
+  }
+}
+
 void Mainwindow::onWorkThreadFinished()
 {
   try
   {
+    // 先显示通道中剩余的最后一帧，再显示完成信息
+    onFrameAvailable();
     appLogInfo("🎉 视觉处理任务完成");
+    appLogInfo(QString("🖥️ 显示通道: %1").arg(m_visualWorkThread->frameChannel()->statsSummary()));
 
     // 更新UI状态
     ui->start_toolBtn->setEnabled(true);
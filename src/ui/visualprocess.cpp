@@ -10,6 +10,7 @@
 #include "../thirdparty/log_manager/inc/simplecategorylogger.h"
 #include "../thirdparty/dynamic_ui/include/DynamicUIBuilder.h"
 #include "../thirdparty/config/inc/config_manager.h"
+#include "../inc/thread/InspectionRecipe.h"
 
 /*========================================  End  ===============================================*/
 
@@ -149,6 +150,13 @@ VisualProcess::~VisualProcess()
   delete ui;
 }
 
+/*============================= 公有接口 ============================*/
+// 获取图像显示控件
+HalconLable* VisualProcess::imageView() const
+{
+  return halWin;
+}
+
 /*============================= 初始化 ============================*/
 // 初始化视觉处理
 void VisualProcess::initVisionProcess()
@@ -160,6 +168,12 @@ void VisualProcess::initVisionProcess()
     clearLaout(ui->gridLayout_ImageDisplay);
     ui->gridLayout_ImageDisplay->addWidget(halWin, 0, 0);
 
+    // ↩️ 撤销/重做替换图像后同步当前图像
+    connect(halWin, &HalconLable::editHistoryImageChanged, this, [this](HObject image)
+    {
+      m_Img = image;
+    });
+
     // 🎯 强制触发初始化，确保Halcon窗口正确创建
     QTimer::singleShot(100, [this]()
     {
@@ -842,6 +856,24 @@ void VisualProcess::handleToolButtonClicked(const QString& key)
         // 📊 显示图像信息
         QString imageInfo = halWin->getImageInfo();
         appLog(tr("📊 %1").arg(imageInfo));
+
+        // 🔍 二维码模式：读取后直接识别（多增益并行识别），结果显示并写入历史
+        if (m_QCodeCam_flag && m_Data_code_handle.Length() > 0)
+        {
+          CodeData code = halWin->QtRecogied(m_Img, m_Data_code_handle, 1, QStringLiteral("visualprocess_local"));
+          VisualProcessResult result;
+          result.taskType = "QRCode";
+          result.success = !code.codestring.isEmpty();
+          result.errorMessage = result.success ? QString() : tr("未识别到二维码");
+          result.processTime = QDateTime::currentDateTime();
+          result.decodedTexts = code.codestring;
+          if (result.success)
+          {
+            halWin->showHalconObject(code.codeobj, "green", 2);
+          }
+          displayProcessingResult(result);
+          updateResultHistory(result);
+        }
       }
       else
       {
@@ -1502,14 +1534,25 @@ void VisualProcess::handleToolButtonClicked(const QString& key)
     enhanceLayout->addWidget(brightnessBtn);
     layout->addWidget(enhanceGroup);
 
+    // 添加撤销/重做按钮
+    QGroupBox* historyGroup = new QGroupBox(tr("↩️ 编辑历史"), preprocessDialog);
+    QHBoxLayout* historyLayout = new QHBoxLayout(historyGroup);
+
+    QPushButton* undoBtn = new QPushButton(tr("↩️ 撤销"), historyGroup);
+    QPushButton* redoBtn = new QPushButton(tr("↪️ 重做"), historyGroup);
+
+    historyLayout->addWidget(undoBtn);
+    historyLayout->addWidget(redoBtn);
+    layout->addWidget(historyGroup);
+
     // 连接按钮事件
     connect(gaussBtn, &QPushButton::clicked, [this]()
     {
       HObject filteredImg = halWin->applyGaussianFilter(m_Img, 1.5);
       if (filteredImg.IsInitialized())
       {
+        halWin->applyImageEdit(filteredImg, tr("高斯滤波"));
         m_Img = filteredImg;
-        halWin->showImage(m_Img);
         appLog(tr("✅ 高斯滤波应用成功"));
       }
     });
@@ -1519,8 +1562,8 @@ void VisualProcess::handleToolButtonClicked(const QString& key)
       HObject filteredImg = halWin->applyMedianFilter(m_Img, "circle", 3.0);
       if (filteredImg.IsInitialized())
       {
+        halWin->applyImageEdit(filteredImg, tr("中值滤波"));
         m_Img = filteredImg;
-        halWin->showImage(m_Img);
         appLog(tr("✅ 中值滤波应用成功"));
       }
     });
@@ -1530,8 +1573,8 @@ void VisualProcess::handleToolButtonClicked(const QString& key)
       HObject enhancedImg = halWin->adjustImageContrast(m_Img, 1.3);
       if (enhancedImg.IsInitialized())
       {
+        halWin->applyImageEdit(enhancedImg, tr("对比度调整"));
         m_Img = enhancedImg;
-        halWin->showImage(m_Img);
         appLog(tr("✅ 对比度调整成功"));
       }
     });
@@ -1541,12 +1584,38 @@ void VisualProcess::handleToolButtonClicked(const QString& key)
       HObject enhancedImg = halWin->adjustImageBrightness(m_Img, 20.0);
       if (enhancedImg.IsInitialized())
       {
+        halWin->applyImageEdit(enhancedImg, tr("亮度调整"));
         m_Img = enhancedImg;
-        halWin->showImage(m_Img);
         appLog(tr("✅ 亮度调整成功"));
       }
     });
 
+    connect(undoBtn, &QPushButton::clicked, [this]()
+    {
+      QString label = halWin->editHistory().undoLabel();
+      if (halWin->undoLastOperation())
+      {
+        appLog(tr("↩️ 已撤销：%1").arg(label));
+      }
+      else
+      {
+        appLog(tr("⚠️ 没有可撤销的操作"), WARNING);
+      }
+    });
+
+    connect(redoBtn, &QPushButton::clicked, [this]()
+    {
+      QString label = halWin->editHistory().redoLabel();
+      if (halWin->redoOperation())
+      {
+        appLog(tr("↪️ 已重做：%1").arg(label));
+      }
+      else
+      {
+        appLog(tr("⚠️ 没有可重做的操作"), WARNING);
+      }
+    });
+
     preprocessDialog->show();
   }
   else if (key == tr("⚡ 快捷操作"))
@@ -3100,6 +3169,12 @@ bool VisualProcess::validateTaskParams(const VisualTaskParams& params, QString&
       errorMessage = tr("边缘阈值设置无效");
       return false;
     }
+    QString recipeError = params.parameters.value("recipeError").toString();
+    if (!recipeError.isEmpty() || (!params.recipe.isEmpty() && !InspectionPlan::validate(params.recipe, recipeError)))
+    {
+      errorMessage = tr("检测配方无效：%1").arg(recipeError);
+      return false;
+    }
   }
   else if (params.taskType == "Detection")
   {
@@ -3292,6 +3367,15 @@ VisualTaskParams VisualProcess::extractMeasureParams() const
       params.modelPath = basePath + params.templateName + "_measure_params.tup";
     }
 
+    // 📋 检测配方：工作线程加载模板时编译为执行计划，文件不存在时为默认配方
+    params.recipePath = QApplication::applicationDirPath() + "/config/halconParams/recipe.json";
+    QString recipeError;
+    params.recipe = InspectionPlan::loadRecipe(params.recipePath, recipeError);
+    if (params.recipe.isEmpty())
+    {
+      params.parameters["recipeError"] = recipeError;
+    }
+
     params.isValid = true;
 
   }
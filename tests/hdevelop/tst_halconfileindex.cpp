@@ -0,0 +1,202 @@
+//
+// 持久化目录文件索引测试 | Persistent directory file index tests
+//
+// 缓存沿用、按目录修改时间增量重新列出、变化通知后的子树删除
+// Cache reuse, incremental relisting by directory time, subtree removal after a change notification
+//
+
+#include "../../thirdparty/hdevelop/include/HalconFileIndex.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <memory>
+
+class TestHalconFileIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void buildsAndQueries();
+    void reusesCachedDirectories();
+    void relistsOnlyChangedDirectories();
+    void removesDeletedSubtree();
+    void removeFileDropsEntry();
+
+private:
+    QString rootPath() const { return m_directory->path() + "/root"; }
+    QString cachePath() const { return m_directory->path() + "/cache/index.idx"; }
+    std::unique_ptr<HalconFileIndex> createIndex() const;
+    QSet<QString> fileNames(const HalconFileIndex& index, const QString& underPath = QString()) const;
+    static void writeFile(const QString& path, const QByteArray& content);
+
+    std::unique_ptr<QTemporaryDir> m_directory;
+};
+
+// root: a.hobj, notes.txt; root/models: m.shm; root/models/old: o.shm; root/regions: r.hobj
+void TestHalconFileIndex::init()
+{
+    m_directory.reset(new QTemporaryDir());
+    QVERIFY(m_directory->isValid());
+    QVERIFY(QDir().mkpath(rootPath() + "/models/old"));
+    QVERIFY(QDir().mkpath(rootPath() + "/regions"));
+    writeFile(rootPath() + "/a.hobj", "a");
+    writeFile(rootPath() + "/notes.txt", "notes");
+    writeFile(rootPath() + "/models/m.shm", "model");
+    writeFile(rootPath() + "/models/old/o.shm", "old");
+    writeFile(rootPath() + "/regions/r.hobj", "region");
+}
+
+std::unique_ptr<HalconFileIndex> TestHalconFileIndex::createIndex() const
+{
+    auto resolver = [](const QString& fileName) {
+        return fileName.endsWith(".txt") ? QString() : QString("object");
+    };
+    std::unique_ptr<HalconFileIndex> index(new HalconFileIndex(rootPath(), resolver));
+    index->setCachePath(cachePath());
+    index->setWalkerThreads(2);
+    return index;
+}
+
+QSet<QString> TestHalconFileIndex::fileNames(const HalconFileIndex& index, const QString& underPath) const
+{
+    QSet<QString> names;
+    index.forEachFile(underPath, [&names](const HalconFileEntry& entry) {
+        names.insert(entry.fileName);
+    });
+    return names;
+}
+
+void TestHalconFileIndex::writeFile(const QString& path, const QByteArray& content)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), qint64(content.size()));
+}
+
+void TestHalconFileIndex::buildsAndQueries()
+{
+    std::unique_ptr<HalconFileIndex> index = createIndex();
+    QVERIFY(index->open());
+
+    const HalconFileIndexStats stats = index->stats();
+    QVERIFY(!stats.loadedFromCache);
+    QCOMPARE(stats.directories, 4);
+    QCOMPARE(stats.files, 5);
+    QCOMPARE(stats.rescannedDirectories, 4);
+
+    QCOMPARE(fileNames(*index), QSet<QString>({"a.hobj", "notes.txt", "m.shm", "o.shm", "r.hobj"}));
+    QCOMPARE(fileNames(*index, rootPath() + "/models"), QSet<QString>({"m.shm", "o.shm"}));
+    QCOMPARE(fileNames(*index, rootPath() + "/missing"), QSet<QString>());
+
+    index->forEachFile(rootPath() + "/models/old", [this](const HalconFileEntry& entry) {
+        QCOMPARE(entry.path, rootPath() + "/models/old/o.shm");
+        QCOMPARE(entry.suffix, QString("shm"));
+        QCOMPARE(entry.fileType, QString("object"));
+        QCOMPARE(entry.size, qint64(3));
+    });
+    index->forEachFile(rootPath(), [](const HalconFileEntry& entry) {
+        if (entry.fileName == "notes.txt") {
+            QVERIFY(entry.fileType.isEmpty());
+        }
+    });
+}
+
+// 缓存中修改时间未变的目录直接沿用，不重新列出
+void TestHalconFileIndex::reusesCachedDirectories()
+{
+    {
+        std::unique_ptr<HalconFileIndex> index = createIndex();
+        QVERIFY(index->open());
+        QVERIFY(QFile::exists(cachePath()));
+    }
+
+    std::unique_ptr<HalconFileIndex> index = createIndex();
+    QVERIFY(index->open());
+    const HalconFileIndexStats stats = index->stats();
+    QVERIFY(stats.loadedFromCache);
+    QCOMPARE(stats.rescannedDirectories, 0);
+    QCOMPARE(stats.directories, 4);
+    QCOMPARE(fileNames(*index), QSet<QString>({"a.hobj", "notes.txt", "m.shm", "o.shm", "r.hobj"}));
+
+    // 缓存不重新 stat 文件，类型仍由解析函数按文件名给出
+    index->forEachFile(rootPath() + "/regions", [](const HalconFileEntry& entry) {
+        QCOMPARE(entry.fileType, QString("object"));
+        QCOMPARE(entry.size, qint64(6));
+    });
+}
+
+// 只有增删过文件的目录重新列出：打开时校验缓存和未监视时的查询前校验
+void TestHalconFileIndex::relistsOnlyChangedDirectories()
+{
+    {
+        std::unique_ptr<HalconFileIndex> index = createIndex();
+        QVERIFY(index->open());
+    }
+    writeFile(rootPath() + "/models/n.shm", "new");
+
+    std::unique_ptr<HalconFileIndex> index = createIndex();
+    index->setMaxWatchedDirectories(0);
+    index->setRevalidateInterval(0);
+    QVERIFY(index->open());
+    QVERIFY(index->stats().loadedFromCache);
+    QCOMPARE(index->stats().rescannedDirectories, 1);
+    QCOMPARE(index->stats().watchedDirectories, 0);
+    QCOMPARE(fileNames(*index, rootPath() + "/models"), QSet<QString>({"m.shm", "n.shm", "o.shm"}));
+
+    QSignalSpy changed(index.get(), &HalconFileIndex::indexChanged);
+    QVERIFY(QFile::remove(rootPath() + "/regions/r.hobj"));
+    QVERIFY(QDir().mkpath(rootPath() + "/regions/sub"));
+    writeFile(rootPath() + "/regions/sub/s.hobj", "sub");
+    index->refresh();
+    QCOMPARE(changed.count(), 1);
+    // regions 重新列出，新目录 sub 不在缓存中也需要列出
+    QCOMPARE(index->stats().rescannedDirectories, 2);
+    QCOMPARE(index->stats().directories, 5);
+    QCOMPARE(fileNames(*index, rootPath() + "/regions"), QSet<QString>({"s.hobj"}));
+
+    index->refresh();
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(index->stats().rescannedDirectories, 0);
+}
+
+// 监视模式：删除子目录树后，上级目录的变化通知移除整个子树
+void TestHalconFileIndex::removesDeletedSubtree()
+{
+    std::unique_ptr<HalconFileIndex> index = createIndex();
+    QVERIFY(index->open());
+    QCOMPARE(index->stats().watchedDirectories, 4);
+
+    QSignalSpy changed(index.get(), &HalconFileIndex::indexChanged);
+    QVERIFY(QDir(rootPath() + "/models").removeRecursively());
+    QTRY_VERIFY(changed.count() > 0);
+
+    QTRY_COMPARE(index->stats().directories, 2);
+    QCOMPARE(fileNames(*index), QSet<QString>({"a.hobj", "notes.txt", "r.hobj"}));
+    QCOMPARE(fileNames(*index, rootPath() + "/models/old"), QSet<QString>());
+    QVERIFY(index->stats().incrementalUpdates > 0);
+    QCOMPARE(index->stats().watchedDirectories, 2);
+
+    // 新建的目录树由上级目录的变化通知发现
+    QVERIFY(QDir().mkpath(rootPath() + "/models/new"));
+    writeFile(rootPath() + "/models/new/x.shm", "x");
+    QTRY_COMPARE(fileNames(*index, rootPath() + "/models"), QSet<QString>({"x.shm"}));
+}
+
+void TestHalconFileIndex::removeFileDropsEntry()
+{
+    std::unique_ptr<HalconFileIndex> index = createIndex();
+    QVERIFY(index->open());
+    index->removeFile(rootPath() + "/models/../models/m.shm");
+    QCOMPARE(fileNames(*index, rootPath() + "/models"), QSet<QString>({"o.shm"}));
+    index->removeFile(rootPath() + "/missing/m.shm");
+    QCOMPARE(index->stats().files, 4);
+}
+
+QTEST_GUILESS_MAIN(TestHalconFileIndex)
+
+#include "tst_halconfileindex.moc"
@@ -0,0 +1,76 @@
+//
+// Halcon文件管理器清理测试 | Halcon file manager cleanup tests
+//
+// 索引中的修改时间可能过期：清理旧文件前须重新检查磁盘上的文件
+// Index times can be stale: cleanup must re-check each file on disk before removing it
+//
+
+#include "../../thirdparty/hdevelop/include/HalconFileManager.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class TestHalconFileManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupRechecksIndexedFiles();
+
+private:
+    static void writeFile(const QString& path, const QByteArray& content, const QDateTime& modified);
+};
+
+void TestHalconFileManager::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true); // 索引缓存写入测试目录
+}
+
+void TestHalconFileManager::writeFile(const QString& path, const QByteArray& content, const QDateTime& modified)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), qint64(content.size()));
+    QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+}
+
+// 建立索引后：rewritten.hobj 被原地改写（目录修改时间不变），gone.hobj 被外部删除
+void TestHalconFileManager::cleanupRechecksIndexedFiles()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString root = directory.path();
+    const QDateTime old = QDateTime::currentDateTime().addDays(-60);
+    writeFile(root + "/stale.hobj", "stale", old);
+    writeFile(root + "/rewritten.hobj", "before", old);
+    writeFile(root + "/gone.hobj", "gone", old);
+    writeFile(root + "/stale.txt", "text", old);
+
+    HalconFileManager manager;
+    QVERIFY(manager.fileIndex(root) != nullptr);
+    QCOMPARE(manager.getAllHalconFiles(root).size(), 3);
+
+    {
+        QFile file(root + "/rewritten.hobj");
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QCOMPARE(file.write("after!"), qint64(6));
+    }
+    QVERIFY(QFile::remove(root + "/gone.hobj"));
+
+    QVERIFY(manager.cleanupOldFiles(root, 30));
+    QVERIFY(!QFile::exists(root + "/stale.hobj"));
+    QVERIFY(QFile::exists(root + "/rewritten.hobj"));
+    QVERIFY(QFile::exists(root + "/stale.txt")); // 非Halcon文件不清理
+
+    const QStringList remaining = manager.getAllHalconFiles(root);
+    QCOMPARE(remaining, QStringList() << QDir(root).absoluteFilePath("rewritten.hobj"));
+    QVERIFY(!manager.cleanupOldFiles(root, 30));
+}
+
+QTEST_GUILESS_MAIN(TestHalconFileManager)
+
+#include "tst_halconfilemanager.moc"
@@ -0,0 +1,240 @@
+/**
+ * @file tst_boundedqueue.cpp
+ * @brief 有界阻塞队列测试 | BoundedQueue close, tryPush and statistics tests
+ */
+
+#include "../../inc/thread/BoundedQueue.h"
+
+#include <QtTest>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// 等待足够长的时间，让另一线程进入阻塞等待
+void settle()
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+}
+
+class TestBoundedQueue : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void fifoOrderAndStats();
+  void tryPushFailsWhenFull();
+  void closeDrainsRemainingItems();
+  void closeWakesBlockedConsumer();
+  void closeWakesBlockedProducer();
+  void popUnblocksProducer();
+  void clearDropsItems();
+  void concurrentProducersAndConsumers();
+};
+
+void TestBoundedQueue::fifoOrderAndStats()
+{
+  BoundedQueue<int> queue(3);
+  QCOMPARE(queue.capacity(), 3);
+  QVERIFY(queue.push(1));
+  QVERIFY(queue.push(2));
+  QVERIFY(queue.push(3));
+  QCOMPARE(queue.size(), 3);
+
+  int item = 0;
+  for (int expected = 1; expected <= 3; ++expected)
+  {
+    QVERIFY(queue.pop(item));
+    QCOMPARE(item, expected);
+  }
+
+  // 入队时深度为 1、2、3
+  const BoundedQueueStats stats = queue.stats();
+  QCOMPARE(stats.capacity, 3);
+  QCOMPARE(stats.depth, 0);
+  QCOMPARE(stats.maxDepth, 3);
+  QCOMPARE(stats.avgDepth, 2.0);
+  QCOMPARE(stats.pushed, quint64(3));
+  QCOMPARE(stats.popped, quint64(3));
+  QCOMPARE(stats.pushWaitMs, 0.0);
+}
+
+void TestBoundedQueue::tryPushFailsWhenFull()
+{
+  BoundedQueue<int> queue(0); // 容量至少为1
+  QCOMPARE(queue.capacity(), 1);
+  QVERIFY(queue.tryPush(1));
+  QVERIFY(!queue.tryPush(2));
+  QCOMPARE(queue.stats().pushed, quint64(1));
+
+  int item = 0;
+  QVERIFY(queue.pop(item));
+  QCOMPARE(item, 1);
+  QVERIFY(queue.tryPush(3));
+  queue.close();
+  QVERIFY(!queue.tryPush(4));
+  QCOMPARE(queue.stats().pushed, quint64(2));
+}
+
+// 关闭后不再入队，已入队的元素仍可取出
+void TestBoundedQueue::closeDrainsRemainingItems()
+{
+  BoundedQueue<int> queue(4);
+  QVERIFY(queue.push(1));
+  QVERIFY(queue.push(2));
+  queue.close();
+  QVERIFY(queue.isClosed());
+  QVERIFY(!queue.push(3));
+
+  int item = 0;
+  QVERIFY(queue.pop(item));
+  QCOMPARE(item, 1);
+  QVERIFY(queue.pop(item));
+  QCOMPARE(item, 2);
+  QVERIFY(!queue.pop(item));
+  QCOMPARE(queue.stats().pushed, quint64(2));
+}
+
+void TestBoundedQueue::closeWakesBlockedConsumer()
+{
+  BoundedQueue<int> queue(2);
+  std::atomic<bool> finished{false};
+  bool popped = true;
+  std::thread consumer([&]()
+  {
+    int item = 0;
+    popped = queue.pop(item);
+    finished = true;
+  });
+  settle();
+  QVERIFY(!finished);
+
+  queue.close();
+  consumer.join();
+  QVERIFY(!popped);
+  QVERIFY(queue.stats().popWaitMs > 0.0);
+}
+
+void TestBoundedQueue::closeWakesBlockedProducer()
+{
+  BoundedQueue<int> queue(1);
+  QVERIFY(queue.push(1));
+  std::atomic<bool> finished{false};
+  bool pushed = true;
+  std::thread producer([&]()
+  {
+    pushed = queue.push(2);
+    finished = true;
+  });
+  settle();
+  QVERIFY(!finished);
+
+  queue.close();
+  producer.join();
+  QVERIFY(!pushed);
+  QCOMPARE(queue.size(), 1);
+  QVERIFY(queue.stats().pushWaitMs > 0.0);
+}
+
+void TestBoundedQueue::popUnblocksProducer()
+{
+  BoundedQueue<int> queue(1);
+  QVERIFY(queue.push(1));
+  std::atomic<bool> finished{false};
+  std::thread producer([&]()
+  {
+    queue.push(2);
+    finished = true;
+  });
+  settle();
+  QVERIFY(!finished);
+
+  int item = 0;
+  QVERIFY(queue.pop(item));
+  QCOMPARE(item, 1);
+  producer.join();
+  QVERIFY(queue.pop(item));
+  QCOMPARE(item, 2);
+  QCOMPARE(queue.stats().maxDepth, 1);
+}
+
+void TestBoundedQueue::clearDropsItems()
+{
+  BoundedQueue<int> queue(2);
+  QVERIFY(queue.push(1));
+  QVERIFY(queue.push(2));
+  queue.clear();
+  QCOMPARE(queue.size(), 0);
+  QVERIFY(queue.tryPush(3));
+  int item = 0;
+  QVERIFY(queue.pop(item));
+  QCOMPARE(item, 3);
+}
+
+// 多生产者、多消费者：每个元素恰好取出一次
+void TestBoundedQueue::concurrentProducersAndConsumers()
+{
+  BoundedQueue<int> queue(8);
+  const int producerCount = 4;
+  const int itemsPerProducer = 5000;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < producerCount; ++p)
+  {
+    producers.emplace_back([&queue, p]()
+    {
+      for (int i = 0; i < itemsPerProducer; ++i)
+      {
+        queue.push(p * itemsPerProducer + i);
+      }
+    });
+  }
+
+  std::vector<std::vector<int>> received(2);
+  std::vector<std::thread> consumers;
+  for (std::vector<int>& items : received)
+  {
+    consumers.emplace_back([&queue, &items]()
+    {
+      int item = 0;
+      while (queue.pop(item))
+      {
+        items.push_back(item);
+      }
+    });
+  }
+
+  for (std::thread& producer : producers)
+  {
+    producer.join();
+  }
+  queue.close();
+  for (std::thread& consumer : consumers)
+  {
+    consumer.join();
+  }
+
+  std::vector<int> seen(producerCount * itemsPerProducer, 0);
+  for (const std::vector<int>& items : received)
+  {
+    for (int item : items)
+    {
+      ++seen[item];
+    }
+  }
+  for (int count : seen)
+  {
+    QCOMPARE(count, 1);
+  }
+  const BoundedQueueStats stats = queue.stats();
+  QCOMPARE(stats.pushed, quint64(producerCount * itemsPerProducer));
+  QCOMPARE(stats.popped, stats.pushed);
+  QVERIFY(stats.maxDepth <= 8);
+}
+
+QTEST_APPLESS_MAIN(TestBoundedQueue)
+
+#include "tst_boundedqueue.moc"
@@ -0,0 +1,236 @@
+/**
+ * @file tst_framechannel.cpp
+ * @brief 有界帧通道丢弃策略、合并通知与关闭测试 | Frame channel drop policy, coalesced notify and close tests
+ *
+ * 帧只携带序号，不调用Halcon算子。
+ */
+
+#include "../../inc/thread/FrameChannel.h"
+
+#include <QSignalSpy>
+#include <QtTest>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+DisplayFrame makeFrame(qint64 sequence)
+{
+  DisplayFrame frame;
+  frame.sequence = sequence;
+  return frame;
+}
+
+// 等待足够长的时间，让另一线程进入阻塞等待
+void settle()
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+}
+
+class TestFrameChannel : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void dropOldestKeepsNewestFrames();
+  void dropNewestRejectsWhenFull();
+  void blockWaitsForConsumer();
+  void closeWakesBlockedProducer();
+  void coalescesNotifications();
+  void capacityReductionDropsOldest();
+  void resetReopensAndClearsStats();
+  void policyStringRoundTrip();
+};
+
+void TestFrameChannel::dropOldestKeepsNewestFrames()
+{
+  FrameChannel channel;
+  channel.setCapacity(2);
+  QCOMPARE(channel.dropPolicy(), FrameDropPolicy::DropOldest);
+  for (qint64 sequence = 1; sequence <= 5; ++sequence)
+  {
+    QVERIFY(channel.publish(makeFrame(sequence)));
+  }
+
+  // 通道中留下 4、5，界面只显示 5，4 被新帧取代
+  DisplayFrame frame;
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(5));
+  QVERIFY(!channel.takeLatest(frame));
+
+  const FrameChannelStats stats = channel.stats();
+  QCOMPARE(stats.published, quint64(5));
+  QCOMPARE(stats.overflowed, quint64(3));
+  QCOMPARE(stats.superseded, quint64(1));
+  QCOMPARE(stats.displayed, quint64(1));
+  QCOMPARE(stats.dropped(), quint64(4));
+}
+
+void TestFrameChannel::dropNewestRejectsWhenFull()
+{
+  FrameChannel channel;
+  channel.setCapacity(2);
+  channel.setDropPolicy(FrameDropPolicy::DropNewest);
+  QVERIFY(channel.publish(makeFrame(1)));
+  QVERIFY(channel.publish(makeFrame(2)));
+  QVERIFY(!channel.publish(makeFrame(3)));
+
+  DisplayFrame frame;
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(2));
+  QVERIFY(channel.publish(makeFrame(4)));
+
+  const FrameChannelStats stats = channel.stats();
+  QCOMPARE(stats.published, quint64(4));
+  QCOMPARE(stats.overflowed, quint64(1));
+  QCOMPARE(stats.superseded, quint64(1));
+}
+
+void TestFrameChannel::blockWaitsForConsumer()
+{
+  FrameChannel channel;
+  channel.setCapacity(1);
+  channel.setDropPolicy(FrameDropPolicy::Block);
+  QVERIFY(channel.publish(makeFrame(1)));
+
+  std::atomic<bool> finished{false};
+  bool published = false;
+  std::thread producer([&]()
+  {
+    published = channel.publish(makeFrame(2));
+    finished = true;
+  });
+  settle();
+  QVERIFY(!finished);
+
+  DisplayFrame frame;
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(1));
+  producer.join();
+  QVERIFY(published);
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(2));
+
+  const FrameChannelStats stats = channel.stats();
+  QCOMPARE(stats.overflowed, quint64(0));
+  QCOMPARE(stats.superseded, quint64(0));
+  QVERIFY(stats.blockedMs > 0.0);
+}
+
+// 关闭通道必须唤醒 Block 策略下等待的工作线程，否则停止检测时会卡住
+void TestFrameChannel::closeWakesBlockedProducer()
+{
+  FrameChannel channel;
+  channel.setCapacity(1);
+  channel.setDropPolicy(FrameDropPolicy::Block);
+  QVERIFY(channel.publish(makeFrame(1)));
+
+  std::atomic<bool> finished{false};
+  bool published = true;
+  std::thread producer([&]()
+  {
+    published = channel.publish(makeFrame(2));
+    finished = true;
+  });
+  settle();
+  QVERIFY(!finished);
+
+  channel.close();
+  producer.join();
+  QVERIFY(!published);
+  QVERIFY(!channel.publish(makeFrame(3)));
+
+  const FrameChannelStats stats = channel.stats();
+  QCOMPARE(stats.published, quint64(2));
+  QCOMPARE(stats.overflowed, quint64(2));
+  QVERIFY(stats.blockedMs > 0.0);
+
+  // 关闭前已进入通道的帧仍可取出
+  DisplayFrame frame;
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(1));
+}
+
+// 界面取帧前只通知一次，事件队列中不会堆积通知
+void TestFrameChannel::coalescesNotifications()
+{
+  FrameChannel channel;
+  channel.setCapacity(4);
+  QSignalSpy available(&channel, &FrameChannel::frameAvailable);
+  QVERIFY(channel.publish(makeFrame(1)));
+  QVERIFY(channel.publish(makeFrame(2)));
+  QVERIFY(channel.publish(makeFrame(3)));
+  QCOMPARE(available.count(), 1);
+
+  DisplayFrame frame;
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(3));
+  QVERIFY(channel.publish(makeFrame(4)));
+  QCOMPARE(available.count(), 2);
+
+  // 通道为空时取帧也清除待处理标记
+  QVERIFY(channel.takeLatest(frame));
+  QVERIFY(!channel.takeLatest(frame));
+  QVERIFY(channel.publish(makeFrame(5)));
+  QCOMPARE(available.count(), 3);
+}
+
+void TestFrameChannel::capacityReductionDropsOldest()
+{
+  FrameChannel channel;
+  channel.setCapacity(4);
+  for (qint64 sequence = 1; sequence <= 4; ++sequence)
+  {
+    QVERIFY(channel.publish(makeFrame(sequence)));
+  }
+  channel.setCapacity(0); // 容量至少为1
+  QCOMPARE(channel.capacity(), 1);
+  QCOMPARE(channel.stats().overflowed, quint64(3));
+
+  DisplayFrame frame;
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(4));
+  QCOMPARE(channel.stats().superseded, quint64(0));
+}
+
+void TestFrameChannel::resetReopensAndClearsStats()
+{
+  FrameChannel channel;
+  QVERIFY(channel.publish(makeFrame(1)));
+  channel.close();
+  QVERIFY(!channel.publish(makeFrame(2)));
+
+  channel.reset();
+  const FrameChannelStats cleared = channel.stats();
+  QCOMPARE(cleared.published, quint64(0));
+  QCOMPARE(cleared.overflowed, quint64(0));
+
+  DisplayFrame frame;
+  QVERIFY(!channel.takeLatest(frame));
+  QSignalSpy available(&channel, &FrameChannel::frameAvailable);
+  QVERIFY(channel.publish(makeFrame(3)));
+  QCOMPARE(available.count(), 1);
+  QVERIFY(channel.takeLatest(frame));
+  QCOMPARE(frame.sequence, qint64(3));
+}
+
+void TestFrameChannel::policyStringRoundTrip()
+{
+  const FrameDropPolicy policies[] = {
+    FrameDropPolicy::DropOldest, FrameDropPolicy::DropNewest, FrameDropPolicy::Block
+  };
+  for (FrameDropPolicy policy : policies)
+  {
+    QCOMPARE(FrameChannel::policyFromString(FrameChannel::policyToString(policy)), policy);
+  }
+  QCOMPARE(FrameChannel::policyFromString(" Drop_Newest "), FrameDropPolicy::DropNewest);
+  QCOMPARE(FrameChannel::policyFromString("unknown", FrameDropPolicy::Block), FrameDropPolicy::Block);
+  QCOMPARE(FrameChannel::policyFromString(QString()), FrameDropPolicy::DropOldest);
+}
+
+QTEST_GUILESS_MAIN(TestFrameChannel)
+
+#include "tst_framechannel.moc"
@@ -0,0 +1,213 @@
+/**
+ * @file tst_hotfoldersource.cpp
+ * @brief 监视目录日志、重启跳过、日志压缩与读取重试测试 | Hot-folder journal, restart skip, compaction and retry tests
+ *
+ * 只测试文件发现与日志记录，不解码图像；文件内容为任意非空字节。
+ */
+
+#include "../../inc/thread/HotFolderSource.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <memory>
+
+class TestHotFolderSource : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void init();
+  void journalsProcessedFiles();
+  void restartSkipsJournaledFiles();
+  void compactsJournalOnStart();
+  void retriesFailedFilesUpToLimit();
+
+private:
+  HotFolderConfig config() const;
+  QString imagePath(const QString& name) const { return m_directory->path() + "/in/" + name; }
+  QString journalPath() const { return m_directory->path() + "/journal/processed.log"; }
+  QStringList journalLines() const;
+  static void writeFile(const QString& path, const QByteArray& content);
+  static QSet<QString> takeAll(HotFolderSource& source, int count, bool processed);
+
+  std::unique_ptr<QTemporaryDir> m_directory;
+};
+
+void TestHotFolderSource::init()
+{
+  m_directory.reset(new QTemporaryDir());
+  QVERIFY(m_directory->isValid());
+  QVERIFY(QDir().mkpath(m_directory->path() + "/in"));
+}
+
+HotFolderConfig TestHotFolderSource::config() const
+{
+  HotFolderConfig result;
+  result.enabled = true;
+  result.folder = m_directory->path() + "/in";
+  result.journalPath = journalPath();
+  result.settleMs = 0;
+  result.pollIntervalMs = 10;
+  result.rescanIntervalMs = 50;
+  return result;
+}
+
+QStringList TestHotFolderSource::journalLines() const
+{
+  QFile file(journalPath());
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    return QStringList();
+  }
+  return QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+}
+
+void TestHotFolderSource::writeFile(const QString& path, const QByteArray& content)
+{
+  QFile file(path);
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  QCOMPARE(file.write(content), qint64(content.size()));
+}
+
+// 调用前已确认有 count 个文件入队，next() 不会阻塞
+QSet<QString> TestHotFolderSource::takeAll(HotFolderSource& source, int count, bool processed)
+{
+  QSet<QString> names;
+  for (int i = 0; i < count; ++i)
+  {
+    SourceImage image;
+    if (!source.next(image))
+    {
+      break;
+    }
+    names.insert(QFileInfo(image.path).fileName());
+    if (processed)
+    {
+      source.markProcessed(image.path);
+    }
+  }
+  return names;
+}
+
+void TestHotFolderSource::journalsProcessedFiles()
+{
+  writeFile(imagePath("a.png"), "a");
+  writeFile(imagePath("b.png"), "bb");
+  writeFile(imagePath("notes.txt"), "ignored");
+
+  HotFolderSource source(config());
+  QVERIFY(source.start());
+  QTRY_COMPARE(source.stats().ingested, quint64(2));
+  QCOMPARE(source.stats().queued, 2);
+  QCOMPARE(takeAll(source, 2, true), QSet<QString>({"a.png", "b.png"}));
+
+  const HotFolderStats stats = source.stats();
+  QCOMPARE(stats.discovered, quint64(2));
+  QCOMPARE(stats.processed, quint64(2));
+  QCOMPARE(stats.queued, 0);
+  QCOMPARE(stats.journalEntries, 2);
+  QCOMPARE(journalLines().size(), 2);
+
+  // 重复通知不重复记录
+  source.markProcessed(imagePath("a.png"));
+  QCOMPARE(source.stats().processed, quint64(2));
+  source.stop();
+  QVERIFY(source.isStopped());
+}
+
+void TestHotFolderSource::restartSkipsJournaledFiles()
+{
+  writeFile(imagePath("a.png"), "a");
+  writeFile(imagePath("b.png"), "bb");
+  {
+    HotFolderSource source(config());
+    QVERIFY(source.start());
+    QTRY_COMPARE(source.stats().ingested, quint64(2));
+    takeAll(source, 2, true);
+  }
+
+  writeFile(imagePath("c.png"), "ccc");
+  HotFolderSource source(config());
+  QVERIFY(source.start());
+  QTRY_COMPARE(source.stats().ingested, quint64(1));
+  QCOMPARE(source.stats().skipped, quint64(2));
+  QCOMPARE(takeAll(source, 1, true), QSet<QString>({"c.png"}));
+  QCOMPARE(source.stats().journalEntries, 3);
+}
+
+// 日志中已删除或已改写的文件记录在启动时去掉；改写后的文件作为新文件处理
+void TestHotFolderSource::compactsJournalOnStart()
+{
+  writeFile(imagePath("a.png"), "a");
+  writeFile(imagePath("b.png"), "bb");
+  writeFile(imagePath("c.png"), "ccc");
+  {
+    HotFolderSource source(config());
+    QVERIFY(source.start());
+    QTRY_COMPARE(source.stats().ingested, quint64(3));
+    takeAll(source, 3, true);
+  }
+  QCOMPARE(journalLines().size(), 3);
+
+  QVERIFY(QFile::remove(imagePath("b.png")));
+  writeFile(imagePath("c.png"), "rewritten");
+  {
+    QFile journal(journalPath());
+    QVERIFY(journal.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text));
+    journal.write(QString("%1\t1\t2\n").arg(imagePath("missing.png")).toUtf8());
+  }
+
+  HotFolderSource source(config());
+  QVERIFY(source.start());
+  QCOMPARE(source.stats().journalEntries, 1);
+  QCOMPARE(journalLines().size(), 1);
+  QVERIFY(journalLines().first().startsWith(imagePath("a.png") + '\t'));
+
+  QTRY_COMPARE(source.stats().ingested, quint64(1));
+  QCOMPARE(source.stats().skipped, quint64(1));
+  QCOMPARE(takeAll(source, 1, true), QSet<QString>({"c.png"}));
+  QCOMPARE(journalLines().size(), 2);
+}
+
+// 读取失败不记入日志，补扫时重新发现；达到次数上限后放弃，文件改写后再次处理
+void TestHotFolderSource::retriesFailedFilesUpToLimit()
+{
+  writeFile(imagePath("bad.png"), "broken");
+  HotFolderConfig sourceConfig = config();
+  sourceConfig.maxDecodeAttempts = 2;
+  HotFolderSource source(sourceConfig);
+  QVERIFY(source.start());
+
+  SourceImage image;
+  QTRY_COMPARE(source.stats().ingested, quint64(1));
+  QVERIFY(source.next(image));
+  source.markFailed(image.path);
+  QCOMPARE(source.stats().retried, quint64(1));
+  QCOMPARE(source.stats().queued, 0);
+
+  QTRY_COMPARE(source.stats().ingested, quint64(2));
+  QVERIFY(source.next(image));
+  source.markFailed(image.path);
+  QCOMPARE(source.stats().failed, quint64(1));
+
+  // 等待数次补扫：放弃的文件不再入队
+  QTest::qWait(4 * sourceConfig.rescanIntervalMs);
+  QCOMPARE(source.stats().ingested, quint64(2));
+  QCOMPARE(source.stats().journalEntries, 0);
+  QVERIFY(journalLines().isEmpty());
+
+  writeFile(imagePath("bad.png"), "fixed image");
+  QTRY_COMPARE(source.stats().ingested, quint64(3));
+  QVERIFY(source.next(image));
+  source.markProcessed(image.path);
+  QCOMPARE(source.stats().processed, quint64(1));
+  QCOMPARE(journalLines().size(), 1);
+}
+
+QTEST_GUILESS_MAIN(TestHotFolderSource)
+
+#include "tst_hotfoldersource.moc"
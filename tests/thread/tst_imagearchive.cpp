@@ -0,0 +1,314 @@
+/**
+ * @file tst_imagearchive.cpp
+ * @brief 图像归档索引、段轮换、崩溃恢复与保留策略测试 | Image archive index, rotation, recovery and retention tests
+ *
+ * 帧数据直接构造为已编码帧，不调用Halcon算子。
+ */
+
+#include "../../inc/thread/ImageArchive.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <memory>
+
+namespace
+{
+// 段文件下限为16MB：每帧约4MB，每段最多3帧
+constexpr int kFrameBytes = 4 * 1024 * 1024;
+constexpr qint64 kSegmentBytes = 16LL * 1024 * 1024;
+
+ArchiveEncodedFrame makeFrame(int bytes, char fill, qint64 sequence, bool ng, const QString& tag)
+{
+  ArchiveEncodedFrame frame;
+  frame.header.headerSize = sizeof(ArchiveFrameHeader);
+  frame.header.width = bytes;
+  frame.header.height = 1;
+  frame.header.channels = 1;
+  frame.header.pixelType = static_cast<quint16>(ArchivePixelType::Byte);
+  frame.header.payloadSize = static_cast<quint64>(bytes);
+  frame.header.rawSize = static_cast<quint64>(bytes);
+  frame.payload = QByteArray(bytes, fill);
+  frame.sequence = sequence;
+  frame.ng = ng;
+  frame.tag = tag;
+  return frame;
+}
+
+QString segmentFile(const QString& directory, int id, const char* suffix)
+{
+  return QString("%1/seg_%2.%3").arg(directory).arg(id, 6, 10, QChar('0')).arg(suffix);
+}
+}
+
+class TestImageArchive : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void init();
+  void appendAndLookup();
+  void rejectsInvalidFrames();
+  void rotatesFullSegments();
+  void recoversTruncatedTail();
+  void retentionRemovesOldestSegments();
+  void truncatesLongTagsOnCharacterBoundary();
+  void rawBytesSurviveReopen();
+
+private:
+  ImageArchiveConfig config() const;
+
+  std::unique_ptr<QTemporaryDir> m_directory;
+};
+
+void TestImageArchive::init()
+{
+  m_directory.reset(new QTemporaryDir());
+  QVERIFY(m_directory->isValid());
+}
+
+ImageArchiveConfig TestImageArchive::config() const
+{
+  ImageArchiveConfig config;
+  config.directory = m_directory->path();
+  config.maxSegmentBytes = kSegmentBytes;
+  config.rotateDaily = false;
+  config.retentionDays = 0;
+  config.compressionLevel = 0;
+  return config;
+}
+
+void TestImageArchive::appendAndLookup()
+{
+  ImageArchive archive;
+  QVERIFY(archive.open(config()));
+  for (int i = 0; i < 10; ++i)
+  {
+    const quint64 frameId = archive.append(makeFrame(100 + i, char(i), 1000 + i, i % 3 == 0, QString("part_%1").arg(i)));
+    QCOMPARE(frameId, quint64(i + 1));
+  }
+
+  ArchiveIndexEntry entry;
+  QVERIFY(archive.entry(4, &entry));
+  QCOMPARE(entry.frameId, quint64(4));
+  QCOMPARE(entry.sequence, qint64(1003));
+  QVERIFY(entry.isNg());
+  QCOMPARE(entry.tagString(), QString("part_3"));
+  QCOMPARE(entry.size, quint64(sizeof(ArchiveFrameHeader) + 103));
+  QVERIFY(!archive.entry(0, &entry));
+  QVERIFY(!archive.entry(11, &entry));
+
+  QCOMPARE(archive.findByTag("part_7"), quint64(8));
+  QCOMPARE(archive.findByTag("missing"), quint64(0));
+  QCOMPARE(archive.findByTime(0), quint64(1));
+
+  // 时间戳单调不减，按时间的查询覆盖全部帧
+  QCOMPARE(archive.query(0, 0).size(), 10);
+  const QVector<ArchiveIndexEntry> ng = archive.query(0, 0, 1);
+  QCOMPARE(ng.size(), 4);
+  for (const ArchiveIndexEntry& item : ng)
+  {
+    QVERIFY(item.isNg());
+  }
+  QCOMPARE(archive.query(0, 0, 0, 2).size(), 2);
+
+  const QVector<ArchiveIndexEntry> latest = archive.latest(3);
+  QCOMPARE(latest.size(), 3);
+  QCOMPARE(latest.front().frameId, quint64(8));
+  QCOMPARE(latest.back().frameId, quint64(10));
+  const QVector<ArchiveIndexEntry> latestNg = archive.latest(2, 1);
+  QCOMPARE(latestNg.size(), 2);
+  QCOMPARE(latestNg.front().frameId, quint64(7));
+  QCOMPARE(latestNg.back().frameId, quint64(10));
+
+  const ImageArchiveStats stats = archive.stats();
+  QCOMPARE(stats.frames, quint64(10));
+  QCOMPARE(stats.ngFrames, quint64(4));
+  QCOMPARE(stats.segments, 1);
+  QCOMPARE(stats.appended, quint64(10));
+
+  // 重新打开后索引从文件恢复，帧号继续递增
+  archive.close();
+  QVERIFY(archive.open(config()));
+  QCOMPARE(archive.stats().frames, quint64(10));
+  QCOMPARE(archive.findByTag("part_7"), quint64(8));
+  QCOMPARE(archive.append(makeFrame(10, 'x', 2000, false, QString())), quint64(11));
+}
+
+void TestImageArchive::rejectsInvalidFrames()
+{
+  ImageArchive archive;
+  QCOMPARE(archive.append(makeFrame(10, 'x', 0, false, QString())), quint64(0)); // 未打开
+
+  QVERIFY(archive.open(config()));
+  QCOMPARE(archive.append(makeFrame(0, 'x', 0, false, QString())), quint64(0));
+  ArchiveEncodedFrame noChannels = makeFrame(10, 'x', 0, false, QString());
+  noChannels.header.channels = 0;
+  QCOMPARE(archive.append(noChannels), quint64(0));
+  QCOMPARE(archive.stats().frames, quint64(0));
+}
+
+void TestImageArchive::rotatesFullSegments()
+{
+  ImageArchive archive;
+  QVERIFY(archive.open(config()));
+  for (int i = 0; i < 7; ++i)
+  {
+    QVERIFY(archive.append(makeFrame(kFrameBytes, char(i), i, false, QString())) > 0);
+  }
+  const ImageArchiveStats stats = archive.stats();
+  QCOMPARE(stats.segments, 3);
+  QCOMPARE(stats.frames, quint64(7));
+
+  ArchiveIndexEntry entry;
+  QVERIFY(archive.entry(3, &entry));
+  QCOMPARE(entry.segmentId, quint32(1));
+  QVERIFY(archive.entry(4, &entry));
+  QCOMPARE(entry.segmentId, quint32(2));
+  QCOMPARE(entry.offset, quint64(0));
+  QVERIFY(QFileInfo(segmentFile(m_directory->path(), 1, "dat")).size() <= kSegmentBytes);
+}
+
+// 崩溃时段文件和索引文件末尾可能留有半条数据，打开时截断到最后一条完整帧
+void TestImageArchive::recoversTruncatedTail()
+{
+  {
+    ImageArchive archive;
+    QVERIFY(archive.open(config()));
+    for (int i = 0; i < 5; ++i)
+    {
+      QVERIFY(archive.append(makeFrame(1000, char(i), i, false, QString("frame_%1").arg(i))) > 0);
+    }
+  }
+
+  const QString dataPath = segmentFile(m_directory->path(), 1, "dat");
+  const QString indexPath = segmentFile(m_directory->path(), 1, "idx");
+  const qint64 dataSize = QFileInfo(dataPath).size();
+  const qint64 indexSize = QFileInfo(indexPath).size();
+  {
+    QFile data(dataPath);
+    QVERIFY(data.open(QIODevice::Append));
+    data.write(QByteArray(300, 'z'));
+    QFile index(indexPath);
+    QVERIFY(index.open(QIODevice::Append));
+    index.write(QByteArray(10, 'z'));
+  }
+
+  ImageArchive archive;
+  QVERIFY(archive.open(config()));
+  QCOMPARE(archive.stats().frames, quint64(5));
+  QCOMPARE(QFileInfo(dataPath).size(), dataSize);
+  QCOMPARE(QFileInfo(indexPath).size(), indexSize);
+  QCOMPARE(archive.findByTag("frame_4"), quint64(5));
+
+  // 索引项指向已丢失的帧数据时丢弃该项及之后的项
+  archive.close();
+  {
+    QFile data(dataPath);
+    QVERIFY(data.open(QIODevice::ReadWrite));
+    QVERIFY(data.resize(dataSize - 10));
+  }
+  QVERIFY(archive.open(config()));
+  QCOMPARE(archive.stats().frames, quint64(4));
+  QCOMPARE(archive.findByTag("frame_4"), quint64(0));
+  QCOMPARE(archive.append(makeFrame(1000, 'n', 9, false, QString())), quint64(5));
+  ArchiveIndexEntry entry;
+  QVERIFY(archive.entry(5, &entry));
+  QCOMPARE(entry.offset, quint64(4 * (sizeof(ArchiveFrameHeader) + 1000)));
+}
+
+// 超出总大小上限时整段删除最旧的段
+void TestImageArchive::retentionRemovesOldestSegments()
+{
+  {
+    ImageArchive archive;
+    QVERIFY(archive.open(config()));
+    for (int i = 0; i < 7; ++i)
+    {
+      QVERIFY(archive.append(makeFrame(kFrameBytes, char(i), i, false, QString("frame_%1").arg(i))) > 0);
+    }
+  }
+
+  ImageArchiveConfig limited = config();
+  limited.maxTotalBytes = 5LL * kFrameBytes;
+  ImageArchive archive;
+  QVERIFY(archive.open(limited));
+  const ImageArchiveStats stats = archive.stats();
+  QCOMPARE(stats.segments, 2);
+  QCOMPARE(stats.frames, quint64(4));
+  QCOMPARE(stats.removedSegments, quint64(1));
+  QVERIFY(!QFile::exists(segmentFile(m_directory->path(), 1, "dat")));
+  QVERIFY(!QFile::exists(segmentFile(m_directory->path(), 1, "idx")));
+  QCOMPARE(archive.findByTag("frame_0"), quint64(0));
+  QCOMPARE(archive.findByTag("frame_3"), quint64(4));
+
+  ArchiveIndexEntry entry;
+  QVERIFY(!archive.entry(3, &entry));
+  QVERIFY(archive.entry(4, &entry));
+  QCOMPARE(archive.append(makeFrame(10, 'n', 9, false, QString())), quint64(8));
+}
+
+// 标签超过63字节时在UTF-8字符边界截断，索引键在追加、重新打开和删除段时保持一致
+void TestImageArchive::truncatesLongTagsOnCharacterBoundary()
+{
+  const QString prefix(61, QChar('a'));
+  const QString longTag = prefix + QString::fromUtf8("测试"); // 61 + 3 + 3 字节，第63字节落在“测”中间
+
+  ImageArchiveConfig limited = config();
+  limited.maxTotalBytes = 5LL * kFrameBytes;
+  {
+    ImageArchive archive;
+    QVERIFY(archive.open(limited));
+    const quint64 frameId = archive.append(makeFrame(100, 't', 0, false, longTag));
+    QCOMPARE(frameId, quint64(1));
+    ArchiveIndexEntry entry;
+    QVERIFY(archive.entry(frameId, &entry));
+    QCOMPARE(entry.tagString(), prefix);
+    QCOMPARE(archive.findByTag(longTag), frameId);
+    QCOMPARE(archive.findByTag(prefix), frameId);
+  }
+
+  ImageArchive archive;
+  QVERIFY(archive.open(limited));
+  QCOMPARE(archive.findByTag(longTag), quint64(1));
+  QCOMPARE(archive.findByTag(prefix), quint64(1));
+
+  // 第1段写满后继续追加，轮换到第3段时删除第1段，标签随之失效
+  for (int i = 0; i < 7; ++i)
+  {
+    QVERIFY(archive.append(makeFrame(kFrameBytes, char(i), i + 1, false, QString())) > 0);
+  }
+  QCOMPARE(archive.stats().removedSegments, quint64(1));
+  QCOMPARE(archive.findByTag(longTag), quint64(0));
+  QCOMPARE(archive.findByTag(prefix), quint64(0));
+}
+
+// 原始像素字节数来自帧头，压缩帧重新打开后统计不变
+void TestImageArchive::rawBytesSurviveReopen()
+{
+  qint64 rawBytes = 0;
+  {
+    ImageArchive archive;
+    QVERIFY(archive.open(config()));
+    for (int i = 0; i < 3; ++i)
+    {
+      ArchiveEncodedFrame frame = makeFrame(1000, char(i), i, false, QString());
+      frame.header.compression = 1;
+      frame.header.rawSize = 4000;
+      QVERIFY(archive.append(std::move(frame)) > 0);
+    }
+    rawBytes = archive.stats().rawBytes;
+    QCOMPARE(rawBytes, qint64(3 * 4000));
+  }
+
+  ImageArchive archive;
+  QVERIFY(archive.open(config()));
+  QCOMPARE(archive.stats().rawBytes, rawBytes);
+}
+
+QTEST_GUILESS_MAIN(TestImageArchive)
+
+#include "tst_imagearchive.moc"
@@ -0,0 +1,251 @@
+/**
+ * @file tst_imagewriterservice.cpp
+ * @brief 图像保存策略与丢弃计数测试 | Image writer save policy and drop counter tests
+ *
+ * 检测结果只设置测量标志：已测量且在公差内为OK，其余为NG。
+ */
+
+#include "../../inc/thread/ImageWriterService.h"
+
+#include <QDate>
+#include <QDir>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <limits>
+#include <memory>
+
+namespace
+{
+HObject constImage(int width, int height)
+{
+  HObject image;
+  GenImageConst(&image, "byte", width, height);
+  return image;
+}
+
+InspectionResult makeResult(const HObject& image, qint64 sequence, bool ok)
+{
+  InspectionResult result;
+  result.image = image;
+  result.sequence = sequence;
+  result.imagePath = QString("/camera/frame_%1.bmp").arg(sequence);
+  result.record.sequence = sequence;
+  result.record.flags = MeasurementRecord::Matched | MeasurementRecord::Measured;
+  if (!ok)
+  {
+    result.record.flags |= MeasurementRecord::OutOfTolerance;
+  }
+  return result;
+}
+}
+
+class TestImageWriterService : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void init();
+  void ngOnlySkipsOkImages();
+  void sampledSavesEveryNthOkImage();
+  void allSavesEverything();
+  void dropsWhenQueueFull();
+  void dropsWhenDiskFull();
+  void dropsWhenStopped();
+  void policyStringRoundTrip();
+
+private:
+  ImageWriterConfig config(ImageSavePolicy policy) const;
+  int savedFiles(const QString& kind) const;
+
+  std::unique_ptr<QTemporaryDir> m_directory;
+  HObject m_image;
+};
+
+void TestImageWriterService::init()
+{
+  m_directory.reset(new QTemporaryDir());
+  QVERIFY(m_directory->isValid());
+  m_image = constImage(64, 64);
+}
+
+ImageWriterConfig TestImageWriterService::config(ImageSavePolicy policy) const
+{
+  ImageWriterConfig result;
+  result.enabled = true;
+  result.rootDir = m_directory->path();
+  result.encoderThreads = 2;
+  result.policy = policy;
+  result.minFreeBytes = 0; // 不检查磁盘空间
+  return result;
+}
+
+// kind 为 NG 或 OK
+int TestImageWriterService::savedFiles(const QString& kind) const
+{
+  QDir dir(QString("%1/%2/%3").arg(m_directory->path()).arg(QDate::currentDate().toString("yyyyMMdd")).arg(kind));
+  return dir.entryList(QDir::Files).size();
+}
+
+void TestImageWriterService::ngOnlySkipsOkImages()
+{
+  ImageWriterService writer;
+  writer.setConfig(config(ImageSavePolicy::NgOnly));
+  QVERIFY(writer.start());
+
+  QVERIFY(!writer.submitResult(makeResult(m_image, 0, true)));
+  QVERIFY(writer.submitResult(makeResult(m_image, 1, false)));
+  QVERIFY(!writer.submitResult(makeResult(m_image, 2, true)));
+
+  // 未完成测量视为NG
+  InspectionResult unmeasured = makeResult(m_image, 3, true);
+  unmeasured.record.flags = 0;
+  QVERIFY(writer.submitResult(unmeasured));
+  QVERIFY(writer.waitForIdle(10000));
+
+  const ImageWriterStats stats = writer.stats();
+  QCOMPARE(stats.submitted, quint64(2));
+  QCOMPARE(stats.written, quint64(2));
+  QCOMPARE(stats.skippedByPolicy, quint64(2));
+  QCOMPARE(stats.dropped(), quint64(0));
+  QCOMPARE(savedFiles("NG"), 2);
+  QCOMPARE(savedFiles("OK"), 0);
+  QVERIFY(QFile::exists(QString("%1/%2/NG/frame_1_1.png")
+                        .arg(m_directory->path()).arg(QDate::currentDate().toString("yyyyMMdd"))));
+}
+
+void TestImageWriterService::sampledSavesEveryNthOkImage()
+{
+  ImageWriterConfig writerConfig = config(ImageSavePolicy::NgAndSampled);
+  writerConfig.sampleInterval = 3;
+  ImageWriterService writer;
+  writer.setConfig(writerConfig);
+  QVERIFY(writer.start());
+
+  // OK 图像第 0、3、6 张保存；NG 图像全部保存
+  for (int i = 0; i < 7; ++i)
+  {
+    writer.submitResult(makeResult(m_image, i, true));
+  }
+  QVERIFY(writer.submitResult(makeResult(m_image, 7, false)));
+  QVERIFY(writer.waitForIdle(10000));
+
+  const ImageWriterStats stats = writer.stats();
+  QCOMPARE(stats.written, quint64(4));
+  QCOMPARE(stats.skippedByPolicy, quint64(4));
+  QCOMPARE(savedFiles("OK"), 3);
+  QCOMPARE(savedFiles("NG"), 1);
+}
+
+void TestImageWriterService::allSavesEverything()
+{
+  ImageWriterConfig writerConfig = config(ImageSavePolicy::All);
+  writerConfig.okOptions.format = "tiff";
+  ImageWriterService writer;
+  writer.setConfig(writerConfig);
+  QVERIFY(writer.start());
+
+  for (int i = 0; i < 4; ++i)
+  {
+    QVERIFY(writer.submitResult(makeResult(m_image, i, i % 2 == 0)));
+  }
+  QVERIFY(writer.waitForIdle(10000));
+
+  const ImageWriterStats stats = writer.stats();
+  QCOMPARE(stats.written, quint64(4));
+  QCOMPARE(stats.skippedByPolicy, quint64(0));
+  QVERIFY(stats.bytesWritten > 0);
+  QCOMPARE(savedFiles("OK"), 2);
+  QCOMPARE(savedFiles("NG"), 2);
+}
+
+// 队列满时OK图像直接丢弃，NG图像等待空位
+void TestImageWriterService::dropsWhenQueueFull()
+{
+  ImageWriterConfig writerConfig = config(ImageSavePolicy::All);
+  writerConfig.encoderThreads = 1;
+  writerConfig.queueCapacity = 1;
+  writerConfig.okOptions.compression = 9;
+  ImageWriterService writer;
+  writer.setConfig(writerConfig);
+  QVERIFY(writer.start());
+
+  // 噪声大图以最高级别压缩，编码远慢于提交
+  HObject large;
+  AddNoiseWhite(constImage(2048, 2048), &large, 60);
+  const int okCount = 8;
+  int queued = 0;
+  for (int i = 0; i < okCount; ++i)
+  {
+    queued += writer.submitResult(makeResult(large, i, true)) ? 1 : 0;
+  }
+  QVERIFY(writer.submitResult(makeResult(large, okCount, false)));
+  QVERIFY(writer.waitForIdle(60000));
+
+  const ImageWriterStats stats = writer.stats();
+  QCOMPARE(stats.submitted, quint64(okCount + 1));
+  QVERIFY(stats.droppedQueueFull > 0);
+  QCOMPARE(stats.droppedQueueFull, quint64(okCount - queued));
+  QCOMPARE(stats.written, quint64(queued + 1));
+  QCOMPARE(stats.maxQueueDepth, 1);
+  QCOMPARE(savedFiles("NG"), 1);
+}
+
+void TestImageWriterService::dropsWhenDiskFull()
+{
+  ImageWriterConfig writerConfig = config(ImageSavePolicy::All);
+  writerConfig.minFreeBytes = std::numeric_limits<qint64>::max() / 2;
+  ImageWriterService writer;
+  writer.setConfig(writerConfig);
+  QVERIFY(writer.start());
+
+  QVERIFY(!writer.submitResult(makeResult(m_image, 0, false)));
+  QVERIFY(!writer.submit(m_image, m_directory->path() + "/manual.png"));
+  QVERIFY(writer.waitForIdle(1000));
+
+  const ImageWriterStats stats = writer.stats();
+  QCOMPARE(stats.submitted, quint64(2));
+  QCOMPARE(stats.droppedDiskFull, quint64(2));
+  QCOMPARE(stats.written, quint64(0));
+  QVERIFY(stats.freeBytes >= 0);
+}
+
+void TestImageWriterService::dropsWhenStopped()
+{
+  ImageWriterService writer;
+  writer.setConfig(config(ImageSavePolicy::All));
+  QVERIFY(!writer.isRunning());
+  QVERIFY(!writer.submit(m_image, m_directory->path() + "/manual.png"));
+  QCOMPARE(writer.stats().droppedOnStop, quint64(1));
+
+  // 手动保存不受保存策略限制，格式由扩展名决定
+  QVERIFY(writer.start());
+  QVERIFY(writer.submit(m_image, m_directory->path() + "/manual.tif"));
+  writer.stop(true);
+  QVERIFY(!writer.isRunning());
+  QVERIFY(QFile::exists(m_directory->path() + "/manual.tif"));
+
+  const ImageWriterStats stats = writer.stats();
+  QCOMPARE(stats.written, quint64(1));
+  QCOMPARE(stats.droppedOnStop, quint64(1));
+  QCOMPARE(stats.dropped(), quint64(1));
+}
+
+void TestImageWriterService::policyStringRoundTrip()
+{
+  const ImageSavePolicy policies[] = {
+    ImageSavePolicy::All, ImageSavePolicy::NgOnly, ImageSavePolicy::NgAndSampled
+  };
+  for (ImageSavePolicy policy : policies)
+  {
+    QCOMPARE(ImageWriterService::policyFromString(ImageWriterService::policyToString(policy)), policy);
+  }
+  QCOMPARE(ImageWriterService::policyFromString(" NG_AND_SAMPLED "), ImageSavePolicy::NgAndSampled);
+  QCOMPARE(ImageWriterService::policyFromString("unknown", ImageSavePolicy::All), ImageSavePolicy::All);
+  QCOMPARE(ImageWriterService::fileExtension("jpeg"), QString("jpg"));
+  QCOMPARE(ImageWriterService::optionsForPath("/tmp/a.TIF").format, QString("tiff"));
+}
+
+QTEST_GUILESS_MAIN(TestImageWriterService)
+
+#include "tst_imagewriterservice.moc"
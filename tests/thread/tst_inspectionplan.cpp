@@ -0,0 +1,243 @@
+/**
+ * @file tst_inspectionplan.cpp
+ * @brief 检测配方编译测试 | Inspection recipe compilation tests
+ *
+ * 只检查配方结构、分层和并行模式；ROI 文件由模板集中的预加载区域提供，不读取文件也不执行Halcon算子。
+ */
+
+#include "../../inc/thread/InspectionRecipe.h"
+#include "../../inc/thread/TemplateCache.h"
+
+#include <QDir>
+#include <QJsonDocument>
+#include <QtTest>
+
+class TestInspectionPlan : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void defaultRecipeIsValid();
+  void rejectsInvalidRecipe_data();
+  void rejectsInvalidRecipe();
+  void acceptsForwardReferences();
+  void compilesIntoDependencyStages();
+  void parallelModeFollowsRecipe_data();
+  void parallelModeFollowsRecipe();
+
+private:
+  static QJsonObject parse(const QByteArray& json);
+  static TemplateSet templateSetWithRegions(const QStringList& files);
+};
+
+QJsonObject TestInspectionPlan::parse(const QByteArray& json)
+{
+  QJsonParseError parseError;
+  QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+  if (parseError.error != QJsonParseError::NoError)
+  {
+    qWarning() << "测试配方解析失败:" << parseError.errorString() << json;
+  }
+  return document.object();
+}
+
+// 以配方目录(当前目录)下的文件路径登记预加载区域，编译时不再读取文件
+TemplateSet TestInspectionPlan::templateSetWithRegions(const QStringList& files)
+{
+  TemplateSet templateSet;
+  for (const QString& file : files)
+  {
+    templateSet.regions.insert(QDir::cleanPath(QDir(QDir::currentPath()).absoluteFilePath(file)), HObject());
+  }
+  return templateSet;
+}
+
+void TestInspectionPlan::defaultRecipeIsValid()
+{
+  QString error;
+  QVERIFY2(InspectionPlan::validate(InspectionPlan::defaultRecipe(), error), qPrintable(error));
+  QVERIFY(!InspectionPlan::defaultRecipe().contains("parallel"));
+}
+
+void TestInspectionPlan::rejectsInvalidRecipe_data()
+{
+  QTest::addColumn<QByteArray>("recipe");
+  QTest::addColumn<QString>("message");
+
+  const QByteArray rois = R"("rois": [{"name": "a", "file": "a.hobj"}, {"name": "b", "file": "b.hobj"}])";
+  auto recipe = [&rois](const QByteArray& tools) -> QByteArray
+  {
+    return "{" + rois + R"(, "tools": [)" + tools + "]}";
+  };
+
+  QTest::newRow("no tools") << QByteArray(R"({"rois": [], "tools": []})") << QString("没有工具");
+  QTest::newRow("roi without source or file")
+      << QByteArray(R"({"rois": [{"name": "a"}], "tools": [{"name": "t", "type": "area", "roi": "a"}]})")
+      << QString("须且只能指定");
+  QTest::newRow("roi with source and file")
+      << QByteArray(R"({"rois": [{"name": "a", "source": "measure_rect1", "file": "a.hobj"}],
+                       "tools": [{"name": "t", "type": "area", "roi": "a"}]})")
+      << QString("须且只能指定");
+  QTest::newRow("unknown roi source")
+      << QByteArray(R"({"rois": [{"name": "a", "source": "measure_rect3"}],
+                       "tools": [{"name": "t", "type": "area", "roi": "a"}]})")
+      << QString("source 未知");
+  QTest::newRow("duplicate roi")
+      << QByteArray(R"({"rois": [{"name": "a", "file": "a.hobj"}, {"name": "a", "file": "b.hobj"}],
+                       "tools": [{"name": "t", "type": "area", "roi": "a"}]})")
+      << QString("ROI 名称为空或重复");
+  QTest::newRow("duplicate tool")
+      << recipe(R"({"name": "t", "type": "area", "roi": "a"}, {"name": "t", "type": "area", "roi": "b"})")
+      << QString("工具名称为空或重复");
+  QTest::newRow("unnamed tool") << recipe(R"({"type": "area", "roi": "a"})") << QString("工具名称为空或重复");
+  QTest::newRow("unknown type") << recipe(R"({"name": "t", "type": "blob", "roi": "a"})") << QString("类型未知");
+  QTest::newRow("missing roi") << recipe(R"({"name": "t", "type": "contour", "roi": "c"})")
+                               << QString("引用的 ROI 不存在");
+  QTest::newRow("roi omitted") << recipe(R"({"name": "t", "type": "edge"})") << QString("引用的 ROI 不存在");
+  QTest::newRow("one input")
+      << recipe(R"({"name": "e1", "type": "contour", "roi": "a"},
+                   {"name": "gap", "type": "distance", "inputs": ["e1"]})")
+      << QString("需要 2 个输入");
+  QTest::newRow("three inputs")
+      << recipe(R"({"name": "p1", "type": "area", "roi": "a"}, {"name": "p2", "type": "area", "roi": "b"},
+                   {"name": "d", "type": "point_distance", "inputs": ["p1", "p2", "p1"]})")
+      << QString("需要 2 个输入");
+  QTest::newRow("unknown input")
+      << recipe(R"({"name": "e1", "type": "contour", "roi": "a"},
+                   {"name": "gap", "type": "distance", "inputs": ["e1", "e3"]})")
+      << QString("输入无效");
+  QTest::newRow("self input")
+      << recipe(R"({"name": "e1", "type": "contour", "roi": "a"},
+                   {"name": "gap", "type": "distance", "inputs": ["e1", "gap"]})")
+      << QString("输入无效");
+  QTest::newRow("distance of areas")
+      << recipe(R"({"name": "p1", "type": "area", "roi": "a"}, {"name": "p2", "type": "area", "roi": "b"},
+                   {"name": "gap", "type": "distance", "inputs": ["p1", "p2"]})")
+      << QString("类型不符");
+  QTest::newRow("point distance of contours")
+      << recipe(R"({"name": "e1", "type": "contour", "roi": "a"}, {"name": "e2", "type": "contour", "roi": "b"},
+                   {"name": "d", "type": "point_distance", "inputs": ["e1", "e2"]})")
+      << QString("类型不符");
+  // point_distance 只接受 area/edge，两个 point_distance 互相引用（依赖环）在类型检查时被拒绝
+  QTest::newRow("dependency cycle")
+      << recipe(R"({"name": "d1", "type": "point_distance", "inputs": ["d2", "d2"]},
+                   {"name": "d2", "type": "point_distance", "inputs": ["d1", "d1"]})")
+      << QString("类型不符");
+  QTest::newRow("unknown output value")
+      << recipe(R"({"name": "t", "type": "area", "roi": "a", "record": {"length": "Area1"}})")
+      << QString("记录映射无效");
+  QTest::newRow("unknown record field")
+      << recipe(R"({"name": "t", "type": "area", "roi": "a", "record": {"area": "Volume"}})")
+      << QString("记录映射无效");
+  QTest::newRow("unknown tolerance value")
+      << recipe(R"({"name": "t", "type": "area", "roi": "a", "tolerance": {"value": "width", "max": 5}})")
+      << QString("公差引用了未知输出值");
+  QTest::newRow("direction as text")
+      << recipe(R"({"name": "t", "type": "width", "roi": "a", "direction": "90"})")
+      << QString("direction 须为角度数值");
+}
+
+void TestInspectionPlan::rejectsInvalidRecipe()
+{
+  QFETCH(QByteArray, recipe);
+  QFETCH(QString, message);
+
+  const QJsonObject object = parse(recipe);
+  QVERIFY(!object.isEmpty());
+  QString error;
+  QVERIFY(!InspectionPlan::validate(object, error));
+  QVERIFY2(error.contains(message), qPrintable(error));
+}
+
+// 输入可以引用写在后面的工具
+void TestInspectionPlan::acceptsForwardReferences()
+{
+  const QJsonObject recipe = parse(R"({
+    "rois": [{"name": "a", "file": "a.hobj"}, {"name": "b", "file": "b.hobj"}],
+    "tools": [
+      {"name": "gap", "type": "point_distance", "inputs": ["left", "right"], "record": {"distance": "CentroidDistance"},
+       "tolerance": {"min": 1.0, "max": 2.0}},
+      {"name": "left", "type": "edge", "roi": "a", "direction": 90},
+      {"name": "right", "type": "area", "roi": "b"}
+    ]})");
+  QString error;
+  QVERIFY2(InspectionPlan::validate(recipe, error), qPrintable(error));
+}
+
+// 层号 = 输入层号最大值 + 1：contour/area/edge 在第0层，distance/point_distance 在第1层
+void TestInspectionPlan::compilesIntoDependencyStages()
+{
+  const QJsonObject recipe = parse(R"({
+    "name": "stages",
+    "rois": [{"name": "a", "file": "a.hobj"}, {"name": "b", "file": "regions/../b.hobj"}],
+    "tools": [
+      {"name": "gap", "type": "distance", "inputs": ["e1", "e2"]},
+      {"name": "e1", "type": "contour", "roi": "a"},
+      {"name": "e2", "type": "contour", "roi": "b"},
+      {"name": "p1", "type": "area", "roi": "a"},
+      {"name": "p2", "type": "edge", "roi": "b"},
+      {"name": "d", "type": "point_distance", "inputs": ["p1", "p2"]}
+    ]})");
+  const TemplateSet templateSet = templateSetWithRegions(QStringList() << "a.hobj" << "b.hobj");
+
+  QString error;
+  InspectionPlanPtr plan = InspectionPlan::compile(recipe, templateSet, QDir::currentPath(), error);
+  QVERIFY2(plan != nullptr, qPrintable(error));
+  QCOMPARE(plan->name(), QString("stages"));
+  QCOMPARE(plan->stepCount(), 6);
+  QCOMPARE(plan->stageCount(), 2);
+
+  InspectionPlanPtr again = InspectionPlan::compile(recipe, templateSet, QDir::currentPath(), error);
+  QVERIFY(again != nullptr);
+  QVERIFY(again->id() != plan->id());
+
+  // 每线程状态按计划分配，计划未变化时不重新分配
+  InspectionPlanState state;
+  plan->prepare(state);
+  QCOMPARE(state.planId, plan->id());
+  QCOMPARE(state.outputs.size(), 6);
+  QCOMPARE(state.mappedRois.size(), 2);
+  state.outputs[0].ok = true;
+  plan->prepare(state);
+  QVERIFY(state.outputs[0].ok);
+  again->prepare(state);
+  QVERIFY(!state.outputs[0].ok);
+}
+
+void TestInspectionPlan::parallelModeFollowsRecipe_data()
+{
+  QTest::addColumn<QByteArray>("parallel");
+  QTest::addColumn<bool>("singleWorker");
+  QTest::addColumn<bool>("multiWorker");
+
+  // 省略或非布尔值时按检测线程数决定（单线程并行，多线程顺序执行）
+  QTest::newRow("omitted") << QByteArray() << true << false;
+  QTest::newRow("not a bool") << QByteArray(R"("parallel": "yes",)") << true << false;
+  QTest::newRow("enabled") << QByteArray(R"("parallel": true,)") << true << true;
+  QTest::newRow("disabled") << QByteArray(R"("parallel": false,)") << false << false;
+}
+
+void TestInspectionPlan::parallelModeFollowsRecipe()
+{
+  QFETCH(QByteArray, parallel);
+  QFETCH(bool, singleWorker);
+  QFETCH(bool, multiWorker);
+
+  const QJsonObject recipe = parse("{" + parallel + R"(
+    "rois": [{"name": "a", "file": "a.hobj"}],
+    "tools": [{"name": "p", "type": "area", "roi": "a"}]})");
+  QString error;
+  InspectionPlanPtr plan =
+      InspectionPlan::compile(recipe, templateSetWithRegions(QStringList() << "a.hobj"), QDir::currentPath(), error);
+  QVERIFY2(plan != nullptr, qPrintable(error));
+
+  InspectionPlanState state;
+  state.parallelByDefault = true;
+  QCOMPARE(plan->isParallel(state), singleWorker);
+  state.parallelByDefault = false;
+  QCOMPARE(plan->isParallel(state), multiWorker);
+}
+
+QTEST_APPLESS_MAIN(TestInspectionPlan)
+
+#include "tst_inspectionplan.moc"
@@ -0,0 +1,147 @@
+/**
+ * @file tst_inspectionpool.cpp
+ * @brief 多线程检测池按序发出与任务窃取测试 | Inspection pool in-order delivery and work stealing tests
+ *
+ * 形状模板由合成图像在临时目录中生成。两个检测线程按轮询分到偶数帧和奇数帧：
+ * 偶数帧为大图（全图匹配较慢），奇数帧为未初始化图像（立即返回），
+ * 处理奇数帧的线程先空闲，从另一线程队列尾部窃取任务，结果仍须按提交顺序发出。
+ */
+
+#include "../../inc/thread/InspectionPool.h"
+
+#include <QDir>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <memory>
+
+namespace
+{
+constexpr int kFrameCount = 24;
+constexpr int kLargeSize = 1024;
+
+// 黑底白色矩形
+HObject rectangleImage(int width, int height)
+{
+  HObject image, rectangle, painted;
+  GenImageConst(&image, "byte", width, height);
+  GenRectangle1(&rectangle, height / 2 - 40, width / 2 - 60, height / 2 + 40, width / 2 + 60);
+  PaintRegion(rectangle, image, &painted, 255, "fill");
+  return painted;
+}
+}
+
+class TestInspectionPool : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void deliversInOrderWithStealing();
+  void beginBatchRestartsSequence();
+
+private:
+  std::unique_ptr<InspectionPool> createPool(QList<InspectionResult>& results);
+  void submitFrames(InspectionPool& pool, int count);
+
+  QTemporaryDir m_directory;
+  TemplateCache m_cache;
+  HObject m_largeImage;
+};
+
+void TestInspectionPool::initTestCase()
+{
+  QVERIFY(m_directory.isValid());
+  const QString modelDir = m_directory.path() + "/model";
+  QVERIFY(QDir().mkpath(modelDir));
+
+  HObject templateImage = rectangleImage(256, 256);
+  HObject templateRegion, reduced;
+  GenRectangle1(&templateRegion, 68, 48, 188, 208);
+  ReduceDomain(templateImage, templateRegion, &reduced);
+  HTuple modelId;
+  CreateShapeModel(reduced, "auto", 0, HTuple(360).TupleRad(), "auto", "auto", "use_polarity", "auto", "auto",
+                   &modelId);
+  WriteShapeModel(modelId, (modelDir + "/model.shm").toStdString().c_str());
+  ClearShapeModel(modelId);
+
+  m_cache.setPaths(modelDir, m_directory.path() + "/measure");
+  QVERIFY(m_cache.reload());
+  m_largeImage = rectangleImage(kLargeSize, kLargeSize);
+}
+
+std::unique_ptr<InspectionPool> TestInspectionPool::createPool(QList<InspectionResult>& results)
+{
+  std::unique_ptr<InspectionPool> pool(new InspectionPool(&m_cache, 2));
+  // 结果在检测线程中按序发出（持有重排序锁），waitForDone() 之后读取
+  connect(pool.get(), &InspectionPool::resultReady, pool.get(), [&results](const InspectionResult& result)
+  {
+    results.append(result);
+  }, Qt::DirectConnection);
+  return pool;
+}
+
+// 轮询分发：偶数帧进入线程0的队列，奇数帧进入线程1的队列
+void TestInspectionPool::submitFrames(InspectionPool& pool, int count)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    const HObject image = i % 2 == 0 ? m_largeImage : HObject();
+    QCOMPARE(pool.submit(image, QString("frame_%1").arg(i)), qint64(i));
+  }
+}
+
+void TestInspectionPool::deliversInOrderWithStealing()
+{
+  QList<InspectionResult> results;
+  std::unique_ptr<InspectionPool> pool = createPool(results);
+  QCOMPARE(pool->workerCount(), 2);
+
+  // 先提交再启动，任务分布不受启动时序影响
+  submitFrames(*pool, kFrameCount);
+  pool->start();
+  QVERIFY(pool->waitForDone(60000));
+
+  QCOMPARE(results.size(), kFrameCount);
+  for (int i = 0; i < results.size(); ++i)
+  {
+    QCOMPARE(results.at(i).sequence, qint64(i));
+    QCOMPARE(results.at(i).record.sequence, qint64(i));
+    QCOMPARE(results.at(i).imagePath, QString("frame_%1").arg(i));
+  }
+
+  quint64 processed = 0;
+  quint64 stolen = 0;
+  for (const InspectionWorkerStats& stats : pool->workerStats())
+  {
+    processed += stats.processed;
+    stolen += stats.stolen;
+  }
+  QCOMPARE(processed, quint64(kFrameCount));
+  QVERIFY(stolen > 0);
+  pool->stop();
+}
+
+void TestInspectionPool::beginBatchRestartsSequence()
+{
+  QList<InspectionResult> results;
+  std::unique_ptr<InspectionPool> pool = createPool(results);
+  pool->start();
+
+  submitFrames(*pool, 6);
+  QVERIFY(pool->waitForDone(60000));
+  pool->beginBatch();
+  submitFrames(*pool, 6);
+  QVERIFY(pool->waitForDone(60000));
+
+  QCOMPARE(results.size(), 12);
+  for (int i = 0; i < results.size(); ++i)
+  {
+    QCOMPARE(results.at(i).sequence, qint64(i % 6));
+  }
+  pool->stop();
+}
+
+QTEST_GUILESS_MAIN(TestInspectionPool)
+
+#include "tst_inspectionpool.moc"
@@ -0,0 +1,180 @@
+/**
+ * @file tst_latencyhistogram.cpp
+ * @brief LatencyHistogram 分桶与分位数测试 | Bucket math and percentile tests for LatencyHistogram
+ */
+
+#include "../../inc/thread/LatencyProfiler.h"
+
+#include <QtTest>
+
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+class TestLatencyHistogram : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void smallValuesHaveExactBuckets();
+  void bucketsAreContiguous();
+  void valuesFallInsideTheirBucket();
+  void bucketWidthWithinRelativeError();
+  void emptySnapshot();
+  void snapshotPercentiles();
+  void percentilesDoNotExceedMax();
+  void resetClearsSamples();
+  void concurrentRecording();
+};
+
+// 0..7 每个值独占一个桶
+void TestLatencyHistogram::smallValuesHaveExactBuckets()
+{
+  for (int value = 0; value < LatencyHistogram::kSubBuckets; ++value)
+  {
+    QCOMPARE(LatencyHistogram::bucketIndex(value), value);
+    QCOMPARE(LatencyHistogram::bucketLowerBound(value), std::uint64_t(value));
+    QCOMPARE(LatencyHistogram::bucketUpperBound(value), std::uint64_t(value));
+  }
+}
+
+// 相邻桶首尾相接，覆盖 [0, 2^64)，最大值落在最后一个桶
+void TestLatencyHistogram::bucketsAreContiguous()
+{
+  for (int index = 0; index < LatencyHistogram::kBucketCount; ++index)
+  {
+    const std::uint64_t lower = LatencyHistogram::bucketLowerBound(index);
+    const std::uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+    QVERIFY(lower <= upper);
+    QCOMPARE(LatencyHistogram::bucketIndex(lower), index);
+    QCOMPARE(LatencyHistogram::bucketIndex(upper), index);
+    if (index + 1 < LatencyHistogram::kBucketCount)
+    {
+      QCOMPARE(LatencyHistogram::bucketLowerBound(index + 1), upper + 1);
+    }
+  }
+  QCOMPARE(LatencyHistogram::bucketIndex(std::numeric_limits<std::uint64_t>::max()),
+           LatencyHistogram::kBucketCount - 1);
+  QCOMPARE(LatencyHistogram::bucketUpperBound(LatencyHistogram::kBucketCount - 1),
+           std::numeric_limits<std::uint64_t>::max());
+}
+
+void TestLatencyHistogram::valuesFallInsideTheirBucket()
+{
+  std::vector<std::uint64_t> values;
+  for (std::uint64_t value = 0; value < 5000; ++value)
+  {
+    values.push_back(value);
+  }
+  for (int bit = 3; bit < 64; ++bit)
+  {
+    const std::uint64_t power = std::uint64_t(1) << bit;
+    values.push_back(power - 1);
+    values.push_back(power);
+    values.push_back(power + 1);
+  }
+  std::mt19937_64 rng(5);
+  for (int i = 0; i < 10000; ++i)
+  {
+    values.push_back(rng() >> (rng() % 64));
+  }
+
+  for (std::uint64_t value : values)
+  {
+    const int index = LatencyHistogram::bucketIndex(value);
+    QVERIFY2(index >= 0 && index < LatencyHistogram::kBucketCount, qPrintable(QString::number(value)));
+    QVERIFY2(LatencyHistogram::bucketLowerBound(index) <= value && value <= LatencyHistogram::bucketUpperBound(index),
+             qPrintable(QString::number(value)));
+  }
+}
+
+// 每个2的幂区间8个子桶：桶宽不超过下界的 1/8
+void TestLatencyHistogram::bucketWidthWithinRelativeError()
+{
+  for (int index = LatencyHistogram::kSubBuckets; index < LatencyHistogram::kBucketCount; ++index)
+  {
+    const std::uint64_t lower = LatencyHistogram::bucketLowerBound(index);
+    const std::uint64_t width = LatencyHistogram::bucketUpperBound(index) - lower;
+    QVERIFY2(width < lower / LatencyHistogram::kSubBuckets + 1, qPrintable(QString::number(index)));
+  }
+}
+
+void TestLatencyHistogram::emptySnapshot()
+{
+  LatencyHistogram histogram;
+  const LatencySnapshot snapshot = histogram.snapshot();
+  QCOMPARE(snapshot.count, std::uint64_t(0));
+  QCOMPARE(snapshot.p50Us, 0.0);
+  QCOMPARE(snapshot.maxUs, 0.0);
+}
+
+// 1..100 us 均匀分布：均值和最大值精确，分位数误差不超过桶宽
+void TestLatencyHistogram::snapshotPercentiles()
+{
+  LatencyHistogram histogram;
+  for (int us = 1; us <= 100; ++us)
+  {
+    histogram.record(std::uint64_t(us) * 1000);
+  }
+  const LatencySnapshot snapshot = histogram.snapshot();
+  QCOMPARE(snapshot.count, std::uint64_t(100));
+  QCOMPARE(snapshot.meanUs, 50.5);
+  QCOMPARE(snapshot.maxUs, 100.0);
+  QVERIFY2(qAbs(snapshot.p50Us - 50.0) <= 50.0 / 8, qPrintable(QString::number(snapshot.p50Us)));
+  QVERIFY2(qAbs(snapshot.p95Us - 95.0) <= 95.0 / 8, qPrintable(QString::number(snapshot.p95Us)));
+  QVERIFY2(qAbs(snapshot.p99Us - 99.0) <= 99.0 / 8, qPrintable(QString::number(snapshot.p99Us)));
+  QVERIFY(snapshot.p50Us <= snapshot.p95Us && snapshot.p95Us <= snapshot.p99Us);
+}
+
+// 1024 位于桶 [1024, 1151] 的下界，桶中点大于最大样本，分位数须截断到最大值
+void TestLatencyHistogram::percentilesDoNotExceedMax()
+{
+  LatencyHistogram histogram;
+  histogram.record(1024);
+  const LatencySnapshot snapshot = histogram.snapshot();
+  QCOMPARE(snapshot.p50Us, 1.024);
+  QCOMPARE(snapshot.p99Us, 1.024);
+}
+
+void TestLatencyHistogram::resetClearsSamples()
+{
+  LatencyHistogram histogram;
+  histogram.record(123456);
+  histogram.reset();
+  QCOMPARE(histogram.snapshot().count, std::uint64_t(0));
+  histogram.record(10);
+  QCOMPARE(histogram.snapshot().count, std::uint64_t(1));
+  QCOMPARE(histogram.snapshot().maxUs, 0.01);
+}
+
+// 多个检测线程并发记录时计数不丢失
+void TestLatencyHistogram::concurrentRecording()
+{
+  LatencyHistogram histogram;
+  const int threadCount = 4;
+  const int samplesPerThread = 20000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threadCount; ++t)
+  {
+    threads.emplace_back([&histogram, t]()
+    {
+      for (int i = 0; i < samplesPerThread; ++i)
+      {
+        histogram.record(std::uint64_t(t + 1) * 1000);
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  const LatencySnapshot snapshot = histogram.snapshot();
+  QCOMPARE(snapshot.count, std::uint64_t(threadCount * samplesPerThread));
+  QCOMPARE(snapshot.maxUs, double(threadCount));
+  QCOMPARE(snapshot.meanUs, 2.5);
+}
+
+QTEST_APPLESS_MAIN(TestLatencyHistogram)
+
+#include "tst_latencyhistogram.moc"
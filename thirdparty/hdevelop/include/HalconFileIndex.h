@@ -0,0 +1,194 @@
+#ifndef HALCONFILEINDEX_H
+#define HALCONFILEINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @brief 文件索引项 | File Index Entry
+ */
+struct HalconFileEntry {
+    QString path;                 // 绝对路径 | Absolute path
+    QString fileName;             // 文件名 | File name
+    QString suffix;               // 完整后缀（不含点）| Complete suffix without the dot
+    QString fileType;             // Halcon文件类型，非Halcon文件为空 | Halcon file type, empty for other files
+    qint64 size = 0;              // 文件大小 | File size
+    qint64 modifiedMs = 0;        // 修改时间(ms, 自纪元起) | Modification time (ms since epoch)
+};
+
+/**
+ * @brief 文件索引统计信息 | File Index Statistics
+ */
+struct HalconFileIndexStats {
+    int directories = 0;          // 目录数 | Indexed directories
+    int files = 0;                // 文件数 | Indexed files
+    int watchedDirectories = 0;   // 监视中的目录数 | Directories under change notification
+    int rescannedDirectories = 0; // 最近一次构建/校验时重新列出的目录数 | Directories relisted by the last build/revalidation
+    qint64 lastBuildMs = 0;       // 最近一次构建/校验耗时 | Duration of the last build/revalidation
+    bool loadedFromCache = false; // 是否由缓存文件加载 | Whether the index was loaded from its cache file
+    quint64 incrementalUpdates = 0; // 按变化通知增量更新的目录次数 | Directory updates from change notifications
+};
+
+/**
+ * @brief 持久化的目录文件索引 | Persistent Directory File Index
+ *
+ * 🎯 为 HalconFileManager 的目录统计、按类型查找和清理提供内存索引，避免每次调用都递归遍历并逐个 stat 文件。
+ * - 冷构建：多个线程并行遍历目录树；
+ * - 持久化：索引保存在缓存文件中，下次打开时每个目录只 stat 一次，修改时间未变的目录直接沿用缓存；
+ * - 增量更新：QFileSystemWatcher 通知的目录变化合并后只重新列出该目录；目录过多无法全部监视时，
+ *   查询前按间隔校验目录修改时间。
+ *
+ * 目录修改时间只在增删、重命名文件时变化：程序未运行期间原地改写的文件，其大小和时间在该目录下次变化时才更新。
+ *
+ * Keeps an in-memory index of a directory tree. Cold builds walk the tree with parallel workers; the index
+ * is persisted and revalidated with one stat per directory; change notifications relist only the affected
+ * directory. Files rewritten in place while the application was not running are refreshed the next time
+ * their directory changes.
+ *
+ * 查询可在任意线程调用；refresh() 和变化通知处理需在索引所属线程中执行。
+ * Queries are thread-safe; refresh and notification handling run in the owning thread.
+ */
+class HalconFileIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 根据文件名返回Halcon文件类型 | Resolves the Halcon file type from a file name
+     */
+    typedef std::function<QString(const QString& fileName)> TypeResolver;
+
+    /**
+     * @param rootPath 索引根目录 | Root directory
+     * @param resolver 文件类型解析函数 | File type resolver
+     * @param parent 父对象 | Parent object
+     */
+    HalconFileIndex(const QString& rootPath, TypeResolver resolver, QObject* parent = nullptr);
+    ~HalconFileIndex() override;
+
+    QString rootPath() const { return m_rootPath; }
+
+    /**
+     * @brief 设置缓存文件路径，为空时不持久化 | Set the cache file path; empty disables persistence
+     */
+    void setCachePath(const QString& cachePath);
+    QString cachePath() const { return m_cachePath; }
+
+    /**
+     * @brief 默认缓存文件路径（按根目录区分）| Default cache file for a root directory
+     */
+    static QString defaultCachePath(const QString& rootPath);
+
+    /**
+     * @brief 设置并行遍历线程数，0表示按CPU核数 | Set walker thread count, 0 uses the core count
+     */
+    void setWalkerThreads(int threads);
+
+    /**
+     * @brief 设置最多监视的目录数，超过时改为查询前按间隔校验 | Limit watched directories; beyond it revalidate on query
+     */
+    void setMaxWatchedDirectories(int count);
+
+    /**
+     * @brief 设置未监视时的校验间隔 | Revalidation interval used when not watching
+     */
+    void setRevalidateInterval(int ms) { m_revalidateIntervalMs = ms; }
+
+    /**
+     * @brief 打开索引：加载缓存并校验，没有缓存时冷构建 | Open: load and revalidate the cache, or cold-build
+     * @return 根目录不存在时返回false | False when the root directory does not exist
+     */
+    bool open();
+
+    /**
+     * @brief 丢弃缓存，重新构建 | Discard cached data and rebuild
+     */
+    void rebuild();
+
+    /**
+     * @brief 使索引反映已收到的变化通知（未监视时按间隔校验）| Apply pending notifications or revalidate
+     */
+    void refresh();
+
+    /**
+     * @brief 保存缓存文件 | Save the cache file
+     */
+    bool save();
+
+    /**
+     * @brief 遍历目录（含子目录）下的文件 | Visit files under a directory, recursively
+     * @param underPath 绝对路径，为空时遍历整个索引 | Absolute path; the whole index when empty
+     * @param visitor 回调，持有读锁期间调用，不得修改索引 | Called under the read lock; must not modify the index
+     */
+    void forEachFile(const QString& underPath, const std::function<void(const HalconFileEntry&)>& visitor) const;
+
+    /**
+     * @brief 通知索引文件已被删除（例如清理旧文件后）| Tell the index a file was removed
+     */
+    void removeFile(const QString& path);
+
+    HalconFileIndexStats stats() const;
+
+    /**
+     * @brief 规范化为绝对路径 | Normalize to a clean absolute path
+     */
+    static QString normalizePath(const QString& path);
+
+signals:
+    /**
+     * @brief 索引内容发生变化 | Emitted after the index content changed
+     */
+    void indexChanged();
+
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void processDirtyDirectories();
+
+private:
+    struct DirectoryNode {
+        qint64 modifiedMs = 0;
+        QVector<HalconFileEntry> files;
+        QStringList subdirectories;
+    };
+
+    typedef QHash<QString, DirectoryNode> DirectoryMap;
+
+    void walk(const QStringList& roots, const DirectoryMap& previous, DirectoryMap* result, int* rescanned) const;
+    bool scanDirectory(const QString& path, DirectoryNode* node) const;
+    void removeSubtreeLocked(const QString& path, QStringList* removedDirectories);
+    void updateWatcher(const QStringList& added, const QStringList& removed);
+    bool loadCache(DirectoryMap* directories) const;
+    void resolveTypes(DirectoryNode* node) const;
+    static bool isUnder(const QString& path, const QString& directory);
+
+private:
+    QString m_rootPath;
+    TypeResolver m_resolver;
+    QString m_cachePath;
+    int m_walkerThreads = 0;
+    int m_maxWatchedDirectories = 4096;
+    int m_revalidateIntervalMs = 2000;
+
+    mutable QReadWriteLock m_lock;              // 保护 m_directories 和统计
+    DirectoryMap m_directories;                 // 目录绝对路径 → 目录内容
+    HalconFileIndexStats m_stats;
+    bool m_open = false;
+    bool m_cacheDirty = false;
+    qint64 m_lastRevalidateMs = 0;
+
+    QFileSystemWatcher* m_watcher = nullptr;
+    QTimer* m_dirtyTimer = nullptr;             // 合并短时间内的多次变化通知
+    QSet<QString> m_dirtyDirectories;
+};
+
+#endif // HALCONFILEINDEX_H
@@ -7,7 +7,9 @@
 #include <QStringList>
 #include <QDateTime>
 #include <QDirIterator>
+#include <functional>
 #include "halconcpp/HalconCpp.h"
+#include "HalconFileIndex.h"
 
 using namespace HalconCpp;
 
@@ -46,6 +48,7 @@ public:
      * @param parent 父QObject对象，用于Qt内存管理 | Parent QObject for Qt memory management
      */
     explicit HalconFileManager(QObject *parent = nullptr);
+    ~HalconFileManager() override;
     
     // 🎯 文件扩展名管理 | File Extension Management
     /**
@@ -176,11 +179,37 @@ public:
      */
     bool createProjectDirectory(const QString& projectName, const QString& basePath = "./") const;
     
+    // 🗂️ 文件索引 | File Index
+    /**
+     * @brief 启用或停用持久化文件索引（默认启用）
+     * Enable or disable the persistent file index (enabled by default)
+     *
+     * 启用时目录统计、按类型查找和清理旧文件由索引提供结果，停用时每次调用递归遍历目录
+     * When enabled, statistics, lookups and cleanup are served from the index; otherwise every call walks the tree
+     *
+     * @param enabled 是否启用 | Whether enabled
+     */
+    void setFileIndexEnabled(bool enabled);
+    bool isFileIndexEnabled() const { return m_fileIndexEnabled; }
+
+    /**
+     * @brief 获取覆盖指定目录的文件索引，不存在时构建（加载缓存或并行遍历）
+     * Get the file index covering a directory, building it (from cache or by parallel walk) when missing
+     *
+     * @param directoryPath 目录路径 | Directory path
+     * @return HalconFileIndex* 索引，未启用或目录不存在时返回nullptr | Index, nullptr when disabled or missing
+     */
+    HalconFileIndex* fileIndex(const QString& directoryPath) const;
+
     // 📊 文件统计 | File Statistics
     /**
      * @brief 分析目录中的文件并生成统计信息
      * Analyze files in a directory and generate statistics
      *
+     * 启用文件索引时大小和修改时间取自索引，不逐个 stat：原地改写（未增删文件）的文件在其目录下次变化前仍为旧值
+     * With the file index enabled, sizes and times come from the index without a per-file stat; a file rewritten
+     * in place keeps its old values until its directory next changes
+     *
      * @param directoryPath 要分析的目录路径 | Directory path to analyze
      * @return FileStats 包含各种文件统计信息的结构 | Structure containing various file statistics
      */
@@ -192,7 +221,7 @@ public:
      *
      * @param directoryPath 要搜索的目录路径 | Directory path to search
      * @param fileType 文件类型标识符 | File type identifier
-     * @return QStringList 匹配文件的路径列表 | List of matching file paths
+     * @return QStringList 匹配文件的绝对路径列表（已排序）| Sorted list of matching absolute file paths
      */
     QStringList findFilesByType(const QString& directoryPath, const QString& fileType) const;
 
@@ -201,7 +230,7 @@ public:
      * Get all Halcon-related files in a directory
      *
      * @param directoryPath 要搜索的目录路径 | Directory path to search
-     * @return QStringList 所有Halcon文件的路径列表 | List of all Halcon file paths
+     * @return QStringList 所有Halcon文件的绝对路径列表（已排序）| Sorted list of all Halcon file absolute paths
      */
     QStringList getAllHalconFiles(const QString& directoryPath) const;
     
@@ -210,6 +239,9 @@ public:
      * @brief 清理指定天数之前的旧文件
      * Clean up old files created before the specified number of days
      *
+     * 候选文件由索引给出，删除前重新检查文件是否存在及其修改时间
+     * Candidates come from the index; each one is re-checked on disk before it is removed
+     *
      * @param directoryPath 要清理的目录路径 | Directory path to clean
      * @param daysOld 文件的最大保留天数 | Maximum number of days to retain files
      * @return bool 如果清理操作成功返回true，否则false | Returns true if cleanup was successful, otherwise false
@@ -277,9 +309,17 @@ private:
      * @return QString 格式化后的文件大小（如"1.2 MB"）| Formatted file size (e.g. "1.2 MB")
      */
     QString formatFileSize(qint64 size) const;
+
+    /**
+     * @brief 遍历目录（含子目录）下的文件：有索引时读取索引，否则递归遍历
+     * Visit files under a directory recursively: from the index when available, otherwise by walking
+     */
+    void forEachFile(const QString& directoryPath, const std::function<void(const HalconFileEntry&)>& visitor) const;
     
     QMap<QString, QString> m_extensionMap;       // 文件扩展名映射表 | File extension mapping
     QStringList m_standardDirectories;          // 标准目录结构 | Standard directory structure
+    bool m_fileIndexEnabled = true;             // 是否启用文件索引 | Whether the file index is enabled
+    mutable QList<HalconFileIndex*> m_fileIndexes; // 各根目录的文件索引 | File indexes by root directory
 };
 
 #endif // HALCONFILEMANAGER_H
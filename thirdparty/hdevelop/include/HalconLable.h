@@ -19,6 +19,9 @@
 
 // Halcon机器视觉库头文件 | Halcon Machine Vision Library Header
 #include "halconcpp/HalconCpp.h"
+#include "ImageEditHistory.h"
+#include "ImageStatistics.h"
+#include "HalconMeasure.h"
 
 // Qt基础框架头文件 | Qt Framework Base Headers
 #include <QWidget>       // Qt窗口控件基类 | Qt widget base class
@@ -31,7 +34,9 @@
 // Qt工具类头文件 | Qt Utility Headers
 #include <QDateTime>     // 日期时间处理 | Date time handling
 #include <QDebug>        // 调试输出 | Debug output
+#include <QElapsedTimer> // 计时器 | Elapsed timer
 #include <QTimer>        // 定时器 | Timer
+#include <QVector>       // 向量容器 | Vector container
 #include <QtMath>        // 数学函数 | Math functions
 #include <QColor>        // 颜色处理 | Color handling
 
@@ -55,6 +60,8 @@
 #include <QRegExpValidator> // 正则表达式验证器 | Regular expression validator
 #include <QStringListModel> // 字符串列表模型 | String list model
 
+#include <functional>    // 回调函数 | Callbacks
+
 // 使用Halcon命名空间 | Using Halcon Namespace
 using namespace HalconCpp;
 
@@ -133,6 +140,45 @@ struct CodeData {
 };
 Q_DECLARE_METATYPE(CodeData);
 
+/**
+ * @struct DisplayStyle
+ * @brief 叠加对象显示样式 | Overlay Display Style
+ *
+ * 颜色、线宽和绘制模式相同的叠加对象归为一组，合并后一次 DispObj 绘制。
+ * Overlays sharing colour, line width and draw mode are concatenated and drawn with one DispObj.
+ */
+struct DisplayStyle {
+  QString color = "green";       // ch:Halcon颜色名或#rrggbb | en:Halcon colour name or #rrggbb
+  double lineWidth = 2.0;        // ch:线宽 | en:Line width
+  QString drawMode = "margin";   // ch:绘制模式 margin/fill | en:Draw mode margin/fill
+
+  DisplayStyle() {}
+  DisplayStyle(const QString& styleColor, double styleLineWidth, const QString& styleDrawMode = "margin")
+      : color(styleColor.isEmpty() ? QString("green") : styleColor),
+        lineWidth(styleLineWidth > 0 ? styleLineWidth : 2.0),
+        drawMode(styleDrawMode.isEmpty() ? QString("margin") : styleDrawMode) {}
+
+  bool operator==(const DisplayStyle& other) const {
+    return color == other.color && qFuzzyCompare(lineWidth, other.lineWidth) && drawMode == other.drawMode;
+  }
+};
+
+/**
+ * @struct DisplayOverlay
+ * @brief 带显示样式的叠加对象 | Overlay Object with Explicit Style
+ *
+ * 可由 HObject 隐式构造（默认样式：绿色、线宽2、margin）。
+ * Implicitly constructible from HObject (default style: green, width 2, margin).
+ */
+struct DisplayOverlay {
+  HObject object;                // ch:区域或XLD对象 | en:Region or XLD object
+  DisplayStyle style;            // ch:显示样式 | en:Display style
+
+  DisplayOverlay() {}
+  DisplayOverlay(const HObject& overlayObject, const DisplayStyle& overlayStyle = DisplayStyle())
+      : object(overlayObject), style(overlayStyle) {}
+};
+
 /**
  * @class HalconLable
  * @brief Halcon图像显示控件类 | Halcon Image Display Widget Class
@@ -171,7 +217,7 @@ public:
   /* ==================== 公有成员变量 | Public Member Variables ==================== */
   bool isMove;                              // ch:是否允许移动标志 | en:Movement allowed flag
   HTuple HColor = "green";                  // ch:默认显示颜色 | en:Default display color
-  QList<HObject> showSymbolList;            // ch:显示符号列表，用于保存显示的对象 | en:Display symbol list for saving displayed objects
+  QList<DisplayOverlay> showSymbolList;     // ch:显示符号列表，保存显示的对象及其样式 | en:Display symbol list with per-object style
   
   /* ==================== 基础图像操作接口 | Basic Image Operation Interface ==================== */
   
@@ -215,6 +261,27 @@ public:
    * @param inputImage 要显示的图像对象 | Image object to display
    */
   void showImage(HObject inputImage);
+
+  /**
+   * @brief 同时显示图像和叠加对象 | Show Image Together with Overlays
+   * @param inputImage 要显示的图像对象 | Image object to display
+   * @param overlays 替换当前显示列表的叠加对象 | Overlays replacing the current display list
+   *
+   * 只渲染一次，适用于连续出图；等价于 clearDisplayObjectsOnly + showImage + 多次 addDisplayObject。
+   * Renders once; equivalent to clearDisplayObjectsOnly + showImage + repeated addDisplayObject.
+   */
+  void showImageWithOverlays(HObject inputImage, const QList<DisplayOverlay>& overlays);
+
+  /**
+   * @brief 应用一次可撤销的图像编辑 | Apply an Undoable Image Edit
+   * @param editedImage 编辑后的图像 | Edited image
+   * @param label 操作名称，显示在撤销历史中 | Operation label shown in the undo history
+   * @return 是否显示成功 | Whether the image was shown
+   *
+   * 只保存变化的分块（见 ImageEditHistory）；尺寸不变时保留当前缩放和平移。
+   * Only changed tiles are kept (see ImageEditHistory); zoom and pan are kept when the size is unchanged.
+   */
+  bool applyImageEdit(HObject editedImage, const QString& label);
   
   /**
    * @brief 显示Halcon对象 | Show Halcon Object
@@ -281,6 +348,14 @@ public:
   void changeShowRegion();
   /// ch:显示图像，执行顺序，先清空窗口，再一个个显示 | en:Show Halcon image
   void showHalconImage();
+  /// ch:请求重绘，平移/缩放时使用，合并到每个显示刷新周期最多一次 | en:Request a coalesced redraw served from the render cache
+  void requestRedraw();
+  /// ch:标记渲染缓存失效（图像或叠加对象变化时）| en:Invalidate render cache when image or overlays change
+  void invalidateRenderCache();
+  /// ch:设置渲染缓存开关 | en:Enable/disable render cache
+  void setRenderCacheEnabled(bool enabled);
+  /// ch:获取渲染缓存开关状态 | en:Get render cache status
+  bool isRenderCacheEnabled() const;
   
   /* ==================== 视觉算法接口 | Vision Algorithm Interface ==================== */
   
@@ -333,15 +408,32 @@ public:
    * @param img 输入图像 | Input image
    * @param codeModel 二维码模型句柄 | 2D code model handle
    * @param num 期望识别的二维码数量，通常设为1表示识别单个二维码 | Expected number of codes to recognize, usually set to 1 for single code
+   * @param templateKey 模板标识，用于记录各模板的增益统计，为空时使用句柄值 | Template key for gain statistics, defaults to the handle value
    * @return 包含识别结果的CodeData结构体 | CodeData structure containing recognition results
    * 
    * 该函数使用预先创建的二维码模型对图像中的二维码进行识别和解码。
    * 支持同时识别多个二维码，返回所有识别到的内容。
+   * 多个图像增益(0.5~2.9)在线程池中并行尝试，优先尝试该模板最近/最常成功的增益，
+   * 识别数量达到 num 后取消其余分支。各线程使用序列化复制的句柄副本，副本按模型序列化内容的哈希缓存，
+   * 更换句柄或修改 codeModel 参数后自动重新复制。
    * 
    * This function uses a pre-created 2D code model to recognize and decode 2D codes in images.
    * Supports simultaneous recognition of multiple 2D codes, returning all recognized content.
+   * Candidate gains are tried concurrently, ordered by this template's winning-gain history,
+   * and the remaining branches are cancelled once num codes are decoded.
+   */
+  CodeData QtRecogied(HObject img, HTuple codeModel, HTuple num, const QString& templateKey = QString());
+
+  /**
+   * @brief 获取模板当前的增益尝试顺序 | Get the gain order used for the next sweep of a template
+   * @param templateKey 模板标识 | Template key
    */
-  CodeData QtRecogied(HObject img, HTuple codeModel, HTuple num);
+  static QList<double> QtDataCodeGainOrder(const QString& templateKey);
+
+  /**
+   * @brief 各模板的二维码增益扫描统计 | Per-template data-code gain sweep statistics
+   */
+  static QString QtDataCodeSweepSummary();
   
   /* ==================== 核心功能说明 | Core Functionality Description ==================== */
   /**
@@ -423,6 +515,36 @@ public:
    * Commonly used for edge detection and contour analysis.
    */
   HObject QtGetLengthMaxXld(HObject Img, HObject CheckRegion, int Thr1);
+
+  /**
+   * @brief 一维边缘测量（measure_pos）| 1D edge measurement, like measure_pos
+   * @param image 输入图像（多通道时使用第一通道）| Input image, first channel
+   * @param measureRegion 测量矩形，由 smallest_rectangle2 得到中心、角度和半长 | Rotated measure rectangle
+   * @param edges 沿矩形长轴排序的亚像素边缘 | Subpixel edges ordered along the major axis
+   * @param options 高斯σ、幅值阈值和极性 | Sigma, amplitude threshold and polarity
+   * @param direction 剖面方向提示（弧度），见 HalconMeasure::measureEdges | Profile direction hint in radians
+   * @return 是否执行成功（没有边缘时也返回true）| Whether the measurement ran
+   *
+   * 只计算矩形内的一维平均剖面及其高斯导数，不提取二维轮廓；byte 图像使用内置SIMD内核，其余使用 measure_pos。
+   * Only the averaged 1D profile and its Gaussian derivative are computed, no 2D contours; byte images use the
+   * built-in SIMD kernel, others fall back to measure_pos.
+   */
+  bool measureEdges(HObject image, HObject measureRegion, std::vector<vk::Edge>& edges,
+                    const vk::MeasureOptions& options = vk::MeasureOptions(),
+                    std::optional<double> direction = std::nullopt);
+  // ch:边缘对宽度测量（measure_pairs）| en:Edge pair widths, like measure_pairs
+  bool measureEdgePairs(HObject image, HObject measureRegion, std::vector<vk::EdgePair>& pairs,
+                        const vk::MeasureOptions& options = vk::MeasureOptions(),
+                        std::optional<double> direction = std::nullopt);
+  /**
+   * @brief 两个测量矩形中最强边缘之间的距离 | Distance between the strongest edges of two measure rectangles
+   *
+   * 代替 QtGetLengthMaxXld + DistanceCc 的双边缘距离测量：每个矩形只求一条剖面上的最强边缘。
+   * Replaces QtGetLengthMaxXld + DistanceCc for the two-edge case: one profile per rectangle, strongest edge.
+   */
+  bool measureEdgeDistance(HObject image, HObject region1, HObject region2, double& distance,
+                           const vk::MeasureOptions& options = vk::MeasureOptions(),
+                           std::optional<double> direction = std::nullopt);
   /* ==================== 文件操作接口 | File Operation Interface ==================== */
   
   /**
@@ -474,6 +596,23 @@ public:
    * Enhanced image saving function with detailed error information and exception handling.
    */
   bool QtSaveImageSafe(HObject mImg, QString& errorMessage);
+
+  /**
+   * @brief 异步图像写入回调 | Asynchronous Image Write Handler
+   * 参数为图像和带扩展名的文件路径，返回是否已加入写入队列。
+   * Receives the image and a file path with extension; returns whether the write was queued.
+   */
+  using ImageWriteHandler = std::function<bool(const HObject& image, const QString& filePath)>;
+
+  /**
+   * @brief 设置异步图像写入回调 | Set Asynchronous Image Write Handler
+   * @param handler 写入回调，为空时在调用线程中同步写入 | Handler; empty writes synchronously
+   *
+   * 设置后 QtSaveImage/QtSaveImageSafe/exportAnnotatedImage 只把图像交给回调（通常是后台保存服务），
+   * 编码和写盘不再阻塞界面线程。
+   * Once set, the save/export functions hand the image to the handler instead of encoding on the GUI thread.
+   */
+  void setImageWriteHandler(const ImageWriteHandler& handler);
   
   /**
    * @brief 添加显示对象到列表 | Add Display Object to List
@@ -485,6 +624,14 @@ public:
    * Adds objects to the display list for batch management and display of multiple objects.
    */
   void addDisplayObject(HObject obj, QString color = "green", double lineWidth = 2.0);
+
+  /**
+   * @brief 按指定样式添加显示对象 | Add Display Object with Style
+   * @param obj 要添加的Halcon对象 | Halcon object to add
+   * @param style 显示样式 | Display style
+   * @param redraw 是否立即重绘，连续添加多个对象时可传false最后统一重绘 | Redraw now; pass false when adding many objects
+   */
+  void addDisplayObject(HObject obj, const DisplayStyle& style, bool redraw = true);
   
   /**
    * @brief 获取显示对象数量 | Get Display Objects Count
@@ -547,6 +694,15 @@ public:
    * Mean filtering achieves image smoothing through neighborhood averaging, fast computation but may blur edges.
    */
   HObject applyMeanFilter(HObject image, int maskWidth = 5, int maskHeight = 5);
+
+  /**
+   * @brief 设置是否使用内置SIMD滤波内核 | Enable/disable the built-in SIMD filter kernels
+   * @param enabled 开启时 byte/uint2 且定义域为整幅图像的输入由 vision_kernels 处理，其余交给Halcon
+   *                | When on, byte/uint2 images with a full domain go to vision_kernels, everything else to Halcon
+   */
+  void setNativeKernelsEnabled(bool enabled);
+  /// ch:获取内置滤波内核开关状态 | en:Get built-in filter kernel status
+  bool isNativeKernelsEnabled() const;
   
   /* ==================== 图像增强功能 | Image Enhancement Functions ==================== */
   
@@ -724,6 +880,8 @@ public:
   bool undoLastOperation();
   // ch:重做操作 | en:Redo operation
   bool redoOperation();
+  // ch:撤销历史（内存预算、转存设置与统计）| en:Edit history (budget, spill settings and stats)
+  ImageEditHistory& editHistory();
   // ch:快速获取鼠标位置的像素值 | en:Quick get pixel value at mouse position
   QString getPixelValueAtPosition(double x, double y);
   
@@ -732,7 +890,7 @@ public:
   QColor getRegionAverageColor(HObject region);
   // ch:颜色阈值分割 | en:Color threshold segmentation
   HObject colorThresholdSegmentation(HObject image, int minR, int maxR, int minG, int maxG, int minB, int maxB);
-  // ch:HSV颜色分割 | en:HSV color segmentation
+  // ch:HSV颜色分割（byte量程0~255，minH > maxH 表示跨越0的色调范围）| en:HSV color segmentation, hue may wrap
   HObject hsvColorSegmentation(HObject image, int minH, int maxH, int minS, int maxS, int minV, int maxV);
   
   // 🔧 高级工具功能 | Advanced tool functions
@@ -746,10 +904,15 @@ public:
   HObject morphologyOperation(HObject region, QString operation = "opening", QString structElement = "circle", double radius = 3.5);
   
   // 📈 统计分析功能 | Statistical analysis functions
+  // ch:单次遍历统计（均值/方差/最值/直方图/百分位/清晰度），结果可复用 | en:Single-pass statistics into a reusable struct
+  bool computeImageStatistics(HObject image, HObject region, vk::ImageStatistics& stats,
+                              const vk::StatisticsOptions& options = vk::StatisticsOptions());
   // ch:获取图像统计信息 | en:Get image statistics
   QMap<QString, double> getImageStatistics(HObject image, HObject region = HObject());
   // ch:获取区域几何特征 | en:Get region geometric features
   QMap<QString, double> getRegionFeatures(HObject region);
+  // ch:缺陷斑点分析（连通域 + 每个斑点的几何特征）| en:Blob analysis, connected components with per-blob features
+  QList<QMap<QString, double>> getBlobFeatures(HObject region, double minArea = 0.0);
   // ch:计算图像质量评分 | en:Calculate image quality score
   double calculateImageQualityScore(HObject image);
 
@@ -870,9 +1033,8 @@ public:
   /* ==================== 扩展私有成员变量 | Extended Private Member Variables ==================== */
   
   QList<HObject> annotationList;               // ch:标注对象列表，存储用户添加的标注 | en:Annotation object list storing user-added annotations
-  QStringList operationHistory;                // ch:操作历史记录，用于撤销/重做功能 | en:Operation history for undo/redo functionality
-  int currentHistoryIndex = -1;                // ch:当前历史记录索引 | en:Current history index
-  HObject backupImage;                         // ch:备份图像，用于撤销操作 | en:Backup image for undo operations
+  ImageEditHistory m_editHistory;              // ch:图像编辑与叠加对象的撤销/重做历史 | en:Undo/redo history for image edits and overlays
+  ImageWriteHandler m_imageWriteHandler;       // ch:异步图像写入回调，为空时同步写入 | en:Async image write handler, synchronous when empty
   bool enableOperationHistory = true;          // ch:是否启用操作历史记录 | en:Whether to enable operation history
   
   /* ==================== 右键菜单相关 | Context Menu Related ==================== */
@@ -888,6 +1050,23 @@ public:
   bool m_pixelInfoDisplayEnabled;              // ch:像素信息显示开关 | en:Pixel info display switch
   QLabel* m_pixelInfoLabel;                    // ch:像素信息显示标签控件 | en:Pixel info display label widget
   QString m_lastPixelInfo;                     // ch:上次的像素信息（避免重复更新）| en:Last pixel info (avoid duplicate updates)
+  QTimer* m_pixelInfoTimer;                    // ch:像素信息刷新节流定时器 | en:Pixel info throttle timer
+  QElapsedTimer m_lastPixelInfoUpdate;         // ch:上次刷新像素信息的计时 | en:Time since last pixel info refresh
+  QPoint m_pendingPixel;                       // ch:待显示的像素坐标 | en:Pixel waiting to be shown
+  QPoint m_shownPixel;                         // ch:已显示的像素坐标 | en:Pixel currently shown
+
+  /// ch:像素直接读取缓存，每幅图像只调用一次GetImagePointer1/3 | en:Raw pixel access cache, one GetImagePointer1/3 per image
+  struct PixelAccessCache {
+    HObject image;                             // ch:持有图像引用，保证指针有效 | en:Holds the image so pointers stay valid
+    bool valid = false;                        // ch:缓存是否可用 | en:Whether the cache is usable
+    int width = 0;                             // ch:图像宽度 | en:Image width
+    int height = 0;                            // ch:图像高度 | en:Image height
+    int channels = 0;                          // ch:通道数 | en:Channel count
+    int pixelType = 0;                         // ch:像素类型 | en:Pixel type
+    QString typeName;                          // ch:Halcon像素类型名 | en:Halcon pixel type name
+    const void* planes[3] = {nullptr, nullptr, nullptr}; // ch:各通道数据指针 | en:Channel data pointers
+  };
+  PixelAccessCache m_pixelCache;               // ch:像素读取缓存 | en:Pixel access cache
   
   /* ==================== 防闪烁优化相关 | Anti-flicker Optimization Related ==================== */
   QTimer* m_resizeTimer;                       // ch:防抖动定时器 | en:Resize debounce timer
@@ -895,6 +1074,27 @@ public:
   QSize m_lastWindowSize;                      // ch:上次窗口大小 | en:Last window size
   bool m_smoothResizeEnabled;                  // ch:平滑调整大小开关 | en:Smooth resize switch
   int m_resizeDebounceMs;                      // ch:防抖动延迟时间（毫秒）| en:Resize debounce delay (milliseconds)
+
+  /* ==================== 渲染缓存相关 | Render Cache Related ==================== */
+  bool m_renderCacheEnabled;                   // ch:渲染缓存开关 | en:Render cache switch
+  bool m_renderCacheDirty;                     // ch:缓存是否需要重建 | en:Whether the cache must be rebuilt
+  bool m_renderOverlayBaked;                   // ch:叠加对象是否已绘入缩小层 | en:Whether overlays are baked into reduced levels
+  QVector<HObject> m_renderPyramid;            // ch:图像金字塔，第0级为原图，第k级缩小2^k倍 | en:Image pyramid, level k is reduced by 2^k
+  QTimer* m_redrawTimer;                       // ch:重绘合并定时器 | en:Redraw coalescing timer
+  QElapsedTimer m_lastRedraw;                  // ch:上次重绘计时 | en:Time since last redraw
+  int m_redrawIntervalMs;                      // ch:最小重绘间隔（显示刷新周期）| en:Minimum redraw interval (display refresh period)
+
+  /// ch:同一样式的叠加对象分组 | en:Overlays grouped by style
+  struct OverlayBucket {
+    DisplayStyle style;                        // ch:分组样式 | en:Bucket style
+    HObject objects;                           // ch:合并后的对象 | en:Concatenated objects
+    int count = 0;                             // ch:对象数量 | en:Object count
+  };
+  QVector<OverlayBucket> m_overlayBuckets;     // ch:按首次出现顺序排列的样式分组 | en:Style buckets in first-seen order
+  bool m_overlayBucketsDirty;                  // ch:分组是否需要重建 | en:Whether buckets must be rebuilt
+
+  /* ==================== 滤波内核 | Filter Kernels ==================== */
+  bool m_nativeKernelsEnabled;                 // ch:内置SIMD滤波内核开关 | en:Built-in SIMD filter kernel switch
   
   /* ==================== 私有辅助函数 | Private Helper Functions ==================== */
   
@@ -938,6 +1138,71 @@ public:
    * Gets floating-point coordinate parameters of current image display region.
    */
   void GetPartFloat(double *row1, double *col1, double *row2, double *col2);
+
+  /* ==================== 渲染缓存私有方法 | Render Cache Private Methods ==================== */
+
+  /**
+   * @brief 重建渲染缓存 | Rebuild Render Cache
+   * @return 是否成功 | Whether successful
+   *
+   * 由原图逐级 2 倍缩小生成金字塔，直到整幅图像不大于窗口；缩小层（第1级起）把叠加对象按
+   * 该级分辨率栅格化后直接绘入图像（彩色），平移/缩放时只需显示一幅图像。第0级为原图，叠加对象仍按矢量绘制。
+   * Builds a 2x pyramid down to window size; overlays are rasterised into reduced levels so
+   * pan/zoom displays a single image. Level 0 is the original image with vector overlays.
+   */
+  bool buildRenderCache();
+
+  /**
+   * @brief 根据当前显示区域选择金字塔层级 | Select Pyramid Level for Current Display Part
+   * @return 层级序号 | Level index
+   */
+  int renderLevelForPart() const;
+
+  /**
+   * @brief 从缓存渲染当前显示区域 | Render Current Display Part from Cache
+   */
+  void renderFromCache();
+
+  /**
+   * @brief 按矢量方式绘制叠加对象 | Draw Overlay Objects as Vectors
+   */
+  void drawOverlayObjects();
+
+  /**
+   * @brief 按样式重建叠加对象分组 | Rebuild Overlay Style Buckets
+   */
+  void rebuildOverlayBuckets();
+
+  /**
+   * @brief 查找样式所在分组 | Find Bucket Index for Style
+   * @return 分组序号，不存在时返回-1 | Bucket index or -1
+   */
+  int overlayBucketIndex(const DisplayStyle& style) const;
+
+  /**
+   * @brief 显示撤销历史中的图像 | Display an Image from the Edit History
+   * @param image 要显示的图像 | Image to display
+   *
+   * 尺寸不变时保留当前显示区域，不清空撤销历史。
+   * Keeps the display part when the size is unchanged and leaves the history intact.
+   */
+  void displayHistoryImage(const HObject& image);
+
+  /**
+   * @brief 记录叠加对象列表的变化 | Record a Change of the Overlay List
+   * @param label 操作名称 | Operation label
+   * @param before 变化前的列表 | List before the change
+   */
+  void recordOverlayChange(const QString& label, const QList<DisplayOverlay>& before);
+
+  /**
+   * @brief 按扩展名写入图像文件 | Write Image File by Extension
+   * @param image 图像 | Image
+   * @param filePath 文件路径，未知扩展名时改为.jpg | File path, changed to .jpg for unknown extensions
+   * @param errorMessage 错误信息输出 | Error message output
+   * @return 已写入或已加入异步写入队列 | Written, or queued for asynchronous writing
+   */
+  bool writeImageFile(const HObject& image, QString& filePath, QString& errorMessage);
   
   /* ==================== 优化相关私有方法 | Optimization Related Private Methods ==================== */
   
@@ -951,6 +1216,34 @@ public:
    * ensuring the label stays within visible area without blocking important content.
    */
   void updatePixelInfoLabelPosition();
+
+  /**
+   * @brief 刷新像素信息标签 | Refresh Pixel Info Label
+   *
+   * 由 updatePixelInfoDisplay 节流调用，每个显示刷新周期最多一次。
+   * Called by updatePixelInfoDisplay at most once per display refresh period.
+   */
+  void flushPixelInfoDisplay();
+
+  /**
+   * @brief 确保像素读取缓存对应当前图像 | Ensure Pixel Access Cache Matches Current Image
+   * @return 缓存是否可用 | Whether the cache is usable
+   */
+  bool refreshPixelAccessCache();
+
+  /**
+   * @brief 从内存读取像素值 | Read Pixel Values from Memory
+   * @param col 列坐标 | Column
+   * @param row 行坐标 | Row
+   * @param values 输出各通道值（最多3个）| Output channel values (up to 3)
+   * @return 读取的通道数，越界或不支持时返回0 | Number of channels read, 0 if out of range or unsupported
+   */
+  int readPixelValues(int col, int row, double* values) const;
+
+  /**
+   * @brief 获取当前显示区域（缓存值，不调用Halcon）| Get Current Display Part (cached, no Halcon call)
+   */
+  void currentPart(double *row1, double *col1, double *row2, double *col2) const;
   
   /**
    * @brief 右键菜单触发处理槽函数 | Context Menu Trigger Handler Slot
@@ -1096,6 +1389,15 @@ signals:
    */
   void handEyeCalibrationCompleted(bool success, const QString& message);
 
+  /**
+   * @brief 撤销/重做替换了显示图像 | Undo/Redo Replaced the Displayed Image
+   * @param image 替换后的图像 | The image now displayed
+   *
+   * 持有图像副本的外部代码应连接此信号以保持同步。
+   * Code that keeps its own copy of the image should connect to stay in sync.
+   */
+  void editHistoryImageChanged(HObject image);
+
 /* ==================== 公有槽函数 | Public Slot Functions ==================== */
 public slots:
   // ch:预留槽函数接口，可根据需要添加具体实现 | en:Reserved slot function interface, specific implementation can be added as needed
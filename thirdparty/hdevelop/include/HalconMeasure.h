@@ -0,0 +1,89 @@
+#ifndef HALCONMEASURE_H
+#define HALCONMEASURE_H
+
+#include "halconcpp/HalconCpp.h"
+#include "Measure1D.h"
+
+#include <optional>
+#include <vector>
+
+using namespace HalconCpp;
+
+/**
+ * @brief 无界面的测量辅助类 | Widget-free measurement helper
+ *
+ * 🎯 从 HalconLable 中拆出的轮廓与一维边缘测量函数，不依赖 QWidget/QObject，可在任意线程创建和使用；
+ * 所有测量函数都是 const 且不修改成员，同一实例可被多个线程同时调用。HalconLable 的同名接口转调本类。
+ * Contour and 1D edge measurement split out of HalconLable. No QWidget/QObject dependency, so it can be
+ * created and used on any thread; all measurement functions are const, so one instance may be shared by
+ * several threads. HalconLable's functions of the same name forward here.
+ */
+class HalconMeasure
+{
+public:
+  explicit HalconMeasure(bool nativeKernelsEnabled = true);
+
+  /**
+   * @brief 是否对 byte 图像使用内置SIMD内核 | Use the built-in SIMD kernels for byte images
+   */
+  void setNativeKernelsEnabled(bool enabled) { m_nativeKernelsEnabled = enabled; }
+  bool nativeKernelsEnabled() const { return m_nativeKernelsEnabled; }
+
+  /**
+   * @brief 获取区域内最长的亚像素轮廓 | Longest subpixel contour inside a region
+   * @param Img 输入图像 | Input image
+   * @param CheckRegion 检查区域 | Check region
+   * @param Thr1 阈值参数 | Threshold parameter
+   * @return 最长的XLD轮廓，失败时为空对象 | Longest XLD contour, empty on failure
+   */
+  HObject QtGetLengthMaxXld(const HObject& Img, const HObject& CheckRegion, int Thr1) const;
+
+  /**
+   * @brief 一维边缘测量（measure_pos）| 1D edge measurement, like measure_pos
+   * @param image 输入图像（多通道时使用第一通道）| Input image, first channel
+   * @param measureRegion 测量矩形，由 smallest_rectangle2 得到中心、角度和半长 | Rotated measure rectangle
+   * @param edges 沿矩形长轴排序的亚像素边缘 | Subpixel edges ordered along the major axis
+   * @param options 高斯σ、幅值阈值和极性 | Sigma, amplitude threshold and polarity
+   * @param direction 剖面方向提示（弧度，与 phi 同义）| Profile direction hint in radians, same sense as phi
+   * @return 是否执行成功（没有边缘时也返回true）| Whether the measurement ran
+   *
+   * smallest_rectangle2 只返回 (−π/2, π/2] 内的角度，并可能交换 length1/length2，丢失ROI绘制时的方向；
+   * 给出 direction 时矩形取四种等价表示中角度最接近它的一种，剖面方向和边缘极性与绘制一致。
+   * smallest_rectangle2 only returns phi in (−π/2, π/2] and may swap length1/length2, losing the drawn direction;
+   * with a direction hint the rectangle takes whichever of its four equivalent forms has phi closest to it, so the
+   * profile direction and edge polarity follow the drawing.
+   *
+   * 只计算矩形内的一维平均剖面及其高斯导数，不提取二维轮廓；byte 图像使用内置SIMD内核，其余使用 measure_pos。
+   * Only the averaged 1D profile and its Gaussian derivative are computed, no 2D contours; byte images use the
+   * built-in SIMD kernel, others fall back to measure_pos.
+   */
+  bool measureEdges(const HObject& image, const HObject& measureRegion, std::vector<vk::Edge>& edges,
+                    const vk::MeasureOptions& options = vk::MeasureOptions(),
+                    std::optional<double> direction = std::nullopt) const;
+  // ch:边缘对宽度测量（measure_pairs）| en:Edge pair widths, like measure_pairs
+  bool measureEdgePairs(const HObject& image, const HObject& measureRegion, std::vector<vk::EdgePair>& pairs,
+                        const vk::MeasureOptions& options = vk::MeasureOptions(),
+                        std::optional<double> direction = std::nullopt) const;
+  /**
+   * @brief 两个测量矩形中最强边缘之间的距离 | Distance between the strongest edges of two measure rectangles
+   *
+   * 代替 QtGetLengthMaxXld + DistanceCc 的双边缘距离测量：每个矩形只求一条剖面上的最强边缘。
+   * Replaces QtGetLengthMaxXld + DistanceCc for the two-edge case: one profile per rectangle, strongest edge.
+   */
+  /**
+   * @brief 区域的测量矩形 | Measure rectangle of a region
+   * @param direction 剖面方向提示，见 measureEdges | Profile direction hint, see measureEdges
+   * @return 区域为空时返回false | False for an empty region
+   */
+  static bool measureRectangle(const HObject& region, vk::MeasureRectangle* rectangle,
+                               std::optional<double> direction = std::nullopt);
+
+  bool measureEdgeDistance(const HObject& image, const HObject& region1, const HObject& region2, double& distance,
+                           const vk::MeasureOptions& options = vk::MeasureOptions(),
+                           std::optional<double> direction = std::nullopt) const;
+
+private:
+  bool m_nativeKernelsEnabled;   // ch:内置SIMD测量内核开关 | en:Built-in SIMD measure kernel switch
+};
+
+#endif // HALCONMEASURE_H
@@ -0,0 +1,227 @@
+#ifndef IMAGEEDITHISTORY_H
+#define IMAGEEDITHISTORY_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "halconcpp/HalconCpp.h"
+
+using namespace HalconCpp;
+
+class QFile;
+class QIODevice;
+
+/**
+ * @brief 撤销历史统计信息 | Edit History Statistics
+ */
+struct ImageEditHistoryStats {
+    int undoCount = 0;               // 可撤销步数 | Undoable steps
+    int redoCount = 0;               // 可重做步数 | Redoable steps
+    qint64 memoryBytes = 0;          // 内存中的历史数据 | History bytes held in RAM
+    qint64 memoryBudget = 0;         // 内存预算 | RAM budget
+    qint64 spilledBytes = 0;         // 已转存到临时文件的数据 | Bytes spilled to the temp file
+    int spilledEntries = 0;          // 已转存的步数 | Spilled steps
+    quint64 evictedEntries = 0;      // 因超出预算被丢弃的步数 | Steps dropped by the budget
+};
+
+/**
+ * @brief 图像编辑撤销/重做历史 | Image Edit Undo/Redo History
+ *
+ * 🎯 图像编辑按固定大小的分块比较前后两幅图像，只保存发生变化的分块（写时复制：历史中不保存整幅图像，
+ * 撤销/重做时复制一次当前图像再写回变化的分块）；撤销与重做交换分块内容，因此每步只保存一份数据。
+ * 尺寸、类型或通道数变化的编辑保存整幅图像的引用。ROI、标注等编辑以命令记录（撤销/重做回调）保存。
+ *
+ * 超出内存预算时从最早的步骤开始处理：启用转存时写入临时文件，否则（或转存预算也用完时）直接丢弃。
+ *
+ * Image edits are diffed tile by tile and only changed tiles are stored; undo and redo swap the tile
+ * contents so each step holds a single copy. Edits that change size, type or channel count keep a
+ * reference to the whole image. ROI/annotation edits are stored as command records. When the RAM budget
+ * is exceeded the oldest steps are spilled to a temp file or dropped.
+ *
+ * 非线程安全，只在界面线程中使用。| Not thread-safe; use from the GUI thread only.
+ */
+class ImageEditHistory
+{
+public:
+    /**
+     * @param memoryBudgetBytes 内存预算（字节）| RAM budget in bytes
+     * @param tileSize 分块边长（像素）| Tile edge length in pixels
+     */
+    explicit ImageEditHistory(qint64 memoryBudgetBytes = 256LL * 1024 * 1024, int tileSize = 128);
+    ~ImageEditHistory();
+
+    ImageEditHistory(const ImageEditHistory&) = delete;
+    ImageEditHistory& operator=(const ImageEditHistory&) = delete;
+
+    /**
+     * @brief 设置内存预算，立即按新预算转存或丢弃旧步骤 | Set RAM budget and enforce it immediately
+     */
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return m_memoryBudget; }
+
+    /**
+     * @brief 设置超出预算时是否转存到临时文件 | Enable spilling to a temp file when over budget
+     * @param enabled 是否启用 | Whether enabled
+     * @param directory 临时文件目录，为空时使用系统临时目录 | Temp directory, system temp when empty
+     * @param spillBudgetBytes 临时文件中历史数据上限 | Upper bound for spilled bytes
+     */
+    void setSpillEnabled(bool enabled, const QString& directory = QString(),
+                         qint64 spillBudgetBytes = 2LL * 1024 * 1024 * 1024);
+
+    /**
+     * @brief 设置分块大小，只在历史为空时生效 | Set tile size; only applies while history is empty
+     */
+    bool setTileSize(int tileSize);
+    int tileSize() const { return m_tileSize; }
+
+    /**
+     * @brief 记录一次图像编辑 | Record an image edit
+     * @param label 操作名称 | Operation label
+     * @param before 编辑前图像 | Image before the edit
+     * @param after 编辑后图像（成为新的当前图像）| Image after the edit (becomes current)
+     * @return 是否记录成功（图像无变化时返回false）| Whether recorded (false when nothing changed)
+     */
+    bool recordImageEdit(const QString& label, const HObject& before, const HObject& after);
+
+    /**
+     * @brief 记录一条命令 | Record a command
+     * @param label 操作名称 | Operation label
+     * @param undo 撤销回调 | Undo callback
+     * @param redo 重做回调 | Redo callback
+     * @param approxBytes 命令占用的大致内存，用于预算统计 | Approximate memory used by the command
+     *
+     * 命令不能转存，超出预算且没有可转存的步骤时按最早优先丢弃。
+     * Commands cannot be spilled; they are dropped oldest first once nothing else can be spilled.
+     */
+    void recordCommand(const QString& label, std::function<void()> undo, std::function<void()> redo,
+                       qint64 approxBytes = 0);
+
+    /**
+     * @brief 估算 Halcon 对象占用的内存 | Estimate the memory held by a Halcon object
+     *
+     * 区域按游程编码字节数，XLD轮廓按点数，图像按像素数据计；可传入对象元组。
+     * Regions by run-length bytes, XLD contours by point count, images by pixel data; object tuples are summed.
+     */
+    static qint64 estimateObjectBytes(const HObject& object);
+
+    bool canUndo() const { return !m_undo.empty(); }
+    bool canRedo() const { return !m_redo.empty(); }
+    QString undoLabel() const;
+    QString redoLabel() const;
+
+    /**
+     * @brief 撤销一步 | Undo one step
+     * @param current 当前图像；图像编辑时替换为撤销后的图像 | Current image, replaced for image edits
+     * @param imageChanged 输出是否替换了图像 | Outputs whether the image was replaced
+     * @return 是否成功 | Whether successful
+     */
+    bool undo(HObject& current, bool* imageChanged = nullptr);
+
+    /**
+     * @brief 重做一步 | Redo one step
+     */
+    bool redo(HObject& current, bool* imageChanged = nullptr);
+
+    /**
+     * @brief 清空历史并删除临时文件 | Clear history and drop the temp file
+     */
+    void clear();
+
+    /**
+     * @brief 从最早到最近的可撤销操作名称 | Undoable labels from oldest to newest
+     */
+    QStringList undoLabels() const;
+
+    ImageEditHistoryStats stats() const;
+
+    /**
+     * @brief 图像是否是最近一次图像编辑的结果 | Whether the image is the result of the latest image edit
+     *
+     * 按像素缓冲区地址比较（HObject 副本共享像素数据）；没有图像编辑记录时返回true。
+     * Compares the pixel buffer address, which HObject copies share; true when no image edit is recorded.
+     */
+    bool isHead(const HObject& image) const;
+
+private:
+    // 图像布局：所有通道尺寸与类型相同
+    struct ImageLayout {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        int bytesPerPixel = 0;
+        QString type;
+
+        bool operator==(const ImageLayout& other) const
+        {
+            return width == other.width && height == other.height && channels == other.channels &&
+                   bytesPerPixel == other.bytesPerPixel && type == other.type;
+        }
+    };
+
+    struct TileRef {
+        int channel = 0;
+        int tileX = 0;
+        int tileY = 0;
+    };
+
+    struct Entry {
+        enum Kind { TileDelta, Snapshot, Command };
+
+        Kind kind = Command;
+        QString label;
+        ImageLayout layout;           // TileDelta/Snapshot
+        QVector<TileRef> tiles;       // TileDelta：变化的分块
+        QByteArray payload;           // TileDelta：分块内容；已转存的Snapshot读回时的像素数据
+        HObject image;                // Snapshot：另一侧的整幅图像
+        std::function<void()> undo;   // Command
+        std::function<void()> redo;   // Command
+        qint64 bytes = 0;             // 内存占用（转存后为0）
+        bool spilled = false;
+        qint64 spillOffset = 0;
+        qint64 spillSize = 0;
+    };
+
+    typedef std::shared_ptr<Entry> EntryPtr;
+
+    bool applyEntry(Entry& entry, HObject& current, bool* imageChanged);
+    bool swapTiles(Entry& entry, HObject& current);
+    bool loadSpilled(Entry& entry);
+    bool spill(Entry& entry);
+    bool spillOldest();
+    void enforceBudget();
+    void dropEntry(const EntryPtr& entry);
+    void discardRedo();
+    void resetSpillFile();
+    static const void* pixelData(const HObject& image);
+
+    static bool readLayout(const HObject& image, ImageLayout* layout);
+    static bool channelPointers(const HObject& image, int channels, QVector<uchar*>* pointers);
+    static bool hasFullDomain(const HObject& image, const ImageLayout& layout);
+    static qint64 imageBytes(const ImageLayout& layout);
+    static bool writePlanes(QIODevice* device, const HObject& image, const ImageLayout& layout);
+    static bool readPlanes(QIODevice* device, const ImageLayout& layout, HObject* image);
+
+private:
+    qint64 m_memoryBudget;
+    int m_tileSize;
+    std::deque<EntryPtr> m_undo;      // 末尾为最近一步
+    std::deque<EntryPtr> m_redo;      // 末尾为下一步重做
+    const void* m_headData = nullptr; // 最近一次图像编辑后图像的像素地址，用于检查当前图像是否仍属于本历史
+    qint64 m_memoryBytes = 0;
+
+    bool m_spillEnabled = false;
+    QString m_spillDirectory;
+    qint64 m_spillBudget = 0;
+    qint64 m_spilledBytes = 0;
+    int m_spilledEntries = 0;
+    std::unique_ptr<QFile> m_spillFile;
+    quint64 m_evictedEntries = 0;
+};
+
+#endif // IMAGEEDITHISTORY_H
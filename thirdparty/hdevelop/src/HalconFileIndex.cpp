@@ -0,0 +1,597 @@
+//
+// 持久化目录文件索引 | Persistent Directory File Index
+//
+
+#include "../include/HalconFileIndex.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QWaitCondition>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+
+const quint32 kIndexCacheMagic = 0x48464958;   // "HFIX"
+const quint32 kIndexCacheVersion = 1;
+const int kDirtyDebounceMs = 200;              // 变化通知合并间隔 | Notification debounce
+
+// 遍历线程池：目录遍历以IO为主，与全局线程池分开，避免占满检测使用的线程
+QThreadPool *fileIndexThreadPool()
+{
+    static QThreadPool *pool = [] {
+        QThreadPool *created = new QThreadPool();
+        created->setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
+        created->setExpiryTimeout(10000);
+        return created;
+    }();
+    return pool;
+}
+
+QString joinPath(const QString &directory, const QString &name)
+{
+    return directory.endsWith('/') ? directory + name : directory + '/' + name;
+}
+
+// 与 QFileInfo::completeSuffix() 相同：第一个点之后的全部字符
+QString completeSuffix(const QString &fileName)
+{
+    int dot = fileName.indexOf('.');
+    return dot < 0 ? QString() : fileName.mid(dot + 1);
+}
+
+// 并行遍历的共享状态
+struct WalkState {
+    QMutex mutex;
+    QWaitCondition wake;
+    QStringList pending;
+    int active = 0;
+    int rescanned = 0;
+};
+
+} // namespace
+
+HalconFileIndex::HalconFileIndex(const QString& rootPath, TypeResolver resolver, QObject* parent)
+    : QObject(parent)
+    , m_rootPath(normalizePath(rootPath))
+    , m_resolver(std::move(resolver))
+{
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &HalconFileIndex::onDirectoryChanged);
+
+    m_dirtyTimer = new QTimer(this);
+    m_dirtyTimer->setSingleShot(true);
+    m_dirtyTimer->setInterval(kDirtyDebounceMs);
+    connect(m_dirtyTimer, &QTimer::timeout, this, &HalconFileIndex::processDirtyDirectories);
+}
+
+HalconFileIndex::~HalconFileIndex()
+{
+    if (m_cacheDirty) {
+        save();
+    }
+}
+
+void HalconFileIndex::setCachePath(const QString& cachePath)
+{
+    m_cachePath = cachePath;
+}
+
+QString HalconFileIndex::defaultCachePath(const QString& rootPath)
+{
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheDir.isEmpty()) {
+        cacheDir = QDir::tempPath();
+    }
+    QByteArray key = QCryptographicHash::hash(normalizePath(rootPath).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString("%1/file_index/%2.idx").arg(cacheDir, QString::fromLatin1(key.left(16)));
+}
+
+void HalconFileIndex::setWalkerThreads(int threads)
+{
+    m_walkerThreads = qMax(0, threads);
+}
+
+void HalconFileIndex::setMaxWatchedDirectories(int count)
+{
+    m_maxWatchedDirectories = count;
+}
+
+QString HalconFileIndex::normalizePath(const QString& path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+bool HalconFileIndex::isUnder(const QString& path, const QString& directory)
+{
+    if (path == directory) {
+        return true;
+    }
+    return directory.endsWith('/') ? path.startsWith(directory) : path.startsWith(directory + '/');
+}
+
+// ==================== 构建与校验 | Build and Revalidation ====================
+
+bool HalconFileIndex::open()
+{
+    if (!QDir(m_rootPath).exists()) {
+        qDebug() << "⚠️ 索引目录不存在:" << m_rootPath;
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    DirectoryMap previous;
+    bool cached = loadCache(&previous);
+
+    DirectoryMap directories;
+    int rescanned = 0;
+    walk(QStringList() << m_rootPath, previous, &directories, &rescanned);
+
+    {
+        QWriteLocker locker(&m_lock);
+        m_directories.swap(directories);
+        m_stats.loadedFromCache = cached;
+        m_stats.rescannedDirectories = rescanned;
+        m_stats.lastBuildMs = timer.elapsed();
+        m_open = true;
+    }
+    m_cacheDirty = !cached || rescanned > 0 || previous.size() != m_directories.size();
+    m_lastRevalidateMs = QDateTime::currentMSecsSinceEpoch();
+    const QStringList watched = m_watcher->directories();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+    updateWatcher(QStringList(), QStringList());
+
+    HalconFileIndexStats current = stats();
+    qDebug() << (cached ? "🗂️ 文件索引已加载并校验:" : "🗂️ 文件索引已构建:") << m_rootPath
+             << "目录" << current.directories << "文件" << current.files
+             << "重新列出" << rescanned << "耗时" << current.lastBuildMs << "ms";
+
+    if (m_cacheDirty) {
+        save();
+    }
+    return true;
+}
+
+void HalconFileIndex::rebuild()
+{
+    if (!m_cachePath.isEmpty()) {
+        QFile::remove(m_cachePath);
+    }
+    {
+        QWriteLocker locker(&m_lock);
+        m_directories.clear();
+    }
+    m_dirtyDirectories.clear();
+    open();
+    emit indexChanged();
+}
+
+/**
+ * 以多个线程遍历目录树：修改时间与 previous 中记录相同的目录沿用缓存内容（只 stat 目录本身），
+ * 其余目录重新列出。调用线程也参与遍历，返回时遍历已完成。
+ */
+void HalconFileIndex::walk(const QStringList& roots, const DirectoryMap& previous, DirectoryMap* result, int* rescanned) const
+{
+    WalkState state;
+    state.pending = roots;
+
+    auto worker = [this, &state, &previous, result]() {
+        for (;;) {
+            QString path;
+            {
+                QMutexLocker locker(&state.mutex);
+                while (state.pending.isEmpty() && state.active > 0) {
+                    state.wake.wait(&state.mutex);
+                }
+                if (state.pending.isEmpty()) {
+                    state.wake.wakeAll();
+                    return;
+                }
+                path = state.pending.takeLast();
+                ++state.active;
+            }
+
+            DirectoryNode node;
+            bool reused = false;
+            bool ok = false;
+            auto cached = previous.constFind(path);
+            if (cached != previous.constEnd()) {
+                QFileInfo info(path);
+                if (info.isDir() && info.lastModified().toMSecsSinceEpoch() == cached->modifiedMs) {
+                    node = cached.value();
+                    reused = ok = true;
+                }
+            }
+            if (!reused) {
+                ok = scanDirectory(path, &node);
+            }
+
+            QMutexLocker locker(&state.mutex);
+            if (ok) {
+                state.pending.append(node.subdirectories);
+                result->insert(path, node);
+                if (!reused) {
+                    ++state.rescanned;
+                }
+            }
+            --state.active;
+            if (!state.pending.isEmpty() || state.active == 0) {
+                state.wake.wakeAll();
+            }
+        }
+    };
+
+    QThreadPool *pool = fileIndexThreadPool();
+    const int threads = qMax(1, m_walkerThreads > 0 ? m_walkerThreads : pool->maxThreadCount());
+    QList<QFuture<void>> walkers;
+    for (int i = 1; i < threads; ++i) {
+        walkers.append(QtConcurrent::run(pool, worker));
+    }
+    worker(); // 调用线程也参与遍历
+    for (QFuture<void> &walker : walkers) {
+        walker.waitForFinished();
+    }
+
+    if (rescanned != nullptr) {
+        *rescanned = state.rescanned;
+    }
+}
+
+bool HalconFileIndex::scanDirectory(const QString& path, DirectoryNode* node) const
+{
+    QFileInfo dirInfo(path);
+    if (!dirInfo.isDir()) {
+        return false;
+    }
+    node->modifiedMs = dirInfo.lastModified().toMSecsSinceEpoch();
+    node->files.clear();
+    node->subdirectories.clear();
+
+    // 与 QDirIterator(QDir::Files, Subdirectories) 的范围一致：不含隐藏文件，不进入符号链接目录
+    const QFileInfoList entries = QDir(path).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDir::NoSort);
+    for (const QFileInfo &info : entries) {
+        if (info.isDir()) {
+            if (!info.isSymLink()) {
+                node->subdirectories.append(info.absoluteFilePath());
+            }
+            continue;
+        }
+        HalconFileEntry entry;
+        entry.path = info.absoluteFilePath();
+        entry.fileName = info.fileName();
+        entry.suffix = info.completeSuffix();
+        entry.size = info.size();
+        entry.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+        if (m_resolver) {
+            entry.fileType = m_resolver(entry.fileName);
+        }
+        node->files.append(entry);
+    }
+    return true;
+}
+
+void HalconFileIndex::refresh()
+{
+    if (!m_open) {
+        return;
+    }
+    if (m_stats.watchedDirectories > 0) {
+        processDirtyDirectories();
+        return;
+    }
+
+    // 未监视：按间隔校验目录修改时间，变化的目录重新列出
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - m_lastRevalidateMs < m_revalidateIntervalMs) {
+        return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    DirectoryMap previous;
+    {
+        QReadLocker locker(&m_lock);
+        previous = m_directories;
+    }
+    DirectoryMap directories;
+    int rescanned = 0;
+    walk(QStringList() << m_rootPath, previous, &directories, &rescanned);
+    m_lastRevalidateMs = QDateTime::currentMSecsSinceEpoch();
+
+    bool changed = rescanned > 0 || directories.size() != previous.size();
+    {
+        QWriteLocker locker(&m_lock);
+        m_directories.swap(directories);
+        m_stats.rescannedDirectories = rescanned;
+        m_stats.lastBuildMs = timer.elapsed();
+    }
+    if (changed) {
+        m_cacheDirty = true;
+        updateWatcher(QStringList(), QStringList());
+        emit indexChanged();
+    }
+}
+
+// ==================== 增量更新 | Incremental Updates ====================
+
+void HalconFileIndex::onDirectoryChanged(const QString& path)
+{
+    m_dirtyDirectories.insert(normalizePath(path));
+    m_dirtyTimer->start();
+}
+
+void HalconFileIndex::processDirtyDirectories()
+{
+    if (m_dirtyDirectories.isEmpty()) {
+        return;
+    }
+    m_dirtyTimer->stop();
+    const QList<QString> dirty = m_dirtyDirectories.values();
+    m_dirtyDirectories.clear();
+
+    QStringList added;
+    QStringList removed;
+    QStringList newRoots;
+    quint64 updated = 0;
+    for (const QString &path : dirty) {
+        DirectoryNode node;
+        bool exists = scanDirectory(path, &node);
+
+        QWriteLocker locker(&m_lock);
+        auto it = m_directories.find(path);
+        if (it == m_directories.end()) {
+            continue; // 不在索引中（已随上级目录删除），新目录由上级目录的变化发现
+        }
+        if (!exists) {
+            removeSubtreeLocked(path, &removed);
+            ++updated;
+            continue;
+        }
+        const QStringList previousSubdirectories = it->subdirectories;
+        for (const QString &subdirectory : previousSubdirectories) {
+            if (!node.subdirectories.contains(subdirectory)) {
+                removeSubtreeLocked(subdirectory, &removed);
+            }
+        }
+        for (const QString &subdirectory : node.subdirectories) {
+            if (!m_directories.contains(subdirectory)) {
+                newRoots.append(subdirectory);
+            }
+        }
+        m_directories.insert(path, node);
+        ++updated;
+    }
+
+    // 新增的子目录树在锁外并行遍历
+    if (!newRoots.isEmpty()) {
+        DirectoryMap subtree;
+        walk(newRoots, DirectoryMap(), &subtree, nullptr);
+        QWriteLocker locker(&m_lock);
+        for (auto it = subtree.constBegin(); it != subtree.constEnd(); ++it) {
+            m_directories.insert(it.key(), it.value());
+            added.append(it.key());
+        }
+    }
+
+    {
+        QWriteLocker locker(&m_lock);
+        m_stats.incrementalUpdates += updated;
+    }
+    if (updated > 0 || !added.isEmpty()) {
+        m_cacheDirty = true;
+        updateWatcher(added, removed);
+        emit indexChanged();
+    }
+}
+
+void HalconFileIndex::removeSubtreeLocked(const QString& path, QStringList* removedDirectories)
+{
+    QStringList stack;
+    stack << path;
+    while (!stack.isEmpty()) {
+        QString current = stack.takeLast();
+        auto it = m_directories.find(current);
+        if (it == m_directories.end()) {
+            continue;
+        }
+        stack.append(it->subdirectories);
+        m_directories.erase(it);
+        removedDirectories->append(current);
+    }
+}
+
+/**
+ * 目录数超过上限时不监视（查询前按间隔校验），否则同步监视列表
+ */
+void HalconFileIndex::updateWatcher(const QStringList& added, const QStringList& removed)
+{
+    QStringList allDirectories;
+    int total = 0;
+    {
+        QReadLocker locker(&m_lock);
+        total = m_directories.size();
+        if (m_watcher->directories().isEmpty() && total <= m_maxWatchedDirectories) {
+            allDirectories = m_directories.keys();
+        }
+    }
+
+    int watched = 0;
+    if (m_maxWatchedDirectories <= 0 || total > m_maxWatchedDirectories) {
+        const QStringList current = m_watcher->directories();
+        if (!current.isEmpty()) {
+            m_watcher->removePaths(current);
+            qDebug() << "⚠️ 索引目录数" << total << "超过监视上限" << m_maxWatchedDirectories << "，改为查询前校验";
+        }
+    } else {
+        if (!removed.isEmpty()) {
+            m_watcher->removePaths(removed);
+        }
+        const QStringList toAdd = allDirectories.isEmpty() ? added : allDirectories;
+        if (!toAdd.isEmpty()) {
+            m_watcher->addPaths(toAdd);
+        }
+        watched = m_watcher->directories().size();
+    }
+
+    QWriteLocker locker(&m_lock);
+    m_stats.watchedDirectories = watched;
+}
+
+void HalconFileIndex::removeFile(const QString& path)
+{
+    QString filePath = normalizePath(path);
+    QString directory = QFileInfo(filePath).absolutePath();
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_directories.find(directory);
+    if (it == m_directories.end()) {
+        return;
+    }
+    QVector<HalconFileEntry> &files = it->files;
+    for (int i = 0; i < files.size(); ++i) {
+        if (files[i].path == filePath) {
+            files.remove(i);
+            m_cacheDirty = true;
+            break;
+        }
+    }
+}
+
+// ==================== 查询 | Queries ====================
+
+void HalconFileIndex::forEachFile(const QString& underPath, const std::function<void(const HalconFileEntry&)>& visitor) const
+{
+    const QString start = underPath.isEmpty() ? m_rootPath : normalizePath(underPath);
+
+    QReadLocker locker(&m_lock);
+    QStringList stack;
+    stack << start;
+    while (!stack.isEmpty()) {
+        auto it = m_directories.constFind(stack.takeLast());
+        if (it == m_directories.constEnd()) {
+            continue;
+        }
+        for (const HalconFileEntry &entry : it->files) {
+            visitor(entry);
+        }
+        stack.append(it->subdirectories);
+    }
+}
+
+HalconFileIndexStats HalconFileIndex::stats() const
+{
+    QReadLocker locker(&m_lock);
+    HalconFileIndexStats result = m_stats;
+    result.directories = m_directories.size();
+    result.files = 0;
+    for (const DirectoryNode &node : m_directories) {
+        result.files += node.files.size();
+    }
+    return result;
+}
+
+// ==================== 缓存文件 | Cache File ====================
+
+bool HalconFileIndex::save()
+{
+    if (m_cachePath.isEmpty() || !m_open) {
+        return false;
+    }
+    QDir().mkpath(QFileInfo(m_cachePath).absolutePath());
+
+    QSaveFile file(m_cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "❌ 无法写入文件索引缓存:" << m_cachePath;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    {
+        QReadLocker locker(&m_lock);
+        out << kIndexCacheMagic << kIndexCacheVersion << m_rootPath << quint32(m_directories.size());
+        for (auto it = m_directories.constBegin(); it != m_directories.constEnd(); ++it) {
+            const DirectoryNode &node = it.value();
+            out << it.key() << node.modifiedMs << node.subdirectories << quint32(node.files.size());
+            for (const HalconFileEntry &entry : node.files) {
+                out << entry.fileName << entry.size << entry.modifiedMs;
+            }
+        }
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qDebug() << "❌ 写入文件索引缓存失败:" << m_cachePath;
+        return false;
+    }
+    m_cacheDirty = false;
+    return true;
+}
+
+bool HalconFileIndex::loadCache(DirectoryMap* directories) const
+{
+    if (m_cachePath.isEmpty()) {
+        return false;
+    }
+    QFile file(m_cachePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString rootPath;
+    quint32 directoryCount = 0;
+    in >> magic >> version >> rootPath >> directoryCount;
+    if (magic != kIndexCacheMagic || version != kIndexCacheVersion || rootPath != m_rootPath) {
+        return false;
+    }
+
+    for (quint32 d = 0; d < directoryCount && in.status() == QDataStream::Ok; ++d) {
+        QString path;
+        DirectoryNode node;
+        quint32 fileCount = 0;
+        in >> path >> node.modifiedMs >> node.subdirectories >> fileCount;
+        node.files.reserve(static_cast<int>(qMin<quint32>(fileCount, 1u << 20)));
+        for (quint32 f = 0; f < fileCount && in.status() == QDataStream::Ok; ++f) {
+            HalconFileEntry entry;
+            in >> entry.fileName >> entry.size >> entry.modifiedMs;
+            entry.path = joinPath(path, entry.fileName);
+            entry.suffix = completeSuffix(entry.fileName);
+            node.files.append(entry);
+        }
+        resolveTypes(&node); // 类型按当前扩展名映射重新计算
+        directories->insert(path, node);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "⚠️ 文件索引缓存已损坏，重新构建:" << m_cachePath;
+        directories->clear();
+        return false;
+    }
+    return true;
+}
+
+void HalconFileIndex::resolveTypes(DirectoryNode* node) const
+{
+    if (!m_resolver) {
+        return;
+    }
+    for (HalconFileEntry &entry : node->files) {
+        entry.fileType = m_resolver(entry.fileName);
+    }
+}
@@ -19,6 +19,12 @@ HalconFileManager::HalconFileManager(QObject *parent) : QObject(parent)
                          << "results" << "calibration" << "temp" << "backup";
 }
 
+HalconFileManager::~HalconFileManager()
+{
+    qDeleteAll(m_fileIndexes); // 析构时保存索引缓存
+    m_fileIndexes.clear();
+}
+
 void HalconFileManager::initializeExtensionMap()
 {
     // 🎯 初始化Halcon专用文件扩展名映射表
@@ -361,6 +367,74 @@ bool HalconFileManager::createProjectDirectory(const QString& projectName, const
     return createDirectoryStructure(projectPath);
 }
 
+void HalconFileManager::setFileIndexEnabled(bool enabled)
+{
+    m_fileIndexEnabled = enabled;
+    if (!enabled) {
+        qDeleteAll(m_fileIndexes);
+        m_fileIndexes.clear();
+    }
+}
+
+HalconFileIndex* HalconFileManager::fileIndex(const QString& directoryPath) const
+{
+    if (!m_fileIndexEnabled) {
+        return nullptr;
+    }
+
+    QString path = HalconFileIndex::normalizePath(directoryPath);
+    for (HalconFileIndex* index : m_fileIndexes) {
+        QString root = index->rootPath();
+        if (path == root || path.startsWith(root.endsWith('/') ? root : root + '/')) {
+            index->refresh();
+            return index;
+        }
+    }
+
+    // 🗂️ 新建索引：加载缓存并校验，没有缓存时并行遍历构建
+    auto resolver = [this](const QString& fileName) { return getFileTypeFromExtension(fileName); };
+    HalconFileIndex* index = new HalconFileIndex(path, resolver);
+    index->setCachePath(HalconFileIndex::defaultCachePath(path));
+    if (!index->open()) {
+        delete index;
+        return nullptr;
+    }
+
+    // 新索引覆盖的子目录索引不再需要
+    for (int i = m_fileIndexes.size() - 1; i >= 0; --i) {
+        QString root = m_fileIndexes[i]->rootPath();
+        if (root.startsWith(path.endsWith('/') ? path : path + '/')) {
+            delete m_fileIndexes.takeAt(i);
+        }
+    }
+    m_fileIndexes.append(index);
+    return index;
+}
+
+void HalconFileManager::forEachFile(const QString& directoryPath, const std::function<void(const HalconFileEntry&)>& visitor) const
+{
+    HalconFileIndex* index = fileIndex(directoryPath);
+    if (index) {
+        index->forEachFile(directoryPath, visitor);
+        return;
+    }
+
+    // 🔍 未启用索引：递归扫描所有文件
+    QDirIterator it(directoryPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo fileInfo = it.fileInfo();
+        HalconFileEntry entry;
+        entry.path = fileInfo.absoluteFilePath();
+        entry.fileName = fileInfo.fileName();
+        entry.suffix = fileInfo.completeSuffix();
+        entry.fileType = getFileTypeFromExtension(entry.fileName);
+        entry.size = fileInfo.size();
+        entry.modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+        visitor(entry);
+    }
+}
+
 FileStats HalconFileManager::analyzeDirectory(const QString& directoryPath) const
 {
     FileStats stats;
@@ -371,34 +445,31 @@ FileStats HalconFileManager::analyzeDirectory(const QString& directoryPath) cons
         return stats;
     }
     
-    // 🔍 递归扫描所有文件
-    QDirIterator it(directoryPath, QDir::Files, QDirIterator::Subdirectories);
-    
-    while (it.hasNext()) {
-        QString filePath = it.next();
-        QFileInfo fileInfo(filePath);
-        
+    qint64 lastModifiedMs = 0;
+    forEachFile(directoryPath, [&](const HalconFileEntry& entry) {
         // 📊 更新统计信息
         stats.totalFiles++;
-        stats.totalSize += fileInfo.size();
+        stats.totalSize += entry.size;
         
         // 🔍 检查是否是Halcon文件
-        QString fileType = getFileTypeFromExtension(filePath);
-        if (!fileType.isEmpty()) {
-            stats.fileTypeCount[fileType]++;
+        if (!entry.fileType.isEmpty()) {
+            stats.fileTypeCount[entry.fileType]++;
         }
         
         // 📈 跟踪最大文件
-        if (fileInfo.size() > stats.largestFileSize) {
-            stats.largestFileSize = fileInfo.size();
-            stats.largestFileName = fileInfo.fileName();
+        if (entry.size > stats.largestFileSize) {
+            stats.largestFileSize = entry.size;
+            stats.largestFileName = entry.fileName;
         }
         
         // 📅 跟踪最新修改文件
-        if (fileInfo.lastModified() > stats.lastModified) {
-            stats.lastModified = fileInfo.lastModified();
-            stats.lastModifiedFile = fileInfo.fileName();
+        if (entry.modifiedMs > lastModifiedMs) {
+            lastModifiedMs = entry.modifiedMs;
+            stats.lastModifiedFile = entry.fileName;
         }
+    });
+    if (lastModifiedMs > 0) {
+        stats.lastModified = QDateTime::fromMSecsSinceEpoch(lastModifiedMs);
     }
     
     return stats;
@@ -408,34 +479,35 @@ QStringList HalconFileManager::findFilesByType(const QString& directoryPath, con
 {
     QStringList foundFiles;
     QString extension = getFileExtension(fileType);
-    QString pattern = QString("*%1").arg(extension);
-    
-    QDir dir(directoryPath);
-    QStringList filters;
-    filters << pattern;
     
-    // 🔍 递归搜索
-    QDirIterator it(directoryPath, filters, QDir::Files, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        foundFiles << it.next();
-    }
+    // 🔍 与 "*扩展名" 通配符相同：文件名以扩展名结尾（不区分大小写）
+    forEachFile(directoryPath, [&](const HalconFileEntry& entry) {
+        if (entry.fileName.endsWith(extension, Qt::CaseInsensitive)) {
+            foundFiles << entry.path;
+        }
+    });
     
+    foundFiles.sort();
     return foundFiles;
 }
 
 QStringList HalconFileManager::getAllHalconFiles(const QString& directoryPath) const
 {
     QStringList allFiles;
+    QStringList extensions = m_extensionMap.values();
+    extensions.removeDuplicates();
+    
+    // 🔍 一次遍历匹配所有支持的Halcon文件扩展名
+    forEachFile(directoryPath, [&](const HalconFileEntry& entry) {
+        for (const QString& extension : extensions) {
+            if (entry.fileName.endsWith(extension, Qt::CaseInsensitive)) {
+                allFiles << entry.path;
+                break;
+            }
+        }
+    });
     
-    // 🔍 搜索所有支持的Halcon文件类型
-    for (auto it = m_extensionMap.begin(); it != m_extensionMap.end(); ++it) {
-        QStringList typeFiles = findFilesByType(directoryPath, it.key());
-        allFiles.append(typeFiles);
-    }
-    
-    allFiles.removeDuplicates();
     allFiles.sort();
-    
     return allFiles;
 }
 
@@ -446,19 +518,36 @@ bool HalconFileManager::cleanupOldFiles(const QString& directoryPath, int daysOl
         return false;
     }
     
-    QDateTime cutoffDate = QDateTime::currentDateTime().addDays(-daysOld);
-    bool hasDeleted = false;
+    qint64 cutoffMs = QDateTime::currentDateTime().addDays(-daysOld).toMSecsSinceEpoch();
+    QStringList extensions = m_extensionMap.values();
     
-    // 🗑️ 删除旧文件
-    QDirIterator it(directoryPath, QDir::Files, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        QString filePath = it.next();
-        QFileInfo fileInfo(filePath);
-        
-        if (fileInfo.lastModified() < cutoffDate && isValidHalconFile(filePath)) {
-            if (QFile::remove(filePath)) {
-                qDebug() << "🗑️ 已删除旧文件:" << fileInfo.fileName();
-                hasDeleted = true;
+    // 🔍 先收集再删除（遍历期间持有索引读锁）
+    QStringList expiredFiles;
+    forEachFile(directoryPath, [&](const HalconFileEntry& entry) {
+        if (entry.modifiedMs < cutoffMs && extensions.contains("." + entry.suffix)) {
+            expiredFiles << entry.path;
+        }
+    });
+    
+    // 🗑️ 删除旧文件：索引中的修改时间可能已过期（原地改写不改变目录修改时间），删除前重新 stat
+    HalconFileIndex* index = fileIndex(directoryPath);
+    bool hasDeleted = false;
+    for (const QString& filePath : expiredFiles) {
+        QFileInfo info(filePath);
+        if (!info.exists()) {
+            if (index) {
+                index->removeFile(filePath);
+            }
+            continue;
+        }
+        if (info.lastModified().toMSecsSinceEpoch() >= cutoffMs) {
+            continue;
+        }
+        if (QFile::remove(filePath)) {
+            qDebug() << "🗑️ 已删除旧文件:" << QFileInfo(filePath).fileName();
+            hasDeleted = true;
+            if (index) {
+                index->removeFile(filePath);
             }
         }
     }
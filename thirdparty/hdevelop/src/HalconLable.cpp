@@ -1,21 +1,97 @@
 #include "HalconLable.h"
 #include <QStandardPaths>
 #include <QDebug>
+#include <QCryptographicHash>
+#include <QFuture>
+#include <QGuiApplication>
+#include <QHash>
+#include <QMutex>
+#include <QPointF>
+#include <QScreen>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentRun>
 #include "qglobal.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ColorThreshold.h"
+#include "ImageFilters.h"
+#include "KernelRuntime.h"
+#include "Region.h"
+
 // #pragma execution_character_set("utf-8")
+namespace {
+// Halcon颜色名 → RGB，用于把叠加对象绘入缓存图像；其他名称和#rrggbb交给QColor解析
+bool overlayColorRgb(const QString& color, HTuple* rgb) {
+  static const QHash<QString, QColor> kHalconColors = {
+      {"black", QColor(0, 0, 0)},       {"white", QColor(255, 255, 255)}, {"red", QColor(255, 0, 0)},
+      {"green", QColor(0, 255, 0)},     {"blue", QColor(0, 0, 255)},      {"cyan", QColor(0, 255, 255)},
+      {"magenta", QColor(255, 0, 255)}, {"yellow", QColor(255, 255, 0)},  {"gray", QColor(190, 190, 190)},
+      {"orange", QColor(255, 165, 0)}};
+  QColor value = kHalconColors.value(color.toLower());
+  if (!value.isValid()) {
+    QString name = QString(color).remove(' ');
+    value = QColor(name.startsWith('#') ? name.left(7) : name); // Halcon的#rrggbbaa去掉透明度
+  }
+  if (!value.isValid()) {
+    return false;
+  }
+  *rgb = HTuple();
+  rgb->Append(value.red());
+  rgb->Append(value.green());
+  rgb->Append(value.blue());
+  return true;
+}
+
+constexpr int kRenderMaxLevels = 8; // 金字塔最多层数（含原图）
+
+// 像素读取缓存支持的像素类型
+enum PixelType { PixelUnsupported = 0, PixelByte, PixelInt1, PixelUInt2, PixelInt2, PixelInt4, PixelReal };
+
+int pixelTypeFromName(const QString& name) {
+  if (name == "byte") return PixelByte;
+  if (name == "int1") return PixelInt1;
+  if (name == "uint2") return PixelUInt2;
+  if (name == "int2") return PixelInt2;
+  if (name == "int4") return PixelInt4;
+  if (name == "real") return PixelReal;
+  return PixelUnsupported;
+}
+
+double readPlaneValue(const void* plane, int pixelType, qint64 offset) {
+  switch (pixelType) {
+  case PixelByte: return static_cast<const quint8*>(plane)[offset];
+  case PixelInt1: return static_cast<const qint8*>(plane)[offset];
+  case PixelUInt2: return static_cast<const quint16*>(plane)[offset];
+  case PixelInt2: return static_cast<const qint16*>(plane)[offset];
+  case PixelInt4: return static_cast<const qint32*>(plane)[offset];
+  case PixelReal: return static_cast<const float*>(plane)[offset];
+  default: return 0.0;
+  }
+}
+
+QString formatPixelValue(double value, int pixelType) {
+  return pixelType == PixelReal ? QString::number(value, 'g', 6) : QString::number(qRound64(value));
+}
+} // namespace
+
 HalconLable::HalconLable(QWidget *parent) : QWidget(parent) {
   mQWindowID = (Hlong)this->winId();
   
   // 🎯 初始化新增成员变量 | Initialize new member variables
   isMove = false;
   contextMenu = nullptr;
-  currentHistoryIndex = -1;
   enableOperationHistory = true;
   
   // 🎯 初始化像素信息显示功能 | Initialize pixel info display functionality
   m_pixelInfoDisplayEnabled = true;  // 默认开启
   m_lastPixelInfo = "";
+  m_shownPixel = QPoint(-1, -1);
   
   // 🎯 初始化防闪烁优化功能 | Initialize anti-flicker optimization
   m_smoothResizeEnabled = true;      // 默认开启平滑调整
@@ -27,6 +103,22 @@ HalconLable::HalconLable(QWidget *parent) : QWidget(parent) {
   m_resizeTimer = new QTimer(this);
   m_resizeTimer->setSingleShot(true);
   connect(m_resizeTimer, &QTimer::timeout, this, &HalconLable::applyWindowSizeChange);
+
+  // 🚀 渲染缓存与重绘合并 | Render cache and redraw coalescing
+  m_renderCacheEnabled = true;
+  m_renderCacheDirty = true;
+  m_renderOverlayBaked = false;
+  m_overlayBucketsDirty = true;
+  m_nativeKernelsEnabled = true;
+  QScreen* screen = QGuiApplication::primaryScreen();
+  double refreshRate = (screen && screen->refreshRate() > 1.0) ? screen->refreshRate() : 60.0;
+  m_redrawIntervalMs = qBound(4, qRound(1000.0 / refreshRate), 50);
+  m_redrawTimer = new QTimer(this);
+  m_redrawTimer->setSingleShot(true);
+  connect(m_redrawTimer, &QTimer::timeout, this, &HalconLable::renderFromCache);
+  m_pixelInfoTimer = new QTimer(this);
+  m_pixelInfoTimer->setSingleShot(true);
+  connect(m_pixelInfoTimer, &QTimer::timeout, this, &HalconLable::flushPixelInfoDisplay);
   
   // 🏷️ 创建像素信息显示标签 | Create pixel info display label
   m_pixelInfoLabel = new QLabel(this);
@@ -159,6 +251,7 @@ HObject HalconLable::QtGrabImg() {
   try {
     GrabImageAsync(&Image, AcqHandle, -1);
     mShowImage = Image; // halcon这里备份一个图片，用于本类其他图像处理使用
+    invalidateRenderCache();
   } catch (HalconCpp::HException e) {
     Image.Clear();
   }
@@ -180,10 +273,8 @@ void HalconLable::QtCloseCam() {
  */
 void HalconLable::RemoveShow() {
   try {
-    foreach (HObject symbolXLD, showSymbolList) {
-      symbolXLD.GenEmptyObj();
-    }
     showSymbolList.clear();
+    invalidateRenderCache();
     ClearWindow(mHWindowID);
   } catch (HalconCpp::HOperatorException) {
   }
@@ -198,12 +289,13 @@ void HalconLable::clearDisplayObjectsOnly() {
     // 🧹 安全清除显示对象列表
     if (showSymbolList.size() > 0) {
       qDebug() << QString("清除 %1 个显示对象...").arg(showSymbolList.size());
+      const QList<DisplayOverlay> before = showSymbolList;
       
       // 🛡️ 安全清除：逐一清除对象
-      foreach (HObject symbolXLD, showSymbolList) {
+      for (DisplayOverlay& overlay : showSymbolList) {
         try {
-          if (symbolXLD.IsInitialized()) {
-            symbolXLD.Clear();
+          if (overlay.object.IsInitialized()) {
+            overlay.object.Clear();
           }
         } catch (HalconCpp::HException& e) {
           qDebug() << "清除单个对象时出错：" << QString(e.ErrorMessage());
@@ -211,6 +303,8 @@ void HalconLable::clearDisplayObjectsOnly() {
       }
       
       showSymbolList.clear();
+      invalidateRenderCache();
+      recordOverlayChange("清除显示对象", before);
       qDebug() << "✅ 显示对象已清除";
     }
     
@@ -367,40 +461,7 @@ bool HalconLable::QtSaveImageSafe(HObject mImg, QString& errorMessage) {
         }
       }
 
-      try {
-        QString fileExt = QFileInfo(filePath).suffix().toLower();
-        HTuple imageType;
-        
-        // 根据扩展名确定图像类型
-        if (fileExt == "jpg" || fileExt == "jpeg") {
-          imageType = "jpg";
-        } else if (fileExt == "png") {
-          imageType = "png";
-        } else if (fileExt == "bmp") {
-          imageType = "bmp";
-        } else if (fileExt == "tif" || fileExt == "tiff") {
-          imageType = "tiff";
-        } else {
-          imageType = "jpg"; // 默认使用jpg格式
-          filePath = QFileInfo(filePath).path() + "/" + QFileInfo(filePath).baseName() + ".jpg";
-        }
-
-        HTuple fillColor(0);
-        WriteImage(mImg, imageType, fillColor, filePath.toStdString().c_str());
-        
-        // 验证文件是否成功创建
-        if (QFile::exists(filePath)) {
-          errorMessage = tr("图像保存成功：%1").arg(QFileInfo(filePath).fileName());
-          return true;
-        } else {
-          errorMessage = tr("图像保存失败：文件未创建");
-          return false;
-        }
-        
-      } catch (HalconCpp::HException& e) {
-        errorMessage = tr("Halcon保存错误：%1").arg(QString(e.ErrorMessage()));
-        return false;
-      }
+      return writeImageFile(mImg, filePath, errorMessage);
     }
     
     errorMessage = tr("用户取消了文件保存");
@@ -415,6 +476,59 @@ bool HalconLable::QtSaveImageSafe(HObject mImg, QString& errorMessage) {
   }
 }
 
+/**
+ * @brief ch:设置异步图像写入回调 | en:Set asynchronous image write handler
+ * @param handler 写入回调，为空时同步写入
+ */
+void HalconLable::setImageWriteHandler(const ImageWriteHandler& handler) {
+  m_imageWriteHandler = handler;
+}
+
+/**
+ * @brief ch:按扩展名写入图像文件 | en:Write image file by extension
+ * 💾 设置了异步写入回调时只把图像引用交给回调，界面线程不做编码
+ */
+bool HalconLable::writeImageFile(const HObject& image, QString& filePath, QString& errorMessage) {
+  QString fileExt = QFileInfo(filePath).suffix().toLower();
+  HTuple imageType;
+  if (fileExt == "jpg" || fileExt == "jpeg") {
+    imageType = "jpg";
+  } else if (fileExt == "png") {
+    imageType = "png";
+  } else if (fileExt == "bmp") {
+    imageType = "bmp";
+  } else if (fileExt == "tif" || fileExt == "tiff") {
+    imageType = "tiff";
+  } else {
+    imageType = "jpg"; // 默认使用jpg格式
+    filePath = QFileInfo(filePath).path() + "/" + QFileInfo(filePath).completeBaseName() + ".jpg";
+  }
+
+  if (m_imageWriteHandler) {
+    if (!m_imageWriteHandler(image, filePath)) {
+      errorMessage = tr("图像未能加入保存队列（队列已满或磁盘空间不足）：%1").arg(QFileInfo(filePath).fileName());
+      return false;
+    }
+    errorMessage = tr("图像已加入保存队列：%1").arg(QFileInfo(filePath).fileName());
+    return true;
+  }
+
+  try {
+    WriteImage(image, imageType, HTuple(0), filePath.toStdString().c_str());
+  } catch (HalconCpp::HException& e) {
+    errorMessage = tr("Halcon保存错误：%1").arg(QString(e.ErrorMessage()));
+    return false;
+  }
+
+  // 验证文件是否成功创建
+  if (!QFile::exists(filePath)) {
+    errorMessage = tr("图像保存失败：文件未创建");
+    return false;
+  }
+  errorMessage = tr("图像保存成功：%1").arg(QFileInfo(filePath).fileName());
+  return true;
+}
+
 /**
  * @brief ch:添加显示对象到列表 | en:Add display object to list
  * @param obj 要添加的对象
@@ -422,13 +536,25 @@ bool HalconLable::QtSaveImageSafe(HObject mImg, QString& errorMessage) {
  * @param lineWidth 线宽
  */
 void HalconLable::addDisplayObject(HObject obj, QString color, double lineWidth) {
+  addDisplayObject(obj, DisplayStyle(color, lineWidth));
+}
+
+/**
+ * @brief ch:按指定样式添加显示对象 | en:Add display object with style
+ * @param obj 要添加的对象
+ * @param style 显示样式
+ * @param redraw 是否立即重绘
+ */
+void HalconLable::addDisplayObject(HObject obj, const DisplayStyle& style, bool redraw) {
   try {
     if (obj.IsInitialized()) {
-      showSymbolList.append(obj);
-      qDebug() << QString("添加显示对象成功，当前对象数量：%1").arg(showSymbolList.size());
+      const QList<DisplayOverlay> before = showSymbolList;
+      showSymbolList.append(DisplayOverlay(obj, style));
+      invalidateRenderCache();
+      recordOverlayChange("添加显示对象", before);
       
       // 重新显示图像
-      if (mShowImage.IsInitialized()) {
+      if (redraw && mShowImage.IsInitialized()) {
         showHalconImage();
       }
     } else {
@@ -457,10 +583,13 @@ int HalconLable::getDisplayObjectsCount() const {
 bool HalconLable::removeDisplayObjectByIndex(int index) {
   try {
     if (index >= 0 && index < showSymbolList.size()) {
-      if (showSymbolList[index].IsInitialized()) {
-        showSymbolList[index].Clear();
+      const QList<DisplayOverlay> before = showSymbolList;
+      if (showSymbolList[index].object.IsInitialized()) {
+        showSymbolList[index].object.Clear();
       }
       showSymbolList.removeAt(index);
+      invalidateRenderCache();
+      recordOverlayChange(QString("移除显示对象 %1").arg(index), before);
       
       // 重新显示图像
       if (mShowImage.IsInitialized()) {
@@ -560,7 +689,11 @@ void HalconLable::showImage(HObject inputImage) {
   }
   
   try {
+    if (!m_editHistory.isHead(inputImage)) {
+      m_editHistory.clear(); // 新图像与撤销历史无关
+    }
     mShowImage = inputImage;
+    invalidateRenderCache();
     changeShowRegion();
     showHalconImage();
     qDebug() << "✅ 图像显示成功";
@@ -571,8 +704,125 @@ void HalconLable::showImage(HObject inputImage) {
   }
 }
 
+/**
+ * @brief HalconLable::showImageWithOverlays 同时显示图像和叠加对象，只渲染一次
+ */
+void HalconLable::showImageWithOverlays(HObject inputImage, const QList<DisplayOverlay>& overlays) {
+  if (!inputImage.IsInitialized()) {
+    qDebug() << "⚠️ 警告：尝试显示未初始化的图像";
+    return;
+  }
+  if (!ensureHalconWindowInitialized()) {
+    qDebug() << "❌ 错误：Halcon窗口初始化失败，无法显示图像";
+    return;
+  }
+
+  try {
+    if (!m_editHistory.isHead(inputImage)) {
+      m_editHistory.clear();
+    }
+    showSymbolList.clear();
+    for (const DisplayOverlay& overlay : overlays) {
+      if (overlay.object.IsInitialized()) {
+        showSymbolList.append(overlay);
+      }
+    }
+    mShowImage = inputImage;
+    invalidateRenderCache();
+    changeShowRegion();
+    showHalconImage();
+  } catch (HalconCpp::HException& e) {
+    qDebug() << "❌ 显示图像时发生Halcon异常：" << QString(e.ErrorMessage());
+  } catch (...) {
+    qDebug() << "❌ 显示图像时发生未知异常";
+  }
+}
+
+/**
+ * @brief HalconLable::applyImageEdit 应用可撤销的图像编辑
+ * 🧩 撤销历史只保存变化的分块，尺寸不变时保留当前显示区域
+ */
+bool HalconLable::applyImageEdit(HObject editedImage, const QString& label) {
+  if (!editedImage.IsInitialized()) {
+    qDebug() << "⚠️ 警告：编辑结果图像未初始化";
+    return false;
+  }
+  if (!mShowImage.IsInitialized()) {
+    showImage(editedImage);
+    return true;
+  }
+
+  if (enableOperationHistory) {
+    if (!m_editHistory.isHead(mShowImage)) {
+      m_editHistory.clear();
+    }
+    m_editHistory.recordImageEdit(label, mShowImage, editedImage);
+  }
+  displayHistoryImage(editedImage);
+  return true;
+}
+
+/**
+ * @brief HalconLable::displayHistoryImage 显示编辑/撤销后的图像
+ */
+void HalconLable::displayHistoryImage(const HObject& image) {
+  if (!ensureHalconWindowInitialized()) {
+    return;
+  }
+  try {
+    HTuple oldWidth = mHtWidth;
+    HTuple oldHeight = mHtHeight;
+    mShowImage = image;
+    invalidateRenderCache();
+
+    HTuple width, height;
+    GetImageSize(mShowImage, &width, &height);
+    if (oldWidth.Length() == 0 || oldHeight.Length() == 0 ||
+        width.I() != oldWidth.I() || height.I() != oldHeight.I()) {
+      changeShowRegion(); // 尺寸变化时重新适配窗口
+    }
+    showHalconImage();
+  } catch (HalconCpp::HException& e) {
+    qDebug() << "❌ 显示编辑图像时发生Halcon异常：" << QString(e.ErrorMessage());
+  }
+}
+
+/**
+ * @brief HalconLable::recordOverlayChange 把叠加对象列表的变化记录为撤销命令
+ * 💡 列表中只有HObject引用，但被引用的区域/XLD在撤销记录存在期间不会释放，
+ *    按前后两份列表中不重复的对象估算内存，计入撤销历史预算
+ */
+void HalconLable::recordOverlayChange(const QString& label, const QList<DisplayOverlay>& before) {
+  if (!enableOperationHistory) {
+    return;
+  }
+  const QList<DisplayOverlay> after = showSymbolList;
+  qint64 approxBytes = static_cast<qint64>(before.size() + after.size()) * sizeof(DisplayOverlay);
+  QSet<Hkey> counted;
+  for (const QList<DisplayOverlay>* overlays : {&before, &after}) {
+    for (const DisplayOverlay& overlay : *overlays) {
+      if (overlay.object.IsInitialized() && !counted.contains(overlay.object.Key())) {
+        counted.insert(overlay.object.Key());
+        approxBytes += ImageEditHistory::estimateObjectBytes(overlay.object);
+      }
+    }
+  }
+  auto restore = [this](const QList<DisplayOverlay>& overlays) {
+    showSymbolList = overlays;
+    invalidateRenderCache();
+    if (mShowImage.IsInitialized()) {
+      showHalconImage();
+    }
+  };
+  m_editHistory.recordCommand(label,
+                              [restore, before]() { restore(before); },
+                              [restore, after]() { restore(after); },
+                              approxBytes);
+}
+
 /**
  * @brief HalconLable::showHalconObject 显示Halcon对象 - 优化版本
+ * 单个对象直接绘制，不再切换flush_graphic（每次切换都会触发整窗刷新）
  */
 void HalconLable::showHalconObject(HObject hObject, QString colorStr,
                                    double lineWidth) {
@@ -588,8 +838,6 @@ void HalconLable::showHalconObject(HObject hObject, QString colorStr,
       return;
     }
     
-    SetSystem("flush_graphic", "false"); // 设置Halcon图形刷新为false
-    
     // 设置显示属性
     showLineWidth = (lineWidth > 0) ? lineWidth : 2.0; // 确保线宽有效
     SetLineWidth(mHWindowID, showLineWidth);
@@ -611,8 +859,6 @@ void HalconLable::showHalconObject(HObject hObject, QString colorStr,
   } catch (...) {
     qDebug() << "❌ 显示Halcon对象时发生未知异常";
   }
-  
-  SetSystem("flush_graphic", "true");
 }
 
 /**
@@ -654,6 +900,9 @@ void HalconLable::changeShowRegion() {
  * 显示图像，执行顺序，先清空窗口，再一个个显示
  */
 void HalconLable::showHalconImage() {
+  if (m_redrawTimer->isActive()) {
+    m_redrawTimer->stop(); // 完整重绘覆盖等待中的缓存重绘
+  }
   try {
     SetSystem("flush_graphic", "false");
     ClearWindow(mHWindowID);
@@ -662,37 +911,284 @@ void HalconLable::showHalconImage() {
       SetPart(mHWindowID, mDDispImagePartRow0, mDDispImagePartCol0,
               mDDispImagePartRow1 - 1, mDDispImagePartCol1 - 1);
       DispObj(mShowImage, mHWindowID);
-      if (showSymbolList.count() > 0) {
-        int objectIndex = 0;
-        foreach (HObject HqtObj, showSymbolList) // 遍历容器showSymbolList中的元素，并将元素赋值给HqtObj
-        {
-          if (HqtObj.IsInitialized()) {
-            SetDraw(mHWindowID, "margin");
-            SetLineWidth(mHWindowID, 2); // 设置线宽
-            
-            // 根据对象索引设置不同的颜色
-            // 区域对象使用绿色，轮廓对象使用红色，以便区分
-            if (objectIndex % 4 == 0) {
-              SetColor(mHWindowID, "green"); // 测量区域1
-            } else if (objectIndex % 4 == 1) {
-              SetColor(mHWindowID, "green"); // 测量区域2 
-            } else if (objectIndex % 4 == 2) {
-              SetColor(mHWindowID, "red");   // 轮廓1
-              SetLineWidth(mHWindowID, 3);   // 轮廓使用更粗的线
-            } else {
-              SetColor(mHWindowID, "blue");  // 轮廓2
-              SetLineWidth(mHWindowID, 3);   // 轮廓使用更粗的线
-            }
-            
-            DispObj(HqtObj, mHWindowID);
-            objectIndex++;
+      drawOverlayObjects();
+    }
+    SetSystem("flush_graphic", "true");
+  } catch (HalconCpp::HException e) {
+  }
+  m_lastRedraw.start();
+}
+
+/**
+ * @brief HalconLable::drawOverlayObjects 绘制showSymbolList中的叠加对象
+ * 🚀 同一样式的对象已合并，每组只设置一次显示属性并调用一次DispObj
+ */
+void HalconLable::drawOverlayObjects() {
+  if (m_overlayBucketsDirty) {
+    rebuildOverlayBuckets();
+  }
+  foreach (const OverlayBucket& bucket, m_overlayBuckets) {
+    SetDraw(mHWindowID, bucket.style.drawMode.toStdString().c_str());
+    SetLineWidth(mHWindowID, bucket.style.lineWidth);
+    SetColor(mHWindowID, bucket.style.color.toStdString().c_str());
+    DispObj(bucket.objects, mHWindowID);
+  }
+}
+
+/**
+ * @brief HalconLable::overlayBucketIndex 查找样式所在分组
+ */
+int HalconLable::overlayBucketIndex(const DisplayStyle& style) const {
+  for (int i = 0; i < m_overlayBuckets.size(); ++i) {
+    if (m_overlayBuckets[i].style == style) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief HalconLable::rebuildOverlayBuckets 按样式分组并合并叠加对象
+ * 分组按样式首次出现的顺序绘制，组内保持添加顺序
+ */
+void HalconLable::rebuildOverlayBuckets() {
+  m_overlayBuckets.clear();
+  for (const DisplayOverlay& overlay : showSymbolList) {
+    if (!overlay.object.IsInitialized()) {
+      continue;
+    }
+    int index = overlayBucketIndex(overlay.style);
+    if (index < 0) {
+      OverlayBucket bucket;
+      bucket.style = overlay.style;
+      bucket.objects = overlay.object;
+      bucket.count = 1;
+      m_overlayBuckets.append(bucket);
+    } else {
+      OverlayBucket& bucket = m_overlayBuckets[index];
+      ConcatObj(bucket.objects, overlay.object, &bucket.objects);
+      bucket.count++;
+    }
+  }
+  m_overlayBucketsDirty = false;
+}
+
+/* ==================== 渲染缓存 | Render cache ==================== */
+
+/**
+ * @brief 标记渲染缓存失效 | Invalidate render cache
+ * 🚀 只释放缓存，重建推迟到下一次平移/缩放，连续出图时不产生额外开销
+ */
+void HalconLable::invalidateRenderCache() {
+  m_renderCacheDirty = true;
+  m_overlayBucketsDirty = true;
+  m_renderOverlayBaked = false;
+  m_renderPyramid.clear();
+}
+
+void HalconLable::setRenderCacheEnabled(bool enabled) {
+  m_renderCacheEnabled = enabled;
+  if (!enabled) {
+    invalidateRenderCache();
+  }
+  qDebug() << QString("🚀 渲染缓存：%1").arg(enabled ? "开启" : "关闭");
+}
+
+bool HalconLable::isRenderCacheEnabled() const {
+  return m_renderCacheEnabled;
+}
+
+/**
+ * @brief 请求重绘 | Request redraw
+ * 🎯 距上次重绘不足一个刷新周期时只启动定时器，期间的多次请求合并为一次
+ */
+void HalconLable::requestRedraw() {
+  if (!m_renderCacheEnabled) {
+    showHalconImage();
+    return;
+  }
+  if (m_redrawTimer->isActive()) {
+    return; // 已有等待中的重绘，显示区域在重绘时读取
+  }
+  qint64 elapsed = m_lastRedraw.isValid() ? m_lastRedraw.elapsed() : m_redrawIntervalMs;
+  if (elapsed >= m_redrawIntervalMs) {
+    renderFromCache();
+  } else {
+    m_redrawTimer->start(static_cast<int>(m_redrawIntervalMs - elapsed));
+  }
+}
+
+/**
+ * @brief 重建渲染缓存 | Rebuild render cache
+ */
+bool HalconLable::buildRenderCache() {
+  m_renderPyramid.clear();
+  m_renderOverlayBaked = false;
+  if (!mShowImage.IsInitialized()) {
+    return false;
+  }
+  try {
+    QElapsedTimer timer;
+    timer.start();
+
+    HTuple width, height, channels, type;
+    GetImageSize(mShowImage, &width, &height);
+    CountChannels(mShowImage, &channels);
+    GetImageType(mShowImage, &type);
+
+    // 每个样式分组的叠加对象转换为原图分辨率的区域（XLD 按轮廓线栅格化，fill 模式按填充区域）
+    if (m_overlayBucketsDirty) {
+      rebuildOverlayBuckets();
+    }
+    QVector<HObject> bucketRegions(m_overlayBuckets.size());
+    QVector<HTuple> bucketColors(m_overlayBuckets.size());
+    bool colorsKnown = true;
+    for (int i = 0; i < m_overlayBuckets.size(); ++i) {
+      GenEmptyObj(&bucketRegions[i]);
+      colorsKnown = overlayColorRgb(m_overlayBuckets[i].style.color, &bucketColors[i]) && colorsKnown;
+    }
+    int overlayRegionCount = 0;
+    for (const DisplayOverlay& overlay : showSymbolList) {
+      int bucket = overlay.object.IsInitialized() ? overlayBucketIndex(overlay.style) : -1;
+      if (bucket < 0) {
+        continue;
+      }
+      HTuple objClass;
+      GetObjClass(overlay.object, &objClass);
+      if (objClass.Length() == 0) {
+        continue;
+      }
+      QString className = QString(objClass[0].S().Text());
+      const char* mode = overlay.style.drawMode == "fill" ? "filled" : "margin";
+      HObject region;
+      if (className == "region") {
+        region = overlay.object;
+      } else if (className == "xld_poly") {
+        GenRegionPolygonXld(overlay.object, &region, mode);
+      } else if (className.startsWith("xld")) {
+        GenRegionContourXld(overlay.object, &region, mode);
+      } else {
+        continue; // 图像等其他对象不参与叠加
+      }
+      ConcatObj(bucketRegions[bucket], region, &bucketRegions[bucket]);
+      overlayRegionCount++;
+    }
+
+    // 只对单通道/三通道的byte图像绘入叠加对象，其他情况缩小层仍按矢量绘制
+    int channelCount = channels.I();
+    bool bakeOverlays = overlayRegionCount > 0 && colorsKnown && QString(type.S().Text()) == "byte" &&
+                        (channelCount == 1 || channelCount == 3);
+
+    m_renderPyramid.append(mShowImage); // 第0级：原图（共享数据，不复制）
+    HObject reduced = mShowImage;
+    double levelWidth = width.D();
+    double levelHeight = height.D();
+    while (m_renderPyramid.size() < kRenderMaxLevels &&
+           (levelWidth > mDLableWidth || levelHeight > mdLableHeight) &&
+           qMin(levelWidth, levelHeight) >= 32) {
+      ZoomImageFactor(reduced, &reduced, 0.5, 0.5, "constant");
+      levelWidth /= 2.0;
+      levelHeight /= 2.0;
+
+      if (!bakeOverlays) {
+        m_renderPyramid.append(reduced);
+        continue;
+      }
+
+      // 叠加对象按本级分辨率栅格化后绘入彩色图像，线宽保持为屏幕像素
+      double factor = 1.0 / (1 << m_renderPyramid.size());
+      HObject levelImage;
+      if (channelCount == 1) {
+        Compose3(reduced, reduced, reduced, &levelImage);
+      } else {
+        CopyImage(reduced, &levelImage);
+      }
+      for (int i = 0; i < m_overlayBuckets.size(); ++i) {
+        const DisplayStyle& style = m_overlayBuckets[i].style;
+        HObject zoomed, outline;
+        ZoomRegion(bucketRegions[i], &zoomed, factor, factor);
+        if (style.drawMode == "fill") {
+          outline = zoomed;
+        } else {
+          Boundary(zoomed, &outline, "inner");
+          int lineWidth = qRound(style.lineWidth);
+          if (lineWidth > 1) {
+            DilationRectangle1(outline, &outline, lineWidth, lineWidth);
           }
         }
+        PaintRegion(outline, levelImage, &levelImage, bucketColors[i], "fill");
       }
+      m_renderPyramid.append(levelImage);
+    }
+
+    m_renderOverlayBaked = bakeOverlays;
+    m_renderCacheDirty = false;
+    qDebug() << QString("🚀 渲染缓存已重建：%1 级，叠加对象 %2，耗时 %3 ms")
+                    .arg(m_renderPyramid.size())
+                    .arg(bakeOverlays ? "已绘入" : "矢量绘制")
+                    .arg(timer.elapsed());
+    return true;
+  } catch (HalconCpp::HException& e) {
+    qDebug() << "❌ 重建渲染缓存失败：" << QString(e.ErrorMessage());
+    m_renderPyramid.clear();
+    m_renderOverlayBaked = false;
+    return false;
+  }
+}
+
+/**
+ * @brief 选择金字塔层级 | Select pyramid level
+ * 🎯 选择每个屏幕像素仍对应至少一个该级像素的最小层，画质与原图显示一致
+ */
+int HalconLable::renderLevelForPart() const {
+  double partWidth = mDDispImagePartCol1 - mDDispImagePartCol0;
+  double partHeight = mDDispImagePartRow1 - mDDispImagePartRow0;
+  double scale = qMax(partWidth / qMax(1.0, mDLableWidth), partHeight / qMax(1.0, mdLableHeight));
+  int level = 0;
+  while (level + 1 < m_renderPyramid.size() && scale >= double(1 << (level + 1))) {
+    level++;
+  }
+  return level;
+}
+
+/**
+ * @brief 从缓存渲染 | Render from cache
+ * 🚀 缩小层只显示一幅已绘入叠加对象的图像；显示后窗口坐标系恢复为原图坐标，
+ * 绘制ROI、显示文字等其他操作不受影响
+ */
+void HalconLable::renderFromCache() {
+  if (m_redrawTimer->isActive()) {
+    m_redrawTimer->stop();
+  }
+  if (!mShowImage.IsInitialized()) {
+    return;
+  }
+  if (!m_renderCacheEnabled || (m_renderCacheDirty && !buildRenderCache())) {
+    showHalconImage();
+    return;
+  }
+
+  int level = renderLevelForPart();
+  double factor = 1.0 / (1 << level);
+  double row1 = mDDispImagePartRow1 - 1;
+  double col1 = mDDispImagePartCol1 - 1;
+  try {
+    SetSystem("flush_graphic", "false");
+    ClearWindow(mHWindowID);
+    // 像素中心对齐：原图坐标 r 对应第k级坐标 (r + 0.5) / 2^k - 0.5
+    SetPart(mHWindowID, (mDDispImagePartRow0 + 0.5) * factor - 0.5, (mDDispImagePartCol0 + 0.5) * factor - 0.5,
+            (row1 + 0.5) * factor - 0.5, (col1 + 0.5) * factor - 0.5);
+    DispObj(m_renderPyramid[level], mHWindowID);
+    SetPart(mHWindowID, mDDispImagePartRow0, mDDispImagePartCol0, row1, col1);
+    if (level == 0 || !m_renderOverlayBaked) {
+      drawOverlayObjects();
     }
     SetSystem("flush_graphic", "true");
-  } catch (HalconCpp::HException e) {
+  } catch (HalconCpp::HException& e) {
+    SetSystem("flush_graphic", "true");
+    qDebug() << "⚠️ 缓存渲染失败：" << QString(e.ErrorMessage());
   }
+  m_lastRedraw.start();
 }
 
 /**
@@ -879,9 +1375,9 @@ void HalconLable::mouseMoveEvent(QMouseEvent *event) {
       // 将窗口坐标转换为图像坐标
       QPoint mousePos = event->pos();
       
-      // 获取当前显示的图像区域
+      // 获取当前显示的图像区域（缓存值，不调用Halcon）
       double row1, col1, row2, col2;
-      GetPartFloat(&row1, &col1, &row2, &col2);
+      currentPart(&row1, &col1, &row2, &col2);
       
       // 计算图像坐标
       double imageX = col1 + (mousePos.x() * (col2 - col1)) / (double)this->width();
@@ -901,26 +1397,13 @@ void HalconLable::mouseMoveEvent(QMouseEvent *event) {
     QPoint delta = lastMousePos - event->globalPos();
     double scalex = (lastCol2 - lastCol1 + 1) / (double)width();
     double scaley = (lastRow2 - lastRow1 + 1) / (double)height();
-    try {
-      // set new visible part
-      SetSystem("flush_graphic", "false");
-      ClearWindow(mHWindowID);
-      // 显示
-      if (mShowImage.IsInitialized()) {
-        SetPart(mHWindowID, lastRow1 + (delta.y() * scaley),
-                lastCol1 + (delta.x() * scalex),
-                lastRow2 + (delta.y() * scaley),
-                lastCol2 + (delta.x() * scalex));
-        DispObj(mShowImage, mHWindowID);
-        foreach (HObject symbolXLD, showSymbolList) {
-          if (symbolXLD.IsInitialized()) {
-            DispObj(symbolXLD, mHWindowID);
-          }
-        }
-      }
-      SetSystem("flush_graphic", "true");
-    } catch (HalconCpp::HOperatorException) {
-      // this may happen, if the part image is moved outside the window
+    // 更新显示区域，重绘合并到下一个刷新周期并使用渲染缓存
+    mDDispImagePartRow0 = lastRow1 + (delta.y() * scaley);
+    mDDispImagePartCol0 = lastCol1 + (delta.x() * scalex);
+    mDDispImagePartRow1 = lastRow2 + (delta.y() * scaley) + 1;
+    mDDispImagePartCol1 = lastCol2 + (delta.x() * scalex) + 1;
+    if (mShowImage.IsInitialized()) {
+      requestRedraw();
     }
   }
 }
@@ -940,6 +1423,18 @@ void HalconLable::GetPartFloat(double *row1, double *col1, double *row2,
   *col2 = tcol2.D();
 }
 
+/**
+ * @brief HalconLable::currentPart 获取当前显示区域
+ * 与GetPart返回值一致（结束行列为mDDispImagePartRow1/Col1 - 1），但直接读取缓存的显示区域
+ */
+void HalconLable::currentPart(double *row1, double *col1, double *row2,
+                              double *col2) const {
+  *row1 = mDDispImagePartRow0;
+  *col1 = mDDispImagePartCol0;
+  *row2 = mDDispImagePartRow1 - 1;
+  *col2 = mDDispImagePartCol1 - 1;
+}
+
 /**
  * @brief HalconLable::wheelEvent 鼠标滚轮事件
  */
@@ -986,7 +1481,7 @@ void HalconLable::wheelEvent(QWheelEvent *event) {
       mDDispImagePartRow1 = Row1;
       mDDispImagePartCol1 = Col1;
     }
-    showHalconImage();
+    requestRedraw();
   }
 }
 
@@ -1000,7 +1495,7 @@ void HalconLable::mouseDoubleClickEvent(QMouseEvent *event) {
   //     }
   if (event->buttons() == Qt::LeftButton) {
     changeShowRegion();
-    showHalconImage();
+    requestRedraw();
   }
 }
 
@@ -1016,7 +1511,7 @@ void HalconLable::mousePressEvent(QMouseEvent *event) {
   } else {
     isMove = true;
   }
-  GetPartFloat(&lastRow1, &lastCol1, &lastRow2, &lastCol2);
+  currentPart(&lastRow1, &lastCol1, &lastRow2, &lastCol2);
   lastMousePos = event->globalPos();
 }
 
@@ -1344,59 +1839,301 @@ HTuple HalconLable::QtData2d(HTuple CodeKind, HTuple polarity) {
   return data2dModelID;
 }
 
+/* ==================== 二维码自适应对比度扫描 | Adaptive data-code contrast sweep ==================== */
+
+namespace {
+// 候选增益 0.5 ~ 2.9，步长 0.1（与原顺序扫描的范围一致）
+constexpr int kDataCodeGainCount = 25;
+constexpr int kDataCodeDefaultGain = 5; // 增益 1.0
+constexpr double kDataCodeSameCodeDistance = 20.0; // 同一内容、中心距离小于该值视为同一个码
+
+double dataCodeGain(int index) { return 0.5 + 0.1 * index; }
+
+// 每个模板的句柄副本与增益统计
+struct DataCodeTemplateState {
+  QByteArray fingerprint;        // 源模型序列化内容的哈希，变化（换句柄或改参数）时丢弃旧副本
+  QList<HTuple> freeCopies;      // 空闲的句柄副本
+  int copyCount = 0;             // 已创建的副本数量
+  quint64 wins[kDataCodeGainCount] = {};
+  int lastWinner = -1;           // 最近一次成功的增益序号
+  quint64 sweeps = 0;            // 扫描次数
+  quint64 successes = 0;         // 达到期望数量的次数
+  quint64 decodes = 0;           // 累计 FindDataCode2d 次数
+};
+
+QMutex g_dataCodeMutex;
+QHash<QString, DataCodeTemplateState> g_dataCodeStates;
+
+QThreadPool *dataCodeThreadPool() {
+  static QThreadPool *pool = [] {
+    QThreadPool *created = new QThreadPool();
+    created->setMaxThreadCount(qBound(1, QThread::idealThreadCount(), kDataCodeGainCount));
+    return created;
+  }();
+  return pool;
+}
+
+// 模型指纹：序列化内容的哈希。句柄值可能被新模型复用，参数修改也不改变句柄，只比较句柄会沿用旧副本
+QByteArray dataCodeFingerprint(const HTuple &serializedItem) {
+  HTuple pointer, size;
+  GetSerializedItemPtr(serializedItem, &pointer, &size);
+  return QCryptographicHash::hash(
+      QByteArray::fromRawData(reinterpret_cast<const char *>(pointer.L()), static_cast<int>(size.L())),
+      QCryptographicHash::Sha1);
+}
+
+// 取一个独占使用的句柄副本；FindDataCode2d 会把结果写入句柄，不能多线程共用同一句柄。
+// 模型指纹与缓存的副本不一致时丢弃旧副本，新副本由本次识别的序列化数据创建
+HTuple acquireDataCodeCopy(const QString &key, const QByteArray &fingerprint, const HTuple &serializedItem) {
+  {
+    QMutexLocker locker(&g_dataCodeMutex);
+    DataCodeTemplateState &state = g_dataCodeStates[key];
+    if (state.fingerprint != fingerprint) {
+      state.fingerprint = fingerprint;
+      state.freeCopies.clear();
+      state.copyCount = 0;
+    }
+    if (!state.freeCopies.isEmpty()) {
+      return state.freeCopies.takeLast();
+    }
+    ++state.copyCount;
+  }
+
+  HTuple copy;
+  DeserializeDataCode2dModel(serializedItem, &copy);
+  return copy;
+}
+
+void releaseDataCodeCopy(const QString &key, const QByteArray &fingerprint, const HTuple &copy) {
+  QMutexLocker locker(&g_dataCodeMutex);
+  DataCodeTemplateState &state = g_dataCodeStates[key];
+  if (state.fingerprint == fingerprint) {
+    state.freeCopies.append(copy);
+  }
+}
+
+// 按历史胜出次数排序，次数相同时离上次成功增益（无记录时为1.0）越近越优先
+QList<int> dataCodeGainOrder(const DataCodeTemplateState &state) {
+  int center = state.lastWinner >= 0 ? state.lastWinner : kDataCodeDefaultGain;
+  QList<int> order;
+  for (int i = 0; i < kDataCodeGainCount; ++i) {
+    order.append(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&state, center](int a, int b) {
+    if (state.wins[a] != state.wins[b]) {
+      return state.wins[a] > state.wins[b];
+    }
+    return qAbs(a - center) < qAbs(b - center);
+  });
+  if (state.lastWinner >= 0) {
+    order.removeOne(state.lastWinner);
+    order.prepend(state.lastWinner);
+  }
+  return order;
+}
+
+// 一次扫描中各分支共享的状态
+struct DataCodeSweep {
+  QMutex mutex;
+  QList<int> order;              // 候选增益序号（按优先级）
+  int next = 0;                  // 下一个待尝试的候选
+  int target = 1;                // 期望数量
+  bool done = false;             // 已达到期望数量，其余分支停止
+  QVector<HTuple> threadIds;     // 各分支的Halcon线程ID
+  QVector<bool> running;         // 各分支是否正在执行 FindDataCode2d（只在持锁时读写）
+  QList<QString> strings;        // 已识别的码内容
+  QList<QPointF> centers;        // 已识别的码中心
+  QList<int> winners;            // 贡献了新码的增益序号
+  HObject codeRegion;            // 已识别的码区域
+  int decodes = 0;
+};
+
+void mergeDataCodeResult(DataCodeSweep &sweep, int gainIndex, const HObject &symbolXlds,
+                         const HTuple &decoded) {
+  bool contributed = false;
+  for (int i = 0; i < decoded.TupleLength(); ++i) {
+    HObject xld, region;
+    HTuple area, row, column;
+    SelectObj(symbolXlds, &xld, i + 1);
+    GenRegionContourXld(xld, &region, "fill");
+    AreaCenter(region, &area, &row, &column);
+    QString text = decoded[i].C();
+    QPointF center(column.D(), row.D());
+
+    bool duplicate = false;
+    for (int k = 0; k < sweep.strings.size(); ++k) {
+      QPointF delta = sweep.centers.at(k) - center;
+      if (sweep.strings.at(k) == text &&
+          qSqrt(delta.x() * delta.x() + delta.y() * delta.y()) < kDataCodeSameCodeDistance) {
+        duplicate = true;
+        break;
+      }
+    }
+    if (duplicate) {
+      continue;
+    }
+    sweep.strings.append(text);
+    sweep.centers.append(center);
+    Union2(region, sweep.codeRegion, &sweep.codeRegion);
+    contributed = true;
+  }
+  if (contributed) {
+    sweep.winners.append(gainIndex);
+  }
+}
+
+void runDataCodeBranch(DataCodeSweep &sweep, int branch, const HObject &img, const HTuple &codeCopy) {
+  {
+    QMutexLocker locker(&sweep.mutex);
+    GetCurrentHthreadId(&sweep.threadIds[branch]);
+  }
+
+  while (true) {
+    int gainIndex = -1;
+    {
+      QMutexLocker locker(&sweep.mutex);
+      if (sweep.done || sweep.next >= sweep.order.size()) {
+        return;
+      }
+      gainIndex = sweep.order.at(sweep.next++);
+    }
+
+    HObject scaleImg, symbolXlds;
+    HTuple resultHandles, decoded;
+    try {
+      ScaleImage(img, &scaleImg, dataCodeGain(gainIndex), 0);
+    } catch (HalconCpp::HException &) {
+      continue;
+    }
+
+    // running 只覆盖 FindDataCode2d：持锁检查 done 后置位，算子返回后立即持锁清除，
+    // 取消方也持锁读取 running，因此中断不会发给正在缩放图像或已退出扫描的分支
+    {
+      QMutexLocker locker(&sweep.mutex);
+      if (sweep.done) {
+        return;
+      }
+      sweep.running[branch] = true;
+    }
+    try {
+      FindDataCode2d(scaleImg, &symbolXlds, codeCopy, "stop_after_result_num", sweep.target,
+                     &resultHandles, &decoded);
+    } catch (HalconCpp::HException &) {
+      decoded = HTuple(); // 被其他分支取消或识别失败
+    }
+
+    QMutexLocker locker(&sweep.mutex);
+    sweep.running[branch] = false;
+    if (sweep.done) {
+      return;
+    }
+    ++sweep.decodes;
+    if (decoded.TupleLength() == 0) {
+      continue;
+    }
+    try {
+      mergeDataCodeResult(sweep, gainIndex, symbolXlds, decoded);
+    } catch (HalconCpp::HException &) {
+      continue;
+    }
+
+    if (sweep.strings.size() >= sweep.target) {
+      // 已达到期望数量：取消其他分支正在执行的算子
+      sweep.done = true;
+      for (int other = 0; other < sweep.running.size(); ++other) {
+        if (other != branch && sweep.running[other]) {
+          try {
+            InterruptOperator(sweep.threadIds[other], "cancel");
+          } catch (HalconCpp::HException &) {
+          }
+        }
+      }
+      return;
+    }
+  }
+}
+}
+
 /**
  * @brief HalconLable::QtRecogied 识别二维
+ * @details 在多个增益下并行识别：按该模板历史胜出增益排序候选，各分支使用独立的句柄副本，
+ *          识别到的不同码达到 num 个时取消其余分支。所有分支都在识别线程池中运行，调用线程只等待，
+ *          取消信号不会发到调用线程上（其后还要执行 DilationRectangle1 等算子）。
  * @return 返回识别到的二维
  */
-CodeData HalconLable::QtRecogied(HObject img, HTuple codeModel, HTuple num) {
+CodeData HalconLable::QtRecogied(HObject img, HTuple codeModel, HTuple num, const QString &templateKey) {
   CodeData coderesult;
-  HObject EmptyRegion;
+  QString key = templateKey;
 
   try {
-    GenEmptyRegion(&EmptyRegion);
-    QList<QString> resultString;
-    int CodeNum = 0; // 位识别码统计
-    for (double i = 0.5; i < 3.0; i = i + 0.1) {
-      HTuple ResultHandles, DecodedDataStrings;
-      HObject RecogiedRegion, reduimg, SymbolXLDs, scaleImg, Coderegion1;
-      Complement(
-          EmptyRegion,
-          &RecogiedRegion); // 获取识别码范围外的区域，也可以是图像范围外，已经识别到的码范围外
-      ScaleImage(img, &scaleImg, i, 0); // 缩放图像，保持比例
-      ReduceDomain(scaleImg, RecogiedRegion, &reduimg);
-      FindDataCode2d(reduimg, &SymbolXLDs, codeModel, "stop_after_result_num",
-                     num, &ResultHandles, &DecodedDataStrings);
-      if (DecodedDataStrings.TupleLength() > 0) {
-        /**
-      * 以下代码 要去除识别到的码范围外的区域，防止干扰码
-      * GenRegionContourXld(SymbolXLDs,&Coderegion1,"fill");
-     Union1(Coderegion1,&Coderegion1);
-     Union2(Coderegion1,EmptyRegion,&EmptyRegion);
-     DilationRectangle1(EmptyRegion,&EmptyRegion,21,21);
-      */
-        GenRegionContourXld(SymbolXLDs, &Coderegion1, "fill");
-        Union1(Coderegion1, &Coderegion1);
-        Union2(Coderegion1, EmptyRegion, &EmptyRegion);
-        DilationRectangle1(EmptyRegion, &EmptyRegion, 21, 21);
-
-        CodeNum =
-            CodeNum +
-            DecodedDataStrings
-                .TupleLength(); // 识别到的码范围信息达到指定数量时退出循环
-
-        for (int i = 0; i < DecodedDataStrings.TupleLength(); i++) {
-          resultString.append(DecodedDataStrings[i].C());
-        }
+    if (key.isEmpty()) {
+      key = QString::number(codeModel.H().GetHandle());
+    }
 
-        if (CodeNum == num) // 识别到的码范围信息达到指定数量时退出循环
-        {
-          break;
-        }
+    DataCodeSweep sweep;
+    sweep.target = qMax(1, num.TupleLength() > 0 ? static_cast<int>(num[0].L()) : 1);
+    GenEmptyRegion(&sweep.codeRegion);
+    {
+      QMutexLocker locker(&g_dataCodeMutex);
+      sweep.order = dataCodeGainOrder(g_dataCodeStates[key]);
+    }
+
+    QThreadPool *pool = dataCodeThreadPool();
+    const int branchCount = qMin(pool->maxThreadCount(), sweep.order.size());
+    sweep.threadIds.resize(branchCount);
+    sweep.running.fill(false, branchCount);
+
+    // 序列化一次：既用于判断缓存的副本是否过期，也用于创建新副本
+    HTuple serializedItem;
+    SerializeDataCode2dModel(codeModel, &serializedItem);
+    QVector<HTuple> copies;
+    QByteArray fingerprint;
+    try {
+      fingerprint = dataCodeFingerprint(serializedItem);
+      for (int b = 0; b < branchCount; ++b) {
+        copies.append(acquireDataCodeCopy(key, fingerprint, serializedItem));
+      }
+    } catch (HalconCpp::HException &) {
+      ClearSerializedItem(serializedItem);
+      throw;
+    }
+    ClearSerializedItem(serializedItem);
+
+    QList<QFuture<void>> branches;
+    for (int b = 0; b < branchCount; ++b) {
+      HTuple copy = copies[b];
+      branches.append(QtConcurrent::run(pool, [&sweep, b, img, copy]() {
+        runDataCodeBranch(sweep, b, img, copy);
+      }));
+    }
+    for (QFuture<void> &branch : branches) {
+      branch.waitForFinished();
+    }
+    for (const HTuple &copy : copies) {
+      releaseDataCodeCopy(key, fingerprint, copy);
+    }
+
+    // 更新该模板的增益统计
+    {
+      QMutexLocker locker(&g_dataCodeMutex);
+      DataCodeTemplateState &state = g_dataCodeStates[key];
+      ++state.sweeps;
+      state.decodes += sweep.decodes;
+      for (int gainIndex : sweep.winners) {
+        ++state.wins[gainIndex];
+      }
+      if (!sweep.winners.isEmpty()) {
+        state.lastWinner = sweep.winners.last();
+      }
+      if (sweep.done) {
+        ++state.successes;
       }
     }
 
-    coderesult.codestring = resultString;
-    coderesult.codeobj = EmptyRegion;
+    // 与原实现一致：返回外扩后的码区域
+    DilationRectangle1(sweep.codeRegion, &sweep.codeRegion, 21, 21);
+    coderesult.codestring = sweep.strings;
+    coderesult.codeobj = sweep.codeRegion;
   } catch (HalconCpp::HException e) {
     coderesult.codestring.clear();
     coderesult.codeobj.Clear();
@@ -1405,6 +2142,45 @@ CodeData HalconLable::QtRecogied(HObject img, HTuple codeModel, HTuple num) {
   return coderesult;
 }
 
+/**
+ * @brief HalconLable::QtDataCodeGainOrder 获取模板当前的增益尝试顺序
+ */
+QList<double> HalconLable::QtDataCodeGainOrder(const QString &templateKey) {
+  QMutexLocker locker(&g_dataCodeMutex);
+  QList<double> gains;
+  for (int index : dataCodeGainOrder(g_dataCodeStates.value(templateKey))) {
+    gains.append(dataCodeGain(index));
+  }
+  return gains;
+}
+
+/**
+ * @brief HalconLable::QtDataCodeSweepSummary 各模板的增益扫描统计
+ */
+QString HalconLable::QtDataCodeSweepSummary() {
+  QMutexLocker locker(&g_dataCodeMutex);
+  QStringList lines;
+  for (auto it = g_dataCodeStates.constBegin(); it != g_dataCodeStates.constEnd(); ++it) {
+    const DataCodeTemplateState &state = it.value();
+    if (state.sweeps == 0) {
+      continue;
+    }
+    QStringList topGains;
+    QList<int> order = dataCodeGainOrder(state);
+    for (int i = 0; i < order.size() && topGains.size() < 3; ++i) {
+      if (state.wins[order[i]] > 0) {
+        topGains << QString("%1×%2").arg(dataCodeGain(order[i]), 0, 'f', 1).arg(state.wins[order[i]]);
+      }
+    }
+    lines << QString("%1: 扫描=%2, 成功=%3, 平均识别次数=%4, 句柄副本=%5, 常用增益=%6")
+                 .arg(it.key()).arg(state.sweeps).arg(state.successes)
+                 .arg(static_cast<double>(state.decodes) / state.sweeps, 0, 'f', 2)
+                 .arg(state.copyCount)
+                 .arg(topGains.isEmpty() ? QString("-") : topGains.join(", "));
+  }
+  return lines.isEmpty() ? QString("无二维码扫描记录") : lines.join("\n");
+}
+
 /**
  * @brief HalconLable::PointRotateByCenter 旋转一个点
  * @return 返回旋转后的点
@@ -1432,94 +2208,23 @@ pointStruct HalconLable::PointRotateByCenter(double centerX, double centerY,
 
 HObject HalconLable::QtGetLengthMaxXld(HObject Img,HObject CheckRegion,int Thr1)
 {
-  // 初始化输出对象
-  HObject select1;
-  select1.GenEmptyObj();
-  
-  qDebug() << QString("🔍 开始提取最长轮廓，阈值：%1").arg(Thr1);
-  
-  // 检查输入参数有效性
-  if (!Img.IsInitialized()) {
-    qDebug() << "❌ 错误：输入图像未初始化";
-    return select1;
-  }
-  
-  if (!CheckRegion.IsInitialized()) {
-    qDebug() << "❌ 错误：检查区域未初始化";  
-    return select1;
-  }
-  
-  // 临时变量，变量的作用域只在块中，所以就在块中申明定义就好==>好处就是可以自动回收变量内存
-  HObject reduimg1, border1;
-  HTuple Lengths, LenthMax;
-  
-  try {
-    // 限制图像域到检查区域
-    ReduceDomain(Img, CheckRegion, &reduimg1);
-    
-    // 检查缩减后的图像是否有效
-    if (!reduimg1.IsInitialized()) {
-      qDebug() << "❌ 错误：缩减图像域失败";
-      return select1;
-    }
-    
-    qDebug() << "✅ 图像域缩减成功";
-    
-    // 亚像素阈值分割
-    ThresholdSubPix(reduimg1, &border1, Thr1);
-    
-    // 检查是否找到轮廓
-    if (!border1.IsInitialized()) {
-      qDebug() << "⚠️ 警告：未找到轮廓线";
-      return select1;
-    }
-    
-    // 计算轮廓长度
-    LengthXld(border1, &Lengths);
-    
-    // 检查是否有轮廓长度数据
-    if (Lengths.TupleLength() == 0) {
-      qDebug() << "⚠️ 警告：没有检测到有效轮廓";
-      return select1;
-    }
-    
-    qDebug() << QString("📊 检测到 %1 个轮廓").arg(static_cast<int>(Lengths.TupleLength()));
-    
-    // 找到最大长度
-    TupleMax(Lengths, &LenthMax);
-    
-    qDebug() << QString("📏 最长轮廓长度：%1 像素").arg(LenthMax.TupleLength() > 0 ? LenthMax[0].D() : 0.0);
-    
-    // 选择最长的轮廓
-    if (LenthMax.TupleLength() > 0 && LenthMax[0].D() > 0) {
-      SelectShapeXld(border1, &select1, "contlength", "and", LenthMax, LenthMax);
-      
-      // 验证选择结果
-      if (select1.IsInitialized() && select1.CountObj() > 0) {
-        qDebug() << "✅ 成功选择最长轮廓";
-      } else {
-        qDebug() << "⚠️ 警告：轮廓选择失败";
-      }
-    } else {
-      qDebug() << "⚠️ 警告：轮廓长度为0";
-    }
-    
-  } catch (HalconCpp::HException& e) {
-    qDebug() << QString("❌ Halcon异常：%1").arg(QString(e.ErrorMessage()));
-    select1.Clear();
-    select1.GenEmptyObj();
-  } catch (const std::exception& e) {
-    qDebug() << QString("❌ 标准异常：%1").arg(QString::fromLocal8Bit(e.what()));
-    select1.Clear(); 
-    select1.GenEmptyObj();
-  } catch (...) {
-    qDebug() << "❌ 未知异常发生";
-    select1.Clear();
-    select1.GenEmptyObj();
-  }
+  return HalconMeasure(m_nativeKernelsEnabled).QtGetLengthMaxXld(Img, CheckRegion, Thr1);
+}
 
-  qDebug() << "🔍 轮廓提取完成";
-  return select1;
+bool HalconLable::measureEdges(HObject image, HObject measureRegion, std::vector<vk::Edge>& edges,
+                               const vk::MeasureOptions& options, std::optional<double> direction) {
+  return HalconMeasure(m_nativeKernelsEnabled).measureEdges(image, measureRegion, edges, options, direction);
+}
+
+bool HalconLable::measureEdgePairs(HObject image, HObject measureRegion, std::vector<vk::EdgePair>& pairs,
+                                   const vk::MeasureOptions& options, std::optional<double> direction) {
+  return HalconMeasure(m_nativeKernelsEnabled).measureEdgePairs(image, measureRegion, pairs, options, direction);
+}
+
+bool HalconLable::measureEdgeDistance(HObject image, HObject region1, HObject region2, double& distance,
+                                      const vk::MeasureOptions& options, std::optional<double> direction) {
+  return HalconMeasure(m_nativeKernelsEnabled).measureEdgeDistance(image, region1, region2, distance, options,
+                                                                   direction);
 }
 
 bool HalconLable::QtSaveImage(HObject mImg)
@@ -1555,34 +2260,11 @@ bool HalconLable::QtSaveImage(HObject mImg)
     if (!filePath.contains(".")) {
       filePath += ".jpg";
     }
-    try {
-      try {
-        // 从文件路径获取文件扩展名
-        QString fileExt = QFileInfo(filePath).suffix().toLower();
-
-        // 根据文件扩展名设置正确的图像类型
-        HTuple imageType;
-        if (fileExt == "jpg" || fileExt == "jpeg") {
-          imageType = "jpg";
-        } else if (fileExt == "png") {
-          imageType = "png";
-        } else if (fileExt == "bmp") {
-          imageType = "bmp";
-        } else if (fileExt == "tif" || fileExt == "tiff") {
-          imageType = "tiff";
-        } else {
-          imageType = "jpg"; // 默认使用jpg格式
-        }
-
-        HTuple fillColor(0);
-        WriteImage(mImg, imageType, fillColor, filePath.toStdString().c_str());
-        return true; // 保存成功
-      } catch (HException& exception) {
-        throw HException(exception.ErrorMessage());
-      }
-    } catch (...) {
-      qDebug() << "保存图像失败，请检查文件路径或格式是否正确。";
+    QString errorMessage;
+    if (writeImageFile(mImg, filePath, errorMessage)) {
+      return true;
     }
+    qDebug() << "保存图像失败，请检查文件路径或格式是否正确：" << errorMessage;
   }
   return false;
 }
@@ -1627,6 +2309,201 @@ bool HalconLable::QtGetLocalImage(HObject& mImg)
 
 /* ==================== 🎯 图像预处理功能实现 ==================== */
 
+namespace {
+using NativeFilter8 = std::function<bool(vk::ConstView8, vk::View8)>;
+using NativeFilter16 = std::function<bool(vk::ConstView16, vk::View16)>;
+
+// 单个图像对象且定义域为整幅图像；否则内置内核与Halcon算子的处理范围不同
+bool isSingleFullDomainImage(const HObject& image) {
+  HTuple objectCount;
+  CountObj(image, &objectCount);
+  if (objectCount.I() != 1) {
+    return false;
+  }
+  HTuple width, height, area, row, column;
+  HObject domain;
+  GetImageSize(image, &width, &height);
+  GetDomain(image, &domain);
+  AreaCenter(domain, &area, &row, &column);
+  return area.L() == width.L() * height.L();
+}
+
+// 逐通道调用 vision_kernels；对象数不为1、定义域被缩小或像素类型不支持时返回false，由调用方使用Halcon算子
+bool applyNativeFilter(const HObject& image, HObject* result, const NativeFilter8& filter8, const NativeFilter16& filter16) {
+  // Halcon滤波只写定义域内的像素，缩小的定义域保持原有行为
+  if (!isSingleFullDomainImage(image)) {
+    return false;
+  }
+
+  HTuple channels;
+  CountChannels(image, &channels);
+  HObject composed;
+  for (int c = 1; c <= channels.I(); ++c) {
+    HObject channel, output;
+    HTuple pointer, type, channelWidth, channelHeight;
+    HTuple outPointer, outType, outWidth, outHeight;
+    AccessChannel(image, &channel, c);
+    GetImagePointer1(channel, &pointer, &type, &channelWidth, &channelHeight);
+    QString typeName = QString(type.S().Text());
+    if (typeName != "byte" && typeName != "uint2") {
+      return false;
+    }
+    GenImageConst(&output, type, channelWidth, channelHeight);
+    GetImagePointer1(output, &outPointer, &outType, &outWidth, &outHeight);
+
+    bool ok = false;
+    if (typeName == "byte") {
+      vk::ConstView8 src(reinterpret_cast<const std::uint8_t*>(pointer.L()), channelWidth.I(), channelHeight.I());
+      vk::View8 dst(reinterpret_cast<std::uint8_t*>(outPointer.L()), outWidth.I(), outHeight.I());
+      ok = filter8(src, dst);
+    } else {
+      vk::ConstView16 src(reinterpret_cast<const std::uint16_t*>(pointer.L()), channelWidth.I(), channelHeight.I());
+      vk::View16 dst(reinterpret_cast<std::uint16_t*>(outPointer.L()), outWidth.I(), outHeight.I());
+      ok = filter16(src, dst);
+    }
+    if (!ok) {
+      return false;
+    }
+
+    if (c == 1) {
+      composed = output;
+    } else {
+      HObject appended;
+      AppendChannel(composed, output, &appended);
+      composed = appended;
+    }
+  }
+  *result = composed;
+  return true;
+}
+
+// gauss_filter 只接受 3~11 的奇数尺寸，按 Halcon 文档的尺寸-σ对应关系（5≈1.0，每增加2约增加0.4）取最近值
+int gaussFilterSizeForSigma(double sigma) {
+  int size = qRound((sigma * 5.0 - 1.0) / 2.0) * 2 + 1;
+  return qBound(3, size, 11);
+}
+
+// Halcon 区域行程 → vision_kernels 行程（列结束改为开区间）；多个区域先合并
+void regionToRuns(const HObject& region, vk::RunList* runs) {
+  HObject merged = region;
+  HTuple objectCount;
+  CountObj(region, &objectCount);
+  if (objectCount.I() > 1) {
+    Union1(region, &merged);
+  }
+  HTuple rows, columnBegin, columnEnd;
+  GetRegionRuns(merged, &rows, &columnBegin, &columnEnd);
+  runs->resize(static_cast<size_t>(rows.Length()));
+  for (int i = 0; i < rows.Length(); ++i) {
+    vk::Run& run = (*runs)[static_cast<size_t>(i)];
+    run.row = rows[i].I();
+    run.begin = columnBegin[i].I();
+    run.end = columnEnd[i].I() + 1;
+  }
+}
+
+// 单个通道的统计：runs 为空指针时统计整幅图像；像素类型不是 byte/uint2 时返回false（由调用方改用Halcon）
+bool nativeChannelStatistics(const HObject& image, int channel, const vk::RunList* runs, vk::ImageStatistics& stats,
+                             const vk::StatisticsOptions& options) {
+  HObject plane;
+  HTuple pointer, type, width, height;
+  AccessChannel(image, &plane, channel);
+  GetImagePointer1(plane, &pointer, &type, &width, &height);
+  QString typeName = QString(type.S().Text());
+  if (typeName == "byte") {
+    vk::ConstView8 view(reinterpret_cast<const std::uint8_t*>(pointer.L()), width.I(), height.I());
+    runs ? vk::computeStatistics(view, *runs, stats, options) : vk::computeStatistics(view, stats, options);
+    return true;
+  }
+  if (typeName == "uint2") {
+    vk::ConstView16 view(reinterpret_cast<const std::uint16_t*>(pointer.L()), width.I(), height.I());
+    runs ? vk::computeStatistics(view, *runs, stats, options) : vk::computeStatistics(view, stats, options);
+    return true;
+  }
+  return false;
+}
+
+// vision_kernels 行程 → Halcon 区域（列结束改回闭区间）
+void runsToRegion(const vk::RunList& runs, HObject* region) {
+  if (runs.empty()) {
+    GenEmptyRegion(region);
+    return;
+  }
+  std::vector<Hlong> rows(runs.size()), columnBegin(runs.size()), columnEnd(runs.size());
+  for (size_t i = 0; i < runs.size(); ++i) {
+    rows[i] = runs[i].row;
+    columnBegin[i] = runs[i].begin;
+    columnEnd[i] = runs[i].end - 1;
+  }
+  const Hlong count = static_cast<Hlong>(runs.size());
+  GenRegionRuns(region, HTuple(rows.data(), count), HTuple(columnBegin.data(), count), HTuple(columnEnd.data(), count));
+}
+
+// 三通道 byte 图像直接在RGB平面上做 RGB/HSV 区间分割，不生成中间通道图像；其他情况返回false
+bool nativeColorSegmentation(const HObject& image, bool hsv, vk::ChannelRange first, vk::ChannelRange second,
+                             vk::ChannelRange third, HObject* region) {
+  if (!isSingleFullDomainImage(image)) {
+    return false;
+  }
+  HTuple channels;
+  CountChannels(image, &channels);
+  if (channels.I() != 3) {
+    return false;
+  }
+  HTuple pointerR, pointerG, pointerB, type, width, height;
+  GetImagePointer3(image, &pointerR, &pointerG, &pointerB, &type, &width, &height);
+  if (QString(type.S().Text()) != "byte") {
+    return false;
+  }
+  vk::PlanarRgb planes;
+  planes.red = vk::ConstView8(reinterpret_cast<const std::uint8_t*>(pointerR.L()), width.I(), height.I());
+  planes.green = vk::ConstView8(reinterpret_cast<const std::uint8_t*>(pointerG.L()), width.I(), height.I());
+  planes.blue = vk::ConstView8(reinterpret_cast<const std::uint8_t*>(pointerB.L()), width.I(), height.I());
+
+  vk::RunList runs;
+  bool ok = hsv ? vk::thresholdHsv(planes, first, second, third, runs) : vk::thresholdRgb(planes, first, second, third, runs);
+  if (!ok) {
+    return false;
+  }
+  runsToRegion(runs, region);
+  return true;
+}
+
+// 单个区域的形态学运算；rectangular 时结构元素为边长 2⌊radius⌋+1 的正方形，否则为半径 radius 的圆
+void nativeMorphology(const HObject& region, const QString& operation, bool rectangular, double radius,
+                      HObject* result) {
+  vk::RunList runs;
+  regionToRuns(region, &runs);
+  const vk::Region input(std::move(runs));
+  const int side = 2 * static_cast<int>(std::floor(radius)) + 1;
+
+  vk::Region output;
+  if (operation == "closing") {
+    output = rectangular ? vk::closeRectangle(input, side, side) : vk::closeCircle(input, radius);
+  } else if (operation == "erosion") {
+    output = rectangular ? vk::erodeRectangle(input, side, side) : vk::erodeCircle(input, radius);
+  } else if (operation == "dilation") {
+    output = rectangular ? vk::dilateRectangle(input, side, side) : vk::dilateCircle(input, radius);
+  } else {
+    output = rectangular ? vk::openRectangle(input, side, side) : vk::openCircle(input, radius);
+  }
+  runsToRegion(output.runs(), result);
+}
+
+// 与 getRegionFeatures 的Halcon路径使用相同的键和定义（边界框宽高为 column2 − column1）
+QMap<QString, double> featureMap(const vk::RegionFeatures& native) {
+  QMap<QString, double> features;
+  features["面积"] = static_cast<double>(native.area);
+  features["重心X"] = native.column;
+  features["重心Y"] = native.row;
+  features["边界框宽度"] = native.column2 - native.column1;
+  features["边界框高度"] = native.row2 - native.row1;
+  features["圆形度"] = native.circularity;
+  features["矩形度"] = native.rectangularity;
+  return features;
+}
+}
+
 /**
  * @brief ch:高斯滤波 | en:Gaussian filter
  * @param image 输入图像
@@ -1651,7 +2528,14 @@ HObject HalconLable::applyGaussianFilter(HObject image, double sigma) {
       qDebug() << "⚠️ sigma值超出范围，使用默认值1.0";
     }
     
-    GaussFilter(image, &filteredImage, sigma);
+    bool native = m_nativeKernelsEnabled &&
+                  applyNativeFilter(
+                      image, &filteredImage,
+                      [sigma](vk::ConstView8 src, vk::View8 dst) { return vk::gaussianFilter(src, dst, sigma); },
+                      [sigma](vk::ConstView16 src, vk::View16 dst) { return vk::gaussianFilter(src, dst, sigma); });
+    if (!native) {
+      GaussFilter(image, &filteredImage, gaussFilterSizeForSigma(sigma));
+    }
     
     if (filteredImage.IsInitialized()) {
       qDebug() << "✅ 高斯滤波应用成功";
@@ -1697,7 +2581,18 @@ HObject HalconLable::applyMedianFilter(HObject image, QString maskType, double m
       qDebug() << "⚠️ 滤波器参数超出范围，使用默认值5.0";
     }
     
-    MedianImage(image, &filteredImage, maskType.toStdString().c_str(), static_cast<int>(maskParam), "mirrored");
+    int radius = qMax(1, static_cast<int>(maskParam));
+    bool native = false;
+    if (m_nativeKernelsEnabled && (maskType == "circle" || maskType == "square")) {
+      vk::MedianMask mask = maskType == "circle" ? vk::MedianMask::Circle : vk::MedianMask::Square;
+      native = applyNativeFilter(
+          image, &filteredImage,
+          [radius, mask](vk::ConstView8 src, vk::View8 dst) { return vk::medianFilter(src, dst, radius, mask); },
+          [radius, mask](vk::ConstView16 src, vk::View16 dst) { return vk::medianFilter(src, dst, radius, mask); });
+    }
+    if (!native) {
+      MedianImage(image, &filteredImage, maskType.toStdString().c_str(), radius, "mirrored");
+    }
     
     if (filteredImage.IsInitialized()) {
       qDebug() << "✅ 中值滤波应用成功";
@@ -1741,7 +2636,18 @@ HObject HalconLable::applyMeanFilter(HObject image, int maskWidth, int maskHeigh
     if (maskWidth <= 0 || maskWidth > 100) maskWidth = 5;
     if (maskHeight <= 0 || maskHeight > 100) maskHeight = 5;
     
-    MeanImage(image, &filteredImage, maskWidth, maskHeight);
+    bool native = m_nativeKernelsEnabled &&
+                  applyNativeFilter(
+                      image, &filteredImage,
+                      [maskWidth, maskHeight](vk::ConstView8 src, vk::View8 dst) {
+                        return vk::boxFilter(src, dst, maskWidth, maskHeight);
+                      },
+                      [maskWidth, maskHeight](vk::ConstView16 src, vk::View16 dst) {
+                        return vk::boxFilter(src, dst, maskWidth, maskHeight);
+                      });
+    if (!native) {
+      MeanImage(image, &filteredImage, maskWidth, maskHeight);
+    }
     
     if (filteredImage.IsInitialized()) {
       qDebug() << "✅ 均值滤波应用成功";
@@ -1762,6 +2668,15 @@ HObject HalconLable::applyMeanFilter(HObject image, int maskWidth, int maskHeigh
   return filteredImage;
 }
 
+void HalconLable::setNativeKernelsEnabled(bool enabled) {
+  m_nativeKernelsEnabled = enabled;
+  qDebug() << QString("🚀 内置滤波内核：%1（%2）").arg(enabled ? "开启" : "关闭").arg(vk::simdLevelName(vk::simdLevel()));
+}
+
+bool HalconLable::isNativeKernelsEnabled() const {
+  return m_nativeKernelsEnabled;
+}
+
 /**
  * @brief ch:调整图像对比度 | en:Adjust image contrast
  * @param image 输入图像
@@ -2448,31 +3363,11 @@ bool HalconLable::captureCurrentDisplay(QString filePath, QString& errorMessage)
     }
     
     // 保存当前显示的图像
-    QString fileExt = QFileInfo(filePath).suffix().toLower();
-    HTuple imageType;
-    
-    if (fileExt == "jpg" || fileExt == "jpeg") {
-      imageType = "jpg";
-    } else if (fileExt == "png") {
-      imageType = "png";
-    } else if (fileExt == "bmp") {
-      imageType = "bmp";
-    } else {
-      imageType = "jpg";
-      filePath = QFileInfo(filePath).path() + "/" + QFileInfo(filePath).baseName() + ".jpg";
-    }
-    
-    WriteImage(mShowImage, imageType, HTuple(0), filePath.toStdString().c_str());
-    
-    // 验证文件是否成功创建
-    if (QFile::exists(filePath)) {
-      errorMessage = tr("截图保存成功：%1").arg(QFileInfo(filePath).fileName());
-      qDebug() << QString("✅ %1").arg(errorMessage);
+    if (writeImageFile(mShowImage, filePath, errorMessage)) {
+      qDebug() << QString("✅ 截图：%1").arg(errorMessage);
       return true;
-    } else {
-      errorMessage = tr("截图保存失败：文件未创建");
-      return false;
     }
+    return false;
     
   } catch (HalconCpp::HException& e) {
     errorMessage = tr("截图时发生Halcon异常：%1").arg(QString(e.ErrorMessage()));
@@ -2780,6 +3675,22 @@ HObject HalconLable::mergeROIs(const QList<HObject>& regions) {
     }
     
     qDebug() << QString("🔄 合并 %1 个ROI").arg(regions.size());
+
+    // ch:行程一次排序归并，代替逐个 Union2 | en:One run merge instead of repeated Union2
+    if (m_nativeKernelsEnabled) {
+      std::vector<vk::Region> nativeRegions;
+      nativeRegions.reserve(static_cast<size_t>(regions.size()));
+      for (const HObject& region : regions) {
+        if (region.IsInitialized()) {
+          vk::RunList runs;
+          regionToRuns(region, &runs);
+          nativeRegions.emplace_back(std::move(runs));
+        }
+      }
+      runsToRegion(vk::unionRegions(nativeRegions).runs(), &mergedRegion);
+      qDebug() << "✅ ROI合并成功";
+      return mergedRegion;
+    }
     
     // 初始化第一个区域
     if (regions.first().IsInitialized()) {
@@ -2868,24 +3779,13 @@ bool HalconLable::exportAnnotatedImage(QString filePath, QString& errorMessage)
       return false;
     }
     
-    // 保存图像
-    QString fileExt = QFileInfo(filePath).suffix().toLower();
-    HTuple imageType;
-    
-    if (fileExt == "jpg" || fileExt == "jpeg") {
-      imageType = "jpg";
-    } else if (fileExt == "png") {
-      imageType = "png";
-    } else if (fileExt == "bmp") {
-      imageType = "bmp";
-    } else {
-      imageType = "jpg";
+    // 保存图像（设置了异步写入回调时只加入写入队列）
+    if (!writeImageFile(mShowImage, filePath, errorMessage)) {
+      qDebug() << QString("❌ %1").arg(errorMessage);
+      return false;
     }
     
-    WriteImage(mShowImage, imageType, HTuple(0), filePath.toStdString().c_str());
-    
-    errorMessage = "带标注的图像导出成功";
-    qDebug() << "✅ 带标注的图像导出成功";
+    qDebug() << QString("✅ 带标注的图像导出：%1").arg(errorMessage);
     return true;
     
   } catch (HalconCpp::HException& e) {
@@ -2912,21 +3812,24 @@ bool HalconLable::undoLastOperation() {
       return false;
     }
     
-    if (currentHistoryIndex <= 0) {
+    if (!m_editHistory.canUndo()) {
       qDebug() << "⚠️ 没有可撤销的操作";
       return false;
     }
     
-    currentHistoryIndex--;
-    
-    qDebug() << QString("↩️ 撤销操作，当前历史索引：%1").arg(currentHistoryIndex);
-    
-    // 恢复到备份图像（这里简化实现）
-    if (backupImage.IsInitialized()) {
-      showImage(backupImage);
+    QString label = m_editHistory.undoLabel();
+    HObject image = mShowImage;
+    bool imageChanged = false;
+    if (!m_editHistory.undo(image, &imageChanged)) {
+      qDebug() << QString("❌ 撤销「%1」失败").arg(label);
+      return false;
+    }
+    if (imageChanged) {
+      displayHistoryImage(image);
+      emit editHistoryImageChanged(mShowImage);
     }
     
-    qDebug() << "✅ 操作撤销成功";
+    qDebug() << QString("↩️ 已撤销「%1」，剩余可撤销 %2 步").arg(label).arg(m_editHistory.stats().undoCount);
     return true;
     
   } catch (...) {
@@ -2946,19 +3849,24 @@ bool HalconLable::redoOperation() {
       return false;
     }
     
-    if (currentHistoryIndex >= operationHistory.size() - 1) {
+    if (!m_editHistory.canRedo()) {
       qDebug() << "⚠️ 没有可重做的操作";
       return false;
     }
     
-    currentHistoryIndex++;
-    
-    qDebug() << QString("↪️ 重做操作，当前历史索引：%1").arg(currentHistoryIndex);
-    
-    // 这里应该根据操作历史重新执行操作
-    // 简化实现
+    QString label = m_editHistory.redoLabel();
+    HObject image = mShowImage;
+    bool imageChanged = false;
+    if (!m_editHistory.redo(image, &imageChanged)) {
+      qDebug() << QString("❌ 重做「%1」失败").arg(label);
+      return false;
+    }
+    if (imageChanged) {
+      displayHistoryImage(image);
+      emit editHistoryImageChanged(mShowImage);
+    }
     
-    qDebug() << "✅ 操作重做成功";
+    qDebug() << QString("↪️ 已重做「%1」，剩余可重做 %2 步").arg(label).arg(m_editHistory.stats().redoCount);
     return true;
     
   } catch (...) {
@@ -2967,6 +3875,13 @@ bool HalconLable::redoOperation() {
   }
 }
 
+/**
+ * @brief ch:获取撤销历史 | en:Get edit history
+ */
+ImageEditHistory& HalconLable::editHistory() {
+  return m_editHistory;
+}
+
 /* ==================== 🎨 颜色分析功能实现 ==================== */
 
 /**
@@ -2991,7 +3906,30 @@ QColor HalconLable::getRegionAverageColor(HObject region) {
     HTuple channels;
     CountChannels(mShowImage, &channels);
     
-    if (channels[0].I() == 3) {
+    // 内置内核：区域转一次行程，各通道只算均值
+    bool nativeDone = false;
+    if (m_nativeKernelsEnabled && (channels[0].I() == 3 || channels[0].I() == 1)) {
+      vk::RunList runs;
+      regionToRuns(region, &runs);
+      vk::StatisticsOptions meanOnly;
+      meanOnly.histogram = false;
+      meanOnly.sharpness = false;
+      int values[3] = {0, 0, 0};
+      nativeDone = true;
+      for (int channel = 1; channel <= channels[0].I() && nativeDone; ++channel) {
+        vk::ImageStatistics stats;
+        nativeDone = nativeChannelStatistics(mShowImage, channel, &runs, stats, meanOnly) && stats.count > 0;
+        values[channel - 1] = qBound(0, qRound(stats.mean), 255);
+      }
+      if (nativeDone) {
+        avgColor = channels[0].I() == 3 ? QColor(values[0], values[1], values[2])
+                                        : QColor(values[0], values[0], values[0]);
+      }
+    }
+    
+    if (nativeDone) {
+      // 已由内置内核得到结果
+    } else if (channels[0].I() == 3) {
       // 彩色图像
       HObject imageR, imageG, imageB;
       Decompose3(mShowImage, &imageR, &imageG, &imageB);
@@ -3053,6 +3991,14 @@ HObject HalconLable::colorThresholdSegmentation(HObject image, int minR, int max
       return segmentedRegion;
     }
     
+    // 内置内核：一次读取三个通道，直接输出行程区域
+    if (m_nativeKernelsEnabled
+        && nativeColorSegmentation(image, false, vk::ChannelRange{minR, maxR}, vk::ChannelRange{minG, maxG},
+                                   vk::ChannelRange{minB, maxB}, &segmentedRegion)) {
+      qDebug() << "✅ 颜色阈值分割完成";
+      return segmentedRegion;
+    }
+    
     HObject imageR, imageG, imageB;
     Decompose3(image, &imageR, &imageG, &imageB);
     
@@ -3101,19 +4047,43 @@ HObject HalconLable::hsvColorSegmentation(HObject image, int minH, int maxH, int
     qDebug() << QString("🌈 HSV颜色分割：H[%1-%2] S[%3-%4] V[%5-%6]")
                 .arg(minH).arg(maxH).arg(minS).arg(maxS).arg(minV).arg(maxV);
     
-    // 直接使用RGB图像进行分解，模拟HSV分割
+    HTuple channels;
+    CountChannels(image, &channels);
+    if (channels[0].I() != 3) {
+      qDebug() << "⚠️ 警告：图像不是彩色图像";
+      return segmentedRegion;
+    }
+    
+    // 内置内核：由RGB直接判断HSV区间（minH > maxH 表示跨越0的色调范围），不生成HSV图像
+    if (m_nativeKernelsEnabled
+        && nativeColorSegmentation(image, true, vk::ChannelRange{minH, maxH}, vk::ChannelRange{minS, maxS},
+                                   vk::ChannelRange{minV, maxV}, &segmentedRegion)) {
+      qDebug() << "✅ HSV颜色分割完成";
+      return segmentedRegion;
+    }
+    
     HObject imageR, imageG, imageB;
     Decompose3(image, &imageR, &imageG, &imageB);
     
-    // 使用RGB通道模拟HSV分割，这里简化处理
-    HObject regionR, regionG, regionB;
-    Threshold(imageR, &regionR, minH, maxH);  // 使用R通道模拟H
-    Threshold(imageG, &regionG, minS, maxS);  // 使用G通道模拟S
-    Threshold(imageB, &regionB, minV, maxV);  // 使用B通道模拟V
+    HObject imageH, imageS, imageV;
+    TransFromRgb(imageR, imageG, imageB, &imageH, &imageS, &imageV, "hsv");
+    
+    HObject regionH, regionS, regionV;
+    if (minH > maxH) {
+      // 色调是环形的，跨越0的范围拆成两段
+      HObject upper, lower;
+      Threshold(imageH, &upper, minH, 255);
+      Threshold(imageH, &lower, 0, maxH);
+      Union2(upper, lower, &regionH);
+    } else {
+      Threshold(imageH, &regionH, minH, maxH);
+    }
+    Threshold(imageS, &regionS, minS, maxS);
+    Threshold(imageV, &regionV, minV, maxV);
     
     // 求交集
-    Intersection(regionR, regionG, &segmentedRegion);
-    Intersection(segmentedRegion, regionB, &segmentedRegion);
+    Intersection(regionH, regionS, &segmentedRegion);
+    Intersection(segmentedRegion, regionV, &segmentedRegion);
     
     qDebug() << "✅ HSV颜色分割完成";
     
@@ -3149,18 +4119,31 @@ HObject HalconLable::autoContrastAdjustment(HObject image) {
     
     qDebug() << "🔧 执行自动对比度调整";
     
-    // 计算图像的最小值和最大值
-    HTuple min, max, range;
-    MinMaxGray(image, image, HTuple(0), &min, &max, &range);
+    // 计算图像的最小值和最大值（只需最值，不计算直方图和清晰度）
+    vk::StatisticsOptions minMaxOnly;
+    minMaxOnly.histogram = false;
+    minMaxOnly.sharpness = false;
+    vk::ImageStatistics stats;
+    if (!computeImageStatistics(image, HObject(), stats, minMaxOnly)) {
+      qDebug() << "❌ 错误：无法计算图像灰度范围";
+      return adjustedImage;
+    }
+    double minValue = stats.minValue;
+    double maxValue = stats.maxValue;
+    if (maxValue <= minValue) {
+      // 纯色图像没有可拉伸的范围，原样返回
+      qDebug() << "⚠️ 图像灰度范围为0，跳过对比度调整";
+      return image;
+    }
     
     // 计算自动拉伸参数
-    double factor = 255.0 / (max[0].D() - min[0].D());
-    double offset = -min[0].D() * factor;
+    double factor = 255.0 / (maxValue - minValue);
+    double offset = -minValue * factor;
     
     ScaleImage(image, &adjustedImage, factor, offset);
     
     qDebug() << QString("✅ 自动对比度调整完成，拉伸范围：[%1,%2] -> [0,255]")
-                .arg(min[0].D()).arg(max[0].D());
+                .arg(minValue).arg(maxValue);
     
   } catch (HalconCpp::HException& e) {
     qDebug() << QString("❌ 自动对比度调整异常：%1").arg(QString(e.ErrorMessage()));
@@ -3282,14 +4265,33 @@ HObject HalconLable::morphologyOperation(HObject region, QString operation, QStr
     }
     
     qDebug() << QString("🔧 执行形态学操作：%1，结构元素=%2，半径=%.1f").arg(operation).arg(structElement).arg(radius);
-    
-    if (operation.toLower() == "opening") {
+
+    const QString op = operation.toLower();
+    // ch:rectangle/square 使用边长 2⌊radius⌋+1 的正方形，其余为圆 | en:Square of side 2⌊radius⌋+1, otherwise a disc
+    const bool rectangular = structElement.toLower() == "rectangle" || structElement.toLower() == "square";
+    const Hlong side = 2 * static_cast<Hlong>(std::floor(radius)) + 1;
+
+    HTuple objectCount;
+    CountObj(region, &objectCount);
+    if (m_nativeKernelsEnabled && objectCount.I() == 1) {
+      nativeMorphology(region, op, rectangular, radius, &resultRegion);
+    } else if (rectangular) {
+      if (op == "closing") {
+        ClosingRectangle1(region, &resultRegion, side, side);
+      } else if (op == "erosion") {
+        ErosionRectangle1(region, &resultRegion, side, side);
+      } else if (op == "dilation") {
+        DilationRectangle1(region, &resultRegion, side, side);
+      } else {
+        OpeningRectangle1(region, &resultRegion, side, side);
+      }
+    } else if (op == "opening") {
       OpeningCircle(region, &resultRegion, radius);
-    } else if (operation.toLower() == "closing") {
+    } else if (op == "closing") {
       ClosingCircle(region, &resultRegion, radius);
-    } else if (operation.toLower() == "erosion") {
+    } else if (op == "erosion") {
       ErosionCircle(region, &resultRegion, radius);
-    } else if (operation.toLower() == "dilation") {
+    } else if (op == "dilation") {
       DilationCircle(region, &resultRegion, radius);
     } else {
       // 默认使用开运算
@@ -3314,56 +4316,100 @@ HObject HalconLable::morphologyOperation(HObject region, QString operation, QStr
 /* ==================== 📈 统计分析功能实现 ==================== */
 
 /**
- * @brief ch:获取图像统计信息 | en:Get image statistics
- * @param image 输入图像
- * @param region 分析区域（可选）
- * @return 统计信息
+ * @brief ch:单次遍历图像统计 | en:Single-pass image statistics
+ * @param image 输入图像（多通道时统计第一通道）
+ * @param region 统计区域，未初始化时使用图像定义域
+ * @param stats 统计结果，调用方可在每帧之间复用
+ * @param options 是否计算直方图和清晰度
+ * @return 是否得到有效结果
  */
-QMap<QString, double> HalconLable::getImageStatistics(HObject image, HObject region) {
-  QMap<QString, double> statistics;
-  
+bool HalconLable::computeImageStatistics(HObject image, HObject region, vk::ImageStatistics& stats,
+                                         const vk::StatisticsOptions& options) {
+  stats.reset();
+
   try {
     if (!image.IsInitialized()) {
       qDebug() << "❌ 错误：图像未初始化";
-      return statistics;
+      return false;
     }
-    
-    qDebug() << "📊 计算图像统计信息";
-    
-    HTuple mean, deviation, min, max;
-    
-    if (region.IsInitialized()) {
-      // 在指定区域内计算
-      HTuple dummyDeviation;
-      Intensity(region, image, &mean, &dummyDeviation);
-      HTuple range;
-      MinMaxGray(region, image, HTuple(0), &min, &max, &range);
-      deviation = dummyDeviation;
-    } else {
-      // 全图计算
-      HTuple dummyDeviation;
-      Intensity(image, image, &mean, &dummyDeviation);
-      HTuple range;
-      MinMaxGray(image, image, HTuple(0), &min, &max, &range);
-      deviation = dummyDeviation;
+
+    // 未指定区域时使用定义域，定义域为整幅图像时按整图统计
+    HObject statRegion = region;
+    bool fullImage = false;
+    if (!region.IsInitialized()) {
+      HTuple width, height, area, row, column;
+      GetDomain(image, &statRegion);
+      GetImageSize(image, &width, &height);
+      AreaCenter(statRegion, &area, &row, &column);
+      fullImage = area.L() == width.L() * height.L();
     }
-    
-    statistics["平均值"] = mean[0].D();
-    statistics["标准差"] = deviation[0].D();
-    statistics["最小值"] = min[0].D();
-    statistics["最大值"] = max[0].D();
-    statistics["动态范围"] = max[0].D() - min[0].D();
-    
-    qDebug() << QString("✅ 统计信息：平均值=%.2f，标准差=%.2f，范围=[%.0f,%.0f]")
-                .arg(statistics["平均值"]).arg(statistics["标准差"])
-                .arg(statistics["最小值"]).arg(statistics["最大值"]);
-    
+
+    if (m_nativeKernelsEnabled) {
+      vk::RunList runs;
+      if (!fullImage) {
+        regionToRuns(statRegion, &runs);
+      }
+      if (nativeChannelStatistics(image, 1, fullImage ? nullptr : &runs, stats, options)) {
+        return stats.count > 0;
+      }
+    }
+
+    // 其他像素类型：Halcon 计算均值/标准差/最值，不提供直方图和清晰度
+    HObject channel;
+    HTuple mean, deviation, min, max, range, area, row, column;
+    AccessChannel(image, &channel, 1);
+    Intensity(statRegion, channel, &mean, &deviation);
+    MinMaxGray(statRegion, channel, HTuple(0), &min, &max, &range);
+    AreaCenter(statRegion, &area, &row, &column);
+    stats.count = static_cast<std::uint64_t>(qMax<Hlong>(0, area[0].L()));
+    stats.mean = mean[0].D();
+    stats.deviation = deviation[0].D();
+    stats.variance = stats.deviation * stats.deviation;
+    stats.minValue = qRound(min[0].D());
+    stats.maxValue = qRound(max[0].D());
+    return stats.count > 0;
+
   } catch (HalconCpp::HException& e) {
     qDebug() << QString("❌ 计算图像统计信息异常：%1").arg(QString(e.ErrorMessage()));
   } catch (...) {
     qDebug() << "❌ 计算图像统计信息时发生未知异常";
   }
-  
+
+  stats.reset();
+  return false;
+}
+
+/**
+ * @brief ch:获取图像统计信息 | en:Get image statistics
+ * @param image 输入图像
+ * @param region 分析区域（可选）
+ * @return 统计信息
+ */
+QMap<QString, double> HalconLable::getImageStatistics(HObject image, HObject region) {
+  QMap<QString, double> statistics;
+
+  qDebug() << "📊 计算图像统计信息";
+
+  vk::ImageStatistics stats;
+  if (!computeImageStatistics(image, region, stats)) {
+    return statistics;
+  }
+
+  statistics["平均值"] = stats.mean;
+  statistics["标准差"] = stats.deviation;
+  statistics["最小值"] = stats.minValue;
+  statistics["最大值"] = stats.maxValue;
+  statistics["动态范围"] = stats.maxValue - stats.minValue;
+  if (stats.sharpnessCount > 0) {
+    statistics["中值"] = stats.median;
+    statistics["拉普拉斯方差"] = stats.laplacianVariance;
+    statistics["梯度能量"] = stats.tenengrad;
+  }
+
+  qDebug() << QString("✅ 统计信息：平均值=%1，标准差=%2，范围=[%3,%4]")
+              .arg(stats.mean, 0, 'f', 2).arg(stats.deviation, 0, 'f', 2)
+              .arg(stats.minValue).arg(stats.maxValue);
+
   return statistics;
 }
 
@@ -3382,26 +4428,35 @@ QMap<QString, double> HalconLable::getRegionFeatures(HObject region) {
     }
     
     qDebug() << "📐 计算区域几何特征";
-    
-    HTuple area, centerRow, centerCol;
-    HTuple row1, col1, row2, col2;
-    HTuple circularity, rectangularity;
-    
-    // 基本特征
-    AreaCenter(region, &area, &centerRow, &centerCol);
-    SmallestRectangle1(region, &row1, &col1, &row2, &col2);
-    
-    // 形状特征
-    Circularity(region, &circularity);
-    Rectangularity(region, &rectangularity);
-    
-    features["面积"] = area[0].D();
-    features["重心X"] = centerCol[0].D();
-    features["重心Y"] = centerRow[0].D();
-    features["边界框宽度"] = col2[0].D() - col1[0].D();
-    features["边界框高度"] = row2[0].D() - row1[0].D();
-    features["圆形度"] = circularity[0].D();
-    features["矩形度"] = rectangularity[0].D();
+
+    HTuple objectCount;
+    CountObj(region, &objectCount);
+    if (m_nativeKernelsEnabled && objectCount.I() == 1) {
+      // ch:一次行程遍历得到全部矩特征 | en:All moment features from one pass over the runs
+      vk::RunList runs;
+      regionToRuns(region, &runs);
+      features = featureMap(vk::regionFeatures(vk::Region(std::move(runs))));
+    } else {
+      HTuple area, centerRow, centerCol;
+      HTuple row1, col1, row2, col2;
+      HTuple circularity, rectangularity;
+
+      // 基本特征
+      AreaCenter(region, &area, &centerRow, &centerCol);
+      SmallestRectangle1(region, &row1, &col1, &row2, &col2);
+
+      // 形状特征
+      Circularity(region, &circularity);
+      Rectangularity(region, &rectangularity);
+
+      features["面积"] = area[0].D();
+      features["重心X"] = centerCol[0].D();
+      features["重心Y"] = centerRow[0].D();
+      features["边界框宽度"] = col2[0].D() - col1[0].D();
+      features["边界框高度"] = row2[0].D() - row1[0].D();
+      features["圆形度"] = circularity[0].D();
+      features["矩形度"] = rectangularity[0].D();
+    }
     
     // 计算长宽比
     double aspectRatio = features["边界框宽度"] / features["边界框高度"];
@@ -3419,6 +4474,75 @@ QMap<QString, double> HalconLable::getRegionFeatures(HObject region) {
   return features;
 }
 
+/**
+ * @brief ch:缺陷斑点分析 | en:Defect blob analysis
+ * @param region 输入区域（多个区域时先合并）
+ * @param minArea 最小面积，小于它的斑点被丢弃
+ * @return 每个斑点的几何特征（键与 getRegionFeatures 相同），按斑点第一个像素的行列顺序排列
+ */
+QList<QMap<QString, double>> HalconLable::getBlobFeatures(HObject region, double minArea) {
+  QList<QMap<QString, double>> blobs;
+
+  try {
+    if (!region.IsInitialized()) {
+      qDebug() << "❌ 错误：区域未初始化";
+      return blobs;
+    }
+
+    if (m_nativeKernelsEnabled) {
+      // ch:行程并查集分割连通域，各斑点的特征并行计算 | en:Union-find labelling, features computed in parallel
+      vk::RunList runs;
+      regionToRuns(region, &runs);
+      const std::vector<vk::Region> components = vk::connectedComponents(vk::Region(std::move(runs)));
+      std::vector<vk::RegionFeatures> native(components.size());
+      vk::parallelFor(0, static_cast<int>(components.size()), 64, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+          native[static_cast<size_t>(i)] = vk::regionFeatures(components[static_cast<size_t>(i)]);
+        }
+      });
+      for (const vk::RegionFeatures& blob : native) {
+        if (static_cast<double>(blob.area) >= minArea) {
+          blobs.append(featureMap(blob));
+        }
+      }
+    } else {
+      HObject merged, connected;
+      Union1(region, &merged);
+      Connection(merged, &connected);
+      HTuple area, centerRow, centerCol, row1, col1, row2, col2, circularity, rectangularity;
+      AreaCenter(connected, &area, &centerRow, &centerCol);
+      SmallestRectangle1(connected, &row1, &col1, &row2, &col2);
+      Circularity(connected, &circularity);
+      Rectangularity(connected, &rectangularity);
+      for (int i = 0; i < area.Length(); ++i) {
+        if (area[i].D() < minArea) {
+          continue;
+        }
+        QMap<QString, double> features;
+        features["面积"] = area[i].D();
+        features["重心X"] = centerCol[i].D();
+        features["重心Y"] = centerRow[i].D();
+        features["边界框宽度"] = col2[i].D() - col1[i].D();
+        features["边界框高度"] = row2[i].D() - row1[i].D();
+        features["圆形度"] = circularity[i].D();
+        features["矩形度"] = rectangularity[i].D();
+        blobs.append(features);
+      }
+    }
+
+    qDebug() << QString("✅ 斑点分析完成：%1 个斑点").arg(blobs.size());
+
+  } catch (HalconCpp::HException& e) {
+    qDebug() << QString("❌ 斑点分析异常：%1").arg(QString(e.ErrorMessage()));
+    blobs.clear();
+  } catch (...) {
+    qDebug() << "❌ 斑点分析时发生未知异常";
+    blobs.clear();
+  }
+
+  return blobs;
+}
+
 /**
  * @brief ch:计算图像质量评分 | en:Calculate image quality score
  * @param image 输入图像
@@ -3426,36 +4550,38 @@ QMap<QString, double> HalconLable::getRegionFeatures(HObject region) {
  */
 double HalconLable::calculateImageQualityScore(HObject image) {
   double qualityScore = 0.0;
-  
-  try {
-    if (!image.IsInitialized()) {
-      qDebug() << "❌ 错误：图像未初始化";
-      return qualityScore;
-    }
-    
-    qDebug() << "🎯 计算图像质量评分";
-    
-    // 获取图像统计信息
-    QMap<QString, double> stats = getImageStatistics(image);
-    
-    // 计算质量指标
-    double contrast = stats["动态范围"] / 255.0 * 100; // 对比度评分
-    double brightness = (stats["平均值"] / 255.0) * 100; // 亮度评分
-    double sharpness = stats["标准差"] / 64.0 * 100; // 清晰度评分（基于标准差）
-    
-    // 综合评分（可以根据需求调整权重）
-    qualityScore = (contrast * 0.4 + sharpness * 0.4 + brightness * 0.2);
-    qualityScore = qMax(0.0, qMin(100.0, qualityScore)); // 限制在0-100范围内
-    
-    qDebug() << QString("✅ 图像质量评分：%.1f分（对比度=%.1f，清晰度=%.1f，亮度=%.1f）")
-                .arg(qualityScore).arg(contrast).arg(sharpness).arg(brightness);
-    
-  } catch (HalconCpp::HException& e) {
-    qDebug() << QString("❌ 计算图像质量评分异常：%1").arg(QString(e.ErrorMessage()));
-  } catch (...) {
-    qDebug() << "❌ 计算图像质量评分时发生未知异常";
+
+  qDebug() << "🎯 计算图像质量评分";
+
+  vk::ImageStatistics stats;
+  if (!computeImageStatistics(image, HObject(), stats)) {
+    return qualityScore;
   }
-  
+
+  // 16位图像按满量程65535归一化
+  double fullScale = stats.histogramShift > 0 ? 65535.0 : 255.0;
+  double brightness = stats.mean / fullScale * 100; // 亮度评分
+  double contrast = 0.0;
+  double sharpness = 0.0;
+  if (stats.sharpnessCount > 0) {
+    // 对比度取1%~99%分位距离，不受少量坏点影响；清晰度取拉普拉斯响应的标准差
+    contrast = (stats.percentile99 - stats.percentile1) / fullScale * 100;
+    sharpness = std::sqrt(stats.laplacianVariance) / (fullScale / 8.0) * 100;
+  } else {
+    // Halcon 回退路径没有直方图和清晰度，沿用动态范围和灰度标准差
+    contrast = (stats.maxValue - stats.minValue) / fullScale * 100;
+    sharpness = stats.deviation / (fullScale / 4.0) * 100;
+  }
+  contrast = qBound(0.0, contrast, 100.0);
+  sharpness = qBound(0.0, sharpness, 100.0);
+
+  // 综合评分（可以根据需求调整权重）
+  qualityScore = (contrast * 0.4 + sharpness * 0.4 + brightness * 0.2);
+  qualityScore = qMax(0.0, qMin(100.0, qualityScore)); // 限制在0-100范围内
+
+  qDebug() << QString("✅ 图像质量评分：%1分（对比度=%2，清晰度=%3，亮度=%4）")
+              .arg(qualityScore, 0, 'f', 1).arg(contrast, 0, 'f', 1).arg(sharpness, 0, 'f', 1).arg(brightness, 0, 'f', 1);
+
   return qualityScore;
 }
 
@@ -4171,51 +5297,114 @@ bool HalconLable::isPixelInfoDisplayEnabled() const {
  * @brief ch:更新实时像素信息显示 | en:Update real-time pixel info display
  * @param imageX 图像坐标X
  * @param imageY 图像坐标Y
+ * 🚀 只记录坐标；同一像素不重复刷新，标签刷新节流到每个显示刷新周期最多一次
  */
 void HalconLable::updatePixelInfoDisplay(double imageX, double imageY) {
   if (!m_pixelInfoDisplayEnabled || !m_pixelInfoLabel) {
     return;
   }
-  
-  try {
-    // 获取详细像素信息
-    QString pixelInfo = getDetailedPixelInfo(imageX, imageY);
-    
-    // 避免重复更新相同信息
-    if (pixelInfo == m_lastPixelInfo) {
-      return;
-    }
-    
-    m_lastPixelInfo = pixelInfo;
-    
-    // 更新标签内容
-    m_pixelInfoLabel->setText(pixelInfo);
-    
-    // 动态调整标签大小
-    m_pixelInfoLabel->adjustSize();
-    
-    // 计算标签位置（在窗口左下角，留出一些边距）
-    int labelX = 15;
-    int labelY = this->height() - m_pixelInfoLabel->height() - 15;
-    
-    // 确保不超出窗口边界
-    if (labelX + m_pixelInfoLabel->width() > this->width()) {
-      labelX = this->width() - m_pixelInfoLabel->width() - 15;
-    }
-    if (labelY < 0) {
-      labelY = 15;
-    }
-    
-    // 设置位置并显示
-    m_pixelInfoLabel->move(labelX, labelY);
+
+  m_pendingPixel = QPoint(qFloor(imageX + 0.5), qFloor(imageY + 0.5));
+  if (m_pendingPixel == m_shownPixel && m_pixelInfoLabel->isVisible()) {
+    return;
+  }
+  if (m_pixelInfoTimer->isActive()) {
+    return; // 定时器到期时显示最新坐标
+  }
+  qint64 elapsed = m_lastPixelInfoUpdate.isValid() ? m_lastPixelInfoUpdate.elapsed() : m_redrawIntervalMs;
+  if (elapsed >= m_redrawIntervalMs) {
+    flushPixelInfoDisplay();
+  } else {
+    m_pixelInfoTimer->start(static_cast<int>(m_redrawIntervalMs - elapsed));
+  }
+}
+
+/**
+ * @brief ch:刷新像素信息标签 | en:Refresh pixel info label
+ */
+void HalconLable::flushPixelInfoDisplay() {
+  if (!m_pixelInfoDisplayEnabled || !m_pixelInfoLabel) {
+    return;
+  }
+  m_lastPixelInfoUpdate.start();
+  m_shownPixel = m_pendingPixel;
+
+  // 获取详细像素信息
+  QString pixelInfo = getDetailedPixelInfo(m_pendingPixel.x(), m_pendingPixel.y());
+
+  // 避免重复更新相同信息
+  if (pixelInfo == m_lastPixelInfo && m_pixelInfoLabel->isVisible()) {
+    return;
+  }
+  m_lastPixelInfo = pixelInfo;
+
+  // 更新标签内容并调整位置（在窗口左下角，留出一些边距）
+  m_pixelInfoLabel->setText(pixelInfo);
+  m_pixelInfoLabel->adjustSize();
+  updatePixelInfoLabelPosition();
+  if (!m_pixelInfoLabel->isVisible()) {
     m_pixelInfoLabel->show();
     m_pixelInfoLabel->raise(); // 确保在最上层
-    
-  } catch (const std::exception& e) {
-    qDebug() << "❌ 更新像素信息时发生异常：" << QString::fromLocal8Bit(e.what());
   }
 }
 
+/**
+ * @brief ch:确保像素读取缓存对应当前图像 | en:Ensure pixel access cache matches current image
+ * 🚀 图像变化后第一次悬停时获取一次通道指针，之后像素值直接从内存读取
+ */
+bool HalconLable::refreshPixelAccessCache() {
+  if (!mShowImage.IsInitialized()) {
+    m_pixelCache = PixelAccessCache();
+    return false;
+  }
+  if (m_pixelCache.image.IsInitialized() && m_pixelCache.image.Key() == mShowImage.Key()) {
+    return m_pixelCache.valid;
+  }
+
+  m_pixelCache = PixelAccessCache();
+  m_pixelCache.image = mShowImage; // 不支持的图像也记录下来，避免每次移动都重试
+  try {
+    HTuple channels, type, width, height;
+    CountChannels(mShowImage, &channels);
+    m_pixelCache.channels = channels.I();
+    if (m_pixelCache.channels == 3) {
+      HTuple pointerR, pointerG, pointerB;
+      GetImagePointer3(mShowImage, &pointerR, &pointerG, &pointerB, &type, &width, &height);
+      m_pixelCache.planes[0] = reinterpret_cast<const void*>(pointerR.L());
+      m_pixelCache.planes[1] = reinterpret_cast<const void*>(pointerG.L());
+      m_pixelCache.planes[2] = reinterpret_cast<const void*>(pointerB.L());
+    } else {
+      HTuple pointer;
+      GetImagePointer1(mShowImage, &pointer, &type, &width, &height); // 多通道图像取第一通道
+      m_pixelCache.planes[0] = reinterpret_cast<const void*>(pointer.L());
+    }
+    m_pixelCache.typeName = QString(type.S().Text());
+    m_pixelCache.pixelType = pixelTypeFromName(m_pixelCache.typeName);
+    m_pixelCache.width = width.I();
+    m_pixelCache.height = height.I();
+    m_pixelCache.valid = m_pixelCache.pixelType != PixelUnsupported;
+  } catch (HalconCpp::HException& e) {
+    qDebug() << "⚠️ 获取图像数据指针失败：" << QString(e.ErrorMessage());
+    m_pixelCache.valid = false;
+  }
+  return m_pixelCache.valid;
+}
+
+/**
+ * @brief ch:从内存读取像素值 | en:Read pixel values from memory
+ */
+int HalconLable::readPixelValues(int col, int row, double* values) const {
+  if (!m_pixelCache.valid || col < 0 || row < 0 || col >= m_pixelCache.width || row >= m_pixelCache.height) {
+    return 0;
+  }
+  qint64 offset = static_cast<qint64>(row) * m_pixelCache.width + col;
+  int count = m_pixelCache.channels == 3 ? 3 : 1;
+  for (int i = 0; i < count; ++i) {
+    values[i] = readPlaneValue(m_pixelCache.planes[i], m_pixelCache.pixelType, offset);
+  }
+  return count;
+}
+
 /**
  * @brief ch:获取详细像素信息（支持彩色图像）| en:Get detailed pixel info (support color images)
  * @param x 图像坐标X
@@ -4223,115 +5412,80 @@ void HalconLable::updatePixelInfoDisplay(double imageX, double imageY) {
  * @return 格式化的像素信息字符串
  */
 QString HalconLable::getDetailedPixelInfo(double x, double y) {
-  try {
-    if (!mShowImage.IsInitialized()) {
-      return QString("📍 位置(%.0f, %.0f)\n❌ 图像未加载").arg(x).arg(y);
-    }
-    
-    // 检查坐标是否在图像范围内
-    HTuple width, height;
-    GetImageSize(mShowImage, &width, &height);
-    
-    if (x < 0 || y < 0 || x >= width[0].D() || y >= height[0].D()) {
-      return QString("📍 位置(%.0f, %.0f)\n⚠️ 超出图像范围\n📏 图像尺寸: %1×%2")
-             .arg(x).arg(y)
-             .arg(width[0].I()).arg(height[0].I());
-    }
-    
-    // 获取图像通道数
-    HTuple channels;
-    CountChannels(mShowImage, &channels);
-    
-    QString result = QString("📍 位置(%.0f, %.0f)\n").arg(x).arg(y);
-    
-    if (channels[0].I() == 1) {
-      // 🎨 灰度图像
-      HTuple grayValue;
-      GetGrayval(mShowImage, HTuple(y), HTuple(x), &grayValue);
-      
-      if (grayValue.Length() > 0) {
-        int gray = grayValue[0].I();
-        result += QString("🔘 灰度值: %1\n").arg(gray);
-        
-        // 添加灰度等级描述
-        if (gray < 64) {
-          result += "🌑 暗色区域";
-        } else if (gray < 128) {
-          result += "🌒 中暗区域";
-        } else if (gray < 192) {
-          result += "🌓 中亮区域";
-        } else {
-          result += "🌕 明亮区域";
-        }
-      } else {
-        result += "❌ 无法获取灰度值";
-      }
-      
-    } else if (channels[0].I() == 3) {
-      // 🌈 彩色图像（RGB）
-      try {
-        HObject imageR, imageG, imageB;
-        Decompose3(mShowImage, &imageR, &imageG, &imageB);
-        
-        HTuple redValue, greenValue, blueValue;
-        GetGrayval(imageR, HTuple(y), HTuple(x), &redValue);
-        GetGrayval(imageG, HTuple(y), HTuple(x), &greenValue);
-        GetGrayval(imageB, HTuple(y), HTuple(x), &blueValue);
-        
-        if (redValue.Length() > 0 && greenValue.Length() > 0 && blueValue.Length() > 0) {
-          int r = redValue[0].I();
-          int g = greenValue[0].I();
-          int b = blueValue[0].I();
-          
-          result += QString("🔴 红色(R): %1\n").arg(r);
-          result += QString("🟢 绿色(G): %2\n").arg(g);
-          result += QString("🔵 蓝色(B): %3\n").arg(b);
-          result += QString("🎨 RGB: (%1,%2,%3)\n").arg(r).arg(g).arg(b);
-          
-          // 计算亮度
-          int brightness = static_cast<int>(0.299 * r + 0.587 * g + 0.114 * b);
-          result += QString("💡 亮度: %1").arg(brightness);
-          
-          // 添加主色调描述
-          if (r > g && r > b) {
-            result += "\n🔴 偏红色调";
-          } else if (g > r && g > b) {
-            result += "\n🟢 偏绿色调";
-          } else if (b > r && b > g) {
-            result += "\n🔵 偏蓝色调";
-          } else {
-            result += "\n⚪ 中性色调";
-          }
-        } else {
-          result += "❌ 无法获取RGB值";
-        }
-      } catch (HalconCpp::HException& e) {
-        result += QString("❌ RGB分解失败: %1").arg(QString(e.ErrorMessage()));
-      }
-      
+  int col = qFloor(x + 0.5);
+  int row = qFloor(y + 0.5);
+  QString result = QString("📍 位置(%1, %2)\n").arg(col).arg(row);
+
+  if (!mShowImage.IsInitialized()) {
+    return result + "❌ 图像未加载";
+  }
+  if (!refreshPixelAccessCache()) {
+    return result + QString("❌ 不支持的像素类型: %1").arg(m_pixelCache.typeName);
+  }
+
+  // 检查坐标是否在图像范围内
+  double values[3] = {0.0, 0.0, 0.0};
+  int count = readPixelValues(col, row, values);
+  if (count == 0) {
+    return result + QString("⚠️ 超出图像范围\n📏 图像尺寸: %1×%2")
+                        .arg(m_pixelCache.width).arg(m_pixelCache.height);
+  }
+
+  int pixelType = m_pixelCache.pixelType;
+  if (count == 3) {
+    // 🌈 彩色图像（RGB）
+    double r = values[0];
+    double g = values[1];
+    double b = values[2];
+    result += QString("🔴 红色(R): %1\n").arg(formatPixelValue(r, pixelType));
+    result += QString("🟢 绿色(G): %1\n").arg(formatPixelValue(g, pixelType));
+    result += QString("🔵 蓝色(B): %1\n").arg(formatPixelValue(b, pixelType));
+    result += QString("🎨 RGB: (%1,%2,%3)\n")
+                  .arg(formatPixelValue(r, pixelType))
+                  .arg(formatPixelValue(g, pixelType))
+                  .arg(formatPixelValue(b, pixelType));
+
+    // 计算亮度
+    result += QString("💡 亮度: %1").arg(formatPixelValue(0.299 * r + 0.587 * g + 0.114 * b, pixelType));
+
+    // 添加主色调描述
+    if (r > g && r > b) {
+      result += "\n🔴 偏红色调";
+    } else if (g > r && g > b) {
+      result += "\n🟢 偏绿色调";
+    } else if (b > r && b > g) {
+      result += "\n🔵 偏蓝色调";
     } else {
-      // 🎭 多通道图像
-      result += QString("📊 通道数: %1\n").arg(channels[0].I());
-      result += "🎭 多通道图像";
+      result += "\n⚪ 中性色调";
     }
-    
     return result;
-    
-  } catch (HalconCpp::HException& e) {
-    return QString("📍 位置(%.0f, %.0f)\n❌ 获取像素信息失败：%2")
-           .arg(x).arg(y).arg(QString(e.ErrorMessage()));
-  } catch (const std::exception& e) {
-    return QString("📍 位置(%.0f, %.0f)\n❌ 异常：%2")
-           .arg(x).arg(y).arg(QString::fromLocal8Bit(e.what()));
-  } catch (...) {
-    return QString("📍 位置(%.0f, %.0f)\n❌ 未知错误").arg(x).arg(y);
   }
+
+  // 🎨 灰度图像（多通道图像显示第一通道）
+  result += QString("🔘 灰度值: %1").arg(formatPixelValue(values[0], pixelType));
+  if (m_pixelCache.channels != 1) {
+    result += QString("\n📊 通道数: %1（显示第1通道）").arg(m_pixelCache.channels);
+  } else if (pixelType == PixelByte) {
+    // 添加灰度等级描述
+    int gray = static_cast<int>(values[0]);
+    if (gray < 64) {
+      result += "\n🌑 暗色区域";
+    } else if (gray < 128) {
+      result += "\n🌒 中暗区域";
+    } else if (gray < 192) {
+      result += "\n🌓 中亮区域";
+    } else {
+      result += "\n🌕 明亮区域";
+    }
+  }
+  return result;
 }
 
 /**
  * @brief ch:清除像素信息显示 | en:Clear pixel info display
  */
 void HalconLable::clearPixelInfoDisplay() {
+  m_pixelInfoTimer->stop();
   if (m_pixelInfoLabel) {
     m_pixelInfoLabel->hide();
     m_lastPixelInfo = "";
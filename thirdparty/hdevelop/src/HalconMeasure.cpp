@@ -0,0 +1,338 @@
+//
+// 无界面测量辅助类 | Widget-free measurement helper
+//
+
+#include "../include/HalconMeasure.h"
+#include <QDebug>
+#include <QString>
+#include <QtMath>
+
+#include <cmath>
+#include <utility>
+
+HalconMeasure::HalconMeasure(bool nativeKernelsEnabled) :
+  m_nativeKernelsEnabled(nativeKernelsEnabled)
+{
+}
+
+HObject HalconMeasure::QtGetLengthMaxXld(const HObject& Img, const HObject& CheckRegion, int Thr1) const
+{
+  // 初始化输出对象
+  HObject select1;
+  select1.GenEmptyObj();
+  
+  qDebug() << QString("🔍 开始提取最长轮廓，阈值：%1").arg(Thr1);
+  
+  // 检查输入参数有效性
+  if (!Img.IsInitialized()) {
+    qDebug() << "❌ 错误：输入图像未初始化";
+    return select1;
+  }
+  
+  if (!CheckRegion.IsInitialized()) {
+    qDebug() << "❌ 错误：检查区域未初始化";  
+    return select1;
+  }
+  
+  // 临时变量，变量的作用域只在块中，所以就在块中申明定义就好==>好处就是可以自动回收变量内存
+  HObject reduimg1, border1;
+  HTuple Lengths, LenthMax;
+  
+  try {
+    // 限制图像域到检查区域
+    ReduceDomain(Img, CheckRegion, &reduimg1);
+    
+    // 检查缩减后的图像是否有效
+    if (!reduimg1.IsInitialized()) {
+      qDebug() << "❌ 错误：缩减图像域失败";
+      return select1;
+    }
+    
+    qDebug() << "✅ 图像域缩减成功";
+    
+    // 亚像素阈值分割
+    ThresholdSubPix(reduimg1, &border1, Thr1);
+    
+    // 检查是否找到轮廓
+    if (!border1.IsInitialized()) {
+      qDebug() << "⚠️ 警告：未找到轮廓线";
+      return select1;
+    }
+    
+    // 计算轮廓长度
+    LengthXld(border1, &Lengths);
+    
+    // 检查是否有轮廓长度数据
+    if (Lengths.TupleLength() == 0) {
+      qDebug() << "⚠️ 警告：没有检测到有效轮廓";
+      return select1;
+    }
+    
+    qDebug() << QString("📊 检测到 %1 个轮廓").arg(static_cast<int>(Lengths.TupleLength()));
+    
+    // 找到最大长度
+    TupleMax(Lengths, &LenthMax);
+    
+    qDebug() << QString("📏 最长轮廓长度：%1 像素").arg(LenthMax.TupleLength() > 0 ? LenthMax[0].D() : 0.0);
+    
+    // 选择最长的轮廓
+    if (LenthMax.TupleLength() > 0 && LenthMax[0].D() > 0) {
+      SelectShapeXld(border1, &select1, "contlength", "and", LenthMax, LenthMax);
+      
+      // 验证选择结果
+      if (select1.IsInitialized() && select1.CountObj() > 0) {
+        qDebug() << "✅ 成功选择最长轮廓";
+      } else {
+        qDebug() << "⚠️ 警告：轮廓选择失败";
+      }
+    } else {
+      qDebug() << "⚠️ 警告：轮廓长度为0";
+    }
+    
+  } catch (HalconCpp::HException& e) {
+    qDebug() << QString("❌ Halcon异常：%1").arg(QString(e.ErrorMessage()));
+    select1.Clear();
+    select1.GenEmptyObj();
+  } catch (const std::exception& e) {
+    qDebug() << QString("❌ 标准异常：%1").arg(QString::fromLocal8Bit(e.what()));
+    select1.Clear(); 
+    select1.GenEmptyObj();
+  } catch (...) {
+    qDebug() << "❌ 未知异常发生";
+    select1.Clear();
+    select1.GenEmptyObj();
+  }
+
+  qDebug() << "🔍 轮廓提取完成";
+  return select1;
+}
+
+namespace {
+// 角度差归一化到 (−π, π] | Wrap an angle difference to (−π, π]
+double wrapAngle(double angle) {
+  const double twoPi = 2.0 * M_PI;
+  angle = std::fmod(angle, twoPi);
+  if (angle <= -M_PI) {
+    angle += twoPi;
+  } else if (angle > M_PI) {
+    angle -= twoPi;
+  }
+  return angle;
+}
+
+// 第一通道为 byte 时返回其视图；测量只读取像素，不受定义域限制。plane 须在使用视图期间保持有效
+bool firstChannelView8(const HObject& image, HObject* plane, vk::ConstView8* view) {
+  HTuple objectCount;
+  CountObj(image, &objectCount);
+  if (objectCount.I() != 1) {
+    return false;
+  }
+  HTuple pointer, type, width, height;
+  AccessChannel(image, plane, 1);
+  GetImagePointer1(*plane, &pointer, &type, &width, &height);
+  if (QString(type.S().Text()) != "byte") {
+    return false;
+  }
+  *view = vk::ConstView8(reinterpret_cast<const std::uint8_t*>(pointer.L()), width.I(), height.I());
+  return true;
+}
+
+const char* measureTransitionName(vk::EdgeTransition transition) {
+  switch (transition) {
+    case vk::EdgeTransition::Positive: return "positive";
+    case vk::EdgeTransition::Negative: return "negative";
+    default: return "all";
+  }
+}
+
+// Halcon 结果换算到与内置内核相同的剖面坐标（起点为中心 − ⌊length1⌋·长轴方向）
+vk::Edge measureEdgeFromHalcon(const vk::MeasureRectangle& rectangle, double row, double column, double amplitude) {
+  vk::Edge edge;
+  edge.row = row;
+  edge.column = column;
+  edge.amplitude = amplitude;
+  edge.position = (row - rectangle.row) * -std::sin(rectangle.phi) + (column - rectangle.column) * std::cos(rectangle.phi)
+                  + std::floor(rectangle.length1);
+  return edge;
+}
+
+// 打开 Halcon 测量句柄，调用 body 后关闭 | Open a Halcon measure handle around body
+template <typename Body>
+void withHalconMeasure(const HObject& image, const vk::MeasureRectangle& rectangle, Body body) {
+  HTuple width, height, handle;
+  GetImageSize(image, &width, &height);
+  GenMeasureRectangle2(rectangle.row, rectangle.column, rectangle.phi, rectangle.length1, rectangle.length2, width,
+                       height, "bilinear", &handle);
+  try {
+    body(handle);
+  } catch (...) {
+    CloseMeasure(handle);
+    throw;
+  }
+  CloseMeasure(handle);
+}
+}
+
+/**
+ * @brief ch:区域的测量矩形 | en:Measure rectangle of a region
+ * 💡 取区域的最小外接旋转矩形（与 gen_rectangle2 绘制的ROI一致）；有方向提示时在
+ *    phi、phi+π（长度不变）和 phi±π/2（交换 length1/length2）中取最接近提示的一种
+ */
+bool HalconMeasure::measureRectangle(const HObject& region, vk::MeasureRectangle* rectangle,
+                                     std::optional<double> direction) {
+  HTuple row, column, phi, length1, length2;
+  SmallestRectangle2(region, &row, &column, &phi, &length1, &length2);
+  if (row.Length() == 0) {
+    return false;
+  }
+  rectangle->row = row[0].D();
+  rectangle->column = column[0].D();
+  rectangle->phi = phi[0].D();
+  rectangle->length1 = length1[0].D();
+  rectangle->length2 = length2[0].D();
+  if (!direction) {
+    return true;
+  }
+
+  // 四种表示中与提示的角度差最小者；相差 π/2 的两种交换长短轴
+  const double turns = std::round(wrapAngle(*direction - rectangle->phi) / (0.5 * M_PI));
+  const int quarter = (static_cast<int>(turns) % 4 + 4) % 4;
+  rectangle->phi = wrapAngle(rectangle->phi + turns * 0.5 * M_PI);
+  if (quarter % 2 == 1) {
+    std::swap(rectangle->length1, rectangle->length2);
+  }
+  return true;
+}
+
+/**
+ * @brief ch:一维边缘测量 | en:1D edge measurement
+ * @param image 输入图像
+ * @param measureRegion 测量矩形区域
+ * @param edges 沿矩形长轴排序的亚像素边缘
+ * @param options 高斯σ、幅值阈值和极性
+ * @param direction 剖面方向提示（弧度），为空时使用 smallest_rectangle2 的角度
+ * @return 是否执行成功
+ */
+bool HalconMeasure::measureEdges(const HObject& image, const HObject& measureRegion, std::vector<vk::Edge>& edges,
+                                 const vk::MeasureOptions& options, std::optional<double> direction) const {
+  edges.clear();
+
+  try {
+    if (!image.IsInitialized() || !measureRegion.IsInitialized()) {
+      qDebug() << "❌ 错误：图像或测量区域未初始化";
+      return false;
+    }
+    vk::MeasureRectangle rectangle;
+    if (!measureRectangle(measureRegion, &rectangle, direction)) {
+      qDebug() << "❌ 错误：测量区域为空";
+      return false;
+    }
+
+    HObject plane;
+    vk::ConstView8 view;
+    if (m_nativeKernelsEnabled && firstChannelView8(image, &plane, &view)) {
+      return vk::measurePos(view, rectangle, options, edges);
+    }
+
+    withHalconMeasure(image, rectangle, [&](const HTuple& handle) {
+      HTuple rows, columns, amplitudes, distances;
+      MeasurePos(image, handle, options.sigma, options.threshold, measureTransitionName(options.transition), "all",
+                 &rows, &columns, &amplitudes, &distances);
+      for (int i = 0; i < rows.Length(); ++i) {
+        edges.push_back(measureEdgeFromHalcon(rectangle, rows[i].D(), columns[i].D(), amplitudes[i].D()));
+      }
+    });
+    return true;
+
+  } catch (HalconCpp::HException& e) {
+    qDebug() << QString("❌ 边缘测量异常：%1").arg(QString(e.ErrorMessage()));
+  } catch (...) {
+    qDebug() << "❌ 边缘测量时发生未知异常";
+  }
+  edges.clear();
+  return false;
+}
+
+/**
+ * @brief ch:边缘对宽度测量 | en:Edge pair width measurement
+ * @param image 输入图像
+ * @param measureRegion 测量矩形区域
+ * @param pairs 边缘对及其宽度
+ * @param options 高斯σ、幅值阈值和第一个边缘的极性
+ * @param direction 剖面方向提示（弧度），为空时使用 smallest_rectangle2 的角度
+ * @return 是否执行成功
+ */
+bool HalconMeasure::measureEdgePairs(const HObject& image, const HObject& measureRegion,
+                                     std::vector<vk::EdgePair>& pairs, const vk::MeasureOptions& options,
+                                     std::optional<double> direction) const {
+  pairs.clear();
+
+  try {
+    if (!image.IsInitialized() || !measureRegion.IsInitialized()) {
+      qDebug() << "❌ 错误：图像或测量区域未初始化";
+      return false;
+    }
+    vk::MeasureRectangle rectangle;
+    if (!measureRectangle(measureRegion, &rectangle, direction)) {
+      qDebug() << "❌ 错误：测量区域为空";
+      return false;
+    }
+
+    HObject plane;
+    vk::ConstView8 view;
+    if (m_nativeKernelsEnabled && firstChannelView8(image, &plane, &view)) {
+      return vk::measurePairs(view, rectangle, options, pairs);
+    }
+
+    withHalconMeasure(image, rectangle, [&](const HTuple& handle) {
+      HTuple rowFirst, columnFirst, amplitudeFirst, rowSecond, columnSecond, amplitudeSecond;
+      HTuple intraDistance, interDistance;
+      MeasurePairs(image, handle, options.sigma, options.threshold, measureTransitionName(options.transition), "all",
+                   &rowFirst, &columnFirst, &amplitudeFirst, &rowSecond, &columnSecond, &amplitudeSecond,
+                   &intraDistance, &interDistance);
+      for (int i = 0; i < rowFirst.Length(); ++i) {
+        vk::EdgePair pair;
+        pair.first = measureEdgeFromHalcon(rectangle, rowFirst[i].D(), columnFirst[i].D(), amplitudeFirst[i].D());
+        pair.second = measureEdgeFromHalcon(rectangle, rowSecond[i].D(), columnSecond[i].D(), amplitudeSecond[i].D());
+        pair.width = intraDistance[i].D();
+        pairs.push_back(pair);
+      }
+    });
+    return true;
+
+  } catch (HalconCpp::HException& e) {
+    qDebug() << QString("❌ 边缘对测量异常：%1").arg(QString(e.ErrorMessage()));
+  } catch (...) {
+    qDebug() << "❌ 边缘对测量时发生未知异常";
+  }
+  pairs.clear();
+  return false;
+}
+
+/**
+ * @brief ch:两个测量矩形中最强边缘之间的距离 | en:Distance between the strongest edges of two measure rectangles
+ * @param image 输入图像
+ * @param region1 第一个测量矩形
+ * @param region2 第二个测量矩形
+ * @param distance 两个边缘点之间的距离（像素）
+ * @param options 高斯σ、幅值阈值和极性
+ * @param direction 两个矩形共用的剖面方向提示（弧度）
+ * @return 两个矩形内都找到边缘时返回true
+ */
+bool HalconMeasure::measureEdgeDistance(const HObject& image, const HObject& region1, const HObject& region2,
+                                        double& distance, const vk::MeasureOptions& options,
+                                        std::optional<double> direction) const {
+  distance = 0.0;
+  std::vector<vk::Edge> edges1, edges2;
+  if (!measureEdges(image, region1, edges1, options, direction) ||
+      !measureEdges(image, region2, edges2, options, direction)) {
+    return false;
+  }
+  vk::Edge edge1, edge2;
+  if (!vk::strongestEdge(edges1, edge1) || !vk::strongestEdge(edges2, edge2)) {
+    qDebug() << "⚠️ 警告：测量矩形内没有找到边缘";
+    return false;
+  }
+  distance = std::hypot(edge2.row - edge1.row, edge2.column - edge1.column);
+  return true;
+}
@@ -0,0 +1,646 @@
+//
+// 图像编辑撤销/重做历史 | Image Edit Undo/Redo History
+//
+
+#include "../include/ImageEditHistory.h"
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryFile>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+int bytesPerPixelForType(const QString& type)
+{
+    if (type == "byte" || type == "int1" || type == "direction" || type == "cyclic") return 1;
+    if (type == "uint2" || type == "int2") return 2;
+    if (type == "int4" || type == "real") return 4;
+    if (type == "int8" || type == "complex") return 8;
+    return 0; // vector_field 等不支持按分块比较
+}
+}
+
+ImageEditHistory::ImageEditHistory(qint64 memoryBudgetBytes, int tileSize)
+    : m_memoryBudget(qMax<qint64>(0, memoryBudgetBytes)),
+      m_tileSize(qMax(16, tileSize))
+{
+}
+
+ImageEditHistory::~ImageEditHistory()
+{
+    clear();
+}
+
+void ImageEditHistory::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = qMax<qint64>(0, bytes);
+    enforceBudget();
+}
+
+void ImageEditHistory::setSpillEnabled(bool enabled, const QString& directory, qint64 spillBudgetBytes)
+{
+    m_spillEnabled = enabled;
+    m_spillDirectory = directory;
+    m_spillBudget = qMax<qint64>(0, spillBudgetBytes);
+    enforceBudget();
+}
+
+bool ImageEditHistory::setTileSize(int tileSize)
+{
+    if (!m_undo.empty() || !m_redo.empty()) {
+        return false;
+    }
+    m_tileSize = qMax(16, tileSize);
+    return true;
+}
+
+/* ==================== 记录 | Recording ==================== */
+
+bool ImageEditHistory::recordImageEdit(const QString& label, const HObject& before, const HObject& after)
+{
+    if (!before.IsInitialized() || !after.IsInitialized()) {
+        return false;
+    }
+
+    EntryPtr entry = std::make_shared<Entry>();
+    entry->label = label;
+
+    try {
+        ImageLayout beforeLayout;
+        ImageLayout afterLayout;
+        bool beforeKnown = readLayout(before, &beforeLayout);
+        bool afterKnown = readLayout(after, &afterLayout);
+
+        if (beforeKnown && afterKnown && beforeLayout == afterLayout &&
+            hasFullDomain(before, beforeLayout) && hasFullDomain(after, afterLayout)) {
+            // 🧩 逐块比较，只保存变化分块的编辑前内容
+            QVector<uchar*> beforePlanes;
+            QVector<uchar*> afterPlanes;
+            if (!channelPointers(before, beforeLayout.channels, &beforePlanes) ||
+                !channelPointers(after, afterLayout.channels, &afterPlanes)) {
+                return false;
+            }
+
+            const int bpp = beforeLayout.bytesPerPixel;
+            const int tilesX = (beforeLayout.width + m_tileSize - 1) / m_tileSize;
+            const int tilesY = (beforeLayout.height + m_tileSize - 1) / m_tileSize;
+            for (int c = 0; c < beforeLayout.channels; ++c) {
+                for (int ty = 0; ty < tilesY; ++ty) {
+                    for (int tx = 0; tx < tilesX; ++tx) {
+                        const int x0 = tx * m_tileSize;
+                        const int y0 = ty * m_tileSize;
+                        const int w = qMin(m_tileSize, beforeLayout.width - x0);
+                        const int h = qMin(m_tileSize, beforeLayout.height - y0);
+                        const int rowBytes = w * bpp;
+
+                        bool changed = false;
+                        for (int r = 0; r < h && !changed; ++r) {
+                            const qint64 offset = (static_cast<qint64>(y0 + r) * beforeLayout.width + x0) * bpp;
+                            changed = std::memcmp(beforePlanes[c] + offset, afterPlanes[c] + offset, rowBytes) != 0;
+                        }
+                        if (!changed) {
+                            continue;
+                        }
+
+                        TileRef tile;
+                        tile.channel = c;
+                        tile.tileX = tx;
+                        tile.tileY = ty;
+                        entry->tiles.append(tile);
+                        for (int r = 0; r < h; ++r) {
+                            const qint64 offset = (static_cast<qint64>(y0 + r) * beforeLayout.width + x0) * bpp;
+                            entry->payload.append(reinterpret_cast<const char*>(beforePlanes[c] + offset), rowBytes);
+                        }
+                    }
+                }
+            }
+
+            if (entry->tiles.isEmpty()) {
+                return false; // 图像内容没有变化
+            }
+            entry->kind = Entry::TileDelta;
+            entry->layout = beforeLayout;
+            entry->bytes = entry->payload.size() + entry->tiles.size() * static_cast<qint64>(sizeof(TileRef));
+        } else {
+            // 🖼️ 尺寸/类型/通道数/定义域变化：保存编辑前整幅图像的引用
+            entry->kind = Entry::Snapshot;
+            entry->image = before;
+            entry->layout = beforeLayout;
+            entry->bytes = static_cast<qint64>(beforeLayout.width) * beforeLayout.height *
+                           qMax(1, beforeLayout.channels) * qMax(1, beforeLayout.bytesPerPixel);
+        }
+    } catch (HalconCpp::HException& e) {
+        qDebug() << "❌ 记录图像编辑失败：" << QString(e.ErrorMessage());
+        return false;
+    }
+
+    discardRedo();
+    m_undo.push_back(entry);
+    m_memoryBytes += entry->bytes;
+    m_headData = pixelData(after);
+
+    qDebug() << QString("📝 记录编辑「%1」：%2，%3 KB")
+                    .arg(label)
+                    .arg(entry->kind == Entry::TileDelta ? QString("%1 个分块").arg(entry->tiles.size()) : QString("整幅图像"))
+                    .arg(entry->bytes / 1024);
+    enforceBudget();
+    return true;
+}
+
+void ImageEditHistory::recordCommand(const QString& label, std::function<void()> undo, std::function<void()> redo,
+                                     qint64 approxBytes)
+{
+    EntryPtr entry = std::make_shared<Entry>();
+    entry->kind = Entry::Command;
+    entry->label = label;
+    entry->undo = std::move(undo);
+    entry->redo = std::move(redo);
+    entry->bytes = static_cast<qint64>(sizeof(Entry)) + qMax<qint64>(0, approxBytes);
+
+    discardRedo();
+    m_undo.push_back(entry);
+    m_memoryBytes += entry->bytes;
+    enforceBudget();
+}
+
+/**
+ * 🧮 逐个对象估算：区域取 runlength_features 的字节数，XLD轮廓按每点两个 double，图像按像素数据
+ */
+qint64 ImageEditHistory::estimateObjectBytes(const HObject& object)
+{
+    if (!object.IsInitialized()) {
+        return 0;
+    }
+    qint64 bytes = 0;
+    try {
+        HTuple classes;
+        GetObjClass(object, &classes);
+        for (Hlong i = 0; i < classes.Length(); ++i) {
+            HObject single;
+            SelectObj(object, &single, i + 1);
+            const QString objectClass(classes[i].S().Text());
+            if (objectClass == "region") {
+                HTuple numRuns, kFactor, lFactor, meanLength, regionBytes;
+                RunlengthFeatures(single, &numRuns, &kFactor, &lFactor, &meanLength, &regionBytes);
+                bytes += regionBytes.L();
+            } else if (objectClass == "xld_cont") {
+                HTuple points;
+                ContourPointNumXld(single, &points);
+                bytes += points.L() * 2 * static_cast<qint64>(sizeof(double));
+            } else if (objectClass == "image") {
+                ImageLayout layout;
+                if (readLayout(single, &layout)) {
+                    bytes += imageBytes(layout);
+                }
+            }
+        }
+    } catch (HalconCpp::HException& e) {
+        qDebug() << "⚠️ 估算对象内存失败：" << QString(e.ErrorMessage());
+    }
+    return bytes;
+}
+
+/* ==================== 撤销/重做 | Undo/Redo ==================== */
+
+QString ImageEditHistory::undoLabel() const
+{
+    return m_undo.empty() ? QString() : m_undo.back()->label;
+}
+
+QString ImageEditHistory::redoLabel() const
+{
+    return m_redo.empty() ? QString() : m_redo.back()->label;
+}
+
+bool ImageEditHistory::undo(HObject& current, bool* imageChanged)
+{
+    if (imageChanged) {
+        *imageChanged = false;
+    }
+    if (m_undo.empty()) {
+        return false;
+    }
+    EntryPtr entry = m_undo.back();
+    if (entry->kind == Entry::Command) {
+        if (entry->undo) {
+            entry->undo();
+        }
+    } else if (!applyEntry(*entry, current, imageChanged)) {
+        return false;
+    }
+    m_undo.pop_back();
+    m_redo.push_back(entry);
+    enforceBudget();
+    return true;
+}
+
+bool ImageEditHistory::redo(HObject& current, bool* imageChanged)
+{
+    if (imageChanged) {
+        *imageChanged = false;
+    }
+    if (m_redo.empty()) {
+        return false;
+    }
+    EntryPtr entry = m_redo.back();
+    if (entry->kind == Entry::Command) {
+        if (entry->redo) {
+            entry->redo();
+        }
+    } else if (!applyEntry(*entry, current, imageChanged)) {
+        return false;
+    }
+    m_redo.pop_back();
+    m_undo.push_back(entry);
+    enforceBudget();
+    return true;
+}
+
+/**
+ * 撤销和重做相同：把记录中的内容与当前图像交换，记录随后保存另一侧的内容
+ */
+bool ImageEditHistory::applyEntry(Entry& entry, HObject& current, bool* imageChanged)
+{
+    if (!isHead(current)) {
+        qDebug() << "⚠️ 当前图像已不是历史记录中的图像，无法撤销/重做图像编辑";
+        return false;
+    }
+    if (entry.spilled && !loadSpilled(entry)) {
+        return false;
+    }
+
+    try {
+        if (entry.kind == Entry::TileDelta) {
+            if (!swapTiles(entry, current)) {
+                return false;
+            }
+        } else {
+            HObject other = entry.image;
+            ImageLayout currentLayout;
+            readLayout(current, &currentLayout);
+            m_memoryBytes -= entry.bytes;
+            entry.image = current;
+            entry.layout = currentLayout;
+            entry.bytes = static_cast<qint64>(currentLayout.width) * currentLayout.height *
+                          qMax(1, currentLayout.channels) * qMax(1, currentLayout.bytesPerPixel);
+            m_memoryBytes += entry.bytes;
+            current = other;
+        }
+    } catch (HalconCpp::HException& e) {
+        qDebug() << "❌ 应用编辑历史失败：" << QString(e.ErrorMessage());
+        return false;
+    }
+
+    m_headData = pixelData(current);
+    if (imageChanged) {
+        *imageChanged = true;
+    }
+    return true;
+}
+
+/**
+ * 🧩 写时复制：复制一次当前图像，再把变化分块与记录内容逐行交换
+ */
+bool ImageEditHistory::swapTiles(Entry& entry, HObject& current)
+{
+    ImageLayout layout;
+    if (!readLayout(current, &layout) || !(layout == entry.layout)) {
+        qDebug() << "⚠️ 当前图像尺寸或类型与编辑记录不一致";
+        return false;
+    }
+
+    HObject working;
+    CopyImage(current, &working);
+    QVector<uchar*> planes;
+    if (!channelPointers(working, layout.channels, &planes)) {
+        return false;
+    }
+
+    uchar* data = reinterpret_cast<uchar*>(entry.payload.data());
+    qint64 position = 0;
+    for (const TileRef& tile : entry.tiles) {
+        const int x0 = tile.tileX * m_tileSize;
+        const int y0 = tile.tileY * m_tileSize;
+        const int w = qMin(m_tileSize, layout.width - x0);
+        const int h = qMin(m_tileSize, layout.height - y0);
+        const int rowBytes = w * layout.bytesPerPixel;
+        for (int r = 0; r < h; ++r) {
+            uchar* row = planes[tile.channel] + (static_cast<qint64>(y0 + r) * layout.width + x0) * layout.bytesPerPixel;
+            std::swap_ranges(row, row + rowBytes, data + position);
+            position += rowBytes;
+        }
+    }
+
+    current = working;
+    return true;
+}
+
+bool ImageEditHistory::isHead(const HObject& image) const
+{
+    if (!m_headData) {
+        return true;
+    }
+    return pixelData(image) == m_headData;
+}
+
+void ImageEditHistory::clear()
+{
+    m_undo.clear();
+    m_redo.clear();
+    m_headData = nullptr;
+    m_memoryBytes = 0;
+    resetSpillFile();
+}
+
+QStringList ImageEditHistory::undoLabels() const
+{
+    QStringList labels;
+    for (const EntryPtr& entry : m_undo) {
+        labels << entry->label;
+    }
+    return labels;
+}
+
+ImageEditHistoryStats ImageEditHistory::stats() const
+{
+    ImageEditHistoryStats stats;
+    stats.undoCount = static_cast<int>(m_undo.size());
+    stats.redoCount = static_cast<int>(m_redo.size());
+    stats.memoryBytes = m_memoryBytes;
+    stats.memoryBudget = m_memoryBudget;
+    stats.spilledBytes = m_spilledBytes;
+    stats.spilledEntries = m_spilledEntries;
+    stats.evictedEntries = m_evictedEntries;
+    return stats;
+}
+
+/* ==================== 内存预算与转存 | Budget and spilling ==================== */
+
+/**
+ * 先按从旧到新的顺序转存仍在内存中的图像步骤（跳过不能转存的命令）；
+ * 没有任何步骤可以转存时才从最早的一步开始丢弃，每次只丢弃一步
+ */
+void ImageEditHistory::enforceBudget()
+{
+    while (m_memoryBytes > m_memoryBudget) {
+        if (spillOldest()) {
+            continue;
+        }
+        if (!m_undo.empty()) {
+            dropEntry(m_undo.front());
+            m_undo.pop_front();
+        } else if (!m_redo.empty()) {
+            dropEntry(m_redo.front()); // 最远的一步重做
+            m_redo.pop_front();
+        } else {
+            break;
+        }
+    }
+}
+
+/**
+ * 转存最早的一个可转存步骤；撤销栈在前，重做栈从最远的一步开始
+ */
+bool ImageEditHistory::spillOldest()
+{
+    for (std::deque<EntryPtr>* stack : {&m_undo, &m_redo}) {
+        for (const EntryPtr& entry : *stack) {
+            if (entry->kind != Entry::Command && !entry->spilled && entry->bytes > 0 && spill(*entry)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * 新的编辑使可重做的步骤失效
+ */
+void ImageEditHistory::discardRedo()
+{
+    for (const EntryPtr& entry : m_redo) {
+        m_memoryBytes -= entry->bytes;
+        if (entry->spilled) {
+            m_spilledBytes -= entry->spillSize;
+            m_spilledEntries--;
+        }
+    }
+    m_redo.clear();
+    if (m_spilledEntries == 0) {
+        resetSpillFile();
+    }
+}
+
+void ImageEditHistory::dropEntry(const EntryPtr& entry)
+{
+    m_memoryBytes -= entry->bytes;
+    if (entry->spilled) {
+        m_spilledBytes -= entry->spillSize;
+        m_spilledEntries--;
+    }
+    m_evictedEntries++;
+    if (m_spilledEntries == 0) {
+        resetSpillFile();
+    }
+}
+
+bool ImageEditHistory::spill(Entry& entry)
+{
+    if (!m_spillEnabled || entry.kind == Entry::Command || entry.spilled) {
+        return false;
+    }
+
+    const qint64 size = entry.kind == Entry::TileDelta ? entry.payload.size() : imageBytes(entry.layout);
+    if (size <= 0 || m_spilledBytes + size > m_spillBudget) {
+        return false;
+    }
+
+    if (!m_spillFile) {
+        QString directory = m_spillDirectory.isEmpty() ? QDir::tempPath() : m_spillDirectory;
+        QDir().mkpath(directory);
+        std::unique_ptr<QTemporaryFile> file(new QTemporaryFile(QDir(directory).filePath("imageedit_XXXXXX.spill")));
+        if (!file->open()) {
+            qDebug() << "⚠️ 无法创建撤销历史临时文件：" << file->errorString();
+            return false;
+        }
+        m_spillFile = std::move(file);
+    }
+
+    const qint64 offset = m_spillFile->size();
+    bool written = false;
+    if (m_spillFile->seek(offset)) {
+        try {
+            written = entry.kind == Entry::TileDelta ? m_spillFile->write(entry.payload) == size
+                                                     : writePlanes(m_spillFile.get(), entry.image, entry.layout);
+        } catch (HalconCpp::HException& e) {
+            qDebug() << "⚠️ 读取图像数据失败，无法转存：" << QString(e.ErrorMessage());
+        }
+    }
+    if (!written) {
+        qDebug() << "⚠️ 写入撤销历史临时文件失败：" << m_spillFile->errorString();
+        m_spillFile->resize(offset); // 去掉写了一半的数据
+        return false;
+    }
+
+    entry.spilled = true;
+    entry.spillOffset = offset;
+    entry.spillSize = size;
+    entry.payload.clear();
+    entry.image.Clear();
+    m_memoryBytes -= entry.bytes;
+    entry.bytes = 0;
+    m_spilledBytes += entry.spillSize;
+    m_spilledEntries++;
+    return true;
+}
+
+bool ImageEditHistory::loadSpilled(Entry& entry)
+{
+    if (!m_spillFile || !m_spillFile->seek(entry.spillOffset)) {
+        return false;
+    }
+    if (entry.kind == Entry::TileDelta) {
+        QByteArray data = m_spillFile->read(entry.spillSize);
+        if (data.size() != entry.spillSize) {
+            qDebug() << "⚠️ 读取撤销历史临时文件失败";
+            return false;
+        }
+        entry.payload = data;
+        entry.bytes = entry.payload.size() + entry.tiles.size() * static_cast<qint64>(sizeof(TileRef));
+    } else {
+        try {
+            if (!readPlanes(m_spillFile.get(), entry.layout, &entry.image)) {
+                qDebug() << "⚠️ 读取撤销历史临时文件失败";
+                return false;
+            }
+        } catch (HalconCpp::HException& e) {
+            qDebug() << "⚠️ 恢复转存图像失败：" << QString(e.ErrorMessage());
+            return false;
+        }
+        entry.bytes = entry.spillSize;
+    }
+
+    entry.spilled = false;
+    m_memoryBytes += entry.bytes;
+    m_spilledBytes -= entry.spillSize;
+    m_spilledEntries--;
+    if (m_spilledEntries == 0) {
+        resetSpillFile(); // 没有转存的步骤时释放磁盘空间
+    }
+    return true;
+}
+
+void ImageEditHistory::resetSpillFile()
+{
+    m_spillFile.reset();
+    m_spilledBytes = 0;
+    m_spilledEntries = 0;
+}
+
+/* ==================== 图像数据访问 | Image data access ==================== */
+
+bool ImageEditHistory::readLayout(const HObject& image, ImageLayout* layout)
+{
+    HTuple channels, type, width, height;
+    CountChannels(image, &channels);
+    GetImageType(image, &type);
+    GetImageSize(image, &width, &height);
+    layout->channels = channels.I();
+    layout->type = QString(type.S().Text());
+    layout->width = width.I();
+    layout->height = height.I();
+    layout->bytesPerPixel = bytesPerPixelForType(layout->type);
+    return layout->channels > 0 && layout->bytesPerPixel > 0;
+}
+
+bool ImageEditHistory::channelPointers(const HObject& image, int channels, QVector<uchar*>* pointers)
+{
+    pointers->clear();
+    for (int c = 0; c < channels; ++c) {
+        HObject channel;
+        HTuple pointer, type, width, height;
+        AccessChannel(image, &channel, c + 1);
+        GetImagePointer1(channel, &pointer, &type, &width, &height);
+        pointers->append(reinterpret_cast<uchar*>(pointer.L()));
+    }
+    return !pointers->isEmpty();
+}
+
+const void* ImageEditHistory::pixelData(const HObject& image)
+{
+    if (!image.IsInitialized()) {
+        return nullptr;
+    }
+    try {
+        HObject channel;
+        HTuple pointer, type, width, height;
+        AccessChannel(image, &channel, 1);
+        GetImagePointer1(channel, &pointer, &type, &width, &height);
+        return reinterpret_cast<const void*>(pointer.L());
+    } catch (HalconCpp::HException&) {
+        return nullptr;
+    }
+}
+
+bool ImageEditHistory::hasFullDomain(const HObject& image, const ImageLayout& layout)
+{
+    HObject domain;
+    HTuple area, row, column;
+    GetDomain(image, &domain);
+    AreaCenter(domain, &area, &row, &column);
+    return static_cast<qint64>(area.D()) == static_cast<qint64>(layout.width) * layout.height;
+}
+
+qint64 ImageEditHistory::imageBytes(const ImageLayout& layout)
+{
+    return static_cast<qint64>(layout.width) * layout.height * layout.bytesPerPixel * layout.channels;
+}
+
+/**
+ * 直接从通道指针写入文件，不经过 QByteArray（其大小受 int 限制，超过 2 GB 的图像会溢出）
+ */
+bool ImageEditHistory::writePlanes(QIODevice* device, const HObject& image, const ImageLayout& layout)
+{
+    QVector<uchar*> planes;
+    if (!channelPointers(image, layout.channels, &planes)) {
+        return false;
+    }
+    const qint64 planeBytes = static_cast<qint64>(layout.width) * layout.height * layout.bytesPerPixel;
+    for (uchar* plane : planes) {
+        if (device->write(reinterpret_cast<const char*>(plane), planeBytes) != planeBytes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 按布局生成空图像后直接读入像素缓冲区
+ */
+bool ImageEditHistory::readPlanes(QIODevice* device, const ImageLayout& layout, HObject* image)
+{
+    if (layout.channels <= 0) {
+        return false;
+    }
+    const qint64 planeBytes = static_cast<qint64>(layout.width) * layout.height * layout.bytesPerPixel;
+    HObject channels;
+    GenEmptyObj(&channels);
+    for (int c = 0; c < layout.channels; ++c) {
+        HObject channel;
+        HTuple pointer, type, width, height;
+        GenImageConst(&channel, layout.type.toStdString().c_str(), layout.width, layout.height);
+        GetImagePointer1(channel, &pointer, &type, &width, &height);
+        if (device->read(reinterpret_cast<char*>(pointer.L()), planeBytes) != planeBytes) {
+            return false;
+        }
+        ConcatObj(channels, channel, &channels);
+    }
+    if (layout.channels == 1) {
+        *image = channels;
+    } else {
+        ChannelsToImage(channels, image);
+    }
+    return true;
+}
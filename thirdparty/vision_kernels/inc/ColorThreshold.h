@@ -0,0 +1,46 @@
+#ifndef VK_COLORTHRESHOLD_H
+#define VK_COLORTHRESHOLD_H
+
+#include "ImageView.h"
+#include "Region.h"
+
+namespace vk {
+
+/**
+ * @brief 单通道闭区间 [min, max] | Closed per-channel interval [min, max]
+ */
+struct ChannelRange {
+    int min = 0;
+    int max = 255;
+};
+
+/**
+ * @brief RGB 盒阈值分割，直接输出行程 | RGB box threshold emitted directly as runs
+ *
+ * 🎯 每个像素只读一次，三个通道的区间判断在SIMD字节通道内完成，结果先写成每行的位掩码，
+ * 再转换为行程；不生成任何中间通道图像或单通道区域。大图按行块并行。
+ * Every pixel is read once and the three interval tests run in SIMD byte lanes; each row becomes a bit mask
+ * that is converted to runs, so no intermediate channel images or per-channel regions are created.
+ *
+ * @param runs 输出，按行、列有序 | Output, sorted by row then column
+ * @return 输入无效时返回false | False on invalid input
+ */
+bool thresholdRgb(const PlanarRgb& image, ChannelRange red, ChannelRange green, ChannelRange blue, RunList& runs);
+bool thresholdRgb(const PackedRgb& image, ChannelRange red, ChannelRange green, ChannelRange blue, RunList& runs);
+
+/**
+ * @brief HSV 盒阈值分割（由RGB直接判断，不生成HSV图像）| HSV box threshold evaluated straight from RGB
+ *
+ * 🎯 H/S/V 与 Halcon trans_from_rgb "hsv" 的 byte 结果同一量程：V = max，S = 255·(max−min)/max，
+ * H 把 0~360° 映射到 0~255，按四舍五入后的整数值比较。判断用整数交叉相乘完成，不做除法，
+ * 因此各指令集结果完全一致。hue.min > hue.max 表示跨越0的环形区间（如红色 [240, 15]）。
+ * Same byte scale as trans_from_rgb "hsv"; the rounded H/S values are compared with exact integer
+ * cross-multiplication, no division, so all instruction sets give identical results.
+ * hue.min > hue.max selects a range that wraps through 0 (e.g. red).
+ */
+bool thresholdHsv(const PlanarRgb& image, ChannelRange hue, ChannelRange saturation, ChannelRange value, RunList& runs);
+bool thresholdHsv(const PackedRgb& image, ChannelRange hue, ChannelRange saturation, ChannelRange value, RunList& runs);
+
+} // namespace vk
+
+#endif // VK_COLORTHRESHOLD_H
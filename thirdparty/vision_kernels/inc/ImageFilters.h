@@ -0,0 +1,59 @@
+#ifndef VK_IMAGEFILTERS_H
+#define VK_IMAGEFILTERS_H
+
+#include "ImageView.h"
+
+namespace vk {
+
+/**
+ * @brief 中值滤波掩膜形状 | Median mask shape
+ */
+enum class MedianMask {
+    Square,   // (2r+1)x(2r+1) 方形 | Square
+    Circle    // 半径r的圆形（与 Halcon "circle" 相同的用法）| Disc of radius r
+};
+
+/**
+ * @brief 高斯滤波（可分离，镜像边界）| Separable Gaussian filter with mirrored borders
+ *
+ * 🎯 核半径为 ceil(3σ)；先水平后垂直，中间结果为 float，按行分块并行，行内按 SIMD 宽度处理。
+ * Kernel radius is ceil(3σ); horizontal then vertical pass in float, rows split across threads,
+ * SIMD across each row.
+ *
+ * @param src 输入图像 | Source
+ * @param dst 输出图像，尺寸与输入相同，不能与输入重叠 | Destination, same size, must not overlap src
+ * @param sigma 标准差(>0) | Standard deviation (>0)
+ * @return 参数无效时返回false | False on invalid arguments
+ */
+bool gaussianFilter(ConstView8 src, View8 dst, double sigma);
+bool gaussianFilter(ConstView16 src, View16 dst, double sigma);
+
+/**
+ * @brief 均值滤波（滑动和，耗时与掩膜大小无关）| Box filter with running sums (cost independent of mask size)
+ *
+ * 🎯 每列维护垂直滑动和（SIMD 整数加减），每行再做水平滑动和；镜像边界，与 Halcon mean_image 一致。
+ * Column running sums are updated with SIMD integer add/sub, then a horizontal running sum per row.
+ *
+ * @param maskWidth 掩膜宽度(>=1) | Mask width
+ * @param maskHeight 掩膜高度(>=1) | Mask height
+ */
+bool boxFilter(ConstView8 src, View8 dst, int maskWidth, int maskHeight);
+bool boxFilter(ConstView16 src, View16 dst, int maskWidth, int maskHeight);
+
+/**
+ * @brief 中值滤波，镜像边界 | Median filter with mirrored borders
+ *
+ * 🎯 8位方形掩膜使用常数时间直方图算法（Perreault–Hébert：每列直方图 + 两级核直方图，
+ * 每像素的直方图加减用16路SIMD完成，耗时与半径无关）。
+ * 圆形掩膜和16位图像使用滑动直方图（Huang），每像素 O(r)。
+ * 8-bit square masks use the constant-time histogram median (per-column histograms plus a two-level
+ * kernel histogram, SIMD add/sub of 16 bins); circles and 16-bit images use a sliding (Huang) histogram, O(r).
+ *
+ * @param radius 半径(>=1)，方形边长为 2r+1 | Radius; the square side is 2r+1
+ */
+bool medianFilter(ConstView8 src, View8 dst, int radius, MedianMask mask = MedianMask::Square);
+bool medianFilter(ConstView16 src, View16 dst, int radius, MedianMask mask = MedianMask::Square);
+
+} // namespace vk
+
+#endif // VK_IMAGEFILTERS_H
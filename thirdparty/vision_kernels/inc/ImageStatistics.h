@@ -0,0 +1,78 @@
+#ifndef VK_IMAGESTATISTICS_H
+#define VK_IMAGESTATISTICS_H
+
+#include "ImageView.h"
+#include "Region.h"
+
+#include <array>
+#include <cstdint>
+
+namespace vk {
+
+/**
+ * @brief 统计选项 | Statistics options
+ */
+struct StatisticsOptions {
+    bool histogram = true;   // 直方图与百分位数 | Histogram and percentiles
+    bool sharpness = true;   // 拉普拉斯方差与 Tenengrad | Laplacian variance and Tenengrad
+};
+
+/**
+ * @brief 图像统计结果（定长，可在每帧之间复用）| Image statistics (fixed size, reusable across frames)
+ *
+ * 🎯 直方图固定256桶：8位图像每个灰度一个桶，16位图像每个桶覆盖256个灰度（histogramShift = 8），
+ * 此时百分位数为桶的下界。清晰度只统计 3x3 邻域完全位于图像内的像素。
+ * The histogram always has 256 bins: one per grey value for 8-bit, 256 grey values per bin for 16-bit
+ * (histogramShift = 8), in which case percentiles are bin lower bounds. Sharpness only uses pixels whose
+ * 3x3 neighbourhood lies inside the image.
+ */
+struct ImageStatistics {
+    std::uint64_t count = 0;           // 像素数 | Pixel count
+    double mean = 0.0;                 // 平均值 | Mean
+    double variance = 0.0;             // 方差 | Variance
+    double deviation = 0.0;            // 标准差 | Standard deviation
+    int minValue = 0;                  // 最小值 | Minimum
+    int maxValue = 0;                  // 最大值 | Maximum
+
+    int histogramShift = 0;            // 灰度值到桶的右移位数 | Right shift from grey value to bin
+    std::array<std::uint32_t, 256> histogram{};
+    int percentile1 = 0;               // 1% 分位 | 1st percentile
+    int percentile5 = 0;               // 5% 分位 | 5th percentile
+    int median = 0;                    // 中位数 | Median
+    int percentile95 = 0;              // 95% 分位 | 95th percentile
+    int percentile99 = 0;              // 99% 分位 | 99th percentile
+
+    std::uint64_t sharpnessCount = 0;  // 参与清晰度统计的像素数 | Pixels used for sharpness
+    double laplacianVariance = 0.0;    // 4邻域拉普拉斯响应的方差 | Variance of the 4-neighbour Laplacian
+    double tenengrad = 0.0;            // Sobel 梯度平方和的均值 | Mean of squared Sobel gradient magnitude
+
+    void reset();
+};
+
+/**
+ * @brief 单次遍历计算统计量 | Compute statistics in a single pass
+ *
+ * 🎯 每行只读一次：SIMD 累加和、平方和、最小/最大值，同一行在缓存中时更新直方图和清晰度；
+ * 大图按行块并行，各块结果最后合并。整幅图像版本统计所有像素，行程版本只统计区域内像素
+ * （超出图像的部分被裁掉）。
+ * Each row is read once: SIMD sum, sum of squares and min/max, with the histogram and sharpness updated while
+ * the row is cached. Large inputs are split into row bands in parallel and merged at the end.
+ *
+ * @return 输入无效或没有像素时返回false | False for invalid input or no pixels
+ */
+bool computeStatistics(ConstView8 image, ImageStatistics& stats, const StatisticsOptions& options = StatisticsOptions());
+bool computeStatistics(ConstView16 image, ImageStatistics& stats, const StatisticsOptions& options = StatisticsOptions());
+bool computeStatistics(ConstView8 image, const RunList& runs, ImageStatistics& stats,
+                       const StatisticsOptions& options = StatisticsOptions());
+bool computeStatistics(ConstView16 image, const RunList& runs, ImageStatistics& stats,
+                       const StatisticsOptions& options = StatisticsOptions());
+
+/**
+ * @brief 由直方图求任意百分位（最近秩）| Any percentile from the histogram (nearest rank)
+ * @param percent 0~100
+ */
+int histogramPercentile(const ImageStatistics& stats, double percent);
+
+} // namespace vk
+
+#endif // VK_IMAGESTATISTICS_H
@@ -0,0 +1,147 @@
+#ifndef VK_IMAGEVIEW_H
+#define VK_IMAGEVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace vk {
+
+/**
+ * @brief 图像视图（不持有内存）| Non-owning image view
+ *
+ * 🎯 指向外部缓冲区（Halcon GetImagePointer1、相机缓冲、std::vector 等）的单通道图像，
+ * 行跨度以元素为单位，允许行尾填充。
+ * Single-channel view over an external buffer; the stride is in elements and may include row padding.
+ */
+template <typename T>
+struct ImageView {
+    T* data = nullptr;            // 首行首像素 | First pixel of the first row
+    int width = 0;                // 宽度 | Width in pixels
+    int height = 0;               // 高度 | Height in rows
+    std::ptrdiff_t stride = 0;    // 行跨度（元素数）| Row stride in elements
+
+    ImageView() = default;
+    ImageView(T* data_, int width_, int height_, std::ptrdiff_t stride_ = 0)
+        : data(data_), width(width_), height(height_), stride(stride_ > 0 ? stride_ : width_) {}
+
+    // 允许 ImageView<T> → ImageView<const T> | Allow conversion to a const view
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    ImageView(const ImageView<U>& other)
+        : data(other.data), width(other.width), height(other.height), stride(other.stride) {}
+
+    bool isValid() const { return data != nullptr && width > 0 && height > 0 && stride >= width; }
+    T* row(int y) const { return data + static_cast<std::ptrdiff_t>(y) * stride; }
+    T& at(int x, int y) const { return row(y)[x]; }
+};
+
+using ConstView8 = ImageView<const std::uint8_t>;
+using View8 = ImageView<std::uint8_t>;
+using ConstView16 = ImageView<const std::uint16_t>;
+using View16 = ImageView<std::uint16_t>;
+
+/**
+ * @brief 平面RGB视图（如 Halcon 三通道图像，每通道一个缓冲区）| Planar RGB view, one buffer per channel
+ */
+struct PlanarRgb {
+    ConstView8 red;
+    ConstView8 green;
+    ConstView8 blue;
+
+    bool isValid() const
+    {
+        return red.isValid() && green.isValid() && blue.isValid() && green.width == red.width
+            && blue.width == red.width && green.height == red.height && blue.height == red.height;
+    }
+    int width() const { return red.width; }
+    int height() const { return red.height; }
+};
+
+/**
+ * @brief 交错像素的通道顺序 | Channel order of packed pixels
+ */
+enum class PixelOrder {
+    RGB,   // R,G,B[,A]
+    BGR    // B,G,R[,A]（OpenCV、小端 QImage::Format_RGB32）| OpenCV, little-endian QImage::Format_RGB32
+};
+
+/**
+ * @brief 交错RGB/RGBA视图（相机缓冲、QImage）| Packed RGB/RGBA view (camera buffers, QImage)
+ *
+ * 🎯 每像素 channels 个字节（3或4，第4字节忽略），行跨度以字节为单位。
+ * channels bytes per pixel (3 or 4, the fourth byte is ignored); the stride is in bytes.
+ */
+struct PackedRgb {
+    const std::uint8_t* data = nullptr;
+    int width = 0;
+    int height = 0;
+    std::ptrdiff_t stride = 0;
+    int channels = 3;
+    PixelOrder order = PixelOrder::RGB;
+
+    PackedRgb() = default;
+    PackedRgb(const std::uint8_t* data_, int width_, int height_, std::ptrdiff_t stride_ = 0, int channels_ = 3,
+              PixelOrder order_ = PixelOrder::RGB)
+        : data(data_), width(width_), height(height_),
+          stride(stride_ > 0 ? stride_ : static_cast<std::ptrdiff_t>(width_) * channels_), channels(channels_),
+          order(order_) {}
+
+    bool isValid() const
+    {
+        return data != nullptr && width > 0 && height > 0 && (channels == 3 || channels == 4)
+            && stride >= static_cast<std::ptrdiff_t>(width) * channels;
+    }
+    const std::uint8_t* row(int y) const { return data + static_cast<std::ptrdiff_t>(y) * stride; }
+};
+
+/**
+ * @brief 持有内存的单通道图像 | Owning single-channel image
+ */
+template <typename T>
+class Image {
+public:
+    Image() = default;
+    Image(int width, int height) { resize(width, height); }
+
+    void resize(int width, int height)
+    {
+        m_width = width > 0 ? width : 0;
+        m_height = height > 0 ? height : 0;
+        m_pixels.assign(static_cast<std::size_t>(m_width) * m_height, T());
+    }
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    T* data() { return m_pixels.data(); }
+    const T* data() const { return m_pixels.data(); }
+
+    ImageView<T> view() { return ImageView<T>(m_pixels.data(), m_width, m_height, m_width); }
+    ImageView<const T> view() const { return ImageView<const T>(m_pixels.data(), m_width, m_height, m_width); }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<T> m_pixels;
+};
+
+/**
+ * @brief 边界外坐标按镜像映射到 [0, n)（边缘像素重复一次：-1→0, n→n-1）
+ * Mirror an out-of-range coordinate into [0, n) (edge pixel repeated: -1→0, n→n-1)
+ */
+inline int mirrorIndex(int i, int n)
+{
+    if (n <= 1) {
+        return 0;
+    }
+    const int period = 2 * n;
+    i %= period;
+    if (i < 0) {
+        i += period;
+    }
+    return i < n ? i : period - 1 - i;
+}
+
+} // namespace vk
+
+#endif // VK_IMAGEVIEW_H
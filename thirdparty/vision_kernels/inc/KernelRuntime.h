@@ -0,0 +1,55 @@
+#ifndef VK_KERNELRUNTIME_H
+#define VK_KERNELRUNTIME_H
+
+#include <functional>
+
+namespace vk {
+
+/**
+ * @brief 指令集级别 | SIMD instruction level
+ */
+enum class SimdLevel {
+    Scalar = 0,   // 纯C++实现 | Portable C++
+    SSE2,         // x86-64 基线 | x86-64 baseline
+    AVX2,         // x86-64 AVX2（运行时检测）| x86-64 AVX2 (detected at runtime)
+    NEON          // ARMv8 基线 | ARMv8 baseline
+};
+
+/**
+ * @brief 当前CPU支持的最高级别 | Highest level supported by this CPU and build
+ */
+SimdLevel detectedSimdLevel();
+
+/**
+ * @brief 当前使用的级别（默认等于检测结果）| Level in use (defaults to the detected level)
+ */
+SimdLevel simdLevel();
+
+/**
+ * @brief 限制使用的级别，用于对比测试和排查；高于检测结果时按检测结果 | Cap the level, e.g. for A/B comparison
+ */
+void setSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief 设置并行线程数（含调用线程），0表示按CPU核数 | Thread count including the caller, 0 = core count
+ */
+void setThreadCount(int threads);
+int threadCount();
+
+/**
+ * @brief 按行分块并行执行 | Run a row range in parallel chunks
+ *
+ * 🎯 [begin, end) 被切成不小于 minChunk 的块，由调用线程和内部线程池共同处理，返回时全部完成。
+ * 调用线程也参与处理，因此在线程池线程中嵌套调用不会死锁。
+ * The range is split into chunks of at least minChunk rows and processed by the caller together with the
+ * internal pool; returns when every chunk is done. Safe to nest because the caller always participates.
+ *
+ * @param body 处理 [chunkBegin, chunkEnd) | Processes [chunkBegin, chunkEnd)
+ */
+void parallelFor(int begin, int end, int minChunk, const std::function<void(int, int)>& body);
+
+} // namespace vk
+
+#endif // VK_KERNELRUNTIME_H
@@ -0,0 +1,109 @@
+#ifndef VK_MEASURE1D_H
+#define VK_MEASURE1D_H
+
+#include "ImageView.h"
+
+#include <vector>
+
+namespace vk {
+
+/**
+ * @brief 旋转矩形测量区域（与 gen_measure_rectangle2 参数相同）| Rotated measure rectangle, as gen_measure_rectangle2
+ *
+ * 🎯 phi 为 length1 轴相对列方向的逆时针角度（弧度）。剖面沿该轴从 −length1 走到 +length1，
+ * 即方向 (row, column) = (−sin phi, cos phi)；length2 方向上的 2⌊length2⌋+1 条平行线取平均。
+ * phi is the counter-clockwise angle of the length1 axis from the column axis, in radians. The profile runs
+ * along that axis from −length1 to +length1, direction (row, column) = (−sin phi, cos phi); 2⌊length2⌋+1
+ * parallel lines across length2 are averaged.
+ */
+struct MeasureRectangle {
+    double row = 0.0;
+    double column = 0.0;
+    double phi = 0.0;
+    double length1 = 0.0;   // 剖面方向半长 | Half length along the profile
+    double length2 = 0.0;   // 平均方向半宽 | Half width that is averaged
+};
+
+/**
+ * @brief 边缘极性（沿剖面方向）| Edge polarity along the profile
+ */
+enum class EdgeTransition {
+    All,        // 全部 | Both polarities
+    Positive,   // 由暗到亮 | Dark to light
+    Negative    // 由亮到暗 | Light to dark
+};
+
+/**
+ * @brief 一维测量参数 | 1D measure parameters
+ */
+struct MeasureOptions {
+    double sigma = 1.0;                                // 高斯平滑σ(>=0.4) | Gaussian sigma
+    double threshold = 30.0;                           // 最小边缘幅值 | Minimum edge amplitude
+    EdgeTransition transition = EdgeTransition::All;
+};
+
+/**
+ * @brief 亚像素边缘 | Subpixel edge
+ */
+struct Edge {
+    double row = 0.0;         // 边缘点（位于剖面中心线上）| Edge point on the profile centre line
+    double column = 0.0;
+    double amplitude = 0.0;   // 带符号的一阶导数，正值为由暗到亮 | Signed first derivative
+    double position = 0.0;    // 距剖面起点的距离 | Distance from the start of the profile
+};
+
+/**
+ * @brief 边缘对 | Edge pair
+ */
+struct EdgePair {
+    Edge first;
+    Edge second;
+    double width = 0.0;       // 两边缘之间的距离 | Distance between the two edges
+};
+
+/**
+ * @brief 生成平均灰度剖面 | Build the averaged grey-value profile
+ *
+ * 🎯 剖面共 2⌊length1⌋+1 个采样点，间距1像素。每条平行采样线上的点坐标按等差递增，
+ * SIMD 一次计算多个采样点的坐标、双线性权重并插值；超出图像的坐标钳位到边界像素。
+ * The profile has 2⌊length1⌋+1 samples one pixel apart. Along each parallel sampling line the coordinates
+ * advance by a constant step, so SIMD computes coordinates, bilinear weights and interpolation for several
+ * samples at once; coordinates outside the image are clamped to the border.
+ *
+ * @return 图像无效（宽或高小于2）时返回false | False for an invalid image (width or height below 2)
+ */
+bool measureProfile(ConstView8 image, const MeasureRectangle& rectangle, std::vector<float>& profile);
+
+/**
+ * @brief 垂直于剖面的直线边缘（measure_pos）| Straight edges perpendicular to the profile, like measure_pos
+ *
+ * 🎯 剖面与高斯一阶导数核卷积，|导数| 的局部极大且不小于阈值处为边缘，用相邻三点抛物线拟合得到亚像素位置。
+ * 只处理一维剖面，工作量与 length1·length2 成正比，不提取任何二维轮廓。
+ * The profile is convolved with a derivative-of-Gaussian kernel; local maxima of |derivative| at or above the
+ * threshold are edges, refined to subpixel by a three-point parabola. Work is proportional to
+ * length1·length2; no 2D contours are extracted.
+ *
+ * @param edges 输出，按剖面方向排序 | Output, ordered along the profile
+ */
+bool measurePos(ConstView8 image, const MeasureRectangle& rectangle, const MeasureOptions& options,
+                std::vector<Edge>& edges);
+
+/**
+ * @brief 边缘对（measure_pairs）| Edge pairs, like measure_pairs
+ *
+ * 🎯 每对由相邻的两个相反极性边缘组成；transition 指定第一个边缘的极性，All 时由第一个检测到的边缘决定。
+ * Each pair is two neighbouring edges of opposite polarity; transition selects the polarity of the first edge
+ * (with All, the first detected edge decides).
+ */
+bool measurePairs(ConstView8 image, const MeasureRectangle& rectangle, const MeasureOptions& options,
+                  std::vector<EdgePair>& pairs);
+
+/**
+ * @brief 取幅值绝对值最大的边缘 | Pick the edge with the largest |amplitude|
+ * @return edges 为空时返回false | False when edges is empty
+ */
+bool strongestEdge(const std::vector<Edge>& edges, Edge& edge);
+
+} // namespace vk
+
+#endif // VK_MEASURE1D_H
@@ -0,0 +1,134 @@
+#ifndef VK_REGION_H
+#define VK_REGION_H
+
+#include <cstdint>
+#include <vector>
+
+namespace vk {
+
+/**
+ * @brief 区域的一段行程 | One run of a run-length encoded region
+ *
+ * 🎯 与 Halcon get_region_runs 对应：row 为行，[begin, end) 为列范围（end = Halcon 的 ColumnEnd + 1）。
+ * Matches Halcon get_region_runs: row and the column range [begin, end) (end = Halcon ColumnEnd + 1).
+ */
+struct Run {
+    int row = 0;
+    int begin = 0;
+    int end = 0;
+};
+
+using RunList = std::vector<Run>;
+
+/**
+ * @brief 行程编码区域 | Run-length encoded region
+ *
+ * 🎯 行程始终保持规范形式：按 (row, begin) 排序，同一行内的行程互不重叠也不相邻。
+ * 构造时检查一次，已规范的输入（如阈值分割结果）不会重新排序；下列运算的结果都直接是规范形式。
+ * 坐标不受图像尺寸限制，可以为负。
+ * Runs are always canonical: sorted by (row, begin), runs of the same row neither overlap nor touch.
+ * The constructor checks once and only sorts/merges when needed; all operations below return canonical
+ * regions. Coordinates are unbounded and may be negative.
+ */
+class Region {
+public:
+    Region() = default;
+    explicit Region(RunList runs);
+
+    // 与 gen_rectangle1 相同，坐标为闭区间 | Same as gen_rectangle1, inclusive coordinates
+    static Region rectangle(int row1, int column1, int row2, int column2);
+
+    const RunList& runs() const { return m_runs; }
+    bool empty() const { return m_runs.empty(); }
+    std::uint64_t area() const;
+
+private:
+    RunList m_runs;
+};
+
+/**
+ * @brief 集合运算（逐行归并，行块并行）| Set operations, merged row by row in parallel row bands
+ */
+Region unionRegions(const Region& a, const Region& b);
+Region unionRegions(const std::vector<Region>& regions);
+Region intersectRegions(const Region& a, const Region& b);
+Region subtractRegion(const Region& a, const Region& b);   // a \ b
+Region translateRegion(const Region& region, int rowOffset, int columnOffset);
+
+/**
+ * @brief 矩形结构元素的膨胀/腐蚀/开/闭 | Rectangle dilation, erosion, opening and closing
+ *
+ * 🎯 水平方向直接扩展/收缩每段行程；垂直方向用 van Herk/Gil-Werman：按窗口高度分块求前缀与后缀并集
+ * （腐蚀为交集），每行只需一次合并，耗时与矩形高度无关。结构元素以 ((height-1)/2, (width-1)/2) 为参考点，
+ * 与 dilation_rectangle1 等算子的奇数尺寸一致。
+ * Horizontally each run is simply grown or shrunk; vertically van Herk/Gil-Werman block prefix/suffix unions
+ * (intersections for erosion) give one merge per row regardless of the height. The reference point is
+ * ((height-1)/2, (width-1)/2), matching dilation_rectangle1 for odd sizes.
+ *
+ * @param width 结构元素宽度(>=1) | Structuring element width
+ * @param height 结构元素高度(>=1) | Structuring element height
+ */
+Region dilateRectangle(const Region& region, int width, int height);
+Region erodeRectangle(const Region& region, int width, int height);
+Region openRectangle(const Region& region, int width, int height);
+Region closeRectangle(const Region& region, int width, int height);
+
+/**
+ * @brief 圆形结构元素的膨胀/腐蚀/开/闭 | Disc dilation, erosion, opening and closing
+ *
+ * 🎯 圆盘包含 dx² + dy² ≤ radius² 的像素，按行拆成 2⌊radius⌋+1 段水平线段，每个输出行合并对应输入行的
+ * 扩展（或收缩）结果，耗时与半径成正比；输出行之间并行。
+ * The disc holds the pixels with dx² + dy² ≤ radius²; it is split into 2⌊radius⌋+1 horizontal segments and each
+ * output row merges the correspondingly grown (or shrunk) input rows, O(radius) per row, rows in parallel.
+ */
+Region dilateCircle(const Region& region, double radius);
+Region erodeCircle(const Region& region, double radius);
+Region openCircle(const Region& region, double radius);
+Region closeCircle(const Region& region, double radius);
+
+/**
+ * @brief 邻域类型 | Neighbourhood
+ */
+enum class Connectivity {
+    Four,    // 4邻域 | 4-connected
+    Eight    // 8邻域（与 Halcon 默认相同）| 8-connected (Halcon default)
+};
+
+/**
+ * @brief 连通域分割（行程并查集）| Connected components by union-find over runs
+ *
+ * 🎯 相邻两行的行程用双指针判断重叠后合并；行块内并行，块边界最后串行合并。
+ * 结果按各连通域第一个像素的行列顺序排列（与 connection 相同）。
+ * Overlapping runs of adjacent rows are joined with a two-pointer sweep; row bands run in parallel and band
+ * boundaries are joined afterwards. Components are ordered by their first pixel, like connection.
+ */
+std::vector<Region> connectedComponents(const Region& region, Connectivity connectivity = Connectivity::Eight);
+
+/**
+ * @brief 区域形状特征 | Region shape features
+ */
+struct RegionFeatures {
+    std::uint64_t area = 0;        // 面积 | Area in pixels
+    double row = 0.0;              // 重心行 | Centroid row
+    double column = 0.0;           // 重心列 | Centroid column
+    int row1 = 0;                  // 外接矩形（闭区间）| Bounding box, inclusive
+    int column1 = 0;
+    int row2 = 0;
+    int column2 = 0;
+    double circularity = 0.0;      // F / (π·maxDistance²)，与 circularity 相同 | As Halcon circularity
+    double rectangularity = 0.0;   // 1 − |A Δ R| / |A|，R 为同阶矩矩形 | R has the same moments, as Halcon
+};
+
+/**
+ * @brief 计算形状特征 | Compute shape features
+ *
+ * 🎯 面积、重心、外接矩形和二阶矩在一次行程遍历中得到（每段行程用求和公式，不逐像素）；
+ * 圆形度需要到重心的最远距离，矩形度需要与等效矩形求交，二者只再遍历一次行程端点。
+ * Area, centroid, bounding box and second moments come from one pass over the runs (closed-form sums per run);
+ * circularity and rectangularity need the centroid, so they take a second pass over the runs only.
+ */
+RegionFeatures regionFeatures(const Region& region);
+
+} // namespace vk
+
+#endif // VK_REGION_H
@@ -0,0 +1,909 @@
+//
+// 颜色阈值分割 | Colour threshold segmentation
+//
+// 每行只读一次原始像素：RGB 区间或 HSV 区间的判断在SIMD通道内完成，结果以每像素1位写入行掩码，
+// 再用位扫描把掩码转成行程。HSV 不计算H/S图像，而是把“四舍五入后的 H/S 落在区间内”改写成
+// 整数交叉相乘（SSE2/AVX2 用 madd，NEON 用 vmlal），无除法，各指令集结果逐位一致。
+// Each row of source pixels is read once: the RGB or HSV interval tests run in SIMD lanes and write one bit
+// per pixel into a row mask, which bit scanning turns into runs. HSV never builds H/S images; "rounded H/S
+// inside the interval" is rewritten as exact integer cross-multiplication (madd / vmlal), with no division.
+//
+
+#include "../inc/ColorThreshold.h"
+#include "../inc/KernelRuntime.h"
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace vk {
+
+namespace {
+
+// 像素 RGB 区间，按 R/G/B 顺序 | Per-channel RGB bounds in R, G, B order
+struct BoxBounds {
+    std::uint8_t lo[3];
+    std::uint8_t hi[3];
+};
+
+/**
+ * HSV 区间（byte 量程）| HSV bounds on the byte scale
+ * 设 d = max−min，hd = H(度)/60·d，则
+ *   round(H) ≥ hueMin ⇔ 85·hd − (2·hueMin−1)·d ≥ 0，round(H) ≤ hueMax ⇔ (2·hueMax+1)·d − 85·hd > 0
+ *   round(S) ≥ satMin ⇔ 510·d − (2·satMin−1)·max ≥ 0，round(S) ≤ satMax ⇔ (2·satMax+1)·max − 510·d > 0
+ * 所有系数都在 int16 范围内，乘积在 int32 范围内。d = 0 时 H = S = 0。
+ */
+struct HsvBounds {
+    int hueMin;
+    int hueMax;
+    bool hueWrap;   // hueMin > hueMax：跨越0的环形区间 | Range wraps through 0
+    int satMin;
+    int satMax;
+    std::uint8_t valueMin;
+    std::uint8_t valueMax;
+};
+
+// 交错像素中 R/G/B 的字节偏移 | Byte offsets of R, G and B inside a packed pixel
+struct PackedLayout {
+    int channels;
+    int offset[3];
+};
+
+struct ColorKernels {
+    // 以下函数把 [0, n) 的判断结果写入 bits（第 x 位对应像素 x）| Write one result bit per pixel into bits
+    void (*boxPlanar)(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                      const BoxBounds& bounds, std::uint8_t* bits);
+    void (*boxPacked)(const std::uint8_t* p, int n, const PackedLayout& layout, const BoxBounds& bounds,
+                      std::uint8_t* bits);
+    void (*hsvPlanar)(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                      const HsvBounds& bounds, std::uint8_t* bits);
+    // 交错 → 平面（HSV 交错输入先拆到行缓冲）| Packed to planar row buffers (used by packed HSV)
+    void (*deinterleave)(const std::uint8_t* p, int n, const PackedLayout& layout, std::uint8_t* r,
+                         std::uint8_t* g, std::uint8_t* b);
+};
+
+// ---------------------------------------------------------------------------
+// 标量实现（也用于SIMD版本的行尾）| Scalar versions (also handle SIMD row tails)
+// ---------------------------------------------------------------------------
+
+inline bool boxPixel(int r, int g, int b, const BoxBounds& k)
+{
+    return r >= k.lo[0] && r <= k.hi[0] && g >= k.lo[1] && g <= k.hi[1] && b >= k.lo[2] && b <= k.hi[2];
+}
+
+inline bool hsvPixel(int r, int g, int b, const HsvBounds& k)
+{
+    const int mx = std::max(r, std::max(g, b));
+    const int d = mx - std::min(r, std::min(g, b));
+    if (mx < k.valueMin || mx > k.valueMax) {
+        return false;
+    }
+    const int mxS = std::max(mx, 1); // max = 0 时 S = 0 | S = 0 for black
+    if (510 * d - (2 * k.satMin - 1) * mxS < 0 || (2 * k.satMax + 1) * mxS - 510 * d <= 0) {
+        return false;
+    }
+    if (d == 0) {
+        return k.hueWrap || k.hueMin <= 0;
+    }
+    int hd = 0;
+    if (mx == r) {
+        hd = g - b;
+    } else if (mx == g) {
+        hd = 2 * d + b - r;
+    } else {
+        hd = 4 * d + r - g;
+    }
+    if (hd < 0) {
+        hd += 6 * d;
+    }
+    const bool low = 85 * hd - (2 * k.hueMin - 1) * d >= 0;
+    const bool high = (2 * k.hueMax + 1) * d - 85 * hd > 0;
+    return k.hueWrap ? (low || high) : (low && high);
+}
+
+// 写入 [start, n) 的位，start 必须是8的倍数 | Write bits [start, n); start must be a multiple of 8
+template <typename Test>
+void writeBitsTail(int start, int n, std::uint8_t* bits, Test&& test)
+{
+    for (int x = start; x < n; x += 8) {
+        std::uint8_t byte = 0;
+        const int count = std::min(8, n - x);
+        for (int i = 0; i < count; ++i) {
+            byte |= static_cast<std::uint8_t>(test(x + i) ? 1u << i : 0u);
+        }
+        bits[x >> 3] = byte;
+    }
+}
+
+inline void storeBits16(std::uint8_t* bits, int x, unsigned mask)
+{
+    const std::uint16_t value = static_cast<std::uint16_t>(mask);
+    std::memcpy(bits + (x >> 3), &value, sizeof(value));
+}
+
+inline void storeBits32(std::uint8_t* bits, int x, unsigned mask)
+{
+    const std::uint32_t value = mask;
+    std::memcpy(bits + (x >> 3), &value, sizeof(value));
+}
+
+void boxPlanarTail(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int start, int n,
+                   const BoxBounds& k, std::uint8_t* bits)
+{
+    writeBitsTail(start, n, bits, [&](int x) { return boxPixel(r[x], g[x], b[x], k); });
+}
+
+void boxPackedTail(const std::uint8_t* p, int start, int n, const PackedLayout& layout, const BoxBounds& k,
+                   std::uint8_t* bits)
+{
+    writeBitsTail(start, n, bits, [&](int x) {
+        const std::uint8_t* pixel = p + static_cast<std::ptrdiff_t>(x) * layout.channels;
+        return boxPixel(pixel[layout.offset[0]], pixel[layout.offset[1]], pixel[layout.offset[2]], k);
+    });
+}
+
+void hsvPlanarTail(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int start, int n,
+                   const HsvBounds& k, std::uint8_t* bits)
+{
+    writeBitsTail(start, n, bits, [&](int x) { return hsvPixel(r[x], g[x], b[x], k); });
+}
+
+void boxPlanarScalar(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                     const BoxBounds& k, std::uint8_t* bits)
+{
+    boxPlanarTail(r, g, b, 0, n, k, bits);
+}
+
+void boxPackedScalar(const std::uint8_t* p, int n, const PackedLayout& layout, const BoxBounds& k,
+                     std::uint8_t* bits)
+{
+    boxPackedTail(p, 0, n, layout, k, bits);
+}
+
+void hsvPlanarScalar(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                     const HsvBounds& k, std::uint8_t* bits)
+{
+    hsvPlanarTail(r, g, b, 0, n, k, bits);
+}
+
+void deinterleaveScalar(const std::uint8_t* p, int n, const PackedLayout& layout, std::uint8_t* r,
+                        std::uint8_t* g, std::uint8_t* b)
+{
+    const std::uint8_t* pr = p + layout.offset[0];
+    const std::uint8_t* pg = p + layout.offset[1];
+    const std::uint8_t* pb = p + layout.offset[2];
+    const int step = layout.channels;
+    for (int x = 0; x < n; ++x) {
+        r[x] = pr[x * step];
+        g[x] = pg[x * step];
+        b[x] = pb[x * step];
+    }
+}
+
+const ColorKernels kScalarColor = {boxPlanarScalar, boxPackedScalar, hsvPlanarScalar, deinterleaveScalar};
+
+// 每像素3个判断位中的第0位收集成16位掩码 | Gather every third bit of a 48-bit mask into 16 bits
+inline unsigned gatherEveryThird(std::uint64_t mask)
+{
+    unsigned bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        bits |= static_cast<unsigned>((mask >> (3 * i)) & 1u) << i;
+    }
+    return bits;
+}
+
+#if defined(VK_HAVE_SSE2)
+// ---------------------------------------------------------------------------
+// SSE2
+// ---------------------------------------------------------------------------
+
+// 字节 v 超出 [lo, hi] 时结果非0 | Non-zero where byte v lies outside [lo, hi]
+inline __m128i outsideSse2(__m128i v, __m128i lo, __m128i hi)
+{
+    return _mm_or_si128(_mm_subs_epu8(lo, v), _mm_subs_epu8(v, hi));
+}
+
+void boxPlanarSse2(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                   const BoxBounds& k, std::uint8_t* bits)
+{
+    const __m128i loR = _mm_set1_epi8(static_cast<char>(k.lo[0]));
+    const __m128i hiR = _mm_set1_epi8(static_cast<char>(k.hi[0]));
+    const __m128i loG = _mm_set1_epi8(static_cast<char>(k.lo[1]));
+    const __m128i hiG = _mm_set1_epi8(static_cast<char>(k.hi[1]));
+    const __m128i loB = _mm_set1_epi8(static_cast<char>(k.lo[2]));
+    const __m128i hiB = _mm_set1_epi8(static_cast<char>(k.hi[2]));
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const __m128i vr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + x));
+        const __m128i vg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + x));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+        const __m128i outside = _mm_or_si128(outsideSse2(vr, loR, hiR),
+                                             _mm_or_si128(outsideSse2(vg, loG, hiG), outsideSse2(vb, loB, hiB)));
+        storeBits16(bits, x, static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(outside, zero))));
+    }
+    boxPlanarTail(r, g, b, x, n, k, bits);
+}
+
+/**
+ * 交错像素：按像素布局把区间展开成每字节的上下限（3通道周期48字节，4通道周期16字节），
+ * 逐字节判断后再把每像素的通道结果合并。
+ * Packed pixels: the bounds are expanded into per-byte patterns matching the pixel layout, every byte is tested,
+ * then the per-channel results of each pixel are combined.
+ */
+void boxPackedSse2(const std::uint8_t* p, int n, const PackedLayout& layout, const BoxBounds& k,
+                   std::uint8_t* bits)
+{
+    const int channels = layout.channels;
+    alignas(16) std::uint8_t lo[48];
+    alignas(16) std::uint8_t hi[48];
+    for (int i = 0; i < 48; ++i) {
+        lo[i] = 0;
+        hi[i] = 255;   // 第4字节（alpha）不参与判断 | The fourth byte always passes
+        for (int c = 0; c < 3; ++c) {
+            if (i % channels == layout.offset[c]) {
+                lo[i] = k.lo[c];
+                hi[i] = k.hi[c];
+            }
+        }
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo0 = _mm_load_si128(reinterpret_cast<const __m128i*>(lo));
+    const __m128i hi0 = _mm_load_si128(reinterpret_cast<const __m128i*>(hi));
+    int x = 0;
+    if (channels == 4) {
+        // 每像素一个32位通道，4个字节全部在区间内时该通道为0 | One 32-bit lane per pixel
+        for (; x + 16 <= n; x += 16) {
+            const __m128i* src = reinterpret_cast<const __m128i*>(p + static_cast<std::ptrdiff_t>(x) * 4);
+            unsigned mask = 0;
+            for (int i = 0; i < 4; ++i) {
+                const __m128i outside = outsideSse2(_mm_loadu_si128(src + i), lo0, hi0);
+                const __m128i inside = _mm_cmpeq_epi32(outside, zero);
+                mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(inside))) << (4 * i);
+            }
+            storeBits16(bits, x, mask);
+        }
+    } else {
+        const __m128i lo1 = _mm_load_si128(reinterpret_cast<const __m128i*>(lo + 16));
+        const __m128i hi1 = _mm_load_si128(reinterpret_cast<const __m128i*>(hi + 16));
+        const __m128i lo2 = _mm_load_si128(reinterpret_cast<const __m128i*>(lo + 32));
+        const __m128i hi2 = _mm_load_si128(reinterpret_cast<const __m128i*>(hi + 32));
+        for (; x + 16 <= n; x += 16) {
+            const __m128i* src = reinterpret_cast<const __m128i*>(p + static_cast<std::ptrdiff_t>(x) * 3);
+            const std::uint64_t m0 = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(outsideSse2(_mm_loadu_si128(src + 0), lo0, hi0), zero)));
+            const std::uint64_t m1 = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(outsideSse2(_mm_loadu_si128(src + 1), lo1, hi1), zero)));
+            const std::uint64_t m2 = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(outsideSse2(_mm_loadu_si128(src + 2), lo2, hi2), zero)));
+            const std::uint64_t m = m0 | (m1 << 16) | (m2 << 32);
+            storeBits16(bits, x, gatherEveryThird(m & (m >> 1) & (m >> 2)));
+        }
+    }
+    boxPackedTail(p, x, n, layout, k, bits);
+}
+
+struct HsvConstsSse2 {
+    __m128i hueLow;    // (85, −(2·hueMin−1)) 交错 | interleaved madd pair
+    __m128i hueHigh;   // (−85, 2·hueMax+1)
+    __m128i satLow;    // (510, −(2·satMin−1))
+    __m128i satHigh;   // (−510, 2·satMax+1)
+    __m128i wrap;      // 环形区间时全1 | All ones for a wrapping hue range
+    __m128i zeroHue;   // d = 0（H = 0）时的色调结果 | Hue result for grey pixels
+    __m128i valueMin;
+    __m128i valueMax;
+};
+
+inline __m128i pairSse2(int a, int b)
+{
+    return _mm_set1_epi32(static_cast<int>((static_cast<std::uint32_t>(b) << 16) | static_cast<std::uint16_t>(a)));
+}
+
+HsvConstsSse2 hsvConstsSse2(const HsvBounds& k)
+{
+    HsvConstsSse2 c;
+    c.hueLow = pairSse2(85, -(2 * k.hueMin - 1));
+    c.hueHigh = pairSse2(-85, 2 * k.hueMax + 1);
+    c.satLow = pairSse2(510, -(2 * k.satMin - 1));
+    c.satHigh = pairSse2(-510, 2 * k.satMax + 1);
+    c.wrap = _mm_set1_epi16(k.hueWrap ? -1 : 0);
+    c.zeroHue = _mm_set1_epi16(k.hueMin <= 0 ? -1 : 0);
+    c.valueMin = _mm_set1_epi8(static_cast<char>(k.valueMin));
+    c.valueMax = _mm_set1_epi8(static_cast<char>(k.valueMax));
+    return c;
+}
+
+inline __m128i selectSse2(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// 两组 madd 的符号判断合并为8个16位掩码 | Sign tests of two madd groups packed to eight 16-bit masks
+inline __m128i maddTestSse2(__m128i lo, __m128i hi, __m128i coeff, __m128i threshold)
+{
+    return _mm_packs_epi32(_mm_cmpgt_epi32(_mm_madd_epi16(lo, coeff), threshold),
+                           _mm_cmpgt_epi32(_mm_madd_epi16(hi, coeff), threshold));
+}
+
+// 8个像素的 H/S 判断（16位通道），V 由调用方按字节判断 | H/S tests for eight 16-bit pixels
+inline __m128i hsvHalfSse2(__m128i r, __m128i g, __m128i b, const HsvConstsSse2& c)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i minusOne = _mm_set1_epi32(-1);
+    const __m128i mx = _mm_max_epi16(r, _mm_max_epi16(g, b));
+    const __m128i d = _mm_sub_epi16(mx, _mm_min_epi16(r, _mm_min_epi16(g, b)));
+    const __m128i isR = _mm_cmpeq_epi16(mx, r);
+    const __m128i isG = _mm_andnot_si128(isR, _mm_cmpeq_epi16(mx, g));
+    const __m128i isB = _mm_andnot_si128(_mm_or_si128(isR, isG), minusOne);
+    const __m128i d2 = _mm_add_epi16(d, d);
+    const __m128i d4 = _mm_add_epi16(d2, d2);
+
+    // hd = 扇区起点·d + 扇区内偏移，负值加 6d | Sector base times d plus offset, wrapped into [0, 6d)
+    const __m128i num = selectSse2(isR, _mm_sub_epi16(g, b), selectSse2(isG, _mm_sub_epi16(b, r), _mm_sub_epi16(r, g)));
+    __m128i hd = _mm_add_epi16(num, _mm_or_si128(_mm_and_si128(isG, d2), _mm_and_si128(isB, d4)));
+    hd = _mm_add_epi16(hd, _mm_and_si128(_mm_cmplt_epi16(hd, zero), _mm_add_epi16(d2, d4)));
+
+    const __m128i hueLo = _mm_unpacklo_epi16(hd, d);
+    const __m128i hueHi = _mm_unpackhi_epi16(hd, d);
+    const __m128i low = maddTestSse2(hueLo, hueHi, c.hueLow, minusOne);
+    const __m128i high = maddTestSse2(hueLo, hueHi, c.hueHigh, zero);
+    __m128i hue = _mm_or_si128(_mm_and_si128(low, high), _mm_and_si128(c.wrap, _mm_or_si128(low, high)));
+    hue = _mm_or_si128(hue, _mm_and_si128(_mm_cmpeq_epi16(d, zero), c.zeroHue));
+
+    const __m128i mxS = _mm_max_epi16(mx, _mm_set1_epi16(1));
+    const __m128i satLo = _mm_unpacklo_epi16(d, mxS);
+    const __m128i satHi = _mm_unpackhi_epi16(d, mxS);
+    const __m128i sat = _mm_and_si128(maddTestSse2(satLo, satHi, c.satLow, minusOne),
+                                      maddTestSse2(satLo, satHi, c.satHigh, zero));
+    return _mm_and_si128(hue, sat);
+}
+
+void hsvPlanarSse2(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                   const HsvBounds& k, std::uint8_t* bits)
+{
+    const HsvConstsSse2 c = hsvConstsSse2(k);
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const __m128i vr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + x));
+        const __m128i vg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + x));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+        const __m128i mx = _mm_max_epu8(vr, _mm_max_epu8(vg, vb));
+        const __m128i value = _mm_cmpeq_epi8(outsideSse2(mx, c.valueMin, c.valueMax), zero);
+        const __m128i lo = hsvHalfSse2(_mm_unpacklo_epi8(vr, zero), _mm_unpacklo_epi8(vg, zero),
+                                       _mm_unpacklo_epi8(vb, zero), c);
+        const __m128i hi = hsvHalfSse2(_mm_unpackhi_epi8(vr, zero), _mm_unpackhi_epi8(vg, zero),
+                                       _mm_unpackhi_epi8(vb, zero), c);
+        const __m128i inside = _mm_and_si128(_mm_packs_epi16(lo, hi), value);
+        storeBits16(bits, x, static_cast<unsigned>(_mm_movemask_epi8(inside)));
+    }
+    hsvPlanarTail(r, g, b, x, n, k, bits);
+}
+
+const ColorKernels kSse2Color = {boxPlanarSse2, boxPackedSse2, hsvPlanarSse2, deinterleaveScalar};
+#endif
+
+#if defined(VK_HAVE_AVX2)
+// ---------------------------------------------------------------------------
+// AVX2（函数级目标属性）| AVX2 via per-function target attribute
+// unpack/pack 都在128位半区内进行，先拆后合的顺序互逆，因此结果位与像素顺序一致。
+// unpack and pack both work within 128-bit halves and undo each other, so result bits stay in pixel order.
+// ---------------------------------------------------------------------------
+
+VK_TARGET_AVX2 inline __m256i outsideAvx2(__m256i v, __m256i lo, __m256i hi)
+{
+    return _mm256_or_si256(_mm256_subs_epu8(lo, v), _mm256_subs_epu8(v, hi));
+}
+
+VK_TARGET_AVX2 void boxPlanarAvx2(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                                  const BoxBounds& k, std::uint8_t* bits)
+{
+    const __m256i loR = _mm256_set1_epi8(static_cast<char>(k.lo[0]));
+    const __m256i hiR = _mm256_set1_epi8(static_cast<char>(k.hi[0]));
+    const __m256i loG = _mm256_set1_epi8(static_cast<char>(k.lo[1]));
+    const __m256i hiG = _mm256_set1_epi8(static_cast<char>(k.hi[1]));
+    const __m256i loB = _mm256_set1_epi8(static_cast<char>(k.lo[2]));
+    const __m256i hiB = _mm256_set1_epi8(static_cast<char>(k.hi[2]));
+    const __m256i zero = _mm256_setzero_si256();
+    int x = 0;
+    for (; x + 32 <= n; x += 32) {
+        const __m256i vr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + x));
+        const __m256i vg = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(g + x));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x));
+        const __m256i outside = _mm256_or_si256(outsideAvx2(vr, loR, hiR),
+                                                _mm256_or_si256(outsideAvx2(vg, loG, hiG), outsideAvx2(vb, loB, hiB)));
+        storeBits32(bits, x, static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(outside, zero))));
+    }
+    boxPlanarTail(r, g, b, x, n, k, bits);
+}
+
+struct HsvConstsAvx2 {
+    __m256i hueLow;
+    __m256i hueHigh;
+    __m256i satLow;
+    __m256i satHigh;
+    __m256i wrap;
+    __m256i zeroHue;
+    __m256i valueMin;
+    __m256i valueMax;
+};
+
+VK_TARGET_AVX2 inline __m256i pairAvx2(int a, int b)
+{
+    return _mm256_set1_epi32(static_cast<int>((static_cast<std::uint32_t>(b) << 16) | static_cast<std::uint16_t>(a)));
+}
+
+VK_TARGET_AVX2 inline __m256i selectAvx2(__m256i mask, __m256i a, __m256i b)
+{
+    return _mm256_blendv_epi8(b, a, mask);
+}
+
+VK_TARGET_AVX2 inline __m256i maddTestAvx2(__m256i lo, __m256i hi, __m256i coeff, __m256i threshold)
+{
+    return _mm256_packs_epi32(_mm256_cmpgt_epi32(_mm256_madd_epi16(lo, coeff), threshold),
+                              _mm256_cmpgt_epi32(_mm256_madd_epi16(hi, coeff), threshold));
+}
+
+VK_TARGET_AVX2 inline __m256i hsvHalfAvx2(__m256i r, __m256i g, __m256i b, const HsvConstsAvx2& c)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i mx = _mm256_max_epi16(r, _mm256_max_epi16(g, b));
+    const __m256i d = _mm256_sub_epi16(mx, _mm256_min_epi16(r, _mm256_min_epi16(g, b)));
+    const __m256i isR = _mm256_cmpeq_epi16(mx, r);
+    const __m256i isG = _mm256_andnot_si256(isR, _mm256_cmpeq_epi16(mx, g));
+    const __m256i isB = _mm256_andnot_si256(_mm256_or_si256(isR, isG), minusOne);
+    const __m256i d2 = _mm256_add_epi16(d, d);
+    const __m256i d4 = _mm256_add_epi16(d2, d2);
+
+    const __m256i num = selectAvx2(isR, _mm256_sub_epi16(g, b),
+                                   selectAvx2(isG, _mm256_sub_epi16(b, r), _mm256_sub_epi16(r, g)));
+    __m256i hd = _mm256_add_epi16(num, _mm256_or_si256(_mm256_and_si256(isG, d2), _mm256_and_si256(isB, d4)));
+    hd = _mm256_add_epi16(hd, _mm256_and_si256(_mm256_cmpgt_epi16(zero, hd), _mm256_add_epi16(d2, d4)));
+
+    const __m256i hueLo = _mm256_unpacklo_epi16(hd, d);
+    const __m256i hueHi = _mm256_unpackhi_epi16(hd, d);
+    const __m256i low = maddTestAvx2(hueLo, hueHi, c.hueLow, minusOne);
+    const __m256i high = maddTestAvx2(hueLo, hueHi, c.hueHigh, zero);
+    __m256i hue = _mm256_or_si256(_mm256_and_si256(low, high), _mm256_and_si256(c.wrap, _mm256_or_si256(low, high)));
+    hue = _mm256_or_si256(hue, _mm256_and_si256(_mm256_cmpeq_epi16(d, zero), c.zeroHue));
+
+    const __m256i mxS = _mm256_max_epi16(mx, _mm256_set1_epi16(1));
+    const __m256i satLo = _mm256_unpacklo_epi16(d, mxS);
+    const __m256i satHi = _mm256_unpackhi_epi16(d, mxS);
+    const __m256i sat = _mm256_and_si256(maddTestAvx2(satLo, satHi, c.satLow, minusOne),
+                                         maddTestAvx2(satLo, satHi, c.satHigh, zero));
+    return _mm256_and_si256(hue, sat);
+}
+
+VK_TARGET_AVX2 void hsvPlanarAvx2(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                                  const HsvBounds& k, std::uint8_t* bits)
+{
+    HsvConstsAvx2 c;
+    c.hueLow = pairAvx2(85, -(2 * k.hueMin - 1));
+    c.hueHigh = pairAvx2(-85, 2 * k.hueMax + 1);
+    c.satLow = pairAvx2(510, -(2 * k.satMin - 1));
+    c.satHigh = pairAvx2(-510, 2 * k.satMax + 1);
+    c.wrap = _mm256_set1_epi16(k.hueWrap ? -1 : 0);
+    c.zeroHue = _mm256_set1_epi16(k.hueMin <= 0 ? -1 : 0);
+    c.valueMin = _mm256_set1_epi8(static_cast<char>(k.valueMin));
+    c.valueMax = _mm256_set1_epi8(static_cast<char>(k.valueMax));
+    const __m256i zero = _mm256_setzero_si256();
+    int x = 0;
+    for (; x + 32 <= n; x += 32) {
+        const __m256i vr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + x));
+        const __m256i vg = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(g + x));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x));
+        const __m256i mx = _mm256_max_epu8(vr, _mm256_max_epu8(vg, vb));
+        const __m256i value = _mm256_cmpeq_epi8(outsideAvx2(mx, c.valueMin, c.valueMax), zero);
+        const __m256i lo = hsvHalfAvx2(_mm256_unpacklo_epi8(vr, zero), _mm256_unpacklo_epi8(vg, zero),
+                                       _mm256_unpacklo_epi8(vb, zero), c);
+        const __m256i hi = hsvHalfAvx2(_mm256_unpackhi_epi8(vr, zero), _mm256_unpackhi_epi8(vg, zero),
+                                       _mm256_unpackhi_epi8(vb, zero), c);
+        const __m256i inside = _mm256_and_si256(_mm256_packs_epi16(lo, hi), value);
+        storeBits32(bits, x, static_cast<unsigned>(_mm256_movemask_epi8(inside)));
+    }
+    hsvPlanarTail(r, g, b, x, n, k, bits);
+}
+
+// 交错输入的字节模式判断已受移位合并限制，沿用SSE2版本 | Packed box test is bound by the bit merge; reuse SSE2
+const ColorKernels kAvx2Color = {boxPlanarAvx2, boxPackedSse2, hsvPlanarAvx2, deinterleaveScalar};
+#endif
+
+#if defined(VK_HAVE_NEON)
+// ---------------------------------------------------------------------------
+// NEON（vld3/vld4 直接拆分交错像素）| NEON, vld3/vld4 split packed pixels natively
+// ---------------------------------------------------------------------------
+
+// 16个字节掩码 → 16位 | Sixteen byte masks to a 16-bit mask
+inline unsigned movemaskNeon(uint8x16_t mask)
+{
+    static const std::uint8_t kWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t weighted = vandq_u8(mask, vld1q_u8(kWeights));
+    uint8x8_t sum = vpadd_u8(vget_low_u8(weighted), vget_high_u8(weighted));
+    sum = vpadd_u8(sum, sum);
+    sum = vpadd_u8(sum, sum);
+    return static_cast<unsigned>(vget_lane_u8(sum, 0)) | (static_cast<unsigned>(vget_lane_u8(sum, 1)) << 8);
+}
+
+inline uint8x16_t insideNeon(uint8x16_t v, uint8x16_t lo, uint8x16_t hi)
+{
+    return vandq_u8(vcgeq_u8(v, lo), vcleq_u8(v, hi));
+}
+
+inline uint8x16_t boxNeon(uint8x16_t r, uint8x16_t g, uint8x16_t b, const BoxBounds& k)
+{
+    return vandq_u8(insideNeon(r, vdupq_n_u8(k.lo[0]), vdupq_n_u8(k.hi[0])),
+                    vandq_u8(insideNeon(g, vdupq_n_u8(k.lo[1]), vdupq_n_u8(k.hi[1])),
+                             insideNeon(b, vdupq_n_u8(k.lo[2]), vdupq_n_u8(k.hi[2]))));
+}
+
+void boxPlanarNeon(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                   const BoxBounds& k, std::uint8_t* bits)
+{
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        storeBits16(bits, x, movemaskNeon(boxNeon(vld1q_u8(r + x), vld1q_u8(g + x), vld1q_u8(b + x), k)));
+    }
+    boxPlanarTail(r, g, b, x, n, k, bits);
+}
+
+void boxPackedNeon(const std::uint8_t* p, int n, const PackedLayout& layout, const BoxBounds& k,
+                   std::uint8_t* bits)
+{
+    int x = 0;
+    if (layout.channels == 4) {
+        for (; x + 16 <= n; x += 16) {
+            const uint8x16x4_t v = vld4q_u8(p + static_cast<std::ptrdiff_t>(x) * 4);
+            storeBits16(bits, x, movemaskNeon(boxNeon(v.val[layout.offset[0]], v.val[layout.offset[1]],
+                                                      v.val[layout.offset[2]], k)));
+        }
+    } else {
+        for (; x + 16 <= n; x += 16) {
+            const uint8x16x3_t v = vld3q_u8(p + static_cast<std::ptrdiff_t>(x) * 3);
+            storeBits16(bits, x, movemaskNeon(boxNeon(v.val[layout.offset[0]], v.val[layout.offset[1]],
+                                                      v.val[layout.offset[2]], k)));
+        }
+    }
+    boxPackedTail(p, x, n, layout, k, bits);
+}
+
+// a·ca + b·cb 的符号判断（4个32位通道）→ 4个16位掩码 | Sign test of a·ca + b·cb narrowed to 16-bit masks
+inline uint16x4_t mlaTestNeon(int16x4_t a, int ca, int16x4_t b, int cb, bool strict)
+{
+    int32x4_t acc = vmull_n_s16(a, static_cast<std::int16_t>(ca));
+    acc = vmlal_n_s16(acc, b, static_cast<std::int16_t>(cb));
+    const uint32x4_t test = strict ? vcgtq_s32(acc, vdupq_n_s32(0)) : vcgeq_s32(acc, vdupq_n_s32(0));
+    return vmovn_u32(test);
+}
+
+inline uint16x8_t mlaTest8Neon(int16x8_t a, int ca, int16x8_t b, int cb, bool strict)
+{
+    return vcombine_u16(mlaTestNeon(vget_low_s16(a), ca, vget_low_s16(b), cb, strict),
+                        mlaTestNeon(vget_high_s16(a), ca, vget_high_s16(b), cb, strict));
+}
+
+inline uint16x8_t hsvHalfNeon(int16x8_t r, int16x8_t g, int16x8_t b, const HsvBounds& k)
+{
+    const int16x8_t mx = vmaxq_s16(r, vmaxq_s16(g, b));
+    const int16x8_t d = vsubq_s16(mx, vminq_s16(r, vminq_s16(g, b)));
+    const uint16x8_t isR = vceqq_s16(mx, r);
+    const uint16x8_t isG = vbicq_u16(vceqq_s16(mx, g), isR);
+    const int16x8_t d2 = vaddq_s16(d, d);
+    const int16x8_t d4 = vaddq_s16(d2, d2);
+
+    const int16x8_t num = vbslq_s16(isR, vsubq_s16(g, b), vbslq_s16(isG, vsubq_s16(b, r), vsubq_s16(r, g)));
+    const int16x8_t base = vbslq_s16(isR, vdupq_n_s16(0), vbslq_s16(isG, d2, d4));
+    int16x8_t hd = vaddq_s16(num, base);
+    hd = vaddq_s16(hd, vandq_s16(vreinterpretq_s16_u16(vcltq_s16(hd, vdupq_n_s16(0))), vaddq_s16(d2, d4)));
+
+    const uint16x8_t low = mlaTest8Neon(hd, 85, d, -(2 * k.hueMin - 1), false);
+    const uint16x8_t high = mlaTest8Neon(hd, -85, d, 2 * k.hueMax + 1, true);
+    uint16x8_t hue = k.hueWrap ? vorrq_u16(low, high) : vandq_u16(low, high);
+    if (k.hueMin <= 0) {
+        hue = vorrq_u16(hue, vceqq_s16(d, vdupq_n_s16(0)));
+    }
+
+    const int16x8_t mxS = vmaxq_s16(mx, vdupq_n_s16(1));
+    const uint16x8_t sat = vandq_u16(mlaTest8Neon(d, 510, mxS, -(2 * k.satMin - 1), false),
+                                     mlaTest8Neon(d, -510, mxS, 2 * k.satMax + 1, true));
+    return vandq_u16(hue, sat);
+}
+
+void hsvPlanarNeon(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, int n,
+                   const HsvBounds& k, std::uint8_t* bits)
+{
+    const uint8x16_t valueMin = vdupq_n_u8(k.valueMin);
+    const uint8x16_t valueMax = vdupq_n_u8(k.valueMax);
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const uint8x16_t vr = vld1q_u8(r + x);
+        const uint8x16_t vg = vld1q_u8(g + x);
+        const uint8x16_t vb = vld1q_u8(b + x);
+        const uint8x16_t value = insideNeon(vmaxq_u8(vr, vmaxq_u8(vg, vb)), valueMin, valueMax);
+        const uint16x8_t lo = hsvHalfNeon(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(vr))),
+                                          vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(vg))),
+                                          vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(vb))), k);
+        const uint16x8_t hi = hsvHalfNeon(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(vr))),
+                                          vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(vg))),
+                                          vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(vb))), k);
+        const uint8x16_t inside = vandq_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)), value);
+        storeBits16(bits, x, movemaskNeon(inside));
+    }
+    hsvPlanarTail(r, g, b, x, n, k, bits);
+}
+
+void deinterleaveNeon(const std::uint8_t* p, int n, const PackedLayout& layout, std::uint8_t* r,
+                      std::uint8_t* g, std::uint8_t* b)
+{
+    int x = 0;
+    if (layout.channels == 4) {
+        for (; x + 16 <= n; x += 16) {
+            const uint8x16x4_t v = vld4q_u8(p + static_cast<std::ptrdiff_t>(x) * 4);
+            vst1q_u8(r + x, v.val[layout.offset[0]]);
+            vst1q_u8(g + x, v.val[layout.offset[1]]);
+            vst1q_u8(b + x, v.val[layout.offset[2]]);
+        }
+    } else {
+        for (; x + 16 <= n; x += 16) {
+            const uint8x16x3_t v = vld3q_u8(p + static_cast<std::ptrdiff_t>(x) * 3);
+            vst1q_u8(r + x, v.val[layout.offset[0]]);
+            vst1q_u8(g + x, v.val[layout.offset[1]]);
+            vst1q_u8(b + x, v.val[layout.offset[2]]);
+        }
+    }
+    deinterleaveScalar(p + static_cast<std::ptrdiff_t>(x) * layout.channels, n - x, layout, r + x, g + x, b + x);
+}
+
+const ColorKernels kNeonColor = {boxPlanarNeon, boxPackedNeon, hsvPlanarNeon, deinterleaveNeon};
+#endif
+
+const ColorKernels& colorKernels()
+{
+    switch (simdLevel()) {
+#if defined(VK_HAVE_AVX2)
+    case SimdLevel::AVX2: return kAvx2Color;
+#endif
+#if defined(VK_HAVE_SSE2)
+    case SimdLevel::SSE2: return kSse2Color;
+#endif
+#if defined(VK_HAVE_NEON)
+    case SimdLevel::NEON: return kNeonColor;
+#endif
+    default: return kScalarColor;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 位掩码 → 行程 | Bit mask to runs
+// ---------------------------------------------------------------------------
+
+inline int lowestSetBit64(std::uint64_t value)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index = 0;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#elif defined(_MSC_VER)
+    unsigned long index = 0;
+    if (_BitScanForward(&index, static_cast<unsigned long>(value))) {
+        return static_cast<int>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+    return static_cast<int>(index) + 32;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// 每次取64位，全0或全1（在行程内）的字直接跳过，否则逐个找跳变位 | 64 bits at a time; uniform words are skipped
+void appendRowRuns(const std::uint8_t* bits, int width, int row, RunList& runs)
+{
+    const int words = (width + 63) / 64;
+    bool inside = false;
+    int begin = 0;
+    for (int w = 0; w < words; ++w) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bits + static_cast<std::size_t>(w) * 8, sizeof(word));
+        const int valid = std::min(64, width - w * 64);
+        if (valid < 64) {
+            word &= (std::uint64_t(1) << valid) - 1;
+        }
+        if (word == (inside ? ~std::uint64_t(0) : std::uint64_t(0))) {
+            continue;
+        }
+        std::uint64_t from = ~std::uint64_t(0);
+        for (;;) {
+            const std::uint64_t transitions = (inside ? ~word : word) & from;
+            if (transitions == 0) {
+                break;
+            }
+            const int bit = lowestSetBit64(transitions);
+            if (inside) {
+                runs.push_back(Run{row, begin, w * 64 + bit});
+            } else {
+                begin = w * 64 + bit;
+            }
+            inside = !inside;
+            from = ~std::uint64_t(0) << bit;
+        }
+    }
+    if (inside) {
+        runs.push_back(Run{row, begin, width});
+    }
+}
+
+// 每块至少约6.4万像素，小图单线程完成 | Bands hold at least ~64K pixels so small inputs stay single-threaded
+constexpr int kMinPixelsPerBand = 1 << 16;
+
+struct RowScratch {
+    std::vector<std::uint8_t> bits;
+    std::vector<std::uint8_t> planes;   // 交错输入拆分后的 R/G/B 行 | R/G/B rows split from packed input
+};
+
+/**
+ * 按行块并行生成行程：每块写自己的 RunList，最后按块顺序拼接，结果与单线程完全相同
+ * Runs are produced per row band and concatenated in band order, so the output matches a single-threaded run.
+ * rowBits(y, bits, scratch) 写出第 y 行的位掩码 | rowBits writes the bit mask of row y
+ */
+template <typename RowBits>
+void thresholdRows(int width, int height, RunList& runs, RowBits&& rowBits)
+{
+    const int bandRows = std::max(1, kMinPixelsPerBand / width);
+    const int bandCount = (height + bandRows - 1) / bandRows;
+    std::vector<RunList> bandRuns(static_cast<std::size_t>(bandCount));
+
+    parallelFor(0, bandCount, 1, [&](int band0, int band1) {
+        RowScratch scratch;
+        scratch.bits.assign(static_cast<std::size_t>((width + 63) / 64) * 8, 0);
+        for (int band = band0; band < band1; ++band) {
+            RunList& out = bandRuns[static_cast<std::size_t>(band)];
+            const int y1 = std::min(height, (band + 1) * bandRows);
+            for (int y = band * bandRows; y < y1; ++y) {
+                rowBits(y, scratch.bits.data(), scratch);
+                appendRowRuns(scratch.bits.data(), width, y, out);
+            }
+        }
+    });
+
+    std::size_t total = 0;
+    for (const RunList& band : bandRuns) {
+        total += band.size();
+    }
+    runs.reserve(total);
+    for (const RunList& band : bandRuns) {
+        runs.insert(runs.end(), band.begin(), band.end());
+    }
+}
+
+inline int clampByte(int value)
+{
+    return std::min(255, std::max(0, value));
+}
+
+// 任一通道区间为空时返回false | False when any channel range is empty
+bool makeBox(ChannelRange red, ChannelRange green, ChannelRange blue, BoxBounds& box)
+{
+    const ChannelRange ranges[3] = {red, green, blue};
+    for (int c = 0; c < 3; ++c) {
+        const int lo = clampByte(ranges[c].min);
+        const int hi = clampByte(ranges[c].max);
+        if (lo > hi || ranges[c].max < 0 || ranges[c].min > 255) {
+            return false;
+        }
+        box.lo[c] = static_cast<std::uint8_t>(lo);
+        box.hi[c] = static_cast<std::uint8_t>(hi);
+    }
+    return true;
+}
+
+bool makeHsv(ChannelRange hue, ChannelRange saturation, ChannelRange value, HsvBounds& bounds)
+{
+    BoxBounds box;
+    if (!makeBox(ChannelRange{0, 255}, saturation, value, box)) {
+        return false;
+    }
+    bounds.hueMin = clampByte(hue.min);
+    bounds.hueMax = clampByte(hue.max);
+    bounds.hueWrap = bounds.hueMin > bounds.hueMax;
+    bounds.satMin = box.lo[1];
+    bounds.satMax = box.hi[1];
+    bounds.valueMin = box.lo[2];
+    bounds.valueMax = box.hi[2];
+    return true;
+}
+
+PackedLayout packedLayout(const PackedRgb& image)
+{
+    PackedLayout layout;
+    layout.channels = image.channels;
+    const bool bgr = image.order == PixelOrder::BGR;
+    layout.offset[0] = bgr ? 2 : 0;
+    layout.offset[1] = 1;
+    layout.offset[2] = bgr ? 0 : 2;
+    return layout;
+}
+
+} // namespace
+
+bool thresholdRgb(const PlanarRgb& image, ChannelRange red, ChannelRange green, ChannelRange blue, RunList& runs)
+{
+    runs.clear();
+    if (!image.isValid()) {
+        return false;
+    }
+    BoxBounds box;
+    if (!makeBox(red, green, blue, box)) {
+        return true;
+    }
+    const ColorKernels& kernels = colorKernels();
+    const int width = image.width();
+    thresholdRows(width, image.height(), runs, [&](int y, std::uint8_t* bits, RowScratch&) {
+        kernels.boxPlanar(image.red.row(y), image.green.row(y), image.blue.row(y), width, box, bits);
+    });
+    return true;
+}
+
+bool thresholdRgb(const PackedRgb& image, ChannelRange red, ChannelRange green, ChannelRange blue, RunList& runs)
+{
+    runs.clear();
+    if (!image.isValid()) {
+        return false;
+    }
+    BoxBounds box;
+    if (!makeBox(red, green, blue, box)) {
+        return true;
+    }
+    const ColorKernels& kernels = colorKernels();
+    const PackedLayout layout = packedLayout(image);
+    thresholdRows(image.width, image.height, runs, [&](int y, std::uint8_t* bits, RowScratch&) {
+        kernels.boxPacked(image.row(y), image.width, layout, box, bits);
+    });
+    return true;
+}
+
+bool thresholdHsv(const PlanarRgb& image, ChannelRange hue, ChannelRange saturation, ChannelRange value, RunList& runs)
+{
+    runs.clear();
+    if (!image.isValid()) {
+        return false;
+    }
+    HsvBounds bounds;
+    if (!makeHsv(hue, saturation, value, bounds)) {
+        return true;
+    }
+    const ColorKernels& kernels = colorKernels();
+    const int width = image.width();
+    thresholdRows(width, image.height(), runs, [&](int y, std::uint8_t* bits, RowScratch&) {
+        kernels.hsvPlanar(image.red.row(y), image.green.row(y), image.blue.row(y), width, bounds, bits);
+    });
+    return true;
+}
+
+bool thresholdHsv(const PackedRgb& image, ChannelRange hue, ChannelRange saturation, ChannelRange value, RunList& runs)
+{
+    runs.clear();
+    if (!image.isValid()) {
+        return false;
+    }
+    HsvBounds bounds;
+    if (!makeHsv(hue, saturation, value, bounds)) {
+        return true;
+    }
+    const ColorKernels& kernels = colorKernels();
+    const PackedLayout layout = packedLayout(image);
+    const int width = image.width;
+    thresholdRows(width, image.height, runs, [&](int y, std::uint8_t* bits, RowScratch& scratch) {
+        // 拆分后的行留在L1中，紧接着做HSV判断 | The split row stays in L1 for the HSV test that follows
+        scratch.planes.resize(static_cast<std::size_t>(width) * 3);
+        std::uint8_t* r = scratch.planes.data();
+        std::uint8_t* g = r + width;
+        std::uint8_t* b = g + width;
+        kernels.deinterleave(image.row(y), width, layout, r, g, b);
+        kernels.hsvPlanar(r, g, b, width, bounds, bits);
+    });
+    return true;
+}
+
+} // namespace vk
@@ -0,0 +1,917 @@
+//
+// 平滑滤波内核 | Smoothing filter kernels
+//
+// 行级原语（float 卷积、列滑动和）按指令集各实现一份，每次调用时根据 simdLevel() 选择一张函数表；
+// 中值滤波的16路直方图运算很短，按指令集内联展开。图像按行分块交给 parallelFor，每块自带工作缓冲。
+// Row primitives exist once per instruction set and a function table is picked from simdLevel() per call;
+// the short 16-bin histogram ops of the median are inlined per ISA instead. Images are split into row bands
+// via parallelFor, each band owning its scratch buffers.
+//
+
+#include "../inc/ImageFilters.h"
+#include "../inc/KernelRuntime.h"
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vk {
+
+namespace {
+
+struct RowKernels {
+    // out[x] = Σ w[k] * ext[x + k]
+    void (*convolveRow)(const float* ext, const float* weights, int taps, float* out, int n);
+    // out[x] = Σ w[k] * rows[k][x]
+    void (*sumRows)(const float* const* rows, const float* weights, int taps, float* out, int n);
+    // sums[x] += add[x] - sub[x]（sub 可为空）| sub may be null
+    void (*updateColumns8)(std::uint32_t* sums, const std::uint8_t* add, const std::uint8_t* sub, int n);
+    void (*updateColumns16)(std::uint32_t* sums, const std::uint16_t* add, const std::uint16_t* sub, int n);
+};
+
+// ---------------------------------------------------------------------------
+// 标量实现（也用于SIMD版本的行尾）| Scalar versions (also handle SIMD row tails)
+// ---------------------------------------------------------------------------
+
+void convolveRowTail(const float* ext, const float* weights, int taps, float* out, int start, int n)
+{
+    for (int x = start; x < n; ++x) {
+        float acc = 0.0f;
+        for (int k = 0; k < taps; ++k) {
+            acc += weights[k] * ext[x + k];
+        }
+        out[x] = acc;
+    }
+}
+
+void sumRowsTail(const float* const* rows, const float* weights, int taps, float* out, int start, int n)
+{
+    for (int x = start; x < n; ++x) {
+        float acc = 0.0f;
+        for (int k = 0; k < taps; ++k) {
+            acc += weights[k] * rows[k][x];
+        }
+        out[x] = acc;
+    }
+}
+
+template <typename T>
+void updateColumnsTail(std::uint32_t* sums, const T* add, const T* sub, int start, int n)
+{
+    if (sub) {
+        for (int x = start; x < n; ++x) {
+            sums[x] += static_cast<std::uint32_t>(add[x]) - static_cast<std::uint32_t>(sub[x]);
+        }
+    } else {
+        for (int x = start; x < n; ++x) {
+            sums[x] += add[x];
+        }
+    }
+}
+
+void convolveRowScalar(const float* ext, const float* weights, int taps, float* out, int n)
+{
+    convolveRowTail(ext, weights, taps, out, 0, n);
+}
+
+void sumRowsScalar(const float* const* rows, const float* weights, int taps, float* out, int n)
+{
+    sumRowsTail(rows, weights, taps, out, 0, n);
+}
+
+void updateColumns8Scalar(std::uint32_t* sums, const std::uint8_t* add, const std::uint8_t* sub, int n)
+{
+    updateColumnsTail(sums, add, sub, 0, n);
+}
+
+void updateColumns16Scalar(std::uint32_t* sums, const std::uint16_t* add, const std::uint16_t* sub, int n)
+{
+    updateColumnsTail(sums, add, sub, 0, n);
+}
+
+const RowKernels kScalarKernels = {
+    convolveRowScalar, sumRowsScalar, updateColumns8Scalar, updateColumns16Scalar
+};
+
+#if defined(VK_HAVE_SSE2)
+// ---------------------------------------------------------------------------
+// SSE2
+// ---------------------------------------------------------------------------
+
+void convolveRowSse2(const float* ext, const float* weights, int taps, float* out, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (int k = 0; k < taps; ++k) {
+            const __m128 w = _mm_set1_ps(weights[k]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(w, _mm_loadu_ps(ext + x + k)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(w, _mm_loadu_ps(ext + x + k + 4)));
+        }
+        _mm_storeu_ps(out + x, acc0);
+        _mm_storeu_ps(out + x + 4, acc1);
+    }
+    convolveRowTail(ext, weights, taps, out, x, n);
+}
+
+void sumRowsSse2(const float* const* rows, const float* weights, int taps, float* out, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (int k = 0; k < taps; ++k) {
+            const __m128 w = _mm_set1_ps(weights[k]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(w, _mm_loadu_ps(rows[k] + x)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(w, _mm_loadu_ps(rows[k] + x + 4)));
+        }
+        _mm_storeu_ps(out + x, acc0);
+        _mm_storeu_ps(out + x + 4, acc1);
+    }
+    sumRowsTail(rows, weights, taps, out, x, n);
+}
+
+inline void addWidened32Sse2(std::uint32_t* sums, __m128i lo16, __m128i hi16, __m128i sublo16, __m128i subhi16)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i* p = reinterpret_cast<__m128i*>(sums);
+    const __m128i d0 = _mm_sub_epi32(_mm_unpacklo_epi16(lo16, zero), _mm_unpacklo_epi16(sublo16, zero));
+    const __m128i d1 = _mm_sub_epi32(_mm_unpackhi_epi16(lo16, zero), _mm_unpackhi_epi16(sublo16, zero));
+    const __m128i d2 = _mm_sub_epi32(_mm_unpacklo_epi16(hi16, zero), _mm_unpacklo_epi16(subhi16, zero));
+    const __m128i d3 = _mm_sub_epi32(_mm_unpackhi_epi16(hi16, zero), _mm_unpackhi_epi16(subhi16, zero));
+    _mm_storeu_si128(p + 0, _mm_add_epi32(_mm_loadu_si128(p + 0), d0));
+    _mm_storeu_si128(p + 1, _mm_add_epi32(_mm_loadu_si128(p + 1), d1));
+    _mm_storeu_si128(p + 2, _mm_add_epi32(_mm_loadu_si128(p + 2), d2));
+    _mm_storeu_si128(p + 3, _mm_add_epi32(_mm_loadu_si128(p + 3), d3));
+}
+
+void updateColumns8Sse2(std::uint32_t* sums, const std::uint8_t* add, const std::uint8_t* sub, int n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + x));
+        const __m128i s = sub ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + x)) : zero;
+        addWidened32Sse2(sums + x, _mm_unpacklo_epi8(a, zero), _mm_unpackhi_epi8(a, zero),
+                         _mm_unpacklo_epi8(s, zero), _mm_unpackhi_epi8(s, zero));
+    }
+    updateColumnsTail(sums, add, sub, x, n);
+}
+
+void updateColumns16Sse2(std::uint32_t* sums, const std::uint16_t* add, const std::uint16_t* sub, int n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + x));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + x + 8));
+        const __m128i s0 = sub ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + x)) : zero;
+        const __m128i s1 = sub ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + x + 8)) : zero;
+        addWidened32Sse2(sums + x, a0, a1, s0, s1);
+    }
+    updateColumnsTail(sums, add, sub, x, n);
+}
+
+const RowKernels kSse2Kernels = {
+    convolveRowSse2, sumRowsSse2, updateColumns8Sse2, updateColumns16Sse2
+};
+#endif
+
+#if defined(VK_HAVE_AVX2)
+// ---------------------------------------------------------------------------
+// AVX2（目标属性编译，运行时选择）| AVX2, compiled via target attribute and selected at runtime
+// ---------------------------------------------------------------------------
+
+VK_TARGET_AVX2 void convolveRowAvx2(const float* ext, const float* weights, int taps, float* out, int n)
+{
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        for (int k = 0; k < taps; ++k) {
+            const __m256 w = _mm256_set1_ps(weights[k]);
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(w, _mm256_loadu_ps(ext + x + k)));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(w, _mm256_loadu_ps(ext + x + k + 8)));
+        }
+        _mm256_storeu_ps(out + x, acc0);
+        _mm256_storeu_ps(out + x + 8, acc1);
+    }
+    convolveRowTail(ext, weights, taps, out, x, n);
+}
+
+VK_TARGET_AVX2 void sumRowsAvx2(const float* const* rows, const float* weights, int taps, float* out, int n)
+{
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        for (int k = 0; k < taps; ++k) {
+            const __m256 w = _mm256_set1_ps(weights[k]);
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(w, _mm256_loadu_ps(rows[k] + x)));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(w, _mm256_loadu_ps(rows[k] + x + 8)));
+        }
+        _mm256_storeu_ps(out + x, acc0);
+        _mm256_storeu_ps(out + x + 8, acc1);
+    }
+    sumRowsTail(rows, weights, taps, out, x, n);
+}
+
+VK_TARGET_AVX2 void updateColumns8Avx2(std::uint32_t* sums, const std::uint8_t* add, const std::uint8_t* sub, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(sums + x);
+        __m256i d = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(add + x)));
+        if (sub) {
+            d = _mm256_sub_epi32(d, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sub + x))));
+        }
+        _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), d));
+    }
+    updateColumnsTail(sums, add, sub, x, n);
+}
+
+VK_TARGET_AVX2 void updateColumns16Avx2(std::uint32_t* sums, const std::uint16_t* add, const std::uint16_t* sub, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(sums + x);
+        __m256i d = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(add + x)));
+        if (sub) {
+            d = _mm256_sub_epi32(d, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + x))));
+        }
+        _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), d));
+    }
+    updateColumnsTail(sums, add, sub, x, n);
+}
+
+const RowKernels kAvx2Kernels = {
+    convolveRowAvx2, sumRowsAvx2, updateColumns8Avx2, updateColumns16Avx2
+};
+#endif
+
+#if defined(VK_HAVE_NEON)
+// ---------------------------------------------------------------------------
+// NEON
+// ---------------------------------------------------------------------------
+
+void convolveRowNeon(const float* ext, const float* weights, int taps, float* out, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        for (int k = 0; k < taps; ++k) {
+            acc0 = vmlaq_n_f32(acc0, vld1q_f32(ext + x + k), weights[k]);
+            acc1 = vmlaq_n_f32(acc1, vld1q_f32(ext + x + k + 4), weights[k]);
+        }
+        vst1q_f32(out + x, acc0);
+        vst1q_f32(out + x + 4, acc1);
+    }
+    convolveRowTail(ext, weights, taps, out, x, n);
+}
+
+void sumRowsNeon(const float* const* rows, const float* weights, int taps, float* out, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        for (int k = 0; k < taps; ++k) {
+            acc0 = vmlaq_n_f32(acc0, vld1q_f32(rows[k] + x), weights[k]);
+            acc1 = vmlaq_n_f32(acc1, vld1q_f32(rows[k] + x + 4), weights[k]);
+        }
+        vst1q_f32(out + x, acc0);
+        vst1q_f32(out + x + 4, acc1);
+    }
+    sumRowsTail(rows, weights, taps, out, x, n);
+}
+
+inline void addWidened32Neon(std::uint32_t* sums, uint16x8_t a, uint16x8_t s)
+{
+    const uint32x4_t d0 = vsubq_u32(vmovl_u16(vget_low_u16(a)), vmovl_u16(vget_low_u16(s)));
+    const uint32x4_t d1 = vsubq_u32(vmovl_u16(vget_high_u16(a)), vmovl_u16(vget_high_u16(s)));
+    vst1q_u32(sums, vaddq_u32(vld1q_u32(sums), d0));
+    vst1q_u32(sums + 4, vaddq_u32(vld1q_u32(sums + 4), d1));
+}
+
+void updateColumns8Neon(std::uint32_t* sums, const std::uint8_t* add, const std::uint8_t* sub, int n)
+{
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const uint8x16_t a = vld1q_u8(add + x);
+        const uint8x16_t s = sub ? vld1q_u8(sub + x) : vdupq_n_u8(0);
+        addWidened32Neon(sums + x, vmovl_u8(vget_low_u8(a)), vmovl_u8(vget_low_u8(s)));
+        addWidened32Neon(sums + x + 8, vmovl_u8(vget_high_u8(a)), vmovl_u8(vget_high_u8(s)));
+    }
+    updateColumnsTail(sums, add, sub, x, n);
+}
+
+void updateColumns16Neon(std::uint32_t* sums, const std::uint16_t* add, const std::uint16_t* sub, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        addWidened32Neon(sums + x, vld1q_u16(add + x), sub ? vld1q_u16(sub + x) : vdupq_n_u16(0));
+    }
+    updateColumnsTail(sums, add, sub, x, n);
+}
+
+const RowKernels kNeonKernels = {
+    convolveRowNeon, sumRowsNeon, updateColumns8Neon, updateColumns16Neon
+};
+#endif
+
+const RowKernels& rowKernels()
+{
+    switch (simdLevel()) {
+#if defined(VK_HAVE_AVX2)
+    case SimdLevel::AVX2: return kAvx2Kernels;
+#endif
+#if defined(VK_HAVE_SSE2)
+    case SimdLevel::SSE2: return kSse2Kernels;
+#endif
+#if defined(VK_HAVE_NEON)
+    case SimdLevel::NEON: return kNeonKernels;
+#endif
+    default: return kScalarKernels;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 公共辅助 | Shared helpers
+// ---------------------------------------------------------------------------
+
+// 区间内坐标直接返回，只有边界附近才走取模 | Only coordinates outside [0, n) pay for the modulo
+inline int mirrorFast(int i, int n)
+{
+    return static_cast<unsigned>(i) < static_cast<unsigned>(n) ? i : mirrorIndex(i, n);
+}
+
+template <typename T>
+bool checkViews(const ImageView<const T>& src, const ImageView<T>& dst)
+{
+    if (!src.isValid() || !dst.isValid() || src.width != dst.width || src.height != dst.height) {
+        return false;
+    }
+    // 按行读邻域，原地处理会读到已写结果 | Neighbourhood reads would see written rows
+    const T* srcBegin = src.data;
+    const T* srcEnd = src.row(src.height - 1) + src.width;
+    const T* dstBegin = dst.data;
+    const T* dstEnd = dst.row(dst.height - 1) + dst.width;
+    return srcEnd <= dstBegin || dstEnd <= srcBegin;
+}
+
+template <typename T>
+inline T saturateRound(float value)
+{
+    const float maxValue = static_cast<float>(static_cast<T>(~T(0)));
+    value += 0.5f;
+    return value <= 0.0f ? T(0) : (value >= maxValue ? static_cast<T>(~T(0)) : static_cast<T>(value));
+}
+
+// ---------------------------------------------------------------------------
+// 高斯 | Gaussian
+// ---------------------------------------------------------------------------
+
+template <typename T>
+bool gaussianImpl(ImageView<const T> src, ImageView<T> dst, double sigma)
+{
+    if (!checkViews(src, dst) || !(sigma > 0.0)) {
+        return false;
+    }
+
+    const int radius = std::max(1, static_cast<int>(std::ceil(3.0 * sigma)));
+    const int taps = 2 * radius + 1;
+    std::vector<float> weights(taps);
+    double weightSum = 0.0;
+    for (int k = 0; k < taps; ++k) {
+        const double d = k - radius;
+        const double w = std::exp(-d * d / (2.0 * sigma * sigma));
+        weights[k] = static_cast<float>(w);
+        weightSum += w;
+    }
+    for (float& w : weights) {
+        w = static_cast<float>(w / weightSum);
+    }
+
+    const int width = src.width;
+    const int height = src.height;
+    const RowKernels& kernels = rowKernels();
+
+    // 每块需要额外计算 2r 行水平结果，块不宜太小 | Each band recomputes 2r halo rows, so keep bands tall
+    parallelFor(0, height, std::max(16, 4 * radius), [&](int y0, int y1) {
+        std::vector<float> ext(static_cast<std::size_t>(width) + 2 * radius);
+        std::vector<float> ring(static_cast<std::size_t>(taps) * width);
+        std::vector<float> acc(width);
+        std::vector<const float*> rows(taps);
+
+        // 水平卷积结果按 (yy - y0 + r) % taps 存入环形缓冲 | Horizontal results live in a ring of taps rows
+        auto filterRow = [&](int yy) {
+            const T* s = src.row(mirrorFast(yy, height));
+            for (int i = 0; i < radius; ++i) {
+                ext[i] = s[mirrorIndex(i - radius, width)];
+                ext[static_cast<std::size_t>(width) + radius + i] = s[mirrorIndex(width + i, width)];
+            }
+            for (int x = 0; x < width; ++x) {
+                ext[static_cast<std::size_t>(radius) + x] = s[x];
+            }
+            float* out = &ring[static_cast<std::size_t>((yy - y0 + radius) % taps) * width];
+            kernels.convolveRow(ext.data(), weights.data(), taps, out, width);
+        };
+
+        for (int yy = y0 - radius; yy <= y0 + radius; ++yy) {
+            filterRow(yy);
+        }
+        for (int y = y0; y < y1; ++y) {
+            for (int k = 0; k < taps; ++k) {
+                rows[k] = &ring[static_cast<std::size_t>((y - y0 + k) % taps) * width];
+            }
+            kernels.sumRows(rows.data(), weights.data(), taps, acc.data(), width);
+            T* d = dst.row(y);
+            for (int x = 0; x < width; ++x) {
+                d[x] = saturateRound<T>(acc[x]);
+            }
+            if (y + 1 < y1) {
+                filterRow(y + radius + 1);   // 覆盖 y-r 所在槽位 | Reuses the slot of row y-r
+            }
+        }
+    });
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 均值 | Box
+// ---------------------------------------------------------------------------
+
+inline void updateColumns(const RowKernels& k, std::uint32_t* sums, const std::uint8_t* add, const std::uint8_t* sub, int n)
+{
+    k.updateColumns8(sums, add, sub, n);
+}
+
+inline void updateColumns(const RowKernels& k, std::uint32_t* sums, const std::uint16_t* add, const std::uint16_t* sub, int n)
+{
+    k.updateColumns16(sums, add, sub, n);
+}
+
+template <typename T>
+bool boxImpl(ImageView<const T> src, ImageView<T> dst, int maskWidth, int maskHeight)
+{
+    if (!checkViews(src, dst) || maskWidth < 1 || maskHeight < 1) {
+        return false;
+    }
+
+    const int width = src.width;
+    const int height = src.height;
+    // 偶数尺寸时中心偏左上，与 Halcon 一致 | Even sizes put the centre up/left as Halcon does
+    const int left = maskWidth / 2;
+    const int right = maskWidth - 1 - left;
+    const int top = maskHeight / 2;
+    const int bottom = maskHeight - 1 - top;
+    const double invArea = 1.0 / (static_cast<double>(maskWidth) * maskHeight);
+    const RowKernels& kernels = rowKernels();
+
+    parallelFor(0, height, std::max(16, 2 * maskHeight), [&](int y0, int y1) {
+        std::vector<std::uint32_t> columns(width, 0);
+        for (int yy = y0 - top; yy <= y0 + bottom; ++yy) {
+            updateColumns(kernels, columns.data(), src.row(mirrorFast(yy, height)), static_cast<const T*>(nullptr), width);
+        }
+
+        for (int y = y0; y < y1; ++y) {
+            if (y > y0) {
+                updateColumns(kernels, columns.data(), src.row(mirrorFast(y + bottom, height)),
+                              src.row(mirrorFast(y - top - 1, height)), width);
+            }
+
+            std::uint64_t sum = 0;
+            for (int x = -left; x <= right; ++x) {
+                sum += columns[mirrorFast(x, width)];
+            }
+            T* d = dst.row(y);
+            d[0] = static_cast<T>(sum * invArea + 0.5);
+            for (int x = 1; x < width; ++x) {
+                sum += columns[mirrorFast(x + right, width)];
+                sum -= columns[mirrorFast(x - left - 1, width)];
+                d[x] = static_cast<T>(sum * invArea + 0.5);
+            }
+        }
+    });
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 中值 | Median
+// ---------------------------------------------------------------------------
+
+// 直方图布局：16个粗桶 + 256个细桶，细桶段 c 从 kCoarseBins + 16c 开始
+// Histogram layout: 16 coarse bins followed by 256 fine bins; fine segment c starts at kCoarseBins + 16c
+constexpr int kCoarseBins = 16;
+constexpr int kHistBins = kCoarseBins + 256;
+// SIMD 秩查找使用有符号16位比较，掩膜像素数不能超过该值 | Signed 16-bit compares cap the mask size
+constexpr int kMaxBins16Count = 32767;
+
+inline int lowestSetBit(unsigned value)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+/**
+ * 16个16位计数的加减与秩查找，按指令集内联展开 | Add/sub/rank lookup on 16 u16 counters, inlined per ISA
+ * find: 返回累计计数首次超过 rank 的桶，acc 累加该桶之前的计数 | Returns the first bin whose cumulative
+ * count exceeds rank; acc accumulates the counts before it
+ */
+struct Bins16Scalar {
+    static void add(std::uint16_t* dst, const std::uint16_t* src)
+    {
+        for (int i = 0; i < 16; ++i) {
+            dst[i] = static_cast<std::uint16_t>(dst[i] + src[i]);
+        }
+    }
+    static void sub(std::uint16_t* dst, const std::uint16_t* src)
+    {
+        for (int i = 0; i < 16; ++i) {
+            dst[i] = static_cast<std::uint16_t>(dst[i] - src[i]);
+        }
+    }
+    static int find(const std::uint16_t* bins, int rank, int& acc)
+    {
+        int i = 0;
+        while (acc + bins[i] <= rank) {
+            acc += bins[i];
+            ++i;
+        }
+        return i;
+    }
+};
+
+#if defined(VK_HAVE_SSE2)
+// AVX2 对16个计数没有额外收益，AVX2 级别也使用该实现 | AVX2 gains nothing on 16 counters; used for AVX2 too
+struct Bins16Sse2 {
+    static void add(std::uint16_t* dst, const std::uint16_t* src)
+    {
+        __m128i* d = reinterpret_cast<__m128i*>(dst);
+        const __m128i* s = reinterpret_cast<const __m128i*>(src);
+        _mm_storeu_si128(d, _mm_add_epi16(_mm_loadu_si128(d), _mm_loadu_si128(s)));
+        _mm_storeu_si128(d + 1, _mm_add_epi16(_mm_loadu_si128(d + 1), _mm_loadu_si128(s + 1)));
+    }
+    static void sub(std::uint16_t* dst, const std::uint16_t* src)
+    {
+        __m128i* d = reinterpret_cast<__m128i*>(dst);
+        const __m128i* s = reinterpret_cast<const __m128i*>(src);
+        _mm_storeu_si128(d, _mm_sub_epi16(_mm_loadu_si128(d), _mm_loadu_si128(s)));
+        _mm_storeu_si128(d + 1, _mm_sub_epi16(_mm_loadu_si128(d + 1), _mm_loadu_si128(s + 1)));
+    }
+    // 前缀和 + 比较 + 位扫描，无数据相关分支 | Prefix sum, compare and bit scan without data-dependent branches
+    static int find(const std::uint16_t* bins, int rank, int& acc)
+    {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bins));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bins + 8));
+        low = _mm_add_epi16(low, _mm_slli_si128(low, 2));
+        high = _mm_add_epi16(high, _mm_slli_si128(high, 2));
+        low = _mm_add_epi16(low, _mm_slli_si128(low, 4));
+        high = _mm_add_epi16(high, _mm_slli_si128(high, 4));
+        low = _mm_add_epi16(low, _mm_slli_si128(low, 8));
+        high = _mm_add_epi16(high, _mm_slli_si128(high, 8));
+        __m128i lowTotal = _mm_shufflehi_epi16(low, 0xFF);
+        lowTotal = _mm_unpackhi_epi64(lowTotal, lowTotal);
+        high = _mm_add_epi16(high, lowTotal);
+
+        const __m128i limit = _mm_set1_epi16(static_cast<short>(rank - acc));
+        const __m128i above = _mm_packs_epi16(_mm_cmpgt_epi16(low, limit), _mm_cmpgt_epi16(high, limit));
+        const int index = lowestSetBit(static_cast<unsigned>(_mm_movemask_epi8(above)));
+        if (index > 0) {
+            alignas(16) std::uint16_t prefix[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(prefix), low);
+            _mm_store_si128(reinterpret_cast<__m128i*>(prefix + 8), high);
+            acc += prefix[index - 1];
+        }
+        return index;
+    }
+};
+#endif
+
+#if defined(VK_HAVE_NEON)
+struct Bins16Neon {
+    static void add(std::uint16_t* dst, const std::uint16_t* src)
+    {
+        vst1q_u16(dst, vaddq_u16(vld1q_u16(dst), vld1q_u16(src)));
+        vst1q_u16(dst + 8, vaddq_u16(vld1q_u16(dst + 8), vld1q_u16(src + 8)));
+    }
+    static void sub(std::uint16_t* dst, const std::uint16_t* src)
+    {
+        vst1q_u16(dst, vsubq_u16(vld1q_u16(dst), vld1q_u16(src)));
+        vst1q_u16(dst + 8, vsubq_u16(vld1q_u16(dst + 8), vld1q_u16(src + 8)));
+    }
+    static int find(const std::uint16_t* bins, int rank, int& acc)
+    {
+        return Bins16Scalar::find(bins, rank, acc);
+    }
+};
+#endif
+
+inline void addPixel8(std::uint16_t* hist, std::uint8_t value)
+{
+    ++hist[value >> 4];
+    ++hist[kCoarseBins + value];
+}
+
+inline void removePixel8(std::uint16_t* hist, std::uint8_t value)
+{
+    --hist[value >> 4];
+    --hist[kCoarseBins + value];
+}
+
+/**
+ * 8位方形掩膜（Perreault–Hébert）：每列一个 2r+1 像素的直方图，行下移时每列只加减一个像素。
+ * 核直方图的16个粗桶逐像素滑动；细桶按段延迟更新，只有中值所在的段才补齐到当前列，
+ * 落后超过掩膜宽度时直接重算该段。
+ * Each column keeps a histogram of its 2r+1 pixels; moving down touches one pixel per column. The 16 coarse
+ * kernel bins slide every pixel; fine segments are updated lazily, only for the segment that holds the median,
+ * and rebuilt outright when they are more than a mask width behind.
+ */
+template <typename Bins>
+void medianSquare8(ConstView8 src, View8 dst, int radius)
+{
+    const int width = src.width;
+    const int height = src.height;
+    const int side = 2 * radius + 1;
+    const int rank = side * side / 2;
+
+    parallelFor(0, height, std::max(16, 2 * side), [&](int y0, int y1) {
+        std::vector<std::uint16_t> columns(static_cast<std::size_t>(width) * kHistBins, 0);
+        std::uint16_t coarse[kCoarseBins];
+        std::uint16_t fine[kCoarseBins][16];
+        int syncedAt[kCoarseBins];   // 各细桶段已同步到的列 | Column each fine segment is synced to
+        auto column = [&](int x) { return &columns[static_cast<std::size_t>(mirrorFast(x, width)) * kHistBins]; };
+
+        for (int yy = y0 - radius; yy <= y0 + radius; ++yy) {
+            const std::uint8_t* s = src.row(mirrorFast(yy, height));
+            for (int x = 0; x < width; ++x) {
+                addPixel8(&columns[static_cast<std::size_t>(x) * kHistBins], s[x]);
+            }
+        }
+
+        for (int y = y0; y < y1; ++y) {
+            if (y > y0) {
+                const std::uint8_t* leaving = src.row(mirrorFast(y - radius - 1, height));
+                const std::uint8_t* entering = src.row(mirrorFast(y + radius, height));
+                for (int x = 0; x < width; ++x) {
+                    std::uint16_t* h = &columns[static_cast<std::size_t>(x) * kHistBins];
+                    removePixel8(h, leaving[x]);
+                    addPixel8(h, entering[x]);
+                }
+            }
+
+            std::fill(coarse, coarse + kCoarseBins, std::uint16_t(0));
+            for (int dx = -radius; dx <= radius; ++dx) {
+                Bins::add(coarse, column(dx));
+            }
+            std::fill(syncedAt, syncedAt + kCoarseBins, -side - 1);
+
+            std::uint8_t* d = dst.row(y);
+            for (int x = 0; x < width; ++x) {
+                if (x > 0) {
+                    Bins::add(coarse, column(x + radius));
+                    Bins::sub(coarse, column(x - radius - 1));
+                }
+
+                int acc = 0;
+                const int c = Bins::find(coarse, rank, acc);
+                std::uint16_t* segment = fine[c];
+                const int offset = kCoarseBins + c * 16;
+                if (x - syncedAt[c] > side) {
+                    std::fill(segment, segment + 16, std::uint16_t(0));
+                    for (int dx = -radius; dx <= radius; ++dx) {
+                        Bins::add(segment, column(x + dx) + offset);
+                    }
+                } else {
+                    for (int j = syncedAt[c] + 1; j <= x; ++j) {
+                        Bins::add(segment, column(j + radius) + offset);
+                        Bins::sub(segment, column(j - radius - 1) + offset);
+                    }
+                }
+                syncedAt[c] = x;
+
+                d[x] = static_cast<std::uint8_t>(c * 16 + Bins::find(segment, rank, acc));
+            }
+        }
+    });
+}
+
+/**
+ * 8位滑动直方图（Huang）：沿行移动时每个掩膜行加减一个像素，支持任意行半宽（圆形）。
+ * Sliding histogram: moving right adds/removes one pixel per mask row, so any per-row half width works.
+ */
+template <typename Bins>
+void medianSliding8(ConstView8 src, View8 dst, int radius, const std::vector<int>& halfWidths, int count)
+{
+    const int width = src.width;
+    const int height = src.height;
+    const int rank = count / 2;
+
+    parallelFor(0, height, 16, [&](int y0, int y1) {
+        std::vector<std::uint16_t> hist(kHistBins, 0);
+        std::vector<const std::uint8_t*> rows(2 * radius + 1);
+
+        for (int y = y0; y < y1; ++y) {
+            for (int dy = -radius; dy <= radius; ++dy) {
+                rows[dy + radius] = src.row(mirrorFast(y + dy, height));
+            }
+            for (int i = 0; i <= 2 * radius; ++i) {
+                for (int dx = -halfWidths[i]; dx <= halfWidths[i]; ++dx) {
+                    addPixel8(hist.data(), rows[i][mirrorFast(dx, width)]);
+                }
+            }
+            std::uint8_t* d = dst.row(y);
+            for (int x = 0; x < width; ++x) {
+                if (x > radius && x + radius < width) {
+                    // 内部区域无需镜像 | No mirroring away from the borders
+                    for (int i = 0; i <= 2 * radius; ++i) {
+                        removePixel8(hist.data(), rows[i][x - 1 - halfWidths[i]]);
+                        addPixel8(hist.data(), rows[i][x + halfWidths[i]]);
+                    }
+                } else if (x > 0) {
+                    for (int i = 0; i <= 2 * radius; ++i) {
+                        removePixel8(hist.data(), rows[i][mirrorFast(x - 1 - halfWidths[i], width)]);
+                        addPixel8(hist.data(), rows[i][mirrorFast(x + halfWidths[i], width)]);
+                    }
+                }
+                int acc = 0;
+                const int c = Bins::find(hist.data(), rank, acc);
+                d[x] = static_cast<std::uint8_t>(c * 16 + Bins::find(hist.data() + kCoarseBins + c * 16, rank, acc));
+            }
+            // 移除行末窗口 | Remove the last window so the histogram is empty again
+            for (int i = 0; i <= 2 * radius; ++i) {
+                for (int dx = -halfWidths[i]; dx <= halfWidths[i]; ++dx) {
+                    removePixel8(hist.data(), rows[i][mirrorFast(width - 1 + dx, width)]);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * 通用滑动直方图（32位计数）：16位图像，以及超出16位计数的大掩膜。
+ * 两级直方图：粗桶定位后只扫描一个细桶段。
+ * Generic sliding histogram with 32-bit counts: 16-bit images and masks too large for 16-bit counters.
+ */
+template <typename T, int FineBits, int CoarseShift>
+void medianSliding(ImageView<const T> src, ImageView<T> dst, int radius, const std::vector<int>& halfWidths, int count)
+{
+    const int width = src.width;
+    const int height = src.height;
+    const int fineBins = 1 << FineBits;
+    const int coarseBins = fineBins >> CoarseShift;
+    const int segment = 1 << CoarseShift;
+    const int rank = count / 2;
+
+    parallelFor(0, height, 16, [&](int y0, int y1) {
+        std::vector<std::uint32_t> fine(fineBins, 0);
+        std::vector<std::uint32_t> coarse(coarseBins, 0);
+        std::vector<const T*> rows(2 * radius + 1);
+
+        auto add = [&](T v) { ++fine[v]; ++coarse[v >> CoarseShift]; };
+        auto remove = [&](T v) { --fine[v]; --coarse[v >> CoarseShift]; };
+        auto median = [&]() {
+            int acc = 0;
+            int c = 0;
+            while (acc + static_cast<int>(coarse[c]) <= rank) {
+                acc += coarse[c];
+                ++c;
+            }
+            int v = c * segment;
+            while (acc + static_cast<int>(fine[v]) <= rank) {
+                acc += fine[v];
+                ++v;
+            }
+            return static_cast<T>(v);
+        };
+
+        for (int y = y0; y < y1; ++y) {
+            for (int dy = -radius; dy <= radius; ++dy) {
+                rows[dy + radius] = src.row(mirrorFast(y + dy, height));
+            }
+            for (int i = 0; i <= 2 * radius; ++i) {
+                for (int dx = -halfWidths[i]; dx <= halfWidths[i]; ++dx) {
+                    add(rows[i][mirrorFast(dx, width)]);
+                }
+            }
+            T* d = dst.row(y);
+            d[0] = median();
+            for (int x = 1; x < width; ++x) {
+                for (int i = 0; i <= 2 * radius; ++i) {
+                    remove(rows[i][mirrorFast(x - 1 - halfWidths[i], width)]);
+                    add(rows[i][mirrorFast(x + halfWidths[i], width)]);
+                }
+                d[x] = median();
+            }
+            // 移除行末窗口，比清零 65536 个桶便宜 | Removing the last window is cheaper than clearing the bins
+            for (int i = 0; i <= 2 * radius; ++i) {
+                for (int dx = -halfWidths[i]; dx <= halfWidths[i]; ++dx) {
+                    remove(rows[i][mirrorFast(width - 1 + dx, width)]);
+                }
+            }
+        }
+    });
+}
+
+std::vector<int> maskHalfWidths(int radius, MedianMask mask)
+{
+    std::vector<int> halfWidths(2 * radius + 1, radius);
+    if (mask == MedianMask::Circle) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            halfWidths[dy + radius] = static_cast<int>(std::floor(std::sqrt(double(radius) * radius - double(dy) * dy) + 0.5));
+        }
+    }
+    return halfWidths;
+}
+
+int maskCount(const std::vector<int>& halfWidths)
+{
+    int count = 0;
+    for (int hw : halfWidths) {
+        count += 2 * hw + 1;
+    }
+    return count;
+}
+
+template <typename Bins>
+void median8(ConstView8 src, View8 dst, int radius, MedianMask mask, const std::vector<int>& halfWidths, int count)
+{
+    if (mask == MedianMask::Square) {
+        medianSquare8<Bins>(src, dst, radius);
+    } else {
+        medianSliding8<Bins>(src, dst, radius, halfWidths, count);
+    }
+}
+
+} // namespace
+
+bool gaussianFilter(ConstView8 src, View8 dst, double sigma)
+{
+    return gaussianImpl(src, dst, sigma);
+}
+
+bool gaussianFilter(ConstView16 src, View16 dst, double sigma)
+{
+    return gaussianImpl(src, dst, sigma);
+}
+
+bool boxFilter(ConstView8 src, View8 dst, int maskWidth, int maskHeight)
+{
+    return boxImpl(src, dst, maskWidth, maskHeight);
+}
+
+bool boxFilter(ConstView16 src, View16 dst, int maskWidth, int maskHeight)
+{
+    return boxImpl(src, dst, maskWidth, maskHeight);
+}
+
+bool medianFilter(ConstView8 src, View8 dst, int radius, MedianMask mask)
+{
+    if (!checkViews(src, dst) || radius < 1) {
+        return false;
+    }
+    const std::vector<int> halfWidths = maskHalfWidths(radius, mask);
+    const int count = maskCount(halfWidths);
+    if (count > kMaxBins16Count) {
+        medianSliding<std::uint8_t, 8, 4>(src, dst, radius, halfWidths, count);
+        return true;
+    }
+
+    switch (simdLevel()) {
+#if defined(VK_HAVE_SSE2)
+    case SimdLevel::SSE2:
+    case SimdLevel::AVX2:
+        median8<Bins16Sse2>(src, dst, radius, mask, halfWidths, count);
+        break;
+#endif
+#if defined(VK_HAVE_NEON)
+    case SimdLevel::NEON:
+        median8<Bins16Neon>(src, dst, radius, mask, halfWidths, count);
+        break;
+#endif
+    default:
+        median8<Bins16Scalar>(src, dst, radius, mask, halfWidths, count);
+        break;
+    }
+    return true;
+}
+
+bool medianFilter(ConstView16 src, View16 dst, int radius, MedianMask mask)
+{
+    if (!checkViews(src, dst) || radius < 1) {
+        return false;
+    }
+    const std::vector<int> halfWidths = maskHalfWidths(radius, mask);
+    medianSliding<std::uint16_t, 16, 8>(src, dst, radius, halfWidths, maskCount(halfWidths));
+    return true;
+}
+
+} // namespace vk
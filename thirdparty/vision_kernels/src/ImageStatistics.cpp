@@ -0,0 +1,655 @@
+//
+// 单次遍历图像统计 | Single-pass image statistics
+//
+// 每行（或每段行程）只读一次：SIMD 原语累加和、平方和、最小/最大值，随后趁该行仍在L1缓存中
+// 更新直方图（4个子直方图交错，减少同一桶连续写的依赖）和 3x3 清晰度响应。
+// Each row or run is read once: SIMD primitives accumulate sum, sum of squares and min/max, then the histogram
+// (four interleaved sub-histograms to break store dependencies) and the 3x3 sharpness responses are updated
+// while the row is still in L1.
+//
+
+#include "../inc/ImageStatistics.h"
+#include "../inc/KernelRuntime.h"
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <mutex>
+
+namespace vk {
+
+namespace {
+
+struct RowSums {
+    std::uint64_t sum = 0;
+    std::uint64_t sumSq = 0;
+    int minValue = INT_MAX;
+    int maxValue = INT_MIN;
+};
+
+struct SharpSums {
+    std::uint64_t count = 0;
+    std::int64_t laplacianSum = 0;
+    std::uint64_t laplacianSq = 0;
+    std::uint64_t gradientSq = 0;
+};
+
+struct StatsKernels {
+    // 累加 p[0, n) | Accumulate p[0, n)
+    void (*rowSums8)(const std::uint8_t* p, int n, RowSums& out);
+    // 累加 x ∈ [begin, end) 的 3x3 响应，调用方保证 x-1 和 x+1 在图像内 | x-1 and x+1 must be inside the image
+    void (*sharpRow8)(const std::uint8_t* up, const std::uint8_t* mid, const std::uint8_t* down, int begin, int end,
+                      SharpSums& out);
+};
+
+// ---------------------------------------------------------------------------
+// 标量 | Scalar
+// ---------------------------------------------------------------------------
+
+template <typename T>
+void rowSumsTail(const T* p, int start, int n, RowSums& out)
+{
+    std::uint64_t sum = 0;
+    std::uint64_t sumSq = 0;
+    int minValue = out.minValue;
+    int maxValue = out.maxValue;
+    for (int x = start; x < n; ++x) {
+        const int v = p[x];
+        sum += static_cast<std::uint64_t>(v);
+        sumSq += static_cast<std::uint64_t>(v) * static_cast<std::uint64_t>(v);
+        minValue = std::min(minValue, v);
+        maxValue = std::max(maxValue, v);
+    }
+    out.sum += sum;
+    out.sumSq += sumSq;
+    out.minValue = minValue;
+    out.maxValue = maxValue;
+}
+
+template <typename T>
+void sharpRowTail(const T* up, const T* mid, const T* down, int begin, int end, SharpSums& out)
+{
+    for (int x = begin; x < end; ++x) {
+        const std::int64_t laplacian = 4 * static_cast<std::int64_t>(mid[x]) - up[x] - down[x] - mid[x - 1] - mid[x + 1];
+        const std::int64_t gx = (static_cast<std::int64_t>(up[x + 1]) + 2 * mid[x + 1] + down[x + 1])
+                                - (static_cast<std::int64_t>(up[x - 1]) + 2 * mid[x - 1] + down[x - 1]);
+        const std::int64_t gy = (static_cast<std::int64_t>(down[x - 1]) + 2 * down[x] + down[x + 1])
+                                - (static_cast<std::int64_t>(up[x - 1]) + 2 * up[x] + up[x + 1]);
+        out.laplacianSum += laplacian;
+        out.laplacianSq += static_cast<std::uint64_t>(laplacian * laplacian);
+        out.gradientSq += static_cast<std::uint64_t>(gx * gx + gy * gy);
+    }
+    out.count += static_cast<std::uint64_t>(std::max(0, end - begin));
+}
+
+void rowSums8Scalar(const std::uint8_t* p, int n, RowSums& out)
+{
+    rowSumsTail(p, 0, n, out);
+}
+
+void sharpRow8Scalar(const std::uint8_t* up, const std::uint8_t* mid, const std::uint8_t* down, int begin, int end,
+                     SharpSums& out)
+{
+    sharpRowTail(up, mid, down, begin, end, out);
+}
+
+const StatsKernels kScalarStats = {rowSums8Scalar, sharpRow8Scalar};
+
+// 32位通道的块内累加上限：平方和每次迭代每通道最多 4*255²，拉普拉斯平方与梯度平方最多 4*1020²
+// Iterations per block before 32-bit lanes could overflow
+constexpr int kSquareBlock = 4096;
+constexpr int kSharpBlock = 256;
+
+template <typename Lane>
+std::int64_t sumLanes(const Lane* lanes, int count)
+{
+    std::int64_t total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += lanes[i];
+    }
+    return total;
+}
+
+#if defined(VK_HAVE_SSE2)
+// ---------------------------------------------------------------------------
+// SSE2
+// ---------------------------------------------------------------------------
+
+inline std::int64_t sumEpi32Sse2(__m128i v)
+{
+    alignas(16) std::int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return sumLanes(lanes, 4);
+}
+
+void rowSums8Sse2(const std::uint8_t* p, int n, RowSums& out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vmin = _mm_set1_epi8(static_cast<char>(0xFF));
+    __m128i vmax = zero;
+    __m128i vsum = zero;
+    int x = 0;
+    while (x + 16 <= n) {
+        const int blockLimit = std::min(n, x + 16 * kSquareBlock);
+        __m128i vsq = zero;
+        for (; x + 16 <= blockLimit; x += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + x));
+            vmin = _mm_min_epu8(vmin, v);
+            vmax = _mm_max_epu8(vmax, v);
+            vsum = _mm_add_epi64(vsum, _mm_sad_epu8(v, zero));
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            vsq = _mm_add_epi32(vsq, _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+        }
+        out.sumSq += static_cast<std::uint64_t>(sumEpi32Sse2(vsq));
+    }
+
+    if (x > 0) {
+        alignas(16) std::uint8_t mins[16];
+        alignas(16) std::uint8_t maxs[16];
+        alignas(16) std::uint64_t sums[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(mins), vmin);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vmax);
+        _mm_store_si128(reinterpret_cast<__m128i*>(sums), vsum);
+        out.sum += sums[0] + sums[1];
+        out.minValue = std::min<int>(out.minValue, *std::min_element(mins, mins + 16));
+        out.maxValue = std::max<int>(out.maxValue, *std::max_element(maxs, maxs + 16));
+    }
+    rowSumsTail(p, x, n, out);
+}
+
+void sharpRow8Sse2(const std::uint8_t* up, const std::uint8_t* mid, const std::uint8_t* down, int begin, int end,
+                   SharpSums& out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    auto load8 = [&zero](const std::uint8_t* q) {
+        return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q)), zero);
+    };
+
+    int x = begin;
+    while (x + 8 <= end) {
+        const int blockLimit = std::min(end, x + 8 * kSharpBlock);
+        __m128i vlap = zero;
+        __m128i vlapSq = zero;
+        __m128i vgrad = zero;
+        for (; x + 8 <= blockLimit; x += 8) {
+            const __m128i ul = load8(up + x - 1), u = load8(up + x), ur = load8(up + x + 1);
+            const __m128i l = load8(mid + x - 1), c = load8(mid + x), r = load8(mid + x + 1);
+            const __m128i dl = load8(down + x - 1), d = load8(down + x), dr = load8(down + x + 1);
+            const __m128i lap = _mm_sub_epi16(_mm_slli_epi16(c, 2), _mm_add_epi16(_mm_add_epi16(u, d), _mm_add_epi16(l, r)));
+            const __m128i gx = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(ur, dr), _mm_slli_epi16(r, 1)),
+                                             _mm_add_epi16(_mm_add_epi16(ul, dl), _mm_slli_epi16(l, 1)));
+            const __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(dl, dr), _mm_slli_epi16(d, 1)),
+                                             _mm_add_epi16(_mm_add_epi16(ul, ur), _mm_slli_epi16(u, 1)));
+            vlap = _mm_add_epi32(vlap, _mm_madd_epi16(lap, ones));
+            vlapSq = _mm_add_epi32(vlapSq, _mm_madd_epi16(lap, lap));
+            vgrad = _mm_add_epi32(vgrad, _mm_add_epi32(_mm_madd_epi16(gx, gx), _mm_madd_epi16(gy, gy)));
+        }
+        out.laplacianSum += sumEpi32Sse2(vlap);
+        out.laplacianSq += static_cast<std::uint64_t>(sumEpi32Sse2(vlapSq));
+        out.gradientSq += static_cast<std::uint64_t>(sumEpi32Sse2(vgrad));
+    }
+    out.count += static_cast<std::uint64_t>(x - begin);
+    sharpRowTail(up, mid, down, x, end, out);
+}
+
+const StatsKernels kSse2Stats = {rowSums8Sse2, sharpRow8Sse2};
+#endif
+
+#if defined(VK_HAVE_AVX2)
+// ---------------------------------------------------------------------------
+// AVX2
+// ---------------------------------------------------------------------------
+
+VK_TARGET_AVX2 inline std::int64_t sumEpi32Avx2(__m256i v)
+{
+    alignas(32) std::int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return sumLanes(lanes, 8);
+}
+
+VK_TARGET_AVX2 void rowSums8Avx2(const std::uint8_t* p, int n, RowSums& out)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vmin = _mm256_set1_epi8(static_cast<char>(0xFF));
+    __m256i vmax = zero;
+    __m256i vsum = zero;
+    int x = 0;
+    while (x + 32 <= n) {
+        const int blockLimit = std::min(n, x + 32 * kSquareBlock);
+        __m256i vsq = zero;
+        for (; x + 32 <= blockLimit; x += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + x));
+            vmin = _mm256_min_epu8(vmin, v);
+            vmax = _mm256_max_epu8(vmax, v);
+            vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(v, zero));
+            const __m256i lo = _mm256_unpacklo_epi8(v, zero);
+            const __m256i hi = _mm256_unpackhi_epi8(v, zero);
+            vsq = _mm256_add_epi32(vsq, _mm256_add_epi32(_mm256_madd_epi16(lo, lo), _mm256_madd_epi16(hi, hi)));
+        }
+        out.sumSq += static_cast<std::uint64_t>(sumEpi32Avx2(vsq));
+    }
+
+    if (x > 0) {
+        alignas(32) std::uint8_t mins[32];
+        alignas(32) std::uint8_t maxs[32];
+        alignas(32) std::uint64_t sums[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(mins), vmin);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), vmax);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), vsum);
+        out.sum += sums[0] + sums[1] + sums[2] + sums[3];
+        out.minValue = std::min<int>(out.minValue, *std::min_element(mins, mins + 32));
+        out.maxValue = std::max<int>(out.maxValue, *std::max_element(maxs, maxs + 32));
+    }
+    rowSumsTail(p, x, n, out);
+}
+
+VK_TARGET_AVX2 inline __m256i load16Avx2(const std::uint8_t* q)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(q)));
+}
+
+VK_TARGET_AVX2 void sharpRow8Avx2(const std::uint8_t* up, const std::uint8_t* mid, const std::uint8_t* down, int begin,
+                                  int end, SharpSums& out)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    int x = begin;
+    while (x + 16 <= end) {
+        const int blockLimit = std::min(end, x + 16 * kSharpBlock);
+        __m256i vlap = zero;
+        __m256i vlapSq = zero;
+        __m256i vgrad = zero;
+        for (; x + 16 <= blockLimit; x += 16) {
+            const __m256i ul = load16Avx2(up + x - 1), u = load16Avx2(up + x), ur = load16Avx2(up + x + 1);
+            const __m256i l = load16Avx2(mid + x - 1), c = load16Avx2(mid + x), r = load16Avx2(mid + x + 1);
+            const __m256i dl = load16Avx2(down + x - 1), d = load16Avx2(down + x), dr = load16Avx2(down + x + 1);
+            const __m256i lap = _mm256_sub_epi16(_mm256_slli_epi16(c, 2),
+                                                 _mm256_add_epi16(_mm256_add_epi16(u, d), _mm256_add_epi16(l, r)));
+            const __m256i gx = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(ur, dr), _mm256_slli_epi16(r, 1)),
+                                                _mm256_add_epi16(_mm256_add_epi16(ul, dl), _mm256_slli_epi16(l, 1)));
+            const __m256i gy = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(dl, dr), _mm256_slli_epi16(d, 1)),
+                                                _mm256_add_epi16(_mm256_add_epi16(ul, ur), _mm256_slli_epi16(u, 1)));
+            vlap = _mm256_add_epi32(vlap, _mm256_madd_epi16(lap, ones));
+            vlapSq = _mm256_add_epi32(vlapSq, _mm256_madd_epi16(lap, lap));
+            vgrad = _mm256_add_epi32(vgrad, _mm256_add_epi32(_mm256_madd_epi16(gx, gx), _mm256_madd_epi16(gy, gy)));
+        }
+        out.laplacianSum += sumEpi32Avx2(vlap);
+        out.laplacianSq += static_cast<std::uint64_t>(sumEpi32Avx2(vlapSq));
+        out.gradientSq += static_cast<std::uint64_t>(sumEpi32Avx2(vgrad));
+    }
+    out.count += static_cast<std::uint64_t>(x - begin);
+    sharpRowTail(up, mid, down, x, end, out);
+}
+
+const StatsKernels kAvx2Stats = {rowSums8Avx2, sharpRow8Avx2};
+#endif
+
+#if defined(VK_HAVE_NEON)
+// ---------------------------------------------------------------------------
+// NEON
+// ---------------------------------------------------------------------------
+
+void rowSums8Neon(const std::uint8_t* p, int n, RowSums& out)
+{
+    uint8x16_t vmin = vdupq_n_u8(0xFF);
+    uint8x16_t vmax = vdupq_n_u8(0);
+    int x = 0;
+    while (x + 16 <= n) {
+        const int blockLimit = std::min(n, x + 16 * kSquareBlock);
+        uint32x4_t vsum = vdupq_n_u32(0);
+        uint32x4_t vsq = vdupq_n_u32(0);
+        for (; x + 16 <= blockLimit; x += 16) {
+            const uint8x16_t v = vld1q_u8(p + x);
+            vmin = vminq_u8(vmin, v);
+            vmax = vmaxq_u8(vmax, v);
+            vsum = vpadalq_u16(vsum, vpaddlq_u8(v));
+            vsq = vpadalq_u16(vsq, vmull_u8(vget_low_u8(v), vget_low_u8(v)));
+            vsq = vpadalq_u16(vsq, vmull_u8(vget_high_u8(v), vget_high_u8(v)));
+        }
+        std::uint32_t sums[4];
+        std::uint32_t squares[4];
+        vst1q_u32(sums, vsum);
+        vst1q_u32(squares, vsq);
+        out.sum += static_cast<std::uint64_t>(sumLanes(sums, 4));
+        out.sumSq += static_cast<std::uint64_t>(sumLanes(squares, 4));
+    }
+
+    if (x > 0) {
+        std::uint8_t mins[16];
+        std::uint8_t maxs[16];
+        vst1q_u8(mins, vmin);
+        vst1q_u8(maxs, vmax);
+        out.minValue = std::min<int>(out.minValue, *std::min_element(mins, mins + 16));
+        out.maxValue = std::max<int>(out.maxValue, *std::max_element(maxs, maxs + 16));
+    }
+    rowSumsTail(p, x, n, out);
+}
+
+void sharpRow8Neon(const std::uint8_t* up, const std::uint8_t* mid, const std::uint8_t* down, int begin, int end,
+                   SharpSums& out)
+{
+    auto load8 = [](const std::uint8_t* q) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(q))); };
+
+    int x = begin;
+    while (x + 8 <= end) {
+        const int blockLimit = std::min(end, x + 8 * kSharpBlock);
+        int32x4_t vlap = vdupq_n_s32(0);
+        int32x4_t vlapSq = vdupq_n_s32(0);
+        int32x4_t vgrad = vdupq_n_s32(0);
+        for (; x + 8 <= blockLimit; x += 8) {
+            const int16x8_t ul = load8(up + x - 1), u = load8(up + x), ur = load8(up + x + 1);
+            const int16x8_t l = load8(mid + x - 1), c = load8(mid + x), r = load8(mid + x + 1);
+            const int16x8_t dl = load8(down + x - 1), d = load8(down + x), dr = load8(down + x + 1);
+            const int16x8_t lap = vsubq_s16(vshlq_n_s16(c, 2), vaddq_s16(vaddq_s16(u, d), vaddq_s16(l, r)));
+            const int16x8_t gx = vsubq_s16(vaddq_s16(vaddq_s16(ur, dr), vshlq_n_s16(r, 1)),
+                                           vaddq_s16(vaddq_s16(ul, dl), vshlq_n_s16(l, 1)));
+            const int16x8_t gy = vsubq_s16(vaddq_s16(vaddq_s16(dl, dr), vshlq_n_s16(d, 1)),
+                                           vaddq_s16(vaddq_s16(ul, ur), vshlq_n_s16(u, 1)));
+            vlap = vpadalq_s16(vlap, lap);
+            vlapSq = vmlal_s16(vlapSq, vget_low_s16(lap), vget_low_s16(lap));
+            vlapSq = vmlal_s16(vlapSq, vget_high_s16(lap), vget_high_s16(lap));
+            vgrad = vmlal_s16(vgrad, vget_low_s16(gx), vget_low_s16(gx));
+            vgrad = vmlal_s16(vgrad, vget_high_s16(gx), vget_high_s16(gx));
+            vgrad = vmlal_s16(vgrad, vget_low_s16(gy), vget_low_s16(gy));
+            vgrad = vmlal_s16(vgrad, vget_high_s16(gy), vget_high_s16(gy));
+        }
+        std::int32_t lanes[4];
+        vst1q_s32(lanes, vlap);
+        out.laplacianSum += sumLanes(lanes, 4);
+        vst1q_s32(lanes, vlapSq);
+        out.laplacianSq += static_cast<std::uint64_t>(sumLanes(lanes, 4));
+        vst1q_s32(lanes, vgrad);
+        out.gradientSq += static_cast<std::uint64_t>(sumLanes(lanes, 4));
+    }
+    out.count += static_cast<std::uint64_t>(x - begin);
+    sharpRowTail(up, mid, down, x, end, out);
+}
+
+const StatsKernels kNeonStats = {rowSums8Neon, sharpRow8Neon};
+#endif
+
+const StatsKernels& statsKernels()
+{
+    switch (simdLevel()) {
+#if defined(VK_HAVE_AVX2)
+    case SimdLevel::AVX2: return kAvx2Stats;
+#endif
+#if defined(VK_HAVE_SSE2)
+    case SimdLevel::SSE2: return kSse2Stats;
+#endif
+#if defined(VK_HAVE_NEON)
+    case SimdLevel::NEON: return kNeonStats;
+#endif
+    default: return kScalarStats;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 按类型分派的行处理 | Per-type row processing
+// ---------------------------------------------------------------------------
+
+/**
+ * 行块累加器，各块独立累加后合并 | Per-band accumulator, merged after the band completes
+ * 8位使用4个交错子直方图，16位只用第一个 | 8-bit uses four interleaved sub-histograms, 16-bit only the first
+ */
+struct Accumulator {
+    std::uint64_t count = 0;
+    RowSums sums;
+    SharpSums sharp;
+    std::array<std::uint32_t, 4 * 256> histogram{};
+
+    void merge(const Accumulator& other)
+    {
+        count += other.count;
+        sums.sum += other.sums.sum;
+        sums.sumSq += other.sums.sumSq;
+        sums.minValue = std::min(sums.minValue, other.sums.minValue);
+        sums.maxValue = std::max(sums.maxValue, other.sums.maxValue);
+        sharp.count += other.sharp.count;
+        sharp.laplacianSum += other.sharp.laplacianSum;
+        sharp.laplacianSq += other.sharp.laplacianSq;
+        sharp.gradientSq += other.sharp.gradientSq;
+        for (std::size_t i = 0; i < histogram.size(); ++i) {
+            histogram[i] += other.histogram[i];
+        }
+    }
+};
+
+inline void accumulateRow(const StatsKernels& kernels, const std::uint8_t* p, int n, RowSums& out)
+{
+    kernels.rowSums8(p, n, out);
+}
+
+inline void accumulateRow(const StatsKernels&, const std::uint16_t* p, int n, RowSums& out)
+{
+    rowSumsTail(p, 0, n, out);
+}
+
+inline void accumulateSharpness(const StatsKernels& kernels, const std::uint8_t* up, const std::uint8_t* mid,
+                                const std::uint8_t* down, int begin, int end, SharpSums& out)
+{
+    kernels.sharpRow8(up, mid, down, begin, end, out);
+}
+
+inline void accumulateSharpness(const StatsKernels&, const std::uint16_t* up, const std::uint16_t* mid,
+                                const std::uint16_t* down, int begin, int end, SharpSums& out)
+{
+    sharpRowTail(up, mid, down, begin, end, out);
+}
+
+inline void accumulateHistogram(const std::uint8_t* p, int n, std::uint32_t* histogram)
+{
+    std::uint32_t* h0 = histogram;
+    std::uint32_t* h1 = histogram + 256;
+    std::uint32_t* h2 = histogram + 512;
+    std::uint32_t* h3 = histogram + 768;
+    int x = 0;
+    for (; x + 4 <= n; x += 4) {
+        ++h0[p[x]];
+        ++h1[p[x + 1]];
+        ++h2[p[x + 2]];
+        ++h3[p[x + 3]];
+    }
+    for (; x < n; ++x) {
+        ++h0[p[x]];
+    }
+}
+
+inline void accumulateHistogram(const std::uint16_t* p, int n, std::uint32_t* histogram)
+{
+    for (int x = 0; x < n; ++x) {
+        ++histogram[p[x] >> 8];
+    }
+}
+
+/**
+ * 处理一行中的 [begin, end) 段 | Process the segment [begin, end) of one row
+ */
+template <typename T>
+void accumulateSegment(const StatsKernels& kernels, const ImageView<const T>& image, int y, int begin, int end,
+                       const StatisticsOptions& options, Accumulator& acc)
+{
+    const T* row = image.row(y);
+    accumulateRow(kernels, row + begin, end - begin, acc.sums);
+    acc.count += static_cast<std::uint64_t>(end - begin);
+    if (options.histogram) {
+        accumulateHistogram(row + begin, end - begin, acc.histogram.data());
+    }
+    if (options.sharpness && y > 0 && y + 1 < image.height) {
+        const int sharpBegin = std::max(begin, 1);
+        const int sharpEnd = std::min(end, image.width - 1);
+        if (sharpBegin < sharpEnd) {
+            accumulateSharpness(kernels, image.row(y - 1), row, image.row(y + 1), sharpBegin, sharpEnd, acc.sharp);
+        }
+    }
+}
+
+void finalize(const Accumulator& acc, int histogramShift, const StatisticsOptions& options, ImageStatistics& stats)
+{
+    stats.reset();
+    stats.count = acc.count;
+    stats.histogramShift = histogramShift;
+    if (acc.count == 0) {
+        return;
+    }
+
+    const double n = static_cast<double>(acc.count);
+    stats.mean = static_cast<double>(acc.sums.sum) / n;
+    stats.variance = std::max(0.0, static_cast<double>(acc.sums.sumSq) / n - stats.mean * stats.mean);
+    stats.deviation = std::sqrt(stats.variance);
+    stats.minValue = acc.sums.minValue;
+    stats.maxValue = acc.sums.maxValue;
+
+    if (options.histogram) {
+        for (int i = 0; i < 256; ++i) {
+            stats.histogram[i] = acc.histogram[i] + acc.histogram[256 + i] + acc.histogram[512 + i] + acc.histogram[768 + i];
+        }
+        stats.percentile1 = histogramPercentile(stats, 1.0);
+        stats.percentile5 = histogramPercentile(stats, 5.0);
+        stats.median = histogramPercentile(stats, 50.0);
+        stats.percentile95 = histogramPercentile(stats, 95.0);
+        stats.percentile99 = histogramPercentile(stats, 99.0);
+    }
+
+    if (options.sharpness && acc.sharp.count > 0) {
+        const double m = static_cast<double>(acc.sharp.count);
+        const double laplacianMean = static_cast<double>(acc.sharp.laplacianSum) / m;
+        stats.sharpnessCount = acc.sharp.count;
+        stats.laplacianVariance = std::max(0.0, static_cast<double>(acc.sharp.laplacianSq) / m - laplacianMean * laplacianMean);
+        stats.tenengrad = static_cast<double>(acc.sharp.gradientSq) / m;
+    }
+}
+
+// 每块至少约6.4万像素，小图单线程完成 | Bands hold at least ~64K pixels so small inputs stay single-threaded
+constexpr int kMinPixelsPerBand = 1 << 16;
+
+template <typename T>
+bool statisticsImage(ImageView<const T> image, ImageStatistics& stats, const StatisticsOptions& options, int shift)
+{
+    if (!image.isValid()) {
+        stats.reset();
+        return false;
+    }
+    const StatsKernels& kernels = statsKernels();
+    Accumulator total;
+    std::mutex mutex;
+
+    parallelFor(0, image.height, std::max(1, kMinPixelsPerBand / image.width), [&](int y0, int y1) {
+        Accumulator local;
+        for (int y = y0; y < y1; ++y) {
+            accumulateSegment(kernels, image, y, 0, image.width, options, local);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        total.merge(local);
+    });
+
+    finalize(total, shift, options, stats);
+    return stats.count > 0;
+}
+
+template <typename T>
+bool statisticsRuns(ImageView<const T> image, const RunList& runs, ImageStatistics& stats,
+                    const StatisticsOptions& options, int shift)
+{
+    if (!image.isValid()) {
+        stats.reset();
+        return false;
+    }
+    const StatsKernels& kernels = statsKernels();
+    Accumulator total;
+    std::mutex mutex;
+
+    // 估算平均行程长度，使每块像素数与整图版本相近 | Size chunks by the average run length
+    std::uint64_t runPixels = 0;
+    for (const Run& run : runs) {
+        runPixels += static_cast<std::uint64_t>(std::max(0, run.end - run.begin));
+    }
+    const int runCount = static_cast<int>(runs.size());
+    const std::uint64_t averageRun = runCount > 0 ? std::max<std::uint64_t>(1, runPixels / runCount) : 1;
+    const int minChunk = static_cast<int>(std::max<std::uint64_t>(1, kMinPixelsPerBand / averageRun));
+
+    parallelFor(0, runCount, minChunk, [&](int i0, int i1) {
+        Accumulator local;
+        for (int i = i0; i < i1; ++i) {
+            const Run& run = runs[i];
+            const int begin = std::max(run.begin, 0);
+            const int end = std::min(run.end, image.width);
+            if (run.row < 0 || run.row >= image.height || begin >= end) {
+                continue;
+            }
+            accumulateSegment(kernels, image, run.row, begin, end, options, local);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        total.merge(local);
+    });
+
+    finalize(total, shift, options, stats);
+    return stats.count > 0;
+}
+
+} // namespace
+
+void ImageStatistics::reset()
+{
+    count = 0;
+    mean = 0.0;
+    variance = 0.0;
+    deviation = 0.0;
+    minValue = 0;
+    maxValue = 0;
+    histogramShift = 0;
+    histogram.fill(0);
+    percentile1 = 0;
+    percentile5 = 0;
+    median = 0;
+    percentile95 = 0;
+    percentile99 = 0;
+    sharpnessCount = 0;
+    laplacianVariance = 0.0;
+    tenengrad = 0.0;
+}
+
+bool computeStatistics(ConstView8 image, ImageStatistics& stats, const StatisticsOptions& options)
+{
+    return statisticsImage(image, stats, options, 0);
+}
+
+bool computeStatistics(ConstView16 image, ImageStatistics& stats, const StatisticsOptions& options)
+{
+    return statisticsImage(image, stats, options, 8);
+}
+
+bool computeStatistics(ConstView8 image, const RunList& runs, ImageStatistics& stats, const StatisticsOptions& options)
+{
+    return statisticsRuns(image, runs, stats, options, 0);
+}
+
+bool computeStatistics(ConstView16 image, const RunList& runs, ImageStatistics& stats, const StatisticsOptions& options)
+{
+    return statisticsRuns(image, runs, stats, options, 8);
+}
+
+int histogramPercentile(const ImageStatistics& stats, double percent)
+{
+    if (stats.count == 0) {
+        return 0;
+    }
+    const double clamped = std::min(100.0, std::max(0.0, percent));
+    std::uint64_t target = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(stats.count)));
+    target = std::max<std::uint64_t>(1, std::min(target, stats.count));
+
+    std::uint64_t cumulative = 0;
+    for (int bin = 0; bin < 256; ++bin) {
+        cumulative += stats.histogram[bin];
+        if (cumulative >= target) {
+            return bin << stats.histogramShift;
+        }
+    }
+    return 255 << stats.histogramShift;
+}
+
+} // namespace vk
@@ -0,0 +1,218 @@
+//
+// 指令集检测与行并行线程池 | SIMD level detection and row-parallel thread pool
+//
+
+#include "../inc/KernelRuntime.h"
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vk {
+
+namespace {
+
+SimdLevel probeSimdLevel()
+{
+#if defined(VK_HAVE_AVX2)
+#if defined(_MSC_VER)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        __cpuidex(info, 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0;
+        // 操作系统须保存YMM寄存器 | The OS must preserve YMM state
+        if (osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6) {
+            return SimdLevel::AVX2;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::SSE2;
+#elif defined(VK_HAVE_NEON)
+    return SimdLevel::NEON;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+std::atomic<int> g_requestedLevel{-1};   // -1: 使用检测结果 | use the detected level
+std::atomic<int> g_threadCount{0};
+
+/**
+ * 常驻工作线程：只执行 parallelFor 提交的辅助任务 | Resident workers running parallelFor helper tasks
+ */
+class WorkerPool {
+public:
+    static WorkerPool& instance()
+    {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    void submit(std::function<void()> task, int wantedWorkers)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (static_cast<int>(m_threads.size()) < wantedWorkers) {
+            m_threads.emplace_back([this]() { workerLoop(); });
+        }
+        m_tasks.push_back(std::move(task));
+        m_condition.notify_one();
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+private:
+    void workerLoop()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping && m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<std::thread> m_threads;
+    bool m_stopping = false;
+};
+
+struct ParallelState {
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+} // namespace
+
+SimdLevel detectedSimdLevel()
+{
+    static const SimdLevel level = probeSimdLevel();
+    return level;
+}
+
+SimdLevel simdLevel()
+{
+    const int requested = g_requestedLevel.load(std::memory_order_relaxed);
+    const SimdLevel detected = detectedSimdLevel();
+    if (requested < 0 || requested >= static_cast<int>(detected)) {
+        return detected;
+    }
+    // NEON 与 SSE2/AVX2 不在同一平台，低于检测结果的请求在ARM上只能是标量
+    // Below-detected requests on ARM can only mean scalar
+    if (detected == SimdLevel::NEON) {
+        return SimdLevel::Scalar;
+    }
+    return static_cast<SimdLevel>(requested);
+}
+
+void setSimdLevel(SimdLevel level)
+{
+    g_requestedLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::SSE2: return "sse2";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+void setThreadCount(int threads)
+{
+    g_threadCount.store(std::max(0, threads), std::memory_order_relaxed);
+}
+
+int threadCount()
+{
+    const int requested = g_threadCount.load(std::memory_order_relaxed);
+    if (requested > 0) {
+        return requested;
+    }
+    static const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    return cores;
+}
+
+void parallelFor(int begin, int end, int minChunk, const std::function<void(int, int)>& body)
+{
+    const int total = end - begin;
+    if (total <= 0) {
+        return;
+    }
+    minChunk = std::max(1, minChunk);
+    const int maxChunks = (total + minChunk - 1) / minChunk;
+    const int threads = std::min(threadCount(), maxChunks);
+    if (threads <= 1) {
+        body(begin, end);
+        return;
+    }
+
+    // 块数多于线程数，负载不均时由先完成的线程继续领取 | More chunks than threads for load balancing
+    const int chunks = std::min(maxChunks, threads * 4);
+    auto state = std::make_shared<ParallelState>();
+    const std::function<void(int, int)>* bodyPointer = &body;
+    auto worker = [state, begin, total, chunks, bodyPointer]() {
+        for (;;) {
+            const int chunk = state->next.fetch_add(1);
+            if (chunk >= chunks) {
+                return;   // 迟到的辅助任务不再访问 body | Late helpers never touch body
+            }
+            const int chunkBegin = begin + static_cast<int>(static_cast<long long>(total) * chunk / chunks);
+            const int chunkEnd = begin + static_cast<int>(static_cast<long long>(total) * (chunk + 1) / chunks);
+            (*bodyPointer)(chunkBegin, chunkEnd);
+            if (state->done.fetch_add(1) + 1 == chunks) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    WorkerPool& pool = WorkerPool::instance();
+    for (int i = 1; i < threads; ++i) {
+        pool.submit(worker, threads - 1);
+    }
+    worker();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, chunks]() { return state->done.load() == chunks; });
+}
+
+} // namespace vk
@@ -0,0 +1,430 @@
+//
+// 一维测量 | 1D measuring
+//
+// 旋转矩形内的 2⌊length2⌋+1 条平行采样线逐条双线性采样并累加成平均剖面。同一条线上第 i 个采样点的坐标为
+// 起点 + i·步长，SIMD 一次计算4/8个点的坐标、整数位置和权重；AVX2 用32位 gather 一次取回同一行相邻两个像素，
+// SSE2/NEON 逐点取像素后向量插值。各指令集的浮点运算顺序相同，剖面结果一致。
+// Each of the 2⌊length2⌋+1 parallel sampling lines is bilinearly sampled and accumulated into the averaged
+// profile. Sample i of a line sits at start + i·step, so SIMD computes coordinates, integer positions and weights
+// for 4/8 samples at once; AVX2 fetches two horizontal neighbours with one 32-bit gather, SSE2/NEON load the
+// pixels one by one and interpolate in vectors. The floating point operation order is the same everywhere.
+//
+
+#include "../inc/Measure1D.h"
+#include "../inc/KernelRuntime.h"
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace vk {
+
+namespace {
+
+/**
+ * 一条采样线：第 i 个点为 (row + i·rowStep, column + i·columnStep) | One sampling line
+ */
+struct SampleLine {
+    float row;
+    float column;
+    float rowStep;
+    float columnStep;
+};
+
+struct MeasureKernels {
+    // accumulate[i] += 第 i 个点的双线性插值，坐标钳位到图像内 | Adds the bilinear sample of point i
+    void (*sampleLine)(ConstView8 image, const SampleLine& line, int n, float* accumulate);
+};
+
+// ---------------------------------------------------------------------------
+// 标量实现 | Scalar implementation
+// ---------------------------------------------------------------------------
+
+// 坐标先钳位到 [0, size−1]，左上角像素取 min(⌊x⌋, size−2)，右/下边界处权重为1
+// Coordinates are clamped to [0, size−1]; the top-left pixel is min(⌊x⌋, size−2) so the border weight becomes 1
+inline float sampleBilinear(ConstView8 image, float row, float column)
+{
+    row = std::max(std::min(row, static_cast<float>(image.height - 1)), 0.0f);
+    column = std::max(std::min(column, static_cast<float>(image.width - 1)), 0.0f);
+    const int y0 = static_cast<int>(std::min(row, static_cast<float>(image.height - 2)));
+    const int x0 = static_cast<int>(std::min(column, static_cast<float>(image.width - 2)));
+    const float fy = row - static_cast<float>(y0);
+    const float fx = column - static_cast<float>(x0);
+    const std::uint8_t* p = image.row(y0) + x0;
+    const float p00 = p[0];
+    const float p01 = p[1];
+    const float p10 = p[image.stride];
+    const float p11 = p[image.stride + 1];
+    const float top = p00 + fx * (p01 - p00);
+    const float bottom = p10 + fx * (p11 - p10);
+    return top + fy * (bottom - top);
+}
+
+void sampleLineScalarFrom(ConstView8 image, const SampleLine& line, int begin, int n, float* accumulate)
+{
+    for (int i = begin; i < n; ++i) {
+        const float index = static_cast<float>(i);
+        accumulate[i] += sampleBilinear(image, line.row + index * line.rowStep, line.column + index * line.columnStep);
+    }
+}
+
+void sampleLineScalar(ConstView8 image, const SampleLine& line, int n, float* accumulate)
+{
+    sampleLineScalarFrom(image, line, 0, n, accumulate);
+}
+
+const MeasureKernels kScalarMeasure = {sampleLineScalar};
+
+// ---------------------------------------------------------------------------
+// SSE2 实现：坐标与插值向量化，像素逐个读取 | SSE2: vector coordinates and interpolation, scalar loads
+// ---------------------------------------------------------------------------
+#if defined(VK_HAVE_SSE2)
+
+void sampleLineSse2(ConstView8 image, const SampleLine& line, int n, float* accumulate)
+{
+    const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 row0 = _mm_set1_ps(line.row);
+    const __m128 column0 = _mm_set1_ps(line.column);
+    const __m128 rowStep = _mm_set1_ps(line.rowStep);
+    const __m128 columnStep = _mm_set1_ps(line.columnStep);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxRow = _mm_set1_ps(static_cast<float>(image.height - 1));
+    const __m128 maxColumn = _mm_set1_ps(static_cast<float>(image.width - 1));
+    const __m128 lastY0 = _mm_set1_ps(static_cast<float>(image.height - 2));
+    const __m128 lastX0 = _mm_set1_ps(static_cast<float>(image.width - 2));
+
+    alignas(16) std::int32_t y0[4];
+    alignas(16) std::int32_t x0[4];
+    alignas(16) float p00[4];
+    alignas(16) float p01[4];
+    alignas(16) float p10[4];
+    alignas(16) float p11[4];
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane);
+        __m128 row = _mm_add_ps(row0, _mm_mul_ps(index, rowStep));
+        __m128 column = _mm_add_ps(column0, _mm_mul_ps(index, columnStep));
+        row = _mm_max_ps(_mm_min_ps(row, maxRow), zero);
+        column = _mm_max_ps(_mm_min_ps(column, maxColumn), zero);
+        const __m128i iy = _mm_cvttps_epi32(_mm_min_ps(row, lastY0));
+        const __m128i ix = _mm_cvttps_epi32(_mm_min_ps(column, lastX0));
+        const __m128 fy = _mm_sub_ps(row, _mm_cvtepi32_ps(iy));
+        const __m128 fx = _mm_sub_ps(column, _mm_cvtepi32_ps(ix));
+        _mm_store_si128(reinterpret_cast<__m128i*>(y0), iy);
+        _mm_store_si128(reinterpret_cast<__m128i*>(x0), ix);
+        for (int k = 0; k < 4; ++k) {
+            const std::uint8_t* p = image.row(y0[k]) + x0[k];
+            p00[k] = p[0];
+            p01[k] = p[1];
+            p10[k] = p[image.stride];
+            p11[k] = p[image.stride + 1];
+        }
+        const __m128 a = _mm_load_ps(p00);
+        const __m128 b = _mm_load_ps(p10);
+        const __m128 top = _mm_add_ps(a, _mm_mul_ps(fx, _mm_sub_ps(_mm_load_ps(p01), a)));
+        const __m128 bottom = _mm_add_ps(b, _mm_mul_ps(fx, _mm_sub_ps(_mm_load_ps(p11), b)));
+        const __m128 value = _mm_add_ps(top, _mm_mul_ps(fy, _mm_sub_ps(bottom, top)));
+        _mm_storeu_ps(accumulate + i, _mm_add_ps(_mm_loadu_ps(accumulate + i), value));
+    }
+    sampleLineScalarFrom(image, line, i, n, accumulate);
+}
+
+const MeasureKernels kSse2Measure = {sampleLineSse2};
+
+// ---------------------------------------------------------------------------
+// AVX2 实现：gather 取像素 | AVX2: gathered pixel loads
+// ---------------------------------------------------------------------------
+
+VK_TARGET_AVX2 void sampleLineAvx2(ConstView8 image, const SampleLine& line, int n, float* accumulate)
+{
+    // 32位 gather 从 (y0, x0) 起读4字节：最后一行 x0 = width−2 时会越过缓冲区末尾，
+    // 且偏移须在 int32 范围内，这两种情况改用 SSE2 | A 4-byte gather may run past the last row; use SSE2 then
+    const float lastRow = std::max(line.row, line.row + static_cast<float>(n - 1) * line.rowStep);
+    const bool tailSafe = image.stride - image.width >= 2 || lastRow < static_cast<float>(image.height - 2);
+    if (!tailSafe || image.stride * static_cast<std::ptrdiff_t>(image.height) > 0x7fffffff) {
+        sampleLineSse2(image, line, n, accumulate);
+        return;
+    }
+
+    const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 row0 = _mm256_set1_ps(line.row);
+    const __m256 column0 = _mm256_set1_ps(line.column);
+    const __m256 rowStep = _mm256_set1_ps(line.rowStep);
+    const __m256 columnStep = _mm256_set1_ps(line.columnStep);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 maxRow = _mm256_set1_ps(static_cast<float>(image.height - 1));
+    const __m256 maxColumn = _mm256_set1_ps(static_cast<float>(image.width - 1));
+    const __m256 lastY0 = _mm256_set1_ps(static_cast<float>(image.height - 2));
+    const __m256 lastX0 = _mm256_set1_ps(static_cast<float>(image.width - 2));
+    const __m256i stride = _mm256_set1_epi32(static_cast<int>(image.stride));
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const int* base = reinterpret_cast<const int*>(image.data);
+    const int* below = reinterpret_cast<const int*>(image.data + image.stride);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 index = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane);
+        __m256 row = _mm256_add_ps(row0, _mm256_mul_ps(index, rowStep));
+        __m256 column = _mm256_add_ps(column0, _mm256_mul_ps(index, columnStep));
+        row = _mm256_max_ps(_mm256_min_ps(row, maxRow), zero);
+        column = _mm256_max_ps(_mm256_min_ps(column, maxColumn), zero);
+        const __m256i iy = _mm256_cvttps_epi32(_mm256_min_ps(row, lastY0));
+        const __m256i ix = _mm256_cvttps_epi32(_mm256_min_ps(column, lastX0));
+        const __m256 fy = _mm256_sub_ps(row, _mm256_cvtepi32_ps(iy));
+        const __m256 fx = _mm256_sub_ps(column, _mm256_cvtepi32_ps(ix));
+        const __m256i offset = _mm256_add_epi32(_mm256_mullo_epi32(iy, stride), ix);
+
+        // 低字节为 (y0, x0)，次低字节为 (y0, x0+1) | Byte 0 is (y0, x0), byte 1 is (y0, x0+1)
+        const __m256i upper = _mm256_i32gather_epi32(base, offset, 1);
+        const __m256i lower = _mm256_i32gather_epi32(below, offset, 1);
+        const __m256 a = _mm256_cvtepi32_ps(_mm256_and_si256(upper, byteMask));
+        const __m256 a1 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(upper, 8), byteMask));
+        const __m256 b = _mm256_cvtepi32_ps(_mm256_and_si256(lower, byteMask));
+        const __m256 b1 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(lower, 8), byteMask));
+
+        const __m256 top = _mm256_add_ps(a, _mm256_mul_ps(fx, _mm256_sub_ps(a1, a)));
+        const __m256 bottom = _mm256_add_ps(b, _mm256_mul_ps(fx, _mm256_sub_ps(b1, b)));
+        const __m256 value = _mm256_add_ps(top, _mm256_mul_ps(fy, _mm256_sub_ps(bottom, top)));
+        _mm256_storeu_ps(accumulate + i, _mm256_add_ps(_mm256_loadu_ps(accumulate + i), value));
+    }
+    sampleLineScalarFrom(image, line, i, n, accumulate);
+}
+
+const MeasureKernels kAvx2Measure = {sampleLineAvx2};
+#endif
+
+// ---------------------------------------------------------------------------
+// NEON 实现 | NEON implementation
+// ---------------------------------------------------------------------------
+#if defined(VK_HAVE_NEON)
+
+void sampleLineNeon(ConstView8 image, const SampleLine& line, int n, float* accumulate)
+{
+    static const float kLane[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    const float32x4_t lane = vld1q_f32(kLane);
+    const float32x4_t row0 = vdupq_n_f32(line.row);
+    const float32x4_t column0 = vdupq_n_f32(line.column);
+    const float32x4_t rowStep = vdupq_n_f32(line.rowStep);
+    const float32x4_t columnStep = vdupq_n_f32(line.columnStep);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t maxRow = vdupq_n_f32(static_cast<float>(image.height - 1));
+    const float32x4_t maxColumn = vdupq_n_f32(static_cast<float>(image.width - 1));
+    const float32x4_t lastY0 = vdupq_n_f32(static_cast<float>(image.height - 2));
+    const float32x4_t lastX0 = vdupq_n_f32(static_cast<float>(image.width - 2));
+
+    std::int32_t y0[4];
+    std::int32_t x0[4];
+    float p00[4];
+    float p01[4];
+    float p10[4];
+    float p11[4];
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t index = vaddq_f32(vdupq_n_f32(static_cast<float>(i)), lane);
+        float32x4_t row = vaddq_f32(row0, vmulq_f32(index, rowStep));
+        float32x4_t column = vaddq_f32(column0, vmulq_f32(index, columnStep));
+        row = vmaxq_f32(vminq_f32(row, maxRow), zero);
+        column = vmaxq_f32(vminq_f32(column, maxColumn), zero);
+        const int32x4_t iy = vcvtq_s32_f32(vminq_f32(row, lastY0));
+        const int32x4_t ix = vcvtq_s32_f32(vminq_f32(column, lastX0));
+        const float32x4_t fy = vsubq_f32(row, vcvtq_f32_s32(iy));
+        const float32x4_t fx = vsubq_f32(column, vcvtq_f32_s32(ix));
+        vst1q_s32(y0, iy);
+        vst1q_s32(x0, ix);
+        for (int k = 0; k < 4; ++k) {
+            const std::uint8_t* p = image.row(y0[k]) + x0[k];
+            p00[k] = p[0];
+            p01[k] = p[1];
+            p10[k] = p[image.stride];
+            p11[k] = p[image.stride + 1];
+        }
+        const float32x4_t a = vld1q_f32(p00);
+        const float32x4_t b = vld1q_f32(p10);
+        const float32x4_t top = vaddq_f32(a, vmulq_f32(fx, vsubq_f32(vld1q_f32(p01), a)));
+        const float32x4_t bottom = vaddq_f32(b, vmulq_f32(fx, vsubq_f32(vld1q_f32(p11), b)));
+        const float32x4_t value = vaddq_f32(top, vmulq_f32(fy, vsubq_f32(bottom, top)));
+        vst1q_f32(accumulate + i, vaddq_f32(vld1q_f32(accumulate + i), value));
+    }
+    sampleLineScalarFrom(image, line, i, n, accumulate);
+}
+
+const MeasureKernels kNeonMeasure = {sampleLineNeon};
+#endif
+
+const MeasureKernels& measureKernels()
+{
+    switch (simdLevel()) {
+#if defined(VK_HAVE_AVX2)
+    case SimdLevel::AVX2: return kAvx2Measure;
+#endif
+#if defined(VK_HAVE_SSE2)
+    case SimdLevel::SSE2: return kSse2Measure;
+#endif
+#if defined(VK_HAVE_NEON)
+    case SimdLevel::NEON: return kNeonMeasure;
+#endif
+    default: return kScalarMeasure;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 剖面处理 | Profile processing
+// ---------------------------------------------------------------------------
+
+// 剖面半长 ⌊length1⌋ | Half length of the profile in samples
+inline int profileHalfLength(const MeasureRectangle& rectangle)
+{
+    return std::max(0, static_cast<int>(std::floor(rectangle.length1)));
+}
+
+/**
+ * 高斯一阶导数：核 D[k] = k·g(k) / Σk²·g(k)，对斜率为1的斜坡响应为1，边界像素重复
+ * Derivative of Gaussian normalised to respond with 1 to a unit ramp; the border samples are repeated.
+ */
+void gaussianDerivative(const std::vector<float>& profile, double sigma, std::vector<double>& derivative)
+{
+    sigma = std::max(sigma, 0.4);
+    const int radius = std::max(1, static_cast<int>(std::ceil(3.0 * sigma)));
+    std::vector<double> kernel(static_cast<std::size_t>(2 * radius + 1));
+    double norm = 0.0;
+    for (int k = -radius; k <= radius; ++k) {
+        const double g = std::exp(-0.5 * k * k / (sigma * sigma));
+        kernel[static_cast<std::size_t>(k + radius)] = k * g;
+        norm += k * k * g;
+    }
+    for (double& weight : kernel) {
+        weight /= norm;
+    }
+
+    const int n = static_cast<int>(profile.size());
+    derivative.assign(profile.size(), 0.0);
+    for (int p = 0; p < n; ++p) {
+        double sum = 0.0;
+        for (int k = -radius; k <= radius; ++k) {
+            const int q = std::min(std::max(p + k, 0), n - 1);
+            sum += kernel[static_cast<std::size_t>(k + radius)] * profile[static_cast<std::size_t>(q)];
+        }
+        derivative[static_cast<std::size_t>(p)] = sum;
+    }
+}
+
+} // namespace
+
+bool measureProfile(ConstView8 image, const MeasureRectangle& rectangle, std::vector<float>& profile)
+{
+    profile.clear();
+    if (!image.isValid() || image.width < 2 || image.height < 2) {
+        return false;
+    }
+    const int half = profileHalfLength(rectangle);
+    const int across = std::max(0, static_cast<int>(std::floor(rectangle.length2)));
+    const int n = 2 * half + 1;
+    const double alongRow = -std::sin(rectangle.phi);
+    const double alongColumn = std::cos(rectangle.phi);
+
+    profile.assign(static_cast<std::size_t>(n), 0.0f);
+    const MeasureKernels& kernels = measureKernels();
+    for (int s = -across; s <= across; ++s) {
+        // 垂直方向 (cos phi, sin phi) 偏移 s 的采样线，从 −half 开始 | Line offset by s across the profile
+        SampleLine line;
+        line.row = static_cast<float>(rectangle.row + s * alongColumn - half * alongRow);
+        line.column = static_cast<float>(rectangle.column - s * alongRow - half * alongColumn);
+        line.rowStep = static_cast<float>(alongRow);
+        line.columnStep = static_cast<float>(alongColumn);
+        kernels.sampleLine(image, line, n, profile.data());
+    }
+    const float scale = 1.0f / static_cast<float>(2 * across + 1);
+    for (float& value : profile) {
+        value *= scale;
+    }
+    return true;
+}
+
+bool measurePos(ConstView8 image, const MeasureRectangle& rectangle, const MeasureOptions& options,
+                std::vector<Edge>& edges)
+{
+    edges.clear();
+    std::vector<float> profile;
+    if (!measureProfile(image, rectangle, profile)) {
+        return false;
+    }
+    std::vector<double> derivative;
+    gaussianDerivative(profile, options.sigma, derivative);
+
+    const int half = profileHalfLength(rectangle);
+    const double alongRow = -std::sin(rectangle.phi);
+    const double alongColumn = std::cos(rectangle.phi);
+    const int n = static_cast<int>(derivative.size());
+    for (int p = 1; p + 1 < n; ++p) {
+        const double value = derivative[static_cast<std::size_t>(p)];
+        const double magnitude = std::fabs(value);
+        const double left = std::fabs(derivative[static_cast<std::size_t>(p - 1)]);
+        const double right = std::fabs(derivative[static_cast<std::size_t>(p + 1)]);
+        if (magnitude < options.threshold || !(magnitude > left && magnitude >= right)) {
+            continue;
+        }
+        if ((options.transition == EdgeTransition::Positive && value <= 0.0)
+            || (options.transition == EdgeTransition::Negative && value >= 0.0)) {
+            continue;
+        }
+        // 三点抛物线顶点 | Vertex of the parabola through the three magnitudes
+        const double curvature = left - 2.0 * magnitude + right;
+        const double offset = curvature < 0.0 ? std::max(-0.5, std::min(0.5, 0.5 * (left - right) / curvature)) : 0.0;
+
+        Edge edge;
+        edge.position = p + offset;
+        edge.row = rectangle.row + (edge.position - half) * alongRow;
+        edge.column = rectangle.column + (edge.position - half) * alongColumn;
+        edge.amplitude = value;
+        edges.push_back(edge);
+    }
+    return true;
+}
+
+bool measurePairs(ConstView8 image, const MeasureRectangle& rectangle, const MeasureOptions& options,
+                  std::vector<EdgePair>& pairs)
+{
+    pairs.clear();
+    MeasureOptions allEdges = options;
+    allEdges.transition = EdgeTransition::All;
+    std::vector<Edge> edges;
+    if (!measurePos(image, rectangle, allEdges, edges)) {
+        return false;
+    }
+    if (edges.empty()) {
+        return true;
+    }
+
+    double firstSign = 1.0;
+    if (options.transition == EdgeTransition::Negative
+        || (options.transition == EdgeTransition::All && edges.front().amplitude < 0.0)) {
+        firstSign = -1.0;
+    }
+    for (std::size_t i = 0; i + 1 < edges.size();) {
+        if (edges[i].amplitude * firstSign > 0.0 && edges[i + 1].amplitude * firstSign < 0.0) {
+            EdgePair pair;
+            pair.first = edges[i];
+            pair.second = edges[i + 1];
+            pair.width = pair.second.position - pair.first.position;
+            pairs.push_back(pair);
+            i += 2;
+        } else {
+            ++i;
+        }
+    }
+    return true;
+}
+
+bool strongestEdge(const std::vector<Edge>& edges, Edge& edge)
+{
+    if (edges.empty()) {
+        return false;
+    }
+    edge = *std::max_element(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return std::fabs(a.amplitude) < std::fabs(b.amplitude);
+    });
+    return true;
+}
+
+} // namespace vk
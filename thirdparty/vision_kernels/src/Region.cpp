@@ -0,0 +1,894 @@
+//
+// 行程编码区域运算 | Run-length region operations
+//
+// 所有运算都直接在规范行程上逐行归并，不展开成位图。行与行之间互不依赖的运算（集合运算、形态学输出行）
+// 按行块交给 parallelFor，每块写自己的 RunList，最后按块顺序拼接，结果与单线程完全相同。
+// Every operation merges canonical runs row by row without rasterising. Row-independent work (set operations,
+// morphology output rows) is split into row bands via parallelFor; each band fills its own RunList and the
+// bands are concatenated in order, so results match a single-threaded run exactly.
+//
+
+#include "../inc/Region.h"
+#include "../inc/KernelRuntime.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <utility>
+
+namespace vk {
+
+namespace {
+
+// 每块至少约4096段行程，小区域单线程完成 | Bands hold at least ~4096 runs so small regions stay single-threaded
+constexpr std::size_t kMinRunsPerBand = 4096;
+
+inline bool runLess(const Run& a, const Run& b)
+{
+    return a.row < b.row || (a.row == b.row && a.begin < b.begin);
+}
+
+bool isCanonical(const RunList& runs)
+{
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        if (runs[i].begin >= runs[i].end) {
+            return false;
+        }
+        if (i > 0 && !(runs[i].row > runs[i - 1].row
+                       || (runs[i].row == runs[i - 1].row && runs[i].begin > runs[i - 1].end))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 去掉空行程、排序并合并重叠或相邻的行程 | Drop empty runs, sort, merge overlapping or touching runs
+void canonicalize(RunList& runs)
+{
+    runs.erase(std::remove_if(runs.begin(), runs.end(), [](const Run& run) { return run.begin >= run.end; }),
+               runs.end());
+    std::sort(runs.begin(), runs.end(), runLess);
+    std::size_t out = 0;
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        if (out > 0 && runs[out - 1].row == runs[i].row && runs[i].begin <= runs[out - 1].end) {
+            runs[out - 1].end = std::max(runs[out - 1].end, runs[i].end);
+        } else {
+            runs[out++] = runs[i];
+        }
+    }
+    runs.resize(out);
+}
+
+// ---------------------------------------------------------------------------
+// 单行归并（输入为同一行的规范行程，结果追加到 out）| Per-row merges appending canonical runs to out
+// ---------------------------------------------------------------------------
+
+inline void appendMerged(RunList& out, std::size_t rowStart, int row, int begin, int end)
+{
+    if (out.size() > rowStart && begin <= out.back().end) {
+        out.back().end = std::max(out.back().end, end);
+    } else {
+        out.push_back(Run{row, begin, end});
+    }
+}
+
+void unionRow(const Run* a, const Run* aEnd, const Run* b, const Run* bEnd, int row, RunList& out)
+{
+    const std::size_t rowStart = out.size();
+    while (a != aEnd || b != bEnd) {
+        const Run& next = (b == bEnd || (a != aEnd && a->begin <= b->begin)) ? *a++ : *b++;
+        appendMerged(out, rowStart, row, next.begin, next.end);
+    }
+}
+
+void intersectRow(const Run* a, const Run* aEnd, const Run* b, const Run* bEnd, int row, RunList& out)
+{
+    while (a != aEnd && b != bEnd) {
+        const int begin = std::max(a->begin, b->begin);
+        const int end = std::min(a->end, b->end);
+        if (begin < end) {
+            out.push_back(Run{row, begin, end});
+        }
+        if (a->end < b->end) {
+            ++a;
+        } else {
+            ++b;
+        }
+    }
+}
+
+void subtractRow(const Run* a, const Run* aEnd, const Run* b, const Run* bEnd, int row, RunList& out)
+{
+    for (; a != aEnd; ++a) {
+        while (b != bEnd && b->end <= a->begin) {
+            ++b;
+        }
+        int cursor = a->begin;
+        for (const Run* cut = b; cut != bEnd && cut->begin < a->end; ++cut) {
+            if (cut->begin > cursor) {
+                out.push_back(Run{row, cursor, cut->begin});
+            }
+            cursor = std::max(cursor, cut->end);
+        }
+        if (cursor < a->end) {
+            out.push_back(Run{row, cursor, a->end});
+        }
+    }
+}
+
+// 水平扩展：[b − left, e + right) | Horizontal growth
+void growRow(const Run* a, const Run* aEnd, int left, int right, int row, RunList& out)
+{
+    const std::size_t rowStart = out.size();
+    for (; a != aEnd; ++a) {
+        appendMerged(out, rowStart, row, a->begin - left, a->end + right);
+    }
+}
+
+// 水平收缩：[b + left, e − right)，变空的行程丢弃 | Horizontal shrink; emptied runs are dropped
+void shrinkRow(const Run* a, const Run* aEnd, int left, int right, int row, RunList& out)
+{
+    for (; a != aEnd; ++a) {
+        if (a->begin + left < a->end - right) {
+            out.push_back(Run{row, a->begin + left, a->end - right});
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 行索引与行块并行 | Row index and row-band parallelism
+// ---------------------------------------------------------------------------
+
+/**
+ * 规范行程的稠密行索引：第 first+i 行的行程为 runs[start[i], start[i+1]) | Dense row index over canonical runs
+ */
+struct RowIndex {
+    const RunList* runs = nullptr;
+    int first = 0;
+    std::vector<std::size_t> start;
+
+    int count() const { return static_cast<int>(start.size()) - 1; }
+    const Run* begin(int row) const { return contains(row) ? runs->data() + start[row - first] : nullptr; }
+    const Run* end(int row) const { return contains(row) ? runs->data() + start[row - first + 1] : nullptr; }
+    bool contains(int row) const { return row >= first && row - first < count(); }
+};
+
+RowIndex indexRows(const RunList& runs)
+{
+    RowIndex index;
+    index.runs = &runs;
+    if (runs.empty()) {
+        index.start.assign(1, 0);
+        return index;
+    }
+    index.first = runs.front().row;
+    const int rows = runs.back().row - index.first + 1;
+    index.start.assign(static_cast<std::size_t>(rows) + 1, runs.size());
+    std::size_t i = 0;
+    for (int r = 0; r < rows; ++r) {
+        index.start[static_cast<std::size_t>(r)] = i;
+        while (i < runs.size() && runs[i].row == index.first + r) {
+            ++i;
+        }
+    }
+    return index;
+}
+
+std::size_t lowerRow(const RunList& runs, int row)
+{
+    return static_cast<std::size_t>(
+        std::lower_bound(runs.begin(), runs.end(), row, [](const Run& run, int r) { return run.row < r; })
+        - runs.begin());
+}
+
+/**
+ * 把行区间 [rowMin, rowMax] 切成若干行块并行处理，bandFn(row0, row1, out) 生成 [row0, row1) 的行程
+ * Split [rowMin, rowMax] into row bands processed in parallel and concatenate the results in order.
+ */
+template <typename BandFn>
+RunList processBands(int rowMin, int rowMax, std::size_t workRuns, BandFn&& bandFn)
+{
+    RunList result;
+    if (rowMax < rowMin) {
+        return result;
+    }
+    const std::int64_t rows = static_cast<std::int64_t>(rowMax) - rowMin + 1;
+    const int bandCount = static_cast<int>(std::max<std::int64_t>(
+        1, std::min<std::int64_t>(rows, static_cast<std::int64_t>(workRuns / kMinRunsPerBand) + 1)));
+    std::vector<RunList> bands(static_cast<std::size_t>(bandCount));
+
+    parallelFor(0, bandCount, 1, [&](int band0, int band1) {
+        for (int band = band0; band < band1; ++band) {
+            const int row0 = static_cast<int>(rowMin + rows * band / bandCount);
+            const int row1 = static_cast<int>(rowMin + rows * (band + 1) / bandCount);
+            bandFn(row0, row1, bands[static_cast<std::size_t>(band)]);
+        }
+    });
+
+    std::size_t total = 0;
+    for (const RunList& band : bands) {
+        total += band.size();
+    }
+    result.reserve(total);
+    for (const RunList& band : bands) {
+        result.insert(result.end(), band.begin(), band.end());
+    }
+    return result;
+}
+
+/**
+ * 逐行组合两个区域，rowOp 对同一行的两组行程（可能为空）生成结果
+ * Combine two regions row by row; rowOp receives the runs of both inputs for one row (either may be empty).
+ */
+template <typename RowOp>
+Region combineRegions(const RunList& a, const RunList& b, RowOp rowOp)
+{
+    int rowMin = INT_MAX;
+    int rowMax = INT_MIN;
+    if (!a.empty()) {
+        rowMin = std::min(rowMin, a.front().row);
+        rowMax = std::max(rowMax, a.back().row);
+    }
+    if (!b.empty()) {
+        rowMin = std::min(rowMin, b.front().row);
+        rowMax = std::max(rowMax, b.back().row);
+    }
+    RunList runs = processBands(rowMin, rowMax, a.size() + b.size(), [&](int row0, int row1, RunList& out) {
+        std::size_t ia = lowerRow(a, row0);
+        std::size_t ib = lowerRow(b, row0);
+        const std::size_t ea = lowerRow(a, row1);
+        const std::size_t eb = lowerRow(b, row1);
+        while (ia < ea || ib < eb) {
+            const int row = std::min(ia < ea ? a[ia].row : INT_MAX, ib < eb ? b[ib].row : INT_MAX);
+            std::size_t na = ia;
+            std::size_t nb = ib;
+            while (na < ea && a[na].row == row) {
+                ++na;
+            }
+            while (nb < eb && b[nb].row == row) {
+                ++nb;
+            }
+            rowOp(a.data() + ia, a.data() + na, b.data() + ib, b.data() + nb, row, out);
+            ia = na;
+            ib = nb;
+        }
+    });
+    return Region(std::move(runs));
+}
+
+// ---------------------------------------------------------------------------
+// van Herk/Gil-Werman 垂直窗口 | van Herk/Gil-Werman vertical window
+// ---------------------------------------------------------------------------
+
+/**
+ * 对输入行按高度 k 的窗口求并集（dilate = true）或交集：窗口起点为 w 时输出到第 w + shift 行。
+ * 按 k 行分块，块内前缀 g 与后缀 h 各算一次，任意窗口 [w, w+k) = h[w] ∪ g[w+k−1]，每行两次合并。
+ * 并集时输入两侧各补 k−1 个空行，使部分覆盖输入的窗口也有输出；交集窗口必须完全落在输入行内。
+ * Unions (dilate) or intersections over every window of k rows, output row = window start + shift. Rows are
+ * split into blocks of k; block prefixes g and suffixes h give any window as h[w] ∪ g[w+k−1].
+ */
+RunList slidingWindow(const RunList& rows, int k, int shift, bool dilate)
+{
+    const RowIndex index = indexRows(rows);
+    const int pad = dilate ? k - 1 : 0;
+    const int padded = index.count() + 2 * pad;
+    const int windows = padded - k + 1;
+    if (rows.empty() || windows <= 0) {
+        return RunList();
+    }
+    const int firstRow = index.first - pad;   // 补齐后第0行对应的输入行 | Input row of padded index 0
+    auto rowBegin = [&](int p) { return index.begin(firstRow + p); };
+    auto rowEnd = [&](int p) { return index.end(firstRow + p); };
+    auto combine = [&](const Run* a, const Run* aEnd, const Run* b, const Run* bEnd, int row, RunList& out) {
+        if (dilate) {
+            unionRow(a, aEnd, b, bEnd, row, out);
+        } else {
+            intersectRow(a, aEnd, b, bEnd, row, out);
+        }
+    };
+
+    std::vector<RunList> prefix(static_cast<std::size_t>(padded));
+    std::vector<RunList> suffix(static_cast<std::size_t>(padded));
+    const int blocks = (padded + k - 1) / k;
+    const std::size_t work = rows.size() * 2;
+    // 每块至少约 kMinRunsPerBand 段行程 | Keep roughly kMinRunsPerBand runs per task
+    const int minBlocks = static_cast<int>(std::min<std::size_t>(
+        static_cast<std::size_t>(blocks), kMinRunsPerBand * static_cast<std::size_t>(blocks) / work + 1));
+    parallelFor(0, blocks, minBlocks, [&](int block0, int block1) {
+        for (int block = block0; block < block1; ++block) {
+            const int p0 = block * k;
+            const int p1 = std::min(padded, p0 + k);
+            for (int p = p0; p < p1; ++p) {
+                RunList& g = prefix[static_cast<std::size_t>(p)];
+                if (p == p0) {
+                    g.assign(rowBegin(p), rowEnd(p));
+                } else {
+                    const RunList& previous = prefix[static_cast<std::size_t>(p - 1)];
+                    combine(previous.data(), previous.data() + previous.size(), rowBegin(p), rowEnd(p), 0, g);
+                }
+            }
+            for (int p = p1 - 1; p >= p0; --p) {
+                RunList& h = suffix[static_cast<std::size_t>(p)];
+                if (p == p1 - 1) {
+                    h.assign(rowBegin(p), rowEnd(p));
+                } else {
+                    const RunList& next = suffix[static_cast<std::size_t>(p + 1)];
+                    combine(rowBegin(p), rowEnd(p), next.data(), next.data() + next.size(), 0, h);
+                }
+            }
+        }
+    });
+
+    const int rowMin = firstRow + shift;
+    return processBands(rowMin, rowMin + windows - 1, work, [&](int row0, int row1, RunList& out) {
+        for (int row = row0; row < row1; ++row) {
+            const int w = row - rowMin;
+            const RunList& h = suffix[static_cast<std::size_t>(w)];
+            const RunList& g = prefix[static_cast<std::size_t>(w + k - 1)];
+            combine(h.data(), h.data() + h.size(), g.data(), g.data() + g.size(), row, out);
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 圆形结构元素 | Disc structuring element
+// ---------------------------------------------------------------------------
+
+// halfWidth[dy + R] = ⌊√(radius² − dy²)⌋ | Half widths of the disc rows
+std::vector<int> discHalfWidths(double radius)
+{
+    const int r = static_cast<int>(std::floor(radius + 1e-9));
+    std::vector<int> halfWidths(static_cast<std::size_t>(2 * r + 1));
+    for (int dy = -r; dy <= r; ++dy) {
+        halfWidths[static_cast<std::size_t>(dy + r)] =
+            static_cast<int>(std::floor(std::sqrt(std::max(0.0, radius * radius - double(dy) * dy)) + 1e-9));
+    }
+    return halfWidths;
+}
+
+Region discMorphology(const Region& region, double radius, bool dilate)
+{
+    if (region.empty() || !(radius >= 0.0)) {
+        return region;
+    }
+    const std::vector<int> halfWidths = discHalfWidths(radius);
+    const int r = static_cast<int>(halfWidths.size() / 2);
+    const RunList& runs = region.runs();
+    const RowIndex index = indexRows(runs);
+    const int lastRow = index.first + index.count() - 1;
+    const int rowMin = dilate ? index.first - r : index.first + r;
+    const int rowMax = dilate ? lastRow + r : lastRow - r;
+
+    RunList result = processBands(rowMin, rowMax, runs.size() * halfWidths.size(), [&](int row0, int row1,
+                                                                                        RunList& out) {
+        RunList accumulated;
+        RunList piece;
+        RunList merged;
+        for (int row = row0; row < row1; ++row) {
+            accumulated.clear();
+            bool first = true;
+            for (int dy = -r; dy <= r; ++dy) {
+                // 膨胀：第 row 行来自输入行 row − dy；腐蚀：需要输入行 row + dy 全部覆盖
+                const int source = dilate ? row - dy : row + dy;
+                const int halfWidth = halfWidths[static_cast<std::size_t>(dy + r)];
+                piece.clear();
+                if (dilate) {
+                    growRow(index.begin(source), index.end(source), halfWidth, halfWidth, row, piece);
+                } else {
+                    shrinkRow(index.begin(source), index.end(source), halfWidth, halfWidth, row, piece);
+                }
+                if (first) {
+                    accumulated.swap(piece);
+                    first = false;
+                } else {
+                    merged.clear();
+                    if (dilate) {
+                        unionRow(accumulated.data(), accumulated.data() + accumulated.size(), piece.data(),
+                                 piece.data() + piece.size(), row, merged);
+                    } else {
+                        intersectRow(accumulated.data(), accumulated.data() + accumulated.size(), piece.data(),
+                                     piece.data() + piece.size(), row, merged);
+                    }
+                    accumulated.swap(merged);
+                }
+                if (!dilate && accumulated.empty()) {
+                    break;
+                }
+            }
+            out.insert(out.end(), accumulated.begin(), accumulated.end());
+        }
+    });
+    return Region(std::move(result));
+}
+
+// ---------------------------------------------------------------------------
+// 连通域 | Connected components
+// ---------------------------------------------------------------------------
+
+inline int findRoot(std::vector<int>& parent, int i)
+{
+    while (parent[static_cast<std::size_t>(i)] != i) {
+        int& p = parent[static_cast<std::size_t>(i)];
+        p = parent[static_cast<std::size_t>(p)];   // 路径减半 | Path halving
+        i = p;
+    }
+    return i;
+}
+
+// 根总是集合内最小的行程序号，连通域因此按第一个像素排序 | The root is always the smallest run index of its set
+inline void joinRuns(std::vector<int>& parent, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) {
+        parent[static_cast<std::size_t>(b)] = a;
+    } else if (b < a) {
+        parent[static_cast<std::size_t>(a)] = b;
+    }
+}
+
+// 合并相邻两行中相互接触的行程（8邻域时对角接触也算）| Join touching runs of two adjacent rows
+void joinRows(const RunList& runs, std::size_t up, std::size_t upEnd, std::size_t down, std::size_t downEnd,
+              int reach, std::vector<int>& parent)
+{
+    while (up < upEnd && down < downEnd) {
+        const Run& a = runs[up];
+        const Run& b = runs[down];
+        if (a.begin < b.end + reach && b.begin < a.end + reach) {
+            joinRuns(parent, static_cast<int>(up), static_cast<int>(down));
+        }
+        if (a.end < b.end) {
+            ++up;
+        } else {
+            ++down;
+        }
+    }
+}
+
+// 行程端点到参考点的最大平方距离只可能出现在行程两端 | The farthest pixel of a run is one of its ends
+inline double farthestSquared(const Run& run, double row, double column)
+{
+    const double dr = run.row - row;
+    const double left = run.begin - column;
+    const double right = run.end - 1 - column;
+    return dr * dr + std::max(left * left, right * right);
+}
+
+// Σ_{k=0..n} k²（n 可为负，保证 F(e−1) − F(b−1) = Σ_{x=b}^{e−1} x²）| Closed-form sum of squares
+inline double sumSquaresTo(double n)
+{
+    return n * (n + 1.0) * (2.0 * n + 1.0) / 6.0;
+}
+
+struct MomentSums {
+    std::uint64_t area = 0;
+    double rows = 0.0;
+    double columns = 0.0;
+    double rowRow = 0.0;
+    double columnColumn = 0.0;
+    double rowColumn = 0.0;
+    int row1 = INT_MAX;
+    int column1 = INT_MAX;
+    int row2 = INT_MIN;
+    int column2 = INT_MIN;
+
+    void merge(const MomentSums& other)
+    {
+        area += other.area;
+        rows += other.rows;
+        columns += other.columns;
+        rowRow += other.rowRow;
+        columnColumn += other.columnColumn;
+        rowColumn += other.rowColumn;
+        row1 = std::min(row1, other.row1);
+        column1 = std::min(column1, other.column1);
+        row2 = std::max(row2, other.row2);
+        column2 = std::max(column2, other.column2);
+    }
+};
+
+/**
+ * 与区域同阶矩的矩形 | Rectangle with the same first and second moments as the region
+ * 离散长度 N 的线段方差为 (N²−1)/12，因此边长取 √(12λ+1)，轴对齐的像素矩形与自身完全重合。
+ * A discrete segment of N pixels has variance (N²−1)/12, so the side is √(12λ+1) and pixel rectangles map onto
+ * themselves.
+ */
+struct EquivalentRectangle {
+    double row = 0.0;
+    double column = 0.0;
+    double cosine = 1.0;
+    double sine = 0.0;
+    double halfLength = 0.0;   // 主轴半长 | Half length along the major axis
+    double halfWidth = 0.0;    // 次轴半长 | Half length along the minor axis
+
+    // 第 row 行落在矩形内的列 [begin, end)，不相交时 begin >= end | Columns of the rectangle on a row
+    void columns(int y, int& begin, int& end) const
+    {
+        constexpr double eps = 1e-9;
+        const double dr = y - row;
+        double lo = -1e300;
+        double hi = 1e300;
+        auto clip = [&](double along, double offset, double half) {
+            // |dc·along + offset| ≤ half
+            if (std::fabs(along) > 1e-12) {
+                const double t1 = (-half - offset) / along;
+                const double t2 = (half - offset) / along;
+                lo = std::max(lo, std::min(t1, t2));
+                hi = std::min(hi, std::max(t1, t2));
+            } else if (std::fabs(offset) > half + eps) {
+                lo = 1.0;
+                hi = 0.0;
+            }
+        };
+        clip(cosine, dr * sine, halfLength);
+        clip(-sine, dr * cosine, halfWidth);
+        if (lo > hi) {
+            begin = 0;
+            end = 0;
+            return;
+        }
+        begin = static_cast<int>(std::ceil(column + lo - eps));
+        end = static_cast<int>(std::floor(column + hi + eps)) + 1;
+    }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Region
+// ---------------------------------------------------------------------------
+
+Region::Region(RunList runs)
+    : m_runs(std::move(runs))
+{
+    if (!isCanonical(m_runs)) {
+        canonicalize(m_runs);
+    }
+}
+
+Region Region::rectangle(int row1, int column1, int row2, int column2)
+{
+    RunList runs;
+    if (row2 >= row1 && column2 >= column1) {
+        runs.reserve(static_cast<std::size_t>(row2 - row1 + 1));
+        for (int row = row1; row <= row2; ++row) {
+            runs.push_back(Run{row, column1, column2 + 1});
+        }
+    }
+    return Region(std::move(runs));
+}
+
+std::uint64_t Region::area() const
+{
+    std::uint64_t total = 0;
+    for (const Run& run : m_runs) {
+        total += static_cast<std::uint64_t>(run.end - run.begin);
+    }
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// 集合运算 | Set operations
+// ---------------------------------------------------------------------------
+
+Region unionRegions(const Region& a, const Region& b)
+{
+    return combineRegions(a.runs(), b.runs(), unionRow);
+}
+
+Region unionRegions(const std::vector<Region>& regions)
+{
+    // 全部行程一次排序合并，避免逐对合并的 O(n·k) | One sort and merge instead of k pairwise unions
+    std::size_t total = 0;
+    for (const Region& region : regions) {
+        total += region.runs().size();
+    }
+    RunList runs;
+    runs.reserve(total);
+    for (const Region& region : regions) {
+        runs.insert(runs.end(), region.runs().begin(), region.runs().end());
+    }
+    return Region(std::move(runs));
+}
+
+Region intersectRegions(const Region& a, const Region& b)
+{
+    return combineRegions(a.runs(), b.runs(), intersectRow);
+}
+
+Region subtractRegion(const Region& a, const Region& b)
+{
+    return combineRegions(a.runs(), b.runs(), subtractRow);
+}
+
+Region translateRegion(const Region& region, int rowOffset, int columnOffset)
+{
+    RunList runs = region.runs();
+    for (Run& run : runs) {
+        run.row += rowOffset;
+        run.begin += columnOffset;
+        run.end += columnOffset;
+    }
+    return Region(std::move(runs));
+}
+
+// ---------------------------------------------------------------------------
+// 形态学 | Morphology
+// ---------------------------------------------------------------------------
+
+Region dilateRectangle(const Region& region, int width, int height)
+{
+    if (region.empty() || width < 1 || height < 1) {
+        return region;
+    }
+    const int left = (width - 1) / 2;
+    const int right = width / 2;
+    const int bottom = height / 2;
+
+    const RunList& runs = region.runs();
+    RunList grown;
+    grown.reserve(runs.size());
+    const RowIndex index = indexRows(runs);
+    for (int row = index.first; row < index.first + index.count(); ++row) {
+        growRow(index.begin(row), index.end(row), left, right, row, grown);
+    }
+    if (height == 1) {
+        return Region(std::move(grown));
+    }
+    // 输出行 y 覆盖输入行 [y − bottom, y + top]：窗口起点 w = y − bottom | Output row y gathers rows y−bottom..y+top
+    return Region(slidingWindow(grown, height, bottom, true));
+}
+
+Region erodeRectangle(const Region& region, int width, int height)
+{
+    if (region.empty() || width < 1 || height < 1) {
+        return region;
+    }
+    const int left = (width - 1) / 2;
+    const int right = width / 2;
+    const int top = (height - 1) / 2;
+
+    const RunList& runs = region.runs();
+    RunList shrunk;
+    shrunk.reserve(runs.size());
+    const RowIndex index = indexRows(runs);
+    for (int row = index.first; row < index.first + index.count(); ++row) {
+        shrinkRow(index.begin(row), index.end(row), left, right, row, shrunk);
+    }
+    if (height == 1 || shrunk.empty()) {
+        return Region(std::move(shrunk));
+    }
+    // 输出行 y 要求输入行 [y − top, y + bottom] 全部覆盖：窗口起点 w = y − top | Needs rows y−top..y+bottom
+    return Region(slidingWindow(shrunk, height, top, false));
+}
+
+Region openRectangle(const Region& region, int width, int height)
+{
+    return dilateRectangle(erodeRectangle(region, width, height), width, height);
+}
+
+Region closeRectangle(const Region& region, int width, int height)
+{
+    return erodeRectangle(dilateRectangle(region, width, height), width, height);
+}
+
+Region dilateCircle(const Region& region, double radius)
+{
+    return discMorphology(region, radius, true);
+}
+
+Region erodeCircle(const Region& region, double radius)
+{
+    return discMorphology(region, radius, false);
+}
+
+Region openCircle(const Region& region, double radius)
+{
+    return dilateCircle(erodeCircle(region, radius), radius);
+}
+
+Region closeCircle(const Region& region, double radius)
+{
+    return erodeCircle(dilateCircle(region, radius), radius);
+}
+
+// ---------------------------------------------------------------------------
+// 连通域 | Connected components
+// ---------------------------------------------------------------------------
+
+std::vector<Region> connectedComponents(const Region& region, Connectivity connectivity)
+{
+    std::vector<Region> components;
+    const RunList& runs = region.runs();
+    if (runs.empty()) {
+        return components;
+    }
+    const int reach = connectivity == Connectivity::Eight ? 1 : 0;
+    const RowIndex index = indexRows(runs);
+    const int rows = index.count();
+
+    std::vector<int> parent(runs.size());
+    for (std::size_t i = 0; i < parent.size(); ++i) {
+        parent[i] = static_cast<int>(i);
+    }
+    auto joinWithPrevious = [&](int r) {
+        joinRows(runs, index.start[static_cast<std::size_t>(r - 1)], index.start[static_cast<std::size_t>(r)],
+                 index.start[static_cast<std::size_t>(r)], index.start[static_cast<std::size_t>(r + 1)], reach, parent);
+    };
+
+    // 行块内部并行（只修改本块行程的 parent），块边界之后串行合并 | Bands touch only their own runs
+    const int bandCount = static_cast<int>(std::max<std::size_t>(
+        1, std::min<std::size_t>(static_cast<std::size_t>(rows), runs.size() / kMinRunsPerBand + 1)));
+    auto bandStart = [&](int band) { return static_cast<int>(static_cast<std::int64_t>(rows) * band / bandCount); };
+    parallelFor(0, bandCount, 1, [&](int band0, int band1) {
+        for (int band = band0; band < band1; ++band) {
+            for (int r = bandStart(band) + 1; r < bandStart(band + 1); ++r) {
+                joinWithPrevious(r);
+            }
+        }
+    });
+    for (int band = 1; band < bandCount; ++band) {
+        const int r = bandStart(band);
+        if (r > 0) {
+            joinWithPrevious(r);
+        }
+    }
+
+    // 按根的出现顺序编号，再把行程分发到各连通域 | Number roots in order, then scatter the runs
+    std::vector<int> label(runs.size());
+    std::vector<std::size_t> sizes;
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        const int root = findRoot(parent, static_cast<int>(i));
+        if (root == static_cast<int>(i)) {
+            label[i] = static_cast<int>(sizes.size());
+            sizes.push_back(0);
+        } else {
+            label[i] = label[static_cast<std::size_t>(root)];
+        }
+        ++sizes[static_cast<std::size_t>(label[i])];
+    }
+    std::vector<RunList> lists(sizes.size());
+    for (std::size_t c = 0; c < sizes.size(); ++c) {
+        lists[c].reserve(sizes[c]);
+    }
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        lists[static_cast<std::size_t>(label[i])].push_back(runs[i]);
+    }
+    components.reserve(lists.size());
+    for (RunList& list : lists) {
+        components.emplace_back(std::move(list));
+    }
+    return components;
+}
+
+// ---------------------------------------------------------------------------
+// 形状特征 | Shape features
+// ---------------------------------------------------------------------------
+
+RegionFeatures regionFeatures(const Region& region)
+{
+    RegionFeatures features;
+    const RunList& runs = region.runs();
+    if (runs.empty()) {
+        return features;
+    }
+
+    // 第一遍：各块独立累加矩，按块顺序合并（结果与线程数无关）| Pass 1: moments per chunk, merged in order
+    // 坐标相对第一段行程，减小大坐标下的相消误差 | Coordinates relative to the first run limit cancellation
+    const double originRow = runs.front().row;
+    const double originColumn = runs.front().begin;
+    const int chunkCount = static_cast<int>(std::max<std::size_t>(1, runs.size() / kMinRunsPerBand));
+    auto chunkBegin = [&](int chunk) { return runs.size() * static_cast<std::size_t>(chunk) / chunkCount; };
+    std::vector<MomentSums> partial(static_cast<std::size_t>(chunkCount));
+    parallelFor(0, chunkCount, 1, [&](int chunk0, int chunk1) {
+        for (int chunk = chunk0; chunk < chunk1; ++chunk) {
+            MomentSums& sums = partial[static_cast<std::size_t>(chunk)];
+            for (std::size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i) {
+                const Run& run = runs[i];
+                const double length = run.end - run.begin;
+                const double r = run.row - originRow;
+                const double first = run.begin - originColumn;
+                const double last = run.end - 1 - originColumn;
+                const double columnSum = (first + last) * length * 0.5;
+                sums.area += static_cast<std::uint64_t>(run.end - run.begin);
+                sums.rows += r * length;
+                sums.rowRow += r * r * length;
+                sums.columns += columnSum;
+                sums.columnColumn += sumSquaresTo(last) - sumSquaresTo(first - 1.0);
+                sums.rowColumn += r * columnSum;
+                sums.row1 = std::min(sums.row1, run.row);
+                sums.row2 = std::max(sums.row2, run.row);
+                sums.column1 = std::min(sums.column1, run.begin);
+                sums.column2 = std::max(sums.column2, run.end - 1);
+            }
+        }
+    });
+    MomentSums total;
+    for (const MomentSums& sums : partial) {
+        total.merge(sums);
+    }
+
+    const double area = static_cast<double>(total.area);
+    const double meanRow = total.rows / area;
+    const double meanColumn = total.columns / area;
+    features.area = total.area;
+    features.row = originRow + meanRow;
+    features.column = originColumn + meanColumn;
+    features.row1 = total.row1;
+    features.column1 = total.column1;
+    features.row2 = total.row2;
+    features.column2 = total.column2;
+
+    // 等效矩形：协方差矩阵的特征值给出两轴方差，主轴方向由 atan2 得到 | Equivalent rectangle from the covariance
+    const double muRR = std::max(0.0, total.rowRow / area - meanRow * meanRow);
+    const double muCC = std::max(0.0, total.columnColumn / area - meanColumn * meanColumn);
+    const double muRC = total.rowColumn / area - meanRow * meanColumn;
+    const double halfSum = 0.5 * (muRR + muCC);
+    const double root = std::sqrt(0.25 * (muCC - muRR) * (muCC - muRR) + muRC * muRC);
+    const double angle = 0.5 * std::atan2(2.0 * muRC, muCC - muRR);
+    EquivalentRectangle rectangle;
+    rectangle.row = features.row;
+    rectangle.column = features.column;
+    rectangle.cosine = std::cos(angle);
+    rectangle.sine = std::sin(angle);
+    rectangle.halfLength = 0.5 * std::sqrt(12.0 * (halfSum + root) + 1.0);
+    rectangle.halfWidth = 0.5 * std::sqrt(std::max(0.0, 12.0 * (halfSum - root)) + 1.0);
+
+    // 第二遍：最远像素距离与区域∩矩形的面积 | Pass 2: farthest pixel and area of region ∩ rectangle
+    std::vector<double> farthest(static_cast<std::size_t>(chunkCount), 0.0);
+    std::vector<std::uint64_t> overlap(static_cast<std::size_t>(chunkCount), 0);
+    parallelFor(0, chunkCount, 1, [&](int chunk0, int chunk1) {
+        for (int chunk = chunk0; chunk < chunk1; ++chunk) {
+            double maxSquared = 0.0;
+            std::uint64_t common = 0;
+            int cachedRow = INT_MIN;
+            int rectBegin = 0;
+            int rectEnd = 0;
+            for (std::size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i) {
+                const Run& run = runs[i];
+                maxSquared = std::max(maxSquared, farthestSquared(run, features.row, features.column));
+                if (run.row != cachedRow) {
+                    rectangle.columns(run.row, rectBegin, rectEnd);
+                    cachedRow = run.row;
+                }
+                const int begin = std::max(run.begin, rectBegin);
+                const int end = std::min(run.end, rectEnd);
+                if (begin < end) {
+                    common += static_cast<std::uint64_t>(end - begin);
+                }
+            }
+            farthest[static_cast<std::size_t>(chunk)] = maxSquared;
+            overlap[static_cast<std::size_t>(chunk)] = common;
+        }
+    });
+    double maxSquared = 0.0;
+    std::uint64_t common = 0;
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        maxSquared = std::max(maxSquared, farthest[static_cast<std::size_t>(chunk)]);
+        common += overlap[static_cast<std::size_t>(chunk)];
+    }
+
+    // 圆形度 F/(π·max²)，单像素时 max = 0 取1 | Circularity, 1 for a single pixel
+    const double pi = std::acos(-1.0);
+    features.circularity = maxSquared > 0.0 ? std::min(1.0, area / (pi * maxSquared)) : 1.0;
+
+    // 矩形度 1 − |A Δ R| / |A|，|A Δ R| = |A| + |R| − 2|A ∩ R| | Rectangularity from the symmetric difference
+    const double extent = rectangle.halfLength * std::fabs(rectangle.sine)
+                          + rectangle.halfWidth * std::fabs(rectangle.cosine);
+    const int rectRow1 = static_cast<int>(std::ceil(rectangle.row - extent - 1e-9));
+    const int rectRow2 = static_cast<int>(std::floor(rectangle.row + extent + 1e-9));
+    std::uint64_t rectangleArea = 0;
+    for (int y = rectRow1; y <= rectRow2; ++y) {
+        int begin = 0;
+        int end = 0;
+        rectangle.columns(y, begin, end);
+        if (begin < end) {
+            rectangleArea += static_cast<std::uint64_t>(end - begin);
+        }
+    }
+    const double difference = area + static_cast<double>(rectangleArea) - 2.0 * static_cast<double>(common);
+    features.rectangularity = std::max(0.0, std::min(1.0, 1.0 - difference / area));
+    return features;
+}
+
+} // namespace vk
@@ -0,0 +1,34 @@
+#ifndef VK_SIMDDISPATCH_H
+#define VK_SIMDDISPATCH_H
+
+//
+// 指令集检测与目标属性（仅供库内部使用）| Instruction set detection and target attributes (internal)
+//
+// x86-64 以 SSE2 为基线，AVX2 函数用目标属性单独编译并在运行时按CPU选择，因此不需要全局 -mavx2；
+// ARMv8 以 NEON 为基线。其他平台只编译标量实现。
+// SSE2 is the x86-64 baseline; AVX2 functions are compiled with a target attribute and selected at runtime,
+// so no global -mavx2 is needed. NEON is the ARMv8 baseline. Other targets build the scalar code only.
+//
+
+#include "../inc/KernelRuntime.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VK_HAVE_SSE2 1
+#define VK_HAVE_AVX2 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define VK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VK_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || (defined(__ARM_NEON) && defined(__ARM_FP))
+#define VK_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>   // __cpuidex、_BitScanForward
+#endif
+
+#endif // VK_SIMDDISPATCH_H
@@ -0,0 +1,102 @@
+#ifndef VK_TESTSUPPORT_H
+#define VK_TESTSUPPORT_H
+
+#include "KernelRuntime.h"
+#include "Region.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace vk {
+namespace test {
+
+/**
+ * @brief 失败计数与断言宏 | Failure counter and check macro
+ *
+ * 🎯 每个测试程序是一个独立可执行文件，失败时打印位置并继续，main 返回失败数（ctest 以非0为失败）。
+ * Each test is a standalone executable; a failed check prints its location and continues, and main returns the
+ * failure count (non-zero fails under ctest).
+ */
+inline int& failures()
+{
+    static int count = 0;
+    return count;
+}
+
+#define VK_CHECK(condition, ...)                                                                   \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            ++vk::test::failures();                                                                \
+            std::printf("%s:%d: check failed: %s | ", __FILE__, __LINE__, #condition);             \
+            std::printf(__VA_ARGS__);                                                              \
+            std::printf("\n");                                                                     \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief 本机可用的全部指令集级别（标量在前）| Every SIMD level usable on this machine, scalar first
+ */
+inline std::vector<SimdLevel> simdLevels()
+{
+    std::vector<SimdLevel> levels{SimdLevel::Scalar};
+    const SimdLevel detected = detectedSimdLevel();
+    if (detected == SimdLevel::NEON) {
+        levels.push_back(SimdLevel::NEON);
+    } else {
+        for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2}) {
+            if (static_cast<int>(level) <= static_cast<int>(detected)) {
+                levels.push_back(level);
+            }
+        }
+    }
+    return levels;
+}
+
+inline bool sameRuns(const RunList& a, const RunList& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].row != b[i].row || a[i].begin != b[i].begin || a[i].end != b[i].end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 由逐像素判定生成规范行程 | Canonical runs from a per-pixel predicate
+ */
+template <typename Predicate>
+RunList runsFromPredicate(int width, int height, Predicate inside)
+{
+    RunList runs;
+    for (int y = 0; y < height; ++y) {
+        int x = 0;
+        while (x < width) {
+            if (!inside(x, y)) {
+                ++x;
+                continue;
+            }
+            const int begin = x;
+            while (x < width && inside(x, y)) {
+                ++x;
+            }
+            runs.push_back(Run{y, begin, x});
+        }
+    }
+    return runs;
+}
+
+inline int finish(const char* name)
+{
+    setSimdLevel(detectedSimdLevel());
+    std::printf("%s: %s (%d failures)\n", name, failures() == 0 ? "passed" : "FAILED", failures());
+    return failures() == 0 ? 0 : 1;
+}
+
+} // namespace test
+} // namespace vk
+
+#endif // VK_TESTSUPPORT_H
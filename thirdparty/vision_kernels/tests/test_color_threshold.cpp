@@ -0,0 +1,189 @@
+//
+// 颜色阈值与逐像素参考实现对比 | Colour thresholds against a per-pixel reference
+//
+
+#include "ColorThreshold.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace vk;
+
+namespace {
+
+bool inRange(int value, ChannelRange range)
+{
+    return value >= range.min && value <= range.max;
+}
+
+// 与 trans_from_rgb 'hsv' 相同的整数换算，色调区间可跨越0 | Integer HSV as trans_from_rgb, hue may wrap
+bool referenceHsv(int r, int g, int b, ChannelRange hue, ChannelRange saturation, ChannelRange value)
+{
+    const int maxValue = std::max({r, g, b});
+    const int minValue = std::min({r, g, b});
+    const int delta = maxValue - minValue;
+    int h = 0;
+    int s = 0;
+    if (delta > 0) {
+        int sector;
+        if (maxValue == r) {
+            sector = g - b;
+        } else if (maxValue == g) {
+            sector = 2 * delta + b - r;
+        } else {
+            sector = 4 * delta + r - g;
+        }
+        if (sector < 0) {
+            sector += 6 * delta;
+        }
+        h = (85 * sector + delta) / (2 * delta);
+        s = (510 * delta + maxValue) / (2 * maxValue);
+    }
+    const bool hueInside = hue.min <= hue.max ? inRange(h, hue) : (h >= hue.min || h <= hue.max);
+    return hueInside && inRange(s, saturation) && inRange(maxValue, value);
+}
+
+struct ColourImage {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> red, green, blue;
+};
+
+void checkImage(const ColourImage& image, std::mt19937& rng, const std::vector<ChannelRange>& rgb,
+                const std::vector<ChannelRange>& hsv)
+{
+    const int width = image.width;
+    const int height = image.height;
+    const PlanarRgb planar{ConstView8(image.red.data(), width, height), ConstView8(image.green.data(), width, height),
+                           ConstView8(image.blue.data(), width, height)};
+
+    // 打包格式：RGB/BGR，3或4通道，行末带填充 | Packed RGB/BGR with 3 or 4 channels and row padding
+    const int channels = 3 + static_cast<int>(rng() % 2);
+    const bool bgr = rng() % 2 != 0;
+    const int stride = width * channels + 5;
+    std::vector<std::uint8_t> packed(static_cast<std::size_t>(stride) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int i = y * width + x;
+            std::uint8_t* pixel = &packed[static_cast<std::size_t>(y) * stride + x * channels];
+            pixel[bgr ? 2 : 0] = image.red[i];
+            pixel[1] = image.green[i];
+            pixel[bgr ? 0 : 2] = image.blue[i];
+            if (channels == 4) {
+                pixel[3] = static_cast<std::uint8_t>(rng());
+            }
+        }
+    }
+    const PackedRgb interleaved(packed.data(), width, height, stride, channels, bgr ? PixelOrder::BGR : PixelOrder::RGB);
+
+    const RunList expectedRgb = test::runsFromPredicate(width, height, [&](int x, int y) {
+        const int i = y * width + x;
+        return inRange(image.red[i], rgb[0]) && inRange(image.green[i], rgb[1]) && inRange(image.blue[i], rgb[2]);
+    });
+    const RunList expectedHsv = test::runsFromPredicate(width, height, [&](int x, int y) {
+        const int i = y * width + x;
+        return referenceHsv(image.red[i], image.green[i], image.blue[i], hsv[0], hsv[1], hsv[2]);
+    });
+
+    for (SimdLevel level : test::simdLevels()) {
+        setSimdLevel(level);
+        const char* name = simdLevelName(level);
+        RunList runs;
+        thresholdRgb(planar, rgb[0], rgb[1], rgb[2], runs);
+        VK_CHECK(test::sameRuns(runs, expectedRgb), "rgb planar %s %dx%d", name, width, height);
+        thresholdRgb(interleaved, rgb[0], rgb[1], rgb[2], runs);
+        VK_CHECK(test::sameRuns(runs, expectedRgb), "rgb packed %s %dx%d channels=%d bgr=%d", name, width, height,
+                 channels, bgr);
+        thresholdHsv(planar, hsv[0], hsv[1], hsv[2], runs);
+        VK_CHECK(test::sameRuns(runs, expectedHsv), "hsv planar %s %dx%d hue=[%d,%d]", name, width, height, hsv[0].min,
+                 hsv[0].max);
+        thresholdHsv(interleaved, hsv[0], hsv[1], hsv[2], runs);
+        VK_CHECK(test::sameRuns(runs, expectedHsv), "hsv packed %s %dx%d channels=%d bgr=%d", name, width, height,
+                 channels, bgr);
+    }
+}
+
+// 随机尺寸的块状彩色图（含灰色和饱和红色块）| Random sizes with grey and saturated red blocks
+void checkRandomImages()
+{
+    std::mt19937 rng(7);
+    for (int iteration = 0; iteration < 40; ++iteration) {
+        ColourImage image;
+        image.width = 1 + static_cast<int>(rng() % 300);
+        image.height = 1 + static_cast<int>(rng() % 40);
+        const int count = image.width * image.height;
+        image.red.resize(count);
+        image.green.resize(count);
+        image.blue.resize(count);
+        for (int i = 0; i < count; ++i) {
+            image.red[i] = static_cast<std::uint8_t>(rng());
+            image.green[i] = static_cast<std::uint8_t>(rng());
+            image.blue[i] = static_cast<std::uint8_t>(rng());
+            const int block = (i / 7) % 5;
+            if (block == 0) {
+                image.green[i] = image.blue[i] = image.red[i];
+            } else if (block == 1) {
+                image.red[i] = 200;
+                image.green[i] = 30;
+                image.blue[i] = static_cast<std::uint8_t>(rng() % 60);
+            }
+        }
+        std::vector<ChannelRange> rgb(3);
+        for (ChannelRange& range : rgb) {
+            range.min = static_cast<int>(rng() % 200);
+            range.max = range.min + static_cast<int>(rng() % 120);
+        }
+        std::vector<ChannelRange> hsv{{static_cast<int>(rng() % 256), static_cast<int>(rng() % 256)},
+                                      {static_cast<int>(rng() % 150), 255},
+                                      {static_cast<int>(rng() % 100), 150 + static_cast<int>(rng() % 106)}};
+        if (iteration % 5 == 0) {
+            hsv[0] = {0, 255};
+            hsv[1] = {0, 0};
+        }
+        checkImage(image, rng, rgb, hsv);
+    }
+}
+
+// 颜色空间抽样（红色全取值，绿/蓝每隔5级）覆盖各色调扇区与边界 | Sampled colour cube covering every hue sector
+void checkColourCube()
+{
+    ColourImage image;
+    image.width = 256;
+    image.height = 52 * 52;
+    const int count = image.width * image.height;
+    image.red.resize(count);
+    image.green.resize(count);
+    image.blue.resize(count);
+    for (int y = 0; y < image.height; ++y) {
+        for (int x = 0; x < image.width; ++x) {
+            const int i = y * image.width + x;
+            image.red[i] = static_cast<std::uint8_t>(x);
+            image.green[i] = static_cast<std::uint8_t>((y / 52) * 5);
+            image.blue[i] = static_cast<std::uint8_t>((y % 52) * 5);
+        }
+    }
+    std::mt19937 rng(11);
+    const std::vector<ChannelRange> rgb{{10, 120}, {0, 255}, {100, 200}};
+    const std::vector<std::vector<ChannelRange>> hsvRanges{
+        {{20, 40}, {50, 200}, {30, 250}},
+        {{240, 15}, {1, 255}, {0, 255}},
+        {{0, 0}, {0, 0}, {10, 10}},
+        {{255, 255}, {255, 255}, {0, 255}},
+    };
+    for (const std::vector<ChannelRange>& hsv : hsvRanges) {
+        checkImage(image, rng, rgb, hsv);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    setThreadCount(3);
+    checkRandomImages();
+    checkColourCube();
+    return test::finish("test_color_threshold");
+}
@@ -0,0 +1,148 @@
+//
+// 滤波内核与逐像素参考实现对比 | Filter kernels against a per-pixel reference
+//
+
+#include "ImageFilters.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace vk;
+
+namespace {
+
+// 镜像边界下的暴力中值 | Brute-force median with mirrored borders
+template <typename T>
+int referenceMedian(const Image<T>& image, int x, int y, int radius, MedianMask mask)
+{
+    std::vector<T> values;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        const int halfWidth = mask == MedianMask::Circle
+            ? static_cast<int>(std::floor(std::sqrt(static_cast<double>(radius * radius - dy * dy)) + 0.5))
+            : radius;
+        for (int dx = -halfWidth; dx <= halfWidth; ++dx) {
+            values.push_back(image.view().at(mirrorIndex(x + dx, image.width()), mirrorIndex(y + dy, image.height())));
+        }
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+// 与 mean_image 相同的掩膜参考点和四舍五入 | Same anchor and rounding as mean_image
+template <typename T>
+int referenceBox(const Image<T>& image, int x, int y, int maskWidth, int maskHeight)
+{
+    long long sum = 0;
+    for (int dy = -(maskHeight / 2); dy <= maskHeight - 1 - maskHeight / 2; ++dy) {
+        for (int dx = -(maskWidth / 2); dx <= maskWidth - 1 - maskWidth / 2; ++dx) {
+            sum += image.view().at(mirrorIndex(x + dx, image.width()), mirrorIndex(y + dy, image.height()));
+        }
+    }
+    return static_cast<int>(sum / static_cast<double>(maskWidth * maskHeight) + 0.5);
+}
+
+template <typename T>
+Image<T> randomImage(int width, int height, int maxValue, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    Image<T> image(width, height);
+    for (int i = 0; i < width * height; ++i) {
+        image.data()[i] = static_cast<T>(rng() % (maxValue + 1));
+    }
+    return image;
+}
+
+template <typename T>
+void checkFilters(int width, int height, int maxValue)
+{
+    const Image<T> image = randomImage<T>(width, height, maxValue, static_cast<unsigned>(width * 7 + height));
+    Image<T> output(width, height);
+    Image<T> reference(width, height);
+
+    setSimdLevel(SimdLevel::Scalar);
+    VK_CHECK(gaussianFilter(image.view(), reference.view(), 1.7), "gaussian %dx%d", width, height);
+
+    for (SimdLevel level : test::simdLevels()) {
+        setSimdLevel(level);
+        const char* name = simdLevelName(level);
+
+        for (int radius : {1, 2, 3, 5}) {
+            for (MedianMask mask : {MedianMask::Square, MedianMask::Circle}) {
+                VK_CHECK(medianFilter(image.view(), output.view(), radius, mask), "median %s r=%d", name, radius);
+                int mismatches = 0;
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        mismatches += output.view().at(x, y) != referenceMedian(image, x, y, radius, mask);
+                    }
+                }
+                VK_CHECK(mismatches == 0, "median %s %dx%d r=%d circle=%d: %d pixels differ", name, width, height,
+                         radius, mask == MedianMask::Circle, mismatches);
+            }
+        }
+
+        for (const std::pair<int, int>& size : std::vector<std::pair<int, int>>{{1, 1}, {3, 3}, {4, 5}, {15, 2}, {40, 40}}) {
+            VK_CHECK(boxFilter(image.view(), output.view(), size.first, size.second), "box %s", name);
+            int mismatches = 0;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    mismatches += output.view().at(x, y) != referenceBox(image, x, y, size.first, size.second);
+                }
+            }
+            VK_CHECK(mismatches == 0, "box %s %dx%d mask %dx%d: %d pixels differ", name, width, height, size.first,
+                     size.second, mismatches);
+        }
+
+        // 高斯的SIMD路径与标量路径最多相差1（浮点累加顺序不同）| SIMD may differ from scalar by one grey level
+        VK_CHECK(gaussianFilter(image.view(), output.view(), 1.7), "gaussian %s", name);
+        int worst = 0;
+        for (int i = 0; i < width * height; ++i) {
+            worst = std::max(worst, std::abs(static_cast<int>(output.data()[i]) - static_cast<int>(reference.data()[i])));
+        }
+        VK_CHECK(worst <= 1, "gaussian %s %dx%d differs from scalar by %d", name, width, height, worst);
+    }
+}
+
+void checkConstantImage()
+{
+    Image<std::uint8_t> image(50, 50);
+    std::fill(image.data(), image.data() + 2500, std::uint8_t(123));
+    Image<std::uint8_t> output(50, 50);
+    for (SimdLevel level : test::simdLevels()) {
+        setSimdLevel(level);
+        gaussianFilter(image.view(), output.view(), 2.0);
+        VK_CHECK(std::all_of(output.data(), output.data() + 2500, [](std::uint8_t v) { return v == 123; }),
+                 "gaussian %s changes a constant image", simdLevelName(level));
+    }
+}
+
+void checkInvalidArguments()
+{
+    Image<std::uint8_t> image(8, 8);
+    Image<std::uint8_t> output(8, 8);
+    Image<std::uint8_t> smaller(4, 4);
+    VK_CHECK(!gaussianFilter(image.view(), output.view(), 0.0), "sigma 0 accepted");
+    VK_CHECK(!boxFilter(image.view(), smaller.view(), 3, 3), "size mismatch accepted");
+    VK_CHECK(!medianFilter(image.view(), output.view(), 0), "radius 0 accepted");
+    VK_CHECK(!medianFilter(image.view(), image.view(), 1), "in-place filtering accepted");
+}
+
+} // namespace
+
+int main()
+{
+    setThreadCount(3);
+    checkFilters<std::uint8_t>(37, 29, 255);
+    checkFilters<std::uint8_t>(5, 3, 255);
+    checkFilters<std::uint8_t>(70, 40, 255);
+    checkFilters<std::uint16_t>(33, 21, 65535);
+    checkFilters<std::uint16_t>(40, 50, 4095);
+    checkConstantImage();
+    checkInvalidArguments();
+    return test::finish("test_filters");
+}
@@ -0,0 +1,116 @@
+//
+// 一维测量与解析边缘位置对比 | 1D measuring against analytic edge positions
+//
+
+#include "Measure1D.h"
+#include "TestSupport.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace vk;
+
+namespace {
+
+// 垂直于 phi 的亮条，8x8 超采样抗锯齿 | Bright bar across phi, anti-aliased by 8x8 supersampling
+std::vector<std::uint8_t> barImage(int width, int height, double row, double column, double phi, double edge1,
+                                   double edge2)
+{
+    const double directionRow = -std::sin(phi);
+    const double directionColumn = std::cos(phi);
+    std::vector<std::uint8_t> image(static_cast<std::size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int inside = 0;
+            for (int sy = 0; sy < 8; ++sy) {
+                for (int sx = 0; sx < 8; ++sx) {
+                    const double r = y + (sy + 0.5) / 8 - 0.5;
+                    const double c = x + (sx + 0.5) / 8 - 0.5;
+                    const double t = (r - row) * directionRow + (c - column) * directionColumn;
+                    inside += t > edge1 && t < edge2;
+                }
+            }
+            image[static_cast<std::size_t>(y) * width + x] = static_cast<std::uint8_t>(std::lround(40 + 160.0 * inside / 64));
+        }
+    }
+    return image;
+}
+
+bool sameProfiles(ConstView8 view, const MeasureRectangle& rectangle, std::vector<float>& reference)
+{
+    setSimdLevel(SimdLevel::Scalar);
+    measureProfile(view, rectangle, reference);
+    for (SimdLevel level : test::simdLevels()) {
+        setSimdLevel(level);
+        std::vector<float> profile;
+        measureProfile(view, rectangle, profile);
+        if (profile != reference) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void checkBars()
+{
+    std::mt19937 rng(3);
+    for (int iteration = 0; iteration < 60; ++iteration) {
+        const int width = 64 + static_cast<int>(rng() % 300);
+        const int height = 64 + static_cast<int>(rng() % 300);
+        const double phi = (rng() % 6283) / 1000.0;
+        const double row = height / 2.0 + static_cast<int>(rng() % 20) - 10;
+        const double column = width / 2.0 + static_cast<int>(rng() % 20) - 10;
+        const double edge1 = -(5.0 + rng() % 20) - 0.37 * (rng() % 3);
+        const double edge2 = (5.0 + rng() % 20) + 0.21 * (rng() % 4);
+        const std::vector<std::uint8_t> image = barImage(width, height, row, column, phi, edge1, edge2);
+        const ConstView8 view(image.data(), width, height);
+
+        // 所有指令集级别的剖面逐位一致 | Profiles are bit-identical across SIMD levels
+        const MeasureRectangle rectangle{row, column, phi, 40, 8};
+        std::vector<float> profile;
+        VK_CHECK(sameProfiles(view, rectangle, profile), "profile differs across SIMD levels, phi=%f", phi);
+
+        MeasureOptions options;
+        options.sigma = 1.0;
+        options.threshold = 20;
+        std::vector<EdgePair> pairs;
+        VK_CHECK(measurePairs(view, rectangle, options, pairs), "measurePairs failed, phi=%f", phi);
+        VK_CHECK(pairs.size() == 1, "%zu pairs, phi=%f", pairs.size(), phi);
+        if (pairs.size() == 1) {
+            const EdgePair& pair = pairs.front();
+            VK_CHECK(std::fabs(pair.width - (edge2 - edge1)) <= 0.1, "width %f vs %f, phi=%f", pair.width,
+                     edge2 - edge1, phi);
+            VK_CHECK(std::fabs(pair.first.position - 40 - edge1) <= 0.1 && std::fabs(pair.second.position - 40 - edge2) <= 0.1,
+                     "positions %f,%f vs %f,%f, phi=%f", pair.first.position - 40, pair.second.position - 40, edge1,
+                     edge2, phi);
+            VK_CHECK(pair.first.amplitude > 0 && pair.second.amplitude < 0, "pair polarity %f,%f", pair.first.amplitude,
+                     pair.second.amplitude);
+        }
+
+        // 超出右下边界的矩形走镜像/裁剪路径 | A rectangle past the bottom-right border
+        const MeasureRectangle border{height - 1.3, width - 2.0, phi, 60, 5};
+        VK_CHECK(sameProfiles(view, border, profile), "border profile differs across SIMD levels, phi=%f", phi);
+    }
+}
+
+void checkStrongestEdge()
+{
+    std::vector<Edge> edges(3);
+    edges[0].amplitude = 25;
+    edges[1].amplitude = -60;
+    edges[2].amplitude = 40;
+    Edge edge;
+    VK_CHECK(strongestEdge(edges, edge) && edge.amplitude == -60, "strongest amplitude %f", edge.amplitude);
+    VK_CHECK(!strongestEdge(std::vector<Edge>(), edge), "empty edge list accepted");
+}
+
+} // namespace
+
+int main()
+{
+    checkBars();
+    checkStrongestEdge();
+    return test::finish("test_measure1d");
+}
@@ -0,0 +1,264 @@
+//
+// 区域运算与位图暴力实现对比 | Region operations against a brute-force bitmap
+//
+
+#include "Region.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace vk;
+
+namespace {
+
+constexpr int kWidth = 48;
+constexpr int kHeight = 40;
+constexpr int kMargin = 12;   // 位图覆盖 [-kMargin, size + kMargin)，容纳膨胀结果 | Room for dilation
+
+// 带边距的布尔位图 | Boolean bitmap with a margin around the image
+struct Bitmap {
+    static constexpr int kStride = kWidth + 2 * kMargin;
+    std::vector<char> bits = std::vector<char>((kHeight + 2 * kMargin) * kStride, 0);
+
+    static bool contains(int row, int column)
+    {
+        return row >= -kMargin && row < kHeight + kMargin && column >= -kMargin && column < kWidth + kMargin;
+    }
+    static int index(int row, int column) { return (row + kMargin) * kStride + column + kMargin; }
+    bool get(int row, int column) const { return contains(row, column) && bits[index(row, column)]; }
+    void set(int row, int column, bool value) { bits[index(row, column)] = value; }
+
+    template <typename Predicate>
+    static Bitmap from(Predicate inside)
+    {
+        Bitmap bitmap;
+        for (int row = -kMargin; row < kHeight + kMargin; ++row) {
+            for (int column = -kMargin; column < kWidth + kMargin; ++column) {
+                bitmap.set(row, column, inside(row, column));
+            }
+        }
+        return bitmap;
+    }
+
+    // 逐像素的单点行程，由 Region 构造函数规范化 | One run per pixel, canonicalised by Region
+    Region region() const
+    {
+        RunList runs;
+        for (int row = -kMargin; row < kHeight + kMargin; ++row) {
+            for (int column = -kMargin; column < kWidth + kMargin; ++column) {
+                if (get(row, column)) {
+                    runs.push_back(Run{row, column, column + 1});
+                }
+            }
+        }
+        return Region(runs);
+    }
+};
+
+bool sameRegion(const Region& a, const Region& b)
+{
+    return test::sameRuns(a.runs(), b.runs());
+}
+
+Bitmap randomBitmap(std::mt19937& rng, int iteration)
+{
+    if (iteration % 3 == 0) {
+        // 若干圆斑 | A few discs
+        Bitmap bitmap;
+        for (int k = 0; k < 6; ++k) {
+            const int row0 = static_cast<int>(rng() % kHeight);
+            const int column0 = static_cast<int>(rng() % kWidth);
+            const int radius = static_cast<int>(rng() % 6);
+            for (int row = std::max(0, row0 - radius); row <= std::min(kHeight - 1, row0 + radius); ++row) {
+                for (int column = std::max(0, column0 - radius); column <= std::min(kWidth - 1, column0 + radius); ++column) {
+                    if ((row - row0) * (row - row0) + (column - column0) * (column - column0) <= radius * radius) {
+                        bitmap.set(row, column, true);
+                    }
+                }
+            }
+        }
+        return bitmap;
+    }
+    const unsigned density = static_cast<unsigned>((iteration % 4 + 1) * 150);
+    return Bitmap::from([&](int row, int column) {
+        return row >= 0 && row < kHeight && column >= 0 && column < kWidth && rng() % 1000 < density;
+    });
+}
+
+void checkSetOperations(const Bitmap& a, const Bitmap& b)
+{
+    const Region ra = a.region();
+    const Region rb = b.region();
+    const Bitmap unite = Bitmap::from([&](int r, int c) { return a.get(r, c) || b.get(r, c); });
+    const Bitmap intersect = Bitmap::from([&](int r, int c) { return a.get(r, c) && b.get(r, c); });
+    const Bitmap difference = Bitmap::from([&](int r, int c) { return a.get(r, c) && !b.get(r, c); });
+    VK_CHECK(sameRegion(unionRegions(ra, rb), unite.region()), "union");
+    VK_CHECK(sameRegion(unionRegions(std::vector<Region>{ra, rb}), unite.region()), "union of list");
+    VK_CHECK(sameRegion(intersectRegions(ra, rb), intersect.region()), "intersection");
+    VK_CHECK(sameRegion(subtractRegion(ra, rb), difference.region()), "difference");
+    VK_CHECK(sameRegion(translateRegion(ra, -3, 5), Bitmap::from([&](int r, int c) { return a.get(r + 3, c - 5); }).region()),
+             "translation");
+}
+
+// 结构元素偏移：膨胀取反射，腐蚀取原样 | Dilation uses the reflected element, erosion the element itself
+template <typename Element>
+void checkMorphology(const Bitmap& a, Element element, const Region& dilated, const Region& eroded, const char* what)
+{
+    const Bitmap dilation = Bitmap::from([&](int r, int c) {
+        bool any = false;
+        element([&](int dy, int dx) { any = any || a.get(r - dy, c - dx); });
+        return any;
+    });
+    const Bitmap erosion = Bitmap::from([&](int r, int c) {
+        bool all = true;
+        element([&](int dy, int dx) { all = all && a.get(r + dy, c + dx); });
+        return all;
+    });
+    VK_CHECK(sameRegion(dilated, dilation.region()), "dilate %s", what);
+    VK_CHECK(sameRegion(eroded, erosion.region()), "erode %s", what);
+}
+
+void checkComponents(const Bitmap& a, Connectivity connectivity)
+{
+    // 按首像素扫描顺序的泛洪标记 | Flood fill in scan order of the first pixel
+    std::vector<int> labels(a.bits.size(), -1);
+    std::vector<Region> expected;
+    for (int row = -kMargin; row < kHeight + kMargin; ++row) {
+        for (int column = -kMargin; column < kWidth + kMargin; ++column) {
+            if (!a.get(row, column) || labels[Bitmap::index(row, column)] >= 0) {
+                continue;
+            }
+            const int label = static_cast<int>(expected.size());
+            RunList pixels;
+            std::vector<std::pair<int, int>> stack{{row, column}};
+            labels[Bitmap::index(row, column)] = label;
+            while (!stack.empty()) {
+                const std::pair<int, int> pixel = stack.back();
+                stack.pop_back();
+                pixels.push_back(Run{pixel.first, pixel.second, pixel.second + 1});
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if ((dy == 0 && dx == 0) || (connectivity == Connectivity::Four && dy != 0 && dx != 0)) {
+                            continue;
+                        }
+                        const int y = pixel.first + dy;
+                        const int x = pixel.second + dx;
+                        if (a.get(y, x) && labels[Bitmap::index(y, x)] < 0) {
+                            labels[Bitmap::index(y, x)] = label;
+                            stack.push_back({y, x});
+                        }
+                    }
+                }
+            }
+            expected.push_back(Region(pixels));
+        }
+    }
+
+    const std::vector<Region> components = connectedComponents(a.region(), connectivity);
+    const int eight = connectivity == Connectivity::Eight;
+    VK_CHECK(components.size() == expected.size(), "components (eight=%d) %zu vs %zu", eight, components.size(),
+             expected.size());
+    if (components.size() == expected.size()) {
+        for (std::size_t i = 0; i < components.size(); ++i) {
+            VK_CHECK(sameRegion(components[i], expected[i]), "component %zu (eight=%d) differs", i, eight);
+        }
+    }
+}
+
+void checkFeatures(const Bitmap& a)
+{
+    double rowSum = 0.0;
+    double columnSum = 0.0;
+    std::uint64_t area = 0;
+    for (int row = -kMargin; row < kHeight + kMargin; ++row) {
+        for (int column = -kMargin; column < kWidth + kMargin; ++column) {
+            if (a.get(row, column)) {
+                rowSum += row;
+                columnSum += column;
+                ++area;
+            }
+        }
+    }
+    const RegionFeatures features = regionFeatures(a.region());
+    VK_CHECK(features.area == area, "area %llu vs %llu", static_cast<unsigned long long>(features.area),
+             static_cast<unsigned long long>(area));
+    if (area > 0) {
+        VK_CHECK(std::fabs(features.row - rowSum / area) < 1e-9 && std::fabs(features.column - columnSum / area) < 1e-9,
+                 "centroid %f,%f vs %f,%f", features.row, features.column, rowSum / area, columnSum / area);
+    }
+}
+
+void checkRandomRegions()
+{
+    std::mt19937 rng(7);
+    for (int iteration = 0; iteration < 120; ++iteration) {
+        const Bitmap a = randomBitmap(rng, iteration);
+        const Bitmap b = Bitmap::from([&](int row, int column) {
+            return row >= 0 && row < kHeight && column >= 0 && column < kWidth && rng() % 2 == 0;
+        });
+        checkSetOperations(a, b);
+
+        // 矩形：参考点与 Halcon 相同，偶数尺寸偏向右下 | Halcon anchor; even sizes extend right/down
+        const int width = static_cast<int>(rng() % 7) + 1;
+        const int height = static_cast<int>(rng() % 7) + 1;
+        checkMorphology(a,
+                        [&](auto visit) {
+                            for (int dy = -(height - 1) / 2; dy <= height / 2; ++dy) {
+                                for (int dx = -(width - 1) / 2; dx <= width / 2; ++dx) {
+                                    visit(dy, dx);
+                                }
+                            }
+                        },
+                        dilateRectangle(a.region(), width, height), erodeRectangle(a.region(), width, height),
+                        "rectangle");
+
+        const double radius = static_cast<double>(rng() % 50) / 10.0;
+        const int reach = static_cast<int>(std::floor(radius + 1e-9));
+        checkMorphology(a,
+                        [&](auto visit) {
+                            for (int dy = -reach; dy <= reach; ++dy) {
+                                for (int dx = -reach; dx <= reach; ++dx) {
+                                    if (dx * dx + dy * dy <= radius * radius + 1e-9) {
+                                        visit(dy, dx);
+                                    }
+                                }
+                            }
+                        },
+                        dilateCircle(a.region(), radius), erodeCircle(a.region(), radius), "circle");
+
+        checkComponents(a, Connectivity::Four);
+        checkComponents(a, Connectivity::Eight);
+        checkFeatures(a);
+    }
+}
+
+void checkShapeFeatures()
+{
+    const RegionFeatures rectangle = regionFeatures(Region::rectangle(10, 20, 29, 69));
+    VK_CHECK(rectangle.area == 20 * 50, "rectangle area %llu", static_cast<unsigned long long>(rectangle.area));
+    VK_CHECK(rectangle.row1 == 10 && rectangle.column1 == 20 && rectangle.row2 == 29 && rectangle.column2 == 69,
+             "rectangle bounding box %d,%d,%d,%d", rectangle.row1, rectangle.column1, rectangle.row2, rectangle.column2);
+    VK_CHECK(rectangle.rectangularity > 0.99, "rectangle rectangularity %f", rectangle.rectangularity);
+
+    RunList disc;
+    for (int row = -50; row <= 50; ++row) {
+        const int halfWidth = static_cast<int>(std::sqrt(2500.0 - row * row));
+        disc.push_back(Run{row, -halfWidth, halfWidth + 1});
+    }
+    const RegionFeatures circle = regionFeatures(Region(disc));
+    VK_CHECK(circle.circularity > 0.95, "disc circularity %f", circle.circularity);
+    VK_CHECK(circle.rectangularity < 0.95, "disc rectangularity %f", circle.rectangularity);
+}
+
+} // namespace
+
+int main()
+{
+    checkRandomRegions();
+    checkShapeFeatures();
+    return test::finish("test_region");
+}
@@ -0,0 +1,150 @@
+//
+// 图像统计与逐像素参考实现对比 | Image statistics against a per-pixel reference
+//
+
+#include "ImageStatistics.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace vk;
+
+namespace {
+
+// 全图(runs为空)或区域内逐像素累加 | Per-pixel accumulation over the image or a region
+template <typename T>
+ImageStatistics referenceStatistics(const Image<T>& image, const RunList* runs)
+{
+    ImageStatistics stats;
+    stats.reset();
+    stats.histogramShift = sizeof(T) == 1 ? 0 : 8;
+    double sum = 0.0, sumSquares = 0.0, laplacianSum = 0.0, laplacianSquares = 0.0, gradient = 0.0;
+    int minValue = 1 << 30;
+    int maxValue = -1;
+    auto value = [&](int x, int y) { return static_cast<double>(image.view().at(x, y)); };
+    auto visit = [&](int y, int begin, int end) {
+        for (int x = begin; x < end; ++x) {
+            const double v = value(x, y);
+            sum += v;
+            sumSquares += v * v;
+            minValue = std::min(minValue, static_cast<int>(v));
+            maxValue = std::max(maxValue, static_cast<int>(v));
+            stats.count++;
+            stats.histogram[static_cast<int>(v) >> stats.histogramShift]++;
+            if (y > 0 && y < image.height() - 1 && x > 0 && x < image.width() - 1) {
+                const double laplacian = 4 * v - value(x, y - 1) - value(x, y + 1) - value(x - 1, y) - value(x + 1, y);
+                const double gx = value(x + 1, y - 1) + 2 * value(x + 1, y) + value(x + 1, y + 1)
+                    - value(x - 1, y - 1) - 2 * value(x - 1, y) - value(x - 1, y + 1);
+                const double gy = value(x - 1, y + 1) + 2 * value(x, y + 1) + value(x + 1, y + 1)
+                    - value(x - 1, y - 1) - 2 * value(x, y - 1) - value(x + 1, y - 1);
+                laplacianSum += laplacian;
+                laplacianSquares += laplacian * laplacian;
+                gradient += gx * gx + gy * gy;
+                stats.sharpnessCount++;
+            }
+        }
+    };
+    if (runs) {
+        for (const Run& run : *runs) {
+            if (run.row >= 0 && run.row < image.height()) {
+                visit(run.row, std::max(0, run.begin), std::min(image.width(), run.end));
+            }
+        }
+    } else {
+        for (int y = 0; y < image.height(); ++y) {
+            visit(y, 0, image.width());
+        }
+    }
+    const double n = static_cast<double>(stats.count);
+    const double sharp = static_cast<double>(stats.sharpnessCount);
+    stats.mean = sum / n;
+    stats.variance = sumSquares / n - stats.mean * stats.mean;
+    stats.minValue = minValue;
+    stats.maxValue = maxValue;
+    stats.laplacianVariance = laplacianSquares / sharp - (laplacianSum / sharp) * (laplacianSum / sharp);
+    stats.tenengrad = gradient / sharp;
+    stats.median = histogramPercentile(stats, 50);
+    return stats;
+}
+
+bool close(double a, double b)
+{
+    return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(b));
+}
+
+void compare(const ImageStatistics& got, const ImageStatistics& expected, const char* level, const char* what)
+{
+    VK_CHECK(got.count == expected.count, "%s %s count %llu vs %llu", level, what,
+             static_cast<unsigned long long>(got.count), static_cast<unsigned long long>(expected.count));
+    VK_CHECK(close(got.mean, expected.mean), "%s %s mean %f vs %f", level, what, got.mean, expected.mean);
+    VK_CHECK(close(got.variance, expected.variance), "%s %s variance %f vs %f", level, what, got.variance,
+             expected.variance);
+    VK_CHECK(got.minValue == expected.minValue && got.maxValue == expected.maxValue, "%s %s min/max %d/%d vs %d/%d",
+             level, what, got.minValue, got.maxValue, expected.minValue, expected.maxValue);
+    VK_CHECK(got.histogram == expected.histogram, "%s %s histogram differs", level, what);
+    VK_CHECK(got.median == expected.median, "%s %s median %d vs %d", level, what, got.median, expected.median);
+    VK_CHECK(got.sharpnessCount == expected.sharpnessCount, "%s %s sharpness count differs", level, what);
+    VK_CHECK(close(got.laplacianVariance, expected.laplacianVariance), "%s %s laplacian %f vs %f", level, what,
+             got.laplacianVariance, expected.laplacianVariance);
+    VK_CHECK(close(got.tenengrad, expected.tenengrad), "%s %s tenengrad %f vs %f", level, what, got.tenengrad,
+             expected.tenengrad);
+}
+
+template <typename T>
+void checkStatistics(int width, int height, int maxValue)
+{
+    std::mt19937 rng(static_cast<unsigned>(width + height));
+    Image<T> image(width, height);
+    for (int i = 0; i < width * height; ++i) {
+        image.data()[i] = static_cast<T>(rng() % (maxValue + 1));
+    }
+    // 部分超出图像、可能重叠的行程 | Runs partly outside the image
+    RunList runs;
+    for (int i = 0; i < 200; ++i) {
+        Run run;
+        run.row = static_cast<int>(rng() % (height + 4)) - 2;
+        run.begin = static_cast<int>(rng() % (width + 10)) - 5;
+        run.end = run.begin + static_cast<int>(rng() % width);
+        runs.push_back(run);
+    }
+
+    const ImageStatistics full = referenceStatistics(image, nullptr);
+    const ImageStatistics region = referenceStatistics(image, &runs);
+    for (SimdLevel level : test::simdLevels()) {
+        setSimdLevel(level);
+        ImageStatistics stats;
+        VK_CHECK(computeStatistics(image.view(), stats), "%s full image rejected", simdLevelName(level));
+        compare(stats, full, simdLevelName(level), "full");
+        VK_CHECK(computeStatistics(image.view(), runs, stats), "%s runs rejected", simdLevelName(level));
+        compare(stats, region, simdLevelName(level), "runs");
+    }
+}
+
+void checkPercentiles()
+{
+    ImageStatistics stats;
+    stats.reset();
+    for (int v = 0; v < 100; ++v) {
+        stats.histogram[v] = 1;
+    }
+    stats.count = 100;
+    VK_CHECK(histogramPercentile(stats, 0) == 0, "p0 = %d", histogramPercentile(stats, 0));
+    VK_CHECK(histogramPercentile(stats, 50) == 49, "p50 = %d", histogramPercentile(stats, 50));
+    VK_CHECK(histogramPercentile(stats, 100) == 99, "p100 = %d", histogramPercentile(stats, 100));
+}
+
+} // namespace
+
+int main()
+{
+    setThreadCount(3);
+    checkStatistics<std::uint8_t>(37, 29, 255);
+    checkStatistics<std::uint8_t>(1000, 300, 255);
+    checkStatistics<std::uint8_t>(3, 3, 255);
+    checkStatistics<std::uint16_t>(50, 40, 65535);
+    checkPercentiles();
+    return test::finish("test_statistics");
+}
@@ -0,0 +1,270 @@
+/**
+ * @file main.cpp
+ * @brief 无界面批量检测工具 | Headless batch inspection runner
+ *
+ * 用与界面程序相同的检测核心（TemplateCache + InspectionCore/InspectionPool + InspectionPipeline）
+ * 处理一个图像目录，输出逐图结果 CSV 和吞吐量/耗时报告。用于回归测试和产能评估。
+ *
+ * 用法:
+ *   MyOperationBatch -i <图像目录> -t <模板目录> [-m <测量区域目录>] [-j <线程数>] [-o <输出目录>]
+ *
+ * 只依赖 QtCore/QtConcurrent（QCoreApplication，测量使用无界面的 HalconMeasure），
+ * 可在无显示器的 Linux 服务器上运行。
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+
+#include <cstdio>
+
+#include "thread/InspectionCore.h"
+#include "thread/InspectionPipeline.h"
+#include "thread/InspectionPool.h"
+#include "thread/LatencyProfiler.h"
+#include "thread/TemplateCache.h"
+#include "simplecategorylogger.h"
+
+#define SYSTEM "VisualWorkThread"
+
+namespace
+{
+// 批次汇总计数（只在发布线程中修改）
+struct BatchTotals {
+  int images = 0;
+  int matched = 0;
+  int measured = 0;
+};
+
+void printLine(const QString& text)
+{
+  std::fprintf(stdout, "%s\n", text.toLocal8Bit().constData());
+  std::fflush(stdout);
+}
+
+void printError(const QString& text)
+{
+  std::fprintf(stderr, "%s\n", text.toLocal8Bit().constData());
+}
+
+void initLog(const QString& logDir)
+{
+  auto& logger = SimpleCategoryLogger::instance();
+  logger.initCategory(SYSTEM, logDir);
+  logger.setDefaultMaxLogFileSize(10 * 1024 * 1024); // 10MB
+  logger.setMaxHistoryFileCount(30);
+  logger.setDebugConfig(false, true, true); // 不输出到控制台，控制台只保留进度和报告
+}
+
+QFileInfoList collectImages(const QString& imageDir)
+{
+  QDir dir(imageDir);
+  QStringList filters;
+  filters << "*.bmp" << "*.jpg" << "*.jpeg" << "*.png" << "*.tiff" << "*.tif";
+  dir.setNameFilters(filters);
+  dir.setSorting(QDir::Name);
+  return dir.entryInfoList(QDir::Files);
+}
+}
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("MyOperationBatch");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("MyOperation headless batch inspection runner");
+  parser.addHelpOption();
+  QCommandLineOption imageOption({"i", "images"}, "Image directory.", "dir");
+  QCommandLineOption templateOption({"t", "templates"}, "Template directory (*.shm + *data.tup).", "dir");
+  QCommandLineOption measureOption({"m", "measure"}, "Measure region directory (default: template directory).", "dir");
+  QCommandLineOption threadOption({"j", "threads"}, "Inspection thread count (default: CPU cores).", "n");
+  QCommandLineOption prefetchOption({"p", "prefetch"}, "Images decoded ahead of inspection (default: 4).", "n", "4");
+  QCommandLineOption outputOption({"o", "output"}, "Output directory for results.csv and report.txt.", "dir", "batch_output");
+  QCommandLineOption trackingOption("tracking", "Enable temporal-coherence search window.");
+  QCommandLineOption speculativeOption("speculative", "Run fast and precise matching concurrently.");
+  parser.addOptions({imageOption, templateOption, measureOption, threadOption, prefetchOption, outputOption,
+                     trackingOption, speculativeOption});
+  parser.process(app);
+
+  if (!parser.isSet(imageOption) || !parser.isSet(templateOption))
+  {
+    printError("必须指定图像目录 (-i) 和模板目录 (-t)");
+    parser.showHelp(2);
+  }
+
+  QString imageDir = parser.value(imageOption);
+  QString templateDir = parser.value(templateOption);
+  QString measureDir = parser.isSet(measureOption) ? parser.value(measureOption) : templateDir;
+  int threadCount = parser.isSet(threadOption) ? parser.value(threadOption).toInt() : QThread::idealThreadCount();
+  threadCount = qBound(1, threadCount, 64);
+  int prefetchDepth = qBound(1, parser.value(prefetchOption).toInt(), 64);
+  QString outputDir = QDir(parser.value(outputOption)).absolutePath();
+
+  if (!QDir(imageDir).exists())
+  {
+    printError(QString("图像目录不存在: %1").arg(imageDir));
+    return 2;
+  }
+  if (!QDir(templateDir).exists())
+  {
+    printError(QString("模板目录不存在: %1").arg(templateDir));
+    return 2;
+  }
+  if (!QDir().mkpath(outputDir))
+  {
+    printError(QString("无法创建输出目录: %1").arg(outputDir));
+    return 2;
+  }
+  initLog(outputDir + "/logs");
+
+  QFileInfoList fileList = collectImages(imageDir);
+  if (fileList.isEmpty())
+  {
+    printError(QString("图像目录中没有图像文件: %1").arg(imageDir));
+    return 2;
+  }
+
+  // 模板只加载一次，批处理期间不监视文件变化
+  TemplateCache cache;
+  cache.setWatchEnabled(false);
+  cache.setPaths(QDir(templateDir).absolutePath() + "/", QDir(measureDir).absolutePath());
+  if (!cache.reload())
+  {
+    printError(QString("模板加载失败: %1").arg(templateDir));
+    return 3;
+  }
+
+  LatencyProfiler& profiler = LatencyProfiler::instance();
+  profiler.setReportInterval(0);
+  profiler.setEnabled(true);
+
+  SearchWindowConfig searchConfig;
+  searchConfig.enabled = parser.isSet(trackingOption);
+  MatchPassConfig matchConfig;
+  matchConfig.speculative = parser.isSet(speculativeOption);
+
+  InspectionCore core;
+  core.setSearchWindowConfig(searchConfig);
+  core.setMatchPassConfig(matchConfig);
+
+  InspectionPool* pool = nullptr;
+  if (threadCount > 1)
+  {
+    pool = new InspectionPool(&cache, threadCount);
+    pool->setSearchWindowConfig(searchConfig);
+    pool->setMatchPassConfig(matchConfig);
+    pool->start();
+  }
+
+  QFile resultFile(outputDir + "/results.csv");
+  if (!resultFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+  {
+    printError(QString("无法写入结果文件: %1").arg(resultFile.fileName()));
+    delete pool;
+    return 2;
+  }
+  QTextStream results(&resultFile);
+  results.setCodec("UTF-8");
+  results << "sequence,image,matched,score,row,column,angle,measured,min_distance,max_distance,"
+             "centroid_distance,area1,area2,inspect_ms\n";
+
+  BatchTotals totals;
+  const int total = fileList.size();
+  InspectionPipeline pipeline(&core, &cache, pool);
+  pipeline.setPrefetchDepth(prefetchDepth);
+  pipeline.addPublisher([&](const InspectionResult& result) {
+    const MeasurementRecord& record = result.record;
+    ++totals.images;
+    totals.matched += record.isMatched() ? 1 : 0;
+    totals.measured += record.isMeasured() ? 1 : 0;
+    results << result.sequence << ',' << '"' << result.imagePath << '"' << ','
+            << (record.isMatched() ? 1 : 0) << ','
+            << QString::number(record.value(MeasurementField::MatchScore), 'f', 4) << ','
+            << QString::number(record.value(MeasurementField::MatchRow), 'f', 3) << ','
+            << QString::number(record.value(MeasurementField::MatchColumn), 'f', 3) << ','
+            << QString::number(record.value(MeasurementField::MatchAngle), 'f', 5) << ','
+            << (record.isMeasured() ? 1 : 0) << ','
+            << QString::number(record.value(MeasurementField::MinDistance), 'f', 3) << ','
+            << QString::number(record.value(MeasurementField::MaxDistance), 'f', 3) << ','
+            << QString::number(record.value(MeasurementField::CentroidDistance), 'f', 3) << ','
+            << QString::number(record.value(MeasurementField::Area1), 'f', 1) << ','
+            << QString::number(record.value(MeasurementField::Area2), 'f', 1) << ','
+            << QString::number(record.inspectMs, 'f', 3) << '\n';
+    if (totals.images % 50 == 0 || totals.images == total)
+    {
+      printLine(QString("[%1/%2] %3").arg(totals.images).arg(total).arg(QFileInfo(result.imagePath).fileName()));
+    }
+  });
+
+  printLine(QString("图像: %1 张, 线程: %2, 预读: %3, 输出: %4").arg(total).arg(threadCount).arg(prefetchDepth).arg(outputDir));
+
+  QElapsedTimer wallTimer;
+  wallTimer.start();
+  int published = pipeline.run(fileList);
+  double wallMs = wallTimer.nsecsElapsed() / 1e6;
+  results.flush();
+  resultFile.close();
+
+  // 汇总报告
+  SearchWindowStats searchStats = core.searchWindowStats();
+  SpeculativeMatchStats specStats = core.speculativeStats();
+  if (pool != nullptr)
+  {
+    searchStats.merge(pool->searchWindowStats());
+    specStats.merge(pool->speculativeStats());
+  }
+
+  QStringList report;
+  report << QString("MyOperation 批量检测报告 %1").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
+  report << QString("图像目录: %1").arg(QDir(imageDir).absolutePath());
+  report << QString("模板目录: %1").arg(QDir(templateDir).absolutePath());
+  report << QString("线程数: %1, 预读: %2, 跟踪模式: %3, 投机匹配: %4")
+            .arg(threadCount).arg(prefetchDepth)
+            .arg(searchConfig.enabled ? "on" : "off").arg(matchConfig.speculative ? "on" : "off");
+  report << QString("图像: %1, 已处理: %2, 匹配: %3, 完成测量: %4")
+            .arg(total).arg(published).arg(totals.matched).arg(totals.measured);
+  report << QString("总耗时: %1 ms, 吞吐量: %2 张/秒")
+            .arg(wallMs, 0, 'f', 1).arg(wallMs > 0.0 ? published * 1000.0 / wallMs : 0.0, 0, 'f', 2);
+  report << "" << "[流水线]" << pipeline.statsSummary();
+  report << "" << "[分阶段耗时]" << profiler.summary();
+  if (pool != nullptr)
+  {
+    report << "" << "[检测线程]" << pool->utilisationSummary();
+  }
+  if (searchStats.frames > 0)
+  {
+    report << "" << "[跟踪搜索]"
+           << QString("命中率=%1%, 全图搜索=%2 (回退=%3, 参考帧过旧=%4), 回退损失=%5 ms, 净节省=%6 ms/帧")
+              .arg(searchStats.hitRate() * 100.0, 0, 'f', 1).arg(searchStats.globalSearches)
+              .arg(searchStats.globalFallbacks).arg(searchStats.staleSkips)
+              .arg(searchStats.fallbackMs, 0, 'f', 1).arg(searchStats.netSavedMsPerFrame(), 0, 'f', 2);
+  }
+  if (specStats.frames > 0)
+  {
+    report << "" << "[投机匹配]"
+           << QString("快速胜出=%1, 精确胜出=%2, 无结果=%3, 取消=%4, 改为顺序匹配=%5")
+              .arg(specStats.fastWins).arg(specStats.preciseWins).arg(specStats.misses).arg(specStats.cancelled)
+              .arg(specStats.busySkips);
+  }
+
+  QString reportText = report.join("\n");
+  QFile reportFile(outputDir + "/report.txt");
+  if (reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+  {
+    QTextStream stream(&reportFile);
+    stream.setCodec("UTF-8");
+    stream << reportText << "\n";
+  }
+  printLine("");
+  printLine(reportText);
+
+  delete pool;
+  return published == total ? 0 : 1;
+}
@@ -0,0 +1,349 @@
+/**
+ * @file main.cpp
+ * @brief 滤波与统计内核基准 | Filter and statistics kernel benchmark
+ *
+ * 对比 vision_kernels 滤波内核在标量、SIMD（检测到的最高级别）以及多线程下的耗时，
+ * 并给出与标量结果的最大差值，用于确认各指令集实现一致。
+ * 统计内核（均值/方差/最值/直方图/清晰度）以均值和标准差的最大偏差作为差值；
+ * 颜色阈值内核以行程数之差作为差值。
+ * 区域内核（形态学/连通域/特征）没有SIMD版本，SIMD列留空，差值为单线程与多线程结果的行程数（或连通域数）之差。
+ * 一维测量只处理一条剖面，不分线程，多线程列留空，差值为标量与SIMD边缘位置的最大差；定义 KERNEL_BENCH_HALCON 时
+ * 对比 ReduceDomain + ThresholdSubPix + LengthXld 提取轮廓的耗时。
+ * 定义 KERNEL_BENCH_HALCON 并链接 Halcon 时，同时测量 gauss_filter / mean_image / median_image
+ * 并给出与内置内核的最大差值（gauss_filter 只有固定尺寸，σ 按文档对应关系取近似值，差值仅供参考）。
+ * Times the vision_kernels filters as scalar, SIMD (highest detected level) and multi-threaded, and reports
+ * the max difference to the scalar output. With KERNEL_BENCH_HALCON the Halcon operators are timed as well.
+ *
+ * 用法:
+ *   MyOperationKernelBench [宽度] [高度] [重复次数] [线程数]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ColorThreshold.h"
+#include "ImageFilters.h"
+#include "ImageStatistics.h"
+#include "KernelRuntime.h"
+#include "Measure1D.h"
+#include "Region.h"
+
+#ifdef KERNEL_BENCH_HALCON
+#include "halconcpp/HalconCpp.h"
+#endif
+
+namespace
+{
+struct BenchCase {
+  std::string name;
+  std::function<void(vk::ConstView8, vk::View8)> run8;
+#ifdef KERNEL_BENCH_HALCON
+  std::function<void(const HalconCpp::HObject&, HalconCpp::HObject*)> halcon;
+#endif
+};
+
+// 带噪声的渐变图，接近实际产品图像的灰度分布
+vk::Image<std::uint8_t> makeImage(int width, int height)
+{
+  vk::Image<std::uint8_t> image(width, height);
+  std::mt19937 random(12345);
+  std::uniform_int_distribution<int> noise(-20, 20);
+  for (int y = 0; y < height; ++y)
+  {
+    std::uint8_t* row = image.view().row(y);
+    for (int x = 0; x < width; ++x)
+    {
+      int value = (x * 255 / width + y * 255 / height) / 2 + noise(random);
+      if ((x / 64 + y / 64) % 2 == 0)
+      {
+        value += 40;
+      }
+      row[x] = static_cast<std::uint8_t>(std::min(255, std::max(0, value)));
+    }
+  }
+  return image;
+}
+
+template<typename Fn>
+double timeMs(int iterations, Fn&& fn)
+{
+  fn(); // 预热（线程池创建、缓存）
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    fn();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+int maxDifference(const vk::Image<std::uint8_t>& a, const vk::Image<std::uint8_t>& b)
+{
+  int maxDiff = 0;
+  const std::uint8_t* pa = a.data();
+  const std::uint8_t* pb = b.data();
+  size_t count = static_cast<size_t>(a.width()) * a.height();
+  for (size_t i = 0; i < count; ++i)
+  {
+    maxDiff = std::max(maxDiff, std::abs(static_cast<int>(pa[i]) - static_cast<int>(pb[i])));
+  }
+  return maxDiff;
+}
+
+#ifdef KERNEL_BENCH_HALCON
+int maxDifference(const HalconCpp::HObject& image, const vk::Image<std::uint8_t>& reference)
+{
+  HalconCpp::HTuple pointer, type, width, height;
+  HalconCpp::GetImagePointer1(image, &pointer, &type, &width, &height);
+  const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(pointer.L());
+  int maxDiff = 0;
+  size_t count = static_cast<size_t>(reference.width()) * reference.height();
+  for (size_t i = 0; i < count; ++i)
+  {
+    maxDiff = std::max(maxDiff, std::abs(static_cast<int>(data[i]) - static_cast<int>(reference.data()[i])));
+  }
+  return maxDiff;
+}
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+  int width = argc > 1 ? std::max(16, std::atoi(argv[1])) : 2448;
+  int height = argc > 2 ? std::max(16, std::atoi(argv[2])) : 2048;
+  int iterations = argc > 3 ? std::max(1, std::atoi(argv[3])) : 10;
+  int threads = argc > 4 ? std::max(0, std::atoi(argv[4])) : 0;
+
+  vk::setThreadCount(threads);
+  const int parallelThreads = vk::threadCount();
+  const vk::SimdLevel bestLevel = vk::detectedSimdLevel();
+
+  std::printf("图像: %dx%d, 重复: %d, 指令集: %s, 线程: %d\n", width, height, iterations,
+              vk::simdLevelName(bestLevel), parallelThreads);
+  std::printf("%-24s %12s %12s %12s %10s", "内核", "标量(ms)", "SIMD(ms)", "SIMD+MT(ms)", "最大差值");
+#ifdef KERNEL_BENCH_HALCON
+  std::printf(" %12s %10s", "Halcon(ms)", "Halcon差值");
+#endif
+  std::printf("\n");
+
+  vk::Image<std::uint8_t> source = makeImage(width, height);
+  vk::Image<std::uint8_t> scalarOut(width, height);
+  vk::Image<std::uint8_t> simdOut(width, height);
+
+  std::vector<BenchCase> cases = {
+    {"gauss sigma=1.4", [](vk::ConstView8 s, vk::View8 d) { vk::gaussianFilter(s, d, 1.4); }
+#ifdef KERNEL_BENCH_HALCON
+     , [](const HalconCpp::HObject& in, HalconCpp::HObject* out) { HalconCpp::GaussFilter(in, out, 7); }
+#endif
+    },
+    {"mean 5x5", [](vk::ConstView8 s, vk::View8 d) { vk::boxFilter(s, d, 5, 5); }
+#ifdef KERNEL_BENCH_HALCON
+     , [](const HalconCpp::HObject& in, HalconCpp::HObject* out) { HalconCpp::MeanImage(in, out, 5, 5); }
+#endif
+    },
+    {"mean 31x31", [](vk::ConstView8 s, vk::View8 d) { vk::boxFilter(s, d, 31, 31); }
+#ifdef KERNEL_BENCH_HALCON
+     , [](const HalconCpp::HObject& in, HalconCpp::HObject* out) { HalconCpp::MeanImage(in, out, 31, 31); }
+#endif
+    },
+    {"median square r=2", [](vk::ConstView8 s, vk::View8 d) { vk::medianFilter(s, d, 2, vk::MedianMask::Square); }
+#ifdef KERNEL_BENCH_HALCON
+     , [](const HalconCpp::HObject& in, HalconCpp::HObject* out) { HalconCpp::MedianImage(in, out, "square", 2, "mirrored"); }
+#endif
+    },
+    {"median square r=7", [](vk::ConstView8 s, vk::View8 d) { vk::medianFilter(s, d, 7, vk::MedianMask::Square); }
+#ifdef KERNEL_BENCH_HALCON
+     , [](const HalconCpp::HObject& in, HalconCpp::HObject* out) { HalconCpp::MedianImage(in, out, "square", 7, "mirrored"); }
+#endif
+    },
+    {"median circle r=3", [](vk::ConstView8 s, vk::View8 d) { vk::medianFilter(s, d, 3, vk::MedianMask::Circle); }
+#ifdef KERNEL_BENCH_HALCON
+     , [](const HalconCpp::HObject& in, HalconCpp::HObject* out) { HalconCpp::MedianImage(in, out, "circle", 3, "mirrored"); }
+#endif
+    },
+  };
+
+#ifdef KERNEL_BENCH_HALCON
+  HalconCpp::HObject halconSource;
+  HalconCpp::GenImage1(&halconSource, "byte", width, height, reinterpret_cast<Hlong>(source.data()));
+#endif
+
+  for (const BenchCase& benchCase : cases)
+  {
+    vk::setThreadCount(1);
+    vk::setSimdLevel(vk::SimdLevel::Scalar);
+    double scalarMs = timeMs(iterations, [&]() { benchCase.run8(source.view(), scalarOut.view()); });
+
+    vk::setSimdLevel(bestLevel);
+    double simdMs = timeMs(iterations, [&]() { benchCase.run8(source.view(), simdOut.view()); });
+
+    vk::setThreadCount(threads);
+    double parallelMs = timeMs(iterations, [&]() { benchCase.run8(source.view(), simdOut.view()); });
+
+    std::printf("%-24s %12.2f %12.2f %12.2f %10d", benchCase.name.c_str(), scalarMs, simdMs, parallelMs,
+                maxDifference(scalarOut, simdOut));
+#ifdef KERNEL_BENCH_HALCON
+    HalconCpp::HObject halconOut;
+    double halconMs = timeMs(iterations, [&]() { benchCase.halcon(halconSource, &halconOut); });
+    std::printf(" %12.2f %10d", halconMs, maxDifference(halconOut, simdOut));
+#endif
+    std::printf("\n");
+  }
+
+  // 统计内核：整图一次遍历得到全部统计量
+  vk::ImageStatistics scalarStats;
+  vk::ImageStatistics simdStats;
+  vk::setThreadCount(1);
+  vk::setSimdLevel(vk::SimdLevel::Scalar);
+  double scalarMs = timeMs(iterations, [&]() { vk::computeStatistics(source.view(), scalarStats); });
+
+  vk::setSimdLevel(bestLevel);
+  double simdMs = timeMs(iterations, [&]() { vk::computeStatistics(source.view(), simdStats); });
+
+  vk::setThreadCount(threads);
+  double parallelMs = timeMs(iterations, [&]() { vk::computeStatistics(source.view(), simdStats); });
+
+  double statsDiff = std::max(std::abs(scalarStats.mean - simdStats.mean),
+                              std::abs(scalarStats.deviation - simdStats.deviation));
+  std::printf("%-24s %12.2f %12.2f %12.2f %10.4f", "statistics", scalarMs, simdMs, parallelMs, statsDiff);
+#ifdef KERNEL_BENCH_HALCON
+  // Halcon 需要两个算子才能得到均值/标准差和最值，且不含直方图与清晰度
+  HalconCpp::HTuple mean, deviation, minGray, maxGray, range;
+  double halconMs = timeMs(iterations, [&]() {
+    HalconCpp::Intensity(halconSource, halconSource, &mean, &deviation);
+    HalconCpp::MinMaxGray(halconSource, halconSource, 0, &minGray, &maxGray, &range);
+  });
+  double halconDiff = std::max(std::abs(mean[0].D() - simdStats.mean), std::abs(deviation[0].D() - simdStats.deviation));
+  std::printf(" %12.2f %10.4f", halconMs, halconDiff);
+#endif
+  std::printf("\n");
+
+  // 颜色阈值：由灰度图错位生成三个平面，保证各种色调都出现
+  vk::Image<std::uint8_t> green(width, height);
+  vk::Image<std::uint8_t> blue(width, height);
+  for (int y = 0; y < height; ++y)
+  {
+    const std::uint8_t* row = source.view().row(y);
+    for (int x = 0; x < width; ++x)
+    {
+      green.view().at(x, y) = row[(x + 37) % width];
+      blue.view().at(x, y) = static_cast<std::uint8_t>(255 - row[(x * 7) % width]);
+    }
+  }
+  vk::PlanarRgb planes;
+  planes.red = source.view();
+  planes.green = green.view();
+  planes.blue = blue.view();
+
+  struct ColorCase {
+    const char* name;
+    std::function<void(vk::RunList&)> run;
+  };
+  const std::vector<ColorCase> colorCases = {
+    {"threshold rgb", [&](vk::RunList& runs) { vk::thresholdRgb(planes, {80, 200}, {60, 180}, {40, 160}, runs); }},
+    {"threshold hsv", [&](vk::RunList& runs) { vk::thresholdHsv(planes, {200, 30}, {40, 255}, {50, 255}, runs); }},
+  };
+  for (const ColorCase& colorCase : colorCases)
+  {
+    vk::RunList scalarRuns;
+    vk::RunList simdRuns;
+    vk::setThreadCount(1);
+    vk::setSimdLevel(vk::SimdLevel::Scalar);
+    double colorScalarMs = timeMs(iterations, [&]() { colorCase.run(scalarRuns); });
+
+    vk::setSimdLevel(bestLevel);
+    double colorSimdMs = timeMs(iterations, [&]() { colorCase.run(simdRuns); });
+
+    vk::setThreadCount(threads);
+    double colorParallelMs = timeMs(iterations, [&]() { colorCase.run(simdRuns); });
+
+    long runDiff = std::labs(static_cast<long>(scalarRuns.size()) - static_cast<long>(simdRuns.size()));
+    std::printf("%-24s %12.2f %12.2f %12.2f %10ld\n", colorCase.name, colorScalarMs, colorSimdMs, colorParallelMs,
+                runDiff);
+  }
+
+  // 区域内核：以RGB阈值结果作为缺陷掩码，结果大小用于核对单线程与多线程一致
+  vk::RunList maskRuns;
+  vk::thresholdRgb(planes, {80, 200}, {60, 180}, {40, 160}, maskRuns);
+  const vk::Region mask(std::move(maskRuns));
+
+  struct RegionCase {
+    const char* name;
+    std::function<std::size_t()> run;
+  };
+  const std::vector<RegionCase> regionCases = {
+    {"dilation rect 15x15", [&]() { return vk::dilateRectangle(mask, 15, 15).runs().size(); }},
+    {"erosion rect 15x15", [&]() { return vk::erodeRectangle(mask, 15, 15).runs().size(); }},
+    {"opening circle 3.5", [&]() { return vk::openCircle(mask, 3.5).runs().size(); }},
+    {"union/intersection", [&]() {
+       const vk::Region shifted = vk::translateRegion(mask, 3, 5);
+       return vk::unionRegions(mask, shifted).runs().size() + vk::intersectRegions(mask, shifted).runs().size();
+     }},
+    {"connection", [&]() { return vk::connectedComponents(mask).size(); }},
+    {"region features", [&]() { return static_cast<std::size_t>(vk::regionFeatures(mask).area); }},
+  };
+  for (const RegionCase& regionCase : regionCases)
+  {
+    std::size_t singleSize = 0;
+    std::size_t parallelSize = 0;
+    vk::setThreadCount(1);
+    double regionSingleMs = timeMs(iterations, [&]() { singleSize = regionCase.run(); });
+
+    vk::setThreadCount(threads);
+    double regionParallelMs = timeMs(iterations, [&]() { parallelSize = regionCase.run(); });
+
+    long sizeDiff = std::labs(static_cast<long>(singleSize) - static_cast<long>(parallelSize));
+    std::printf("%-24s %12.2f %12s %12.2f %10ld\n", regionCase.name, regionSingleMs, "-", regionParallelMs, sizeDiff);
+  }
+
+  // 一维测量：穿过棋盘格的斜向测量矩形，只求一条剖面
+  vk::MeasureRectangle rectangle;
+  rectangle.row = height / 2.0;
+  rectangle.column = width / 2.0;
+  rectangle.phi = 0.3;
+  rectangle.length1 = std::min(width, height) / 3.0;
+  rectangle.length2 = 20.0;
+  vk::MeasureOptions measureOptions;
+  measureOptions.threshold = 10.0;
+  std::vector<vk::Edge> scalarEdges;
+  std::vector<vk::Edge> simdEdges;
+  const int measureIterations = iterations * 100;
+  vk::setSimdLevel(vk::SimdLevel::Scalar);
+  double measureScalarMs = timeMs(measureIterations, [&]() {
+    vk::measurePos(source.view(), rectangle, measureOptions, scalarEdges);
+  });
+  vk::setSimdLevel(bestLevel);
+  double measureSimdMs = timeMs(measureIterations, [&]() {
+    vk::measurePos(source.view(), rectangle, measureOptions, simdEdges);
+  });
+  double edgeDiff = scalarEdges.size() == simdEdges.size() ? 0.0 : 1e9;
+  for (size_t i = 0; i < scalarEdges.size() && i < simdEdges.size(); ++i)
+  {
+    edgeDiff = std::max(edgeDiff, std::abs(scalarEdges[i].position - simdEdges[i].position));
+  }
+  std::printf("%-24s %12.3f %12.3f %12s %10.4f", "measure pos", measureScalarMs, measureSimdMs, "-", edgeDiff);
+#ifdef KERNEL_BENCH_HALCON
+  // 原流程：测量矩形内提取全部亚像素轮廓再求长度（还不含选择最长轮廓和 DistanceCc）
+  HalconCpp::HObject measureRegion;
+  HalconCpp::GenRectangle2(&measureRegion, rectangle.row, rectangle.column, rectangle.phi, rectangle.length1,
+                           rectangle.length2);
+  double contourMs = timeMs(iterations, [&]() {
+    HalconCpp::HObject reduced, border;
+    HalconCpp::HTuple lengths;
+    HalconCpp::ReduceDomain(halconSource, measureRegion, &reduced);
+    HalconCpp::ThresholdSubPix(reduced, &border, 128);
+    HalconCpp::LengthXld(border, &lengths);
+  });
+  std::printf(" %12.3f %10s", contourMs, "-");
+#endif
+  std::printf("\n");
+  return 0;
+}
@@ -0,0 +1,245 @@
+/**
+ * @file main.cpp
+ * @brief 测量结果存储分配基准 | Measurement result allocation benchmark
+ *
+ * 对比每帧测量结果的两种保存方式：
+ *  - 旧方式：构造 QMap<QString, QVariant>（中文键）、逐项复制到测量缓存并格式化显示文本；
+ *  - 新方式：填写定长 MeasurementRecord 并写入预分配的 MeasurementRing，文本只为显示的帧生成。
+ * Qt 容器和 QString 直接调用 malloc，因此 glibc 下替换 malloc 系列函数、MSVC 调试版使用
+ * _CrtSetAllocHook 统计每帧堆分配次数和字节数；其他平台只能统计 operator new。不依赖 Halcon。
+ *
+ * 用法:
+ *   MyOperationMeasurementBench [帧数] [显示间隔]
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QString>
+#include <QVariant>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#define BENCH_HOOK_MALLOC 1
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void __libc_free(void* pointer);
+#elif defined(_MSC_VER) && defined(_DEBUG)
+#define BENCH_HOOK_MALLOC 1
+#include <crtdbg.h>
+#endif
+
+#include "thread/MeasurementRecord.h"
+
+namespace
+{
+std::atomic<bool> g_counting{false};
+std::atomic<quint64> g_allocations{0};
+std::atomic<quint64> g_allocatedBytes{0};
+
+struct BenchResult {
+  double nsPerFrame = 0.0;
+  double allocationsPerFrame = 0.0;
+  double bytesPerFrame = 0.0;
+};
+
+// 模拟一帧的检测输出
+void fillValues(double* values, int frame)
+{
+  for (int i = 0; i < static_cast<int>(MeasurementField::Count); ++i)
+  {
+    values[i] = frame * 0.001 + i * 1.5;
+  }
+}
+
+// 旧方式：与改造前 visualWorkThread::storeMeasurementResult + InspectionCore 文本格式化一致（每帧都格式化）
+void legacyFrame(int frame, QMap<QString, QVariant>& cache, quint64& sink)
+{
+  double v[static_cast<int>(MeasurementField::Count)];
+  fillValues(v, frame);
+
+  QString message = QString(
+                        "🎯 映射区域测量结果:\n最小距离: %1px\n最大距离: %2px\n重心距离: %3px\n区域1面积: %4px²\n区域2面积: %5px²\n模板匹配得分: %6")
+                    .arg(QString::number(v[0], 'f', 2))
+                    .arg(QString::number(v[1], 'f', 2))
+                    .arg(QString::number(v[2], 'f', 2))
+                    .arg(QString::number(v[3], 'f', 1))
+                    .arg(QString::number(v[4], 'f', 1))
+                    .arg(QString::number(v[9], 'f', 3));
+
+  QMap<QString, QVariant> measurementResults;
+  measurementResults["最小距离"] = v[0];
+  measurementResults["最大距离"] = v[1];
+  measurementResults["重心距离"] = v[2];
+  measurementResults["区域1面积"] = v[3];
+  measurementResults["区域2面积"] = v[4];
+  measurementResults["重心1_X"] = v[5];
+  measurementResults["重心1_Y"] = v[6];
+  measurementResults["重心2_X"] = v[7];
+  measurementResults["重心2_Y"] = v[8];
+  measurementResults["模板匹配得分"] = v[9];
+  measurementResults["模板位置_Row"] = v[10];
+  measurementResults["模板位置_Col"] = v[11];
+  measurementResults["模板角度"] = v[12];
+  for (auto it = measurementResults.begin(); it != measurementResults.end(); ++it)
+  {
+    cache[it.key()] = it.value();
+  }
+
+  sink += static_cast<quint64>(message.size() + cache.size());
+}
+
+// 新方式：定长记录写入环形缓冲，只有显示的帧生成文本
+void recordFrame(int frame, MeasurementRing& ring, int displayInterval, quint64& sink)
+{
+  MeasurementRecord record;
+  record.sequence = frame;
+  record.flags = MeasurementRecord::Matched | MeasurementRecord::Measured;
+  fillValues(record.values, frame);
+  ring.push(record);
+
+  if (displayInterval > 0 && frame % displayInterval == 0)
+  {
+    sink += static_cast<quint64>(measurementMessage(record).size());
+  }
+}
+
+template<typename Fn>
+BenchResult runBench(int frames, Fn&& frameFn)
+{
+  // 预热（建立缓存键、QString 共享数据等）
+  for (int i = 0; i < 100; ++i)
+  {
+    frameFn(i);
+  }
+
+  g_allocations.store(0);
+  g_allocatedBytes.store(0);
+  QElapsedTimer timer;
+  timer.start();
+  g_counting.store(true);
+  for (int i = 0; i < frames; ++i)
+  {
+    frameFn(i);
+  }
+  g_counting.store(false);
+  qint64 elapsedNs = timer.nsecsElapsed();
+
+  BenchResult result;
+  result.nsPerFrame = static_cast<double>(elapsedNs) / frames;
+  result.allocationsPerFrame = static_cast<double>(g_allocations.load()) / frames;
+  result.bytesPerFrame = static_cast<double>(g_allocatedBytes.load()) / frames;
+  return result;
+}
+
+void printResult(const char* name, const BenchResult& result)
+{
+  std::printf("%-36s %12.1f %14.2f %14.1f\n", name, result.nsPerFrame, result.allocationsPerFrame, result.bytesPerFrame);
+}
+
+void countAllocation(size_t size)
+{
+  if (g_counting.load(std::memory_order_relaxed))
+  {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  }
+}
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+int crtAllocHook(int allocType, void*, size_t size, int, long, const unsigned char*, int)
+{
+  if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC)
+  {
+    countAllocation(size);
+  }
+  return 1;
+}
+#endif
+}
+
+#if defined(__GLIBC__)
+extern "C" void* malloc(size_t size)
+{
+  countAllocation(size);
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+  countAllocation(count * size);
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size)
+{
+  countAllocation(size);
+  return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void* pointer)
+{
+  __libc_free(pointer);
+}
+#endif
+
+void* operator new(std::size_t size)
+{
+#ifndef BENCH_HOOK_MALLOC
+  countAllocation(size); // 无法替换 malloc 时只统计 operator new
+#endif
+  void* pointer = std::malloc(size == 0 ? 1 : size);
+  if (pointer == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(_MSC_VER) && defined(_DEBUG)
+  _CrtSetAllocHook(crtAllocHook);
+#endif
+  QCoreApplication app(argc, argv);
+  QStringList args = QCoreApplication::arguments();
+  int frames = args.size() > 1 ? qMax(1, args.at(1).toInt()) : 200000;
+  int displayInterval = args.size() > 2 ? qMax(0, args.at(2).toInt()) : 4;
+
+  std::printf("帧数: %d, 显示间隔: %d (0 表示不显示)\n", frames, displayInterval);
+  std::printf("%-36s %12s %14s %14s\n", "方式", "ns/帧", "分配次数/帧", "分配字节/帧");
+
+  quint64 sink = 0;
+  QMap<QString, QVariant> cache;
+  BenchResult legacy = runBench(frames, [&](int frame) { legacyFrame(frame, cache, sink); });
+  printResult("QMap<QString,QVariant> + 文本", legacy);
+
+  MeasurementRing ring(4096);
+  BenchResult record = runBench(frames, [&](int frame) { recordFrame(frame, ring, displayInterval, sink); });
+  printResult("MeasurementRecord + MeasurementRing", record);
+
+  BenchResult recordOnly = runBench(frames, [&](int frame) { recordFrame(frame, ring, 0, sink); });
+  printResult("MeasurementRecord (不显示)", recordOnly);
+
+  if (record.allocationsPerFrame > 0.0)
+  {
+    std::printf("分配次数减少: %.1fx\n", legacy.allocationsPerFrame / record.allocationsPerFrame);
+  }
+  std::printf("(校验值 %llu)\n", static_cast<unsigned long long>(sink));
+  return 0;
+}